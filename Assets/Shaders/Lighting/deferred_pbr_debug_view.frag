@@ -110,7 +110,7 @@ void main()
 		case 8: //MAIN_SHADOW_DEPTH
 		color = vec3(texture(u_shadowMap2D, OurTexCoords).r, 0.0, 0.0);
 		case 9: //MOTION_VECTOR
-		vec2 velocity = (texture(u_motionVector, OurTexCoords).rg);
+		vec2 velocity = (texture(u_motionVector, OurTexCoords * u_uvScale).rg);
 		color = vec3(velocity.rg, 0.0);
 		break;
 	}
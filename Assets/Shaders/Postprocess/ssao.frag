@@ -24,6 +24,7 @@ uniform vec3      u_sampleKernel[kernelSize];
 uniform mat4      u_view;
 uniform mat4      u_projection;
 uniform mat4      u_invProjection;
+uniform vec2      u_uvScale = vec2(1.0); //Dynamic resolution viewport in the gbuffer
 
 //***************************************
 // Exposed Parameter
@@ -44,7 +45,7 @@ void UnpackNormalFromRG(inout vec3 normal)
 
 vec3 GetViewSpacePositionFromDepth(vec2 uv)
 {
-  float normalizedDepth = texture(u_depthTexture, uv).r;
+  float normalizedDepth = texture(u_depthTexture, uv * u_uvScale).r;
   float z = normalizedDepth * 2.0 - 1.0; //[-1, 1]
   vec4 positionCS = vec4(uv.xy * 2.0 - 1.0, z, 1.0);
 
@@ -58,7 +59,7 @@ void main()
   vec2 uv = OurTexCoords;
 
   //FragPos in view space
-  vec4 normalXY = texture(gbuffer0, uv);
+  vec4 normalXY = texture(gbuffer0, uv * u_uvScale);
   vec3 positionVS = GetViewSpacePositionFromDepth(uv);//(u_view * vec4(fragPosNormalX.xyz, 1.0)).xyz;
 
   //Normal in view space
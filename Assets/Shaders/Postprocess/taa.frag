@@ -16,6 +16,10 @@ uniform vec4 u_TAAFrameInfo; // { taaSharpenStrength, taaFrameIndex, jitterUV.x,
 uniform bool u_beforeTonemapping = false;
 uniform bool u_blendTofilteredColor = false;
 
+// Dynamic resolution viewport in the current, depth and motion vector textures,
+// the output and the history cover the whole target
+uniform vec2 u_uvScale = vec2(1.0);
+
 //***************************************
 // Macros
 //***************************************
@@ -100,6 +104,9 @@ vec3 YCoCg_RGB(vec3 c)
 vec3 FetchCurrTexture(vec2 uv, float offsetX, float offsetY, vec2 texelSize)
 {
     uv += (vec2(offsetX, offsetY) * texelSize.xy);
+
+    //Don't filter in the stale texels outside the viewport
+    uv = min(uv, u_uvScale - (0.5 * texelSize.xy));
     return texture(u_currTexture, uv).xyz;
 }
 
@@ -214,7 +221,7 @@ vec3 TAA(in vec2 texelSize, in vec2 positionSS, in vec2 screenUV, in vec2 res)
     vec3 historyColor = FetchPrevTexture(screenUV - motionVector01, 0, 0, texelSize).xyz;
 
     //Sample Screen texture using unjittered uv
-    vec2 uv = screenUV - uvJitterAmount;
+    vec2 uv = (screenUV - uvJitterAmount) * u_uvScale;
     vec3 botLeft = FetchCurrTexture(uv, -NEIGHBOR_TEXEL_OFFSET, -NEIGHBOR_TEXEL_OFFSET, texelSize).xyz;
     vec3 topRight = FetchCurrTexture(uv, NEIGHBOR_TEXEL_OFFSET, NEIGHBOR_TEXEL_OFFSET, texelSize).xyz;
     vec3 botRight = FetchCurrTexture(uv, NEIGHBOR_TEXEL_OFFSET, -NEIGHBOR_TEXEL_OFFSET, texelSize).xyz;
@@ -318,7 +325,7 @@ void main()
 { 
     vec2 res = textureSize(u_currTexture, 0);
     vec2 texelSize = vec2(1.0 / res.x, 1.0 / res.y);
-    vec2 positionSS = OurTexCoords * res; 
+    vec2 positionSS = OurTexCoords * u_uvScale * res; 
     
     vec3 color = TAA(texelSize, positionSS, OurTexCoords, res);
     o_FragColor = vec4(color.xyz, 1.0);
@@ -13,6 +13,8 @@ layout(binding=2) uniform sampler2D u_ssaoTexture;
 uniform float     u_exposure;
 uniform float     u_time;
 uniform bool      u_useSSAO = false;
+uniform bool      u_useBloom = false;
+uniform vec2      u_ssaoUVScale = vec2(1.0); //SSAO is rendered at the dynamic resolution
 
 vec4 GammaCorrection(vec3 color, float gammaValue)
 {
@@ -56,17 +58,18 @@ vec3 ACESFilm(vec3 x)
 void main()
 { 
     vec3 screenColor = texture(u_screenTexture, OurTexCoords).rgb;
-    vec3 bloomColor = texture(u_bloomTexture, OurTexCoords).rgb;
-    vec3 ssao = texture(u_ssaoTexture, OurTexCoords).rgb;
 
     //Multiply with ssao
     if(u_useSSAO)
     {
-        screenColor *= ssao;
+        screenColor *= texture(u_ssaoTexture, OurTexCoords * u_ssaoUVScale).rgb;
     }
 
     //Addictive Blend
-    screenColor += bloomColor;
+    if(u_useBloom)
+    {
+        screenColor += texture(u_bloomTexture, OurTexCoords).rgb;
+    }
     
     //Tonemapping + GammaCorrection
     //screenColor = TonemapWithExposure(screenColor, u_exposure);
@@ -7,6 +7,7 @@ uniform mat4    u_prevUnJitteredVP;
 uniform mat4    u_unjitteredVP;
 
 uniform mat4    u_invVP;
+uniform vec2    u_uvScale = vec2(1.0); //Dynamic resolution viewport in the depth texture
 
 layout(binding=0) uniform sampler2D u_depthTexture;
 
@@ -14,7 +15,7 @@ layout(binding=0) uniform sampler2D u_depthTexture;
 
 void main()
 {
-  float depth = textureLod(u_depthTexture, OurTexCoords, 0.0f).r;
+  float depth = textureLod(u_depthTexture, OurTexCoords * u_uvScale, 0.0f).r;
   vec4 positionWS = vec4(DepthToWorldSpacePosition(depth, OurTexCoords, u_invVP).xyz,1.0);
 
   //[-1, 1] Clip Space position
@@ -6,10 +6,13 @@ layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec2 inTexCoord;
 layout (location = 3) in mat4 inInstanceModel;
 
+#include "ShaderLibrary/skinning.glsl"
+#include "ShaderLibrary/mesh_vertex.glsl"
+
 uniform mat4 u_lightSpaceMatrix;
 uniform mat4 u_model;
 
 void main()
 {
-  gl_Position = u_lightSpaceMatrix * u_model * vec4(inPos, 1.0);
+  gl_Position = u_lightSpaceMatrix * u_model * GetSkinMatrix() * vec4(DecodePosition(inPos), 1.0);
 }  
\ No newline at end of file
@@ -16,6 +16,7 @@ uniform GBufferResult u_gbuffer;
 layout(binding=13) uniform sampler2D   u_depthTexture;
 uniform mat4    u_invVP;
 uniform mat4    u_lightSpaceMatrix;
+uniform vec2    u_uvScale = vec2(1.0); //Dynamic resolution viewport in the gbuffer
 
 struct MaterialData
 {
@@ -76,16 +77,17 @@ vec3 LinearToSRGB(vec3 c)
 void UnpackGBufferData(vec2 uv
     , out MaterialData matData, out SurfaceData surfaceData)
 {
-	//Unpack datas from GBuffer
-	vec4 gbuffer1 = texture(u_gbuffer.gbuffer1, uv);
+	//Unpack datas from GBuffer, position is reconstructed from the unscaled uv
+	vec2 gbufferUV = uv * u_uvScale;
+	vec4 gbuffer1 = texture(u_gbuffer.gbuffer1, gbufferUV);
 	matData.albedo = LinearToSRGB(gbuffer1.rgb);	//Need to convert back to SRGB, since SRGB8_ALPHA8 auto convert to linear on encode
 	
 	//matData.positionWS = gbuffer0.xyz;
-  	float depth = textureLod(u_depthTexture, uv, 0.0f).r;
+  	float depth = textureLod(u_depthTexture, gbufferUV, 0.0f).r;
   	matData.positionWS = DepthToWorldSpacePosition(depth, uv, u_invVP).xyz;
 
 	//Unpack normal
-	vec2 gbuffer0 = texture(u_gbuffer.gbuffer0, uv).xy;
+	vec2 gbuffer0 = texture(u_gbuffer.gbuffer0, gbufferUV).xy;
 	vec3 normal = vec3(0.0);
 	normal.xy = gbuffer0.xy;
 
@@ -94,7 +96,7 @@ void UnpackGBufferData(vec2 uv
 	normal = normalize(normal);
 
 	//Material data
-	vec4 gbuffer2 = texture(u_gbuffer.gbuffer2, uv);
+	vec4 gbuffer2 = texture(u_gbuffer.gbuffer2, gbufferUV);
 	
 	matData.emissive = DecodeQuantization(gbuffer2.xyz, 12);
 	matData.positionLS = (u_lightSpaceMatrix * vec4(matData.positionWS, 1.0)).xyz;
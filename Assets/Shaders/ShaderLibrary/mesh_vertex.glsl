@@ -0,0 +1,41 @@
+//***************************************
+// mesh_vertex.glsl
+//***************************************
+//Decoding of the Mesh VertexFormat, the defaults are the all float Vertex
+
+//Bit 1: octahedral normal, bit 2: octahedral tangent
+uniform int u_vertexFormat = 0;
+
+//Quantized positions and uv are stored inside the mesh bounds
+uniform vec3 u_positionOffset = vec3(0.0);
+uniform vec3 u_positionScale = vec3(1.0);
+uniform vec4 u_texCoordDecode = vec4(0.0, 0.0, 1.0, 1.0);
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+  vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+  float t = max(-n.z, 0.0);
+  n.x += n.x >= 0.0 ? -t : t;
+  n.y += n.y >= 0.0 ? -t : t;
+  return normalize(n);
+}
+
+vec3 DecodePosition(vec3 position)
+{
+  return u_positionOffset + position * u_positionScale;
+}
+
+vec3 DecodeNormal(vec3 normal)
+{
+  return (u_vertexFormat & 1) != 0 ? DecodeOctahedral(normal.xy) : normal;
+}
+
+vec3 DecodeTangent(vec3 tangent)
+{
+  return (u_vertexFormat & 2) != 0 ? DecodeOctahedral(tangent.xy) : tangent;
+}
+
+vec2 DecodeTexCoord(vec2 texCoord)
+{
+  return u_texCoordDecode.xy + texCoord * u_texCoordDecode.zw;
+}
@@ -0,0 +1,31 @@
+//***************************************
+// skinning.glsl
+//***************************************
+layout (location = 8) in uvec4 inBoneIndices;
+layout (location = 9) in vec4 inBoneWeights;
+
+//Skinning matrices of every animated character, 3 texels (rows) per bone
+uniform samplerBuffer u_skinPalette;
+
+//First bone of this draw in the palette, -1 when the mesh is not skinned
+uniform int u_skinPaletteOffset = -1;
+
+mat4 GetSkinMatrix()
+{
+  if (u_skinPaletteOffset < 0)
+  {
+    return mat4(1.0);
+  }
+
+  mat4 skin = mat4(0.0);
+  for (int i = 0; i < 4; ++i)
+  {
+    int texel = (u_skinPaletteOffset + int(inBoneIndices[i])) * 3;
+    mat4 bone = transpose(mat4(texelFetch(u_skinPalette, texel)
+      , texelFetch(u_skinPalette, texel + 1)
+      , texelFetch(u_skinPalette, texel + 2)
+      , vec4(0.0, 0.0, 0.0, 1.0)));
+    skin += bone * inBoneWeights[i];
+  }
+  return skin;
+}
@@ -5,6 +5,9 @@ layout (location = 2) in vec2 inTexCoord;
 layout (location = 3) in vec3 inTangent;
 layout (location = 4) in mat4 inInstanceModel;
 
+#include "ShaderLibrary/skinning.glsl"
+#include "ShaderLibrary/mesh_vertex.glsl"
+
 out VS_OUT
 {
 	vec2 ourTexCoord;
@@ -34,9 +37,11 @@ void main()
 {
 	mat4 model = u_instanceRendering? inInstanceModel:u_model;
 
-	vec4 worldPos = model * vec4(inPos, 1.0f);
-	vec4 prevWorldPos = u_instanceRendering? worldPos: (u_prevModel * vec4(inPos, 1.0f));
-	vs_out.ourTexCoord = inTexCoord;
+	//Previous bone poses aren't kept, skinned motion only come from the model matrix
+	vec4 positionOS = GetSkinMatrix() * vec4(DecodePosition(inPos), 1.0f);
+	vec4 worldPos = model * positionOS;
+	vec4 prevWorldPos = u_instanceRendering? worldPos: (u_prevModel * positionOS);
+	vs_out.ourTexCoord = DecodeTexCoord(inTexCoord);
 
 	//No motion vector for GPU instancing for now
 	vs_out.positionCS = u_instanceRendering? vec4(0.0, 0.0, 0.0, 1.0): u_unjitteredVP * worldPos;
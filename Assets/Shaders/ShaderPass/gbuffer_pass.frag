@@ -1,4 +1,5 @@
 #version 330 core
+#pragma shader_feature USE_NORMALMAP USE_OPACITYMAP
 
 // 4 4 4 4
 layout (location = 0) out vec4 o_gbuffer0;  //(0) vec4(n.xy)
@@ -15,70 +16,62 @@ in VS_OUT
 	mat3 ourTBNMatrix;
 } fs_in;
 
-//! brief Store Material information
-struct Material
+//! brief Material textures, units are set by MaterialProperty
+uniform sampler2D 	u_diffuseMap;	//albedo
+uniform sampler2D 	u_normalMap;
+uniform sampler2D 	u_roughnessMap;
+uniform sampler2D	u_metallicMap;
+uniform sampler2D 	u_emissiveMap;
+uniform sampler2D 	u_opacityMap;
+
+//! brief Material constants, packed on CPU in the same order (MP_PBRMetallic::GetConstantLayout)
+layout (std140) uniform MaterialConstants
 {
-  sampler2D 	m_diffuseMap;	//albedo
-  
-  sampler2D 	m_normalMap;
-  float         m_normalMultiplier;
-
-  sampler2D 	m_roughnessMap;
-  float 		m_roughnessValue;
-
-  sampler2D		m_metallicMap;
-  float 		m_metallicValue;
-	
-  sampler2D 	m_emissiveMap;
+  vec4			m_diffuseColor;
+  float			m_normalMultiplier;
+  float			m_roughnessValue;
+  float			m_metallicValue;
   float			m_emissiveStrength;
-  
-  sampler2D 	m_opacityMap;
   float			m_cutOffValue;
-};
-uniform Material u_material;
-uniform vec4	 u_diffuseColor = vec4(1.0f);
+} u_material;
 
 //***************************************
 // Uniforms
 //***************************************
-uniform bool        u_useNormalmap = false;
-uniform bool        u_useOpacityMap = false;
 const float			k_lodBias = -1;	//add more detail to compensate for taa
 
 void main()
 {
 	vec2 uv = fs_in.ourTexCoord.xy;
 
-	if(u_useOpacityMap)
+#ifdef USE_OPACITYMAP
+	float opacity = texture(u_opacityMap, uv, k_lodBias).r;
+	if(opacity < u_material.m_cutOffValue)
 	{
-		float opacity = texture(u_material.m_opacityMap, uv, k_lodBias).r;
-		if(opacity < u_material.m_cutOffValue)
-		{
-			discard;
-		}
+		discard;
 	}
+#endif
 
 	//Sample Normal map
 	vec3 normal = fs_in.ourFragNormal;
-	if(u_useNormalmap)
-	{
-		normal = (texture(u_material.m_normalMap, uv, k_lodBias).rgb);
+#ifdef USE_NORMALMAP
+	normal = (texture(u_normalMap, uv, k_lodBias).rgb);
 
-		//Remap to range [-1,1]
-		normal = normalize(normal * 2.0 - 1.0);
-		normal.z *= u_material.m_normalMultiplier;
+	//Remap to range [-1,1]
+	normal = normalize(normal * 2.0 - 1.0);
+	normal.z *= u_material.m_normalMultiplier;
 
-		//Transform tangent to world space normal
-		normal = (fs_in.ourTBNMatrix * normal);
-		normal = normalize(normal);
-	}
+	//Transform tangent to world space normal
+	normal = (fs_in.ourTBNMatrix * normal);
+	normal = normalize(normal);
+#endif
 
 	//Roughness, Metallic
-	float roughness = texture(u_material.m_roughnessMap, uv, k_lodBias).r
+	float roughness = texture(u_roughnessMap, uv, k_lodBias).r
 								* u_material.m_roughnessValue;
 	roughness = clamp(roughness, 0.01, 1.0);
 
-	float metallic = texture(u_material.m_metallicMap, uv, k_lodBias).r
+	float metallic = texture(u_metallicMap, uv, k_lodBias).r
 								* u_material.m_metallicValue;
 
 	/////////////////////////////////////////////
@@ -87,12 +80,12 @@ void main()
 	o_gbuffer0.xy = normal.xy;
 
 	//(1) vec4(albedo.xyz, n.y)
-	o_gbuffer1.rgb = texture(u_material.m_diffuseMap, uv, k_lodBias).rgb
-								* u_diffuseColor.rgb;
+	o_gbuffer1.rgb = texture(u_diffuseMap, uv, k_lodBias).rgb
+								* u_material.m_diffuseColor.rgb;
 	o_gbuffer1.a = metallic;
 
 	//(3) vec4(emissive.xyz, roughness.x)
-	o_gbuffer2.rgb = EncodeQuantization(texture(u_material.m_emissiveMap, uv, k_lodBias).rgb
+	o_gbuffer2.rgb = EncodeQuantization(texture(u_emissiveMap, uv, k_lodBias).rgb
 								* u_material.m_emissiveStrength, 12);
 	o_gbuffer2.a = roughness;
 }
\ No newline at end of file
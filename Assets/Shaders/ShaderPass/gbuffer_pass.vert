@@ -1,10 +1,14 @@
 #version 330 core
+#pragma shader_feature USE_NORMALMAP
 layout (location = 0) in vec3 inPos;
 layout (location = 1) in vec3 inNormal;
 layout (location = 2) in vec2 inTexCoord;
 layout (location = 3) in vec3 inTangent;
 layout (location = 4) in mat4 inInstanceModel;
 
+#include "ShaderLibrary/skinning.glsl"
+#include "ShaderLibrary/mesh_vertex.glsl"
+
 out VS_OUT
 {
 	vec2 ourTexCoord;
@@ -25,30 +29,29 @@ layout (std140) uniform u_matrices
 uniform mat4 u_model;
 uniform bool u_instanceRendering = false;
 
-uniform bool u_useNormalmap = false;
-
 void main()
 {
 	mat4 model = u_instanceRendering? inInstanceModel:u_model;
+	mat4 skin = GetSkinMatrix();
+	vec4 positionOS = skin * vec4(DecodePosition(inPos), 1.0);
 
-	vs_out.ourTexCoord = inTexCoord;
+	vs_out.ourTexCoord = DecodeTexCoord(inTexCoord);
 
 	//Fragment position in worldspace
-	vs_out.ourFragPos = (model * vec4(inPos, 1.0)).xyz;
+	vs_out.ourFragPos = (model * positionOS).xyz;
 
-	gl_Position = u_vp * model * vec4(inPos, 1.0f);
+	gl_Position = u_vp * model * positionOS;
 	
 	// NormalOS to NormalWS
 	// Support Non-uniform scaling
 	mat3 inverseTransposeModel = mat3(transpose(inverse(u_model)));
-	vs_out.ourFragNormal = normalize(inverseTransposeModel * inNormal);
+	vs_out.ourFragNormal = normalize(inverseTransposeModel * mat3(skin) * DecodeNormal(inNormal));
 
 	//Calculate TBN only if use Normal map
-	if(u_useNormalmap)
-	{
-		//TBN
-		vec3 T = normalize(vec3(inverseTransposeModel * inTangent));
-		vec3 B = normalize(cross(vs_out.ourFragNormal, T));
-		vs_out.ourTBNMatrix = mat3(T, B, vs_out.ourFragNormal);
-	}
+#ifdef USE_NORMALMAP
+	//TBN
+	vec3 T = normalize(vec3(inverseTransposeModel * mat3(skin) * DecodeTangent(inTangent)));
+	vec3 B = normalize(cross(vs_out.ourFragNormal, T));
+	vs_out.ourTBNMatrix = mat3(T, B, vs_out.ourFragNormal);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 330 core
+out vec4 FragColor;
+
+in VS_OUT
+{
+	vec2 ourCorner;
+	vec4 ourColor;
+} fs_in;
+
+void main()
+{
+	//Soft round sprite, fade out toward the edge of the quad
+	float distanceSq = dot(fs_in.ourCorner, fs_in.ourCorner);
+	if (distanceSq > 1.0f)
+	{
+		discard;
+	}
+
+	float alpha = fs_in.ourColor.a * (1.0f - distanceSq);
+	FragColor = vec4(fs_in.ourColor.rgb, alpha);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+layout (location = 0) in vec2 inCorner;
+layout (location = 4) in vec4 inPositionSize;
+layout (location = 5) in vec4 inColor;
+
+out VS_OUT
+{
+	vec2 ourCorner;
+	vec4 ourColor;
+} vs_out;
+
+//***************************************
+// Uniforms
+//***************************************
+uniform mat4 u_vp;
+uniform vec3 u_cameraRight;
+uniform vec3 u_cameraUp;
+
+void main()
+{
+	//Billboard facing the camera, sized in world units
+	vec3 positionWS = inPositionSize.xyz
+		+ (u_cameraRight * inCorner.x + u_cameraUp * inCorner.y) * inPositionSize.w;
+
+	vs_out.ourCorner = inCorner * 2.0f;
+	vs_out.ourColor = inColor;
+	gl_Position = u_vp * vec4(positionWS, 1.0f);
+}
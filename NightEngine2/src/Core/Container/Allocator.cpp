@@ -0,0 +1,309 @@
+/*!
+  @file Allocator.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Allocator
+*/
+
+#include "Core/Container/Allocator.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+//*****************************************************
+// Global heap allocation counter
+//*****************************************************
+static std::atomic<NightEngine::Container::U64> g_globalAllocationCount{ 0 };
+
+//Constant initialized, safe to touch from operator new during thread startup
+static thread_local NightEngine::Container::U64 t_threadAllocationCount = 0;
+
+static inline void CountAllocation(void)
+{
+#if MEMORY_TRACKING_ENABLED
+  g_globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  ++t_threadAllocationCount;
+#endif
+}
+
+#if MEMORY_TRACKING_ENABLED
+void* operator new(std::size_t size)
+{
+  CountAllocation();
+  size = size == 0 ? 1 : size;
+  while (true)
+  {
+    void* ptr = std::malloc(size);
+    if (ptr != nullptr)
+    {
+      return ptr;
+    }
+
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  CountAllocation();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+#endif
+
+namespace NightEngine
+{
+  namespace Container
+  {
+    //*****************************************************
+    // Tagged Heap
+    //*****************************************************
+    namespace TaggedHeap
+    {
+      struct TagCounter
+      {
+        std::atomic<U64> m_liveBytes{ 0 };
+        std::atomic<U64> m_peakBytes{ 0 };
+        std::atomic<U64> m_liveAllocations{ 0 };
+        std::atomic<U64> m_totalAllocations{ 0 };
+      };
+
+      static TagCounter g_tagCounters[static_cast<size_t>(MemoryTag::COUNT)];
+
+      static const char* g_tagNames[] =
+      {
+        "General",
+        "ECS",
+        "Rendering",
+        "Physics",
+        "Message",
+        "Resource",
+        "Editor",
+        "Frame"
+      };
+      static_assert(sizeof(g_tagNames) / sizeof(g_tagNames[0])
+        == static_cast<size_t>(MemoryTag::COUNT), "Missing MemoryTag name");
+
+      void* Allocate(size_t size, MemoryTag tag, size_t alignment)
+      {
+        void* ptr = nullptr;
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+          //Aligned new doesn't go through the counted operator new
+          CountAllocation();
+          ptr = ::operator new(size, std::align_val_t(alignment));
+        }
+        else
+        {
+          ptr = ::operator new(size);
+        }
+
+        TrackAllocation(size, tag);
+        return ptr;
+      }
+
+      void Deallocate(void* ptr, size_t size, MemoryTag tag, size_t alignment)
+      {
+        if (ptr == nullptr)
+        {
+          return;
+        }
+
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+          ::operator delete(ptr, std::align_val_t(alignment));
+        }
+        else
+        {
+          ::operator delete(ptr);
+        }
+
+        TrackDeallocation(size, tag);
+      }
+
+      void TrackAllocation(size_t size, MemoryTag tag)
+      {
+        TagCounter& counter = g_tagCounters[static_cast<size_t>(tag)];
+        U64 liveBytes = counter.m_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        counter.m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+        counter.m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        U64 peak = counter.m_peakBytes.load(std::memory_order_relaxed);
+        while (liveBytes > peak
+          && !counter.m_peakBytes.compare_exchange_weak(peak, liveBytes, std::memory_order_relaxed))
+        {
+        }
+      }
+
+      void TrackDeallocation(size_t size, MemoryTag tag)
+      {
+        TagCounter& counter = g_tagCounters[static_cast<size_t>(tag)];
+        counter.m_liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        counter.m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+      }
+
+      MemoryTagStats GetStats(MemoryTag tag)
+      {
+        const TagCounter& counter = g_tagCounters[static_cast<size_t>(tag)];
+        MemoryTagStats stats;
+        stats.m_liveBytes = counter.m_liveBytes.load(std::memory_order_relaxed);
+        stats.m_peakBytes = counter.m_peakBytes.load(std::memory_order_relaxed);
+        stats.m_liveAllocations = counter.m_liveAllocations.load(std::memory_order_relaxed);
+        stats.m_totalAllocations = counter.m_totalAllocations.load(std::memory_order_relaxed);
+        return stats;
+      }
+
+      const char* GetTagName(MemoryTag tag)
+      {
+        return g_tagNames[static_cast<size_t>(tag)];
+      }
+
+      U64 GetGlobalAllocationCount(void)
+      {
+        return g_globalAllocationCount.load(std::memory_order_relaxed);
+      }
+
+      U64 GetThreadAllocationCount(void)
+      {
+        return t_threadAllocationCount;
+      }
+    }
+
+    //*****************************************************
+    // Linear Arena
+    //*****************************************************
+    LinearArena::LinearArena(size_t capacity, MemoryTag tag)
+      : m_capacity(capacity), m_tag(tag)
+    {
+      m_buffer = static_cast<U8*>(TaggedHeap::Allocate(m_capacity, m_tag));
+    }
+
+    LinearArena::~LinearArena()
+    {
+      Reset();
+      TaggedHeap::Deallocate(m_buffer, m_capacity, m_tag);
+    }
+
+    void* LinearArena::Allocate(size_t size, size_t alignment)
+    {
+      size_t offset = m_offset.load(std::memory_order_relaxed);
+      size_t alignedOffset = 0;
+      do
+      {
+        //Align the address, the buffer itself is only max_align_t aligned
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer);
+        alignedOffset = AlignUp(base + offset, alignment) - base;
+        if (alignedOffset + size > m_capacity)
+        {
+          return AllocateOverflow(size, alignment);
+        }
+      } while (!m_offset.compare_exchange_weak(offset, alignedOffset + size
+        , std::memory_order_relaxed));
+
+      return m_buffer + alignedOffset;
+    }
+
+    void* LinearArena::AllocateOverflow(size_t size, size_t alignment)
+    {
+      void* ptr = TaggedHeap::Allocate(size, m_tag, alignment);
+
+      std::lock_guard<std::mutex> guard(m_overflowMutex);
+      m_overflowBlocks.emplace_back(OverflowBlock{ ptr, size, alignment });
+      m_overflowBytes += size;
+      return ptr;
+    }
+
+    void LinearArena::Reset(void)
+    {
+      size_t used = m_offset.load(std::memory_order_relaxed);
+      m_peakBytes = std::max(m_peakBytes, used + m_overflowBytes);
+
+      if (!m_overflowBlocks.empty())
+      {
+        for (auto& block : m_overflowBlocks)
+        {
+          TaggedHeap::Deallocate(block.m_ptr, block.m_size, m_tag, block.m_alignment);
+        }
+        m_overflowBlocks.clear();
+
+        //Grow so the next frame fit without overflow
+        size_t newCapacity = std::max(m_capacity * 2, AlignUp(m_peakBytes, 4096));
+        Debug::Log << Logger::MessageType::WARNING << "LinearArena overflowed by "
+          << m_overflowBytes << " bytes, grow to " << newCapacity << " bytes\n";
+
+        TaggedHeap::Deallocate(m_buffer, m_capacity, m_tag);
+        m_capacity = newCapacity;
+        m_buffer = static_cast<U8*>(TaggedHeap::Allocate(m_capacity, m_tag));
+        m_overflowBytes = 0;
+      }
+
+      m_offset.store(0, std::memory_order_relaxed);
+    }
+
+    bool LinearArena::Owns(const void* ptr) const
+    {
+      const U8* bytePtr = static_cast<const U8*>(ptr);
+      return bytePtr >= m_buffer && bytePtr < m_buffer + m_capacity;
+    }
+
+    LinearArena& GetFrameArena(void)
+    {
+      static LinearArena s_frameArena{ c_DEFAULT_FRAME_ARENA_SIZE, MemoryTag::FRAME };
+      return s_frameArena;
+    }
+
+    //*****************************************************
+    // Pool Allocator
+    //*****************************************************
+    PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerPage, MemoryTag tag)
+      : m_blockSize(AlignUp(std::max(blockSize, sizeof(FreeBlock)), alignof(std::max_align_t)))
+      , m_blocksPerPage(blocksPerPage), m_tag(tag)
+    {
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+      for (void* page : m_pages)
+      {
+        TaggedHeap::Deallocate(page, m_blockSize * m_blocksPerPage, m_tag);
+      }
+      m_pages.clear();
+      m_freeList = nullptr;
+    }
+
+    void PoolAllocator::AllocatePage(void)
+    {
+      U8* page = static_cast<U8*>(TaggedHeap::Allocate(m_blockSize * m_blocksPerPage, m_tag));
+      m_pages.emplace_back(page);
+
+      //Thread the new blocks into the free list, lowest address first
+      for (size_t i = m_blocksPerPage; i > 0; --i)
+      {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(page + (i - 1) * m_blockSize);
+        block->m_next = m_freeList;
+        m_freeList = block;
+      }
+    }
+  }
+}
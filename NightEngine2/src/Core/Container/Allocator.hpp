@@ -0,0 +1,303 @@
+/*!
+  @file Allocator.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Allocator
+*/
+
+#pragma once
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/Hashmap.hpp"
+#include "Core/Macros.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace NightEngine
+{
+  namespace Container
+  {
+    //! @brief Subsystem that own an allocation, for memory statistics
+    enum class MemoryTag : U8
+    {
+      GENERAL = 0,
+      ECS,
+      RENDERING,
+      PHYSICS,
+      MESSAGE,
+      RESOURCE,
+      EDITOR,
+      FRAME,
+      COUNT
+    };
+
+    //! @brief Snapshot of a MemoryTag statistic
+    struct MemoryTagStats
+    {
+      U64 m_liveBytes = 0;
+      U64 m_peakBytes = 0;
+      U64 m_liveAllocations = 0;
+      U64 m_totalAllocations = 0;
+    };
+
+    //! @brief Default capacity of the frame arena, grow on overflow
+    constexpr size_t c_DEFAULT_FRAME_ARENA_SIZE = 4u << 20;
+
+    //! @brief Default blocks per page of a PoolAllocator
+    constexpr size_t c_DEFAULT_POOL_PAGE_BLOCKS = 256;
+
+    //! @brief Round up to the power of two alignment
+    inline size_t AlignUp(size_t value, size_t alignment)
+    {
+      return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    //*****************************************************
+    // Tagged Heap
+    //*****************************************************
+    namespace TaggedHeap
+    {
+      //! @brief Allocate from the heap and account it to tag
+      void* Allocate(size_t size, MemoryTag tag
+        , size_t alignment = alignof(std::max_align_t));
+
+      //! @brief Free memory from Allocate, size/tag/alignment must match
+      void Deallocate(void* ptr, size_t size, MemoryTag tag
+        , size_t alignment = alignof(std::max_align_t));
+
+      //! @brief Account memory that came from somewhere else
+      void TrackAllocation(size_t size, MemoryTag tag);
+
+      //! @brief Account memory that came from somewhere else
+      void TrackDeallocation(size_t size, MemoryTag tag);
+
+      //! @brief Get statistic of a tag
+      MemoryTagStats GetStats(MemoryTag tag);
+
+      //! @brief Get display name of a tag
+      const char* GetTagName(MemoryTag tag);
+
+      //! @brief Amount of global heap allocations (operator new) since startup,
+      // always 0 when MEMORY_TRACKING_ENABLED is off
+      U64 GetGlobalAllocationCount(void);
+
+      //! @brief Same as GetGlobalAllocationCount but only the calling thread's allocations
+      U64 GetThreadAllocationCount(void);
+    }
+
+    //*****************************************************
+    // Linear Arena
+    //*****************************************************
+    //! @brief Thread-safe bump allocator, everything is freed at once by Reset().
+    // Allocations beyond the capacity fall back to the heap until the next Reset(),
+    // which then grow the buffer to fit.
+    class LinearArena
+    {
+    public:
+      explicit LinearArena(size_t capacity = c_DEFAULT_FRAME_ARENA_SIZE
+        , MemoryTag tag = MemoryTag::FRAME);
+      ~LinearArena();
+
+      LinearArena(const LinearArena&) = delete;
+      LinearArena& operator=(const LinearArena&) = delete;
+
+      //! @brief Allocate, lock-free unless the arena overflow
+      void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+      //! @brief Free everything, must not race with Allocate()
+      void Reset(void);
+
+      //! @brief Check if ptr is inside the arena buffer
+      bool Owns(const void* ptr) const;
+
+      size_t GetUsedBytes(void) const { return m_offset.load(std::memory_order_relaxed); }
+      size_t GetCapacity(void) const { return m_capacity; }
+      size_t GetPeakBytes(void) const { return m_peakBytes; }
+      size_t GetOverflowBytes(void) const { return m_overflowBytes; }
+    private:
+      void* AllocateOverflow(size_t size, size_t alignment);
+
+      struct OverflowBlock
+      {
+        void*  m_ptr;
+        size_t m_size;
+        size_t m_alignment;
+      };
+
+      U8*                       m_buffer = nullptr;
+      size_t                    m_capacity = 0;
+      MemoryTag                 m_tag;
+      std::atomic<size_t>       m_offset{ 0 };
+      size_t                    m_peakBytes = 0;
+
+      std::mutex                 m_overflowMutex;
+      std::vector<OverflowBlock> m_overflowBlocks;
+      size_t                     m_overflowBytes = 0;
+    };
+
+    //! @brief Global per-frame arena, reset at GameTime::EndFrame()
+    LinearArena& GetFrameArena(void);
+
+    //*****************************************************
+    // Pool Allocator
+    //*****************************************************
+    //! @brief Fixed size block allocator growing by pages, not thread-safe.
+    // Use GetThreadLocalPool() for a pool per thread.
+    class PoolAllocator
+    {
+    public:
+      explicit PoolAllocator(size_t blockSize
+        , size_t blocksPerPage = c_DEFAULT_POOL_PAGE_BLOCKS
+        , MemoryTag tag = MemoryTag::GENERAL);
+      ~PoolAllocator();
+
+      PoolAllocator(const PoolAllocator&) = delete;
+      PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+      //! @brief Pop a block from the free list
+      inline void* Allocate(void)
+      {
+        if (m_freeList == nullptr)
+        {
+          AllocatePage();
+        }
+
+        FreeBlock* block = m_freeList;
+        m_freeList = block->m_next;
+        ++m_liveBlocks;
+        return block;
+      }
+
+      //! @brief Push the block back to the free list
+      inline void Deallocate(void* ptr)
+      {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->m_next = m_freeList;
+        m_freeList = block;
+        --m_liveBlocks;
+      }
+
+      //! @brief Construct T in a block
+      template<typename T, typename ... ARGS>
+      T* New(ARGS&& ... args)
+      {
+        ASSERT_TRUE(sizeof(T) <= m_blockSize && alignof(T) <= alignof(std::max_align_t));
+        return new (Allocate()) T(std::forward<ARGS>(args)...);
+      }
+
+      //! @brief Destruct T and free its block
+      template<typename T>
+      void Delete(T* ptr)
+      {
+        if (ptr != nullptr)
+        {
+          ptr->~T();
+          Deallocate(ptr);
+        }
+      }
+
+      size_t GetBlockSize(void) const { return m_blockSize; }
+      size_t GetLiveBlocks(void) const { return m_liveBlocks; }
+      size_t GetPageCount(void) const { return m_pages.size(); }
+    private:
+      struct FreeBlock
+      {
+        FreeBlock* m_next;
+      };
+
+      void AllocatePage(void);
+
+      size_t              m_blockSize;
+      size_t              m_blocksPerPage;
+      MemoryTag           m_tag;
+      FreeBlock*          m_freeList = nullptr;
+      std::vector<void*>  m_pages;
+      size_t              m_liveBlocks = 0;
+    };
+
+    //! @brief Pool owned by the calling thread, blocks must be freed on the same thread
+    template<size_t BLOCK_SIZE, MemoryTag TAG = MemoryTag::GENERAL>
+    PoolAllocator& GetThreadLocalPool(void)
+    {
+      thread_local PoolAllocator pool{ BLOCK_SIZE, c_DEFAULT_POOL_PAGE_BLOCKS, TAG };
+      return pool;
+    }
+
+    //*****************************************************
+    // STL Allocators
+    //*****************************************************
+    //! @brief Allocate from the frame arena, deallocate is a no-op.
+    // Memory is only valid until the end of the frame, reserve() up front
+    // since every reallocation leave the old buffer in the arena.
+    template<typename T>
+    struct FrameAllocator
+    {
+      using value_type = T;
+
+      FrameAllocator(void) noexcept = default;
+      template<typename U>
+      FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+      T* allocate(size_t n)
+      {
+        return static_cast<T*>(GetFrameArena().Allocate(n * sizeof(T), alignof(T)));
+      }
+
+      void deallocate(T*, size_t) noexcept {}
+    };
+
+    template<typename T, typename U>
+    inline bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+    template<typename T, typename U>
+    inline bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+    //! @brief Heap allocator accounted to a MemoryTag
+    template<typename T, MemoryTag TAG>
+    struct TaggedAllocator
+    {
+      using value_type = T;
+
+      template<typename U>
+      struct rebind { using other = TaggedAllocator<U, TAG>; };
+
+      TaggedAllocator(void) noexcept = default;
+      template<typename U>
+      TaggedAllocator(const TaggedAllocator<U, TAG>&) noexcept {}
+
+      T* allocate(size_t n)
+      {
+        return static_cast<T*>(TaggedHeap::Allocate(n * sizeof(T), TAG, alignof(T)));
+      }
+
+      void deallocate(T* ptr, size_t n) noexcept
+      {
+        TaggedHeap::Deallocate(ptr, n * sizeof(T), TAG, alignof(T));
+      }
+    };
+
+    template<typename T, typename U, MemoryTag TAG>
+    inline bool operator==(const TaggedAllocator<T, TAG>&, const TaggedAllocator<U, TAG>&) { return true; }
+    template<typename T, typename U, MemoryTag TAG>
+    inline bool operator!=(const TaggedAllocator<T, TAG>&, const TaggedAllocator<U, TAG>&) { return false; }
+
+    //*****************************************************
+    // Allocator-aware Containers
+    //*****************************************************
+    template<typename T>
+    using FrameVector = Vector<T, FrameAllocator<T>>;
+
+    template<typename T, MemoryTag TAG>
+    using TaggedVector = Vector<T, TaggedAllocator<T, TAG>>;
+
+    template<typename KEY, typename VALUE, typename HASH = std::hash<KEY>>
+    using FrameHashmap = HashmapCustom<KEY, VALUE, HASH
+      , FrameAllocator<std::pair<const KEY, VALUE>>>;
+
+    template<typename KEY, typename VALUE, MemoryTag TAG, typename HASH = std::hash<KEY>>
+    using TaggedHashmap = HashmapCustom<KEY, VALUE, HASH
+      , TaggedAllocator<std::pair<const KEY, VALUE>, TAG>>;
+  }
+}
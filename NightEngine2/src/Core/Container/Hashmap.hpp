@@ -12,10 +12,12 @@ namespace NightEngine
 {
   namespace Container
   {
-    template<typename KEY, typename VALUE>
-    using Hashmap = std::unordered_map<KEY, VALUE>;
+    template<typename KEY, typename VALUE
+      , typename ALLOC = std::allocator<std::pair<const KEY, VALUE>>>
+    using Hashmap = std::unordered_map<KEY, VALUE, std::hash<KEY>, std::equal_to<KEY>, ALLOC>;
 
-    template<typename KEY, typename VALUE, typename HASH>
-    using HashmapCustom = std::unordered_map<KEY, VALUE, HASH>;
+    template<typename KEY, typename VALUE, typename HASH
+      , typename ALLOC = std::allocator<std::pair<const KEY, VALUE>>>
+    using HashmapCustom = std::unordered_map<KEY, VALUE, HASH, std::equal_to<KEY>, ALLOC>;
   }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #pragma once
 #include "Core/Container/PrimitiveType.hpp"
+#include <cstddef>
 
 #define MURMURHASH2(TYPE) NightEngine::Container::ConvertToHash(#TYPE, sizeof(#TYPE)-1)
 
@@ -19,12 +20,20 @@ namespace NightEngine
       constexpr U32 shift1{19};
       constexpr U32 shift2{37};
       U64 hash{seed ^ (size * prime)};
-      const U64 *data{(const U64 *)str};
-      const U64 *end{data + (size / 8)};
+      const char *data{str};
+      const char *end{data + (size / 8) * 8};
 
       while (data != end)
       {
-        U64 word{*data++};
+        //Assemble the little-endian word bytewise so the hash is usable
+        //in constant expressions, compilers fold this into a single load
+        U64 word{0};
+        for (U32 i = 0; i < 8; ++i)
+        {
+          word |= static_cast<U64>(static_cast<unsigned char>(data[i])) << (i * 8);
+        }
+        data += 8;
+
         word *= prime;
         word ^= word >> shift1;
         word *= prime;
@@ -32,24 +41,22 @@ namespace NightEngine
         hash *= prime;
       }
 
-      const unsigned char *byte_data{(const unsigned char *)data};
-
       switch (size & 7)
       {
       case 7:
-        hash ^= ((U64)byte_data[6]) << 48;
+        hash ^= ((U64)(unsigned char)data[6]) << 48;
       case 6:
-        hash ^= ((U64)byte_data[5]) << 40;
+        hash ^= ((U64)(unsigned char)data[5]) << 40;
       case 5:
-        hash ^= ((U64)byte_data[4]) << 32;
+        hash ^= ((U64)(unsigned char)data[4]) << 32;
       case 4:
-        hash ^= ((U64)byte_data[3]) << 24;
+        hash ^= ((U64)(unsigned char)data[3]) << 24;
       case 3:
-        hash ^= ((U64)byte_data[2]) << 16;
+        hash ^= ((U64)(unsigned char)data[2]) << 16;
       case 2:
-        hash ^= ((U64)byte_data[1]) << 8;
+        hash ^= ((U64)(unsigned char)data[1]) << 8;
       case 1:
-        hash ^= ((U64)byte_data[0]);
+        hash ^= ((U64)(unsigned char)data[0]);
       }
 
       hash ^= hash >> shift1;
@@ -4,6 +4,11 @@
   @brief Contain the Interface of Slotmap
 */
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 #include "Core/Container/Vector.hpp"
@@ -48,6 +53,16 @@ namespace NightEngine
 		template<typename T>
 		using SlotEntry = std::pair<SlotEntryLabel, T>;
 
+    //! @brief How a slot differ from a state written by Slotmap::WriteState
+    enum class SlotChange : U8
+    {
+      NONE = 0,   //Inactive on both sides
+      KEPT,       //Same object on both sides
+      DROPPED,    //Only active now
+      REVIVED,    //Only active in the state
+      REPLACED    //Active on both sides, but not the same object
+    };
+
     //! @brief Container for storing T
 		template<typename T>
 		class Slotmap
@@ -148,6 +163,9 @@ namespace NightEngine
       //! @brief Set the reserve option
 			void			Reserve(size_t reserveAmount, U32 expandRate);
 
+      //! @brief Grow once so the next count CreateSlot() won't expand the array
+			void			EnsureFreeSlots(size_t count);
+
       //! @brief Get the amount of total active slot
 			size_t		Size() { return m_array.size() - m_freelist.size(); }
 
@@ -156,7 +174,47 @@ namespace NightEngine
 
       //! @brief Clear the Slotmap
       void Clear(void) { m_array.clear(); m_freelist.clear(); m_head = NullIndex; m_tail = NullIndex; m_lastCreated = NullIndex; }
+
+      //! @brief Bytes needed by WriteState
+      size_t    GetStateSize(void) const;
+
+      //! @brief Copy the slots and the freelist into memory,
+      // memory must be aligned to alignof(std::max_align_t)
+      void      WriteState(U8* memory) const;
+
+      //! @brief Put back a state written by WriteState. The slots are assigned in place,
+      // slots expanded since then are kept free. Only reallocate if the array got smaller (after Clear)
+      void      ReadState(const U8* memory);
+
+      //! @brief Destroy the objects copied by WriteState
+      static void ReleaseState(U8* memory);
+
+      //! @brief Compare each slot with a state written by WriteState
+      void      CompareState(const U8* memory, Container::Vector<SlotChange>& changes) const;
 		private:
+      //! @brief Header of the memory written by WriteState
+      struct State
+      {
+        U64 m_arraySize;
+        U64 m_freelistSize;
+        U32 m_head;
+        U32 m_tail;
+        U32 m_lastCreated;
+      };
+
+      //! @brief Entries follow the header, the freelist follow the entries
+      static size_t GetStateEntriesOffset(void)
+      {
+        constexpr size_t alignment = alignof(SlotEntry<T>);
+        return (sizeof(State) + alignment - 1) & ~(alignment - 1);
+      }
+
+      static size_t GetStateFreelistOffset(size_t arraySize)
+      {
+        constexpr size_t alignment = alignof(U32);
+        return (GetStateEntriesOffset() + arraySize * sizeof(SlotEntry<T>) + alignment - 1) & ~(alignment - 1);
+      }
+
 			U32 m_expandRate;
 
 			Container::Vector<SlotEntry<T>> m_array;  //Actual data
@@ -294,5 +352,164 @@ namespace NightEngine
 			m_array.reserve(reserveAmount);
 			m_freelist.reserve(expandRate);
 		}
+
+		template<typename T>
+		inline void Slotmap<T>::EnsureFreeSlots(size_t count)
+		{
+			if (m_freelist.size() >= count)
+			{
+				return;
+			}
+
+			//Same layout as the expansion in CreateSlot, lowest index on the back
+			size_t size = m_array.size();
+			size_t expandAmount = count - m_freelist.size();
+			m_array.reserve(size + expandAmount);
+			m_freelist.reserve(count);
+			for (size_t i = expandAmount; i > 0; --i)
+			{
+				SlotEntry<T> entry{ { false,0, NullIndex, NullIndex } , T() };
+				m_array.emplace_back(std::move(entry));
+				m_freelist.emplace_back(static_cast<U32>(size + i - 1));
+			}
+		}
+
+    //***************************************
+		// Slotmap State Definition
+    //***************************************
+		template<typename T>
+		inline size_t Slotmap<T>::GetStateSize(void) const
+		{
+			return GetStateFreelistOffset(m_array.size()) + m_freelist.size() * sizeof(U32);
+		}
+
+		template<typename T>
+		void Slotmap<T>::WriteState(U8* memory) const
+		{
+			static_assert(alignof(SlotEntry<T>) <= alignof(std::max_align_t)
+				, "SlotEntry is over-aligned for the state memory");
+
+			size_t arraySize = m_array.size();
+			new (memory) State{ arraySize, m_freelist.size(), m_head, m_tail, m_lastCreated };
+
+			//Trivially copyable objects are copied as raw bytes, the others with their copy constructor
+			auto entries = reinterpret_cast<SlotEntry<T>*>(memory + GetStateEntriesOffset());
+			if constexpr (std::is_trivially_copyable<T>::value)
+			{
+				std::memcpy(static_cast<void*>(entries), m_array.data(), arraySize * sizeof(SlotEntry<T>));
+			}
+			else
+			{
+				for (size_t i = 0; i < arraySize; ++i)
+				{
+					new (entries + i) SlotEntry<T>(m_array[i]);
+				}
+			}
+
+			std::memcpy(memory + GetStateFreelistOffset(arraySize)
+				, m_freelist.data(), m_freelist.size() * sizeof(U32));
+		}
+
+		template<typename T>
+		void Slotmap<T>::ReadState(const U8* memory)
+		{
+			auto state = reinterpret_cast<const State*>(memory);
+			auto entries = reinterpret_cast<const SlotEntry<T>*>(memory + GetStateEntriesOffset());
+			size_t arraySize = static_cast<size_t>(state->m_arraySize);
+
+			//Slots expanded since the state stay as free slots, handles to them must stay in range
+			size_t currentSize = m_array.size();
+			size_t assignSize = std::min(currentSize, arraySize);
+			for (size_t i = 0; i < currentSize; ++i)
+			{
+				SlotEntryLabel& label = m_array[i].first;
+				U64 nextGeneration = label.m_generation + label.m_active;
+
+				if (i >= assignSize)
+				{
+					label.m_active = false;
+					label.m_lastActiveIndex = NullIndex;
+					label.m_nextActiveIndex = NullIndex;
+				}
+				else if constexpr (std::is_trivially_copyable<T>::value)
+				{
+					std::memcpy(static_cast<void*>(&m_array[i]), entries + i, sizeof(SlotEntry<T>));
+				}
+				else
+				{
+					label = entries[i].first;
+					m_array[i].second = entries[i].second;
+				}
+
+				//Free slots skip the generations used since the state,
+				// handles to objects created since then won't match the next CreateSlot()
+				if (!label.m_active && nextGeneration > label.m_generation)
+				{
+					label.m_generation = nextGeneration;
+				}
+			}
+
+			for (size_t i = assignSize; i < arraySize; ++i)
+			{
+				m_array.emplace_back(entries[i]);
+			}
+
+			//Extra slots go first, the state freelist keep its order on the back
+			auto freelist = reinterpret_cast<const U32*>(memory + GetStateFreelistOffset(arraySize));
+			m_freelist.clear();
+			for (size_t i = currentSize; i > assignSize; --i)
+			{
+				m_freelist.emplace_back(static_cast<U32>(i - 1));
+			}
+			m_freelist.insert(m_freelist.end(), freelist, freelist + state->m_freelistSize);
+
+			m_head = state->m_head;
+			m_tail = state->m_tail;
+			m_lastCreated = state->m_lastCreated;
+		}
+
+		template<typename T>
+		void Slotmap<T>::ReleaseState(U8* memory)
+		{
+			if constexpr (!std::is_trivially_copyable<T>::value)
+			{
+				auto state = reinterpret_cast<const State*>(memory);
+				auto entries = reinterpret_cast<SlotEntry<T>*>(memory + GetStateEntriesOffset());
+				for (size_t i = 0; i < state->m_arraySize; ++i)
+				{
+					entries[i].~SlotEntry<T>();
+				}
+			}
+		}
+
+		template<typename T>
+		void Slotmap<T>::CompareState(const U8* memory
+			, Container::Vector<SlotChange>& changes) const
+		{
+			auto state = reinterpret_cast<const State*>(memory);
+			auto entries = reinterpret_cast<const SlotEntry<T>*>(memory + GetStateEntriesOffset());
+			size_t arraySize = static_cast<size_t>(state->m_arraySize);
+
+			changes.assign(std::max(arraySize, m_array.size()), SlotChange::NONE);
+			for (size_t i = 0; i < changes.size(); ++i)
+			{
+				bool activeNow = i < m_array.size() && m_array[i].first.m_active;
+				bool activeInState = i < arraySize && entries[i].first.m_active;
+				if (activeNow && activeInState)
+				{
+					//Generation only change on Destroy, it tell if the slot was reused
+					changes[i] = m_array[i].first.m_generation == entries[i].first.m_generation
+						? SlotChange::KEPT : SlotChange::REPLACED;
+				}
+				else if (activeNow)
+				{
+					changes[i] = SlotChange::DROPPED;
+				}
+				else if (activeInState)
+				{
+					changes[i] = SlotChange::REVIVED;
+				}
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*!
+  @file StringIntern.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of StringIntern
+*/
+
+#include "Core/Container/StringIntern.hpp"
+#include "Core/Macros.hpp"
+
+#include <mutex>
+
+namespace NightEngine
+{
+  namespace Container
+  {
+    namespace StringIntern
+    {
+      //Node based map, interned strings never move
+      using InternTable = StringIDMap<String>;
+
+      static InternTable& GetTable(void)
+      {
+        static InternTable table;
+        return table;
+      }
+
+      static std::mutex& GetMutex(void)
+      {
+        static std::mutex mutex;
+        return mutex;
+      }
+
+      StringID Intern(const char* str)
+      {
+        return Intern(String{ str });
+      }
+
+      StringID Intern(const String& str)
+      {
+        StringID id = ToStringID(str);
+
+        std::lock_guard<std::mutex> guard(GetMutex());
+        auto result = GetTable().emplace(id, str);
+
+        //Two different strings with the same id would alias every lookup
+        ASSERT_MSG(result.first->second == str, "StringID collision between \""
+          << result.first->second << "\" and \"" << str << '\"');
+        return id;
+      }
+
+      const char* GetString(StringID id)
+      {
+        std::lock_guard<std::mutex> guard(GetMutex());
+        auto& table = GetTable();
+        auto it = table.find(id);
+        return it != table.end() ? it->second.c_str() : nullptr;
+      }
+
+      size_t GetCount(void)
+      {
+        std::lock_guard<std::mutex> guard(GetMutex());
+        return GetTable().size();
+      }
+    }
+  }
+}
@@ -0,0 +1,82 @@
+/*!
+  @file StringIntern.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of StringIntern
+*/
+
+#pragma once
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Core/Container/Hashmap.hpp"
+#include "Core/Container/String.hpp"
+
+#include <type_traits>
+
+//! @brief StringID of a string literal, always evaluated at compile time
+#define STRING_ID(STR) (std::integral_constant<NightEngine::Container::StringID \
+  , NightEngine::Container::ConvertToHash(STR, sizeof(STR) - 1)>::value)
+
+namespace NightEngine
+{
+  namespace Container
+  {
+    //! @brief Murmur2A64 hash of a string, used as a key instead of the string itself
+    using StringID = U64;
+
+    //! @brief Index into a dense registry array
+    using DenseIndex = U32;
+    constexpr DenseIndex c_INVALID_DENSE_INDEX = ~DenseIndex(0);
+
+    //! @brief Length of null terminated string, usable in constant expressions
+    constexpr size_t ConstStringLength(const char* str)
+    {
+      size_t length = 0;
+      while (str[length] != '\0')
+      {
+        ++length;
+      }
+      return length;
+    }
+
+    //! @brief Hash a null terminated string into StringID
+    constexpr StringID ToStringID(const char* str)
+    {
+      return ConvertToHash(str, ConstStringLength(str));
+    }
+
+    //! @brief Hash a string into StringID
+    inline StringID ToStringID(const String& str)
+    {
+      return ConvertToHash(str.c_str(), str.size());
+    }
+
+    //! @brief StringID is already a hash, use it as it is
+    struct StringIDHash
+    {
+      size_t operator()(StringID id) const { return static_cast<size_t>(id); }
+    };
+
+    //! @brief Map from StringID, mostly to a DenseIndex
+    template<typename VALUE>
+    using StringIDMap = HashmapCustom<StringID, VALUE, StringIDHash>;
+
+    //*****************************************************
+    // Global String Intern Table
+    //*****************************************************
+    namespace StringIntern
+    {
+      //! @brief Add string to the global table and return its StringID,
+      // assert if another string already own the same hash
+      StringID Intern(const char* str);
+
+      //! @brief Add string to the global table and return its StringID
+      StringID Intern(const String& str);
+
+      //! @brief Get the interned string of id, nullptr if never interned
+      const char* GetString(StringID id);
+
+      //! @brief Amount of interned strings
+      size_t GetCount(void);
+    }
+  }
+}
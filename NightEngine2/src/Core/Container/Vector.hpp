@@ -12,7 +12,7 @@ namespace NightEngine
 {
   namespace Container
   {
-    template<typename T>
-    using Vector = std::vector<T>;
+    template<typename T, typename ALLOC = std::allocator<T>>
+    using Vector = std::vector<T, ALLOC>;
   }
 }
\ No newline at end of file
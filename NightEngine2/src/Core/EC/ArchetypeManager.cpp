@@ -6,12 +6,15 @@
 
 #include "ArchetypeManager.hpp"
 #include "Core/EC/Archetype.hpp"
+#include "Core/EC/Blueprint.hpp"
 
 #include "Core/EC/GameObject.hpp"
 #include "Core/Reflection/ReflectionMacros.hpp"
 
 #include "Core/Reflection/Variable.hpp"
 
+#include <memory>
+
 using namespace NightEngine::Reflection;
 
 namespace NightEngine
@@ -23,6 +26,9 @@ namespace NightEngine
       ArchetypeList g_archetypeList;
       std::string   g_archetypeListFileName{ "ArchetypeList.archetypelist"};
 
+      //Compiled Blueprints by name
+      Container::Map<Container::String, std::unique_ptr<Blueprint>> g_blueprints;
+
       //TODO: Blueprint Track/Link System
 
       JsonValue SerializeArchetypeList(Reflection::Variable& variable)
@@ -89,6 +95,7 @@ namespace NightEngine
       void Terminate(void)
       {
         Debug::Log << "ArchetypeManager::Terminate\n";
+        g_blueprints.clear();
       }
 
       ///////////////////////////////////////////////////////////
@@ -103,18 +110,63 @@ namespace NightEngine
 
         Debug::Log << Logger::MessageType::INFO
           << "Saved Blueprint:" << fileName << '\n';
+
+        RefreshBlueprint(name);
       }
 
       void LoadBlueprint(const std::string & name, NightEngine::EC::GameObject& gameObject)
       {
+        Blueprint* blueprint = GetBlueprint(name);
+        if (blueprint != nullptr)
+        {
+          blueprint->Apply(gameObject);
+
+          Debug::Log << Logger::MessageType::INFO
+            << "Load Blueprint:" << name << ".bp\n";
+        }
+      }
+
+      Blueprint* GetBlueprint(const std::string& name)
+      {
+        auto it = g_blueprints.find(name);
+        if (it != g_blueprints.end())
+        {
+          return it->second.get();
+        }
+
+        //Parse the file once, instances are built from the compiled image
         std::string fileName{ name };
         fileName += ".bp";
-        Serialization::Deserialize(gameObject
-          , fileName
+        std::string json = FileSystem::OpenFileAsString(fileName
           , FileSystem::DirectoryType::Archetypes);
 
-        Debug::Log << Logger::MessageType::INFO 
-          << "Load Blueprint:" << fileName << '\n';
+        auto blueprint = std::make_unique<Blueprint>();
+        if (json.empty() || !blueprint->CompileFromString(json))
+        {
+          Debug::Log << Logger::MessageType::WARNING
+            << "Blueprint Compile Failed: " << fileName << '\n';
+          return nullptr;
+        }
+
+        Blueprint* result = blueprint.get();
+        g_blueprints.insert({ name, std::move(blueprint) });
+        return result;
+      }
+
+      void RefreshBlueprint(const std::string& name)
+      {
+        g_blueprints.erase(name);
+      }
+
+      void InstantiateBlueprint(const std::string& name, size_t count
+        , const InstanceTransform* transforms
+        , Container::Vector<Handle<GameObject>>& outGameObjects)
+      {
+        Blueprint* blueprint = GetBlueprint(name);
+        if (blueprint != nullptr)
+        {
+          blueprint->Instantiate(count, transforms, outGameObjects);
+        }
       }
 
       ///////////////////////////////////////////////////////////
@@ -11,6 +11,8 @@
 
 #include "Core/Container/Map.hpp"
 #include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/EC/Handle.hpp"
 
 using namespace NightEngine::Serialization;
 
@@ -20,6 +22,8 @@ namespace NightEngine
   {
     class GameObject;
     struct Archetype;
+    class Blueprint;
+    struct InstanceTransform;
 
     namespace ArchetypeManager
     {
@@ -50,10 +54,22 @@ namespace NightEngine
       void SaveToBlueprint(const std::string& name
         , NightEngine::EC::GameObject& gameObject);
 
-      //! @brief Load Blueprint
+      //! @brief Load Blueprint, compiled once and cached
       void LoadBlueprint(const std::string& name
         , NightEngine::EC::GameObject& gameObject);
 
+      //! @brief Get the compiled Blueprint, compile it from file on first use.
+      // Return nullptr if the file can't be compiled
+      Blueprint* GetBlueprint(const std::string& name);
+
+      //! @brief Drop the cached Blueprint, next use recompile from file
+      void RefreshBlueprint(const std::string& name);
+
+      //! @brief Create count instances of a Blueprint in one pass, see Blueprint::Instantiate
+      void InstantiateBlueprint(const std::string& name, size_t count
+        , const InstanceTransform* transforms
+        , Container::Vector<Handle<GameObject>>& outGameObjects);
+
       ///////////////////////////////////////////////////////////
 
       //! @brief Get the Archetype Map
@@ -0,0 +1,230 @@
+/*!
+  @file Blueprint.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Blueprint
+*/
+
+#include "Core/EC/Blueprint.hpp"
+#include "Core/EC/GameObject.hpp"
+#include "Core/EC/ComponentLogic.hpp"
+#include "Core/EC/Factory.hpp"
+
+#include "Core/Container/Allocator.hpp"
+#include "Core/Reflection/ReflectionMacros.hpp"
+#include "Core/Reflection/Variable.hpp"
+#include "Core/Utility/Profiling.hpp"
+#include "Core/Logger.hpp"
+
+#include "taocpp_json/include/tao/json/from_string.hpp"
+
+using namespace NightEngine::Container;
+using namespace NightEngine::Reflection;
+using namespace NightEngine::EC::Components;
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    Blueprint::~Blueprint()
+    {
+      Clear();
+    }
+
+    bool Blueprint::Compile(const ValueObject& gameObjectValue)
+    {
+      PROFILE_ZONE("Blueprint::Compile");
+      Clear();
+
+      auto& obj = gameObjectValue.get_object();
+      auto it = obj.find("m_name");
+      if (it != obj.end())
+      {
+        m_name = it->second.as<Container::String>();
+      }
+
+      //Layout the component images back to back
+      it = obj.find("m_components");
+      if (it != obj.end())
+      {
+        auto& componentMap = it->second.get_object();
+        m_components.reserve(componentMap.size());
+        for (auto& pair : componentMap)
+        {
+          DenseIndex factoryIndex = Factory::g_factory.GetTypeIndex(pair.first.c_str());
+          if (factoryIndex == c_INVALID_DENSE_INDEX)
+          {
+            Debug::Log << Logger::MessageType::ERROR_MSG
+              << "Blueprint component is not registered to the Factory: " << pair.first << '\n';
+            Clear();
+            return false;
+          }
+
+          MetaType* metaType = METATYPE_FROM_STRING(pair.first);
+          auto& info = Factory::g_factory.GetFunctionInfo(factoryIndex);
+          m_imageSize = AlignUp(m_imageSize, alignof(std::max_align_t));
+          m_components.emplace_back(ComponentTemplate{ metaType, factoryIndex, m_imageSize
+            , info.m_copyFn, info.m_destructFn });
+          m_imageSize += metaType->GetSize();
+        }
+
+        //Default construct then deserialize each image
+        m_image = static_cast<U8*>(TaggedHeap::Allocate(std::max<size_t>(m_imageSize, 1)
+          , MemoryTag::ECS));
+        size_t index = 0;
+        for (auto& pair : componentMap)
+        {
+          auto& component = m_components[index++];
+          void* image = m_image + component.m_imageOffset;
+          Factory::g_factory.GetFunctionInfo(component.m_factoryIndex).m_constructFn(image);
+
+          Variable componentVar{ component.m_metaType, image };
+          componentVar.Deserialize(const_cast<ValueObject&>(pair.second));
+        }
+      }
+
+      it = obj.find("m_transform");
+      if (it != obj.end())
+      {
+        Variable transformVar{ METATYPE(Transform), &m_transform };
+        transformVar.Deserialize(const_cast<ValueObject&>(it->second));
+      }
+
+      m_valid = true;
+      return true;
+    }
+
+    bool Blueprint::CompileFromString(const std::string& json)
+    {
+      JsonValue value = tao::json::from_string(json);
+      auto& map = value.get_object();
+      auto it = map.find("GameObject");
+      if (it == map.end())
+      {
+        Debug::Log << Logger::MessageType::ERROR_MSG
+          << "Blueprint json doesn't contain a GameObject\n";
+        return false;
+      }
+
+      return Compile(it->second);
+    }
+
+    void Blueprint::Clear(void)
+    {
+      if (m_image != nullptr)
+      {
+        for (auto& component : m_components)
+        {
+          component.m_destructFn(m_image + component.m_imageOffset);
+        }
+        TaggedHeap::Deallocate(m_image, std::max<size_t>(m_imageSize, 1), MemoryTag::ECS);
+      }
+
+      m_image = nullptr;
+      m_imageSize = 0;
+      m_components.clear();
+      m_name.clear();
+      m_transform = Transform();
+      m_valid = false;
+    }
+
+    void Blueprint::CopyComponent(CopyFN copyFn, void* dst, const void* src)
+    {
+      //Image is default-valued only, identity belong to the instance
+      auto logic = static_cast<ComponentLogic*>(dst);
+      ComponentLogicID uniqueID = logic->m_uniqueID;
+      Handle<GameObject> gameObject = logic->m_gameObject;
+      HandleObject handle = logic->m_handle;
+
+      copyFn(dst, src);
+
+      logic->m_uniqueID = uniqueID;
+      logic->m_gameObject = gameObject;
+      logic->m_handle = handle;
+    }
+
+    void Blueprint::CopyComponent(const ComponentTemplate& component, void* dst) const
+    {
+      CopyComponent(component.m_copyFn, dst, m_image + component.m_imageOffset);
+    }
+
+    void Blueprint::CopyTransform(Transform& dst) const
+    {
+      //Pending move belong to the instance too, a copied flag would hide the next MarkDirty
+      bool dirty = dst.m_dirty;
+      CopyComponent(Factory::FactoryCopy<Transform>, &dst, &m_transform);
+      dst.m_dirty = dirty;
+    }
+
+    void Blueprint::Apply(GameObject& gameObject) const
+    {
+      ASSERT_TRUE(m_valid);
+      gameObject.SetName(m_name);
+
+      for (auto& component : m_components)
+      {
+        ComponentHandle* handle = gameObject.GetComponent(component.m_metaType);
+        if (handle != nullptr)
+        {
+          CopyComponent(component, handle->GetPointer());
+        }
+        else
+        {
+          HandleObject newComponent = Factory::g_factory.Create(component.m_factoryIndex);
+          CopyComponent(component, newComponent.GetPointer());
+          gameObject.AddComponent(newComponent, component.m_metaType);
+        }
+      }
+
+      //The GameObject may have moved, the spatial index has to hear about it
+      Transform* transform = gameObject.GetTransform();
+      CopyTransform(*transform);
+      transform->MarkDirty();
+    }
+
+    void Blueprint::Instantiate(size_t count, const InstanceTransform* transforms
+      , Container::Vector<Handle<GameObject>>& outGameObjects) const
+    {
+      PROFILE_ZONE("Blueprint::Instantiate");
+      ASSERT_TRUE(m_valid);
+      if (count == 0)
+      {
+        return;
+      }
+
+      //Grow every slotmap once up front instead of per instance
+      Factory::GetTypeContainer<GameObject>().EnsureFreeSlots(count);
+      Factory::GetTypeContainer<Transform>().EnsureFreeSlots(count);
+      for (auto& component : m_components)
+      {
+        Factory::g_factory.GetFunctionInfo(component.m_factoryIndex).m_reserveFn(count);
+      }
+      outGameObjects.reserve(outGameObjects.size() + count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        Handle<GameObject> handle = GameObject::Create(m_name.c_str(), m_components.size());
+        GameObject& gameObject = *handle;
+
+        //Transform from the image, then the per-instance override
+        Transform* transform = gameObject.GetTransform();
+        CopyTransform(*transform);
+        if (transforms != nullptr)
+        {
+          transform->SetPosition(transforms[i].m_position);
+          transform->SetRotation(transforms[i].m_rotation);
+          transform->SetScale(transforms[i].m_scale);
+        }
+
+        //Components, copy the image before Awake so OnAwake see the values
+        for (auto& component : m_components)
+        {
+          HandleObject newComponent = Factory::g_factory.Create(component.m_factoryIndex);
+          CopyComponent(component, newComponent.GetPointer());
+          gameObject.AddComponent(newComponent, component.m_metaType);
+        }
+
+        outGameObjects.emplace_back(handle);
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/*!
+  @file Blueprint.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Blueprint
+*/
+
+#pragma once
+
+#include "Core/Reflection/MetaType.hpp" //JsonValue
+#include "Core/EC/Components/Transform.hpp"
+#include "Core/EC/Handle.hpp"
+
+#include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/StringIntern.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    class GameObject;
+
+    //! @brief Per-instance transform override for Blueprint::Instantiate
+    struct InstanceTransform
+    {
+      glm::vec3 m_position{ 0.0f };
+      glm::quat m_rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+      glm::vec3 m_scale{ 1.0f };
+    };
+
+    //! @brief GameObject template compiled once from a .bp file.
+    // Hold the component types and a default-value image of each component,
+    // instances are copied from the image instead of parsing the json again.
+    class Blueprint
+    {
+    public:
+      //! @brief Constructor
+      Blueprint(void) = default;
+
+      //! @brief Destructor, destruct the component images
+      ~Blueprint();
+
+      Blueprint(const Blueprint&) = delete;
+      Blueprint& operator=(const Blueprint&) = delete;
+
+      //! @brief Compile from a parsed GameObject value (the object under "GameObject")
+      bool Compile(const ValueObject& gameObjectValue);
+
+      //! @brief Compile from a serialized GameObject json string
+      bool CompileFromString(const std::string& json);
+
+      //! @brief Release the images, the blueprint is empty afterward
+      void Clear(void);
+
+      //! @brief Make gameObject match the blueprint, same result as deserializing the .bp into it
+      void Apply(GameObject& gameObject) const;
+
+      //! @brief Create count GameObjects in one pass, transforms can be nullptr
+      // to keep the blueprint transform. Handles are appended to outGameObjects.
+      void Instantiate(size_t count, const InstanceTransform* transforms
+        , Container::Vector<Handle<GameObject>>& outGameObjects) const;
+
+      //! @brief Check if compiled
+      bool IsValid(void) const { return m_valid; }
+
+      //! @brief GameObject name of the instances
+      const Container::String& GetName(void) const { return m_name; }
+
+      //! @brief Amount of components, excluding Transform
+      size_t GetComponentCount(void) const { return m_components.size(); }
+
+      //! @brief Factory type of the component at index, to reserve before instantiating
+      Container::DenseIndex GetComponentFactoryIndex(size_t index) const { return m_components[index].m_factoryIndex; }
+
+      //! @brief Bytes of the component images
+      size_t GetImageSize(void) const { return m_imageSize; }
+
+      //! @brief Get the blueprint transform
+      const Components::Transform& GetTransform(void) const { return m_transform; }
+    private:
+      using CopyFN = void (*)(void* dst, const void* src);
+      using DestructFN = void (*)(void* object);
+
+      //! @brief Component type and the offset of its default-value image
+      struct ComponentTemplate
+      {
+        Reflection::MetaType*  m_metaType;
+        Container::DenseIndex  m_factoryIndex;
+        size_t                 m_imageOffset;
+        CopyFN                 m_copyFn;
+        DestructFN             m_destructFn;
+      };
+
+      //! @brief Copy src image into an existing component, keeping its identity
+      static void CopyComponent(CopyFN copyFn, void* dst, const void* src);
+
+      //! @brief Copy the component image into dst
+      void CopyComponent(const ComponentTemplate& component, void* dst) const;
+
+      //! @brief Copy the transform image into dst
+      void CopyTransform(Components::Transform& dst) const;
+
+      Container::String                      m_name;
+      Container::Vector<ComponentTemplate>   m_components;
+      Components::Transform                  m_transform;
+
+      Container::U8*                         m_image = nullptr;
+      size_t                                 m_imageSize = 0;
+      bool                                   m_valid = false;
+    };
+  }
+}
@@ -10,7 +10,7 @@ namespace NightEngine
 {
 	namespace EC
 	{
-		ComponentLogicID ComponentLogic::s_uniqueIDCounter = 0;
+		std::atomic<ComponentLogicID> ComponentLogic::s_uniqueIDCounter{ 0 };
 
 		ComponentHandle::ComponentHandle(GameObject* gameObject
 			, HandleObject handle, Reflection::MetaType* metaType)
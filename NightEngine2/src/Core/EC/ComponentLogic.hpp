@@ -11,6 +11,8 @@
 #include "Core/Container/PrimitiveType.hpp"
 #include "Core/Reflection/ReflectionMacros.hpp"
 
+#include <atomic>
+
 namespace NightEngine
 {
 	namespace EC
@@ -18,6 +20,7 @@ namespace NightEngine
 		//Forward Declaration
 		class GameObject;
     class ComponentLogic;
+    class Blueprint;
 
     //! @brief Handle for accessing Component
 		struct ComponentHandle
@@ -61,7 +64,7 @@ namespace NightEngine
       REFLECTABLE_TYPE();
     public:
       //! @brief Constructor
-      ComponentLogic() : m_uniqueID(s_uniqueIDCounter++) {}
+      ComponentLogic() : m_uniqueID(s_uniqueIDCounter.fetch_add(1, std::memory_order_relaxed)) {}
 
       //! @brief Destructor
       virtual ~ComponentLogic() {}
@@ -92,12 +95,13 @@ namespace NightEngine
 
 		protected:
 			friend struct  ComponentHandle;
+			friend class   Blueprint;
 
 			ComponentLogicID      m_uniqueID;	    //Unique id for each component
 			Handle<GameObject>    m_gameObject;	  //TODO: Use handle instead
       HandleObject m_handle;       //Handle to itself
 
-			static ComponentLogicID s_uniqueIDCounter;
+			static std::atomic<ComponentLogicID> s_uniqueIDCounter;  //Components can be staged on worker threads
 		};
   }
 }
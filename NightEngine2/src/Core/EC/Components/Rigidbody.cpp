@@ -122,6 +122,46 @@ namespace NightEngine
         }
       }
 
+      void Rigidbody::RestoreFromSnapshot(bool revived)
+      {
+        //Never initialized, nothing in the PhysicsScene
+        if (m_scene == nullptr || !m_gameObject.IsValid())
+        {
+          return;
+        }
+
+        auto transform = GetTransform();
+        if (revived)
+        {
+          //Body and collider of the copy were deleted by OnDestroy
+          Physics::PhysicsScene& scene = *m_scene;
+          m_rigidBody = nullptr;
+          m_scene = nullptr;
+          m_collider = nullptr;
+          Initialize(scene, transform->GetPosition(), m_colliderParams, m_mass);
+        }
+
+        //SetKinematic overwrite the mass, keep the restored one
+        btScalar mass = m_mass;
+        SetKinematic(m_isKinematic);
+        m_mass = mass;
+
+        //Teleport to the restored Transform, at rest
+        btTransform worldTransform;
+        worldTransform.setIdentity();
+        worldTransform.setOrigin(Physics::ToBulletVec3(transform->GetPosition()));
+        worldTransform.setRotation(Physics::ToBulletQuaternion(transform->GetRotation()));
+
+        m_rigidBody->setWorldTransform(worldTransform);
+        if (m_rigidBody->getMotionState() != nullptr)
+        {
+          m_rigidBody->getMotionState()->setWorldTransform(worldTransform);
+        }
+        m_rigidBody->setLinearVelocity(btVector3(0.0f, 0.0f, 0.0f));
+        m_rigidBody->setAngularVelocity(btVector3(0.0f, 0.0f, 0.0f));
+        m_rigidBody->clearForces();
+      }
+
     }
   }
 }
\ No newline at end of file
@@ -74,6 +74,10 @@ namespace NightEngine
 
         //! brief OnDestroy Callback
         virtual void OnDestroy(void) override;
+
+        //! brief Sync the body with the restored Transform and flags.
+        // A revived Rigidbody was destroyed since the snapshot, its body is created again.
+        void RestoreFromSnapshot(bool revived);
       private:
         btRigidBody*               m_rigidBody = nullptr;
         Physics::PhysicsScene*     m_scene = nullptr;
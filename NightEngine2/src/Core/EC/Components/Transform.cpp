@@ -20,6 +20,9 @@ namespace NightEngine
     {
       INIT_REFLECTION_AND_FACTORY(Transform, 2000, 1000)
 
+      //Setters are called on the main thread, the list is only touched there
+      static Container::Vector<Handle<GameObject>> g_movedGameObjects;
+
       void Transform::OnAwake(void)
       {
         Subscribe("MSG_TRANSFORMMESSAGE");
@@ -85,34 +88,60 @@ namespace NightEngine
       void Transform::SetPosition(const glm::vec3 & position)
       {
         m_position = position;
-        m_dirty = true;
+        MarkDirty();
       }
 
       void Transform::SetEulerAngle(const glm::vec3 & angle)
       {
         m_angle = angle;
         m_rotation = glm::toQuat(glm::eulerAngleYXZ(angle.y, angle.x, angle.z));
-        m_dirty = true;
+        MarkDirty();
       }
 
       void Transform::SetRotation(const glm::quat & rotation)
       {
         m_rotation = rotation;
         m_angle = glm::eulerAngles(rotation);
-        m_dirty = true;
+        MarkDirty();
       }
 
       void Transform::RotateAround(const glm::vec3 & axis, float angle)
       {
         m_rotation = glm::angleAxis(angle, axis) * m_rotation;
         m_angle = glm::eulerAngles(m_rotation);
-        m_dirty = true;
+        MarkDirty();
       }
 
       void Transform::SetScale(const glm::vec3 & scale)
       {
         m_scale = scale;
-        m_dirty = true;
+        MarkDirty();
+      }
+
+      //*************************************************
+      // Moved Transforms
+      //*************************************************
+      void Transform::MarkDirty(void)
+      {
+        //Unattached Transforms aren't in a scene yet, nothing to tell
+        if (!m_dirty && m_gameObject.m_handle.m_lookupFN != nullptr)
+        {
+          m_dirty = true;
+          g_movedGameObjects.emplace_back(m_gameObject);
+        }
+      }
+
+      void Transform::TakeMovedGameObjects(Container::Vector<Handle<GameObject>>& outMoved)
+      {
+        outMoved.clear();
+        outMoved.swap(g_movedGameObjects);
+        for (auto& gameObject : outMoved)
+        {
+          if (gameObject.IsValid())
+          {
+            gameObject->GetTransform()->m_dirty = false;
+          }
+        }
       }
 
       //*************************************************
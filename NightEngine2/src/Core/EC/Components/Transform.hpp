@@ -124,7 +124,26 @@ namespace NightEngine
         //! @brief Calculate Orthographic Projection Matrix from given info
         static glm::mat4 CalculateOrthoProjectionMatrix(float size, float aspect
           , float near, float far);
+
+        //*************************************************
+        // Moved Transforms
+        //*************************************************
+        //! @brief Check if the Transform was set since the last TakeMovedGameObjects
+        bool IsDirty(void) const { return m_dirty; }
+
+        //! @brief Forget the pending move, after a restore put the Transform back
+        void ClearDirty(void) { m_dirty = false; }
+
+        //! @brief Take the GameObjects whose Transform was set since the last call,
+        // each one listed once. Called once per frame by the SceneManager
+        static void TakeMovedGameObjects(Container::Vector<Handle<GameObject>>& outMoved);
       private:
+        //Apply keep the pending move of the instance and flag the copied Transform
+        friend class NightEngine::EC::Blueprint;
+
+        //! @brief Flag the Transform and list its GameObject the first time it change in a frame
+        void MarkDirty(void);
+
         glm::vec3 m_position;
         glm::vec3 m_scale;
 
@@ -7,21 +7,26 @@
 #include "Core/Macros.hpp"
 #include "Core/EC/Handle.hpp"
 
-#include "Core/Container/Hashmap.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/StringIntern.hpp"
 #include "Core/Container/PrimitiveType.hpp"
 
+#include <cstring>
+#include <new>
+#include <type_traits>
+
 //**********************************************
 // Factory Helper Macros
 //**********************************************
 //! @brief Factory Registering Call (must be called within function)
 #define FACTORY_REGISTER_TYPE(TYPE) \
-	NightEngine::Factory::g_factory.Register(#TYPE, \
-  NightEngine::Factory::HandleObjectFactory::InfoFN{FactoryCreate##TYPE,FactoryLookup##TYPE, FactoryDestroy##TYPE});																
+	NightEngine::Factory::GetTypeIndex<TYPE>() = NightEngine::Factory::g_factory.Register(#TYPE, \
+  NightEngine::Factory::MakeInfoFN<TYPE>(FactoryCreate##TYPE,FactoryLookup##TYPE, FactoryDestroy##TYPE));																
 
 //! @brief Factory Registering Call (must be called within function)
 #define FACTORY_REGISTER_TYPE_WITHPARAM(TYPE, RESERVE_INT, EXPAND_RATE) \
-	NightEngine::Factory::g_factory.Register(#TYPE, \
-  NightEngine::Factory::HandleObjectFactory::InfoFN{FactoryCreate##TYPE,FactoryLookup##TYPE, FactoryDestroy##TYPE}); \
+	NightEngine::Factory::GetTypeIndex<TYPE>() = NightEngine::Factory::g_factory.Register(#TYPE, \
+  NightEngine::Factory::MakeInfoFN<TYPE>(FactoryCreate##TYPE,FactoryLookup##TYPE, FactoryDestroy##TYPE)); \
 	NightEngine::Factory::GetTypeContainer<TYPE>().Reserve(RESERVE_INT, EXPAND_RATE); 	
 
 //! @brief Factory Lookup/Destroy/Create Functions Implementation
@@ -67,6 +72,10 @@ namespace NightEngine
 		template<class T>
 		Slotmap<T>& GetTypeContainer();
 
+    //! @brief Dense factory index of type T, set by FACTORY_REGISTER_TYPE
+    template<class T>
+    DenseIndex& GetTypeIndex();
+
     //**********************************************
     // Factory Class
     //**********************************************
@@ -74,31 +83,71 @@ namespace NightEngine
     {
 		public:
       using CreateFN = EC::HandleObject (*)(void);
+      using ConstructFN = void (*)(void* memory);
+      using DestructFN = void (*)(void* object);
+      using CopyFN = void (*)(void* dst, const void* src);
+      using ReserveFN = void (*)(size_t count);
+      using StateSizeFN = size_t (*)(void);
+      using WriteStateFN = void (*)(U8* memory);
+      using ReadStateFN = void (*)(const U8* memory);
+      using ReleaseStateFN = void (*)(U8* memory);
+      using CompareStateFN = void (*)(const U8* memory, Container::Vector<SlotChange>& changes);
+      using SlotObjectFN = void* (*)(U32 index);
       struct InfoFN
       {
         CreateFN m_createFn;
         EC::HandleObject::LookupFN m_lookupFn;
         EC::HandleObject::DestroyFN m_destroyFn;
+
+        //Type-erased object operations, for building instances from a raw image
+        ConstructFN m_constructFn = nullptr;
+        DestructFN  m_destructFn = nullptr;
+        CopyFN      m_copyFn = nullptr;
+        ReserveFN   m_reserveFn = nullptr;
+
+        //Type-erased container state, for snapshot and restore of the world
+        StateSizeFN     m_stateSizeFn = nullptr;
+        WriteStateFN    m_writeStateFn = nullptr;
+        ReadStateFN     m_readStateFn = nullptr;
+        ReleaseStateFN  m_releaseStateFn = nullptr;
+        CompareStateFN  m_compareStateFn = nullptr;
+        SlotObjectFN    m_slotObjectFn = nullptr;
       };
 
-			//! @brief Register typename into Factory
-      void	            Register(const char* name, InfoFN infoFn);
+			//! @brief Register typename into Factory, return its dense index
+      DenseIndex        Register(const char* name, InfoFN infoFn);
+
+      //! @brief Create object from dense index
+      EC::HandleObject	Create(DenseIndex typeIndex);
 
       //! @brief Create object from typename
-      EC::HandleObject	Create(const char* typeName);
+      EC::HandleObject	Create(const char* typeName) { return Create(GetTypeIndex(typeName)); }
+
+      //! @brief Get dense index of typename, c_INVALID_DENSE_INDEX if unregistered
+      DenseIndex        GetTypeIndex(StringID typeNameID) const;
+
+      //! @brief Get dense index of typename, c_INVALID_DENSE_INDEX if unregistered
+      DenseIndex        GetTypeIndex(const char* typeName) const { return GetTypeIndex(ToStringID(typeName)); }
 
       //! @brief Get function info for specific type
-      InfoFN	          GetFunctionInfo(const char* typeName);
+      const InfoFN&     GetFunctionInfo(DenseIndex typeIndex) const;
 
-      void              Clear(void) { m_handleMap.clear(); }
-		private:
+      //! @brief Get function info for specific type
+      const InfoFN&     GetFunctionInfo(const char* typeName) const { return GetFunctionInfo(GetTypeIndex(typeName)); }
 
-			using HandleInfoMap = Container::Hashmap<std::string, InfoFN>;
-      HandleInfoMap m_handleMap;	//Map of name to Creator
+      void              Clear(void) { m_infos.clear(); m_indexMap.clear(); }
+		private:
+      Container::Vector<InfoFN>               m_infos;	  //Creator indexed by dense index
+      Container::StringIDMap<DenseIndex>      m_indexMap;	//Map of name to dense index
 		};
 
 		//Global Variable
 		extern HandleObjectFactory g_factory;
+
+    //! @brief Build InfoFN of type T for Register
+    template<class T>
+    HandleObjectFactory::InfoFN MakeInfoFN(HandleObjectFactory::CreateFN createFn
+      , EC::HandleObject::LookupFN lookupFn, EC::HandleObject::DestroyFN destroyFn);
 	}
 }
 
@@ -112,23 +161,40 @@ namespace NightEngine
     //**********************************************
     // Class Definition
     //**********************************************
-    inline void HandleObjectFactory::Register(const char* name, InfoFN infoFn)
+    inline DenseIndex HandleObjectFactory::Register(const char* name, InfoFN infoFn)
     {
-      m_handleMap.insert( {name, infoFn} );
+      StringID nameID = StringIntern::Intern(name);
+      auto it = m_indexMap.find(nameID);
+      if (it != m_indexMap.end())
+      {
+        m_infos[it->second] = infoFn;
+        return it->second;
+      }
+
+      DenseIndex index = static_cast<DenseIndex>(m_infos.size());
+      m_infos.emplace_back(infoFn);
+      m_indexMap.insert({ nameID, index });
+      return index;
     }
 
-    inline EC::HandleObject HandleObjectFactory::Create(const char* typeName)
+    inline EC::HandleObject HandleObjectFactory::Create(DenseIndex typeIndex)
     {
-      ASSERT_MSG(m_handleMap.find(typeName) != m_handleMap.end()
+      ASSERT_MSG(typeIndex < m_infos.size()
         , "Trying to Create an unregistered typeName");
-      return m_handleMap[typeName].m_createFn();
+      return m_infos[typeIndex].m_createFn();
     }
 
-    inline HandleObjectFactory::HandleObjectFactory::InfoFN HandleObjectFactory::GetFunctionInfo(const char* typeName)
+    inline DenseIndex HandleObjectFactory::GetTypeIndex(StringID typeNameID) const
     {
-      ASSERT_MSG(m_handleMap.find(typeName) != m_handleMap.end()
+      auto it = m_indexMap.find(typeNameID);
+      return it != m_indexMap.end() ? it->second : c_INVALID_DENSE_INDEX;
+    }
+
+    inline const HandleObjectFactory::InfoFN& HandleObjectFactory::GetFunctionInfo(DenseIndex typeIndex) const
+    {
+      ASSERT_MSG(typeIndex < m_infos.size()
         , "Trying to Lookup an unregistered typeName");
-      return m_handleMap[typeName];
+      return m_infos[typeIndex];
     }
 
     //**********************************************
@@ -137,7 +203,13 @@ namespace NightEngine
     template<class T>
     EC::Handle<T> Create(const char* typeName)
     {
-      return EC::Handle<T>(Create(typeName));
+      //T registered through FACTORY_REGISTER_TYPE skip hashing typeName
+      DenseIndex typeIndex = GetTypeIndex<T>();
+      if (typeIndex == c_INVALID_DENSE_INDEX)
+      {
+        return EC::Handle<T>(Create(typeName));
+      }
+      return EC::Handle<T>(g_factory.Create(typeIndex));
     }
 
     template<class T>
@@ -147,10 +219,122 @@ namespace NightEngine
       return slotmap;
     }
 
+    template<class T>
+    void FactoryConstruct(void* memory)
+    {
+      new (memory) T();
+    }
+
+    template<class T>
+    void FactoryDestruct(void* object)
+    {
+      static_cast<T*>(object)->~T();
+    }
+
+    template<class T>
+    void FactoryCopy(void* dst, const void* src)
+    {
+      if constexpr (std::is_trivially_copyable<T>::value)
+      {
+        std::memcpy(dst, src, sizeof(T));
+      }
+      else if constexpr (std::is_copy_assignable<T>::value)
+      {
+        *static_cast<T*>(dst) = *static_cast<const T*>(src);
+      }
+      else
+      {
+        ASSERT_MSG(false, "Trying to copy a non-copyable factory type");
+      }
+    }
+
+    template<class T>
+    void FactoryReserve(size_t count)
+    {
+      GetTypeContainer<T>().EnsureFreeSlots(count);
+    }
+
+    template<class T>
+    size_t FactoryStateSize(void)
+    {
+      return GetTypeContainer<T>().GetStateSize();
+    }
+
+    template<class T>
+    void FactoryWriteState(U8* memory)
+    {
+      if constexpr (std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value)
+      {
+        GetTypeContainer<T>().WriteState(memory);
+      }
+      else
+      {
+        ASSERT_MSG(false, "Trying to snapshot a non-copyable factory type");
+      }
+    }
+
+    template<class T>
+    void FactoryReadState(const U8* memory)
+    {
+      if constexpr (std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value)
+      {
+        GetTypeContainer<T>().ReadState(memory);
+      }
+      else
+      {
+        ASSERT_MSG(false, "Trying to restore a non-copyable factory type");
+      }
+    }
+
+    template<class T>
+    void FactoryReleaseState(U8* memory)
+    {
+      Slotmap<T>::ReleaseState(memory);
+    }
+
+    template<class T>
+    void FactoryCompareState(const U8* memory, Container::Vector<SlotChange>& changes)
+    {
+      GetTypeContainer<T>().CompareState(memory, changes);
+    }
+
+    template<class T>
+    void* FactorySlotObject(U32 index)
+    {
+      return &(GetTypeContainer<T>().GetArray()[index].second);
+    }
+
+    template<class T>
+    HandleObjectFactory::InfoFN MakeInfoFN(HandleObjectFactory::CreateFN createFn
+      , EC::HandleObject::LookupFN lookupFn, EC::HandleObject::DestroyFN destroyFn)
+    {
+      HandleObjectFactory::InfoFN info{ createFn, lookupFn, destroyFn };
+      info.m_constructFn = FactoryConstruct<T>;
+      info.m_destructFn = FactoryDestruct<T>;
+      info.m_copyFn = FactoryCopy<T>;
+      info.m_reserveFn = FactoryReserve<T>;
+      info.m_stateSizeFn = FactoryStateSize<T>;
+      info.m_writeStateFn = FactoryWriteState<T>;
+      info.m_readStateFn = FactoryReadState<T>;
+      info.m_releaseStateFn = FactoryReleaseState<T>;
+      info.m_compareStateFn = FactoryCompareState<T>;
+      info.m_slotObjectFn = FactorySlotObject<T>;
+      return info;
+    }
+
+    template<class T>
+    DenseIndex& GetTypeIndex()
+    {
+      static DenseIndex typeIndex = c_INVALID_DENSE_INDEX;
+      return typeIndex;
+    }
+
     template<class T>
     EC::Handle<T> Cast(const char* typeName, SlotmapID slotmapID)
     {
-      auto funcInfo = g_factory.GetFunctionInfo(typeName);
+      DenseIndex typeIndex = GetTypeIndex<T>();
+      auto& funcInfo = typeIndex != c_INVALID_DENSE_INDEX
+        ? g_factory.GetFunctionInfo(typeIndex) : g_factory.GetFunctionInfo(typeName);
       return EC::Handle<T>
       {
         EC::HandleObject{ slotmapID, funcInfo.m_lookupFn, funcInfo.m_destroyFn }
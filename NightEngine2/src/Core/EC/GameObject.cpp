@@ -30,6 +30,8 @@ namespace NightEngine::EC
     m_components.reserve(reserveSize);
   }
 
+  Container::U64 GameObject::s_revision = 0;
+
   GameObject::~GameObject()
   {
   }
@@ -40,6 +42,7 @@ namespace NightEngine::EC
     *handle = GameObject(name, reserveSize);
     handle->m_handle = handle;
     handle->Init();
+    ++s_revision;
     return handle;
   }
 
@@ -61,6 +64,7 @@ namespace NightEngine::EC
     ASSERT_TRUE(m_handle.IsValid());
     RemoveAllComponents();
     m_handle.Destroy();
+    ++s_revision;
   }
 
   Container::Vector<ComponentHandle>& GameObject::GetAllComponents(void)
@@ -70,29 +74,20 @@ namespace NightEngine::EC
 
   ComponentHandle* GameObject::GetComponent(const char* componentType)
   {
-    using namespace Reflection;
-    //TODO: Verify if conversion from char* to std::string is valid
-    MetaType* metaType = METATYPE_FROM_STRING(componentType);
-
-    //Linear Search for Component
-    for (auto& handle : m_components)
-    {
-      //If component match the type
-      if (handle.m_metaType == metaType)
-      {
-        return &handle;
-      }
-    }
-
-    return nullptr;
+    return GetComponent(METATYPE_FROM_STRING(componentType));
   }
 
   ComponentHandle* GameObject::AddComponent(const char* componentType)
   {
-    //ComponentHandle Constructor will set Component's ref to GameObject
-    m_components.emplace_back(this
-      , Factory::Create(componentType)
+    return AddComponent(Factory::Create(componentType)
       , METATYPE_FROM_STRING(componentType));
+  }
+
+  ComponentHandle* GameObject::AddComponent(HandleObject component
+    , Reflection::MetaType* metaType)
+  {
+    //ComponentHandle Constructor will set Component's ref to GameObject
+    m_components.emplace_back(this, component, metaType);
 
     //Initialize
     auto& handle = m_components.back();
@@ -108,7 +103,6 @@ namespace NightEngine::EC
   void GameObject::RemoveComponent(const char* componentType)
   {
     using namespace Reflection;
-    //TODO: Verify if conversion from char* to std::string is valid
     MetaType* metaType = METATYPE_FROM_STRING(componentType);
 
     //Linear Search for Component
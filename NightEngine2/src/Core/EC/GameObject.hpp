@@ -54,7 +54,13 @@ namespace NightEngine::EC
 		void Destroy(void);
 
 		//! @brief Set the GameObject Name
-		void	SetName(const Container::String& name) { m_name = name; }
+		void	SetName(const Container::String& name) { m_name = name; ++s_revision; }
+
+		//! @brief Counter bumped when a GameObject is created, destroyed or renamed
+		static Container::U64 GetRevision(void) { return s_revision; }
+
+		//! @brief Bump the revision for changes done behind the GameObjects, like a restore
+		static void InvalidateRevision(void) { ++s_revision; }
 
 		//! @brief Get GameObject Name
 		const Container::String& GetName() const { return m_name; }
@@ -75,9 +81,15 @@ namespace NightEngine::EC
 		//! @brief GetComponent by Name
 		ComponentHandle* GetComponent(const char*);
 
+		//! @brief GetComponent by MetaType
+		ComponentHandle* GetComponent(const Reflection::MetaType* metaType);
+
 		//! @brief AddComponent by Name
 		ComponentHandle* AddComponent(const char*);
 
+		//! @brief Add an already created component, then Awake it
+		ComponentHandle* AddComponent(HandleObject component, Reflection::MetaType* metaType);
+
 		//! @brief RemoveComponent by Name
 		void		RemoveComponent(const char*);
 
@@ -88,6 +100,8 @@ namespace NightEngine::EC
 		//! @brief Remove all components
 		void								RemoveAllComponents();
 	private:
+		static Container::U64                  s_revision;
+
 		Container::String                      m_name;
 		Handle<GameObject>                     m_handle;
 		Container::Vector<ComponentHandle>     m_components;
@@ -100,9 +114,11 @@ namespace NightEngine::EC
 	template<class T>
 	inline ComponentHandle* GameObject::GetComponent()
 	{
-		using namespace Reflection;
-		MetaType* metaType = METATYPE(T);
+		return GetComponent(METATYPE(T));
+	}
 
+	inline ComponentHandle* GameObject::GetComponent(const Reflection::MetaType* metaType)
+	{
 		//Linear Search for Component
 		for (auto& handle : m_components)
 		{
@@ -6,6 +6,7 @@
 #include "Core/EC/Scene.hpp"
 
 #include "Core/EC/SceneManager.hpp"
+#include "Core/EC/SceneLoader.hpp"
 #include "Core/EC/ComponentLogic.hpp"
 #include "Graphics/Opengl/MeshRenderer.hpp"
 #include "Graphics/Opengl/Light.hpp"
@@ -15,6 +16,8 @@
 
 #include "Core/Serialization/FileSystem.hpp"
 
+#include "taocpp_json/include/tao/json/from_string.hpp"
+
 #include "Graphics/Opengl/InstanceDrawer.hpp"
 
 using namespace NightEngine::Rendering;
@@ -31,27 +34,176 @@ namespace NightEngine
     {
       m_sceneGameObjects.emplace_back(gameObject);
       m_sceneNodes.emplace_back(SceneNode());
+
+      RecordChange(SceneChange{ SceneChange::Type::ADD, gameObject, Handle<GameObject>() });
+      if (m_spatialIndexEnabled && !m_spatialIndexStale)
+      {
+        m_spatialIndex.Insert(gameObject);
+      }
     }
 
     void Scene::RemoveGameObject(Handle<GameObject> gameObject)
     {
-      auto it2 = m_sceneNodes.begin();
-      for (auto it = m_sceneGameObjects.begin();
-        it != m_sceneGameObjects.end() && it2 != m_sceneNodes.end(); 
-        ++it, ++it2)
+      int index = FindGameObjectIndex(gameObject);
+      if (index < 0)
       {
-        if ((*it).m_handle == gameObject.m_handle)
+        return;
+      }
+
+      Debug::Log << "RemoveGameObject: " << gameObject->GetName() << '\n';
+      int removedParent = m_sceneNodes[index].m_parentIndex;
+      m_sceneGameObjects.erase(m_sceneGameObjects.begin() + index);
+      m_sceneNodes.erase(m_sceneNodes.begin() + index);
+
+      //Node indices past the removed one shifted, its children move to its parent
+      auto shiftIndex = [index](int i) { return i > index ? i - 1 : i; };
+      removedParent = shiftIndex(removedParent);
+      for (auto& node : m_sceneNodes)
+      {
+        node.m_parentIndex = node.m_parentIndex == index ?
+          removedParent : shiftIndex(node.m_parentIndex);
+        node.m_children.clear();
+      }
+      for (int i = 0; i < (int)m_sceneNodes.size(); ++i)
+      {
+        int parent = m_sceneNodes[i].m_parentIndex;
+        if (parent >= 0)
         {
-          Debug::Log << "RemoveGameObject: " << gameObject->GetName() << '\n';
-          m_sceneGameObjects.erase(it);
-          m_sceneNodes.erase(it2);
-          break;
+          m_sceneNodes[parent].AddChild(i);
         }
       }
+
+      RecordChange(SceneChange{ SceneChange::Type::REMOVE, gameObject, Handle<GameObject>() });
+      if (m_spatialIndexEnabled)
+      {
+        m_spatialIndex.Remove(gameObject);
+      }
+    }
+
+    bool Scene::SetParent(Handle<GameObject> gameObject, Handle<GameObject> parent)
+    {
+      int index = FindGameObjectIndex(gameObject);
+      int parentIndex = parent.m_handle.m_lookupFN != nullptr ?
+        FindGameObjectIndex(parent) : -1;
+      if (index < 0 || (parentIndex < 0 && parent.m_handle.m_lookupFN != nullptr))
+      {
+        return false;
+      }
+
+      //Can't move a node under itself
+      for (int ancestor = parentIndex; ancestor >= 0; ancestor = m_sceneNodes[ancestor].m_parentIndex)
+      {
+        if (ancestor == index)
+        {
+          return false;
+        }
+      }
+
+      SceneNode& node = m_sceneNodes[index];
+      if (node.m_parentIndex >= 0)
+      {
+        m_sceneNodes[node.m_parentIndex].m_children.erase(index);
+      }
+      node.SetParent(parentIndex);
+      if (parentIndex >= 0)
+      {
+        m_sceneNodes[parentIndex].AddChild(index);
+      }
+
+      RecordChange(SceneChange{ SceneChange::Type::REPARENT, gameObject, parent });
+      return true;
+    }
+
+    Handle<GameObject> Scene::GetParent(int index) const
+    {
+      int parentIndex = m_sceneNodes[index].m_parentIndex;
+      return parentIndex >= 0 ? m_sceneGameObjects[parentIndex] : Handle<GameObject>();
+    }
+
+    bool Scene::ConsumeChanges(Container::Vector<SceneChange>& changes)
+    {
+      changes.clear();
+      changes.swap(m_changes);
+
+      bool complete = !m_changesOverflowed;
+      m_changesOverflowed = false;
+      return complete;
+    }
+
+    void Scene::EnableSpatialIndex(const SpatialIndexSettings& settings)
+    {
+      m_spatialIndex = SpatialIndex(settings);
+      m_spatialIndex.Rebuild(m_sceneGameObjects);
+      m_spatialIndexEnabled = true;
+      m_spatialIndexStale = false;
+    }
+
+    void Scene::DisableSpatialIndex(void)
+    {
+      m_spatialIndex = SpatialIndex(m_spatialIndex.GetSettings());
+      m_spatialIndexEnabled = false;
+    }
+
+    void Scene::SyncSpatialIndex(const Container::Vector<Handle<GameObject>>& moved)
+    {
+      if (!m_spatialIndexEnabled)
+      {
+        return;
+      }
+
+      if (m_spatialIndexStale)
+      {
+        m_spatialIndex.Rebuild(m_sceneGameObjects);
+        m_spatialIndexStale = false;
+        return;
+      }
+      m_spatialIndex.SyncTransforms(moved);
+    }
+
+    int Scene::FindGameObjectIndex(const Handle<GameObject>& gameObject) const
+    {
+      for (int i = 0; i < (int)m_sceneGameObjects.size(); ++i)
+      {
+        if (m_sceneGameObjects[i].m_handle == gameObject.m_handle)
+        {
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    void Scene::RecordChange(const SceneChange& change)
+    {
+      const size_t k_maxPendingChanges = 4096;
+      if (m_changes.size() >= k_maxPendingChanges)
+      {
+        m_changes.clear();
+        m_changesOverflowed = true;
+      }
+      if (!m_changesOverflowed)
+      {
+        m_changes.emplace_back(change);
+      }
     }
 
     namespace SceneManager
     {
+      static void DeserializeSceneNodes(ValueObject& nodeArray
+        , Container::Vector<SceneNode>& outNodes)
+      {
+        using namespace NightEngine::Reflection;
+        auto& array = nodeArray.get_array();
+        outNodes.reserve(outNodes.size() + array.size());
+        for (auto& node : array)
+        {
+          SceneNode sceneNode;
+          Variable sceneNodeVar{ METATYPE_FROM_OBJECT(sceneNode), &sceneNode };
+          sceneNodeVar.Deserialize(node);
+
+          outNodes.emplace_back(sceneNode);
+        }
+      }
+
       JsonValue SerializeScene(Reflection::Variable& variable)
       {
         using namespace NightEngine::Reflection;
@@ -111,23 +263,13 @@ namespace NightEngine
           ASSERT_TRUE(false);
         }
 
-        //GameObjects, Creating each GameObject
+        //GameObjects, staged in parallel then created in file order
         it = obj.find("m_sceneGameObjects");
         if (it != obj.end())
         {
-          auto goArray = it->second.get_array();
-          for (auto& go : goArray)
-          {
-            //New GameObject
-            auto newGOHandle = GameObject::Create("Unname", 1);
-            auto newGO = newGOHandle.Get();
-
-            //Deserialize data
-            Variable newGOVar{ METATYPE_FROM_OBJECT(*newGO), newGO };
-            newGOVar.Deserialize(go);
-
-            scene.m_sceneGameObjects.emplace_back(newGOHandle);
-          }
+          SceneLoader loader;
+          loader.Load(it->second, scene.m_sceneGameObjects);
+          scene.m_spatialIndexStale = true;
         }
         else
         {
@@ -139,15 +281,7 @@ namespace NightEngine
         it = obj.find("m_sceneNodes");
         if (it != obj.end())
         {
-          auto sceneNodeArray = it->second.get_array();
-          for (auto& node : sceneNodeArray)
-          {
-            SceneNode sceneNode;
-            Variable sceneNodeVar{ METATYPE_FROM_OBJECT(sceneNode), &sceneNode };
-            sceneNodeVar.Deserialize(node);
-
-            scene.m_sceneNodes.emplace_back(sceneNode);
-          }
+          DeserializeSceneNodes(it->second, scene.m_sceneNodes);
         }
         else
         {
@@ -155,6 +289,45 @@ namespace NightEngine
             << "Not Found Deserialize MemberName: m_sceneNodes\n";
         }
       }
+
+      void StageScene(const Container::String& json, StagedScene& staged)
+      {
+        staged.m_json = tao::json::from_string(json);
+        auto& obj = staged.m_json.get_object();
+
+        auto it = obj.find("m_name");
+        if (it != obj.end())
+        {
+          staged.m_name = it->second.as<Container::String>();
+        }
+
+        //Models aren't prefetched here, loading one create materials in the factory
+        it = obj.find("m_sceneGameObjects");
+        if (it != obj.end())
+        {
+          staged.m_loader.Parse(it->second);
+          staged.m_loader.Stage();
+        }
+
+        it = obj.find("m_sceneNodes");
+        if (it != obj.end())
+        {
+          DeserializeSceneNodes(it->second, staged.m_sceneNodes);
+        }
+      }
+
+      void CommitScene(StagedScene& staged, Scene& scene)
+      {
+        scene.m_name = staged.m_name;
+        staged.m_loader.Commit(scene.m_sceneGameObjects);
+
+        //Nodes and GameObjects are parallel arrays, a file missing nodes get top level ones
+        scene.m_sceneNodes = std::move(staged.m_sceneNodes);
+        scene.m_sceneNodes.resize(scene.m_sceneGameObjects.size());
+        scene.InvalidateChanges();
+
+        staged.m_json = JsonValue();
+      }
     }
   }
 }
\ No newline at end of file
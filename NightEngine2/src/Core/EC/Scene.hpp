@@ -6,6 +6,8 @@
 
 #pragma once
 #include "Core/EC/SceneNode.hpp"
+#include "Core/EC/SceneLoader.hpp"
+#include "Core/EC/SpatialIndex.hpp"
 
 #include "Core/Container/Vector.hpp"
 
@@ -15,6 +17,8 @@ namespace NightEngine
 {
   namespace EC
   {
+    class Scene;
+
     namespace SceneManager
     {
       //! @brief Scene Serialize function
@@ -22,12 +26,43 @@ namespace NightEngine
 
       //! @brief Scene Deserialize function
       void DeserializeScene(ValueObject& valueObject, Reflection::Variable& variable);
+
+      //! @brief Scene read and deserialized off the main thread, nothing is created yet
+      struct StagedScene
+      {
+        JsonValue                     m_json;         //The loader point into it until CommitScene
+        Container::String             m_name;
+        SceneLoader                   m_loader;
+        Container::Vector<SceneNode>  m_sceneNodes;
+      };
+
+      //! @brief Parse a scene file content and stage its GameObjects, safe on a background thread
+      void StageScene(const Container::String& json, StagedScene& staged);
+
+      //! @brief Create the staged GameObjects into an empty scene, on the main thread
+      void CommitScene(StagedScene& staged, Scene& scene);
     }
 
+    //! @brief Structural change of a scene, for views mirroring its hierarchy
+    struct SceneChange
+    {
+      enum class Type : unsigned
+      {
+        ADD = 0,
+        REMOVE,
+        REPARENT
+      };
+
+      Type               m_type;
+      Handle<GameObject> m_gameObject;
+      Handle<GameObject> m_parent;      //REPARENT only, null for the top level
+    };
+
     class Scene
     {
       friend NightEngine::JsonValue SceneManager::SerializeScene(NightEngine::Reflection::Variable&);
       friend void SceneManager::DeserializeScene(NightEngine::ValueObject&, NightEngine::Reflection::Variable&);
+      friend void SceneManager::CommitScene(SceneManager::StagedScene&, Scene&);
       REFLECTABLE_TYPE_BLOCK()
       {
         META_REGISTERER(Scene, true
@@ -43,8 +78,34 @@ namespace NightEngine
         void AddGameObject(Handle<GameObject> gameObject);
         
         void RemoveGameObject(Handle<GameObject> gameObject);
+
+        //! @brief Move gameObject under parent, a null parent move it to the top level.
+        // False if either isn't in the scene or parent is a descendant of gameObject.
+        bool SetParent(Handle<GameObject> gameObject, Handle<GameObject> parent);
+
+        //! @brief Parent of the gameObject at index, null for the top level
+        Handle<GameObject> GetParent(int index) const;
         
-        void Clear(void) { m_sceneNodes.clear(); m_sceneGameObjects.clear(); }
+        void Clear(void) { m_sceneNodes.clear(); m_sceneGameObjects.clear(); m_changesOverflowed = true; m_spatialIndex.Clear(); }
+
+        //! @brief Take the changes since the last call.
+        // False if too many changes piled up, the caller should rebuild from the scene.
+        bool ConsumeChanges(Container::Vector<SceneChange>& changes);
+
+        //! @brief Drop the pending changes, the next ConsumeChanges tell to rebuild
+        void InvalidateChanges(void) { m_changes.clear(); m_changesOverflowed = true; m_spatialIndexStale = true; }
+
+        //! @brief Index the GameObjects of the scene for proximity queries, built right away
+        void EnableSpatialIndex(const SpatialIndexSettings& settings);
+
+        //! @brief Drop the spatial index
+        void DisableSpatialIndex(void);
+
+        //! @brief The spatial index, null when disabled
+        inline const SpatialIndex* GetSpatialIndex(void) const { return m_spatialIndexEnabled ? &m_spatialIndex : nullptr; }
+
+        //! @brief Move the indexed GameObjects among moved, rebuild if the scene was replaced
+        void SyncSpatialIndex(const Container::Vector<Handle<GameObject>>& moved);
 
         inline void SetSceneName(Container::String name) { m_name = name; }
         inline const Container::String& GetSceneName(void) const { return m_name; }
@@ -52,6 +113,9 @@ namespace NightEngine
         inline const Container::Vector<SceneNode>& GetSceneNodes(void) const { return m_sceneNodes; }
         inline const Container::Vector<Handle<GameObject>>& GetAllGameObjects(void) const { return m_sceneGameObjects; }
       private:
+        int FindGameObjectIndex(const Handle<GameObject>& gameObject) const;
+        void RecordChange(const SceneChange& change);
+
         bool m_active = false;
         Container::String m_name;
         //TODO: Store set of Components to Update
@@ -59,6 +123,15 @@ namespace NightEngine
         //Parallel Arrays of Scene Data
         Container::Vector<SceneNode> m_sceneNodes;
         Container::Vector<Handle<GameObject>> m_sceneGameObjects;
+
+        //Changes not consumed yet, dropped past a limit when nobody consume them
+        Container::Vector<SceneChange> m_changes;
+        bool m_changesOverflowed = false;
+
+        //Kept in sync from the moved Transforms by the SceneManager
+        SpatialIndex m_spatialIndex;
+        bool m_spatialIndexEnabled = false;
+        bool m_spatialIndexStale = false;
     };
   }
 }
\ No newline at end of file
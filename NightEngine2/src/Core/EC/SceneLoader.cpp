@@ -0,0 +1,199 @@
+/*!
+  @file SceneLoader.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of SceneLoader
+*/
+
+#include "Core/EC/SceneLoader.hpp"
+#include "Core/EC/GameObject.hpp"
+#include "Core/EC/Factory.hpp"
+
+#include "Core/Container/Hashmap.hpp"
+#include "Core/Serialization/ResourceManager.hpp"
+#include "Core/Utility/JobSystem.hpp"
+#include "Core/Utility/Profiling.hpp"
+
+#include "Graphics/Opengl/Material.hpp"
+
+#include <future>
+#include <unordered_set>
+
+using namespace NightEngine::Container;
+using namespace NightEngine::EC::Components;
+using namespace NightEngine::Rendering::Opengl;
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    //GameObjects are small, fewer bigger batches keep the workers off the job queue lock
+    static const size_t c_STAGE_MIN_BATCH = 64;
+
+    void SceneLoader::Parse(const ValueObject& gameObjectArray)
+    {
+      PROFILE_ZONE("SceneLoader::Parse");
+      Clear();
+
+      auto& array = gameObjectArray.get_array();
+      m_staged = Vector<StagedGameObject>(array.size());
+
+      std::unordered_set<String> modelPaths;
+      for (size_t i = 0; i < array.size(); ++i)
+      {
+        m_staged[i].m_value = &array[i];
+
+        //Model requests, many GameObjects usually share the same file
+        auto& obj = array[i].get_object();
+        auto components = obj.find("m_components");
+        if (components == obj.end())
+        {
+          continue;
+        }
+
+        auto& componentMap = components->second.get_object();
+        auto meshRenderer = componentMap.find("MeshRenderer");
+        if (meshRenderer == componentMap.end())
+        {
+          continue;
+        }
+
+        auto& meshRendererObj = meshRenderer->second.get_object();
+        auto path = meshRendererObj.find("m_meshLoadPath");
+        if (path != meshRendererObj.end() && path->second.is_string())
+        {
+          auto& pathString = path->second.get_string();
+          if (!pathString.empty() && modelPaths.insert(pathString).second)
+          {
+            m_modelPaths.emplace_back(pathString);
+          }
+        }
+      }
+    }
+
+    void SceneLoader::Stage(void)
+    {
+      PROFILE_ZONE("SceneLoader::Stage");
+      JobSystem::ParallelFor(m_staged.size(), c_STAGE_MIN_BATCH
+        , [this](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          auto& staged = m_staged[i];
+          Serialization::SetDeferredMaterialLoads(&staged.m_materialLoads);
+          staged.m_blueprint.Compile(*staged.m_value);
+        }
+        Serialization::SetDeferredMaterialLoads(nullptr);
+      });
+    }
+
+    void SceneLoader::Commit(Vector<Handle<GameObject>>& outGameObjects)
+    {
+      PROFILE_ZONE("SceneLoader::Commit");
+
+      //Models create their Materials and GL objects, so they are only built here.
+      //Their cooked data was read by Load, the MeshRenderers then find them cached
+      for (size_t i = 0; i < m_prefetchedModels.size(); ++i)
+      {
+        ResourceManager::LoadModelResource(m_modelPaths[i]);
+      }
+      m_prefetchedModels.clear();
+
+      //Materials need the GL context, each file is loaded once then shared
+      Hashmap<String, Handle<Material>> materials;
+      for (auto& staged : m_staged)
+      {
+        for (auto& load : staged.m_materialLoads)
+        {
+          auto it = materials.find(load.m_filePath);
+          if (it == materials.end())
+          {
+            it = materials.emplace(load.m_filePath
+              , Material::LoadMaterial(load.m_filePath)).first;
+          }
+          *(load.m_target) = it->second;
+        }
+      }
+
+      //Grow every slotmap once up front instead of per GameObject
+      Hashmap<DenseIndex, size_t> componentCounts;
+      for (auto& staged : m_staged)
+      {
+        for (size_t i = 0; i < staged.m_blueprint.GetComponentCount(); ++i)
+        {
+          ++componentCounts[staged.m_blueprint.GetComponentFactoryIndex(i)];
+        }
+      }
+      for (auto& pair : componentCounts)
+      {
+        Factory::g_factory.GetFunctionInfo(pair.first).m_reserveFn(pair.second);
+      }
+      Factory::GetTypeContainer<GameObject>().EnsureFreeSlots(m_staged.size());
+      Factory::GetTypeContainer<Transform>().EnsureFreeSlots(m_staged.size());
+      outGameObjects.reserve(outGameObjects.size() + m_staged.size());
+
+      for (auto& staged : m_staged)
+      {
+        if (staged.m_blueprint.IsValid())
+        {
+          staged.m_blueprint.Instantiate(1, nullptr, outGameObjects);
+        }
+        else
+        {
+          //Scene nodes refer to GameObjects by index, keep the file order
+          outGameObjects.emplace_back(GameObject::Create("Unname", 1));
+        }
+      }
+
+      Clear();
+    }
+
+    void SceneLoader::Load(const ValueObject& gameObjectArray
+      , Vector<Handle<GameObject>>& outGameObjects)
+    {
+      PROFILE_ZONE("SceneLoader::Load");
+      Parse(gameObjectArray);
+
+      //Cooked model files are read while the GameObjects are staged. Only bytes,
+      //the Models are built by Commit on this thread
+      std::future<void> prefetch;
+      if (!m_modelPaths.empty())
+      {
+        prefetch = std::async(std::launch::async, [this]()
+        {
+          m_prefetchedModels.reserve(m_modelPaths.size());
+          for (auto& path : m_modelPaths)
+          {
+            m_prefetchedModels.emplace_back(ResourceManager::PrefetchModelResource(path));
+          }
+        });
+      }
+
+      Stage();
+
+      if (prefetch.valid())
+      {
+        prefetch.wait();
+      }
+
+      Commit(outGameObjects);
+    }
+
+    size_t SceneLoader::GetStagedSize(void) const
+    {
+      //The images are the components, GameObject and Transform come on top
+      size_t size = 0;
+      for (auto& staged : m_staged)
+      {
+        size += sizeof(GameObject) + sizeof(Transform) + staged.m_blueprint.GetImageSize();
+      }
+      return size;
+    }
+
+    void SceneLoader::Clear(void)
+    {
+      m_staged.clear();
+      m_modelPaths.clear();
+      m_prefetchedModels.clear();
+    }
+  }
+}
@@ -0,0 +1,70 @@
+/*!
+  @file SceneLoader.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of SceneLoader
+*/
+
+#pragma once
+
+#include "Core/EC/Blueprint.hpp"
+#include "Core/Serialization/SerializeFunction.hpp"
+#include "Core/Serialization/MappedFile.hpp"
+
+#include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    class GameObject;
+
+    //! @brief Build the GameObjects of a scene file in phases.
+    // Parse walk the json once and collect the assets, Stage deserialize every
+    // GameObject into its own Blueprint across the JobSystem workers,
+    // Commit create them in the factory containers on the calling thread.
+    class SceneLoader
+    {
+    public:
+      //! @brief Walk the "m_sceneGameObjects" array, it must outlive Stage()
+      void Parse(const ValueObject& gameObjectArray);
+
+      //! @brief Deserialize the parsed GameObjects in parallel, nothing is created yet
+      void Stage(void);
+
+      //! @brief Build the prefetched models, load the deferred materials then create
+      // the GameObjects in file order. Handles are appended to outGameObjects,
+      // the loader is empty afterward.
+      void Commit(Container::Vector<Handle<GameObject>>& outGameObjects);
+
+      //! @brief Every phase, with the cooked models read while the GameObjects are staged
+      void Load(const ValueObject& gameObjectArray
+        , Container::Vector<Handle<GameObject>>& outGameObjects);
+
+      //! @brief Release the staging
+      void Clear(void);
+
+      //! @brief Amount of GameObjects parsed
+      size_t GetGameObjectCount(void) const { return m_staged.size(); }
+
+      //! @brief Estimated bytes the staged GameObjects take once committed, valid after Stage()
+      size_t GetStagedSize(void) const;
+
+      //! @brief Model files used by the MeshRenderers, without duplicates
+      const Container::Vector<Container::String>& GetModelPaths(void) const { return m_modelPaths; }
+    private:
+      //! @brief One GameObject between Parse and Commit
+      struct StagedGameObject
+      {
+        const ValueObject*                                       m_value = nullptr;
+        Blueprint                                                m_blueprint;
+        Container::Vector<Serialization::DeferredMaterialLoad>   m_materialLoads;
+      };
+
+      //Blueprint can't move, the staging is sized once per Parse
+      Container::Vector<StagedGameObject>  m_staged;
+      Container::Vector<Container::String> m_modelPaths;
+      Container::Vector<FileView>          m_prefetchedModels;  //Same order as m_modelPaths
+    };
+  }
+}
@@ -6,6 +6,8 @@
 
 #include "Core/EC/SceneManager.hpp"
 #include "Core/EC/Scene.hpp"
+#include "Core/EC/WorldSnapshot.hpp"
+#include "Core/EC/WorldPartition.hpp"
 
 #include "Core/EC/GameObject.hpp"
 #include "Core/EC/ComponentLogic.hpp"
@@ -25,6 +27,7 @@
 #include "Core/Serialization/FileSystem.hpp"
 #include "Core/Serialization/ResourceManager.hpp"
 #include "Core/Serialization/Serialization.hpp"
+#include "Core/Serialization/HotReload.hpp"
 
 #include "Core/Utility/Utility.hpp"
 
@@ -52,13 +55,55 @@ namespace NightEngine
       static Handle<Material>          g_billboardMaterial;
       static Handle<Material>          g_errorMaterial;
 
+      //Play mode
+      static WorldSnapshot                     g_playModeSnapshot;
+      static Container::Vector<Handle<Scene>>  g_playModeScenes;
+      static Handle<Scene>                     g_playModeActiveScene;
+
+      //World streaming
+      static WorldPartition                    g_worldPartition;
+      static glm::vec3                         g_streamingFocus{ 0.0f };
+
+      //Spatial index sync
+      static Container::Vector<Handle<GameObject>> g_movedGameObjects;
+
       FACTORY_FUNC_IMPLEMENTATION(Scene);
 
+      static void RegisterSnapshotHooks(void)
+      {
+        //Journal entries refer to the play mode changes
+        SnapshotHooks sceneHooks;
+        sceneHooks.m_onRestored = [](void* object) { static_cast<Scene*>(object)->InvalidateChanges(); };
+        sceneHooks.m_onRevive = sceneHooks.m_onRestored;
+        WorldSnapshot::RegisterHooks("Scene", sceneHooks);
+
+        //Bullet bodies live outside of the container
+        SnapshotHooks rigidbodyHooks;
+        rigidbodyHooks.m_onRestored = [](void* object) { static_cast<Rigidbody*>(object)->RestoreFromSnapshot(false); };
+        rigidbodyHooks.m_onRevive = [](void* object) { static_cast<Rigidbody*>(object)->RestoreFromSnapshot(true); };
+        WorldSnapshot::RegisterHooks("Rigidbody", rigidbodyHooks);
+
+        //The Drawers track the draw mode, the meshes own GPU buffers
+        SnapshotHooks meshRendererHooks;
+        meshRendererHooks.m_onKeep = [](void* object) { static_cast<MeshRenderer*>(object)->SuspendDrawMode(); };
+        meshRendererHooks.m_onRestored = [](void* object) { static_cast<MeshRenderer*>(object)->ResumeDrawMode(); };
+        meshRendererHooks.m_onRevive = [](void* object) { static_cast<MeshRenderer*>(object)->RebuildFromSnapshot(); };
+        WorldSnapshot::RegisterHooks("MeshRenderer", meshRendererHooks);
+
+        //Restored Transforms aren't in the moved list, the Scenes rebuild their index instead
+        SnapshotHooks transformHooks;
+        transformHooks.m_onRestored = [](void* object) { static_cast<Transform*>(object)->ClearDirty(); };
+        transformHooks.m_onRevive = transformHooks.m_onRestored;
+        WorldSnapshot::RegisterHooks("Transform", transformHooks);
+      }
+
+
       void Initialize(void)
       {
         Debug::Log << "SceneManager::Initialize\n";
 
         FACTORY_REGISTER_TYPE_WITHPARAM(Scene, 1, 5);
+        RegisterSnapshotHooks();
 
         if (!g_defaultMaterial.IsValid())
         {
@@ -77,6 +122,7 @@ namespace NightEngine
       void Update(float dt)
       {
         //Debug::Log << "SceneManager::Update\n";
+        g_worldPartition.Update(g_streamingFocus);
 
         //TODO: This is kind of ghetto, should traverse registered component from the Slotmap directly
         for (int i = 0; i < g_openedScenes.size(); ++i)
@@ -93,6 +139,13 @@ namespace NightEngine
             }
           }
         }
+
+        //Move what the components moved this frame in the spatial indices
+        Transform::TakeMovedGameObjects(g_movedGameObjects);
+        for (int i = 0; i < g_openedScenes.size(); ++i)
+        {
+          g_openedScenes[i]->SyncSpatialIndex(g_movedGameObjects);
+        }
       }
 
       void FixedUpdate(void)
@@ -103,6 +156,9 @@ namespace NightEngine
       void Terminate(void)
       {
         Debug::Log << "SceneManager::Terminate\n";
+        g_worldPartition.Close();
+        g_playModeSnapshot.Release();
+        g_playModeScenes.clear();
         g_openedScenes.clear();
 
         g_defaultMaterial.m_handle.Nullify();
@@ -542,6 +598,12 @@ namespace NightEngine
           }
         }
 
+        //Streamed cells come and go, never leave a closed scene active
+        if (g_activeScene.m_handle == scene.m_handle)
+        {
+          g_activeScene = g_openedScenes.size() > 0 ? g_openedScenes[0] : Handle<Scene>();
+        }
+
         //Remove all gameObject in the scene then destroy the scene object itself
         auto gameObjects = scene->GetAllGameObjects();
         for (int i = 0; i < gameObjects.size(); ++i)
@@ -552,6 +614,26 @@ namespace NightEngine
         scene.Destroy();
       }
 
+      Handle<Scene> ReloadScene(Handle<Scene> scene)
+      {
+        Container::String sceneName = scene->GetSceneName();
+        bool isActive = GetActiveScene().m_handle == scene.m_handle;
+
+        CloseScene(scene);
+        auto newScene = LoadScene(sceneName);
+        if (isActive)
+        {
+          SetActiveScene(newScene);
+        }
+        return newScene;
+      }
+
+      Container::String GetSceneFilePath(const Scene& scene)
+      {
+        return FileSystem::GetFilePath(scene.GetSceneName() + ".nscene"
+          , FileSystem::DirectoryType::Scenes);
+      }
+
       void SaveScene(Handle<Scene> scene)
       {
         std::string fileName{ scene->GetSceneName() };
@@ -570,6 +652,8 @@ namespace NightEngine
             , fileName
             , FileSystem::DirectoryType::Scenes
             , SceneManager::SerializeScene);
+          HotReload::NotifyFileWritten(FileSystem::GetFilePath(fileName
+            , FileSystem::DirectoryType::Scenes));
         }
         stopWatch.Stop();
 
@@ -617,6 +701,70 @@ namespace NightEngine
 
       /////////////////////////////////////////
 
+      void EnterPlayMode(void)
+      {
+        if (IsInPlayMode())
+        {
+          return;
+        }
+
+        g_playModeScenes = g_openedScenes;
+        g_playModeActiveScene = g_activeScene;
+        g_playModeSnapshot.Capture();
+        Debug::Log << "SceneManager::EnterPlayMode, snapshot of "
+          << (unsigned)g_playModeSnapshot.GetSize() << " bytes\n";
+      }
+
+      void ExitPlayMode(void)
+      {
+        if (!IsInPlayMode())
+        {
+          return;
+        }
+
+        Debug::Log << "SceneManager::ExitPlayMode\n";
+        g_playModeSnapshot.Restore();
+        g_playModeSnapshot.Release();
+
+        //Scenes opened or closed while playing come back to the list they had
+        g_openedScenes = g_playModeScenes;
+        g_activeScene = g_playModeActiveScene;
+        g_playModeScenes.clear();
+        g_worldPartition.ResyncScenes();
+
+        //Names are restored behind SetName, the editor views have to rebuild
+        GameObject::InvalidateRevision();
+      }
+
+      bool IsInPlayMode(void)
+      {
+        return g_playModeSnapshot.IsCaptured();
+      }
+
+      /////////////////////////////////////////
+
+      void OpenWorld(const WorldPartitionSettings& settings)
+      {
+        g_worldPartition.Open(settings);
+      }
+
+      void CloseWorld(void)
+      {
+        g_worldPartition.Close();
+      }
+
+      WorldPartition& GetWorldPartition(void)
+      {
+        return g_worldPartition;
+      }
+
+      void SetStreamingFocus(const glm::vec3& position)
+      {
+        g_streamingFocus = position;
+      }
+
+      /////////////////////////////////////////
+
       Container::Vector<Handle<Scene>>* GetAllScenes(void)
       {
         return &g_openedScenes;
@@ -656,7 +804,7 @@ namespace NightEngine
           auto& gameObjects = g_openedScenes[i]->GetAllGameObjects();
           for (auto& gameObjectHandle : gameObjects)
           {
-            auto lightComponent = gameObjectHandle.Get()->GetComponent("Light");
+            auto lightComponent = gameObjectHandle.Get()->GetComponent<Light>();
             if (lightComponent != nullptr)
             {
               auto light = lightComponent->Get<Light>();
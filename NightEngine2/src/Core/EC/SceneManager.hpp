@@ -6,10 +6,13 @@
 #pragma once
 #include "Core/Container/String.hpp"
 #include "Core/Container/Vector.hpp"
+#include "Core/Container/Allocator.hpp"
 
 #include "Core/EC/Handle.hpp"
 #include "Core/EC/ComponentLogic.hpp"
 
+#include <glm/vec3.hpp>
+
 namespace NightEngine::Rendering::Opengl
 {
   class Material;
@@ -26,9 +29,11 @@ namespace NightEngine
   {
     struct SceneLights
     {
-      Container::Vector<Handle<GameObject>> dirLights;
-      Container::Vector<Handle<GameObject>> pointLights;
-      Container::Vector<Handle<GameObject>> spotLights;
+      using LightList = Container::TaggedVector<Handle<GameObject>, Container::MemoryTag::RENDERING>;
+
+      LightList dirLights;
+      LightList pointLights;
+      LightList spotLights;
 
       inline void Clear()
       {
@@ -39,6 +44,9 @@ namespace NightEngine
     };
 
     class Scene;
+    class WorldPartition;
+    struct WorldPartitionSettings;
+
     namespace SceneManager
     {
       //!breif Initialize SceneManager
@@ -69,9 +77,18 @@ namespace NightEngine
       //!@brief Load scene through ResourceManager
       Handle<Scene> LoadScene(Container::String sceneFile);
 
+      //!@brief Add to the opened scenes, the first one become the active scene
+      void AddScene(Handle<Scene> scene);
+
       //!@brief Close scene
       void CloseScene(Handle<Scene> scene);
 
+      //!@brief Close the scene and load its file again, keep it active if it was
+      Handle<Scene> ReloadScene(Handle<Scene> scene);
+
+      //!@brief Full path of the scene's file
+      Container::String GetSceneFilePath(const Scene& scene);
+
       //!@brief Save scene
       void SaveScene(Handle<Scene> scene);
 
@@ -89,6 +106,31 @@ namespace NightEngine
 
       /////////////////////////////////////////
 
+      //!@brief Snapshot the world, everything changed from now is undone by ExitPlayMode
+      void EnterPlayMode(void);
+
+      //!@brief Restore the world and the opened scenes to the EnterPlayMode snapshot
+      void ExitPlayMode(void);
+
+      //!@brief Check if there is a play mode snapshot to go back to
+      bool IsInPlayMode(void);
+
+      /////////////////////////////////////////
+
+      //!@brief Stream the cells of a world around the streaming focus, replace the opened world
+      void OpenWorld(const WorldPartitionSettings& settings);
+
+      //!@brief Close every cell of the opened world
+      void CloseWorld(void);
+
+      //!@brief Get the world partition streamed by Update
+      WorldPartition& GetWorldPartition(void);
+
+      //!@brief Position the world cells are streamed around, usually the camera or the player
+      void SetStreamingFocus(const glm::vec3& position);
+
+      /////////////////////////////////////////
+
       //!@brief Get all currently openned scenes
       Container::Vector<Handle<Scene>>* GetAllScenes(void);
 
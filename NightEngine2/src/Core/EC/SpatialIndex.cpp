@@ -0,0 +1,638 @@
+/*!
+  @file SpatialIndex.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of SpatialIndex
+*/
+
+#include "Core/EC/SpatialIndex.hpp"
+#include "Core/EC/GameObject.hpp"
+#include "Core/EC/Components/Transform.hpp"
+
+#include "Core/Utility/JobSystem.hpp"
+#include "Core/Macros.hpp"
+
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    //Queries are a few microseconds each, batch them to amortize the scheduling
+    static const size_t c_MIN_QUERY_BATCH = 32;
+
+    //Slots without an entry
+    static const U32 c_NO_ENTRY = ~0u;
+
+    //Cell coordinates are packed in 21 bits per axis
+    static const int c_MAX_CELL_COORD = (1 << 20) - 1;
+
+    //Keep the traversal stack bounded, 7 siblings pushed per level at most
+    static const int c_MAX_OCTREE_DEPTH = 32;
+    static const size_t c_OCTREE_STACK_SIZE = c_MAX_OCTREE_DEPTH * 7 + 1;
+
+    static float GetSquaredDistance(const glm::vec3& point, const SpatialBox& box)
+    {
+      glm::vec3 offset = glm::max(box.m_min - point, glm::vec3(0.0f))
+        + glm::max(point - box.m_max, glm::vec3(0.0f));
+      return glm::dot(offset, offset);
+    }
+
+    static bool Overlaps(const SpatialBox& lhs, const SpatialBox& rhs)
+    {
+      return lhs.m_min.x <= rhs.m_max.x && lhs.m_max.x >= rhs.m_min.x
+        && lhs.m_min.y <= rhs.m_max.y && lhs.m_max.y >= rhs.m_min.y
+        && lhs.m_min.z <= rhs.m_max.z && lhs.m_max.z >= rhs.m_min.z;
+    }
+
+    static bool Overlaps(const SpatialFrustum& frustum, const SpatialBox& box)
+    {
+      //The box is out when its corner furthest along a plane normal is behind it
+      for (const glm::vec4& plane : frustum.m_planes)
+      {
+        glm::vec3 corner{ plane.x >= 0.0f ? box.m_max.x : box.m_min.x
+          , plane.y >= 0.0f ? box.m_max.y : box.m_min.y
+          , plane.z >= 0.0f ? box.m_max.z : box.m_min.z };
+        if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static bool Overlaps(const SpatialFrustum& frustum, const glm::vec3& center, float radius)
+    {
+      for (const glm::vec4& plane : frustum.m_planes)
+      {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    static SpatialBox MakeBox(const glm::vec3& center, float extent)
+    {
+      return SpatialBox{ center - glm::vec3(extent), center + glm::vec3(extent) };
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    SpatialFrustum SpatialFrustum::FromMatrix(const glm::mat4& viewProjection)
+    {
+      //Rows of the clip space transform, -w <= x, y, z <= w
+      glm::vec4 rows[4];
+      for (int i = 0; i < 4; ++i)
+      {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i]
+          , viewProjection[2][i], viewProjection[3][i]);
+      }
+
+      SpatialFrustum frustum;
+      for (int i = 0; i < 3; ++i)
+      {
+        frustum.m_planes[i * 2] = rows[3] + rows[i];
+        frustum.m_planes[i * 2 + 1] = rows[3] - rows[i];
+      }
+      for (glm::vec4& plane : frustum.m_planes)
+      {
+        plane /= glm::length(glm::vec3(plane));
+      }
+
+      glm::mat4 inverse = glm::inverse(viewProjection);
+      frustum.m_bounds = SpatialBox{ glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+      for (int i = 0; i < 8; ++i)
+      {
+        glm::vec4 corner = inverse * glm::vec4((i & 1) ? 1.0f : -1.0f
+          , (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        glm::vec3 position = glm::vec3(corner) / corner.w;
+        frustum.m_bounds.m_min = glm::min(frustum.m_bounds.m_min, position);
+        frustum.m_bounds.m_max = glm::max(frustum.m_bounds.m_max, position);
+      }
+      return frustum;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    SpatialIndex::SpatialIndex(const SpatialIndexSettings& settings)
+      : m_settings(settings)
+    {
+      ASSERT_MSG(settings.m_cellSize > 0.0f, "SpatialIndex cell size must be positive");
+      ASSERT_MSG(settings.m_worldHalfSize >= settings.m_cellSize * 0.5f
+        , "SpatialIndex world must be at least one cell");
+    }
+
+    void SpatialIndex::Insert(const Handle<GameObject>& gameObject, const glm::vec3& position, float radius)
+    {
+      m_maxRadius = std::max(m_maxRadius, radius);
+
+      const SlotmapID& id = gameObject.m_handle.m_slotmapID;
+      ASSERT_MSG(id.m_index < c_NO_ENTRY, "SpatialIndex need a GameObject handle");
+      if (id.m_index >= m_slotEntries.size())
+      {
+        m_slotEntries.resize(static_cast<size_t>(id.m_index) + 1, c_NO_ENTRY);
+      }
+
+      U32 entryIndex = m_slotEntries[id.m_index];
+      if (entryIndex == c_NO_ENTRY)
+      {
+        entryIndex = static_cast<U32>(m_entries.size());
+        m_entries.emplace_back(Entry{ gameObject, position, radius, 0, 0 });
+        m_slotEntries[id.m_index] = entryIndex;
+        AddToBucket(entryIndex, FindBucket(position, radius));
+        return;
+      }
+
+      //A reused slot take over the entry of the destroyed GameObject,
+      //most moves stay in the same bucket
+      Entry& entry = m_entries[entryIndex];
+      entry.m_gameObject = gameObject;
+      entry.m_position = position;
+      entry.m_radius = radius;
+      if (m_settings.m_type == SpatialIndexType::HASHED_GRID)
+      {
+        if (GetCellCoord(position) != m_cells[entry.m_bucket].m_coord)
+        {
+          //Removing can drop the cell and move another one, find the new cell after
+          RemoveFromBucket(entryIndex);
+          AddToBucket(entryIndex, FindBucket(position, radius));
+        }
+      }
+      else
+      {
+        U32 bucket = FindBucket(position, radius);
+        if (bucket != entry.m_bucket)
+        {
+          RemoveFromBucket(entryIndex);
+          AddToBucket(entryIndex, bucket);
+        }
+      }
+    }
+
+    void SpatialIndex::Insert(const Handle<GameObject>& gameObject)
+    {
+      const GameObject& object = *gameObject.Get();
+      Insert(gameObject, object.GetTransform()->GetPosition(), GetTransformRadius(object));
+    }
+
+    bool SpatialIndex::Remove(const Handle<GameObject>& gameObject)
+    {
+      U32 entryIndex = FindEntry(gameObject);
+      if (entryIndex == c_NO_ENTRY)
+      {
+        return false;
+      }
+
+      m_slotEntries[gameObject.m_handle.m_slotmapID.m_index] = c_NO_ENTRY;
+      RemoveFromBucket(entryIndex);
+
+      //Swap the last entry in, its bucket and lookup point to the new index
+      U32 lastIndex = static_cast<U32>(m_entries.size() - 1);
+      if (entryIndex != lastIndex)
+      {
+        Entry& last = m_entries[lastIndex];
+        Vector<U32>& bucketEntries = m_settings.m_type == SpatialIndexType::HASHED_GRID ?
+          m_cells[last.m_bucket].m_entries : m_nodes[last.m_bucket].m_entries;
+        bucketEntries[last.m_slot] = entryIndex;
+        m_slotEntries[last.m_gameObject.m_handle.m_slotmapID.m_index] = entryIndex;
+        m_entries[entryIndex] = last;
+      }
+      m_entries.pop_back();
+      return true;
+    }
+
+    bool SpatialIndex::Contains(const Handle<GameObject>& gameObject) const
+    {
+      return FindEntry(gameObject) != c_NO_ENTRY;
+    }
+
+    void SpatialIndex::Clear(void)
+    {
+      m_entries.clear();
+      m_slotEntries.clear();
+      m_cells.clear();
+      m_cellLookup.clear();
+      m_nodes.clear();
+      m_maxRadius = 0.0f;
+    }
+
+    size_t SpatialIndex::GetBucketCount(void) const
+    {
+      if (m_settings.m_type == SpatialIndexType::HASHED_GRID)
+      {
+        return m_cells.size();
+      }
+
+      size_t count = 0;
+      for (const OctreeNode& node : m_nodes)
+      {
+        count += node.m_entries.empty() ? 0 : 1;
+      }
+      return count;
+    }
+
+    void SpatialIndex::Rebuild(const Vector<Handle<GameObject>>& gameObjects)
+    {
+      Clear();
+      m_entries.reserve(gameObjects.size());
+      for (const Handle<GameObject>& gameObject : gameObjects)
+      {
+        if (gameObject.IsValid())
+        {
+          Insert(gameObject);
+        }
+      }
+    }
+
+    void SpatialIndex::SyncTransforms(const Vector<Handle<GameObject>>& moved)
+    {
+      for (const Handle<GameObject>& gameObject : moved)
+      {
+        if (gameObject.IsValid() && Contains(gameObject))
+        {
+          Insert(gameObject);
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    void SpatialIndex::QueryRadius(const RadiusQuery& query, Vector<Handle<GameObject>>& outResult) const
+    {
+      const glm::vec3 center = query.m_center;
+      const float radius = query.m_radius;
+      VisitCandidates(MakeBox(center, radius)
+        , [&](const SpatialBox& box) { return GetSquaredDistance(center, box) <= radius * radius; }
+        , [&](const Entry& entry)
+        {
+          glm::vec3 offset = entry.m_position - center;
+          float reach = radius + entry.m_radius;
+          if (glm::dot(offset, offset) <= reach * reach)
+          {
+            outResult.emplace_back(entry.m_gameObject);
+          }
+        });
+    }
+
+    void SpatialIndex::QueryNearest(const NearestQuery& query, Vector<Handle<GameObject>>& outResult) const
+    {
+      if (query.m_count == 0 || m_entries.empty())
+      {
+        return;
+      }
+
+      //Grow the search until it hold count entries, those are the closest ones
+      const glm::vec3 center = query.m_center;
+      Vector<std::pair<float, U32>> candidates;
+      float radius = m_settings.m_cellSize;
+      while (true)
+      {
+        const float searchRadius = std::min(radius, query.m_maxDistance);
+        const float searchRadiusSq = searchRadius * searchRadius;
+        candidates.clear();
+        VisitCandidates(MakeBox(center, searchRadius)
+          , [&](const SpatialBox& box) { return GetSquaredDistance(center, box) <= searchRadiusSq; }
+          , [&](const Entry& entry)
+          {
+            glm::vec3 offset = entry.m_position - center;
+            float distanceSq = glm::dot(offset, offset);
+            if (distanceSq <= searchRadiusSq)
+            {
+              candidates.emplace_back(distanceSq, static_cast<U32>(&entry - m_entries.data()));
+            }
+          });
+
+        if (candidates.size() >= query.m_count || candidates.size() == m_entries.size()
+          || searchRadius >= query.m_maxDistance)
+        {
+          break;
+        }
+        radius *= 2.0f;
+      }
+
+      size_t count = std::min(query.m_count, candidates.size());
+      std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+      for (size_t i = 0; i < count; ++i)
+      {
+        outResult.emplace_back(m_entries[candidates[i].second].m_gameObject);
+      }
+    }
+
+    void SpatialIndex::QueryBox(const SpatialBox& box, Vector<Handle<GameObject>>& outResult) const
+    {
+      VisitCandidates(box
+        , [&](const SpatialBox& bucketBox) { return Overlaps(box, bucketBox); }
+        , [&](const Entry& entry)
+        {
+          if (GetSquaredDistance(entry.m_position, box) <= entry.m_radius * entry.m_radius)
+          {
+            outResult.emplace_back(entry.m_gameObject);
+          }
+        });
+    }
+
+    void SpatialIndex::QueryFrustum(const SpatialFrustum& frustum, Vector<Handle<GameObject>>& outResult) const
+    {
+      VisitCandidates(frustum.m_bounds
+        , [&](const SpatialBox& box) { return Overlaps(frustum, box); }
+        , [&](const Entry& entry)
+        {
+          //The planes alone let spheres past the corners through, the bounds cut those
+          if (GetSquaredDistance(entry.m_position, frustum.m_bounds) <= entry.m_radius * entry.m_radius
+            && Overlaps(frustum, entry.m_position, entry.m_radius))
+          {
+            outResult.emplace_back(entry.m_gameObject);
+          }
+        });
+    }
+
+    void SpatialIndex::QueryRadius(const RadiusQuery* queries, size_t count, SpatialQueryResults& outResults) const
+    {
+      outResults.resize(count);
+      JobSystem::ParallelFor(count, c_MIN_QUERY_BATCH, [&](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          outResults[i].clear();
+          QueryRadius(queries[i], outResults[i]);
+        }
+      });
+    }
+
+    void SpatialIndex::QueryNearest(const NearestQuery* queries, size_t count, SpatialQueryResults& outResults) const
+    {
+      outResults.resize(count);
+      JobSystem::ParallelFor(count, c_MIN_QUERY_BATCH, [&](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          outResults[i].clear();
+          QueryNearest(queries[i], outResults[i]);
+        }
+      });
+    }
+
+    void SpatialIndex::QueryBox(const SpatialBox* boxes, size_t count, SpatialQueryResults& outResults) const
+    {
+      outResults.resize(count);
+      JobSystem::ParallelFor(count, c_MIN_QUERY_BATCH, [&](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          outResults[i].clear();
+          QueryBox(boxes[i], outResults[i]);
+        }
+      });
+    }
+
+    void SpatialIndex::QueryFrustum(const SpatialFrustum* frustums, size_t count, SpatialQueryResults& outResults) const
+    {
+      outResults.resize(count);
+      JobSystem::ParallelFor(count, 1, [&](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          outResults[i].clear();
+          QueryFrustum(frustums[i], outResults[i]);
+        }
+      });
+    }
+
+    float SpatialIndex::GetTransformRadius(const GameObject& gameObject)
+    {
+      return 0.5f * glm::length(gameObject.GetTransform()->GetScale());
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    U32 SpatialIndex::FindBucket(const glm::vec3& position, float radius)
+    {
+      if (m_settings.m_type == SpatialIndexType::HASHED_GRID)
+      {
+        glm::ivec3 coord = GetCellCoord(position);
+        U64 key = GetCellKey(coord);
+        auto it = m_cellLookup.find(key);
+        if (it != m_cellLookup.end())
+        {
+          return it->second;
+        }
+
+        U32 cellIndex = static_cast<U32>(m_cells.size());
+        m_cells.emplace_back(GridCell{ key, coord, Vector<U32>() });
+        m_cellLookup.emplace(key, cellIndex);
+        return cellIndex;
+      }
+
+      if (m_nodes.empty())
+      {
+        m_nodes.emplace_back(OctreeNode{ m_settings.m_worldCenter, m_settings.m_worldHalfSize
+          , { -1, -1, -1, -1, -1, -1, -1, -1 }, Vector<U32>() });
+      }
+
+      //Outside of the world, stay in the root which is always visited
+      glm::vec3 offset = glm::abs(position - m_settings.m_worldCenter);
+      if (offset.x > m_settings.m_worldHalfSize || offset.y > m_settings.m_worldHalfSize
+        || offset.z > m_settings.m_worldHalfSize)
+      {
+        return 0;
+      }
+
+      //Go down while the child is still as big as the entry, its loose
+      //bounds are twice its size so the whole sphere stay inside
+      const float minHalfSize = m_settings.m_cellSize * 0.5f;
+      U32 nodeIndex = 0;
+      for (int depth = 0; ; ++depth)
+      {
+        const glm::vec3 center = m_nodes[nodeIndex].m_center;
+        const float childHalfSize = m_nodes[nodeIndex].m_halfSize * 0.5f;
+        if (childHalfSize < minHalfSize || childHalfSize < radius || depth == c_MAX_OCTREE_DEPTH)
+        {
+          return nodeIndex;
+        }
+
+        int octant = (position.x >= center.x ? 1 : 0) | (position.y >= center.y ? 2 : 0)
+          | (position.z >= center.z ? 4 : 0);
+        int child = m_nodes[nodeIndex].m_children[octant];
+        if (child < 0)
+        {
+          child = static_cast<int>(m_nodes.size());
+          glm::vec3 childCenter = center + glm::vec3((octant & 1) ? childHalfSize : -childHalfSize
+            , (octant & 2) ? childHalfSize : -childHalfSize, (octant & 4) ? childHalfSize : -childHalfSize);
+          m_nodes.emplace_back(OctreeNode{ childCenter, childHalfSize
+            , { -1, -1, -1, -1, -1, -1, -1, -1 }, Vector<U32>() });
+          m_nodes[nodeIndex].m_children[octant] = child;
+        }
+        nodeIndex = static_cast<U32>(child);
+      }
+    }
+
+    void SpatialIndex::AddToBucket(U32 entryIndex, U32 bucket)
+    {
+      Vector<U32>& bucketEntries = m_settings.m_type == SpatialIndexType::HASHED_GRID ?
+        m_cells[bucket].m_entries : m_nodes[bucket].m_entries;
+
+      Entry& entry = m_entries[entryIndex];
+      entry.m_bucket = bucket;
+      entry.m_slot = static_cast<U32>(bucketEntries.size());
+      bucketEntries.emplace_back(entryIndex);
+    }
+
+    void SpatialIndex::RemoveFromBucket(U32 entryIndex)
+    {
+      const Entry& entry = m_entries[entryIndex];
+      const bool grid = m_settings.m_type == SpatialIndexType::HASHED_GRID;
+      Vector<U32>& bucketEntries = grid ? m_cells[entry.m_bucket].m_entries
+        : m_nodes[entry.m_bucket].m_entries;
+
+      U32 movedEntry = bucketEntries.back();
+      bucketEntries[entry.m_slot] = movedEntry;
+      m_entries[movedEntry].m_slot = entry.m_slot;
+      bucketEntries.pop_back();
+
+      //Empty cells are dropped so moving objects don't leave a trail of them,
+      //octree nodes are bounded by the world and kept
+      if (grid && bucketEntries.empty())
+      {
+        U32 cellIndex = entry.m_bucket;
+        U32 lastIndex = static_cast<U32>(m_cells.size() - 1);
+        m_cellLookup.erase(m_cells[cellIndex].m_key);
+        if (cellIndex != lastIndex)
+        {
+          m_cells[cellIndex] = std::move(m_cells[lastIndex]);
+          m_cellLookup[m_cells[cellIndex].m_key] = cellIndex;
+          for (U32 moved : m_cells[cellIndex].m_entries)
+          {
+            m_entries[moved].m_bucket = cellIndex;
+          }
+        }
+        m_cells.pop_back();
+      }
+    }
+
+    template<typename OverlapFN, typename EntryFN>
+    void SpatialIndex::VisitCandidates(const SpatialBox& searchBox, const OverlapFN& overlapsBox
+      , const EntryFN& fn) const
+    {
+      if (m_entries.empty())
+      {
+        return;
+      }
+
+      //Entries are bucketed by their center, a bucket reach as far as the biggest radius
+      const float reach = m_maxRadius;
+      if (m_settings.m_type == SpatialIndexType::HASHED_GRID)
+      {
+        const float cellSize = m_settings.m_cellSize;
+        glm::ivec3 minCoord = GetCellCoord(searchBox.m_min - glm::vec3(reach));
+        glm::ivec3 maxCoord = GetCellCoord(searchBox.m_max + glm::vec3(reach));
+        auto visitCell = [&](const GridCell& cell)
+        {
+          glm::vec3 cellMin = glm::vec3(cell.m_coord) * cellSize;
+          if (overlapsBox(SpatialBox{ cellMin - glm::vec3(reach), cellMin + glm::vec3(cellSize + reach) }))
+          {
+            for (U32 entryIndex : cell.m_entries)
+            {
+              fn(m_entries[entryIndex]);
+            }
+          }
+        };
+
+        //Big searches walk the occupied cells instead of the empty space
+        glm::dvec3 extent = glm::dvec3(maxCoord - minCoord) + 1.0;
+        if (extent.x * extent.y * extent.z > static_cast<double>(m_cells.size()))
+        {
+          for (const GridCell& cell : m_cells)
+          {
+            if (glm::all(glm::greaterThanEqual(cell.m_coord, minCoord))
+              && glm::all(glm::lessThanEqual(cell.m_coord, maxCoord)))
+            {
+              visitCell(cell);
+            }
+          }
+          return;
+        }
+
+        for (int z = minCoord.z; z <= maxCoord.z; ++z)
+        {
+          for (int y = minCoord.y; y <= maxCoord.y; ++y)
+          {
+            for (int x = minCoord.x; x <= maxCoord.x; ++x)
+            {
+              auto it = m_cellLookup.find(GetCellKey(glm::ivec3(x, y, z)));
+              if (it != m_cellLookup.end())
+              {
+                visitCell(m_cells[it->second]);
+              }
+            }
+          }
+        }
+        return;
+      }
+
+      //The root also hold the entries outside of the world, always visit it
+      U32 stack[c_OCTREE_STACK_SIZE];
+      size_t stackSize = 0;
+      stack[stackSize++] = 0;
+      while (stackSize > 0)
+      {
+        const OctreeNode& node = m_nodes[stack[--stackSize]];
+        for (U32 entryIndex : node.m_entries)
+        {
+          fn(m_entries[entryIndex]);
+        }
+
+        for (int child : node.m_children)
+        {
+          if (child < 0)
+          {
+            continue;
+          }
+
+          const OctreeNode& childNode = m_nodes[child];
+          if (overlapsBox(MakeBox(childNode.m_center, childNode.m_halfSize * 2.0f)))
+          {
+            stack[stackSize++] = static_cast<U32>(child);
+          }
+        }
+      }
+    }
+
+    glm::ivec3 SpatialIndex::GetCellCoord(const glm::vec3& position) const
+    {
+      glm::vec3 coord = glm::floor(position / m_settings.m_cellSize);
+      coord = glm::clamp(coord, glm::vec3(-c_MAX_CELL_COORD), glm::vec3(c_MAX_CELL_COORD));
+      return glm::ivec3(coord);
+    }
+
+    U64 SpatialIndex::GetCellKey(const glm::ivec3& coord)
+    {
+      const U64 mask = (U64(1) << 21) - 1;
+      return (U64(coord.x + c_MAX_CELL_COORD + 1) & mask)
+        | ((U64(coord.y + c_MAX_CELL_COORD + 1) & mask) << 21)
+        | ((U64(coord.z + c_MAX_CELL_COORD + 1) & mask) << 42);
+    }
+
+    U32 SpatialIndex::FindEntry(const Handle<GameObject>& gameObject) const
+    {
+      const SlotmapID& id = gameObject.m_handle.m_slotmapID;
+      if (id.m_index >= m_slotEntries.size() || m_slotEntries[id.m_index] == c_NO_ENTRY)
+      {
+        return c_NO_ENTRY;
+      }
+
+      //Another GameObject in the slot than the one asked for
+      U32 entryIndex = m_slotEntries[id.m_index];
+      return m_entries[entryIndex].m_gameObject.m_handle.m_slotmapID.m_generation == id.m_generation ?
+        entryIndex : c_NO_ENTRY;
+    }
+  }
+}
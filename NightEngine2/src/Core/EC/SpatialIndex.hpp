@@ -0,0 +1,199 @@
+/*!
+  @file SpatialIndex.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of SpatialIndex
+*/
+
+#pragma once
+
+#include "Core/EC/Handle.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/Hashmap.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cfloat>
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    class GameObject;
+
+    //! @brief Axis aligned box in world space
+    struct SpatialBox
+    {
+      glm::vec3 m_min{ 0.0f };
+      glm::vec3 m_max{ 0.0f };
+    };
+
+    //! @brief View volume as 6 planes pointing inward, with the box around its corners
+    struct SpatialFrustum
+    {
+      glm::vec4  m_planes[6];     //Inside where dot(xyz, p) + w >= 0
+      SpatialBox m_bounds;
+
+      //! @brief Planes of a view projection matrix, like CameraObject::m_VP
+      static SpatialFrustum FromMatrix(const glm::mat4& viewProjection);
+    };
+
+    //! @brief Structure holding the entries, picked per scene
+    enum class SpatialIndexType : Container::U8
+    {
+      HASHED_GRID = 0,    //Uniform cells, best when the objects have similar sizes
+      LOOSE_OCTREE        //Nodes sized by the objects, best for mixed sizes in a bounded world
+    };
+
+    //! @brief How a SpatialIndex split the space
+    struct SpatialIndexSettings
+    {
+      SpatialIndexType m_type = SpatialIndexType::HASHED_GRID;
+      float            m_cellSize = 8.0f;              //Grid cell, or the smallest octree node
+      glm::vec3        m_worldCenter{ 0.0f };          //Octree only
+      float            m_worldHalfSize = 1024.0f;      //Octree only, entries outside stay in the root
+    };
+
+    //! @brief Everything overlapping a sphere
+    struct RadiusQuery
+    {
+      glm::vec3 m_center{ 0.0f };
+      float     m_radius = 0.0f;
+    };
+
+    //! @brief The m_count closest entry positions, nearest first
+    struct NearestQuery
+    {
+      glm::vec3 m_center{ 0.0f };
+      size_t    m_count = 1;
+      float     m_maxDistance = FLT_MAX;
+    };
+
+    //! @brief One list of GameObjects per query of a batch
+    using SpatialQueryResults = Container::Vector<Container::Vector<Handle<GameObject>>>;
+
+    //! @brief Bounding spheres of GameObjects for proximity queries without scanning a scene.
+    // Queries are const and safe to run from several threads, the batched ones
+    // split their queries across the JobSystem workers.
+    class SpatialIndex
+    {
+    public:
+      //! @brief Constructor
+      explicit SpatialIndex(const SpatialIndexSettings& settings = SpatialIndexSettings());
+
+      const SpatialIndexSettings& GetSettings(void) const { return m_settings; }
+
+      //! @brief Add or move a GameObject
+      void Insert(const Handle<GameObject>& gameObject, const glm::vec3& position, float radius);
+
+      //! @brief Add or move a GameObject by its Transform
+      void Insert(const Handle<GameObject>& gameObject);
+
+      //! @brief Remove a GameObject, false if it isn't in the index
+      bool Remove(const Handle<GameObject>& gameObject);
+
+      //! @brief Check if a GameObject is in the index
+      bool Contains(const Handle<GameObject>& gameObject) const;
+
+      //! @brief Remove everything
+      void Clear(void);
+
+      //! @brief Amount of GameObjects in the index
+      size_t GetCount(void) const { return m_entries.size(); }
+
+      //! @brief Amount of grid cells or octree nodes holding entries
+      size_t GetBucketCount(void) const;
+
+      //! @brief Replace the content by gameObjects at their Transform
+      void Rebuild(const Container::Vector<Handle<GameObject>>& gameObjects);
+
+      //! @brief Move the indexed ones of the moved GameObjects to their Transform,
+      // the others are ignored
+      void SyncTransforms(const Container::Vector<Handle<GameObject>>& moved);
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief Append the GameObjects overlapping the sphere
+      void QueryRadius(const RadiusQuery& query, Container::Vector<Handle<GameObject>>& outResult) const;
+
+      //! @brief Append the count GameObjects closest to the center, nearest first
+      void QueryNearest(const NearestQuery& query, Container::Vector<Handle<GameObject>>& outResult) const;
+
+      //! @brief Append the GameObjects overlapping the box
+      void QueryBox(const SpatialBox& box, Container::Vector<Handle<GameObject>>& outResult) const;
+
+      //! @brief Append the GameObjects overlapping the frustum
+      void QueryFrustum(const SpatialFrustum& frustum, Container::Vector<Handle<GameObject>>& outResult) const;
+
+      //! @brief Run every query across the workers, outResults get one list per query
+      void QueryRadius(const RadiusQuery* queries, size_t count, SpatialQueryResults& outResults) const;
+
+      void QueryNearest(const NearestQuery* queries, size_t count, SpatialQueryResults& outResults) const;
+
+      void QueryBox(const SpatialBox* boxes, size_t count, SpatialQueryResults& outResults) const;
+
+      void QueryFrustum(const SpatialFrustum* frustums, size_t count, SpatialQueryResults& outResults) const;
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief Bounding sphere of a unit mesh under the Transform scale
+      static float GetTransformRadius(const GameObject& gameObject);
+    private:
+      struct Entry
+      {
+        Handle<GameObject> m_gameObject;
+        glm::vec3          m_position;
+        float              m_radius;
+        Container::U32     m_bucket;     //Grid cell or octree node
+        Container::U32     m_slot;       //Index in the bucket entries
+      };
+
+      struct GridCell
+      {
+        Container::U64              m_key;
+        glm::ivec3                  m_coord;
+        Container::Vector<Container::U32> m_entries;
+      };
+
+      struct OctreeNode
+      {
+        glm::vec3                   m_center;
+        float                       m_halfSize;
+        int                         m_children[8];
+        Container::Vector<Container::U32> m_entries;
+      };
+
+      //! @brief Bucket the entry belong to, created if needed
+      Container::U32 FindBucket(const glm::vec3& position, float radius);
+
+      void AddToBucket(Container::U32 entryIndex, Container::U32 bucket);
+
+      void RemoveFromBucket(Container::U32 entryIndex);
+
+      //! @brief Call fn(entry) on every entry whose bucket overlap searchBox and pass
+      // overlapsBox(min, max) for the bucket bounds, entries aren't tested
+      template<typename OverlapFN, typename EntryFN>
+      void VisitCandidates(const SpatialBox& searchBox, const OverlapFN& overlapsBox
+        , const EntryFN& fn) const;
+
+      glm::ivec3 GetCellCoord(const glm::vec3& position) const;
+
+      static Container::U64 GetCellKey(const glm::ivec3& coord);
+
+      //! @brief Entry of the GameObject, c_NO_ENTRY if it isn't in the index
+      Container::U32 FindEntry(const Handle<GameObject>& gameObject) const;
+
+      SpatialIndexSettings                          m_settings;
+      Container::Vector<Entry>                      m_entries;
+      Container::Vector<Container::U32>             m_slotEntries;   //Entry per GameObject slot
+      float                                         m_maxRadius = 0.0f;
+
+      Container::Vector<GridCell>                   m_cells;
+      Container::Hashmap<Container::U64, Container::U32> m_cellLookup;
+
+      Container::Vector<OctreeNode>                 m_nodes;
+    };
+  }
+}
@@ -0,0 +1,505 @@
+/*!
+  @file WorldPartition.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of WorldPartition
+*/
+
+#include "Core/EC/WorldPartition.hpp"
+#include "Core/EC/Scene.hpp"
+#include "Core/EC/SceneManager.hpp"
+#include "Core/EC/Factory.hpp"
+
+#include "Core/Serialization/FileSystem.hpp"
+#include "Core/Serialization/Serialization.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Utility/Profiling.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    static bool ReadCellFile(const String& worldName, const CellCoord& cell, String& outJson)
+    {
+      FileView view = VirtualFileSystem::Read(FileSystem::GetFilePath(
+        WorldPartition::GetCellFileName(worldName, cell), FileSystem::DirectoryType::Scenes));
+      if (!view.IsValid())
+      {
+        return false;
+      }
+
+      outJson.assign(view.GetData(), view.GetSize());
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    WorldPartition::~WorldPartition()
+    {
+      Close();
+    }
+
+    void WorldPartition::Open(const WorldPartitionSettings& settings, CellSourceFN source)
+    {
+      ASSERT_MSG(settings.m_cellSize > 0.0f, "WorldPartition cell size must be positive");
+      ASSERT_MSG(settings.m_unloadRadius >= settings.m_loadRadius
+        , "WorldPartition unload radius must not be smaller than the load radius");
+      Close();
+
+      m_settings = settings;
+      m_source = source;
+      if (m_source == nullptr)
+      {
+        String worldName = settings.m_worldName;
+        m_source = [worldName](const CellCoord& cell, String& outJson)
+        {
+          return ReadCellFile(worldName, cell, outJson);
+        };
+      }
+      m_open = true;
+
+      Debug::Log << "WorldPartition::Open: " << m_settings.m_worldName << '\n';
+    }
+
+    void WorldPartition::Close(void)
+    {
+      if (!m_open)
+      {
+        return;
+      }
+
+      WaitForLoads();
+      PollLoads();
+      for (auto& pair : m_cells)
+      {
+        Unload(pair.second);
+      }
+
+      m_cells.clear();
+      m_source = nullptr;
+      m_residentSize = 0;
+      m_open = false;
+    }
+
+    void WorldPartition::Update(const glm::vec3& focus)
+    {
+      PROFILE_ZONE("WorldPartition::Update");
+      if (!m_open)
+      {
+        return;
+      }
+
+      for (auto& pair : m_cells)
+      {
+        Cell& cell = pair.second;
+        cell.m_distance = GetCellDistance(cell.m_coord, focus, m_settings.m_cellSize);
+      }
+
+      PollLoads();
+
+      //Streaming out, the map only keep the cells around the focus
+      for (auto it = m_cells.begin(); it != m_cells.end();)
+      {
+        Cell& cell = it->second;
+        if (cell.m_distance > m_settings.m_unloadRadius && cell.m_state != CellState::LOADING)
+        {
+          Unload(cell);
+          it = m_cells.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+
+      //Streaming in, nearest cells first
+      struct Candidate
+      {
+        float     m_distance;
+        CellCoord m_coord;
+      };
+      Vector<Candidate> candidates;
+
+      float cellSize = m_settings.m_cellSize;
+      int range = static_cast<int>(std::ceil(m_settings.m_loadRadius / cellSize));
+      CellCoord center = GetCell(focus, cellSize);
+      for (int z = center.m_z - range; z <= center.m_z + range; ++z)
+      {
+        for (int x = center.m_x - range; x <= center.m_x + range; ++x)
+        {
+          CellCoord coord{ x, z };
+          float distance = GetCellDistance(coord, focus, cellSize);
+          if (distance > m_settings.m_loadRadius)
+          {
+            continue;
+          }
+
+          auto it = m_cells.find(GetCellKey(coord));
+          if (it == m_cells.end() || it->second.m_state == CellState::UNLOADED)
+          {
+            candidates.emplace_back(Candidate{ distance, coord });
+          }
+        }
+      }
+      std::sort(candidates.begin(), candidates.end()
+        , [](const Candidate& lhs, const Candidate& rhs) { return lhs.m_distance < rhs.m_distance; });
+
+      for (auto& candidate : candidates)
+      {
+        if (m_pendingLoads >= m_settings.m_maxPendingLoads)
+        {
+          break;
+        }
+
+        Cell& cell = m_cells[GetCellKey(candidate.m_coord)];
+        cell.m_coord = candidate.m_coord;
+        cell.m_distance = candidate.m_distance;
+
+        //A cell that didn't fit before isn't read again until something farther can make room
+        if (FitBudget(cell.m_size, cell.m_distance))
+        {
+          StartLoad(cell);
+        }
+      }
+
+      //Activation, a few cells per frame so the commits never spike a frame
+      Vector<Cell*> staged;
+      for (auto& pair : m_cells)
+      {
+        if (pair.second.m_state == CellState::STAGED)
+        {
+          staged.emplace_back(&pair.second);
+        }
+      }
+      std::sort(staged.begin(), staged.end()
+        , [](const Cell* lhs, const Cell* rhs) { return lhs->m_distance < rhs->m_distance; });
+
+      size_t activationCount = std::min<size_t>(staged.size(), m_settings.m_activationsPerFrame);
+      for (size_t i = 0; i < activationCount; ++i)
+      {
+        Activate(*staged[i]);
+      }
+    }
+
+    void WorldPartition::WaitForLoads(void)
+    {
+      for (auto& pair : m_cells)
+      {
+        if (pair.second.m_state == CellState::LOADING)
+        {
+          pair.second.m_load.wait();
+        }
+      }
+    }
+
+    void WorldPartition::ResyncScenes(void)
+    {
+      if (!m_open)
+      {
+        return;
+      }
+
+      //Cell scenes closed or destroyed
+      for (auto& pair : m_cells)
+      {
+        Cell& cell = pair.second;
+        if (cell.m_state != CellState::ACTIVE)
+        {
+          continue;
+        }
+
+        auto& scenes = *SceneManager::GetAllScenes();
+        bool opened = cell.m_scene.IsValid() && std::any_of(scenes.begin(), scenes.end()
+          , [&cell](const Handle<Scene>& scene) { return scene.m_handle == cell.m_scene.m_handle; });
+        if (!opened)
+        {
+          m_residentSize -= cell.m_size;
+          cell.m_scene = Handle<Scene>();
+          cell.m_state = CellState::UNLOADED;
+        }
+      }
+
+      //Cell scenes opened again, they take the place of what the partition had for the cell
+      WaitForLoads();
+      PollLoads();
+      for (auto& scene : *SceneManager::GetAllScenes())
+      {
+        CellCoord coord;
+        if (!ParseCellSceneName(m_settings.m_worldName, scene->GetSceneName(), coord))
+        {
+          continue;
+        }
+
+        Cell& cell = m_cells[GetCellKey(coord)];
+        if (cell.m_state == CellState::ACTIVE)
+        {
+          continue;
+        }
+
+        Unload(cell);
+        cell.m_coord = coord;
+        cell.m_scene = scene;
+        cell.m_state = CellState::ACTIVE;
+        m_residentSize += cell.m_size;
+      }
+    }
+
+    WorldPartition::CellState WorldPartition::GetCellState(const CellCoord& cell) const
+    {
+      auto it = m_cells.find(GetCellKey(cell));
+      return it != m_cells.end() ? it->second.m_state : CellState::UNLOADED;
+    }
+
+    Handle<Scene> WorldPartition::GetCellScene(const CellCoord& cell) const
+    {
+      auto it = m_cells.find(GetCellKey(cell));
+      if (it != m_cells.end() && it->second.m_state == CellState::ACTIVE)
+      {
+        return it->second.m_scene;
+      }
+      return Handle<Scene>();
+    }
+
+    size_t WorldPartition::GetActiveCellCount(void) const
+    {
+      return std::count_if(m_cells.begin(), m_cells.end()
+        , [](const auto& pair) { return pair.second.m_state == CellState::ACTIVE; });
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    CellCoord WorldPartition::GetCell(const glm::vec3& position, float cellSize)
+    {
+      return CellCoord{ static_cast<int>(std::floor(position.x / cellSize))
+        , static_cast<int>(std::floor(position.z / cellSize)) };
+    }
+
+    float WorldPartition::GetCellDistance(const CellCoord& cell, const glm::vec3& position, float cellSize)
+    {
+      float minX = cell.m_x * cellSize;
+      float minZ = cell.m_z * cellSize;
+      float dx = std::max({ minX - position.x, 0.0f, position.x - (minX + cellSize) });
+      float dz = std::max({ minZ - position.z, 0.0f, position.z - (minZ + cellSize) });
+      return std::sqrt(dx * dx + dz * dz);
+    }
+
+    String WorldPartition::GetCellFileName(const String& worldName, const CellCoord& cell)
+    {
+      return worldName + "_" + std::to_string(cell.m_x) + "_" + std::to_string(cell.m_z) + ".nscene";
+    }
+
+    bool WorldPartition::ParseCellSceneName(const String& worldName
+      , const String& sceneName, CellCoord& outCell)
+    {
+      String prefix = worldName + "_";
+      if (sceneName.compare(0, prefix.size(), prefix) != 0)
+      {
+        return false;
+      }
+
+      //"<x>_<z>" with nothing after
+      int x = 0, z = 0, length = 0;
+      String coords = sceneName.substr(prefix.size());
+      if (std::sscanf(coords.c_str(), "%d_%d%n", &x, &z, &length) != 2
+        || length != static_cast<int>(coords.size()))
+      {
+        return false;
+      }
+
+      outCell = CellCoord{ x, z };
+      return true;
+    }
+
+    size_t WorldPartition::PartitionScene(const Scene& scene, const WorldPartitionSettings& settings)
+    {
+      auto& gameObjects = scene.GetAllGameObjects();
+      auto& nodes = scene.GetSceneNodes();
+
+      //Top level GameObjects by the cell of their position
+      Hashmap<U64, Vector<int>> cellRoots;
+      Vector<CellCoord> cellCoords;
+      for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (nodes[i].m_parentIndex >= 0)
+        {
+          continue;
+        }
+
+        CellCoord coord = GetCell(gameObjects[i]->GetTransform()->GetPosition(), settings.m_cellSize);
+        auto& roots = cellRoots[GetCellKey(coord)];
+        if (roots.empty())
+        {
+          cellCoords.emplace_back(coord);
+        }
+        roots.emplace_back(static_cast<int>(i));
+      }
+
+      for (auto& coord : cellCoords)
+      {
+        //Roots then their descendants, parents always come first
+        Scene cellScene;
+        Vector<int> indices = cellRoots[GetCellKey(coord)];
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+          for (int child : nodes[indices[i]].m_children)
+          {
+            indices.emplace_back(child);
+          }
+        }
+
+        for (int index : indices)
+        {
+          cellScene.AddGameObject(gameObjects[index]);
+        }
+        for (int index : indices)
+        {
+          int parentIndex = nodes[index].m_parentIndex;
+          if (parentIndex >= 0)
+          {
+            cellScene.SetParent(gameObjects[index], gameObjects[parentIndex]);
+          }
+        }
+
+        String fileName = GetCellFileName(settings.m_worldName, coord);
+        cellScene.SetSceneName(fileName.substr(0, fileName.rfind('.')));
+        Serialization::SerializeToFile(cellScene, fileName
+          , FileSystem::DirectoryType::Scenes, SceneManager::SerializeScene);
+
+        //The GameObjects belong to scene, not to the temporary cell scene
+        cellScene.Clear();
+      }
+
+      Debug::Log << Logger::MessageType::INFO << "WorldPartition::PartitionScene: "
+        << scene.GetSceneName() << " into " << cellCoords.size() << " cells\n";
+      return cellCoords.size();
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    void WorldPartition::PollLoads(void)
+    {
+      for (auto& pair : m_cells)
+      {
+        Cell& cell = pair.second;
+        if (cell.m_state != CellState::LOADING
+          || cell.m_load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+          continue;
+        }
+
+        --m_pendingLoads;
+        if (!cell.m_load.get())
+        {
+          cell.m_staged.reset();
+          cell.m_state = CellState::EMPTY;
+          continue;
+        }
+
+        cell.m_size = cell.m_staged->m_loader.GetStagedSize();
+        cell.m_state = CellState::STAGED;
+        m_residentSize += cell.m_size;
+
+        //The size is only known now, make room or give the cell up
+        if (m_residentSize > m_settings.m_memoryBudget && !FitBudget(0, cell.m_distance))
+        {
+          Debug::Log << Logger::MessageType::WARNING << "WorldPartition memory budget exceeded, dropped cell "
+            << cell.m_coord.m_x << ", " << cell.m_coord.m_z << '\n';
+          Unload(cell);
+        }
+      }
+    }
+
+    void WorldPartition::StartLoad(Cell& cell)
+    {
+      cell.m_staged = std::make_unique<SceneManager::StagedScene>();
+      cell.m_state = CellState::LOADING;
+      ++m_pendingLoads;
+
+      CellSourceFN source = m_source;
+      CellCoord coord = cell.m_coord;
+      SceneManager::StagedScene* staged = cell.m_staged.get();
+      cell.m_load = std::async(std::launch::async, [source, coord, staged]()
+      {
+        String json;
+        if (!source(coord, json))
+        {
+          return false;
+        }
+
+        SceneManager::StageScene(json, *staged);
+        return true;
+      });
+    }
+
+    void WorldPartition::Activate(Cell& cell)
+    {
+      PROFILE_ZONE("WorldPartition::Activate");
+      auto handle = Factory::Create<Scene>("Scene");
+      SceneManager::CommitScene(*cell.m_staged, *handle);
+      cell.m_staged.reset();
+
+      SceneManager::InitLoadedScene(*handle);
+      SceneManager::AddScene(handle);
+
+      cell.m_scene = handle;
+      cell.m_state = CellState::ACTIVE;
+    }
+
+    void WorldPartition::Unload(Cell& cell)
+    {
+      switch (cell.m_state)
+      {
+        case CellState::ACTIVE:
+          SceneManager::CloseScene(cell.m_scene);
+          cell.m_scene = Handle<Scene>();
+          m_residentSize -= cell.m_size;
+          cell.m_state = CellState::UNLOADED;
+          break;
+        case CellState::STAGED:
+          cell.m_staged.reset();
+          m_residentSize -= cell.m_size;
+          cell.m_state = CellState::UNLOADED;
+          break;
+        default:
+          break;
+      }
+    }
+
+    bool WorldPartition::FitBudget(size_t extraSize, float distance)
+    {
+      while (m_residentSize + extraSize > m_settings.m_memoryBudget)
+      {
+        Cell* farthest = nullptr;
+        for (auto& pair : m_cells)
+        {
+          Cell& cell = pair.second;
+          if ((cell.m_state == CellState::ACTIVE || cell.m_state == CellState::STAGED)
+            && cell.m_distance > distance
+            && (farthest == nullptr || cell.m_distance > farthest->m_distance))
+          {
+            farthest = &cell;
+          }
+        }
+
+        if (farthest == nullptr)
+        {
+          return false;
+        }
+        Unload(*farthest);
+      }
+      return true;
+    }
+
+    U64 WorldPartition::GetCellKey(const CellCoord& cell)
+    {
+      return (static_cast<U64>(static_cast<U32>(cell.m_x)) << 32) | static_cast<U32>(cell.m_z);
+    }
+  }
+}
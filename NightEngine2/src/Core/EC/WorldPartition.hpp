@@ -0,0 +1,171 @@
+/*!
+  @file WorldPartition.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of WorldPartition
+*/
+
+#pragma once
+
+#include "Core/EC/Handle.hpp"
+#include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/Hashmap.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    class Scene;
+
+    namespace SceneManager
+    {
+      struct StagedScene;
+    }
+
+    //! @brief Grid coordinate of a cell on the XZ plane
+    struct CellCoord
+    {
+      int m_x = 0;
+      int m_z = 0;
+
+      bool operator==(const CellCoord& rhs) const { return m_x == rhs.m_x && m_z == rhs.m_z; }
+    };
+
+    //! @brief How a world is cut into cells and streamed around the focus
+    struct WorldPartitionSettings
+    {
+      Container::String m_worldName;                          //Cells are "<worldName>_<x>_<z>.nscene"
+      float             m_cellSize = 64.0f;
+      float             m_loadRadius = 128.0f;                //Cells closer than this are streamed in
+      float             m_unloadRadius = 192.0f;              //Cells farther than this are streamed out
+      unsigned          m_activationsPerFrame = 1;            //Staged cells committed per Update
+      unsigned          m_maxPendingLoads = 4;                //Cells read and staged at the same time
+      size_t            m_memoryBudget = 256 * 1024 * 1024;   //Estimated bytes of the staged and active cells
+    };
+
+    //! @brief Stream the cells of a world as scenes around a focus position.
+    // Cell files are read and deserialized on background threads, then a few
+    // staged cells a frame are committed on the main thread. The gap between
+    // the load and unload radius keep a focus on a border from flipping cells.
+    class WorldPartition
+    {
+    public:
+      //! @brief Give the content of a cell file, false if the cell has nothing. Called on background threads
+      using CellSourceFN = std::function<bool(const CellCoord& cell, Container::String& outJson)>;
+
+      enum class CellState : Container::U8
+      {
+        UNLOADED = 0,
+        LOADING,      //Read and staged on a background thread
+        STAGED,       //Waiting for its activation
+        ACTIVE,       //Committed, its scene is opened
+        EMPTY         //No file for this cell
+      };
+
+      //! @brief Constructor
+      WorldPartition(void) = default;
+
+      //! @brief Destructor, close the world
+      ~WorldPartition();
+
+      WorldPartition(const WorldPartition&) = delete;
+      WorldPartition& operator=(const WorldPartition&) = delete;
+
+      //! @brief Start streaming a world, the cell files are read from the Scenes directory when source is null
+      void Open(const WorldPartitionSettings& settings, CellSourceFN source = nullptr);
+
+      //! @brief Wait for the loads in flight then close every cell scene
+      void Close(void);
+
+      //! @brief Stream around focus, on the main thread once per frame
+      void Update(const glm::vec3& focus);
+
+      //! @brief Block until every cell being loaded is staged, the next Update activate them
+      void WaitForLoads(void);
+
+      //! @brief Match the cells to the opened scenes again after they were swapped
+      // behind the partition, like a play mode restore. Cell scenes are found by name
+      void ResyncScenes(void);
+
+      bool IsOpen(void) const { return m_open; }
+
+      const WorldPartitionSettings& GetSettings(void) const { return m_settings; }
+
+      //! @brief State of a cell, UNLOADED if it isn't tracked
+      CellState GetCellState(const CellCoord& cell) const;
+
+      //! @brief Scene of an active cell, null otherwise
+      Handle<Scene> GetCellScene(const CellCoord& cell) const;
+
+      //! @brief Estimated bytes of the staged and active cells
+      size_t GetResidentSize(void) const { return m_residentSize; }
+
+      //! @brief Amount of active cells
+      size_t GetActiveCellCount(void) const;
+
+      //! @brief Amount of cells being read and staged
+      unsigned GetPendingLoadCount(void) const { return m_pendingLoads; }
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief Cell containing position
+      static CellCoord GetCell(const glm::vec3& position, float cellSize);
+
+      //! @brief Distance on the XZ plane from position to the closest point of the cell
+      static float GetCellDistance(const CellCoord& cell, const glm::vec3& position, float cellSize);
+
+      //! @brief File name of a cell, without directory
+      static Container::String GetCellFileName(const Container::String& worldName, const CellCoord& cell);
+
+      //! @brief Cell of a scene named after GetCellFileName, false if it isn't a cell of worldName
+      static bool ParseCellSceneName(const Container::String& worldName
+        , const Container::String& sceneName, CellCoord& outCell);
+
+      //! @brief Write the top level GameObjects of scene into cell files by position,
+      // children follow their root. Return the amount of cell files written
+      static size_t PartitionScene(const Scene& scene, const WorldPartitionSettings& settings);
+    private:
+      struct Cell
+      {
+        CellCoord                                   m_coord;
+        CellState                                   m_state = CellState::UNLOADED;
+        float                                       m_distance = 0.0f;
+        size_t                                      m_size = 0;      //Known once staged, kept after an unload
+        std::future<bool>                           m_load;
+        std::unique_ptr<SceneManager::StagedScene>  m_staged;
+        Handle<Scene>                               m_scene;
+      };
+
+      //! @brief Move the finished loads to STAGED or EMPTY
+      void PollLoads(void);
+
+      //! @brief Start reading and staging the cell on a background thread
+      void StartLoad(Cell& cell);
+
+      //! @brief Commit the staged cell into a new opened scene
+      void Activate(Cell& cell);
+
+      //! @brief Drop the staging or close the scene of the cell
+      void Unload(Cell& cell);
+
+      //! @brief Evict the farthest cells beyond distance until extraSize fit the budget
+      bool FitBudget(size_t extraSize, float distance);
+
+      static Container::U64 GetCellKey(const CellCoord& cell);
+
+      WorldPartitionSettings                  m_settings;
+      CellSourceFN                            m_source;
+      Container::Hashmap<Container::U64, Cell> m_cells;
+      size_t                                  m_residentSize = 0;
+      unsigned                                m_pendingLoads = 0;
+      bool                                    m_open = false;
+    };
+  }
+}
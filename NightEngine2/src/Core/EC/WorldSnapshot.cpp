@@ -0,0 +1,206 @@
+/*!
+  @file WorldSnapshot.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of WorldSnapshot
+*/
+
+#include "Core/EC/WorldSnapshot.hpp"
+#include "Core/EC/ComponentLogic.hpp"
+#include "Core/EC/Factory.hpp"
+
+#include "Core/Container/Allocator.hpp"
+#include "Core/Container/StringIntern.hpp"
+#include "Core/Reflection/ReflectionMacros.hpp"
+#include "Core/Utility/Profiling.hpp"
+
+using namespace NightEngine::Container;
+using namespace NightEngine::Reflection;
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    static StringIDMap<SnapshotHooks>& GetHooksMap(void)
+    {
+      static StringIDMap<SnapshotHooks> hooksMap;
+      return hooksMap;
+    }
+
+    static void DestroyComponent(void* object)
+    {
+      static_cast<ComponentLogic*>(object)->OnDestroy();
+    }
+
+    static void RunHook(SnapshotHooks::HookFN hook, DenseIndex typeIndex, U32 slotIndex)
+    {
+      if (hook != nullptr)
+      {
+        hook(Factory::g_factory.GetFunctionInfo(typeIndex).m_slotObjectFn(slotIndex));
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    WorldSnapshot::~WorldSnapshot()
+    {
+      Release();
+    }
+
+    void WorldSnapshot::Capture(const Vector<String>& typeNames)
+    {
+      PROFILE_ZONE("WorldSnapshot::Capture");
+      Release();
+
+      auto& hooksMap = GetHooksMap();
+      auto componentLogic = METATYPE(ComponentLogic);
+
+      //Every container get a section of the buffer, aligned for its slot entries
+      size_t size = 0;
+      for (auto& typeName : typeNames)
+      {
+        DenseIndex typeIndex = Factory::g_factory.GetTypeIndex(typeName.c_str());
+        ASSERT_MSG(typeIndex != c_INVALID_DENSE_INDEX
+          , "Trying to snapshot an unregistered typeName");
+
+        Section section{ typeIndex, size, SnapshotHooks{} };
+        auto it = hooksMap.find(ToStringID(typeName.c_str()));
+        if (it != hooksMap.end())
+        {
+          section.m_hooks = it->second;
+        }
+
+        auto metaType = METATYPE_FROM_STRING(typeName);
+        if (section.m_hooks.m_onDrop == nullptr
+          && metaType != nullptr && metaType->IsDerivedFrom(componentLogic))
+        {
+          section.m_hooks.m_onDrop = DestroyComponent;
+        }
+
+        m_sections.emplace_back(section);
+
+        auto& info = Factory::g_factory.GetFunctionInfo(typeIndex);
+        size = AlignUp(size + info.m_stateSizeFn(), alignof(std::max_align_t));
+      }
+
+      m_size = size;
+      m_buffer = static_cast<U8*>(TaggedHeap::Allocate(std::max<size_t>(m_size, 1)
+        , MemoryTag::ECS));
+
+      for (auto& section : m_sections)
+      {
+        auto& info = Factory::g_factory.GetFunctionInfo(section.m_typeIndex);
+        info.m_writeStateFn(m_buffer + section.m_offset);
+      }
+    }
+
+    bool WorldSnapshot::Restore(void)
+    {
+      PROFILE_ZONE("WorldSnapshot::Restore");
+      if (m_buffer == nullptr)
+      {
+        return false;
+      }
+
+      //Classify every slot before any hook touch the containers
+      Vector<Vector<SlotChange>> changes(m_sections.size());
+      for (size_t i = 0; i < m_sections.size(); ++i)
+      {
+        auto& info = Factory::g_factory.GetFunctionInfo(m_sections[i].m_typeIndex);
+        info.m_compareStateFn(m_buffer + m_sections[i].m_offset, changes[i]);
+      }
+
+      //Let the current objects let go of what they own outside the containers
+      for (size_t i = 0; i < m_sections.size(); ++i)
+      {
+        auto& section = m_sections[i];
+        for (U32 slot = 0; slot < changes[i].size(); ++slot)
+        {
+          switch (changes[i][slot])
+          {
+            case SlotChange::DROPPED:
+            case SlotChange::REPLACED:
+              RunHook(section.m_hooks.m_onDrop, section.m_typeIndex, slot);
+              break;
+            case SlotChange::KEPT:
+              RunHook(section.m_hooks.m_onKeep, section.m_typeIndex, slot);
+              break;
+            default:
+              break;
+          }
+        }
+      }
+
+      for (auto& section : m_sections)
+      {
+        auto& info = Factory::g_factory.GetFunctionInfo(section.m_typeIndex);
+        info.m_readStateFn(m_buffer + section.m_offset);
+      }
+
+      //Every container is restored, hooks can follow handles to other types
+      for (size_t i = 0; i < m_sections.size(); ++i)
+      {
+        auto& section = m_sections[i];
+        for (U32 slot = 0; slot < changes[i].size(); ++slot)
+        {
+          switch (changes[i][slot])
+          {
+            case SlotChange::REVIVED:
+            case SlotChange::REPLACED:
+              RunHook(section.m_hooks.m_onRevive, section.m_typeIndex, slot);
+              break;
+            case SlotChange::KEPT:
+              RunHook(section.m_hooks.m_onRestored, section.m_typeIndex, slot);
+              break;
+            default:
+              break;
+          }
+        }
+      }
+
+      return true;
+    }
+
+    void WorldSnapshot::Release(void)
+    {
+      if (m_buffer == nullptr)
+      {
+        return;
+      }
+
+      for (auto& section : m_sections)
+      {
+        auto& info = Factory::g_factory.GetFunctionInfo(section.m_typeIndex);
+        info.m_releaseStateFn(m_buffer + section.m_offset);
+      }
+
+      TaggedHeap::Deallocate(m_buffer, std::max<size_t>(m_size, 1), MemoryTag::ECS);
+      m_buffer = nullptr;
+      m_size = 0;
+      m_sections.clear();
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    void WorldSnapshot::RegisterHooks(const char* typeName, const SnapshotHooks& hooks)
+    {
+      GetHooksMap()[StringIntern::Intern(typeName)] = hooks;
+    }
+
+    Vector<String> WorldSnapshot::GetWorldTypes(void)
+    {
+      Vector<String> typeNames{ "GameObject", "Scene" };
+
+      //Components are found through reflection, only the ones the factory can create
+      auto componentLogic = METATYPE(ComponentLogic);
+      for (auto metaType : MetaManager::GetMetaArray())
+      {
+        if (metaType != componentLogic && metaType->IsDerivedFrom(componentLogic)
+          && Factory::g_factory.GetTypeIndex(metaType->GetName().c_str()) != c_INVALID_DENSE_INDEX)
+        {
+          typeNames.emplace_back(metaType->GetName());
+        }
+      }
+      return typeNames;
+    }
+  }
+}
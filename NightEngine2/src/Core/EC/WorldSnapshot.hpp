@@ -0,0 +1,83 @@
+/*!
+  @file WorldSnapshot.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of WorldSnapshot
+*/
+
+#pragma once
+
+#include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/StringIntern.hpp"
+
+namespace NightEngine
+{
+  namespace EC
+  {
+    //! @brief Callbacks for objects owning something outside of their container,
+    // like a physics body or GPU buffers. object point to the registered type.
+    struct SnapshotHooks
+    {
+      using HookFN = void (*)(void* object);
+
+      HookFN m_onDrop = nullptr;      //Alive now, gone once restored. Null on a ComponentLogic call OnDestroy
+      HookFN m_onKeep = nullptr;      //Alive on both sides, before it is overwritten
+      HookFN m_onRestored = nullptr;  //Alive on both sides, after it is overwritten
+      HookFN m_onRevive = nullptr;    //Gone now, alive once restored
+    };
+
+    //! @brief Copy of the factory containers in one buffer, restored in place.
+    // Slots keep their index and generation, so every Handle stay valid across a restore.
+    class WorldSnapshot
+    {
+    public:
+      //! @brief Constructor
+      WorldSnapshot(void) = default;
+
+      //! @brief Destructor, release the buffer
+      ~WorldSnapshot();
+
+      WorldSnapshot(const WorldSnapshot&) = delete;
+      WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+      //! @brief Copy the containers of the factory types, replace the previous capture
+      void Capture(const Container::Vector<Container::String>& typeNames);
+
+      //! @brief Copy the containers of GetWorldTypes()
+      void Capture(void) { Capture(GetWorldTypes()); }
+
+      //! @brief Put the captured containers back, the capture is kept. False if nothing is captured
+      bool Restore(void);
+
+      //! @brief Free the buffer
+      void Release(void);
+
+      //! @brief Check if there is something to restore
+      bool IsCaptured(void) const { return m_buffer != nullptr; }
+
+      //! @brief Bytes used by the capture
+      size_t GetSize(void) const { return m_size; }
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief Set the hooks of a factory type, replace the previous ones
+      static void RegisterHooks(const char* typeName, const SnapshotHooks& hooks);
+
+      //! @brief GameObject, Scene and every factory type deriving from ComponentLogic
+      static Container::Vector<Container::String> GetWorldTypes(void);
+    private:
+      //! @brief Container of one type inside the buffer
+      struct Section
+      {
+        Container::DenseIndex m_typeIndex;
+        size_t                m_offset;
+        SnapshotHooks         m_hooks;
+      };
+
+      Container::Vector<Section>  m_sections;
+      Container::U8*              m_buffer = nullptr;
+      size_t                      m_size = 0;
+    };
+  }
+}
@@ -6,6 +6,8 @@
 #include "Core/Message/MessageObjectList.hpp"
 #include "Core/GameTime.hpp"
 #include "Core/Logger.hpp"
+#include "Core/Utility/Profiling.hpp"
+#include "Core/Container/Allocator.hpp"
 
 #include <thread>
 
@@ -23,6 +25,8 @@ namespace NightEngine
 	{
 		// Get the frame start time
 		m_frameStartTime = Clock::now();
+    PROFILE_FRAME_MARK();
+    m_frameStartHeapAllocations = Container::TaggedHeap::GetGlobalAllocationCount();
 	}
 
 	void GameTime::EndFrame()
@@ -65,10 +69,17 @@ namespace NightEngine
       m_averageFrameTimes[i] = m_averageFrameTimes[i + 1u];
     }
     m_averageFrameTimes[size - 1] = currTotalFrameTimeMS;
+    PROFILE_COUNTER("FrameTimeMS", currTotalFrameTimeMS);
 
     //Clear time stamp
     m_frameTimeStampTempStack.clear();
     m_frameTimeStampResult.clear();
+
+    //Every frame allocation is dead by now
+    m_frameHeapAllocations = Container::TaggedHeap::GetGlobalAllocationCount()
+      - m_frameStartHeapAllocations;
+    PROFILE_COUNTER("HeapAllocations", m_frameHeapAllocations);
+    Container::GetFrameArena().Reset();
 	}
 
   void GameTime::BeginTimeStamp(const char* name, int sortIndex)
@@ -80,6 +91,11 @@ namespace NightEngine
     fts.totalTimeMS = 0.0f;
     fts.indentCount = m_frameTimeStampTempStack.size();
     m_frameTimeStampTempStack.push_back(fts);
+
+#if PROFILER_ENABLED
+    //Time stamps also show up as zones in the profiler
+    Profiling::PushEvent(Profiling::EventType::ZONE_BEGIN, name);
+#endif
   }
 
   void GameTime::EndTimeStamp()
@@ -88,6 +104,9 @@ namespace NightEngine
     {
       //Calculate total time ms passed since startTime
       auto& frameTime = m_frameTimeStampTempStack[m_frameTimeStampTempStack.size() - 1];
+#if PROFILER_ENABLED
+      Profiling::PushEvent(Profiling::EventType::ZONE_END, frameTime.name);
+#endif
       auto timeNS = (Clock::now() - frameTime.startTime);
       float timeMS = std::chrono::duration_cast<MilliSeconds>(timeNS).count();
       frameTime.totalTimeMS = timeMS;
@@ -8,6 +8,7 @@
 #include "Core/Message/IMessageHandler.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <vector>
 
 namespace NightEngine
@@ -101,5 +102,9 @@ namespace NightEngine
 
 		std::vector<FrameTimeStamp> m_frameTimeStampTempStack;
 		std::vector<FrameTimeStamp> m_frameTimeStampResult;
+
+    //Global heap allocations (operator new) made during the last frame
+    uint64_t m_frameHeapAllocations = 0;
+    uint64_t m_frameStartHeapAllocations = 0;
   };
 } // namespace World
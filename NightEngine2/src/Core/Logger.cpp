@@ -9,6 +9,9 @@
 #include "Core/Message/MessageSystem.hpp"
 #include "Core/Message/MessageObjectList.hpp"
 
+#include <algorithm>
+#include <cstdio>
+
 namespace NightEngine
 {
 	namespace Debug
@@ -17,10 +20,208 @@ namespace NightEngine
 		Logger Log;
 	}
 
-	Logger::Logger(): m_curMessageType(MessageType::INFO) {}
+  namespace LogInternal
+  {
+    //! @brief Header of every record in the ring, records are 8 bytes aligned
+    struct RecordHeader
+    {
+      uint32_t    m_size;       //Total size including header
+      uint32_t    m_argCount;   //c_wrapMarker means skip to the beginning of the ring
+      uint64_t    m_sequence;   //Global order across threads
+      const char* m_format;     //nullptr for "<<" lines
+      uint32_t    m_type;
+      uint32_t    m_padding;
+    };
+
+    static constexpr uint32_t c_wrapMarker = 0xFFFFFFFFu;
+    static constexpr size_t   c_ringCapacity = 1u << 18;   //256KB per thread
+    static constexpr size_t   c_maxRecordSize = c_ringCapacity / 4;
+    static constexpr size_t   c_maxDevConsoleLines = 1024;  //Until the main thread pick them up
+    static constexpr uint64_t c_noSequence = ~uint64_t(0);
+
+    inline size_t AlignRecord(size_t size) { return (size + 7u) & ~size_t(7u); }
+
+    class LogRingBuffer
+    {
+    public:
+      LogRingBuffer(void) : m_buffer(new char[c_ringCapacity]) {}
+
+      //! @brief Producer: write a record, spin if the logger thread is behind
+      void Write(const RecordHeader& header, const char* args, size_t argsSize)
+      {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t index = head & (c_ringCapacity - 1);
+        size_t contiguous = c_ringCapacity - index;
+        size_t needed = contiguous < header.m_size ? contiguous + header.m_size : header.m_size;
+
+        while (c_ringCapacity - (head - m_tail.load(std::memory_order_acquire)) < needed)
+        {
+          std::this_thread::yield();
+        }
+
+        //Not enough space at the end, mark the rest as padding and wrap around
+        if (contiguous < header.m_size)
+        {
+          RecordHeader wrap{};
+          wrap.m_argCount = c_wrapMarker;
+          std::memcpy(m_buffer.get() + index, &wrap, sizeof(uint32_t) * 2);
+          head += contiguous;
+          index = 0;
+        }
+
+        std::memcpy(m_buffer.get() + index, &header, sizeof(RecordHeader));
+        std::memcpy(m_buffer.get() + index + sizeof(RecordHeader), args, argsSize);
+        m_head.store(head + header.m_size, std::memory_order_release);
+      }
+
+      //! @brief Consumer: get the oldest record, nullptr if empty
+      const RecordHeader* Peek(void)
+      {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+        {
+          return nullptr;
+        }
+
+        size_t index = tail & (c_ringCapacity - 1);
+        auto header = reinterpret_cast<const RecordHeader*>(m_buffer.get() + index);
+        if (header->m_argCount == c_wrapMarker)
+        {
+          m_tail.store(tail + (c_ringCapacity - index), std::memory_order_release);
+          return Peek();
+        }
+        return header;
+      }
+
+      //! @brief Consumer: release the record returned by Peek()
+      void Pop(const RecordHeader* header)
+      {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + header->m_size
+          , std::memory_order_release);
+      }
+
+      std::unique_ptr<char[]> m_buffer;
+      alignas(64) std::atomic<size_t> m_head{ 0 };
+      alignas(64) std::atomic<size_t> m_tail{ 0 };
+      std::atomic<bool> m_retired{ false };
+
+      //Sequence reserved by the owner thread but not published yet, c_noSequence when idle.
+      //The logger thread never merge past it so a late record can't be written out of order
+      std::atomic<uint64_t> m_inFlight{ c_noSequence };
+
+      //Owner thread only
+      std::vector<char> m_pendingLine;
+      std::vector<char> m_scratch;
+      uint32_t          m_pendingArgCount = 0;
+      bool              m_pendingFiltered = false;
+      Logger::MessageType m_pendingType = Logger::MessageType::INFO;
+    };
+
+    //! @brief Mark the ring as retired when its thread exit, the logger thread free it once drained
+    struct RingRetirer
+    {
+      LogRingBuffer* m_ring = nullptr;
+      ~RingRetirer()
+      {
+        if (m_ring != nullptr)
+        {
+          m_ring->m_retired.store(true, std::memory_order_release);
+        }
+      }
+    };
+
+    static thread_local RingRetirer t_ringRetirer;
+
+    //! @brief Read an argument and append its text to str
+    static const char* FormatArg(std::string& str, const char* arg)
+    {
+      char text[64];
+      ArgTag tag = static_cast<ArgTag>(*arg++);
+      switch (tag)
+      {
+      case ArgTag::I64:
+      {
+        int64_t value;
+        std::memcpy(&value, arg, sizeof(value));
+        str += std::to_string(value);
+        return arg + sizeof(value);
+      }
+      case ArgTag::U64:
+      {
+        uint64_t value;
+        std::memcpy(&value, arg, sizeof(value));
+        str += std::to_string(value);
+        return arg + sizeof(value);
+      }
+      case ArgTag::F64:
+      {
+        double value;
+        std::memcpy(&value, arg, sizeof(value));
+        std::snprintf(text, sizeof(text), "%g", value);
+        str += text;
+        return arg + sizeof(value);
+      }
+      case ArgTag::BOOL:
+      {
+        bool value;
+        std::memcpy(&value, arg, sizeof(value));
+        str += value ? '1' : '0';
+        return arg + sizeof(value);
+      }
+      case ArgTag::CHAR:
+      {
+        str += *arg;
+        return arg + 1;
+      }
+      case ArgTag::STRING:
+      {
+        uint32_t length;
+        std::memcpy(&length, arg, sizeof(length));
+        str.append(arg + sizeof(length), length);
+        return arg + sizeof(length) + length;
+      }
+      case ArgTag::POINTER:
+      {
+        const void* value;
+        std::memcpy(&value, arg, sizeof(value));
+        std::snprintf(text, sizeof(text), "%p", value);
+        str += text;
+        return arg + sizeof(value);
+      }
+      case ArgTag::TYPE:
+      {
+        Logger::MessageType value;
+        std::memcpy(&value, arg, sizeof(value));
+        switch (value)
+        {
+        case Logger::MessageType::ERROR_MSG: str += "[error] "; break;
+        case Logger::MessageType::INFO: str += "[info] "; break;
+        case Logger::MessageType::WARNING: str += "[warning] "; break;
+        case Logger::MessageType::LUA: str += "[lua] "; break;
+        }
+        return arg + sizeof(value);
+      }
+      }
+      return arg;
+    }
+  }
+
+  using namespace LogInternal;
+
+	Logger::Logger(): m_running(true)
+  {
+    m_consumer = std::thread(&Logger::ConsumerLoop, this);
+  }
 
 	Logger::~Logger()
 	{
+    m_running.store(false, std::memory_order_release);
+    if (m_consumer.joinable())
+    {
+      m_consumer.join();
+    }
+    DrainRings();
+
     if (m_outfileStream.is_open())
     {
       m_outfileStream.close();
@@ -32,7 +233,10 @@ namespace NightEngine
 		// Open log file
 		std::string path = PROJECT_DIR_LOGFILE;
 		path += filename;
-		m_outfileStream.open(path);
+    {
+      std::lock_guard<std::mutex> guard(m_drainMutex);
+      m_outfileStream.open(path);
+    }
 
 		//Check error
 		if (!m_outfileStream.is_open())
@@ -48,126 +252,366 @@ namespace NightEngine
 
 	void Logger::SendLogToDevConsole()
 	{
-    std::string log{m_logStream.str()};
-    LogMessage logMsg{ log };
-    MessageSystem::Get().BroadcastMessage(logMsg
-    , BroadcastScope::HANDLER);
-
-    //Clear stringstream
-    m_logStream.str(std::string());
-    m_logStream.clear();
+    {
+      std::lock_guard<std::mutex> guard(m_devConsoleMutex);
+      if (m_devConsoleLines.empty())
+      {
+        return;
+      }
+      m_devConsoleSendLines.swap(m_devConsoleLines);
+    }
+
+    for (auto& log : m_devConsoleSendLines)
+    {
+      LogMessage logMsg{ std::move(log) };
+      MessageSystem::Get().BroadcastMessage(logMsg
+        , BroadcastScope::HANDLER);
+    }
+    m_devConsoleSendLines.clear();
 	}
 
-  Logger & Logger::operator<<(const std::string& message)
+  void Logger::Flush()
   {
-    using namespace NightEngine;
+    uint64_t target = m_sequence.load(std::memory_order_acquire);
+    if (!m_running.load(std::memory_order_acquire))
+    {
+      DrainRings();
+      return;
+    }
 
-    // Send message to Logger
-    std::cout << message;
+    while (m_written.load(std::memory_order_acquire) < target)
+    {
+      std::this_thread::yield();
+    }
+  }
 
-    // Send to DevConsole
-    m_logStream << message;
-    if (message.find_first_of('\n') != std::string::npos)
+  unsigned Logger::GetSeverity(MessageType type)
+  {
+    switch (type)
     {
-      SendLogToDevConsole();
+    case MessageType::WARNING: return 1;
+    case MessageType::ERROR_MSG: return 2;
+    default: return 0;
     }
+  }
 
-    if (m_outfileStream.is_open())
+  //*****************************************************
+  // Producer
+  //*****************************************************
+
+  LogRingBuffer& Logger::GetThreadRing()
+  {
+    LogRingBuffer* ring = t_ringRetirer.m_ring;
+    if (ring == nullptr)
     {
-      m_outfileStream << message;
+      auto newRing = std::make_unique<LogRingBuffer>();
+      ring = newRing.get();
+
+      std::lock_guard<std::mutex> guard(m_ringsMutex);
+      m_rings.emplace_back(std::move(newRing));
+      t_ringRetirer.m_ring = ring;
     }
+    return *ring;
+  }
 
-    return *this;
+  std::vector<char>* Logger::GetPendingLine()
+  {
+    LogRingBuffer& ring = GetThreadRing();
+    return ring.m_pendingFiltered ? nullptr : &ring.m_pendingLine;
   }
 
-  Logger & Logger::operator<<(const char* message)
+  uint32_t& Logger::GetPendingArgCount()
   {
-    using namespace NightEngine;
+    return GetThreadRing().m_pendingArgCount;
+  }
 
-    // Send message to Logger
-    std::cout <<  message;
+  std::vector<char>& Logger::GetScratchBuffer()
+  {
+    return GetThreadRing().m_scratch;
+  }
 
-    // Send to DevConsole
-    m_logStream << message;
-    if (strstr(message, "\n"))
+  void Logger::CommitPendingLine()
+  {
+    LogRingBuffer& ring = GetThreadRing();
+    if (!ring.m_pendingFiltered && ring.m_pendingArgCount > 0)
     {
-      SendLogToDevConsole();
+      CommitRecord(ring.m_pendingType, nullptr
+        , ring.m_pendingArgCount, ring.m_pendingLine);
     }
 
-    if (m_outfileStream.is_open())
+    ring.m_pendingLine.clear();
+    ring.m_pendingArgCount = 0;
+    ring.m_pendingFiltered = false;
+    ring.m_pendingType = MessageType::INFO;
+  }
+
+  void Logger::CommitRecord(MessageType type, const char* format
+    , uint32_t argCount, const std::vector<char>& args)
+  {
+    static const char c_tooLarge[] = "<log record too large>";
+    std::vector<char> truncated;
+    const std::vector<char>* payload = &args;
+    if (AlignRecord(sizeof(RecordHeader) + args.size()) > c_maxRecordSize)
     {
-      m_outfileStream << message;
+      AppendString(truncated, c_tooLarge, sizeof(c_tooLarge) - 1);
+      payload = &truncated;
+      argCount = 1;
+      format = nullptr;
     }
 
-    return *this;
+    RecordHeader header{};
+    header.m_size = static_cast<uint32_t>(AlignRecord(sizeof(RecordHeader) + payload->size()));
+    header.m_argCount = argCount;
+    header.m_format = format;
+    header.m_type = static_cast<uint32_t>(type);
+
+    //Announce a lower bound before reserving, the drain stop below it until the record is in the ring
+    LogRingBuffer& ring = GetThreadRing();
+    ring.m_inFlight.store(m_sequence.load());
+    header.m_sequence = m_sequence.fetch_add(1);
+
+    ring.Write(header, payload->data(), payload->size());
+    ring.m_inFlight.store(c_noSequence);
+
+    //Logger thread is gone (static destruction), write it out right away
+    if (!m_running.load(std::memory_order_acquire))
+    {
+      DrainRings();
+    }
   }
 
-  Logger & Logger::operator<<(const char & message)
+  Logger& Logger::operator<<(const std::string& message)
   {
-    using namespace NightEngine;
+    std::vector<char>* line = GetPendingLine();
+    if (line != nullptr)
+    {
+      AppendString(*line, message.c_str(), static_cast<uint32_t>(message.size()));
+      ++GetPendingArgCount();
+    }
 
-    // Send message to Logger
-    std::cout << message;
+    if (message.find_first_of('\n') != std::string::npos)
+    {
+      CommitPendingLine();
+    }
+    return *this;
+  }
 
-    // Send to DevConsole
-    m_logStream << message;
-    if (message == '\n')
+  Logger& Logger::operator<<(const char* message)
+  {
+    size_t length = std::strlen(message);
+    std::vector<char>* line = GetPendingLine();
+    if (line != nullptr)
     {
-      SendLogToDevConsole();
+      AppendString(*line, message, static_cast<uint32_t>(length));
+      ++GetPendingArgCount();
     }
 
-    if (m_outfileStream.is_open())
+    if (std::memchr(message, '\n', length) != nullptr)
+    {
+      CommitPendingLine();
+    }
+    return *this;
+  }
+
+  Logger& Logger::operator<<(const char& message)
+  {
+    std::vector<char>* line = GetPendingLine();
+    if (line != nullptr)
     {
-      m_outfileStream << message;
+      AppendRaw(*line, ArgTag::CHAR, message);
+      ++GetPendingArgCount();
     }
 
+    if (message == '\n')
+    {
+      CommitPendingLine();
+    }
     return *this;
   }
 
-  Logger & Logger::operator<<(MessageType type)
+  Logger& Logger::operator<<(MessageType type)
 	{
-		m_curMessageType = type;
-		
-		// TODO: Newline to DevConsole
-		switch (type)
-		{
-			case MessageType::ERROR_MSG:
-			{
-				std::cout << "[error] ";
-        m_logStream << "[error] ";
-				break;
-			}
-			case MessageType::INFO:
-			{
-				std::cout << "[info] ";
-        m_logStream << "[info] ";
-				break;
-			}
-			case MessageType::WARNING:
-			{
-				std::cout << "[warning] ";
-        m_logStream << "[warning] ";
-				break;
-			}
-      case MessageType::LUA:
-      {
-        std::cout << "[lua] ";
-        m_logStream << "[lua] ";
-        break;
-      }
-		}
+    LogRingBuffer& ring = GetThreadRing();
+    if (!IsEnabled(type))
+    {
+      //Drop the rest of this line
+      ring.m_pendingFiltered = true;
+      ring.m_pendingLine.clear();
+      ring.m_pendingArgCount = 0;
+      return *this;
+    }
 
+    ring.m_pendingType = type;
+    if (!ring.m_pendingFiltered)
+    {
+      AppendRaw(ring.m_pendingLine, ArgTag::TYPE, type);
+      ++ring.m_pendingArgCount;
+    }
 		return *this;
 	}
 
-	Logger & Logger::operator<<(std::ostream &(*OutStreamFn)(std::ostream &))
+	Logger& Logger::operator<<(std::ostream &(*OutStreamFn)(std::ostream &))
 	{
-    OutStreamFn(std::cout);
-		if (m_outfileStream.is_open())
-		{
-      OutStreamFn(m_outfileStream);
-		}
-
+    using OStreamFN = std::ostream& (*)(std::ostream&);
+    if (OutStreamFn == static_cast<OStreamFN>(std::endl))
+    {
+      *this << '\n';
+    }
+    else if (OutStreamFn == static_cast<OStreamFN>(std::flush))
+    {
+      CommitPendingLine();
+    }
 		return *this;
 	}
+
+  //*****************************************************
+  // Consumer
+  //*****************************************************
+
+  void Logger::ConsumerLoop()
+  {
+    while (m_running.load(std::memory_order_acquire))
+    {
+      if (!DrainRings())
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  bool Logger::DrainRings()
+  {
+    std::lock_guard<std::mutex> drainGuard(m_drainMutex);
+
+    //Snapshot the rings, free the retired ones that are already drained
+    std::vector<LogRingBuffer*> rings;
+    {
+      std::lock_guard<std::mutex> guard(m_ringsMutex);
+      m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end()
+        , [](const std::unique_ptr<LogRingBuffer>& ring)
+        {
+          return ring->m_retired.load(std::memory_order_acquire)
+            && ring->Peek() == nullptr;
+        }), m_rings.end());
+
+      rings.reserve(m_rings.size());
+      for (auto& ring : m_rings)
+      {
+        rings.push_back(ring.get());
+      }
+    }
+
+    //Records below the limit are all published: read the counter first, a thread
+    //idle at that point can only reserve a sequence above it
+    uint64_t limit = m_sequence.load();
+    for (auto ring : rings)
+    {
+      limit = std::min(limit, ring->m_inFlight.load());
+    }
+
+    //Merge every ring in sequence order
+    bool wroteAny = false;
+    while (true)
+    {
+      LogRingBuffer* oldestRing = nullptr;
+      const RecordHeader* oldest = nullptr;
+      for (auto ring : rings)
+      {
+        const RecordHeader* header = ring->Peek();
+        if (header != nullptr && header->m_sequence < limit
+          && (oldest == nullptr || header->m_sequence < oldest->m_sequence))
+        {
+          oldest = header;
+          oldestRing = ring;
+        }
+      }
+
+      if (oldest == nullptr)
+      {
+        break;
+      }
+
+      auto args = reinterpret_cast<const char*>(oldest) + sizeof(RecordHeader);
+      WriteRecord(static_cast<MessageType>(oldest->m_type), oldest->m_format
+        , oldest->m_argCount, args, reinterpret_cast<const char*>(oldest) + oldest->m_size);
+
+      oldestRing->Pop(oldest);
+      m_written.fetch_add(1, std::memory_order_acq_rel);
+      wroteAny = true;
+    }
+
+    if (wroteAny)
+    {
+      std::cout.flush();
+      if (m_outfileStream.is_open())
+      {
+        m_outfileStream.flush();
+      }
+    }
+    return wroteAny;
+  }
+
+  void Logger::WriteRecord(MessageType type, const char* format
+    , uint32_t argCount, const char* args, const char* argsEnd)
+  {
+    m_formatted.clear();
+
+    if (format == nullptr)
+    {
+      //"<<" line, the arguments are the fragments
+      for (uint32_t i = 0; i < argCount && args < argsEnd; ++i)
+      {
+        args = FormatArg(m_formatted, args);
+      }
+    }
+    else
+    {
+      //Deferred format, substitute "{}" with the arguments in order
+      m_formatted += (type == MessageType::ERROR_MSG) ? "[error] "
+        : (type == MessageType::WARNING) ? "[warning] " : "[info] ";
+
+      uint32_t argIndex = 0;
+      for (const char* c = format; *c != '\0'; ++c)
+      {
+        if (c[0] == '{' && c[1] == '}' && argIndex < argCount)
+        {
+          args = FormatArg(m_formatted, args);
+          ++argIndex;
+          ++c;
+        }
+        else
+        {
+          m_formatted += *c;
+        }
+      }
+
+      //Leftover arguments
+      for (; argIndex < argCount && args < argsEnd; ++argIndex)
+      {
+        m_formatted += ' ';
+        args = FormatArg(m_formatted, args);
+      }
+      m_formatted += '\n';
+    }
+
+    //Fan out to the sinks
+    unsigned sinks = m_sinkMask.load(std::memory_order_relaxed);
+    if (sinks & SINK_CONSOLE)
+    {
+      std::cout.write(m_formatted.data(), m_formatted.size());
+    }
+    if ((sinks & SINK_FILE) && m_outfileStream.is_open())
+    {
+      m_outfileStream.write(m_formatted.data(), m_formatted.size());
+    }
+    if (sinks & SINK_DEVCONSOLE)
+    {
+      std::lock_guard<std::mutex> guard(m_devConsoleMutex);
+      if (m_devConsoleLines.size() >= c_maxDevConsoleLines)
+      {
+        m_devConsoleLines.pop_front();
+      }
+      m_devConsoleLines.emplace_back(m_formatted);
+    }
+  }
 }
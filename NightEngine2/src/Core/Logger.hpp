@@ -10,13 +10,135 @@
 #include <string>
 #include <sstream>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
 
 #define DEBUG_INFO NightEngine::Debug::Log << NightEngine::Logger::MessageType::INFO
 #define DEBUG_WARNING NightEngine::Debug::Log << NightEngine::Logger::MessageType::WARNING
 #define DEBUG_ERROR NightEngine::Debug::Log << NightEngine::Logger::MessageType::ERROR_MSG
 
+//! @brief Compile-time severity filter for LOG_* macros (0: info, 1: warning, 2: error)
+#ifndef LOG_COMPILE_LEVEL
+  #define LOG_COMPILE_LEVEL 0
+#endif
+
+//! @brief Deferred formatting log, FMT must be a string literal,
+// each "{}" is replaced by the next argument on the logger thread
+#if LOG_COMPILE_LEVEL <= 0
+  #define LOG_INFO(FMT, ...) NightEngine::Debug::Log.Format(NightEngine::Logger::MessageType::INFO, "" FMT, ##__VA_ARGS__)
+#else
+  #define LOG_INFO(FMT, ...) do {} while(0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 1
+  #define LOG_WARNING(FMT, ...) NightEngine::Debug::Log.Format(NightEngine::Logger::MessageType::WARNING, "" FMT, ##__VA_ARGS__)
+#else
+  #define LOG_WARNING(FMT, ...) do {} while(0)
+#endif
+
+#if LOG_COMPILE_LEVEL <= 2
+  #define LOG_ERROR(FMT, ...) NightEngine::Debug::Log.Format(NightEngine::Logger::MessageType::ERROR_MSG, "" FMT, ##__VA_ARGS__)
+#else
+  #define LOG_ERROR(FMT, ...) do {} while(0)
+#endif
+
 namespace NightEngine
 {
+  namespace LogInternal
+  {
+    //! @brief Type tag written in front of every raw argument
+    enum class ArgTag : uint8_t
+    {
+      I64 = 0,
+      U64,
+      F64,
+      BOOL,
+      CHAR,
+      STRING,   //u32 length + bytes
+      POINTER,
+      TYPE      //MessageType marker, print the severity prefix
+    };
+
+    //! @brief Single producer single consumer byte ring, one per logging thread
+    class LogRingBuffer;
+
+    //! @brief Append raw bytes of an argument into record buffer
+    template<typename T>
+    inline void AppendRaw(std::vector<char>& buffer, ArgTag tag, const T& value)
+    {
+      size_t offset = buffer.size();
+      buffer.resize(offset + 1 + sizeof(T));
+      buffer[offset] = static_cast<char>(tag);
+      std::memcpy(buffer.data() + offset + 1, &value, sizeof(T));
+    }
+
+    //! @brief Append string bytes into record buffer
+    inline void AppendString(std::vector<char>& buffer, const char* str, uint32_t length)
+    {
+      size_t offset = buffer.size();
+      buffer.resize(offset + 1 + sizeof(uint32_t) + length);
+      buffer[offset] = static_cast<char>(ArgTag::STRING);
+      std::memcpy(buffer.data() + offset + 1, &length, sizeof(uint32_t));
+      std::memcpy(buffer.data() + offset + 1 + sizeof(uint32_t), str, length);
+    }
+
+    //! @brief Encode argument without formatting, fallback to ostream for other types
+    template<typename T>
+    inline void AppendArg(std::vector<char>& buffer, const T& value)
+    {
+      using Type = std::decay_t<T>;
+      if constexpr (std::is_same_v<Type, bool>)
+      {
+        AppendRaw(buffer, ArgTag::BOOL, value);
+      }
+      else if constexpr (std::is_same_v<Type, char>)
+      {
+        AppendRaw(buffer, ArgTag::CHAR, value);
+      }
+      else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+      {
+        AppendRaw(buffer, ArgTag::I64, static_cast<int64_t>(value));
+      }
+      else if constexpr (std::is_integral_v<Type>)
+      {
+        AppendRaw(buffer, ArgTag::U64, static_cast<uint64_t>(value));
+      }
+      else if constexpr (std::is_floating_point_v<Type>)
+      {
+        AppendRaw(buffer, ArgTag::F64, static_cast<double>(value));
+      }
+      else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+      {
+        AppendString(buffer, value, static_cast<uint32_t>(std::strlen(value)));
+      }
+      else if constexpr (std::is_same_v<Type, std::string>)
+      {
+        AppendString(buffer, value.c_str(), static_cast<uint32_t>(value.size()));
+      }
+      else if constexpr (std::is_pointer_v<Type>)
+      {
+        AppendRaw(buffer, ArgTag::POINTER, static_cast<const void*>(value));
+      }
+      else
+      {
+        //Unknown type, format on the caller thread
+        thread_local std::ostringstream stream;
+        stream.str(std::string());
+        stream.clear();
+        stream << value;
+        std::string str = stream.str();
+        AppendString(buffer, str.c_str(), static_cast<uint32_t>(str.size()));
+      }
+    }
+  }
+
 	class Logger
 	{
 	public:
@@ -30,6 +152,15 @@ namespace NightEngine
       LUA
 		};
 
+    //! @brief Output targets of the logger thread
+    enum Sink : unsigned
+    {
+      SINK_CONSOLE = 1 << 0,
+      SINK_FILE = 1 << 1,
+      SINK_DEVCONSOLE = 1 << 2,
+      SINK_ALL = SINK_CONSOLE | SINK_FILE | SINK_DEVCONSOLE
+    };
+
 		///////////////////////////////////////////////////////
 
 		Logger();
@@ -38,9 +169,33 @@ namespace NightEngine
     //! @brief Set target output stream
 		void SetFileOutputStream(const std::string& filename);
 
-    //! @brief Broadcast LogMessage to DevConsole
+    //! @brief Broadcast formatted log lines to DevConsole, must be called on the main thread
 		void SendLogToDevConsole();
 
+    //! @brief Block until every committed record is written to the sinks
+    void Flush();
+
+    //! @brief Runtime severity filter (0: info, 1: warning, 2: error)
+    void SetLogLevel(unsigned level) { m_runtimeLevel.store(level, std::memory_order_relaxed); }
+
+    //! @brief Enable/Disable sinks with Sink mask
+    void SetSinks(unsigned sinkMask) { m_sinkMask.store(sinkMask, std::memory_order_relaxed); }
+
+    //! @brief Get current Sink mask
+    unsigned GetSinks(void) const { return m_sinkMask.load(std::memory_order_relaxed); }
+
+    //! @brief Amount of records written out by the logger thread
+    uint64_t GetWrittenCount(void) const { return m_written.load(std::memory_order_acquire); }
+
+    //! @brief Severity of MessageType used for filtering
+    static unsigned GetSeverity(MessageType type);
+
+    //! @brief Check runtime filter
+    inline bool IsEnabled(MessageType type) const
+    {
+      return GetSeverity(type) >= m_runtimeLevel.load(std::memory_order_relaxed);
+    }
+
 		//! @brief For sending things to Logger
 		template<typename ... T>
 		void Print(MessageType mode, const T& ... t)
@@ -49,23 +204,31 @@ namespace NightEngine
 			std::initializer_list<int>{ (*this << t, 0)... };
 		}
 
+    //! @brief Push a deferred formatting record, format must outlive the logger (string literal)
+    template<typename ... T>
+    void Format(MessageType type, const char* format, const T& ... args)
+    {
+      if (!IsEnabled(type))
+      {
+        return;
+      }
+
+      std::vector<char>& buffer = GetScratchBuffer();
+      buffer.clear();
+      std::initializer_list<int>{ (LogInternal::AppendArg(buffer, args), 0)... };
+      CommitRecord(type, format, sizeof...(T), buffer);
+    }
+
 		//! @brief For sending message to Logger
 		template<typename T>
 		Logger& operator<<(const T& message)
 		{
-      using namespace NightEngine;
-
-			// Send message to Logger
-			std::cout << message;
-
-      // Stream to send to DevConsole
-      m_logStream << message;
-
-			if (m_outfileStream.is_open())
-			{
-				m_outfileStream << message;
-			}
-
+      std::vector<char>* line = GetPendingLine();
+      if (line != nullptr)
+      {
+        LogInternal::AppendArg(*line, message);
+        ++GetPendingArgCount();
+      }
 			return *this;
 		}
 
@@ -85,9 +248,54 @@ namespace NightEngine
 		Logger& operator<<(std::ostream& (*OutStreamFn)(std::ostream&));
 
 	private:
+    //! @brief Pending "<<" line of this thread, nullptr if filtered
+    std::vector<char>* GetPendingLine();
+
+    //! @brief Argument count of the pending "<<" line of this thread
+    uint32_t& GetPendingArgCount();
+
+    //! @brief Per-thread scratch buffer for Format()
+    std::vector<char>& GetScratchBuffer();
+
+    //! @brief Commit the pending "<<" line of this thread into its ring
+    void CommitPendingLine();
+
+    //! @brief Write encoded record into this thread's ring
+    void CommitRecord(MessageType type, const char* format
+      , uint32_t argCount, const std::vector<char>& args);
+
+    //! @brief Get (or create) the ring of the calling thread
+    LogInternal::LogRingBuffer& GetThreadRing();
+
+    //! @brief Logger thread loop
+    void ConsumerLoop();
+
+    //! @brief Drain every ring in sequence order, return true if anything was written
+    bool DrainRings();
+
+    //! @brief Format a record and fan out to the sinks
+    void WriteRecord(MessageType type, const char* format
+      , uint32_t argCount, const char* args, const char* argsEnd);
+
 		std::ofstream m_outfileStream;	//For writing Log to text file
-    std::stringstream m_logStream;  //For accumulating before sending it to DevConsole
-    MessageType m_curMessageType;	
+    std::string   m_formatted;      //Logger thread formatting buffer
+    std::mutex    m_drainMutex;     //Only one thread drain the rings at a time
+
+    //Formatted lines waiting for SendLogToDevConsole() on the main thread
+    std::mutex               m_devConsoleMutex;
+    std::deque<std::string>  m_devConsoleLines;       //Oldest dropped in O(1) when full
+    std::deque<std::string>  m_devConsoleSendLines;   //Main thread only
+
+    //Every thread ring, owned by the logger
+    std::mutex                                              m_ringsMutex;
+    std::vector<std::unique_ptr<LogInternal::LogRingBuffer>> m_rings;
+
+    std::thread           m_consumer;
+    std::atomic<bool>     m_running{ false };
+    std::atomic<uint64_t> m_sequence{ 0 };
+    std::atomic<uint64_t> m_written{ 0 };
+    std::atomic<unsigned> m_runtimeLevel{ 0 };
+    std::atomic<unsigned> m_sinkMask{ SINK_ALL };
 	};
 
 	namespace Debug
@@ -74,6 +74,7 @@
 				NightEngine::Debug::Log << NightEngine::Logger::MessageType::ERROR_MSG << "Debug assertion \""		\
 					<< #EXP << "\" FAILED in: " << __func__ << ", line: " << __LINE__				\
 					<< ", file: " << __FILE__ << '\n';																				\
+				NightEngine::Debug::Log.Flush();																								\
 				DEBUG_BREAK();																																	\
 			}																																									\
 		} while(0)	
@@ -86,6 +87,7 @@
 					  << #EXP << "\" FAILED in: " << __func__ << ", line: " << __LINE__				      \
 					  << ", file: " << __FILE__ << '\n';                                            \
           NightEngine::Debug::Log << NightEngine::Logger::MessageType::ERROR_MSG << ERRORMSG << '\n';       \
+          NightEngine::Debug::Log.Flush();                                                                  \
 				  DEBUG_BREAK();																																	\
 			  }																																									\
 		  } while(0)																																	
@@ -136,6 +138,7 @@
 			NightEngine::Debug::Log << NightEngine::Logger::MessageType::ERROR_MSG <<											\
 				"OpenGL error encountered! " << __func__ << ", line " << __LINE__        \
 				<< ", file " << __FILE__ << ": " << text << std::endl;                   \
+			NightEngine::Debug::Log.Flush();                                           \
 			DEBUG_BREAK();                                                             \
 		}                                                                            \
 	}                                                                              \
@@ -65,8 +65,8 @@ namespace NightEngine
   struct LogMessage : public MessageObject
   {
     //Constructor
-    LogMessage(std::string& str)
-      :MessageObject(MessageType::MSG_LOGMESSAGE), m_string(str)
+    LogMessage(std::string str)
+      :MessageObject(MessageType::MSG_LOGMESSAGE), m_string(std::move(str))
     {}
 
     //Override Double dispatch
@@ -5,6 +5,8 @@
 */
 #include "Core/Message/MessageSystem.hpp"
 #include "Core/Message/MessageObject.hpp"
+#include "Core/Message/MessageTypeEnum.hpp"
+#include "Core/Container/StringIntern.hpp"
 #include "Core/Macros.hpp"
 
 #include <algorithm>
@@ -12,6 +14,8 @@
 
 namespace NightEngine
 {
+	using namespace Container;
+
 #define REGISTER_MESSAGE(MSG) #MSG ,
 	const char* msgTypeName[] =
 	{
@@ -21,42 +25,51 @@ namespace NightEngine
 	};
 #undef REGISTER_MESSAGE
 
+#define REGISTER_MESSAGE(MSG) STRING_ID(#MSG) ,
+	//! @brief StringID of msgTypeName, computed at compile time
+	const StringID msgTypeID[] =
+	{
+		STRING_ID("MSG_BASE"),
+#include "Core/Message/RegisterMessageList.inl"
+		STRING_ID("MSG_COUNT")
+	};
+#undef REGISTER_MESSAGE
+
+	MessageSystem::MessageSystem(void)
+		: m_msgHandlerLists(static_cast<size_t>(MessageType::MSG_COUNT))
+	{
+	}
+
 	const char * MessageSystem::LookupMessageName(MessageType msgType) const
 	{
 		return msgTypeName[static_cast<size_t>(msgType)];
 	}
 
+	MessageType MessageSystem::LookupMessageType(const char* msgName) const
+	{
+		//Few message types, a linear scan over the ids beat any map
+		StringID id = ToStringID(msgName);
+		for (size_t i = 0; i < static_cast<size_t>(MessageType::MSG_COUNT); ++i)
+		{
+			if (msgTypeID[i] == id)
+			{
+				return static_cast<MessageType>(i);
+			}
+		}
+
+		ASSERT_MSG(false, "Trying to lookup unregistered message type: " << msgName);
+		return MessageType::MSG_COUNT;
+	}
+
 	void MessageSystem::BroadcastMessage(MessageObject & msg, BroadcastScope scope)
 	{
     //TODO: accumulate all message and send at the end of the frame
 
-		const char* msgName = LookupMessageName(msg.m_msgType);
-		switch (scope)
+		//HANDLER and GLOBAL scope send to the same subscribers for now
+		IHandlerList& list = m_msgHandlerLists[static_cast<size_t>(msg.m_msgType)];
+		for (auto handler : list)
 		{
-			case BroadcastScope::HANDLER:
-			{
-				//If messageType exist, send msg to all handler
-				if (m_msgHandlerMap.find(msgName) != m_msgHandlerMap.end())
-				{
-					for(auto handler :m_msgHandlerMap[msgName])
-					{
-						msg.SendMessageTo(*handler);
-					}
-				}
-				break;
-			}
-			case BroadcastScope::GLOBAL:
-			{
-				//If messageType exist, send msg to all handler
-				if (m_msgHandlerMap.find(msgName) != m_msgHandlerMap.end())
-				{
-					for (auto handler : m_msgHandlerMap[msgName])
-					{
-						msg.SendMessageTo(*handler);
-					}
-				}
-				break;
-			}
+			msg.SendMessageTo(*handler);
 		}
 	}
 
@@ -70,54 +83,39 @@ namespace NightEngine
 
 	void MessageSystem::Subscribe(IMessageHandler& handler, MessageType msgType)
 	{
-		const char* msgName = LookupMessageName(msgType);
-		Subscribe(handler, msgName);
+		ASSERT_TRUE(msgType < MessageType::MSG_COUNT);
+		IHandlerList& list = m_msgHandlerLists[static_cast<size_t>(msgType)];
+
+		//Error if Subscribe to the same msg twice
+		ASSERT_TRUE(std::find(list.begin(), list.end(), &handler) == list.end());
+		list.push_back(&handler);
 	}
 
 	void MessageSystem::Subscribe(IMessageHandler& handler, const char* msgName)
 	{
-		//Already registered msgType
-		if (m_msgHandlerMap.find(msgName) != m_msgHandlerMap.end())
-		{
-			//Add to list if not already
-			IHandlerList& list = m_msgHandlerMap[msgName];
-			//Error if Subscribe to the same msg twice
-			ASSERT_TRUE(std::find(list.begin(), list.end(), &handler) == list.end());
-
-			m_msgHandlerMap[msgName].push_back(&handler);
-		}
-		else
-		{
-			//Register new msgType
-			IHandlerList handlerList{ &handler };
-			m_msgHandlerMap[msgName] = handlerList;
-
-			ASSERT_TRUE(m_msgHandlerMap[msgName][0] == &handler);
-		}
+		Subscribe(handler, LookupMessageType(msgName));
 	}
 
 	/////////////////////////////////////////////////////////
 
 	void MessageSystem::Unsubscribe(IMessageHandler& handler, MessageType msgType)
 	{
-		const char* msgName = LookupMessageName(msgType);
-		Unsubscribe(handler, msgName);
+		ASSERT_TRUE(msgType < MessageType::MSG_COUNT);
+		IHandlerList& list = m_msgHandlerLists[static_cast<size_t>(msgType)];
+
+		list.erase(std::remove(list.begin(), list.end(), &handler), list.end());
 	}
 
 	void MessageSystem::Unsubscribe(IMessageHandler& handler, const char* msgName)
 	{
-		ASSERT_TRUE(m_msgHandlerMap.find(msgName) != m_msgHandlerMap.end());
-
-		m_msgHandlerMap[msgName].erase(std::remove_if(m_msgHandlerMap[msgName].begin(), m_msgHandlerMap[msgName].end(),
-			[&handler](IMessageHandler * i) { return i && (i == &handler); }));
+		Unsubscribe(handler, LookupMessageType(msgName));
 	}
 
 	void MessageSystem::UnsubscribeAll(IMessageHandler& handler)
 	{
-		//Find handler and remove it from the map
-		for (auto& pair : m_msgHandlerMap)
+		//Find handler and remove it from every list
+		for (auto& list : m_msgHandlerLists)
 		{
-			IHandlerList& list = pair.second;
 			auto pos = std::find(list.begin(), list.end(), &handler);
 			if (pos != list.end())
 			{
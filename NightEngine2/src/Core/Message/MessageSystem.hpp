@@ -5,10 +5,8 @@
 */
 #pragma once
 
-#include "Core/Container/Hashmap.hpp"
 #include "Core/Container/Vector.hpp"
-#include "Core/Container/MurmurHash2.hpp"
-#include <string>
+#include <cstdint>
 
 namespace NightEngine
 {
@@ -35,6 +33,7 @@ namespace NightEngine
 		}
 
 		const char* LookupMessageName(MessageType) const;
+		MessageType LookupMessageType(const char*) const;
 		void BroadcastMessage(MessageObject&, BroadcastScope);
 
 		void SendMessage(MessageObject &, IMessageHandler &);
@@ -47,17 +46,12 @@ namespace NightEngine
 
 		void UnsubscribeAll(IMessageHandler &);
 	private:
-		struct StringHash 
-		{
-				std::size_t operator()(const std::string& key) const 
-				{
-					return NightEngine::Container::ConvertToHash(key.c_str(), key.size());
-				}
-		};
+		MessageSystem(void);
+
 		using IHandlerList = Container::Vector<IMessageHandler *>;
-		using MessageMap = Container::HashmapCustom< std::string, IHandlerList, StringHash>;
+		using HandlerLists = Container::Vector<IHandlerList>;
 
-		MessageMap m_msgHandlerMap;
+		HandlerLists m_msgHandlerLists;	//Indexed by MessageType
 	};
 
 } // namespace NightEngine
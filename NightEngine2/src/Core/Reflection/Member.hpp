@@ -6,6 +6,8 @@
 #pragma once
 #include <string>
 
+#include "Core/Container/StringIntern.hpp"
+
 namespace NightEngine
 {
   namespace Reflection
@@ -27,7 +29,7 @@ namespace NightEngine
 			//! @brief Constructor
       Member(const std::string& name, size_t offset, MetaType* metaType
 			, AccessType type = AccessType::PUBLIC, bool shouldSeriazlie = true)
-      : m_name(name), m_offset(offset), m_metaType(metaType)
+      : m_name(name), m_nameID(Container::ToStringID(name)), m_offset(offset), m_metaType(metaType)
 			, m_accessType(type), m_shouldSerialized(shouldSeriazlie){}
 
 			//! @brief Constructor for overriding access type
@@ -40,6 +42,7 @@ namespace NightEngine
 
 			//! @brief Getters
 			const std::string& GetName(void) const{ return m_name; }
+			Container::StringID GetNameID(void) const{ return m_nameID; }
 			size_t             GetOffset(void) const{ return m_offset; }
 			MetaType*          GetMetaType(void) { return m_metaType;}
 			AccessType         GetAccessType(void) const { return m_accessType; }
@@ -51,6 +54,7 @@ namespace NightEngine
 			void LogInfo(void) const;
     private:
       std::string m_name;	//Member name
+      Container::StringID m_nameID;	//Hash of m_name, for lookup
       size_t m_offset;		//Offset within Data
 
       MetaType* m_metaType;			//Type of member
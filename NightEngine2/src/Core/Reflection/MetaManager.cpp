@@ -15,21 +15,94 @@ namespace NightEngine
 		void MetaManager::Register(const Container::String& name, MetaType* metaType)
 		{
 			GetMetaMap()[name] = metaType;
+
+      //A type registered under more than one name keep a single slot
+      auto& metaArray = GetMetaArray();
+      if (metaType->GetTypeIndex() == Container::c_INVALID_DENSE_INDEX)
+      {
+        metaType->SetTypeIndex(static_cast<Container::DenseIndex>(metaArray.size()));
+        metaArray.emplace_back(metaType);
+      }
+
+      Container::StringID nameID = Container::StringIntern::Intern(name);
+      GetMetaIndexMap()[nameID] = metaType->GetTypeIndex();
+		}
+
+		/*!
+		@brief Number the inheritance tree and hash the members of every MetaType
+		*/
+		void MetaManager::Finalize(void)
+		{
+      auto& metaArray = GetMetaArray();
+
+      //Children of each type, types without base are the roots
+      Container::Vector<Container::Vector<Container::DenseIndex>> children(metaArray.size());
+      Container::Vector<Container::DenseIndex> roots;
+      for (auto metaType : metaArray)
+      {
+        metaType->BuildMemberLookup();
+        metaType->SetHierarchyInterval(~Container::U32(0), ~Container::U32(0));
+
+        MetaType* base = metaType->GetBaseClass().m_metaType;
+        if (base == nullptr)
+        {
+          roots.emplace_back(metaType->GetTypeIndex());
+        }
+        else if (base->GetTypeIndex() != Container::c_INVALID_DENSE_INDEX)
+        {
+          children[base->GetTypeIndex()].emplace_back(metaType->GetTypeIndex());
+        }
+        //A base never registered leave the subtree unnumbered, IsDerivedFrom walk it instead
+      }
+
+      //Depth first, enter number in preorder, exit is the last number of the subtree
+      struct Visit
+      {
+        Container::DenseIndex m_typeIndex;
+        size_t                m_nextChild;
+        Container::U32        m_enter;
+      };
+      Container::Vector<Visit> stack;
+      Container::U32 counter = 0;
+      for (auto root : roots)
+      {
+        stack.emplace_back(Visit{ root, 0, counter++ });
+        while (!stack.empty())
+        {
+          Visit& visit = stack.back();
+          auto& childList = children[visit.m_typeIndex];
+          if (visit.m_nextChild < childList.size())
+          {
+            Container::DenseIndex child = childList[visit.m_nextChild++];
+            stack.emplace_back(Visit{ child, 0, counter++ });
+          }
+          else
+          {
+            metaArray[visit.m_typeIndex]->SetHierarchyInterval(visit.m_enter, counter - 1);
+            stack.pop_back();
+          }
+        }
+      }
 		}
 
 		/*!
 		@brief Lookup MetaType from a map
 		*/
-		MetaType* MetaManager::Lookup(const Container::String& name)
+		MetaType* MetaManager::Lookup(Container::StringID nameID)
 		{
-			auto it = GetMetaMap().find(name);
+      auto& indexMap = GetMetaIndexMap();
+			auto it = indexMap.find(nameID);
 
       //Trying to Access unregistered MetaType is an error
-      ASSERT_MSG(it != GetMetaMap().end(), "Trying to lookup unregistered MetaType");
-      ASSERT_MSG(it->second->GetName() != "", "Trying to lookup unregistered MetaType");
+      ASSERT_MSG(it != indexMap.end(), "Trying to lookup unregistered MetaType");
+      if (it == indexMap.end())
+      {
+        return nullptr;
+      }
 
-			//Make sure this return nullptr if not found
-			return it->second;
+      MetaType* metaType = GetMetaArray()[it->second];
+      ASSERT_MSG(metaType->GetName() != "", "Trying to lookup unregistered MetaType");
+			return metaType;
 		}
 
 	}
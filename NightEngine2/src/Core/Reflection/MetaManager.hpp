@@ -8,6 +8,8 @@
 #include "Core/Container/Vector.hpp"
 #include "Core/Container/String.hpp"
 #include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/StringIntern.hpp"
+#include "Core/Macros.hpp"
 
 #include "Core/Reflection/MetaType.hpp"
 #include "Core/Serialization/SerializeFunction.hpp"
@@ -25,10 +27,32 @@ namespace NightEngine
     class MetaManager
     {
       public:
+        //! @brief Sorted by name, for editor listing
         using MetaMap = Container::Map<Container::String, MetaType*>;
+        using MetaArray = Container::Vector<MetaType*>;
+        using MetaIndexMap = Container::StringIDMap<Container::DenseIndex>;
 				
         static void Register(const Container::String& name, MetaType* metaType);
-        static MetaType* Lookup(const Container::String& name);
+
+        //! @brief Lookup by the StringID of the registered name
+        static MetaType* Lookup(Container::StringID nameID);
+
+        //! @brief Build the member lookups and the inheritance intervals once registration is done,
+        // types registered afterward fall back to the slower queries until called again
+        static void Finalize(void);
+
+        //! @brief Lookup by name, hash the string then lookup by StringID
+        static MetaType* Lookup(const char* name) { return Lookup(Container::ToStringID(name)); }
+
+        //! @brief Lookup by name, hash the string then lookup by StringID
+        static MetaType* Lookup(const Container::String& name) { return Lookup(Container::ToStringID(name)); }
+
+        //! @brief Lookup by MetaType::GetTypeIndex()
+        static MetaType* LookupByIndex(Container::DenseIndex typeIndex)
+        {
+          ASSERT_TRUE(typeIndex < GetMetaArray().size());
+          return GetMetaArray()[typeIndex];
+        }
 
         ///////////////////////////////////////////////////////////////
 
@@ -39,6 +63,20 @@ namespace NightEngine
           return map;
         }
 
+        /*! @brief Get global dense array of MetaType, indexed by type index */
+        static MetaArray& GetMetaArray(void)
+        {
+          static MetaArray metaArray;
+          return metaArray;
+        }
+
+        /*! @brief Get global map of name StringID to type index */
+        static MetaIndexMap& GetMetaIndexMap(void)
+        {
+          static MetaIndexMap map;
+          return map;
+        }
+
 				/*! @brief Get global instance of a specific MetaType */
 				template<typename TYPE>
 				static MetaType* GetMetaType(void)
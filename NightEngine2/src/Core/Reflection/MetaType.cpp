@@ -25,6 +25,7 @@ namespace NightEngine
       m_hash = hash;
       m_size = size;
 			m_baseClass = base;
+      m_memberSlots.clear();
 
 			m_serializeFn = serializeFn;
 			m_deserializeFn = deserializeFn;
@@ -58,15 +59,31 @@ namespace NightEngine
 		{
 			m_members.emplace_back(name, offset, memberType
         , accessType, shouldSerialized);
+
+      //Stale until the next BuildMemberLookup
+      m_memberSlots.clear();
 		}
 
-		//! @brief Find member by name in m_members
-		Member* MetaType::FindMember(std::string name)
+    //! @brief Multiplicative hash of the StringID into a slot of the member table
+    static inline U32 GetMemberSlot(StringID nameID, U64 seed, U32 shift)
+    {
+      return static_cast<U32>(((nameID ^ seed) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+		//! @brief Find member by the hash of its name
+		Member* MetaType::FindMember(StringID nameID)
 		{
-			//Linearly looking for member
+      if (!m_memberSlots.empty())
+      {
+        U32 slot = m_memberSlots[GetMemberSlot(nameID, m_memberSeed, m_memberShift)];
+        return slot != 0 && m_members[slot - 1].GetNameID() == nameID ?
+          &m_members[slot - 1] : nullptr;
+      }
+
+			//Not built yet, linearly looking for member
 			for (auto& member : m_members)
 			{
-				if (member.GetName() == name)
+				if (member.GetNameID() == nameID)
 				{
 					return &member;
 				}
@@ -74,12 +91,74 @@ namespace NightEngine
 			return nullptr;
 		}
 
+    //! @brief Look for a seed that put every member in its own slot
+    void MetaType::BuildMemberLookup(void)
+    {
+      m_memberSlots.clear();
+      if (m_members.empty())
+      {
+        return;
+      }
+
+      //Start from the smallest power of two fitting the members, grow when no seed fit
+      U32 bits = 1;
+      while ((size_t(1) << bits) < m_members.size())
+      {
+        ++bits;
+      }
+
+      const U32 c_seedTries = 64;
+      for (;; ++bits)
+      {
+        U32 shift = 64 - bits;
+        for (U32 tries = 0; tries < c_seedTries; ++tries)
+        {
+          U64 seed = tries * 0xD6E8FEB86659FD93ull;
+          m_memberSlots.assign(size_t(1) << bits, 0);
+
+          bool collided = false;
+          for (U32 i = 0; i < m_members.size() && !collided; ++i)
+          {
+            U32& slot = m_memberSlots[GetMemberSlot(m_members[i].GetNameID(), seed, shift)];
+            if (slot == 0)
+            {
+              slot = i + 1;
+            }
+            else
+            {
+              //A name redeclared by a derived class keep the first one, like the linear scan
+              collided = m_members[slot - 1].GetNameID() != m_members[i].GetNameID();
+            }
+          }
+
+          if (!collided)
+          {
+            m_memberSeed = seed;
+            m_memberShift = shift;
+            return;
+          }
+        }
+      }
+    }
+
 		//! @brief Check if this Type is derived from baseClass
 		bool MetaType::IsDerivedFrom(const MetaType* baseClass) const
 		{
-			const MetaType* meta = this;
+      if (baseClass == nullptr)
+      {
+        return false;
+      }
 
-			//Traverse all m_baseClass of this MetaType
+      //baseClass subtree contain every preorder number from its enter to its exit
+      if (m_hierarchyEnter != c_INVALID_HIERARCHY
+        && baseClass->m_hierarchyEnter != c_INVALID_HIERARCHY)
+      {
+        return baseClass->m_hierarchyEnter <= m_hierarchyEnter
+          && m_hierarchyEnter <= baseClass->m_hierarchyExit;
+      }
+
+			//Not numbered yet, traverse all m_baseClass of this MetaType
+			const MetaType* meta = this;
 			while (meta != nullptr)
 			{
 				//Look for baseClass
@@ -7,6 +7,7 @@
 #include <string>
 #include "Core/Container/Vector.hpp"
 #include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/StringIntern.hpp"
 
 #include "Core/Reflection/Member.hpp"
 
@@ -63,6 +64,12 @@ namespace NightEngine
       //! @brief Get Hash value of the name of the type
       Container::U64 							GetHash(void) const { return m_hash; }
 			
+      //! @brief Get dense index of the type in MetaManager, assigned at registration
+      Container::DenseIndex       GetTypeIndex(void) const { return m_typeIndex; }
+
+      //! @brief Set by MetaManager::Register
+      void                        SetTypeIndex(Container::DenseIndex index) { m_typeIndex = index; }
+
       //! @brief Get Size of the type
       size_t 											GetSize(void) const{ return m_size; }
 			
@@ -73,16 +80,27 @@ namespace NightEngine
       bool ShouldSerialized(void) { return m_shouldSerialized; }
 
       //! @brief Find the member by name
-			Member* FindMember(std::string name);
+			Member* FindMember(const std::string& name) { return FindMember(Container::ToStringID(name)); }
+
+      //! @brief Find the member by the StringID of its name, STRING_ID("m_name") hash at compile time
+			Member* FindMember(Container::StringID nameID);
+
+      //! @brief Build the perfect hash of the member names, done by MetaManager::Finalize
+      void BuildMemberLookup(void);
 
       //! @brief Check if this type is a subclass of baseClass or not
 			bool IsDerivedFrom(const MetaType* baseClass) const;
 
+      //! @brief Set by MetaManager::Finalize, preorder number of this type in the
+      // inheritance tree and the last preorder number of its subtree
+      void SetHierarchyInterval(Container::U32 enter, Container::U32 exit) { m_hierarchyEnter = enter; m_hierarchyExit = exit; }
+
       //! @brief Check if this type has a base class or not
 			bool HasBaseClass(void) const { return m_baseClass.m_metaType != nullptr; }
 			
       //! @brief Get the baseclass of this type
       BaseClass& GetBaseClass(void) { return m_baseClass; }
+      const BaseClass& GetBaseClass(void) const { return m_baseClass; }
 
       //! @brief Debug log the information of this type
 			void LogInfo(void) const;
@@ -96,10 +114,22 @@ namespace NightEngine
       std::string m_name;
       Container::U64 m_hash;	//Hash of the m_name
       size_t m_size;
+      Container::DenseIndex m_typeIndex = Container::c_INVALID_DENSE_INDEX;
 
       BaseClass m_baseClass{};	//Not support multiple inheritance
       Container::Vector<Member> m_members;
 
+      //Perfect hash of the member StringIDs, slot hold member index + 1, 0 is empty.
+      // Empty until BuildMemberLookup, FindMember scan m_members meanwhile
+      Container::Vector<Container::U32> m_memberSlots;
+      Container::U64 m_memberSeed = 0;
+      Container::U32 m_memberShift = 63;
+
+      //Interval in the inheritance tree, invalid until MetaManager::Finalize
+      static constexpr Container::U32 c_INVALID_HIERARCHY = ~Container::U32(0);
+      Container::U32 m_hierarchyEnter = c_INVALID_HIERARCHY;
+      Container::U32 m_hierarchyExit = c_INVALID_HIERARCHY;
+
       bool m_shouldSerialized = true;
 			SerializeFn m_serializeFn = nullptr;
 			DeserializeFn m_deserializeFn = nullptr;
@@ -340,6 +340,9 @@ namespace NightEngine
 
       //Invoke all the Reflection initialization functions
       ReflectionInitFunctions::InvokeAll();
+
+      //Everything is registered, build the lookup tables
+      MetaManager::Finalize();
       //LOGINFO_METATYPE(ComponentLogic);
       //LOGINFO_METATYPE(Transform);
       //LOGINFO_METATYPE(Light);
@@ -148,7 +148,7 @@ ReflectionManager::RegisterType<RawType<TYPE>>(#TYPE, MURMURHASH2(TYPE)\
 //! @brief Register reflection init function to the global class to be called at init time, must be in .cpp file
 #define INIT_REFLECTION_AND_FACTORY(TYPE, RESERVE_INT, EXPAND_RATE) \
     FACTORY_FUNC_IMPLEMENTATION(TYPE); \
-    static void RegisterFactory##TYPE(){ FACTORY_REGISTER_TYPE(TYPE, RESERVE_INT, EXPAND_RATE); }\
+    static void RegisterFactory##TYPE(){ FACTORY_REGISTER_TYPE_WITHPARAM(TYPE, RESERVE_INT, EXPAND_RATE); }\
     static NightEngine::Reflection::ReflectionInitFunctionsRegisterer<TYPE> g_registerer##TYPE{ RegisterFactory##TYPE }; \
 //************************************************************
 // Getter Macros
@@ -163,6 +163,12 @@ ReflectionManager::RegisterType<RawType<TYPE>>(#TYPE, MURMURHASH2(TYPE)\
 //! @brief Get MetaType by string
 #define METATYPE_FROM_STRING(STR) (ReflectionManager::Lookup(STR))
 
+//! @brief Get MetaType by StringID of its name, see STRING_ID()
+#define METATYPE_FROM_ID(ID) (ReflectionManager::Lookup(static_cast<NightEngine::Container::StringID>(ID)))
+
+//! @brief Get MetaType by its dense type index
+#define METATYPE_FROM_INDEX(INDEX) (ReflectionManager::LookupByIndex(INDEX))
+
 //************************************************************
 // Log Utility
 //************************************************************
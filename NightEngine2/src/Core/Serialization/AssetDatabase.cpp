@@ -0,0 +1,889 @@
+/*!
+  @file AssetDatabase.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of AssetDatabase
+*/
+#include "Core/Serialization/AssetDatabase.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/FileSystem.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Core/Utility/JobSystem.hpp"
+
+#include "taocpp_json/include/tao/json/stream.hpp"
+#include "taocpp_json/include/tao/json/from_string.hpp"
+#include "taocpp_json/include/tao/json/as.hpp"
+#include "taocpp_json/include/tao/json/value.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine
+{
+  static const unsigned c_DATABASE_VERSION = 1;
+
+  //Bump when the key layout change
+  static const U64 c_COOK_KEY_SEED = 0x4B4F4F43;  //"COOK"
+
+  static std::string ToLower(std::string str)
+  {
+    for (auto& c : str)
+    {
+      c = static_cast<char>(tolower(c));
+    }
+    return str;
+  }
+
+  static std::string ToHex(U64 value)
+  {
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(value));
+    return hex;
+  }
+
+  static bool FromHex(const std::string& str, size_t offset, U64& value)
+  {
+    value = 0;
+    for (size_t i = offset; i < offset + 16; ++i)
+    {
+      char c = i < str.size() ? static_cast<char>(tolower(str[i])) : '\0';
+      if (c >= '0' && c <= '9')
+      {
+        value = (value << 4) | static_cast<U64>(c - '0');
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+        value = (value << 4) | static_cast<U64>(c - 'a' + 10);
+      }
+      else
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  AssetType GetAssetType(const std::string& path)
+  {
+    auto dotIndex = path.find_last_of('.');
+    if (dotIndex == std::string::npos)
+    {
+      return AssetType::UNKNOWN;
+    }
+
+    std::string ext = ToLower(path.substr(dotIndex + 1));
+    if (ext == "vert" || ext == "frag" || ext == "geom" || ext == "comp" || ext == "glsl")
+    {
+      return AssetType::SHADER;
+    }
+    if (ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "tga" || ext == "bmp"
+      || ext == "hdr" || ext == "psd")
+    {
+      return AssetType::TEXTURE;
+    }
+    if (ext == "mat")
+    {
+      return AssetType::MATERIAL;
+    }
+    if (ext == "obj" || ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae"
+      || ext == "blend" || ext == "3ds")
+    {
+      return AssetType::MODEL;
+    }
+    if (ext == "nscene")
+    {
+      return AssetType::SCENE;
+    }
+    return AssetType::UNKNOWN;
+  }
+
+  bool CookJsonReferences(const std::string& path, const FileView& source
+    , CookOutput& output)
+  {
+    tao::json::value root;
+    try
+    {
+      root = tao::json::from_string(source.GetData(), source.GetSize());
+    }
+    catch (const std::exception& e)
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "AssetDatabase: can't parse references of [" << path << "], " << e.what() << '\n';
+      return false;
+    }
+
+    //Every string that look like an asset path, a file naming itself isn't a dependency
+    std::vector<const tao::json::value*> open{ &root };
+    while (!open.empty())
+    {
+      const tao::json::value* value = open.back();
+      open.pop_back();
+      if (value->is_string())
+      {
+        const std::string& str = value->get_string();
+        if (str.find('/') != std::string::npos && str != path
+          && GetAssetType(str) != AssetType::UNKNOWN)
+        {
+          output.m_references.emplace_back(str);
+        }
+      }
+      else if (value->is_array())
+      {
+        for (auto& element : value->get_array())
+        {
+          open.emplace_back(&element);
+        }
+      }
+      else if (value->is_object())
+      {
+        for (auto& pair : value->get_object())
+        {
+          open.emplace_back(&pair.second);
+        }
+      }
+    }
+    return true;
+  }
+
+  //*****************************************************
+  // AssetGuid
+  //*****************************************************
+  std::string AssetGuid::ToString(void) const
+  {
+    return ToHex(m_high) + ToHex(m_low);
+  }
+
+  bool AssetGuid::FromString(const std::string& str, AssetGuid& guid)
+  {
+    AssetGuid result;
+    if (str.size() != 32 || !FromHex(str, 0, result.m_high)
+      || !FromHex(str, 16, result.m_low))
+    {
+      return false;
+    }
+
+    guid = result;
+    return true;
+  }
+
+  AssetGuid AssetGuid::Generate(void)
+  {
+    static std::mutex s_mutex;
+    static std::mt19937_64 s_random{ (static_cast<U64>(std::random_device{}()) << 32)
+      ^ static_cast<U64>(std::random_device{}()) };
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    AssetGuid guid;
+    while (!guid.IsValid())
+    {
+      guid.m_high = s_random();
+      guid.m_low = s_random();
+    }
+    return guid;
+  }
+
+  //*****************************************************
+  // AssetDatabase
+  //*****************************************************
+  AssetDatabase::AssetDatabase(std::string assetRoot, std::string cacheRoot)
+    : m_assetRoot(std::move(assetRoot)), m_cacheRoot(std::move(cacheRoot))
+  {
+    for (std::string* root : { &m_assetRoot, &m_cacheRoot })
+    {
+      if (!root->empty() && root->back() != '/')
+      {
+        *root += '/';
+      }
+    }
+  }
+
+  bool AssetDatabase::Load(const std::string& filePath)
+  {
+    std::ifstream file(filePath, std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+      return false;
+    }
+    std::string content{ std::istreambuf_iterator<char>(file)
+      , std::istreambuf_iterator<char>() };
+
+    std::unordered_map<std::string, AssetRecord> records;
+    try
+    {
+      tao::json::value root = tao::json::from_string(content);
+      const tao::json::value* version = root.find("version");
+      const tao::json::value* assets = root.find("assets");
+      if (version == nullptr || version->as<unsigned>() != c_DATABASE_VERSION
+        || assets == nullptr)
+      {
+        return false;
+      }
+
+      auto readStrings = [](const tao::json::value& value, const char* key
+        , std::vector<std::string>& output)
+      {
+        const tao::json::value* array = value.find(key);
+        if (array != nullptr)
+        {
+          for (auto& str : array->get_array())
+          {
+            output.emplace_back(str.get_string());
+          }
+        }
+      };
+
+      for (auto& value : assets->get_array())
+      {
+        AssetRecord record;
+        record.m_path = value.find("path")->get_string();
+        record.m_type = GetAssetType(record.m_path);
+        if (!AssetGuid::FromString(value.find("guid")->get_string(), record.m_guid)
+          || !FromHex(value.find("hash")->get_string(), 0, record.m_sourceHash))
+        {
+          continue;
+        }
+        record.m_sourceSize = value.find("size")->as<U64>();
+        record.m_sourceTime = value.find("time")->as<I64>();
+        readStrings(value, "inputs", record.m_inputs);
+        readStrings(value, "references", record.m_references);
+
+        std::string path = record.m_path;
+        records.emplace(std::move(path), std::move(record));
+      }
+    }
+    catch (const std::exception& e)
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "AssetDatabase: can't parse [" << filePath << "], " << e.what() << '\n';
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_records = std::move(records);
+    m_graph.Clear();
+    for (auto& pair : m_records)
+    {
+      for (auto& dependency : pair.second.m_inputs)
+      {
+        m_graph.AddDependency(pair.first, dependency);
+      }
+      for (auto& dependency : pair.second.m_references)
+      {
+        m_graph.AddDependency(pair.first, dependency);
+      }
+    }
+    return true;
+  }
+
+  bool AssetDatabase::Save(const std::string& filePath) const
+  {
+    tao::json::value assets = tao::json::empty_array;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      //Sorted by path, the file stay diffable under version control
+      std::vector<const AssetRecord*> records;
+      records.reserve(m_records.size());
+      for (auto& pair : m_records)
+      {
+        records.emplace_back(&pair.second);
+      }
+      std::sort(records.begin(), records.end()
+        , [](const AssetRecord* lhs, const AssetRecord* rhs) { return lhs->m_path < rhs->m_path; });
+
+      for (auto record : records)
+      {
+        tao::json::value inputs = tao::json::empty_array;
+        for (auto& input : record->m_inputs)
+        {
+          inputs.push_back(input);
+        }
+        tao::json::value references = tao::json::empty_array;
+        for (auto& reference : record->m_references)
+        {
+          references.push_back(reference);
+        }
+
+        assets.push_back(tao::json::value{
+          { "guid", record->m_guid.ToString() },
+          { "path", record->m_path },
+          { "hash", ToHex(record->m_sourceHash) },
+          { "size", record->m_sourceSize },
+          { "time", record->m_sourceTime },
+          { "inputs", std::move(inputs) },
+          { "references", std::move(references) } });
+      }
+    }
+
+    std::string tempPath = filePath + ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file.is_open())
+      {
+        return false;
+      }
+      tao::json::value root{ { "version", c_DATABASE_VERSION }, { "assets", std::move(assets) } };
+      tao::json::to_stream(file, root, 2);
+      if (!file.good())
+      {
+        return false;
+      }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, filePath, error);
+    return !error;
+  }
+
+  void AssetDatabase::RegisterCooker(AssetType type, U64 settingsHash, CookFN cookFn)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cookers[static_cast<unsigned>(type)] = Cooker{ settingsHash, std::move(cookFn) };
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  size_t AssetDatabase::Refresh(void)
+  {
+    struct FileState
+    {
+      std::string m_path;
+      U64         m_size = 0;
+      I64         m_time = 0;
+      U64         m_hash = 0;
+      bool        m_hashed = false;
+    };
+
+    //Walk without the lock, loads can keep going
+    std::vector<FileState> files;
+    std::error_code error;
+    std::filesystem::path root{ m_assetRoot };
+    std::filesystem::path cacheRoot = std::filesystem::weakly_canonical(m_cacheRoot, error);
+    for (auto it = std::filesystem::recursive_directory_iterator(root, error);
+      it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+      if (error)
+      {
+        break;
+      }
+
+      if (it->is_directory(error))
+      {
+        if (std::filesystem::weakly_canonical(it->path(), error) == cacheRoot)
+        {
+          it.disable_recursion_pending();
+        }
+        continue;
+      }
+
+      if (it->is_regular_file(error))
+      {
+        FileState state;
+        state.m_path = it->path().lexically_relative(root).generic_string();
+        state.m_size = static_cast<U64>(it->file_size(error));
+        state.m_time = static_cast<I64>(it->last_write_time(error).time_since_epoch().count());
+        files.emplace_back(std::move(state));
+      }
+    }
+
+    //Asset files, and the side files a cooker read last time
+    std::vector<FileState*> modified;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto& file : files)
+      {
+        auto it = m_records.find(file.m_path);
+        if (it == m_records.end() ? GetAssetType(file.m_path) != AssetType::UNKNOWN
+          : it->second.m_sourceSize != file.m_size || it->second.m_sourceTime != file.m_time)
+        {
+          modified.emplace_back(&file);
+        }
+      }
+    }
+
+    JobSystem::ParallelFor(modified.size(), 8, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        modified[i]->m_hashed = HashFile(modified[i]->m_path, modified[i]->m_hash);
+      }
+    });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    //Deleted files give their guid to a new file with the same content, a rename
+    std::unordered_set<std::string> existing;
+    for (auto& file : files)
+    {
+      existing.insert(file.m_path);
+    }
+    std::unordered_multimap<U64, AssetGuid> removedGuids;
+    for (auto it = m_records.begin(); it != m_records.end();)
+    {
+      if (existing.find(it->first) == existing.end())
+      {
+        removedGuids.emplace(it->second.m_sourceHash, it->second.m_guid);
+        m_graph.ClearDependencies(it->first);
+        it = m_records.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    size_t changedCount = 0;
+    for (auto file : modified)
+    {
+      if (!file->m_hashed)
+      {
+        continue;
+      }
+
+      auto it = m_records.find(file->m_path);
+      if (it == m_records.end())
+      {
+        AssetRecord record;
+        record.m_path = file->m_path;
+        record.m_type = GetAssetType(file->m_path);
+
+        auto removed = removedGuids.find(file->m_hash);
+        if (removed != removedGuids.end())
+        {
+          record.m_guid = removed->second;
+          removedGuids.erase(removed);
+        }
+        else
+        {
+          record.m_guid = AssetGuid::Generate();
+        }
+        it = m_records.emplace(file->m_path, std::move(record)).first;
+        ++changedCount;
+      }
+      else if (it->second.m_sourceHash != file->m_hash)
+      {
+        ++changedCount;
+      }
+
+      //Only touched files just get the new time
+      it->second.m_sourceHash = file->m_hash;
+      it->second.m_sourceSize = file->m_size;
+      it->second.m_sourceTime = file->m_time;
+    }
+
+    return changedCount + removedGuids.size();
+  }
+
+  bool AssetDatabase::UpdateRecord(const std::string& path)
+  {
+    std::string virtualPath = ToRecordPath(path);
+    U64 size = 0, hash = 0;
+    I64 time = 0;
+    if (!StatFile(virtualPath, size, time) || !HashFile(virtualPath, hash))
+    {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    AssetRecord& record = m_records[virtualPath];
+    if (!record.m_guid.IsValid())
+    {
+      record.m_guid = AssetGuid::Generate();
+      record.m_path = virtualPath;
+      record.m_type = GetAssetType(virtualPath);
+    }
+    record.m_sourceHash = hash;
+    record.m_sourceSize = size;
+    record.m_sourceTime = time;
+    return true;
+  }
+
+  bool AssetDatabase::GetRecord(const std::string& path, AssetRecord& record) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_records.find(ToRecordPath(path));
+    if (it == m_records.end())
+    {
+      return false;
+    }
+    record = it->second;
+    return true;
+  }
+
+  std::string AssetDatabase::GetPath(const AssetGuid& guid) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& pair : m_records)
+    {
+      if (pair.second.m_guid == guid)
+      {
+        return pair.first;
+      }
+    }
+    return std::string();
+  }
+
+  void AssetDatabase::GetDependents(const std::string& path
+    , std::vector<std::string>& output) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_graph.GetAffected({ ToRecordPath(path) }, output);
+
+    //The changed file itself come first
+    output.erase(output.begin());
+  }
+
+  size_t AssetDatabase::GetRecordCount(void) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records.size();
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  U64 AssetDatabase::GetCookKey(const std::string& path) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_records.find(ToRecordPath(path));
+    const Cooker* cooker = it != m_records.end() ? FindCooker(it->second.m_type) : nullptr;
+    return cooker != nullptr ? MakeCookKey(it->second, *cooker) : 0;
+  }
+
+  FileView AssetDatabase::LoadCooked(const std::string& path)
+  {
+    std::string virtualPath = ToRecordPath(path);
+    Cooker cooker;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const Cooker* found = FindCooker(GetAssetType(virtualPath));
+      if (found == nullptr)
+      {
+        return FileView();
+      }
+      cooker = *found;
+    }
+
+    //Not seen by Refresh, e.g. created after it
+    AssetRecord record;
+    if (!GetRecord(virtualPath, record) && !UpdateRecord(virtualPath))
+    {
+      return FileView();
+    }
+
+    U64 key = GetCookKey(virtualPath);
+    FileView cached = ReadCache(key);
+    if (cached.IsValid())
+    {
+      return cached;
+    }
+
+    //Miss, cook it now and keep it for the next run
+    auto output = std::make_shared<CookOutput>();
+    if (!RunCooker(virtualPath, cooker, *output))
+    {
+      return FileView();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      AssetRecord* found = FindRecord(virtualPath);
+      if (found == nullptr)
+      {
+        return FileView();
+      }
+      SetDependencies(*found, *output);
+      key = MakeCookKey(*found, cooker);
+    }
+    WriteCache(key, output->m_data);
+
+    const char* data = output->m_data.empty() ? "" : output->m_data.data();
+    size_t size = output->m_data.size();
+    return FileView(data, size, std::move(output));
+  }
+
+  size_t AssetDatabase::Cook(void)
+  {
+    struct CookJob
+    {
+      std::string m_path;
+      Cooker      m_cooker;
+    };
+
+    std::vector<CookJob> jobs;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto& pair : m_records)
+      {
+        const Cooker* cooker = FindCooker(pair.second.m_type);
+        std::error_code error;
+        if (cooker != nullptr && !std::filesystem::exists(m_cacheRoot
+          + ToHex(MakeCookKey(pair.second, *cooker)) + ".bin", error))
+        {
+          jobs.emplace_back(CookJob{ pair.first, *cooker });
+        }
+      }
+    }
+
+    std::atomic<size_t> cookedCount{ 0 };
+    JobSystem::ParallelFor(jobs.size(), 1, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        CookOutput output;
+        if (!RunCooker(jobs[i].m_path, jobs[i].m_cooker, output))
+        {
+          continue;
+        }
+
+        U64 key = 0;
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          AssetRecord* record = FindRecord(jobs[i].m_path);
+          if (record == nullptr)
+          {
+            continue;
+          }
+          SetDependencies(*record, output);
+          key = MakeCookKey(*record, jobs[i].m_cooker);
+        }
+
+        if (WriteCache(key, output.m_data))
+        {
+          ++cookedCount;
+        }
+      }
+    });
+
+    Debug::Log << Logger::MessageType::INFO << "AssetDatabase: cooked "
+      << cookedCount.load() << " of " << jobs.size() << " out of date assets\n";
+    return cookedCount.load();
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  FileView AssetDatabase::ReadCache(U64 key) const
+  {
+    auto file = std::make_shared<MappedFile>();
+    if (key == 0 || !file->Open(m_cacheRoot + ToHex(key) + ".bin"))
+    {
+      return FileView();
+    }
+
+    const char* data = file->GetData();
+    size_t size = file->GetSize();
+    return FileView(data, size, std::move(file));
+  }
+
+  bool AssetDatabase::WriteCache(U64 key, const std::vector<char>& data) const
+  {
+    std::error_code error;
+    std::filesystem::create_directories(m_cacheRoot, error);
+
+    //Never leave a half written file under the final name, a crash would poison the cache
+    std::string path = m_cacheRoot + ToHex(key) + ".bin";
+    std::string tempPath = path + "." + ToHex(std::hash<std::thread::id>{}(
+      std::this_thread::get_id())) + ".tmp";
+    {
+      std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(data.data(), data.size());
+      if (!file.good())
+      {
+        file.close();
+        std::filesystem::remove(tempPath, error);
+        return false;
+      }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+      std::filesystem::remove(tempPath, error);
+      return false;
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  std::string AssetDatabase::ToRecordPath(const std::string& path) const
+  {
+    //Absolute path from the file watcher
+    std::filesystem::path filePath{ path };
+    if (filePath.is_absolute())
+    {
+      std::error_code error;
+      std::filesystem::path relative = filePath.lexically_relative(
+        std::filesystem::weakly_canonical(m_assetRoot, error));
+      if (!relative.empty() && *relative.begin() != "..")
+      {
+        return relative.generic_string();
+      }
+    }
+
+    //"Models/sponza/../Textures/a.png" from a loader joining a relative reference
+    std::string virtualPath = VirtualFileSystem::ToVirtualPath(path);
+    if (virtualPath.find("..") != std::string::npos)
+    {
+      virtualPath = std::filesystem::path(virtualPath).lexically_normal().generic_string();
+    }
+    return virtualPath;
+  }
+
+  AssetRecord* AssetDatabase::FindRecord(const std::string& path)
+  {
+    auto it = m_records.find(path);
+    return it != m_records.end() ? &(it->second) : nullptr;
+  }
+
+  const AssetDatabase::Cooker* AssetDatabase::FindCooker(AssetType type) const
+  {
+    auto it = m_cookers.find(static_cast<unsigned>(type));
+    return it != m_cookers.end() ? &(it->second) : nullptr;
+  }
+
+  U64 AssetDatabase::MakeCookKey(const AssetRecord& record, const Cooker& cooker) const
+  {
+    //Content addressed, the path isn't part of it. Renamed or copied files hit the cache.
+    U64 key[2] = { cooker.m_settingsHash, record.m_sourceHash };
+    U64 hash = Murmur2A64_Hash(reinterpret_cast<const char*>(key), sizeof(key), c_COOK_KEY_SEED);
+    for (auto& input : record.m_inputs)
+    {
+      auto it = m_records.find(input);
+      U64 inputHash = it != m_records.end() ? it->second.m_sourceHash : 0;
+      hash = Murmur2A64_Hash(reinterpret_cast<const char*>(&inputHash), sizeof(inputHash), hash);
+    }
+
+    //0 means no key
+    return hash != 0 ? hash : 1;
+  }
+
+  bool AssetDatabase::StatFile(const std::string& path, U64& size, I64& time) const
+  {
+    std::error_code error;
+    std::filesystem::path filePath{ m_assetRoot + path };
+    size = static_cast<U64>(std::filesystem::file_size(filePath, error));
+    if (!error)
+    {
+      time = static_cast<I64>(std::filesystem::last_write_time(filePath, error)
+        .time_since_epoch().count());
+      return !error;
+    }
+
+    //Only in a pak, the content never change under us
+    FileView view = VirtualFileSystem::Read(path);
+    size = view.GetSize();
+    time = 0;
+    return view.IsValid();
+  }
+
+  bool AssetDatabase::HashFile(const std::string& path, U64& hash) const
+  {
+    MappedFile file;
+    if (file.Open(m_assetRoot + path))
+    {
+      hash = ConvertToHash(file.GetData(), file.GetSize());
+      return true;
+    }
+
+    FileView view = VirtualFileSystem::Read(path);
+    hash = view.IsValid() ? ConvertToHash(view.GetData(), view.GetSize()) : 0;
+    return view.IsValid();
+  }
+
+  void AssetDatabase::SetDependencies(AssetRecord& record, CookOutput& output)
+  {
+    auto normalize = [this](std::vector<std::string>& paths)
+    {
+      for (auto& path : paths)
+      {
+        path = ToRecordPath(path);
+      }
+      std::sort(paths.begin(), paths.end());
+      paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    };
+    normalize(output.m_inputs);
+    normalize(output.m_references);
+    output.m_inputs.erase(std::remove(output.m_inputs.begin(), output.m_inputs.end()
+      , record.m_path), output.m_inputs.end());
+
+    record.m_inputs = output.m_inputs;
+    record.m_references = output.m_references;
+
+    m_graph.ClearDependencies(record.m_path);
+    for (auto& dependency : record.m_inputs)
+    {
+      m_graph.AddDependency(record.m_path, dependency);
+    }
+    for (auto& dependency : record.m_references)
+    {
+      m_graph.AddDependency(record.m_path, dependency);
+    }
+
+    //Inputs are part of the key, their hash has to be known
+    for (auto& input : record.m_inputs)
+    {
+      if (m_records.find(input) != m_records.end())
+      {
+        continue;
+      }
+
+      U64 size = 0, hash = 0;
+      I64 time = 0;
+      if (StatFile(input, size, time) && HashFile(input, hash))
+      {
+        AssetRecord& inputRecord = m_records[input];
+        inputRecord.m_guid = AssetGuid::Generate();
+        inputRecord.m_path = input;
+        inputRecord.m_type = GetAssetType(input);
+        inputRecord.m_sourceHash = hash;
+        inputRecord.m_sourceSize = size;
+        inputRecord.m_sourceTime = time;
+      }
+    }
+  }
+
+  bool AssetDatabase::RunCooker(const std::string& path, const Cooker& cooker
+    , CookOutput& output) const
+  {
+    //Loose file first, the database track the asset directory
+    auto file = std::make_shared<MappedFile>();
+    FileView source;
+    if (file->Open(m_assetRoot + path))
+    {
+      const char* data = file->GetData();
+      size_t size = file->GetSize();
+      source = FileView(data, size, std::move(file));
+    }
+    else
+    {
+      source = VirtualFileSystem::Read(path);
+    }
+
+    if (!source.IsValid() || !cooker.m_cookFn(path, source, output))
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "AssetDatabase: failed to cook [" << path << "]\n";
+      return false;
+    }
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  AssetDatabase& GetAssetDatabase(void)
+  {
+    static AssetDatabase database{ PROJECT_DIR_SOURCE_ASSETS
+      , FileSystem::GetFilePath("", FileSystem::DirectoryType::AssetCache) };
+    return database;
+  }
+}
@@ -0,0 +1,171 @@
+/*!
+  @file AssetDatabase.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of AssetDatabase
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Serialization/MappedFile.hpp"
+#include "Core/Serialization/AssetDependencyGraph.hpp"
+
+// Standard Headers
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace NightEngine
+{
+  enum class AssetType : unsigned
+  {
+    UNKNOWN = 0,
+    SHADER,
+    TEXTURE,
+    MATERIAL,
+    MODEL,
+    SCENE
+  };
+
+  //! @brief Asset type from the file extension
+  AssetType GetAssetType(const std::string& path);
+
+  //! @brief 128 bits id given to an asset once, kept when the file is renamed
+  struct AssetGuid
+  {
+    Container::U64 m_high = 0;
+    Container::U64 m_low = 0;
+
+    //! @brief Check if the guid was assigned
+    bool IsValid(void) const { return m_high != 0 || m_low != 0; }
+
+    //! @brief 32 lower case hex digits
+    std::string ToString(void) const;
+
+    //! @brief Parse the 32 hex digits, false if str isn't a guid
+    static bool FromString(const std::string& str, AssetGuid& guid);
+
+    //! @brief New random guid
+    static AssetGuid Generate(void);
+
+    bool operator==(const AssetGuid& rhs) const { return m_high == rhs.m_high && m_low == rhs.m_low; }
+    bool operator!=(const AssetGuid& rhs) const { return !(*this == rhs); }
+  };
+
+  //! @brief What the database know about one source file
+  struct AssetRecord
+  {
+    AssetGuid   m_guid;
+    std::string m_path;               //Virtual path, relative to the asset root
+    AssetType   m_type = AssetType::UNKNOWN;
+    Container::U64 m_sourceHash = 0;
+    Container::U64 m_sourceSize = 0;
+    Container::I64 m_sourceTime = 0;  //Only to skip hashing unchanged files
+
+    std::vector<std::string> m_inputs;      //Other files read by the cooker, part of the cook key
+    std::vector<std::string> m_references;  //Assets used at runtime, e.g. model -> textures
+  };
+
+  //! @brief What a cooker produce from a source file
+  struct CookOutput
+  {
+    std::vector<char>        m_data;
+    std::vector<std::string> m_inputs;
+    std::vector<std::string> m_references;
+  };
+
+  //! @brief Turn the source bytes of path into the runtime data, thread safe
+  using CookFN = std::function<bool(const std::string& path, const FileView& source
+    , CookOutput& output)>;
+
+  //! @brief Cooker for json assets (materials, scenes) that only record the
+  // asset paths they reference, nothing is cooked
+  bool CookJsonReferences(const std::string& path, const FileView& source
+    , CookOutput& output);
+
+  //! @brief Source assets with a stable guid, their content hash and dependencies,
+  // and a local cache of cooked outputs addressed by the hash of everything they
+  // were built from (sources, inputs, cooker settings).
+  class AssetDatabase
+  {
+    public:
+      //! @brief Constructor, sources are under assetRoot, cooked files go in cacheRoot
+      AssetDatabase(std::string assetRoot, std::string cacheRoot);
+
+      //! @brief Load the records, false if the file is missing or broken
+      bool Load(const std::string& filePath);
+
+      //! @brief Save the records
+      bool Save(const std::string& filePath) const;
+
+      //! @brief Cooker for every asset of type. settingsHash is the cooker's version
+      // and import options, changing it invalidate every cooked output of the type.
+      void RegisterCooker(AssetType type, Container::U64 settingsHash, CookFN cookFn);
+
+      //! @brief Scan the asset root, hash new and modified files, match renamed files
+      // to their old guid and forget deleted ones. Return the number of changed files.
+      size_t Refresh(void);
+
+      //! @brief Stat and rehash one file, true if it exists
+      bool UpdateRecord(const std::string& path);
+
+      //! @brief Copy of the record of path, false if unknown
+      bool GetRecord(const std::string& path, AssetRecord& record) const;
+
+      //! @brief Path of the asset with guid, empty if unknown
+      std::string GetPath(const AssetGuid& guid) const;
+
+      //! @brief Every asset that transitively depend on path
+      void GetDependents(const std::string& path, std::vector<std::string>& output) const;
+
+      //! @brief Key of the cooked output of path, 0 if it has no record or cooker
+      Container::U64 GetCookKey(const std::string& path) const;
+
+      //! @brief Cooked output of path from the cache, cooked and stored first on a miss.
+      // Invalid view if path has no cooker or the cooker failed.
+      FileView LoadCooked(const std::string& path);
+
+      //! @brief Cook every asset whose output isn't in the cache, in parallel.
+      // Return the number of assets cooked.
+      size_t Cook(void);
+
+      //! @brief Number of known source files
+      size_t GetRecordCount(void) const;
+
+      //! @brief Cached file of key
+      FileView ReadCache(Container::U64 key) const;
+
+      //! @brief Store data under key, written to a temporary file then renamed
+      bool WriteCache(Container::U64 key, const std::vector<char>& data) const;
+    private:
+      struct Cooker
+      {
+        Container::U64 m_settingsHash = 0;
+        CookFN         m_cookFn;
+      };
+
+      std::string ToRecordPath(const std::string& path) const;
+      AssetRecord* FindRecord(const std::string& path);
+      const Cooker* FindCooker(AssetType type) const;
+      Container::U64 MakeCookKey(const AssetRecord& record, const Cooker& cooker) const;
+      bool StatFile(const std::string& path, Container::U64& size, Container::I64& time) const;
+      bool HashFile(const std::string& path, Container::U64& hash) const;
+      void SetDependencies(AssetRecord& record, CookOutput& output);
+      bool RunCooker(const std::string& path, const Cooker& cooker, CookOutput& output) const;
+
+      std::string m_assetRoot;
+      std::string m_cacheRoot;
+
+      std::unordered_map<std::string, AssetRecord> m_records;
+      std::unordered_map<unsigned, Cooker>         m_cookers;
+      AssetDependencyGraph                         m_graph;
+      mutable std::mutex                           m_mutex;
+  };
+
+  //! @brief Records of the engine's database, in the asset directory under version control
+  constexpr const char* c_ASSET_DATABASE_FILE = "AssetDatabase.json";
+
+  //! @brief Database of the engine's asset directory
+  AssetDatabase& GetAssetDatabase(void);
+}
@@ -0,0 +1,91 @@
+/*!
+  @file AssetDependencyGraph.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of AssetDependencyGraph
+*/
+#include "Core/Serialization/AssetDependencyGraph.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+namespace NightEngine
+{
+  void AssetDependencyGraph::AddDependency(const std::string& dependent
+    , const std::string& dependency)
+  {
+    if (dependent == dependency)
+    {
+      return;
+    }
+
+    m_nodes[dependent].m_dependencies.insert(dependency);
+    m_nodes[dependency].m_dependents.insert(dependent);
+  }
+
+  void AssetDependencyGraph::ClearDependencies(const std::string& dependent)
+  {
+    auto it = m_nodes.find(dependent);
+    if (it == m_nodes.end())
+    {
+      return;
+    }
+
+    for (auto& dependency : it->second.m_dependencies)
+    {
+      auto depIt = m_nodes.find(dependency);
+      if (depIt != m_nodes.end())
+      {
+        depIt->second.m_dependents.erase(dependent);
+      }
+    }
+    it->second.m_dependencies.clear();
+  }
+
+  void AssetDependencyGraph::GetDependencies(const std::string& dependent
+    , std::vector<std::string>& output) const
+  {
+    output.clear();
+    auto it = m_nodes.find(dependent);
+    if (it != m_nodes.end())
+    {
+      output.assign(it->second.m_dependencies.begin(), it->second.m_dependencies.end());
+      std::sort(output.begin(), output.end());
+    }
+  }
+
+  void AssetDependencyGraph::GetAffected(const std::vector<std::string>& changedFiles
+    , std::vector<std::string>& output) const
+  {
+    output.clear();
+    std::unordered_set<std::string> visited;
+    for (auto& file : changedFiles)
+    {
+      if (visited.insert(file).second)
+      {
+        output.emplace_back(file);
+      }
+    }
+
+    //Breadth first, output grow while it is traversed
+    for (size_t i = 0; i < output.size(); ++i)
+    {
+      auto it = m_nodes.find(output[i]);
+      if (it == m_nodes.end())
+      {
+        continue;
+      }
+
+      //Sorted so the reload order doesn't depend on the hashing
+      std::vector<std::string> dependents(it->second.m_dependents.begin()
+        , it->second.m_dependents.end());
+      std::sort(dependents.begin(), dependents.end());
+      for (auto& dependent : dependents)
+      {
+        if (visited.insert(dependent).second)
+        {
+          output.emplace_back(dependent);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/*!
+  @file AssetDependencyGraph.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of AssetDependencyGraph
+*/
+#pragma once
+
+// Standard Headers
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace NightEngine
+{
+  //! @brief Which asset file use which, e.g. material -> texture, scene -> model.
+  // A change to a file affect every file that transitively depend on it.
+  class AssetDependencyGraph
+  {
+    public:
+      //! @brief Record that dependent use dependency
+      void AddDependency(const std::string& dependent, const std::string& dependency);
+
+      //! @brief Forget the outgoing edges of dependent, before recording them again
+      void ClearDependencies(const std::string& dependent);
+
+      //! @brief Direct dependencies of the file
+      void GetDependencies(const std::string& dependent, std::vector<std::string>& output) const;
+
+      //! @brief Changed files and every file depending on them, each one once.
+      // Changed files come first in their order, then the dependents breadth first.
+      void GetAffected(const std::vector<std::string>& changedFiles
+        , std::vector<std::string>& output) const;
+
+      //! @brief Number of files with at least one edge
+      size_t GetFileCount(void) const { return m_nodes.size(); }
+
+      //! @brief Remove everything
+      void Clear(void) { m_nodes.clear(); }
+    private:
+      struct Node
+      {
+        std::unordered_set<std::string> m_dependencies;
+        std::unordered_set<std::string> m_dependents;
+      };
+
+      std::unordered_map<std::string, Node> m_nodes;
+  };
+}
@@ -0,0 +1,219 @@
+/*!
+  @file Compression.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Compression
+*/
+#include "Core/Serialization/Compression.hpp"
+
+// Standard Headers
+#include <cstring>
+#include <vector>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine
+{
+  namespace Compression
+  {
+    //Reference: https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+    static const size_t c_MIN_MATCH = 4;
+    static const size_t c_LAST_LITERALS = 5;    //Block always end with literals
+    static const size_t c_MF_LIMIT = 12;        //Last match start this far from the end
+    static const size_t c_MAX_OFFSET = 65535;
+    static const unsigned c_HASH_LOG = 12;
+
+    static inline U32 Read32(const U8* ptr)
+    {
+      U32 value;
+      std::memcpy(&value, ptr, sizeof(value));
+      return value;
+    }
+
+    static inline U32 Hash(U32 sequence)
+    {
+      return (sequence * 2654435761u) >> (32 - c_HASH_LOG);
+    }
+
+    //! @brief 15 in the token nibble, the rest as 255 bytes and a remainder
+    static inline U8* WriteLength(U8* out, size_t length)
+    {
+      length -= 15;
+      while (length >= 255)
+      {
+        *out++ = 255;
+        length -= 255;
+      }
+      *out++ = static_cast<U8>(length);
+      return out;
+    }
+
+    static inline bool ReadLength(const U8*& in, const U8* inEnd, size_t& length)
+    {
+      U8 byte;
+      do
+      {
+        if (in >= inEnd)
+        {
+          return false;
+        }
+        byte = *in++;
+        length += byte;
+      } while (byte == 255);
+      return true;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    size_t GetLZ4Bound(size_t srcSize)
+    {
+      return srcSize + srcSize / 255 + 16;
+    }
+
+    size_t CompressLZ4(const char* src, size_t srcSize, char* dst, size_t dstCapacity)
+    {
+      //With the bound, no write need to be checked
+      if (dstCapacity < GetLZ4Bound(srcSize))
+      {
+        return 0;
+      }
+
+      const U8* in = reinterpret_cast<const U8*>(src);
+      U8* out = reinterpret_cast<U8*>(dst);
+      size_t anchor = 0;
+
+      if (srcSize > c_MF_LIMIT)
+      {
+        std::vector<U32> table(size_t(1) << c_HASH_LOG, 0);
+        const size_t matchLimit = srcSize - c_LAST_LITERALS;
+        const size_t searchEnd = srcSize - c_MF_LIMIT;
+
+        size_t pos = 0;
+        while (pos < searchEnd)
+        {
+          U32 sequence = Read32(in + pos);
+          U32& slot = table[Hash(sequence)];
+          size_t candidate = slot;
+          slot = static_cast<U32>(pos);
+
+          if (candidate >= pos || pos - candidate > c_MAX_OFFSET
+            || Read32(in + candidate) != sequence)
+          {
+            ++pos;
+            continue;
+          }
+
+          size_t matchLength = c_MIN_MATCH;
+          while (pos + matchLength < matchLimit
+            && in[candidate + matchLength] == in[pos + matchLength])
+          {
+            ++matchLength;
+          }
+
+          //Sequence: token, literals, offset, match length
+          size_t literalLength = pos - anchor;
+          U8* token = out++;
+          *token = static_cast<U8>((literalLength >= 15 ? 15 : literalLength) << 4);
+          if (literalLength >= 15)
+          {
+            out = WriteLength(out, literalLength);
+          }
+          std::memcpy(out, in + anchor, literalLength);
+          out += literalLength;
+
+          size_t offset = pos - candidate;
+          *out++ = static_cast<U8>(offset & 0xFF);
+          *out++ = static_cast<U8>(offset >> 8);
+
+          size_t matchCode = matchLength - c_MIN_MATCH;
+          *token |= static_cast<U8>(matchCode >= 15 ? 15 : matchCode);
+          if (matchCode >= 15)
+          {
+            out = WriteLength(out, matchCode);
+          }
+
+          pos += matchLength;
+          anchor = pos;
+        }
+      }
+
+      //Last sequence is literals only
+      size_t literalLength = srcSize - anchor;
+      U8* token = out++;
+      *token = static_cast<U8>((literalLength >= 15 ? 15 : literalLength) << 4);
+      if (literalLength >= 15)
+      {
+        out = WriteLength(out, literalLength);
+      }
+      std::memcpy(out, in + anchor, literalLength);
+      out += literalLength;
+
+      return static_cast<size_t>(out - reinterpret_cast<U8*>(dst));
+    }
+
+    bool DecompressLZ4(const char* src, size_t srcSize, char* dst, size_t dstSize)
+    {
+      const U8* in = reinterpret_cast<const U8*>(src);
+      const U8* inEnd = in + srcSize;
+      U8* out = reinterpret_cast<U8*>(dst);
+      U8* outBegin = out;
+      U8* outEnd = out + dstSize;
+
+      while (in < inEnd)
+      {
+        U8 token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(in, inEnd, literalLength))
+        {
+          return false;
+        }
+        if (literalLength > static_cast<size_t>(inEnd - in)
+          || literalLength > static_cast<size_t>(outEnd - out))
+        {
+          return false;
+        }
+        std::memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        //Last sequence has no match
+        if (in == inEnd)
+        {
+          break;
+        }
+
+        if (inEnd - in < 2)
+        {
+          return false;
+        }
+        size_t offset = size_t(in[0]) | (size_t(in[1]) << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - outBegin))
+        {
+          return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(in, inEnd, matchLength))
+        {
+          return false;
+        }
+        matchLength += c_MIN_MATCH;
+        if (matchLength > static_cast<size_t>(outEnd - out))
+        {
+          return false;
+        }
+
+        //Match can overlap the bytes it produce, e.g. a run of one byte
+        const U8* match = out - offset;
+        for (size_t i = 0; i < matchLength; ++i)
+        {
+          out[i] = match[i];
+        }
+        out += matchLength;
+      }
+
+      return out == outEnd;
+    }
+  }
+}
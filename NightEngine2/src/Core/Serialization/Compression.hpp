@@ -0,0 +1,34 @@
+/*!
+  @file Compression.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Compression
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+
+// Standard Headers
+#include <cstddef>
+
+namespace NightEngine
+{
+  enum class CompressionType : Container::U32
+  {
+    NONE = 0,
+    LZ4             //LZ4 block format
+  };
+
+  //! @brief Byte compression for the asset archives
+  namespace Compression
+  {
+    //! @brief Largest compressed size of srcSize bytes
+    size_t GetLZ4Bound(size_t srcSize);
+
+    //! @brief Compress into dst, dstCapacity has to be at least GetLZ4Bound(srcSize).
+    // Return the compressed size, 0 on failure.
+    size_t CompressLZ4(const char* src, size_t srcSize, char* dst, size_t dstCapacity);
+
+    //! @brief Decompress exactly dstSize bytes, false if src is malformed
+    bool DecompressLZ4(const char* src, size_t srcSize, char* dst, size_t dstSize);
+  }
+}
@@ -4,9 +4,9 @@
   @brief Contain the Implementation of FileSystem
 */
 #include "Core/Serialization/FileSystem.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
 
 #include "Core/Macros.hpp"
-#include <sys/stat.h>
 
 #include <filesystem>	//Required C++17
 
@@ -15,7 +15,8 @@ namespace NightEngine
 	namespace FileSystem
 	{
 		static Container::String g_dirSubPath[] = {"","Models","Textures"
-      ,"Shaders", "ErrorLog", "Cubemaps", "Archetypes", "Materials", "Scenes"};
+      ,"Shaders", "ErrorLog", "Cubemaps", "Archetypes", "Materials", "Scenes", "ShaderCache"
+      , "AssetCache"};
 
 		std::unique_ptr<std::ofstream> CreateFileTo(const Container::String& fileName, DirectoryType dir, bool append)
 		{
@@ -23,6 +24,12 @@ namespace NightEngine
 			Container::String path{ GetFilePath(fileName, dir) };
 			int mode = append ? std::ofstream::out | std::ofstream::app : std::ofstream::out;
 
+			//New file has to show up in the listing
+			if (!append)
+			{
+				VirtualFileSystem::InvalidateFileList();
+			}
+
 			//Open or create the file
 			return std::unique_ptr<std::ofstream>{ new std::ofstream(path, mode) };
 		}
@@ -40,15 +47,13 @@ namespace NightEngine
 
 		Container::String OpenFileAsString(const Container::String& fileName, DirectoryType dir)
 		{
-			Container::String path{ GetFilePath(fileName, dir) };
+			//Loose file or pak archive
+			FileView view = VirtualFileSystem::Read(GetFilePath(fileName, dir));
 
 			//Error, if file doesn't exist
-			ASSERT_TRUE(IsFileExist(fileName, dir));
+			ASSERT_TRUE(view.IsValid());
 
-			//If exist, open and return
-			std::ifstream out{ path };
-			return Container::String(std::istreambuf_iterator<char>(out),
-				(std::istreambuf_iterator<char>()));
+			return Container::String(view.GetData(), view.GetSize());
 		}
 
 		void GetAllFilesInDirectory(DirectoryType dir, std::vector<std::string>& output
@@ -59,30 +64,19 @@ namespace NightEngine
 				output.clear();
 			}
 
-			std::string path = GetFilePath("", dir);
+			//Cached listing of the mounted backends, the directory isn't walked every call
+			std::vector<std::string> files;
+			VirtualFileSystem::GetFiles(g_dirSubPath[static_cast<unsigned>(dir)]
+				, searchRecursively, files);
 
-			if (searchRecursively)
+			size_t begin = output.size();
+			for (auto& file : files)
 			{
-				for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+				Container::String filePath{ PROJECT_DIR_SOURCE_ASSETS };
+				filePath += file;
+				if (filePath.find(extension) != std::string::npos)
 				{
-					auto filePath = entry.path().string();
-					if (filePath.find(extension) != std::string::npos)
-					{
-						std::replace(filePath.begin(), filePath.end(), '\\', '/');
-						output.emplace_back(filePath);
-					}
-				}
-			}
-			else
-			{
-				for (const auto& entry : std::filesystem::directory_iterator(path))
-				{
-					auto filePath = entry.path().string();
-					if (filePath.find(extension) != std::string::npos)
-					{
-						std::replace(filePath.begin(), filePath.end(), '\\', '/');
-						output.emplace_back(filePath);
-					}
+					output.emplace_back(std::move(filePath));
 				}
 			}
 
@@ -91,7 +85,7 @@ namespace NightEngine
 			{
 			case NightEngine::FileSystem::FileFilter::FileName:
 			{
-				for (int i = 0; i < output.size(); ++i)
+				for (size_t i = begin; i < output.size(); ++i)
 				{
 					auto pos = output[i].find_last_of('/') + 1;
 					if (pos < output[i].size())
@@ -112,7 +106,7 @@ namespace NightEngine
 			//Extension Parsing
 			if (removeExtension)
 			{
-				for (int i = 0; i < output.size(); ++i)
+				for (size_t i = begin; i < output.size(); ++i)
 				{
 					auto pos = output[i].find_last_of('.');
 					if (pos > 0)
@@ -151,9 +145,7 @@ namespace NightEngine
 
 		bool IsFileExist(Container::String fileName, DirectoryType dir)
 		{
-			struct stat buffer;
-			Container::String path{ GetFilePath(fileName, dir) };
-			return (stat(path.c_str(), &buffer) == 0);
+			return VirtualFileSystem::Exists(GetFilePath(fileName, dir));
 		}
 
 		Container::String GetFilePath(const Container::String& fileName, DirectoryType dir)
@@ -165,5 +157,16 @@ namespace NightEngine
 			path += fileName;
 			return path;
 		}
+
+		Container::String NormalizePath(const Container::String& path)
+		{
+			std::error_code error;
+			auto normalized = std::filesystem::weakly_canonical(std::filesystem::path(path), error);
+			if (error)
+			{
+				normalized = std::filesystem::path(path).lexically_normal();
+			}
+			return normalized.generic_string();
+		}
 	}
 }
\ No newline at end of file
@@ -26,6 +26,8 @@ namespace NightEngine
       Archetypes,
       Materials,
       Scenes,
+      ShaderCache,
+      AssetCache,
 			Count
 		};
 		enum class FileFilter : unsigned
@@ -61,5 +63,9 @@ namespace NightEngine
 
 		//! @brief Get Full file path
     Container::String GetFilePath(const Container::String& fileName, DirectoryType dir);
+
+		//! @brief Absolute path with '/' separators and no "./" or "../",
+		// the same file always give the same string
+		Container::String NormalizePath(const Container::String& path);
   }
 }
\ No newline at end of file
@@ -0,0 +1,296 @@
+/*!
+  @file FileWatcher.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of FileWatcher
+*/
+#include "Core/Serialization/FileWatcher.hpp"
+#include "Core/Serialization/FileSystem.hpp"
+
+#include "Core/Logger.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <filesystem>
+
+#if defined(__linux__)
+// System Headers
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+namespace NightEngine
+{
+  void ChangeDebouncer::Add(const std::string& path, FileChangeType type, double now)
+  {
+    //Latest event win, write then delete is a delete
+    m_pending[path] = PendingChange{ type, now };
+  }
+
+  void ChangeDebouncer::Collect(double now, std::vector<FileChange>& output)
+  {
+    size_t begin = output.size();
+    for (auto it = m_pending.begin(); it != m_pending.end(); )
+    {
+      if (now - it->second.m_lastEventTime >= m_delay)
+      {
+        output.emplace_back(FileChange{ it->first, it->second.m_type });
+        it = m_pending.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    std::sort(output.begin() + begin, output.end()
+      , [](const FileChange& lhs, const FileChange& rhs) { return lhs.m_path < rhs.m_path; });
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  FileWatcher::FileWatcher(double debounceSeconds)
+    : m_debouncer(debounceSeconds)
+  {
+#if defined(__linux__)
+    m_inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFD < 0)
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "FileWatcher: inotify_init1 failed, errno[" << errno << "]\n";
+    }
+#endif
+  }
+
+  FileWatcher::~FileWatcher(void)
+  {
+    Clear();
+#if defined(__linux__)
+    if (m_inotifyFD >= 0)
+    {
+      close(m_inotifyFD);
+      m_inotifyFD = -1;
+    }
+#endif
+  }
+
+  bool FileWatcher::Watch(const std::string& directory)
+  {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error))
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "FileWatcher: not a directory [" << directory << "]\n";
+      return false;
+    }
+
+    std::string root = FileSystem::NormalizePath(directory);
+    m_roots.emplace_back(root);
+    AddDirectory(root);
+    for (auto& entry : std::filesystem::recursive_directory_iterator(root, error))
+    {
+      if (entry.is_directory(error))
+      {
+        AddDirectory(entry.path().generic_string());
+      }
+    }
+
+#if !defined(__linux__)
+    //Baseline, files that exist now are not changes
+    Scan(0.0, false);
+#endif
+    return true;
+  }
+
+  void FileWatcher::Clear(void)
+  {
+#if defined(__linux__)
+    for (auto& pair : m_watchDirs)
+    {
+      inotify_rm_watch(m_inotifyFD, pair.first);
+    }
+    m_watchDirs.clear();
+    m_rescanPending = false;
+#else
+    m_writeTimes.clear();
+#endif
+    m_roots.clear();
+  }
+
+  bool FileWatcher::IsNative(void) const
+  {
+#if defined(__linux__)
+    return m_inotifyFD >= 0;
+#else
+    return false;
+#endif
+  }
+
+#if defined(__linux__)
+  void FileWatcher::AddDirectory(const std::string& directory)
+  {
+    if (m_inotifyFD < 0)
+    {
+      return;
+    }
+
+    //Only the events that mean the content is final
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM
+      | IN_CREATE | IN_DELETE;
+    int wd = inotify_add_watch(m_inotifyFD, directory.c_str(), mask);
+    if (wd < 0)
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "FileWatcher: failed to watch [" << directory << "], errno[" << errno << "]\n";
+      return;
+    }
+    m_watchDirs[wd] = directory;
+  }
+
+  void FileWatcher::AddDirectoryTree(const std::string& directory, double now)
+  {
+    //Files can land in it before the watch exist, or came with it when moved in
+    AddDirectory(directory);
+    std::error_code error;
+    for (auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+    {
+      if (entry.is_directory(error))
+      {
+        AddDirectory(entry.path().generic_string());
+      }
+      else if (entry.is_regular_file(error))
+      {
+        m_debouncer.Add(entry.path().generic_string(), FileChangeType::MODIFIED, now);
+      }
+    }
+  }
+
+  void FileWatcher::Poll(double now, std::vector<FileChange>& output)
+  {
+    if (m_inotifyFD >= 0)
+    {
+      alignas(inotify_event) char buffer[16 * 1024];
+      for (;;)
+      {
+        ssize_t length = read(m_inotifyFD, buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+          break;
+        }
+
+        for (char* ptr = buffer; ptr < buffer + length; )
+        {
+          auto event = reinterpret_cast<const inotify_event*>(ptr);
+          ptr += sizeof(inotify_event) + event->len;
+
+          //Events were dropped, only a full rescan can tell what changed
+          if (event->mask & IN_Q_OVERFLOW)
+          {
+            m_rescanPending = true;
+            continue;
+          }
+
+          auto it = m_watchDirs.find(event->wd);
+          if (it == m_watchDirs.end() || event->len == 0)
+          {
+            continue;
+          }
+
+          std::string path = it->second + "/" + event->name;
+          if (event->mask & IN_ISDIR)
+          {
+            //New sub directory need its own watch
+            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            {
+              AddDirectoryTree(path, now);
+            }
+            continue;
+          }
+
+          //IN_CREATE alone is an empty file, the write come with IN_CLOSE_WRITE
+          if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+          {
+            m_debouncer.Add(path, FileChangeType::MODIFIED, now);
+          }
+          else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+          {
+            m_debouncer.Add(path, FileChangeType::REMOVED, now);
+          }
+        }
+      }
+    }
+
+    //Every file is reported modified, removals during the overflow are lost
+    if (m_rescanPending)
+    {
+      m_rescanPending = false;
+      Debug::Log << Logger::MessageType::WARNING
+        << "FileWatcher: inotify queue overflowed, rescanning " << m_roots.size() << " roots\n";
+      for (auto& root : m_roots)
+      {
+        AddDirectoryTree(root, now);
+      }
+    }
+
+    m_debouncer.Collect(now, output);
+  }
+#else
+  void FileWatcher::AddDirectory(const std::string&)
+  {
+    //Scanned from the roots
+  }
+
+  void FileWatcher::Scan(double now, bool recordChanges)
+  {
+    std::unordered_map<std::string, long long> writeTimes;
+    std::error_code error;
+    for (auto& root : m_roots)
+    {
+      for (auto& entry : std::filesystem::recursive_directory_iterator(root, error))
+      {
+        if (!entry.is_regular_file(error))
+        {
+          continue;
+        }
+
+        std::string path = entry.path().generic_string();
+        long long time = static_cast<long long>(
+          entry.last_write_time(error).time_since_epoch().count());
+        writeTimes[path] = time;
+
+        auto it = m_writeTimes.find(path);
+        if (recordChanges && (it == m_writeTimes.end() || it->second != time))
+        {
+          m_debouncer.Add(path, FileChangeType::MODIFIED, now);
+        }
+      }
+    }
+
+    if (recordChanges)
+    {
+      for (auto& pair : m_writeTimes)
+      {
+        if (writeTimes.find(pair.first) == writeTimes.end())
+        {
+          m_debouncer.Add(pair.first, FileChangeType::REMOVED, now);
+        }
+      }
+    }
+    m_writeTimes.swap(writeTimes);
+  }
+
+  void FileWatcher::Poll(double now, std::vector<FileChange>& output)
+  {
+    //Scanning is expensive, twice a second is enough for iteration
+    const double c_SCAN_INTERVAL = 0.5;
+    if (now - m_lastScanTime >= c_SCAN_INTERVAL)
+    {
+      m_lastScanTime = now;
+      Scan(now, true);
+    }
+
+    m_debouncer.Collect(now, output);
+  }
+#endif
+}
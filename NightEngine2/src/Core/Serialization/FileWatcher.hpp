@@ -0,0 +1,100 @@
+/*!
+  @file FileWatcher.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of FileWatcher
+*/
+#pragma once
+
+// Standard Headers
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace NightEngine
+{
+  enum class FileChangeType : unsigned
+  {
+    MODIFIED = 0,   //Created, written or moved in
+    REMOVED         //Deleted or moved out
+  };
+
+  struct FileChange
+  {
+    std::string    m_path;    //Normalized, see FileSystem::NormalizePath
+    FileChangeType m_type;
+  };
+
+  //! @brief Coalesce bursts of events per file, a file is reported once
+  // it has been quiet for the delay. Editors often save with several writes.
+  class ChangeDebouncer
+  {
+    public:
+      //! @brief Constructor
+      explicit ChangeDebouncer(double delaySeconds = 0.2) : m_delay(delaySeconds) {}
+
+      //! @brief Record an event at time now, restarting the file's quiet period
+      void Add(const std::string& path, FileChangeType type, double now);
+
+      //! @brief Append the files that have been quiet long enough, sorted by path
+      void Collect(double now, std::vector<FileChange>& output);
+
+      //! @brief Number of files waiting for their quiet period
+      size_t GetPendingCount(void) const { return m_pending.size(); }
+    private:
+      struct PendingChange
+      {
+        FileChangeType m_type;
+        double         m_lastEventTime;
+      };
+
+      std::unordered_map<std::string, PendingChange> m_pending;
+      double m_delay;
+  };
+
+  //! @brief Watch directories recursively for changed files.
+  // Use inotify on Linux, scan the modified time of every file elsewhere.
+  class FileWatcher
+  {
+    public:
+      //! @brief Constructor
+      explicit FileWatcher(double debounceSeconds = 0.2);
+
+      //! @brief Destructor, close the watches
+      ~FileWatcher(void);
+
+      FileWatcher(const FileWatcher&) = delete;
+      FileWatcher& operator=(const FileWatcher&) = delete;
+
+      //! @brief Watch directory and all its sub directories, return false if it can't be watched
+      bool Watch(const std::string& directory);
+
+      //! @brief Stop watching everything
+      void Clear(void);
+
+      //! @brief Read the pending events without blocking, output the debounced changes
+      void Poll(double now, std::vector<FileChange>& output);
+
+      //! @brief Check if the native notification is in use instead of scanning
+      bool IsNative(void) const;
+    private:
+      void AddDirectory(const std::string& directory);
+
+      ChangeDebouncer m_debouncer;
+      std::vector<std::string> m_roots;
+
+#if defined(__linux__)
+      //! @brief Watch directory and its sub directories, report the files already in them
+      void AddDirectoryTree(const std::string& directory, double now);
+
+      int m_inotifyFD = -1;
+      std::unordered_map<int, std::string> m_watchDirs;   //Watch descriptor -> directory
+      bool m_rescanPending = false;                       //The kernel queue overflowed
+#else
+      //Polling fallback
+      void Scan(double now, bool recordChanges);
+
+      std::unordered_map<std::string, long long> m_writeTimes;
+      double m_lastScanTime = -1.0;
+#endif
+  };
+}
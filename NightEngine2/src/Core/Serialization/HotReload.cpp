@@ -0,0 +1,424 @@
+/*!
+  @file HotReload.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of HotReload
+*/
+#include "Core/Serialization/HotReload.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Utility/Utility.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Core/Serialization/FileSystem.hpp"
+#include "Core/Serialization/FileWatcher.hpp"
+#include "Core/Serialization/AssetDependencyGraph.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
+#include "Core/Serialization/ResourceManager.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+
+#include "Core/EC/Factory.hpp"
+#include "Core/EC/SceneManager.hpp"
+#include "Core/EC/Scene.hpp"
+#include "Core/EC/GameObject.hpp"
+
+#include "Graphics/Opengl/Texture.hpp"
+#include "Graphics/Opengl/Material.hpp"
+#include "Graphics/Opengl/MeshRenderer.hpp"
+#include "Graphics/Opengl/ShaderTracker.hpp"
+#include "Graphics/Opengl/ShaderPreprocessor.hpp"
+
+// Standard Headers
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace NightEngine::Container;
+using namespace NightEngine::EC;
+using namespace NightEngine::EC::Components;
+using namespace NightEngine::EC::SceneManager;
+using namespace NightEngine::Rendering::Opengl;
+
+namespace NightEngine
+{
+  namespace HotReload
+  {
+    static std::unique_ptr<FileWatcher> g_watcher;
+    static AssetDependencyGraph         g_graph;
+    static std::vector<FileChange>      g_changes;
+
+    //Content hash of the files the engine just wrote
+    static std::unordered_map<std::string, U64> g_selfWrites;
+
+    static const FileSystem::DirectoryType c_WATCHED_DIRS[] =
+    {
+      FileSystem::DirectoryType::Shaders,
+      FileSystem::DirectoryType::Textures,
+      FileSystem::DirectoryType::Materials,
+      FileSystem::DirectoryType::Models,
+      FileSystem::DirectoryType::Scenes
+    };
+
+    static double GetTimeSeconds(void)
+    {
+      using namespace std::chrono;
+      return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    static bool HashFile(const std::string& path, U64& hash)
+    {
+      std::ifstream file(path, std::ios::in | std::ios::binary);
+      if (!file.is_open())
+      {
+        return false;
+      }
+
+      std::string content{ std::istreambuf_iterator<char>(file)
+        , std::istreambuf_iterator<char>() };
+      hash = ConvertToHash(content.c_str(), content.size());
+      return true;
+    }
+
+    //! @brief Check if the change is only the engine's own write
+    static bool IsSelfWrite(const FileChange& change)
+    {
+      auto it = g_selfWrites.find(change.m_path);
+      if (it == g_selfWrites.end())
+      {
+        return false;
+      }
+
+      U64 hash = 0;
+      bool isSelfWrite = change.m_type == FileChangeType::MODIFIED
+        && HashFile(change.m_path, hash) && hash == it->second;
+      g_selfWrites.erase(it);
+      return isSelfWrite;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    static void AddMaterialDependencies(Material& material)
+    {
+      if (material.GetFilePath().empty())
+      {
+        return;
+      }
+
+      std::string materialPath = FileSystem::NormalizePath(material.GetFilePath());
+      g_graph.ClearDependencies(materialPath);
+      for (auto& pair : material.GetTextureMap())
+      {
+        if (pair.second.IsValid() && !pair.second->GetFilePath().empty())
+        {
+          g_graph.AddDependency(materialPath
+            , FileSystem::NormalizePath(pair.second->GetFilePath()));
+        }
+      }
+    }
+
+    //! @brief Record the current edges, materials and scenes can change at runtime
+    static void RebuildDependencies(void)
+    {
+      //Shader -> includes, from the preprocessor's cache
+      auto& preprocessor = GetShaderPreprocessor();
+      std::vector<std::string> files;
+      std::vector<std::string> includes;
+      preprocessor.GetFiles(files);
+      for (auto& file : files)
+      {
+        std::string shaderPath = FileSystem::NormalizePath(file);
+        g_graph.ClearDependencies(shaderPath);
+        preprocessor.GetIncludes(file, includes);
+        for (auto& include : includes)
+        {
+          g_graph.AddDependency(shaderPath, FileSystem::NormalizePath(include));
+        }
+      }
+
+      //Material -> textures
+      auto& materialContainer = Factory::GetTypeContainer<Material>();
+      auto it = materialContainer.GetIterator();
+      while (!it.IsEnd())
+      {
+        AddMaterialDependencies(*it.Get());
+        it.Next();
+      }
+
+      //Scene -> models, materials
+      auto scenes = GetAllScenes();
+      for (size_t i = 0; scenes != nullptr && i < scenes->size(); ++i)
+      {
+        Scene& scene = *((*scenes)[i].Get());
+        std::string scenePath = FileSystem::NormalizePath(GetSceneFilePath(scene));
+        g_graph.ClearDependencies(scenePath);
+        for (auto go : scene.GetAllGameObjects())
+        {
+          auto handle = go.Get()->GetComponent<MeshRenderer>();
+          if (handle == nullptr)
+          {
+            continue;
+          }
+
+          auto meshRenderer = handle->Get<MeshRenderer>();
+          if (!meshRenderer->GetMeshLoadPath().empty())
+          {
+            g_graph.AddDependency(scenePath
+              , FileSystem::NormalizePath(meshRenderer->GetMeshLoadPath()));
+          }
+
+          auto material = meshRenderer->GetMaterial();
+          if (material != nullptr && !material->GetFilePath().empty())
+          {
+            g_graph.AddDependency(scenePath
+              , FileSystem::NormalizePath(material->GetFilePath()));
+          }
+        }
+      }
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    static size_t ReloadShaders(const std::unordered_set<std::string>& changed
+      , const std::vector<std::string>& affected)
+    {
+      //Preprocessor and shaders use the path they were loaded with
+      auto& preprocessor = GetShaderPreprocessor();
+      std::vector<std::string> files;
+      preprocessor.GetFiles(files);
+
+      std::unordered_map<std::string, std::string> rawPaths;
+      for (auto& file : files)
+      {
+        rawPaths.emplace(FileSystem::NormalizePath(file), file);
+      }
+
+      std::unordered_set<std::string> shaderFiles;
+      for (auto& path : affected)
+      {
+        auto it = rawPaths.find(path);
+        if (it == rawPaths.end())
+        {
+          continue;
+        }
+
+        //Includers are expanded again from the cache, only the edited file is read
+        if (changed.find(path) != changed.end())
+        {
+          preprocessor.Invalidate(it->second);
+        }
+        shaderFiles.insert(it->second);
+      }
+
+      return shaderFiles.empty() ? 0 : ShaderTracker::RecompileShadersUsing(shaderFiles);
+    }
+
+    static size_t ReloadTexture(const std::string& path)
+    {
+      size_t count = 0;
+      auto& textureContainer = Factory::GetTypeContainer<Texture>();
+      auto it = textureContainer.GetIterator();
+      while (!it.IsEnd())
+      {
+        auto texture = it.Get();
+        if (!texture->GetFilePath().empty()
+          && FileSystem::NormalizePath(texture->GetFilePath()) == path
+          && texture->Reload())
+        {
+          ++count;
+        }
+        it.Next();
+      }
+      return count;
+    }
+
+    static size_t ReloadMaterial(const std::string& path, bool fromFile)
+    {
+      size_t count = 0;
+      auto& materialContainer = Factory::GetTypeContainer<Material>();
+      auto it = materialContainer.GetIterator();
+      while (!it.IsEnd())
+      {
+        auto material = it.Get();
+        if (!material->GetFilePath().empty()
+          && FileSystem::NormalizePath(material->GetFilePath()) == path)
+        {
+          //Only a texture changed, the texture handles are already updated
+          if (fromFile)
+          {
+            material->ReloadFromFile();
+          }
+          else
+          {
+            material->RefreshTextureUniforms();
+          }
+          ++count;
+        }
+        it.Next();
+      }
+      return count;
+    }
+
+    static size_t ReloadModel(const std::string& path)
+    {
+      size_t count = 0;
+      std::unordered_set<std::string> unloaded;
+      auto& meshRendererContainer = Factory::GetTypeContainer<MeshRenderer>();
+      auto it = meshRendererContainer.GetIterator();
+      while (!it.IsEnd())
+      {
+        auto meshRenderer = it.Get();
+        const std::string& loadPath = meshRenderer->GetMeshLoadPath();
+        if (!loadPath.empty() && FileSystem::NormalizePath(loadPath) == path)
+        {
+          //Cached by the path it was loaded with
+          if (unloaded.insert(loadPath).second)
+          {
+            ResourceManager::UnloadModelResource(loadPath);
+          }
+          meshRenderer->ReloadModel();
+          ++count;
+        }
+        it.Next();
+      }
+      return count;
+    }
+
+    static size_t ReloadScene(const std::string& path)
+    {
+      auto scenes = GetAllScenes();
+      for (size_t i = 0; scenes != nullptr && i < scenes->size(); ++i)
+      {
+        Handle<Scene> scene = (*scenes)[i];
+        if (FileSystem::NormalizePath(GetSceneFilePath(*scene.Get())) == path)
+        {
+          SceneManager::ReloadScene(scene);
+          return 1;
+        }
+      }
+      return 0;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    void Initialize(void)
+    {
+      g_watcher = std::make_unique<FileWatcher>();
+      for (auto dir : c_WATCHED_DIRS)
+      {
+        g_watcher->Watch(FileSystem::GetFilePath("", dir));
+      }
+
+      Debug::Log << Logger::MessageType::INFO
+        << "HotReload: watching assets [" << (g_watcher->IsNative() ? "inotify" : "polling") << "]\n";
+    }
+
+    void Terminate(void)
+    {
+      g_watcher.reset();
+      g_graph.Clear();
+      g_changes.clear();
+      g_selfWrites.clear();
+    }
+
+    bool Update(void)
+    {
+      if (g_watcher == nullptr)
+      {
+        return false;
+      }
+
+      g_changes.clear();
+      g_watcher->Poll(GetTimeSeconds(), g_changes);
+      if (g_changes.empty())
+      {
+        return false;
+      }
+
+      //Added or removed files show up in the editor's listing
+      VirtualFileSystem::InvalidateFileList();
+
+      NightEngine::Utility::StopWatch stopWatch{ true };
+      std::vector<std::string> changedFiles;
+      auto& assetDatabase = GetAssetDatabase();
+      for (auto& change : g_changes)
+      {
+        //New content hash, reloads below cook it again
+        if (change.m_type == FileChangeType::MODIFIED)
+        {
+          assetDatabase.UpdateRecord(change.m_path);
+        }
+
+        //Removed files keep their last loaded content
+        if (change.m_type == FileChangeType::MODIFIED && !IsSelfWrite(change))
+        {
+          changedFiles.emplace_back(change.m_path);
+        }
+      }
+      if (changedFiles.empty())
+      {
+        return false;
+      }
+
+      RebuildDependencies();
+      std::vector<std::string> affected;
+      g_graph.GetAffected(changedFiles, affected);
+      std::unordered_set<std::string> changed{ changedFiles.begin(), changedFiles.end() };
+
+      //Textures before materials, materials before scenes
+      size_t reloadCount = 0;
+      for (auto& path : affected)
+      {
+        switch (GetAssetType(path))
+        {
+        case AssetType::TEXTURE:
+          reloadCount += ReloadTexture(path);
+          break;
+        case AssetType::MODEL:
+          reloadCount += ReloadModel(path);
+          break;
+        default:
+          break;
+        }
+      }
+      for (auto& path : affected)
+      {
+        if (GetAssetType(path) == AssetType::MATERIAL)
+        {
+          reloadCount += ReloadMaterial(path, changed.find(path) != changed.end());
+        }
+      }
+      for (auto& path : changedFiles)
+      {
+        //A scene using a changed asset already see it, only the scene file need a reload
+        if (GetAssetType(path) == AssetType::SCENE)
+        {
+          reloadCount += ReloadScene(path);
+        }
+      }
+      size_t shaderCount = ReloadShaders(changed, affected);
+      stopWatch.Stop();
+
+      Debug::Log << Logger::MessageType::INFO
+        << "HotReload: " << changedFiles.size() << " changed, " << affected.size()
+        << " affected, reloaded " << reloadCount << " resources and " << shaderCount
+        << " shaders [" << stopWatch.GetElapsedTimeMilli() << " ms]\n";
+
+      return shaderCount > 0;
+    }
+
+    void NotifyFileWritten(const Container::String& filePath)
+    {
+      std::string path = FileSystem::NormalizePath(filePath);
+      U64 hash = 0;
+      if (HashFile(path, hash))
+      {
+        g_selfWrites[path] = hash;
+      }
+    }
+
+    const AssetDependencyGraph& GetDependencyGraph(void)
+    {
+      return g_graph;
+    }
+  }
+}
@@ -0,0 +1,35 @@
+/*!
+  @file HotReload.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of HotReload
+*/
+#pragma once
+
+#include "Core/Container/String.hpp"
+
+namespace NightEngine
+{
+  class AssetDependencyGraph;
+
+  //! @brief Watch the asset directories and reload only the resources
+  // affected by a changed file: shaders through their includes, materials
+  // through their textures, scenes through their models and materials.
+  namespace HotReload
+  {
+    //! @brief Start watching, need the renderer and SceneManager initialized
+    void Initialize(void);
+
+    //! @brief Stop watching
+    void Terminate(void);
+
+    //! @brief Reload the changed resources, call at the frame boundary.
+    // Return true if any shader has been recompiled.
+    bool Update(void);
+
+    //! @brief The engine wrote filePath itself, don't reload it for that write
+    void NotifyFileWritten(const Container::String& filePath);
+
+    //! @brief Graph from the last update, for the editor
+    const AssetDependencyGraph& GetDependencyGraph(void);
+  }
+}
@@ -0,0 +1,150 @@
+/*!
+  @file MappedFile.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MappedFile
+*/
+#include "Core/Serialization/MappedFile.hpp"
+
+#if defined(_WIN32)
+// System Headers
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+// System Headers
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NightEngine
+{
+  //Mapping an empty file fail, they still need a valid pointer
+  static const char c_EMPTY_FILE[1] = { '\0' };
+
+  MappedFile::~MappedFile(void)
+  {
+    Close();
+  }
+
+#if defined(_WIN32)
+  bool MappedFile::Open(const std::string& path)
+  {
+    Close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE
+      , nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+      CloseHandle(file);
+      return false;
+    }
+
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_isOpen = true;
+    if (m_size == 0)
+    {
+      m_data = c_EMPTY_FILE;
+      return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (view == nullptr)
+    {
+      if (mapping != nullptr)
+      {
+        CloseHandle(mapping);
+      }
+      Close();
+      return false;
+    }
+
+    m_mappingHandle = mapping;
+    m_data = static_cast<const char*>(view);
+    return true;
+  }
+
+  void MappedFile::Close(void)
+  {
+    if (m_data != nullptr && m_data != c_EMPTY_FILE)
+    {
+      UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr)
+    {
+      CloseHandle(m_mappingHandle);
+    }
+    if (m_fileHandle != nullptr)
+    {
+      CloseHandle(m_fileHandle);
+    }
+
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+  }
+#else
+  bool MappedFile::Open(const std::string& path)
+  {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+      close(fd);
+      return false;
+    }
+
+    m_size = static_cast<size_t>(info.st_size);
+    m_isOpen = true;
+    if (m_size == 0)
+    {
+      close(fd);
+      m_data = c_EMPTY_FILE;
+      return true;
+    }
+
+    //The mapping stay valid after the descriptor is closed
+    void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+      m_size = 0;
+      m_isOpen = false;
+      return false;
+    }
+
+    m_data = static_cast<const char*>(view);
+    return true;
+  }
+
+  void MappedFile::Close(void)
+  {
+    if (m_data != nullptr && m_data != c_EMPTY_FILE)
+    {
+      munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+  }
+#endif
+}
@@ -0,0 +1,81 @@
+/*!
+  @file MappedFile.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MappedFile
+*/
+#pragma once
+
+// Standard Headers
+#include <string>
+#include <string_view>
+#include <memory>
+
+namespace NightEngine
+{
+  //! @brief Read-only file mapped into memory
+  class MappedFile
+  {
+    public:
+      //! @brief Constructor
+      MappedFile(void) = default;
+
+      //! @brief Destructor, unmap the file
+      ~MappedFile(void);
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      //! @brief Map the whole file, return false if it can't be opened
+      bool Open(const std::string& path);
+
+      //! @brief Unmap the file
+      void Close(void);
+
+      //! @brief Check if the file is mapped, empty file are open with no data
+      bool IsOpen(void) const { return m_isOpen; }
+
+      //! @brief Start of the mapped file
+      const char* GetData(void) const { return m_data; }
+
+      //! @brief Size of the file in bytes
+      size_t GetSize(void) const { return m_size; }
+    private:
+      const char* m_data = nullptr;
+      size_t      m_size = 0;
+      bool        m_isOpen = false;
+
+#if defined(_WIN32)
+      void*       m_fileHandle = nullptr;
+      void*       m_mappingHandle = nullptr;
+#endif
+  };
+
+  //! @brief Read-only bytes of a file, either pointing into a mapped file
+  // or owning the decompressed bytes. The owner is kept alive by the view.
+  class FileView
+  {
+    public:
+      //! @brief Constructor, invalid view
+      FileView(void) = default;
+
+      //! @brief Constructor, data has to stay valid as long as owner
+      FileView(const char* data, size_t size, std::shared_ptr<const void> owner)
+        : m_data(data), m_size(size), m_owner(std::move(owner)) {}
+
+      //! @brief Check if the file was found and read
+      bool IsValid(void) const { return m_data != nullptr; }
+
+      //! @brief Start of the bytes
+      const char* GetData(void) const { return m_data; }
+
+      //! @brief Size in bytes
+      size_t GetSize(void) const { return m_size; }
+
+      //! @brief Content as text
+      std::string_view GetString(void) const { return std::string_view(m_data, m_size); }
+    private:
+      const char*                 m_data = nullptr;
+      size_t                      m_size = 0;
+      std::shared_ptr<const void> m_owner;
+  };
+}
@@ -0,0 +1,267 @@
+/*!
+  @file PakArchive.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of PakArchive
+*/
+#include "Core/Serialization/PakArchive.hpp"
+
+#include "Core/Container/MurmurHash2.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <fstream>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine
+{
+  static U64 AlignUp(U64 value, U64 alignment)
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  static bool EntryLess(const PakEntry& lhs, U64 hash)
+  {
+    return lhs.m_pathHash < hash;
+  }
+
+  //Only kept compressed if it save at least 1/8 of the size
+  static bool IsWorthCompressing(size_t size, size_t compressedSize)
+  {
+    return compressedSize + size / 8 <= size;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  U64 PakArchive::HashPath(std::string_view path)
+  {
+    return ConvertToHash(path.data(), path.size());
+  }
+
+  bool PakArchive::Open(const std::string& path)
+  {
+    Close();
+    if (!m_file.Open(path) || m_file.GetSize() < sizeof(PakHeader))
+    {
+      m_file.Close();
+      return false;
+    }
+
+    const char* data = m_file.GetData();
+    U64 fileSize = m_file.GetSize();
+    auto header = reinterpret_cast<const PakHeader*>(data);
+    U64 entriesSize = U64(header->m_entryCount) * sizeof(PakEntry);
+    if (header->m_magic != c_PAK_MAGIC || header->m_version != c_PAK_VERSION
+      || header->m_tocOffset % alignof(PakEntry) != 0
+      || header->m_tocOffset > fileSize || header->m_tocSize > fileSize - header->m_tocOffset
+      || entriesSize > header->m_tocSize)
+    {
+      m_file.Close();
+      return false;
+    }
+
+    m_entries = reinterpret_cast<const PakEntry*>(data + header->m_tocOffset);
+    m_paths = data + header->m_tocOffset + entriesSize;
+    m_entryCount = header->m_entryCount;
+
+    //A truncated or corrupted archive must not read out of the mapping
+    U64 pathsSize = header->m_tocSize - entriesSize;
+    for (size_t i = 0; i < m_entryCount; ++i)
+    {
+      const PakEntry& entry = m_entries[i];
+      if (entry.m_offset > header->m_tocOffset
+        || entry.m_storedSize > header->m_tocOffset - entry.m_offset
+        || U64(entry.m_pathOffset) + entry.m_pathLength > pathsSize
+        || (entry.m_compression == CompressionType::NONE && entry.m_storedSize != entry.m_size)
+        || entry.m_compression > CompressionType::LZ4
+        || (i > 0 && m_entries[i - 1].m_pathHash > entry.m_pathHash))
+      {
+        Close();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void PakArchive::Close(void)
+  {
+    m_file.Close();
+    m_entries = nullptr;
+    m_paths = nullptr;
+    m_entryCount = 0;
+  }
+
+  const PakEntry* PakArchive::Find(std::string_view path) const
+  {
+    U64 hash = HashPath(path);
+    const PakEntry* end = m_entries + m_entryCount;
+    for (auto it = std::lower_bound(m_entries, end, hash, EntryLess);
+      it != end && it->m_pathHash == hash; ++it)
+    {
+      if (GetPath(*it) == path)
+      {
+        return it;
+      }
+    }
+    return nullptr;
+  }
+
+  std::string_view PakArchive::GetPath(const PakEntry& entry) const
+  {
+    return std::string_view(m_paths + entry.m_pathOffset, entry.m_pathLength);
+  }
+
+  const char* PakArchive::GetStoredData(const PakEntry& entry) const
+  {
+    return m_file.GetData() + entry.m_offset;
+  }
+
+  bool PakArchive::Decompress(const PakEntry& entry, char* output) const
+  {
+    switch (entry.m_compression)
+    {
+    case CompressionType::NONE:
+      std::copy_n(GetStoredData(entry), entry.m_size, output);
+      return true;
+    case CompressionType::LZ4:
+      return Compression::DecompressLZ4(GetStoredData(entry), entry.m_storedSize
+        , output, entry.m_size);
+    }
+    return false;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void PakWriter::AddFile(const std::string& path, const std::string& diskPath)
+  {
+    m_sources.emplace_back(Source{ path, diskPath, {} });
+  }
+
+  void PakWriter::AddData(const std::string& path, std::vector<char> data)
+  {
+    m_sources.emplace_back(Source{ path, "", std::move(data) });
+  }
+
+  bool PakWriter::Write(const std::string& outputPath, CompressionType compression
+    , std::string& error)
+  {
+    m_totalSize = 0;
+    m_storedSize = 0;
+
+    std::sort(m_sources.begin(), m_sources.end()
+      , [](const Source& lhs, const Source& rhs) { return lhs.m_path < rhs.m_path; });
+    for (size_t i = 1; i < m_sources.size(); ++i)
+    {
+      if (m_sources[i - 1].m_path == m_sources[i].m_path)
+      {
+        error = "duplicated path [" + m_sources[i].m_path + "]";
+        return false;
+      }
+    }
+
+    std::ofstream file(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      error = "can't create [" + outputPath + "]";
+      return false;
+    }
+
+    //Header is written last, once the table of content is known
+    PakHeader header{ c_PAK_MAGIC, c_PAK_VERSION, static_cast<U32>(m_sources.size()), 0, 0, 0 };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<PakEntry> entries;
+    entries.reserve(m_sources.size());
+    std::string paths;
+    std::vector<char> compressed;
+    const char zeros[16] = {};
+    U64 offset = sizeof(header);
+    auto writePadding = [&](U64 target)
+    {
+      while (offset < target)
+      {
+        U64 count = std::min<U64>(target - offset, sizeof(zeros));
+        file.write(zeros, count);
+        offset += count;
+      }
+    };
+
+    for (auto& source : m_sources)
+    {
+      MappedFile mappedFile;
+      const char* data = source.m_data.data();
+      size_t size = source.m_data.size();
+      if (!source.m_diskPath.empty())
+      {
+        if (!mappedFile.Open(source.m_diskPath))
+        {
+          error = "can't read [" + source.m_diskPath + "]";
+          return false;
+        }
+        data = mappedFile.GetData();
+        size = mappedFile.GetSize();
+      }
+
+      PakEntry entry{};
+      entry.m_pathHash = PakArchive::HashPath(source.m_path);
+      entry.m_size = size;
+      entry.m_pathOffset = static_cast<U32>(paths.size());
+      entry.m_pathLength = static_cast<U32>(source.m_path.size());
+      entry.m_compression = CompressionType::NONE;
+      paths += source.m_path;
+
+      const char* stored = data;
+      U64 storedSize = size;
+      if (compression == CompressionType::LZ4 && size > 0)
+      {
+        compressed.resize(Compression::GetLZ4Bound(size));
+        size_t compressedSize = Compression::CompressLZ4(data, size
+          , compressed.data(), compressed.size());
+        if (compressedSize > 0 && IsWorthCompressing(size, compressedSize))
+        {
+          entry.m_compression = CompressionType::LZ4;
+          stored = compressed.data();
+          storedSize = compressedSize;
+        }
+      }
+
+      U64 start = AlignUp(offset, 16);
+      U64 blockOffset = start % c_PAK_BLOCK_SIZE;
+      if (storedSize > c_PAK_BLOCK_SIZE ? blockOffset != 0
+        : blockOffset + storedSize > c_PAK_BLOCK_SIZE)
+      {
+        start = AlignUp(start, c_PAK_BLOCK_SIZE);
+      }
+      writePadding(start);
+
+      entry.m_offset = offset;
+      entry.m_storedSize = storedSize;
+      file.write(stored, storedSize);
+      offset += storedSize;
+      entries.emplace_back(entry);
+
+      m_totalSize += size;
+      m_storedSize += storedSize;
+    }
+
+    //Table of content, sorted by hash for the binary search
+    std::sort(entries.begin(), entries.end()
+      , [](const PakEntry& lhs, const PakEntry& rhs) { return lhs.m_pathHash < rhs.m_pathHash; });
+    writePadding(AlignUp(offset, alignof(PakEntry)));
+    header.m_tocOffset = offset;
+    header.m_tocSize = entries.size() * sizeof(PakEntry) + paths.size();
+    file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PakEntry));
+    file.write(paths.data(), paths.size());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    if (!file)
+    {
+      error = "failed writing [" + outputPath + "]";
+      return false;
+    }
+    return true;
+  }
+}
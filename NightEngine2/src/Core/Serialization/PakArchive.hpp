@@ -0,0 +1,125 @@
+/*!
+  @file PakArchive.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of PakArchive
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Serialization/Compression.hpp"
+#include "Core/Serialization/MappedFile.hpp"
+
+// Standard Headers
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NightEngine
+{
+  constexpr Container::U32 c_PAK_MAGIC = 0x4B41504E;      //"NPAK"
+  constexpr Container::U32 c_PAK_VERSION = 1;
+
+  //! @brief Entries no bigger than a block never cross a block boundary,
+  // bigger ones start on one. Reading a small file touch a single block.
+  constexpr Container::U64 c_PAK_BLOCK_SIZE = 64 * 1024;
+
+  //! @brief File layout: header, file data, entries sorted by (hash, path), path strings
+  struct PakHeader
+  {
+    Container::U32 m_magic;
+    Container::U32 m_version;
+    Container::U32 m_entryCount;
+    Container::U32 m_reserved;
+    Container::U64 m_tocOffset;     //Entries then paths
+    Container::U64 m_tocSize;
+  };
+
+  struct PakEntry
+  {
+    Container::U64  m_pathHash;
+    Container::U64  m_offset;
+    Container::U64  m_storedSize;   //Size in the archive
+    Container::U64  m_size;         //Size once decompressed
+    Container::U32  m_pathOffset;   //From the end of the entries
+    Container::U32  m_pathLength;
+    CompressionType m_compression;
+    Container::U32  m_reserved;
+  };
+
+  static_assert(sizeof(PakHeader) == 32, "PakHeader is read from the file as is");
+  static_assert(sizeof(PakEntry) == 48, "PakEntry is read from the file as is");
+
+  //! @brief Read-only archive, mapped as a whole
+  class PakArchive
+  {
+    public:
+      //! @brief Map the archive and validate the table of content
+      bool Open(const std::string& path);
+
+      //! @brief Unmap the archive
+      void Close(void);
+
+      //! @brief Check if the archive is open
+      bool IsOpen(void) const { return m_file.IsOpen(); }
+
+      //! @brief Binary search the table of content, nullptr if not found
+      const PakEntry* Find(std::string_view path) const;
+
+      //! @brief Number of files
+      size_t GetEntryCount(void) const { return m_entryCount; }
+
+      //! @brief Entry at index, sorted by path hash
+      const PakEntry& GetEntry(size_t index) const { return m_entries[index]; }
+
+      //! @brief Path of the entry
+      std::string_view GetPath(const PakEntry& entry) const;
+
+      //! @brief Bytes of the entry as stored, compressed or not
+      const char* GetStoredData(const PakEntry& entry) const;
+
+      //! @brief Decompress the entry into output of entry.m_size bytes
+      bool Decompress(const PakEntry& entry, char* output) const;
+
+      //! @brief Hash used for the table of content
+      static Container::U64 HashPath(std::string_view path);
+    private:
+      MappedFile      m_file;
+      const PakEntry* m_entries = nullptr;
+      const char*     m_paths = nullptr;
+      size_t          m_entryCount = 0;
+  };
+
+  //! @brief Build a PakArchive
+  class PakWriter
+  {
+    public:
+      //! @brief Pack the file on disk under path
+      void AddFile(const std::string& path, const std::string& diskPath);
+
+      //! @brief Pack the bytes under path
+      void AddData(const std::string& path, std::vector<char> data);
+
+      //! @brief Number of files added
+      size_t GetFileCount(void) const { return m_sources.size(); }
+
+      //! @brief Write the archive. Compressed files that don't shrink are stored.
+      // Return false and set error if a file can't be read or written.
+      bool Write(const std::string& outputPath, CompressionType compression
+        , std::string& error);
+
+      //! @brief Byte counts of the last Write
+      Container::U64 GetTotalSize(void) const { return m_totalSize; }
+      Container::U64 GetStoredSize(void) const { return m_storedSize; }
+    private:
+      struct Source
+      {
+        std::string       m_path;
+        std::string       m_diskPath;
+        std::vector<char> m_data;
+      };
+
+      std::vector<Source> m_sources;
+      Container::U64      m_totalSize = 0;
+      Container::U64      m_storedSize = 0;
+  };
+}
@@ -8,6 +8,7 @@
 
 #include "Core/Serialization/ResourceManager.hpp"
 #include "Core/Serialization/Serialization.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
 
 #include "Core/Container/MurmurHash2.hpp"
 #include "Core/Container/Hashmap.hpp"
@@ -17,7 +18,6 @@
 
 #include "Core/EC/Factory.hpp"
 
-#include <mutex>
 #include <future>
 
 namespace NightEngine
@@ -173,6 +173,13 @@ namespace NightEngine
 
   /////////////////////////////////////////////////////////////////
 
+  void ResourceManager::UnloadModelResource(const Container::String& filePath)
+  {
+    Container::Hashmap<U64, Model>& hashmap = GetContainer<Model>();
+    U64 key = Container::ConvertToHash(filePath.c_str(), filePath.size());
+    hashmap.erase(key);
+  }
+
   NightEngine::Rendering::Opengl::Model* ResourceManager::LoadModelResource(const Container::String& filePath)
   {
     Container::Hashmap<U64, Model>& hashmap = GetContainer<Model>();
@@ -203,30 +210,31 @@ namespace NightEngine
     return &(hashmap[key]);
   }
 
-  static std::mutex g_modelsMutex;
-  static void LoadModels_Task(Container::String filePath, U64 key)
-  {
-    Container::Hashmap<U64, Model>& hashmap = GetContainer<Model>();
+  //Touching one byte per page is enough to have the mapped file read
+  static const size_t c_PREFETCH_PAGE_SIZE = 4096;
 
-    //Load Mesh
-    Model newModel{ filePath, false };
-
-    std::lock_guard<std::mutex> guard(g_modelsMutex);
-    Debug::Log << Logger::MessageType::INFO
-      << "Loading Model: " << filePath << '\n';
-    hashmap.insert({ key, newModel });
+  FileView ResourceManager::PrefetchModelResource(const Container::String& filePath)
+  {
+    FileView cooked = GetAssetDatabase().LoadCooked(filePath);
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < cooked.GetSize(); offset += c_PREFETCH_PAGE_SIZE)
+    {
+      sink = sink + cooked.GetData()[offset];
+    }
+    return cooked;
   }
 
   void ResourceManager::PreloadModelsResourceAsync(const Container::Vector<Container::String>& filePaths)
   {
     Container::Hashmap<U64, Model>& hashmap = GetContainer<Model>();
-    Container::Vector<std::future<void>> futures;
+    Container::Vector<std::future<FileView>> futures;
 
     Debug::Log << Logger::MessageType::INFO
       << "**************************************************************\n";
     NightEngine::Utility::StopWatch stopWatch{ true };
     {
-      //Launch Async Tasks
+      //Launch Async Tasks, they only read the cooked files
+      Container::Vector<Container::String> unloaded;
       for (auto filePath : filePaths)
       {
         //Convert to U64 Hash key
@@ -236,13 +244,16 @@ namespace NightEngine
         auto it = hashmap.find(key);
         if (it == hashmap.end())
         {
-          futures.push_back(std::async(std::launch::async, LoadModels_Task, filePath, key));
+          futures.push_back(std::async(std::launch::async, PrefetchModelResource, filePath));
+          unloaded.emplace_back(filePath);
         }
       }
 
+      //Materials and GL objects are created here, on the thread with the context
       for (int i = 0; i < futures.size(); ++i)
       {
         futures[i].wait();
+        LoadModelResource(unloaded[i]);
       }
     }
     stopWatch.Stop();
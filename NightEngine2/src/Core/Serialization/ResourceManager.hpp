@@ -8,6 +8,7 @@
 #include "Graphics/Opengl/Texture.hpp"
 
 #include "Core/EC/Handle.hpp"
+#include "Core/Serialization/MappedFile.hpp"
 
 //Forward Declaration
 namespace NightEngine::Rendering::Opengl
@@ -46,7 +47,15 @@ namespace NightEngine
 
     //! @brief Static Function for Load and Cache Model
     static NightEngine::Rendering::Opengl::Model* LoadModelResource(const Container::String& filePath);
+
+    //! @brief Drop the cached Model, the next LoadModelResource read the file again
+    static void UnloadModelResource(const Container::String& filePath);
     
+    //! @brief Read the cooked files of the models across threads then build them on the calling thread
     static void PreloadModelsResourceAsync(const Container::Vector<Container::String>& filePaths);
+
+    //! @brief Cook if needed and read the cooked model, safe off the main thread.
+    // Only bytes, the Model with its Materials is built by LoadModelResource
+    static FileView PrefetchModelResource(const Container::String& filePath);
   };
 }
\ No newline at end of file
@@ -55,6 +55,13 @@ namespace NightEngine
 {
 	namespace Serialization
 	{
+    static thread_local Container::Vector<DeferredMaterialLoad>* t_deferredMaterialLoads = nullptr;
+
+    void SetDeferredMaterialLoads(Container::Vector<DeferredMaterialLoad>* loads)
+    {
+      t_deferredMaterialLoads = loads;
+    }
+
     DEFINE_DEFAULT_SERIALIZER(bool)
     DEFINE_DEFAULT_SERIALIZER(int)
     DEFINE_DEFAULT_SERIALIZER(unsigned)
@@ -264,7 +271,11 @@ namespace NightEngine
 
       //Find ValueObject Corresponding to Shaders
       auto it = obj.find("Shaders");
-      if (it != obj.end())
+      if (material.GetBaseShader().GetProgramID() != ~(0u))
+      {
+        //Reloading into a live material, shader edits come through the shader reload
+      }
+      else if (it != obj.end())
       {
         auto array = it->second.get_array();
         std::string vertShader;
@@ -377,7 +388,11 @@ namespace NightEngine
       {
         auto filePath = it->second.as<std::string>();
         FileSystem::RemoveFileDirectoryPath(filePath, FileSystem::DirectoryType::Materials);
-        if (filePath != "")
+        if (filePath != "" && t_deferredMaterialLoads != nullptr)
+        {
+          t_deferredMaterialLoads->emplace_back(DeferredMaterialLoad{ &matHandle, filePath });
+        }
+        else if (filePath != "")
         {
           matHandle = Material::LoadMaterial(filePath);
           auto mat = matHandle.Get();
@@ -7,6 +7,7 @@
 #pragma once
 #include "Core/Macros.hpp"
 #include "Core/EC/Handle.hpp"
+#include "Core/Container/Vector.hpp"
 
 #include "Core/Reflection/MetaType.hpp"
 #include "Core/Reflection/Variable.hpp"
@@ -161,5 +162,16 @@ namespace NightEngine
 
     template <>
     void DefaultDeserializer<NightEngine::EC::Handle<NightEngine::Rendering::Opengl::Material>>(ValueObject& valueObject, Reflection::Variable& variable);
+
+    //! @brief Material handle found while deserializing, loaded later on the main thread
+    struct DeferredMaterialLoad
+    {
+      NightEngine::EC::Handle<NightEngine::Rendering::Opengl::Material>* m_target;
+      std::string m_filePath;
+    };
+
+    //! @brief Queue the material loads of the calling thread into loads instead of
+    // loading them, materials need the GL context. nullptr to load immediately again
+    void SetDeferredMaterialLoads(Container::Vector<DeferredMaterialLoad>* loads);
 	}
 }
\ No newline at end of file
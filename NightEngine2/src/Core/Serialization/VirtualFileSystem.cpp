@@ -0,0 +1,276 @@
+/*!
+  @file VirtualFileSystem.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of VirtualFileSystem
+*/
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/PakArchive.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+
+namespace NightEngine
+{
+  DirectoryBackend::DirectoryBackend(std::string root)
+    : m_root(std::move(root))
+  {
+    if (!m_root.empty() && m_root.back() != '/')
+    {
+      m_root += '/';
+    }
+  }
+
+  bool DirectoryBackend::Exists(const std::string& path) const
+  {
+    std::error_code error;
+    return std::filesystem::is_regular_file(m_root + path, error);
+  }
+
+  FileView DirectoryBackend::Read(const std::string& path) const
+  {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(m_root + path))
+    {
+      return FileView();
+    }
+
+    const char* data = file->GetData();
+    size_t size = file->GetSize();
+    return FileView(data, size, std::move(file));
+  }
+
+  void DirectoryBackend::GetFiles(std::vector<std::string>& output) const
+  {
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_root, error);
+      it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+    {
+      if (error)
+      {
+        break;
+      }
+      if (it->is_regular_file(error))
+      {
+        output.emplace_back(std::filesystem::relative(it->path(), m_root, error).generic_string());
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  PakBackend::PakBackend(std::shared_ptr<PakArchive> archive)
+    : m_archive(std::move(archive))
+  {
+  }
+
+  bool PakBackend::Exists(const std::string& path) const
+  {
+    return m_archive->Find(path) != nullptr;
+  }
+
+  FileView PakBackend::Read(const std::string& path) const
+  {
+    const PakEntry* entry = m_archive->Find(path);
+    if (entry == nullptr)
+    {
+      return FileView();
+    }
+
+    //Stored file is a view into the mapping, the archive stay mapped as long as the view
+    if (entry->m_compression == CompressionType::NONE)
+    {
+      return FileView(m_archive->GetStoredData(*entry), entry->m_size, m_archive);
+    }
+
+    auto buffer = std::make_shared<std::vector<char>>(entry->m_size);
+    if (!m_archive->Decompress(*entry, buffer->data()))
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "PakBackend: corrupted file [" << path << "]\n";
+      return FileView();
+    }
+
+    const char* data = buffer->data();
+    return FileView(data, entry->m_size, std::move(buffer));
+  }
+
+  void PakBackend::GetFiles(std::vector<std::string>& output) const
+  {
+    for (size_t i = 0; i < m_archive->GetEntryCount(); ++i)
+    {
+      output.emplace_back(m_archive->GetPath(m_archive->GetEntry(i)));
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  namespace VirtualFileSystem
+  {
+    //Loaders can read from the job threads
+    static std::mutex g_mutex;
+    static std::vector<std::shared_ptr<IFileBackend>> g_backends;
+    static std::vector<std::string> g_fileList;
+    static bool g_fileListDirty = true;
+
+    void Initialize(void)
+    {
+      Mount(std::make_shared<DirectoryBackend>(PROJECT_DIR_SOURCE_ASSETS));
+
+      //Shipping builds read from the archives, they go on top of the loose files
+      std::vector<std::string> pakPaths;
+      std::error_code error;
+      for (auto& entry : std::filesystem::directory_iterator(PROJECT_DIR_SOURCE_ASSETS, error))
+      {
+        if (entry.path().extension() == ".pak")
+        {
+          pakPaths.emplace_back(entry.path().generic_string());
+        }
+      }
+      std::sort(pakPaths.begin(), pakPaths.end());
+      for (auto& pakPath : pakPaths)
+      {
+        MountPak(pakPath);
+      }
+    }
+
+    void Terminate(void)
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_backends.clear();
+      g_fileList.clear();
+      g_fileListDirty = true;
+    }
+
+    void Mount(std::shared_ptr<IFileBackend> backend)
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_backends.emplace_back(std::move(backend));
+      g_fileListDirty = true;
+    }
+
+    bool MountPak(const std::string& pakPath)
+    {
+      auto archive = std::make_shared<PakArchive>();
+      if (!archive->Open(pakPath))
+      {
+        Debug::Log << Logger::MessageType::ERROR_MSG
+          << "VirtualFileSystem: invalid pak archive [" << pakPath << "]\n";
+        return false;
+      }
+
+      Debug::Log << Logger::MessageType::INFO
+        << "VirtualFileSystem: mounted [" << pakPath << "], "
+        << archive->GetEntryCount() << " files\n";
+      Mount(std::make_shared<PakBackend>(std::move(archive)));
+      return true;
+    }
+
+    FileView Read(const std::string& path)
+    {
+      std::string virtualPath = ToVirtualPath(path);
+      std::vector<std::shared_ptr<IFileBackend>> backends;
+      {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        backends = g_backends;
+      }
+
+      for (auto it = backends.rbegin(); it != backends.rend(); ++it)
+      {
+        FileView view = (*it)->Read(virtualPath);
+        if (view.IsValid())
+        {
+          return view;
+        }
+      }
+      return FileView();
+    }
+
+    bool Exists(const std::string& path)
+    {
+      std::string virtualPath = ToVirtualPath(path);
+      std::lock_guard<std::mutex> lock(g_mutex);
+      for (auto it = g_backends.rbegin(); it != g_backends.rend(); ++it)
+      {
+        if ((*it)->Exists(virtualPath))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void GetFiles(const std::string& directory, bool recursive
+      , std::vector<std::string>& output)
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      if (g_fileListDirty)
+      {
+        g_fileList.clear();
+        for (auto& backend : g_backends)
+        {
+          backend->GetFiles(g_fileList);
+        }
+        std::sort(g_fileList.begin(), g_fileList.end());
+        g_fileList.erase(std::unique(g_fileList.begin(), g_fileList.end()), g_fileList.end());
+        g_fileListDirty = false;
+      }
+
+      //Sorted, the directory is one contiguous range
+      std::string prefix = ToVirtualPath(directory);
+      if (!prefix.empty() && prefix.back() != '/')
+      {
+        prefix += '/';
+      }
+      for (auto it = std::lower_bound(g_fileList.begin(), g_fileList.end(), prefix);
+        it != g_fileList.end() && it->compare(0, prefix.size(), prefix) == 0; ++it)
+      {
+        if (recursive || it->find('/', prefix.size()) == std::string::npos)
+        {
+          output.emplace_back(*it);
+        }
+      }
+    }
+
+    void InvalidateFileList(void)
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      g_fileListDirty = true;
+    }
+
+    std::string ToVirtualPath(std::string_view path)
+    {
+      std::string result{ path };
+      std::replace(result.begin(), result.end(), '\\', '/');
+
+      //Full path under the asset root
+      std::string_view root{ PROJECT_DIR_SOURCE_ASSETS };
+      if (result.compare(0, root.size(), root) == 0)
+      {
+        result.erase(0, root.size());
+      }
+
+      while (result.compare(0, 2, "./") == 0)
+      {
+        result.erase(0, 2);
+      }
+
+      //"a//b" happen when a path is joined to a root with a trailing '/',
+      //"a/./b" when a loader join its directory to a relative reference
+      size_t pos;
+      while ((pos = result.find("//")) != std::string::npos)
+      {
+        result.erase(pos, 1);
+      }
+      while ((pos = result.find("/./")) != std::string::npos)
+      {
+        result.erase(pos, 2);
+      }
+      return result;
+    }
+  }
+}
@@ -0,0 +1,96 @@
+/*!
+  @file VirtualFileSystem.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of VirtualFileSystem
+*/
+#pragma once
+
+#include "Core/Serialization/MappedFile.hpp"
+
+// Standard Headers
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+namespace NightEngine
+{
+  class PakArchive;
+
+  //! @brief Source of files, paths are relative to the mount root with '/'
+  class IFileBackend
+  {
+    public:
+      virtual ~IFileBackend(void) = default;
+
+      //! @brief Check if the file exist
+      virtual bool Exists(const std::string& path) const = 0;
+
+      //! @brief Read the whole file, invalid view if it doesn't exist
+      virtual FileView Read(const std::string& path) const = 0;
+
+      //! @brief Append every file path
+      virtual void GetFiles(std::vector<std::string>& output) const = 0;
+  };
+
+  //! @brief Loose files under a directory, read through a mapping
+  class DirectoryBackend: public IFileBackend
+  {
+    public:
+      //! @brief Constructor
+      explicit DirectoryBackend(std::string root);
+
+      virtual bool Exists(const std::string& path) const override;
+      virtual FileView Read(const std::string& path) const override;
+      virtual void GetFiles(std::vector<std::string>& output) const override;
+    private:
+      std::string m_root;
+  };
+
+  //! @brief Files of a PakArchive, stored files are viewed in place
+  class PakBackend: public IFileBackend
+  {
+    public:
+      //! @brief Constructor, archive must be open
+      explicit PakBackend(std::shared_ptr<PakArchive> archive);
+
+      virtual bool Exists(const std::string& path) const override;
+      virtual FileView Read(const std::string& path) const override;
+      virtual void GetFiles(std::vector<std::string>& output) const override;
+    private:
+      std::shared_ptr<PakArchive> m_archive;
+  };
+
+  //! @brief Asset files from the mounted backends, the last mounted one win.
+  // Paths are relative to the asset root, e.g. "Textures/Blank/000.png".
+  namespace VirtualFileSystem
+  {
+    //! @brief Mount the asset directory, then every .pak file in it
+    void Initialize(void);
+
+    //! @brief Unmount everything
+    void Terminate(void);
+
+    //! @brief Add a backend on top of the mounted ones
+    void Mount(std::shared_ptr<IFileBackend> backend);
+
+    //! @brief Open and mount a pak archive, false if it isn't a valid one
+    bool MountPak(const std::string& pakPath);
+
+    //! @brief Read the file from the top-most backend that has it
+    FileView Read(const std::string& path);
+
+    //! @brief Check if any backend has the file
+    bool Exists(const std::string& path);
+
+    //! @brief Files under directory from the cached listing, sorted
+    void GetFiles(const std::string& directory, bool recursive
+      , std::vector<std::string>& output);
+
+    //! @brief List the backends again on the next GetFiles, call after files are added
+    void InvalidateFileList(void);
+
+    //! @brief Path relative to the asset root, accept full paths under the root
+    std::string ToVirtualPath(std::string_view path);
+  }
+}
@@ -0,0 +1,91 @@
+/*!
+  @file CpuFeatures.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of CpuFeatures
+*/
+#include "Core/Utility/CpuFeatures.hpp"
+
+#include <atomic>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+  #include <immintrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <cpuid.h>
+#endif
+
+namespace NightEngine
+{
+  namespace CpuFeatures
+  {
+    static std::atomic<bool> g_avx2Enabled{ true };
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    static void CpuId(int leaf, int subleaf, unsigned (&regs)[4])
+    {
+      int values[4];
+      __cpuidex(values, leaf, subleaf);
+      for (int i = 0; i < 4; ++i)
+      {
+        regs[i] = static_cast<unsigned>(values[i]);
+      }
+    }
+
+    static unsigned long long ReadXcr0(void) { return _xgetbv(0); }
+#elif defined(__x86_64__) || defined(__i386__)
+    static void CpuId(int leaf, int subleaf, unsigned (&regs)[4])
+    {
+      __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    }
+
+    static unsigned long long ReadXcr0(void)
+    {
+      unsigned eax, edx;
+      __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+      return (static_cast<unsigned long long>(edx) << 32) | eax;
+    }
+#endif
+
+    static bool QueryAvx2(void)
+    {
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || defined(__x86_64__) || defined(__i386__)
+      unsigned regs[4];
+      CpuId(0, 0, regs);
+      if (regs[0] < 7)
+      {
+        return false;
+      }
+
+      //The OS has to save the ymm registers (OSXSAVE, then XCR0 bits 1 and 2)
+      CpuId(1, 0, regs);
+      bool osxsave = (regs[2] & (1u << 27)) != 0;
+      bool avx = (regs[2] & (1u << 28)) != 0;
+      if (!osxsave || !avx || (ReadXcr0() & 0x6) != 0x6)
+      {
+        return false;
+      }
+
+      CpuId(7, 0, regs);
+      return (regs[1] & (1u << 5)) != 0;
+#else
+      return false;
+#endif
+    }
+
+    bool HasAvx2(void)
+    {
+      static const bool s_hasAvx2 = QueryAvx2();
+      return s_hasAvx2;
+    }
+
+    bool IsAvx2Enabled(void)
+    {
+      return g_avx2Enabled.load(std::memory_order_relaxed) && HasAvx2();
+    }
+
+    void SetAvx2Enabled(bool enabled)
+    {
+      g_avx2Enabled.store(enabled, std::memory_order_relaxed);
+    }
+  }
+}
@@ -0,0 +1,22 @@
+/*!
+  @file CpuFeatures.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of CpuFeatures
+*/
+#pragma once
+
+namespace NightEngine
+{
+  namespace CpuFeatures
+  {
+    //! @brief Check if the cpu and the OS support AVX2, queried once
+    bool HasAvx2(void);
+
+    //! @brief Check if the AVX2 kernels should run, HasAvx2 unless turned off
+    bool IsAvx2Enabled(void);
+
+    //! @brief Turn the AVX2 kernels off/on, for comparing against the SSE2 path.
+    // Can't enable it on a cpu without AVX2
+    void SetAvx2Enabled(bool enabled);
+  }
+}
@@ -0,0 +1,222 @@
+/*!
+  @file JobSystem.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of JobSystem
+*/
+#include "Core/Utility/JobSystem.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/Allocator.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace NightEngine
+{
+  namespace JobSystem
+  {
+    //! @brief A batch of a ParallelFor call
+    struct Job
+    {
+      const RangeFN*       m_fn;
+      size_t               m_begin;
+      size_t               m_end;
+      std::atomic<size_t>* m_remaining;
+      Job*                 m_next;
+    };
+
+    static Container::Vector<std::thread> g_workers;
+    static std::mutex                     g_jobsMutex;
+    static std::condition_variable        g_jobsCondition;
+    static bool                           g_running = false;
+
+    //FIFO of pooled jobs, the pool keep its pages so steady state frames don't allocate
+    static Container::PoolAllocator       g_jobPool{ sizeof(Job), 64 };
+    static Job*                           g_jobsHead = nullptr;
+    static Job*                           g_jobsTail = nullptr;
+
+    static thread_local unsigned          t_threadIndex = 0;
+
+    //Heap allocations of the jobs run by the workers, see GetWorkerAllocationCount
+    static std::atomic<Container::U64>    g_workerAllocationCount{ 0 };
+
+    //! @brief Pop the oldest job into job, g_jobsMutex must be held
+    static bool PopJobLocked(Job& job)
+    {
+      Job* front = g_jobsHead;
+      if (front == nullptr)
+      {
+        return false;
+      }
+
+      g_jobsHead = front->m_next;
+      if (g_jobsHead == nullptr)
+      {
+        g_jobsTail = nullptr;
+      }
+
+      job = *front;
+      g_jobPool.Deallocate(front);
+      return true;
+    }
+
+    //! @brief Append a job, g_jobsMutex must be held
+    static void PushJobLocked(const Job& job)
+    {
+      Job* node = g_jobPool.New<Job>(job);
+      node->m_next = nullptr;
+      if (g_jobsTail != nullptr)
+      {
+        g_jobsTail->m_next = node;
+      }
+      else
+      {
+        g_jobsHead = node;
+      }
+      g_jobsTail = node;
+    }
+
+    static bool TryPopJob(Job& job)
+    {
+      std::lock_guard<std::mutex> guard(g_jobsMutex);
+      return PopJobLocked(job);
+    }
+
+    static void ExecuteJob(const Job& job)
+    {
+      Container::U64 allocations = Container::TaggedHeap::GetThreadAllocationCount();
+      (*job.m_fn)(job.m_begin, job.m_end);
+
+      //Added before the batch is reported done, ParallelFor return with it counted
+      if (t_threadIndex != 0)
+      {
+        g_workerAllocationCount.fetch_add(Container::TaggedHeap::GetThreadAllocationCount() - allocations
+          , std::memory_order_relaxed);
+      }
+      job.m_remaining->fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    static void WorkerLoop(unsigned threadIndex)
+    {
+      t_threadIndex = threadIndex;
+
+      while (true)
+      {
+        Job job;
+        {
+          std::unique_lock<std::mutex> lock(g_jobsMutex);
+          g_jobsCondition.wait(lock, [] { return !g_running || g_jobsHead != nullptr; });
+
+          if (!PopJobLocked(job))
+          {
+            return;
+          }
+        }
+
+        ExecuteJob(job);
+      }
+    }
+
+    void Initialize(unsigned workerCount)
+    {
+      if (g_running)
+      {
+        return;
+      }
+
+      if (workerCount == 0)
+      {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+      }
+
+      Debug::Log << "JobSystem::Initialize(" << workerCount << " workers)\n";
+
+      g_running = true;
+      g_workers.reserve(workerCount);
+      for (unsigned i = 0; i < workerCount; ++i)
+      {
+        g_workers.emplace_back(WorkerLoop, i + 1);
+      }
+    }
+
+    void Terminate(void)
+    {
+      {
+        std::lock_guard<std::mutex> guard(g_jobsMutex);
+        g_running = false;
+      }
+      g_jobsCondition.notify_all();
+
+      for (auto& worker : g_workers)
+      {
+        worker.join();
+      }
+      g_workers.clear();
+    }
+
+    unsigned GetWorkerCount(void)
+    {
+      return static_cast<unsigned>(g_workers.size());
+    }
+
+    unsigned GetThreadIndex(void)
+    {
+      return t_threadIndex;
+    }
+
+    Container::U64 GetWorkerAllocationCount(void)
+    {
+      return g_workerAllocationCount.load(std::memory_order_relaxed);
+    }
+
+    void ParallelFor(size_t count, size_t minBatchSize, const RangeFN& fn)
+    {
+      if (count == 0)
+      {
+        return;
+      }
+
+      //Split evenly over every thread, but never below minBatchSize
+      size_t threadCount = g_workers.size() + 1;
+      size_t batchSize = std::max<size_t>(minBatchSize
+        , (count + threadCount - 1) / threadCount);
+      size_t batchCount = (count + batchSize - 1) / batchSize;
+
+      if (g_workers.empty() || batchCount < 2)
+      {
+        fn(0, count);
+        return;
+      }
+
+      std::atomic<size_t> remaining{ batchCount };
+      {
+        std::lock_guard<std::mutex> guard(g_jobsMutex);
+        for (size_t i = 0; i < batchCount; ++i)
+        {
+          size_t begin = i * batchSize;
+          PushJobLocked(Job{ &fn, begin
+            , std::min(begin + batchSize, count), &remaining, nullptr });
+        }
+      }
+      g_jobsCondition.notify_all();
+
+      //Help out until our own batches are done, this also make nested ParallelFor safe
+      while (remaining.load(std::memory_order_acquire) > 0)
+      {
+        Job job;
+        if (TryPopJob(job))
+        {
+          ExecuteJob(job);
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+}
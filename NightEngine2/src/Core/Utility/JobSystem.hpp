@@ -0,0 +1,60 @@
+/*!
+  @file JobSystem.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of JobSystem
+*/
+#pragma once
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace NightEngine
+{
+  namespace JobSystem
+  {
+    //! @brief Function executed over the range [begin, end). Only refer to the callable,
+    // ParallelFor block until every batch is done so a lambda temporary outlive it and
+    // no std::function get allocated per call
+    class RangeFN
+    {
+    public:
+      template<typename FN, typename = std::enable_if_t<!std::is_same_v<std::decay_t<FN>, RangeFN>>>
+      RangeFN(FN&& fn)
+        : m_callable(const_cast<void*>(static_cast<const void*>(std::addressof(fn))))
+        , m_invoke([](void* callable, size_t begin, size_t end)
+          {
+            (*static_cast<std::remove_reference_t<FN>*>(callable))(begin, end);
+          })
+      {
+      }
+
+      void operator()(size_t begin, size_t end) const { m_invoke(m_callable, begin, end); }
+    private:
+      void* m_callable;
+      void (*m_invoke)(void* callable, size_t begin, size_t end);
+    };
+
+    //! @brief Spawn the worker threads, 0 means (hardware threads - 1)
+    void Initialize(unsigned workerCount = 0);
+
+    //! @brief Join all the worker threads
+    void Terminate(void);
+
+    //! @brief Amount of worker threads (not including the calling thread)
+    unsigned GetWorkerCount(void);
+
+    //! @brief Index of the current thread, 0 is the calling thread, 1..n are the workers
+    unsigned GetThreadIndex(void);
+
+    //! @brief Heap allocations made by the workers while running jobs, the calling thread
+    // count its own with TaggedHeap::GetThreadAllocationCount. 0 without MEMORY_TRACKING_ENABLED
+    Container::U64 GetWorkerAllocationCount(void);
+
+    //! @brief Split [0, count) into batches of at least minBatchSize and execute
+    // them across the workers, the calling thread also help and block until done.
+    // Run inline when the JobSystem is not initialized.
+    void ParallelFor(size_t count, size_t minBatchSize, const RangeFN& fn);
+  }
+}
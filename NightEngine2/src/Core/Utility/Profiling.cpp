@@ -6,74 +6,403 @@
 #include "Core/Utility/Profiling.hpp"
 #include "Core/Logger.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace NightEngine::Container;
+
 namespace NightEngine
 {
 	namespace Profiling
 	{
-    static std::ofstream g_outputStream;
+    //Retired rings kept around so their events can still be captured
+    static const size_t c_MAX_RETIRED_RINGS = 8;
 
-    Instrumentor& Instrumentor::Get()
+    std::atomic<bool> g_profilerEnabled{ true };
+    thread_local ThreadEventRing* t_threadRing = nullptr;
+
+    static std::mutex                                    g_ringsMutex;
+    static Vector<std::unique_ptr<ThreadEventRing>>      g_rings;
+    static U32                                           g_nextThreadIndex = 0;
+
+    static std::atomic<U64> g_frameTimestamps[c_FRAME_HISTORY];
+    static std::atomic<U64> g_frameCount{ 0 };
+    static std::atomic<U32> g_mainThreadIndex{ 0 };
+
+    //Reference point for tick to microsecond conversion
+    static const U64 g_startTicks = ReadTimestamp();
+    static const std::chrono::steady_clock::time_point g_startClock
+      = std::chrono::steady_clock::now();
+
+    //! @brief Flag the ring as retired when the owner thread exit
+    struct RingRetirer
     {
-      static Instrumentor instance;
-      return instance;
+      ~RingRetirer()
+      {
+        if (t_threadRing != nullptr)
+        {
+          t_threadRing->m_retired.store(true, std::memory_order_release);
+          t_threadRing = nullptr;
+        }
+      }
+    };
+
+    //Set by Calibrate(), 0 until then
+    static std::atomic<double> g_ticksPerMicro{ 0.0 };
+
+    static double GetTicksPerMicrosecond(void)
+    {
+      double ticksPerMicro = g_ticksPerMicro.load(std::memory_order_relaxed);
+      if (ticksPerMicro > 0.0)
+      {
+        return ticksPerMicro;
+      }
+
+      //Not calibrated yet, use the reference so far without waiting
+      double micro = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - g_startClock).count();
+      return micro > 0.0 ? static_cast<double>(ReadTimestamp() - g_startTicks) / micro : 1.0;
     }
 
-    void Instrumentor::BeginSession(const std::string& sessionName
-      , const std::string& filepath)
+    static void AppendEscaped(std::string& output, const char* str)
     {
-      m_session = Session{ sessionName, filepath };
+      for (; *str != '\0'; ++str)
+      {
+        if (*str == '"' || *str == '\\')
+        {
+          output += '\\';
+        }
+        output += *str;
+      }
+    }
 
-      g_outputStream.open(filepath);
-      WriteHeader();
+    /////////////////////////////////////////////////////////////////////
 
-      m_sessionActive = true;
-      Debug::Log << "BeginProfilingSession: " << sessionName << "\n";
+    ThreadEventRing* CreateThreadRing(void)
+    {
+      thread_local RingRetirer t_retirer;
+      (void)t_retirer;
+
+      std::unique_ptr<ThreadEventRing> ring = std::make_unique<ThreadEventRing>();
+      ThreadEventRing* ringPtr = ring.get();
+      {
+        std::lock_guard<std::mutex> guard(g_ringsMutex);
+        ring->m_threadIndex = g_nextThreadIndex++;
+
+        //Keep only the newest retired rings, short lived threads would leak otherwise
+        size_t retiredCount = std::count_if(g_rings.begin(), g_rings.end()
+          , [](const std::unique_ptr<ThreadEventRing>& r) { return r->m_retired.load(std::memory_order_acquire); });
+        for (auto it = g_rings.begin(); it != g_rings.end() && retiredCount > c_MAX_RETIRED_RINGS;)
+        {
+          if ((*it)->m_retired.load(std::memory_order_acquire))
+          {
+            it = g_rings.erase(it);
+            --retiredCount;
+          }
+          else
+          {
+            ++it;
+          }
+        }
+
+        g_rings.emplace_back(std::move(ring));
+      }
+
+      t_threadRing = ringPtr;
+      return ringPtr;
     }
 
-    void Instrumentor::EndSession()
+    void MarkFrame(void)
     {
-      Debug::Log << "EndProfilingSession: " << m_session.m_sessionName << "\n";
+      if (!IsEnabled())
+      {
+        return;
+      }
+
+      ThreadEventRing* ring = t_threadRing;
+      if (ring == nullptr)
+      {
+        ring = CreateThreadRing();
+      }
+      g_mainThreadIndex.store(ring->m_threadIndex, std::memory_order_relaxed);
 
-      WriteFooter();
-      g_outputStream.close();
-      m_profileCount = 0;
+      //Same timestamp for the event and the frame history
+      U64 timestamp = ReadTimestamp();
+      PackedEvent event = PackEvent(EventType::FRAME, timestamp, "Frame");
+      WriteSlots(*ring, &event, 1);
 
-      m_sessionActive = false;
+      U64 frame = g_frameCount.load(std::memory_order_relaxed);
+      g_frameTimestamps[frame % c_FRAME_HISTORY].store(timestamp, std::memory_order_relaxed);
+      g_frameCount.store(frame + 1, std::memory_order_release);
+    }
+
+    U64 GetFrameCount(void)
+    {
+      return g_frameCount.load(std::memory_order_acquire);
+    }
+
+    U64 GetFrameTimestamp(U32 framesAgo)
+    {
+      //The oldest slot may be overwritten by the next frame
+      U64 frameCount = GetFrameCount();
+      if (framesAgo >= frameCount || framesAgo >= c_FRAME_HISTORY - 1)
+      {
+        return 0;
+      }
+
+      return g_frameTimestamps[(frameCount - 1 - framesAgo) % c_FRAME_HISTORY]
+        .load(std::memory_order_relaxed);
+    }
+
+    U32 GetMainThreadIndex(void)
+    {
+      return g_mainThreadIndex.load(std::memory_order_relaxed);
+    }
+
+    void Calibrate(void)
+    {
+      //Need a few milliseconds of reference for a stable ratio
+      auto elapsed = std::chrono::steady_clock::now() - g_startClock;
+      if (elapsed < std::chrono::milliseconds(10))
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10) - elapsed);
+      }
+
+      U64 ticks = ReadTimestamp() - g_startTicks;
+      double micro = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - g_startClock).count();
+      g_ticksPerMicro.store(static_cast<double>(ticks) / micro, std::memory_order_relaxed);
+    }
+
+    double TicksToMicroseconds(U64 ticks)
+    {
+      return static_cast<double>(ticks) / GetTicksPerMicrosecond();
     }
 
-    void Instrumentor::WriteProfile(const ProfileData& data)
+    void CaptureEvents(U64 beginTimestamp, U64 endTimestamp
+      , Vector<CapturedEvent>& output)
     {
-      if (m_sessionActive)
+      struct IndexedEvent
       {
-        if (m_profileCount++ > 0)
+        U64         m_index;
+        PackedEvent m_event;
+      };
+      Vector<IndexedEvent> backward;
+
+      std::lock_guard<std::mutex> guard(g_ringsMutex);
+      for (auto& ring : g_rings)
+      {
+        //Walk backward from the newest event until it is older than the range
+        backward.clear();
+        U64 head = ring->m_head.load(std::memory_order_acquire);
+        U64 oldest = head > c_THREAD_RING_CAPACITY ? head - c_THREAD_RING_CAPACITY : 0;
+        for (U64 i = head; i > oldest; --i)
         {
-          g_outputStream << ",";
+          const PackedEvent& ev = ring->m_events[(i - 1) & (c_THREAD_RING_CAPACITY - 1)];
+          EventType type = static_cast<EventType>(ev.m_timestampType >> c_EVENT_TYPE_SHIFT);
+          if (type != EventType::COUNTER_VALUE
+            && (ev.m_timestampType & c_TIMESTAMP_MASK) < beginTimestamp)
+          {
+            break;
+          }
+          backward.emplace_back(IndexedEvent{ i - 1, ev });
         }
 
-        g_outputStream << "{";
-        g_outputStream << "\"cat\":\"function\",";
-        g_outputStream << "\"dur\":" << (data.m_elapsedTime) << ',';
-        g_outputStream << "\"name\":\"" << data.m_name << "\",";
-        g_outputStream << "\"ph\":\"X\",";
-        g_outputStream << "\"pid\":0,";
-        g_outputStream << "\"tid\":" << data.m_threadId << ",";
-        g_outputStream << "\"ts\":" << data.m_startTime;
-        g_outputStream << "}";
-
-        g_outputStream.flush();
+        //Slot i is overwritten once slot i + capacity is claimed, anything the owner
+        //thread claimed over while copying may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        U64 claimed = ring->m_claimed.load(std::memory_order_relaxed);
+        U64 valid = claimed > c_THREAD_RING_CAPACITY ? claimed - c_THREAD_RING_CAPACITY : 0;
+
+        for (auto it = backward.rbegin(); it != backward.rend(); ++it)
+        {
+          ProfileEvent event{ it->m_event.m_timestampType & c_TIMESTAMP_MASK, it->m_event.m_name
+            , static_cast<EventType>(it->m_event.m_timestampType >> c_EVENT_TYPE_SHIFT), 0.0f };
+          if (it->m_index < valid || event.m_type == EventType::COUNTER_VALUE
+            || event.m_timestamp >= endTimestamp)
+          {
+            continue;
+          }
+
+          //The value is in the next slot, published together with the counter
+          if (event.m_type == EventType::COUNTER)
+          {
+            if (std::next(it) == backward.rend())
+            {
+              continue;
+            }
+            U32 valueBits = static_cast<U32>(std::next(it)->m_event.m_timestampType);
+            std::memcpy(&event.m_value, &valueBits, sizeof(valueBits));
+          }
+          output.emplace_back(CapturedEvent{ event, ring->m_threadIndex });
+        }
       }
     }
 
-    void Instrumentor::WriteHeader()
+    bool WriteChromeTrace(const Vector<CapturedEvent>& events
+      , const std::string& filePath)
     {
-      g_outputStream << "{\"otherData\": {},\"traceEvents\":[";
-      g_outputStream.flush();
+      double ticksPerMicro = GetTicksPerMicrosecond();
+      U32 mainThreadIndex = GetMainThreadIndex();
+
+      std::string json;
+      json.reserve(events.size() * 96 + 256);
+      json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+      char buffer[128];
+      bool first = true;
+      auto BeginEvent = [&](const char* name, const char* phase, U32 tid, U64 timestamp)
+      {
+        double ts = static_cast<double>(static_cast<I64>(timestamp - g_startTicks)) / ticksPerMicro;
+        json += first ? "{\"name\":\"" : ",\n{\"name\":\"";
+        first = false;
+        AppendEscaped(json, name);
+        snprintf(buffer, sizeof(buffer), "\",\"ph\":\"%s\",\"pid\":0,\"tid\":%u,\"ts\":%.3f"
+          , phase, tid, ts);
+        json += buffer;
+      };
+
+      //Zones still open at the end of the capture are closed at the last timestamp,
+      // ends without a begin (started before the capture) are dropped
+      Vector<U32> threadIndices;
+      Vector<Vector<const char*>> openZones;
+      U64 lastTimestamp = 0;
+      for (auto& captured : events)
+      {
+        const ProfileEvent& ev = captured.m_event;
+        U32 tid = captured.m_threadIndex;
+        lastTimestamp = std::max(lastTimestamp, ev.m_timestamp);
+
+        auto found = std::find(threadIndices.begin(), threadIndices.end(), tid);
+        size_t slot = static_cast<size_t>(found - threadIndices.begin());
+        if (found == threadIndices.end())
+        {
+          threadIndices.emplace_back(tid);
+          openZones.emplace_back();
+        }
+        auto& stack = openZones[slot];
+
+        switch (ev.m_type)
+        {
+        case EventType::ZONE_BEGIN:
+          stack.emplace_back(ev.m_name);
+          BeginEvent(ev.m_name, "B", tid, ev.m_timestamp);
+          json += "}";
+          break;
+        case EventType::ZONE_END:
+          if (!stack.empty())
+          {
+            stack.pop_back();
+            BeginEvent(ev.m_name, "E", tid, ev.m_timestamp);
+            json += "}";
+          }
+          break;
+        case EventType::COUNTER:
+          BeginEvent(ev.m_name, "C", tid, ev.m_timestamp);
+          snprintf(buffer, sizeof(buffer), ",\"args\":{\"value\":%g}}", ev.m_value);
+          json += buffer;
+          break;
+        case EventType::FRAME:
+          BeginEvent(ev.m_name, "i", tid, ev.m_timestamp);
+          json += ",\"s\":\"g\"}";
+          break;
+        }
+      }
+
+      for (size_t i = 0; i < threadIndices.size(); ++i)
+      {
+        for (auto it = openZones[i].rbegin(); it != openZones[i].rend(); ++it)
+        {
+          BeginEvent(*it, "E", threadIndices[i], lastTimestamp);
+          json += "}";
+        }
+
+        //Thread name metadata
+        json += first ? "{" : ",\n{";
+        first = false;
+        snprintf(buffer, sizeof(buffer)
+          , "\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}"
+          , threadIndices[i], threadIndices[i] == mainThreadIndex ? "Main Thread" : "Thread"
+          , threadIndices[i]);
+        json += buffer;
+      }
+      json += "\n]}\n";
+
+      std::ofstream outputStream(filePath, std::ios::binary);
+      if (!outputStream.is_open())
+      {
+        Debug::Log << Logger::MessageType::ERROR_MSG
+          << "Profiling: Failed to open " << filePath << '\n';
+        return false;
+      }
+      outputStream.write(json.data(), json.size());
+      return true;
     }
 
-    void Instrumentor::WriteFooter()
+    bool CaptureLastFrames(U32 frameCount, const std::string& filePath)
     {
-      g_outputStream << "]}";
-      g_outputStream.flush();
+      //Only complete frames, the current frame is still recording
+      U64 endTimestamp = GetFrameTimestamp(0);
+      U64 beginTimestamp = GetFrameTimestamp(frameCount);
+      if (endTimestamp == 0)
+      {
+        endTimestamp = ReadTimestamp();
+      }
+
+      Vector<CapturedEvent> events;
+      CaptureEvents(beginTimestamp, endTimestamp, events);
+      bool result = WriteChromeTrace(events, filePath);
+      ReleaseRetiredRings();
+
+      Debug::Log << "Profiling::CaptureLastFrames(" << frameCount << "): "
+        << events.size() << " events to " << filePath << '\n';
+      return result;
+    }
+
+    void ReleaseRetiredRings(void)
+    {
+      std::lock_guard<std::mutex> guard(g_ringsMutex);
+      g_rings.erase(std::remove_if(g_rings.begin(), g_rings.end()
+        , [](const std::unique_ptr<ThreadEventRing>& ring)
+        {
+          return ring->m_retired.load(std::memory_order_acquire);
+        }), g_rings.end());
+    }
+
+    /////////////////////////////////////////////////////////////////////
+
+    Instrumentor& Instrumentor::Get()
+    {
+      static Instrumentor instance;
+      return instance;
+    }
+
+    void Instrumentor::BeginSession(const std::string& sessionName
+      , const std::string& filepath)
+    {
+      m_session = Session{ sessionName, filepath };
+      m_sessionStart = ReadTimestamp();
+
+      m_sessionActive = true;
+      Debug::Log << "BeginProfilingSession: " << sessionName << "\n";
+    }
+
+    void Instrumentor::EndSession()
+    {
+      Debug::Log << "EndProfilingSession: " << m_session.m_sessionName << "\n";
+
+      Vector<CapturedEvent> events;
+      CaptureEvents(m_sessionStart, ReadTimestamp(), events);
+      WriteChromeTrace(events, m_session.m_filePath);
+      ReleaseRetiredRings();
+
+      m_sessionActive = false;
     }
 
 	} // Profiling
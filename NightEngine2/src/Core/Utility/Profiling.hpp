@@ -5,19 +5,32 @@
 */
 #pragma once
 #include "Core/Macros.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/Vector.hpp"
 
-//TODO: remove this, what a shame to include 2 huge files just for thread id
-#include <thread>
-#include <functional>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <cstring>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
 
 //! @brief Macros for getting global profiling instrumentor
 #define GET_GLOBAL_PROFILER() NightEngine::Profiling::Instrumentor::Get()
 
-#if DEBUG_MODE
+//! @brief Indirection so __LINE__ get expanded before pasting
+#define PROFILE_CONCAT_INNER(X,Y) X##Y
+#define PROFILE_CONCAT(X,Y) PROFILE_CONCAT_INNER(X,Y)
+
+#if PROFILER_ENABLED
 //! @brief Macros for starting a profiling session
 #define PROFILE_SESSION_BEGIN(DESCRIPTION)	\
   GET_GLOBAL_PROFILER().BeginSession(STR_INNER(DESCRIPTION) \
-, NightEngine::FileSystem::GetFilePath( STR_CAT(DESCRIPTION, .json) \
+, NightEngine::FileSystem::GetFilePath( STR_INNER(DESCRIPTION) ".json" \
   , NightEngine::FileSystem::DirectoryType::Assets))
 
 //! @brief Macros for ending a profiling session
@@ -25,41 +38,233 @@
   GET_GLOBAL_PROFILER().EndSession()
 
 //! @brief Macros for profiling a block of code and record it
-  #define PROFILE_BLOCK_INSTRUMENT(DESCRIPTION)	\
-  for (auto p = std::make_pair(false                                      \
-    , NightEngine::Utility::StopWatch{ true });                                  \
-	    !(p.first); p.first = true, p.second.Stop()												  \
-	  , GET_GLOBAL_PROFILER().WriteProfile(                                 \
-      NightEngine::Profiling::ProfileData{DESCRIPTION                            \
-    ,p.second.GetStartTimeMicro(), p.second.GetElapsedTimeMicro(), std::hash<std::thread::id>{}(std::this_thread::get_id()) }))
+#define PROFILE_BLOCK_INSTRUMENT(DESCRIPTION)	\
+  for (NightEngine::Profiling::ScopedZone profileBlock{ DESCRIPTION }; \
+    !profileBlock.m_blockDone; profileBlock.m_blockDone = true)
+
+//! @brief Record a zone until the end of the current scope, NAME must be a string literal
+#define PROFILE_ZONE(NAME) \
+  NightEngine::Profiling::ScopedZone PROFILE_CONCAT(profileZone_, __LINE__){ NAME }
+
+//! @brief Record a counter value, NAME must be a string literal
+#define PROFILE_COUNTER(NAME, VALUE) \
+  NightEngine::Profiling::PushCounter(NAME, static_cast<float>(VALUE))
+
+//! @brief Mark the beginning of a new frame, main thread only
+#define PROFILE_FRAME_MARK() NightEngine::Profiling::MarkFrame()
 #else
   #define PROFILE_SESSION_BEGIN(DESCRIPTION)
   #define PROFILE_SESSION_END()
   #define PROFILE_BLOCK_INSTRUMENT(DESCRIPTION)
+  #define PROFILE_ZONE(NAME)
+  #define PROFILE_COUNTER(NAME, VALUE)
+  #define PROFILE_FRAME_MARK()
 #endif
 
-
 namespace NightEngine
 {
   namespace Profiling
   {
-    struct Session
+    //! @brief Slots per thread ring (256KB), the oldest events get overwritten
+    constexpr Container::U32 c_THREAD_RING_CAPACITY = 1u << 14;
+
+    //! @brief Amount of frame markers remembered for capturing
+    constexpr Container::U32 c_FRAME_HISTORY = 256;
+
+    enum class EventType : Container::U32
     {
-      std::string m_sessionName;
-      std::string m_filePath;
+      ZONE_BEGIN = 0,
+      ZONE_END,
+      COUNTER,
+      FRAME,
+      COUNTER_VALUE   //Second slot of a counter, never captured on its own
+    };
+
+    //! @brief The type is kept in the top bits of the timestamp
+    constexpr Container::U32 c_EVENT_TYPE_SHIFT = 61;
+    constexpr Container::U64 c_TIMESTAMP_MASK = (Container::U64(1) << c_EVENT_TYPE_SHIFT) - 1;
+
+    //! @brief 16 bytes ring slot, name must be a string literal (never copied).
+    // A counter take two slots, the value slot keep the float bits in place of the timestamp
+    struct PackedEvent
+    {
+      Container::U64 m_timestampType;
+      const char*    m_name;
+    };
+
+    //! @brief Decoded event
+    struct ProfileEvent
+    {
+      Container::U64 m_timestamp;
+      const char*    m_name;
+      EventType      m_type;
+      float          m_value;
+    };
+
+    //! @brief Overwrite ring written only by its owner thread. m_claimed is bumped before
+    // a slot is written and m_head after, so a reader can tell which slots it may have
+    // copied while they were being overwritten
+    struct ThreadEventRing
+    {
+      PackedEvent                 m_events[c_THREAD_RING_CAPACITY];
+      std::atomic<Container::U64> m_head{ 0 };
+      std::atomic<Container::U64> m_claimed{ 0 };
+      std::atomic<bool>           m_retired{ false };
+      Container::U32              m_threadIndex = 0;
     };
 
-    struct ProfileData
+    //! @brief Event copied out of a thread ring
+    struct CapturedEvent
+    {
+      ProfileEvent   m_event;
+      Container::U32 m_threadIndex;
+    };
+
+    //! @brief Global runtime toggle
+    extern std::atomic<bool> g_profilerEnabled;
+
+    //! @brief Ring of the calling thread, nullptr until the first event
+    extern thread_local ThreadEventRing* t_threadRing;
+
+    //! @brief Allocate and register the ring of the calling thread
+    ThreadEventRing* CreateThreadRing(void);
+
+    //! @brief Read cpu timestamp counter (steady_clock when not available), without the type bits
+    inline Container::U64 ReadTimestamp(void)
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+      return __rdtsc() & c_TIMESTAMP_MASK;
+#else
+      return static_cast<Container::U64>(
+        std::chrono::steady_clock::now().time_since_epoch().count()) & c_TIMESTAMP_MASK;
+#endif
+    }
+
+    inline PackedEvent PackEvent(EventType type, Container::U64 timestamp, const char* name)
+    {
+      return PackedEvent{ (timestamp & c_TIMESTAMP_MASK)
+        | (static_cast<Container::U64>(type) << c_EVENT_TYPE_SHIFT), name };
+    }
+
+    //! @brief Ring of the calling thread, created on the first event
+    inline ThreadEventRing& GetThreadRing(void)
     {
-      std::string m_name;
+      ThreadEventRing* ring = t_threadRing;
+      return ring != nullptr ? *ring : *CreateThreadRing();
+    }
 
-      //Both time should be in microsecond unit
-      long long m_startTime;  
-      float m_elapsedTime;
-      
-      size_t m_threadId;
+    //! @brief Claim, write and publish count (1 or 2) slots, owner thread only
+    inline void WriteSlots(ThreadEventRing& ring, const PackedEvent* events, Container::U32 count)
+    {
+      Container::U64 head = ring.m_head.load(std::memory_order_relaxed);
+      ring.m_claimed.store(head + count, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (Container::U32 i = 0; i < count; ++i)
+      {
+        ring.m_events[(head + i) & (c_THREAD_RING_CAPACITY - 1)] = events[i];
+      }
+      ring.m_head.store(head + count, std::memory_order_release);
+    }
+
+    //! @brief Write a zone or frame event into the calling thread's ring
+    inline void PushEvent(EventType type, const char* name)
+    {
+      if (!g_profilerEnabled.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+
+      PackedEvent event = PackEvent(type, ReadTimestamp(), name);
+      WriteSlots(GetThreadRing(), &event, 1);
+    }
+
+    //! @brief Write a counter into the calling thread's ring
+    inline void PushCounter(const char* name, float value)
+    {
+      if (!g_profilerEnabled.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+
+      Container::U32 valueBits;
+      std::memcpy(&valueBits, &value, sizeof(valueBits));
+      PackedEvent events[2]{ PackEvent(EventType::COUNTER, ReadTimestamp(), name)
+        , PackEvent(EventType::COUNTER_VALUE, valueBits, nullptr) };
+      WriteSlots(GetThreadRing(), events, 2);
+    }
+
+    //! @brief RAII zone, record begin/end events
+    struct ScopedZone
+    {
+      explicit ScopedZone(const char* name) : m_name(name)
+      {
+        PushEvent(EventType::ZONE_BEGIN, m_name);
+      }
+
+      ~ScopedZone()
+      {
+        PushEvent(EventType::ZONE_END, m_name);
+      }
+
+      ScopedZone(const ScopedZone&) = delete;
+      ScopedZone& operator=(const ScopedZone&) = delete;
+
+      const char* m_name;
+      bool        m_blockDone = false;  //For PROFILE_BLOCK_INSTRUMENT
+    };
+
+    /////////////////////////////////////////////////////////////////////
+
+    //! @brief Enable/Disable recording at runtime
+    inline void SetEnabled(bool enabled) { g_profilerEnabled.store(enabled, std::memory_order_relaxed); }
+
+    //! @brief Check if recording is enabled
+    inline bool IsEnabled(void) { return g_profilerEnabled.load(std::memory_order_relaxed); }
+
+    //! @brief Mark the beginning of a frame, the calling thread is treated as the main thread
+    void MarkFrame(void);
+
+    //! @brief Amount of frames marked since startup
+    Container::U64 GetFrameCount(void);
+
+    //! @brief Timestamp of the frame marker framesAgo frames back (0 is the current frame),
+    // return 0 if it is no longer remembered
+    Container::U64 GetFrameTimestamp(Container::U32 framesAgo);
+
+    //! @brief Index of the thread that marks the frames
+    Container::U32 GetMainThreadIndex(void);
+
+    //! @brief Measure the timestamp frequency, call once after startup so the reference is long
+    void Calibrate(void);
+
+    //! @brief Convert timestamp ticks to microseconds
+    double TicksToMicroseconds(Container::U64 ticks);
+
+    //! @brief Copy events in [beginTimestamp, endTimestamp) of every thread,
+    // events are ordered by time within the same thread
+    void CaptureEvents(Container::U64 beginTimestamp, Container::U64 endTimestamp
+      , Container::Vector<CapturedEvent>& output);
+
+    //! @brief Write captured events as Chrome trace event JSON (chrome://tracing, Perfetto)
+    bool WriteChromeTrace(const Container::Vector<CapturedEvent>& events
+      , const std::string& filePath);
+
+    //! @brief Dump the last frameCount frames into filePath
+    bool CaptureLastFrames(Container::U32 frameCount, const std::string& filePath);
+
+    //! @brief Free the rings of threads that already exited
+    void ReleaseRetiredRings(void);
+
+    /////////////////////////////////////////////////////////////////////
+
+    struct Session
+    {
+      std::string m_sessionName;
+      std::string m_filePath;
     };
 
+    //! @brief Session dump every event recorded between Begin/End.
+    // Older events are lost if a thread overflow its ring during the session.
     class Instrumentor
     {
     public:
@@ -69,15 +274,10 @@ namespace NightEngine
         , const std::string& filepath = "profile_results.json");
       void EndSession();
 
-      void WriteProfile(const ProfileData& data);
-
       inline bool IsActive(void) { return m_sessionActive; }
     private:
-      void WriteHeader();
-      void WriteFooter();
-
       bool m_sessionActive = false;
-      int m_profileCount = 0;
+      Container::U64 m_sessionStart = 0;
       Session m_session;
     };
   }
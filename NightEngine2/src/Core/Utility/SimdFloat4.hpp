@@ -0,0 +1,163 @@
+/*!
+  @file SimdFloat4.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of SimdFloat4
+*/
+#pragma once
+
+//SSE2 is part of every x64 target, anything else take the scalar path
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+  #define NE_SIMD_SSE2 1
+  #include <emmintrin.h>
+#else
+  #define NE_SIMD_SSE2 0
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace NightEngine::Simd
+{
+  //! @brief 4 floats processed at once, the lanes are usually 4 objects of a SoA layout
+  struct alignas(16) Float4
+  {
+#if NE_SIMD_SSE2
+    __m128 m_value;
+#else
+    float  m_value[4];
+#endif
+  };
+
+#if NE_SIMD_SSE2
+  inline Float4 Splat(float value) { return Float4{ _mm_set1_ps(value) }; }
+
+  inline Float4 Set(float x, float y, float z, float w) { return Float4{ _mm_setr_ps(x, y, z, w) }; }
+
+  //! @brief Load 4 floats, ptr doesn't need to be aligned
+  inline Float4 Load(const float* ptr) { return Float4{ _mm_loadu_ps(ptr) }; }
+
+  //! @brief Store 4 floats, ptr doesn't need to be aligned
+  inline void Store(const Float4& v, float* ptr) { _mm_storeu_ps(ptr, v.m_value); }
+
+  inline Float4 operator+(const Float4& a, const Float4& b) { return Float4{ _mm_add_ps(a.m_value, b.m_value) }; }
+  inline Float4 operator-(const Float4& a, const Float4& b) { return Float4{ _mm_sub_ps(a.m_value, b.m_value) }; }
+  inline Float4 operator*(const Float4& a, const Float4& b) { return Float4{ _mm_mul_ps(a.m_value, b.m_value) }; }
+  inline Float4 operator/(const Float4& a, const Float4& b) { return Float4{ _mm_div_ps(a.m_value, b.m_value) }; }
+
+  inline Float4 Min(const Float4& a, const Float4& b) { return Float4{ _mm_min_ps(a.m_value, b.m_value) }; }
+  inline Float4 Max(const Float4& a, const Float4& b) { return Float4{ _mm_max_ps(a.m_value, b.m_value) }; }
+  inline Float4 Sqrt(const Float4& a) { return Float4{ _mm_sqrt_ps(a.m_value) }; }
+
+  //! @brief Lanes set to all ones where a < b
+  inline Float4 CmpLess(const Float4& a, const Float4& b) { return Float4{ _mm_cmplt_ps(a.m_value, b.m_value) }; }
+
+  inline Float4 And(const Float4& a, const Float4& b) { return Float4{ _mm_and_ps(a.m_value, b.m_value) }; }
+  inline Float4 Or(const Float4& a, const Float4& b) { return Float4{ _mm_or_ps(a.m_value, b.m_value) }; }
+  inline Float4 Xor(const Float4& a, const Float4& b) { return Float4{ _mm_xor_ps(a.m_value, b.m_value) }; }
+
+  //! @brief mask ? a : b per lane, mask lanes are all ones or all zeros
+  inline Float4 Select(const Float4& mask, const Float4& a, const Float4& b)
+  {
+    return Float4{ _mm_or_ps(_mm_and_ps(mask.m_value, a.m_value), _mm_andnot_ps(mask.m_value, b.m_value)) };
+  }
+
+  //! @brief Bit i set when the sign bit of lane i is set
+  inline int MoveMask(const Float4& a) { return _mm_movemask_ps(a.m_value); }
+#else
+  inline Float4 Splat(float value) { return Float4{ { value, value, value, value } }; }
+
+  inline Float4 Set(float x, float y, float z, float w) { return Float4{ { x, y, z, w } }; }
+
+  inline Float4 Load(const float* ptr) { return Float4{ { ptr[0], ptr[1], ptr[2], ptr[3] } }; }
+
+  inline void Store(const Float4& v, float* ptr) { std::memcpy(ptr, v.m_value, sizeof(v.m_value)); }
+
+  template<typename FN>
+  inline Float4 PerLane(const Float4& a, const Float4& b, FN fn)
+  {
+    return Float4{ { fn(a.m_value[0], b.m_value[0]), fn(a.m_value[1], b.m_value[1])
+      , fn(a.m_value[2], b.m_value[2]), fn(a.m_value[3], b.m_value[3]) } };
+  }
+
+  template<typename FN>
+  inline Float4 PerLaneBits(const Float4& a, const Float4& b, FN fn)
+  {
+    Float4 result;
+    for (int i = 0; i < 4; ++i)
+    {
+      uint32_t x, y;
+      std::memcpy(&x, &a.m_value[i], sizeof(x));
+      std::memcpy(&y, &b.m_value[i], sizeof(y));
+      uint32_t r = fn(x, y);
+      std::memcpy(&result.m_value[i], &r, sizeof(r));
+    }
+    return result;
+  }
+
+  inline Float4 operator+(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return x + y; }); }
+  inline Float4 operator-(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return x - y; }); }
+  inline Float4 operator*(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return x * y; }); }
+  inline Float4 operator/(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return x / y; }); }
+
+  inline Float4 Min(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return y < x ? y : x; }); }
+  inline Float4 Max(const Float4& a, const Float4& b) { return PerLane(a, b, [](float x, float y) { return y > x ? y : x; }); }
+  inline Float4 Sqrt(const Float4& a) { return PerLane(a, a, [](float x, float) { return std::sqrt(x); }); }
+
+  inline Float4 CmpLess(const Float4& a, const Float4& b)
+  {
+    Float4 result;
+    for (int i = 0; i < 4; ++i)
+    {
+      uint32_t r = a.m_value[i] < b.m_value[i] ? 0xFFFFFFFFu : 0u;
+      std::memcpy(&result.m_value[i], &r, sizeof(r));
+    }
+    return result;
+  }
+
+  inline Float4 And(const Float4& a, const Float4& b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+  inline Float4 Or(const Float4& a, const Float4& b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return x | y; }); }
+  inline Float4 Xor(const Float4& a, const Float4& b) { return PerLaneBits(a, b, [](uint32_t x, uint32_t y) { return x ^ y; }); }
+
+  inline Float4 Select(const Float4& mask, const Float4& a, const Float4& b)
+  {
+    return Or(And(mask, a), PerLaneBits(mask, b, [](uint32_t m, uint32_t y) { return ~m & y; }));
+  }
+
+  inline int MoveMask(const Float4& a)
+  {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+      uint32_t x;
+      std::memcpy(&x, &a.m_value[i], sizeof(x));
+      mask |= static_cast<int>(x >> 31) << i;
+    }
+    return mask;
+  }
+#endif
+
+  ///////////////////////////////////////////////////////
+
+  inline Float4 operator-(const Float4& a) { return Splat(0.0f) - a; }
+
+  //! @brief a * b + c
+  inline Float4 MulAdd(const Float4& a, const Float4& b, const Float4& c) { return a * b + c; }
+
+  //! @brief a + (b - a) * t
+  inline Float4 Lerp(const Float4& a, const Float4& b, const Float4& t) { return MulAdd(b - a, t, a); }
+
+  //! @brief Full precision 1 / sqrt(a)
+  inline Float4 RSqrt(const Float4& a) { return Splat(1.0f) / Sqrt(a); }
+
+  //! @brief Only the sign bit of every lane
+  inline Float4 SignBits(const Float4& a) { return And(a, Splat(-0.0f)); }
+
+  //! @brief Lane i of a, slow, for the scalar tail of a loop
+  inline float GetLane(const Float4& a, int lane)
+  {
+    alignas(16) float values[4];
+    Store(a, values);
+    return values[lane];
+  }
+}
@@ -18,6 +18,7 @@
 #include "Core/Serialization/FileSystem.hpp"
 
 #include "NightEngine2.hpp"
+#include "Input/Input.hpp"
 #include "Physics/PhysicsDebugDrawer.hpp"
 
 #include <ctype.h>          // toupper, isprint
@@ -33,6 +34,8 @@ namespace Editor
   //***************************************
   // Global
   //***************************************
+  static const NightEngine::Container::U32 c_CAPTURE_PROFILE_FRAMES = 120;
+  static const char* c_INPUT_RECORDING_FILE = "nightengine2_input_recording.bin";
 
   //***************************************
   // Definition
@@ -57,10 +60,16 @@ namespace Editor
 
     AddCommand("BEGINPROFILE", &DevConsole::StartProfilingSession);
     AddCommand("ENDPROFILE", &DevConsole::EndProfilingSession);
+    AddCommand("CAPTUREPROFILE", &DevConsole::CaptureProfile);
+
+    AddCommand("RECORD_INPUT", &DevConsole::RecordInput);
+    AddCommand("STOP_RECORD_INPUT", &DevConsole::StopRecordInput);
+    AddCommand("REPLAY_INPUT", &DevConsole::ReplayInput);
 
     AddCommand("RENDERDOC_CAPTURE", &DevConsole::RenderDocCapture);
     AddCommand("RESTART_WINDOW", &DevConsole::RestartWindow);
     AddCommand("COMPILE_SHADERS", &DevConsole::RecompileShaders);
+    AddCommand("COOK_ASSETS", &DevConsole::CookAssets);
 
     AddCommand("TOGGLE_PHYSICS_DEBUG", &DevConsole::TogglePhysicsDebug);
     AddCommand("PRINT_GRAPHICS_ALLOCATION_TRACKER", &DevConsole::PrintGraphicsAllocationTracker);
@@ -448,6 +457,33 @@ namespace Editor
     PROFILE_SESSION_END();
   }
 
+  void DevConsole::CaptureProfile(void)
+  {
+    NightEngine::Profiling::CaptureLastFrames(c_CAPTURE_PROFILE_FRAMES
+      , NightEngine::FileSystem::GetFilePath("nightengine2_profile_capture.json"
+        , NightEngine::FileSystem::DirectoryType::Assets));
+  }
+
+  void DevConsole::RecordInput(void)
+  {
+    if (!Input::BeginRecording())
+    {
+      AddLog("Input is already recording or replaying");
+    }
+  }
+
+  void DevConsole::StopRecordInput(void)
+  {
+    Input::EndRecording(NightEngine::FileSystem::GetFilePath(c_INPUT_RECORDING_FILE
+      , NightEngine::FileSystem::DirectoryType::Assets));
+  }
+
+  void DevConsole::ReplayInput(void)
+  {
+    Input::BeginReplay(NightEngine::FileSystem::GetFilePath(c_INPUT_RECORDING_FILE
+      , NightEngine::FileSystem::DirectoryType::Assets));
+  }
+
   void DevConsole::RenderDocCapture(void)
   {
     using namespace NightEngine::Rendering;
@@ -479,6 +515,12 @@ namespace Editor
     NightEngine::Engine::GetInstance()->SendPostRenderEvent(NightEngine::PostRenderEngineEvent::RecompileShader);
   }
 
+  void DevConsole::CookAssets(void)
+  {
+    size_t cookedCount = NightEngine::Engine::CookAssets();
+    AddLog("Cooked %d assets", static_cast<int>(cookedCount));
+  }
+
   void DevConsole::TogglePhysicsDebug(void)
   {
     auto debugDrawer = Physics::PhysicsDebugDrawer::GetInstance();
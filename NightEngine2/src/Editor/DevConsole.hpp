@@ -84,10 +84,16 @@ namespace Editor
     //*****************************************
     void StartProfilingSession(void);
     void EndProfilingSession(void);
+    void CaptureProfile(void);
+
+    void RecordInput(void);
+    void StopRecordInput(void);
+    void ReplayInput(void);
 
     void RenderDocCapture(void);
     void RestartWindow(void);
     void RecompileShaders(void);
+    void CookAssets(void);
 
     void TogglePhysicsDebug(void);
     void PrintGraphicsAllocationTracker(void);
@@ -6,6 +6,7 @@
 #include "Editor/GameObjectBrowser.hpp"
 #include "Editor/MemberSerializerEditor.hpp"
 #include "Editor/ConfirmationBox.hpp"
+#include "Editor/HierarchyTree.hpp"
 
 #include "imgui/imgui.h"
 
@@ -40,6 +41,43 @@ namespace Editor
   static bool            g_removeComponent{ false };
   static std::string     g_componentToRemove{ "" };
 
+  //GameObject list, rebuilt only when a gameobject is created, destroyed or renamed
+  static std::vector<Handle<GameObject>>  g_gameObjectList;
+  static NameSearchIndex                  g_nameIndex;
+  static std::vector<NameSearchIndex::Key> g_filteredList;
+  static Container::U64                   g_listRevision = ~0ull;
+  static size_t                           g_listSize = 0;
+  static std::string                      g_listFilter;
+
+  //! @brief Refresh the cached list and the rows passing filter
+  static void UpdateGameObjectList(const char* filter)
+  {
+    auto& gameObjectContainer = Factory::GetTypeContainer<GameObject>();
+    bool dirty = g_listRevision != GameObject::GetRevision()
+      || g_listSize != gameObjectContainer.Size();
+    if (dirty)
+    {
+      g_listRevision = GameObject::GetRevision();
+      g_listSize = gameObjectContainer.Size();
+
+      g_gameObjectList.clear();
+      g_nameIndex.Clear();
+      auto it = gameObjectContainer.GetIterator();
+      while (!it.IsEnd())
+      {
+        g_nameIndex.Insert(g_gameObjectList.size(), it.Get()->GetName());
+        g_gameObjectList.emplace_back(it.Get()->GetHandle());
+        it.Next();
+      }
+    }
+
+    if (dirty || g_listFilter != filter)
+    {
+      g_listFilter = filter;
+      g_nameIndex.Search(g_listFilter, g_filteredList);
+    }
+  }
+
   void GameObjectBrowser::Update(MemberSerializerEditor& memberSerializer)
   {
     if (m_show)
@@ -72,8 +110,11 @@ namespace Editor
         ImGui::BeginChild("Left Panel", ImVec2(leftPanelWidth, 0), true
         , ImGuiWindowFlags_AlwaysAutoResize);
         {
-          static ImGuiTextFilter filter;
-          filter.Draw("Search", 110.0f);
+          static char filter[128] = "";
+          ImGui::PushItemWidth(110.0f);
+          ImGui::InputText("Search", filter, sizeof(filter));
+          ImGui::PopItemWidth();
+          UpdateGameObjectList(filter);
 
           //Header buttons
           ImGui::Separator();
@@ -93,34 +134,34 @@ namespace Editor
             ImGui::Text("NAME"); ImGui::NextColumn();
             ImGui::Separator();
 
-            //Traverse all gameobject
-            int gameObjectIndex = -1;
-            auto& gameObjectContainer = Factory::GetTypeContainer<GameObject>();
-            auto it = gameObjectContainer.GetIterator();
-            while (!it.IsEnd())
+            //Draw the gameobjects passing the filter, only those in the scroll region
+            ImGuiListClipper clipper(static_cast<int>(g_filteredList.size()));
+            while (clipper.Step())
             {
-              gameObjectIndex = it.m_index;
-
-              //Draw the Column, if name pass the filter
-              auto name = it.Get()->GetName().c_str();
-              if (filter.PassFilter(name))
+              for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
               {
+                auto& handle = g_gameObjectList[g_filteredList[row]];
+                if (!handle.IsValid())
+                {
+                  ImGui::Text("-"); ImGui::NextColumn();
+                  ImGui::Text("-"); ImGui::NextColumn();
+                  continue;
+                }
+                int gameObjectIndex = handle.GetSlotMapID();
+
                 //ID Column 
-                char label[8];
+                char label[24];
                 sprintf(label, "%d", gameObjectIndex);
                 if (ImGui::Selectable(label, g_selectedIndex == gameObjectIndex))
                 {
                   g_selectedIndex = gameObjectIndex;
-                  g_curSelectedGameObject = it.Get();
+                  g_curSelectedGameObject = handle.Get();
                 }
 
                 //Name Column
                 ImGui::NextColumn();
-                ImGui::Text(name); ImGui::NextColumn();
+                ImGui::Text("%s", handle->GetName().c_str()); ImGui::NextColumn();
               }
-
-              //Next iterator
-              it.Next();
             }
 
             //EndChild
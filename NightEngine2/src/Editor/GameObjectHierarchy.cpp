@@ -1,4 +1,3 @@
-
 /*!
   @file GameObjectHierarchy.cpp
   @author Rittikorn Tangtrongchit
@@ -14,12 +13,23 @@
 
 #include "Core/EC/GameObject.hpp"
 
+#include <algorithm>
+
 using namespace NightEngine;
 using namespace NightEngine::Rendering::Opengl;
 using namespace NightEngine::EC;
 
 namespace Editor
 {
+  static const char* g_dragDropType = "HIERARCHY_GO";
+
+  //! @brief Key of a gameobject, stay unique after its slot is reused
+  static HierarchyTree::Key GetKey(const Handle<GameObject>& handle)
+  {
+    const SlotmapID& id = handle.m_handle.m_slotmapID;
+    return (HierarchyTree::Key(id.m_index) << 17) | HierarchyTree::Key(id.m_generation);
+  }
+
   void Hierarchy::Update(void)
   {
     if (m_show)
@@ -37,21 +47,20 @@ namespace Editor
       , ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoMove))
     {
       //Filter Search
-      static ImGuiTextFilter filter;
-      filter.Draw("Search");
+      ImGui::InputText("Search", m_filter, sizeof(m_filter));
 
       // Tree Hierarchy in Child Border
       ImGui::BeginChild("Panel", ImVec2(0, 0), true
         , ImGuiWindowFlags_AlwaysVerticalScrollbar | ImGuiWindowFlags_AlwaysHorizontalScrollbar);
       {
-        DrawHierarchyTree(filter);
+        DrawHierarchyTree();
       }
       ImGui::EndChild();
     }
     ImGui::End();
   }
 
-  void Hierarchy::DrawHierarchyTree(ImGuiTextFilter& filter)
+  void Hierarchy::DrawHierarchyTree(void)
   {
     static std::vector<bool> closable_groups;
     static bool cur_closable_group = true;
@@ -68,104 +77,50 @@ namespace Editor
       cur_closable_group = (closable_groups[i]);
 
       Scene* scenePtr = (*scenes)[i].Get();
-      if ( ImGui::CollapsingHeader(scenePtr->GetSceneName().c_str()
-        , &cur_closable_group, ImGuiTreeNodeFlags_DefaultOpen) )
-      {
-        //TODO: Some container to hold all selected index maybe set
-        int node_clicked = -1;                // Temporary storage of what node we have clicked to process selection at the end of the loop. May be a pointer to your own node type, etc.
-        ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, ImGui::GetFontSize() * 2); // Increase spacing to differentiate leaves from expanded contents.
+      SceneView& view = m_sceneViews[scenePtr];
+      SyncSceneView(*scenePtr, view);
 
-        //Traverse all gameobject
-        int gameObjectIndex = -1;
-        auto& gameObjects = scenePtr->GetAllGameObjects();
+      bool headerOpen = ImGui::CollapsingHeader(scenePtr->GetSceneName().c_str()
+        , &cur_closable_group, ImGuiTreeNodeFlags_DefaultOpen);
 
-        for(int gID = 0; gID < gameObjects.size(); ++gID)
+      //Dropping on the scene header move the gameobject to the top level
+      if (ImGui::BeginDragDropTarget())
+      {
+        if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload(g_dragDropType))
         {
-          gameObjectIndex = gameObjects[gID].GetSlotMapID();
-
-          //Draw the Column, if name pass the filter
-          auto name = gameObjects[gID]->GetName().c_str();
-          if (filter.PassFilter(name))
+          auto it = view.m_gameObjects.find(*static_cast<const HierarchyTree::Key*>(payload->Data));
+          if (it != view.m_gameObjects.end())
           {
-            //Node Selection
-            auto setIt = m_selectedIndexSet.find(gameObjectIndex);
-            ImGuiTreeNodeFlags node_flags = setIt != m_selectedIndexSet.end() ?//selection_mask & (1 << gameObjectIndex) ? 
-              ImGuiTreeNodeFlags_Selected : 0;
-
-            //Node openable flag
-            bool hasChild = false;
-
-            //TODO: Traverse child
-            if (hasChild)
-            {
-              node_flags |= ImGuiTreeNodeFlags_OpenOnArrow
-                | ImGuiTreeNodeFlags_OpenOnDoubleClick
-                | ImGuiTreeNodeFlags_SpanAvailWidth;
-
-              bool node_open = ImGui::TreeNodeEx((void*)(intptr_t)gameObjectIndex
-                , node_flags, name);
-              if (node_open)
-              {
-                //TODO: Recursively draw Child Node
-                ImGui::Text("Blah blah\nBlah Blah");
-                ImGui::Text("Blah blah\nBlah Blah");
-                ImGui::Text("Blah blah\nBlah Blah");
-
-                node_flags |= ImGuiTreeNodeFlags_Leaf
-                  | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-                ImGui::TreeNodeEx((void*)(intptr_t)gameObjectIndex
-                  , node_flags, "Selectable Leaf %d", gameObjectIndex);
-
-                ImGui::TreePop();
-              }
-            }
-            //No child
-            else
-            {
-              node_flags |= ImGuiTreeNodeFlags_Leaf
-                | ImGuiTreeNodeFlags_NoTreePushOnOpen
-                | ImGuiTreeNodeFlags_SpanAvailWidth; // ImGuiTreeNodeFlags_Bullet
-
-              ImGui::TreeNodeEx((void*)(intptr_t)gameObjectIndex
-                , node_flags, name);
-            }
-
-            //Select Node
-            if (ImGui::IsItemClicked())
-            {
-              node_clicked = gameObjectIndex;
-              m_curSelected = gameObjects[gID].Get();
-            }
+            scenePtr->SetParent(it->second, Handle<GameObject>());
           }
         }
+        ImGui::EndDragDropTarget();
+      }
 
-        //Click on some Node
-        if (node_clicked != -1)
-        {
-          if (ImGui::GetIO().KeyCtrl)
-          {
-            m_selectedIndexSet.insert({ node_clicked });
-          }
-          else //if (!(selection_mask & (1 << node_clicked))) // Depending on selection behavior you want, this commented bit preserve selection when clicking on item that is part of the selection
-          {
-            m_selectedIndexSet.clear();
-            m_selectedIndexSet.insert({ node_clicked });
-          }
-        }
-        ImGui::PopStyleVar();
+      if (headerOpen)
+      {
+        DrawSceneRows(*scenePtr, view);
       }
 
       //Save flags if the close button is clicked
       closable_groups[i] = cur_closable_group;
     }
 
+    //Forget the views of closed scenes
+    for (auto it = m_sceneViews.begin(); it != m_sceneViews.end();)
+    {
+      bool opened = std::any_of(scenes->begin(), scenes->end()
+        , [&it](Handle<Scene>& scene) { return scene.Get() == it->first; });
+      it = opened ? std::next(it) : m_sceneViews.erase(it);
+    }
+
     //Check for close button click flag
     for (int i = 0; i < closable_groups.size(); ++i)
     {
       if (closable_groups[i] == false)
       {
         Debug::Log << "Close Scene: " << (*scenes)[i].Get()->GetSceneName() << '\n';
-        m_curSelected = nullptr;
+        m_curSelected = Handle<GameObject>();
         SceneManager::CloseScene((*scenes)[i]);
 
         //Reopen all the closed headers
@@ -178,4 +133,273 @@ namespace Editor
       }
     }
   }
-}
\ No newline at end of file
+
+  GameObject* Hierarchy::GetSelectedGameObject(void)
+  {
+    return m_curSelected.IsValid() ? m_curSelected.Get() : nullptr;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void Hierarchy::SyncSceneView(Scene& scene, SceneView& view)
+  {
+    static Container::Vector<SceneChange> changes;
+    bool complete = scene.ConsumeChanges(changes) && view.m_built;
+
+    HierarchyTree& tree = view.m_tree;
+    for (size_t i = 0; complete && i < changes.size(); ++i)
+    {
+      const SceneChange& change = changes[i];
+      HierarchyTree::Key key = GetKey(change.m_gameObject);
+      switch (change.m_type)
+      {
+        case SceneChange::Type::ADD:
+        {
+          //Might be destroyed already
+          const Container::String& name = change.m_gameObject.IsValid() ?
+            change.m_gameObject->GetName() : Container::String();
+          complete = tree.Add(key, name);
+          view.m_gameObjects[key] = change.m_gameObject;
+          break;
+        }
+        case SceneChange::Type::REMOVE:
+        {
+          tree.Remove(key);
+          view.m_gameObjects.erase(key);
+          break;
+        }
+        case SceneChange::Type::REPARENT:
+        {
+          HierarchyTree::Key parent = change.m_parent.m_handle.m_lookupFN != nullptr ?
+            GetKey(change.m_parent) : HierarchyTree::c_ROOT;
+          complete = tree.Reparent(key, parent);
+          break;
+        }
+      }
+    }
+
+    //The scene arrays were also written without going through the changes (e.g. loading)
+    if (!complete || tree.GetNodeCount() != scene.GetAllGameObjects().size())
+    {
+      RebuildSceneView(scene, view);
+      return;
+    }
+
+    //Names are only rescanned when a gameobject was renamed somewhere
+    if (view.m_revision != GameObject::GetRevision())
+    {
+      view.m_revision = GameObject::GetRevision();
+      for (auto& pair : view.m_gameObjects)
+      {
+        if (pair.second.IsValid() && tree.GetName(pair.first) != pair.second->GetName())
+        {
+          tree.Rename(pair.first, pair.second->GetName());
+        }
+      }
+    }
+  }
+
+  void Hierarchy::RebuildSceneView(Scene& scene, SceneView& view)
+  {
+    //Keep what the user opened and selected
+    std::vector<HierarchyTree::Key> expanded;
+    for (auto& pair : view.m_gameObjects)
+    {
+      if (view.m_tree.Contains(pair.first) && view.m_tree.IsExpanded(pair.first))
+      {
+        expanded.emplace_back(pair.first);
+      }
+    }
+    std::unordered_set<HierarchyTree::Key> selection = view.m_tree.GetSelection();
+
+    view.m_tree.Clear();
+    view.m_gameObjects.clear();
+
+    auto& gameObjects = scene.GetAllGameObjects();
+    auto& sceneNodes = scene.GetSceneNodes();
+    int count = static_cast<int>(gameObjects.size());
+
+    //Parents before children, so every Add land under a collapsed parent
+    std::vector<bool> added(count, false);
+    std::vector<int> stack;
+    auto addSubtree = [&](int rootIndex)
+    {
+      stack.emplace_back(rootIndex);
+      while (!stack.empty())
+      {
+        int index = stack.back();
+        stack.pop_back();
+        if (added[index])
+        {
+          continue;
+        }
+        added[index] = true;
+
+        int parentIndex = sceneNodes[index].m_parentIndex;
+        HierarchyTree::Key key = GetKey(gameObjects[index]);
+        HierarchyTree::Key parent = parentIndex >= 0 && parentIndex < count && added[parentIndex] ?
+          GetKey(gameObjects[parentIndex]) : HierarchyTree::c_ROOT;
+        const Container::String& name = gameObjects[index].IsValid() ?
+          gameObjects[index]->GetName() : Container::String();
+        view.m_tree.Add(key, name, parent);
+        view.m_gameObjects[key] = gameObjects[index];
+
+        //Children set is unordered, keep the scene order
+        std::vector<int> children(sceneNodes[index].m_children.begin()
+          , sceneNodes[index].m_children.end());
+        std::sort(children.begin(), children.end(), std::greater<int>());
+        for (int child : children)
+        {
+          if (child >= 0 && child < count)
+          {
+            stack.emplace_back(child);
+          }
+        }
+      }
+    };
+
+    for (int i = 0; i < count; ++i)
+    {
+      int parentIndex = sceneNodes[i].m_parentIndex;
+      if (parentIndex < 0 || parentIndex >= count)
+      {
+        addSubtree(i);
+      }
+    }
+    //Nodes only reachable through a broken parent chain
+    for (int i = 0; i < count; ++i)
+    {
+      addSubtree(i);
+    }
+
+    for (auto key : expanded)
+    {
+      if (view.m_tree.Contains(key))
+      {
+        view.m_tree.SetExpanded(key, true);
+      }
+    }
+    for (auto key : selection)
+    {
+      if (view.m_tree.Contains(key))
+      {
+        view.m_tree.Select(key, true);
+      }
+    }
+
+    view.m_revision = GameObject::GetRevision();
+    view.m_built = true;
+  }
+
+  void Hierarchy::DrawSceneRows(Scene& scene, SceneView& view)
+  {
+    HierarchyTree& tree = view.m_tree;
+    bool filtering = m_filter[0] != '\0';
+    if (tree.GetFilter() != m_filter)
+    {
+      tree.SetFilter(m_filter);
+    }
+
+    //Tree is modified after the loop, the rows stay valid while drawing
+    HierarchyTree::Key clicked = HierarchyTree::c_ROOT;
+    HierarchyTree::Key toggled = HierarchyTree::c_ROOT;
+    HierarchyTree::Key dropChild = HierarchyTree::c_ROOT;
+    HierarchyTree::Key dropParent = HierarchyTree::c_ROOT;
+
+    ImGui::PushStyleVar(ImGuiStyleVar_IndentSpacing, ImGui::GetFontSize() * 2); // Increase spacing to differentiate leaves from expanded contents.
+    float indent = ImGui::GetStyle().IndentSpacing;
+
+    //Only the rows in the scroll region are submitted
+    const std::vector<HierarchyTree::Row>& rows = tree.GetRows();
+    ImGuiListClipper clipper(static_cast<int>(rows.size()));
+    while (clipper.Step())
+    {
+      for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r)
+      {
+        const HierarchyTree::Row& row = rows[r];
+        const std::string& name = tree.GetName(row.m_key);
+
+        ImGuiTreeNodeFlags node_flags = ImGuiTreeNodeFlags_NoTreePushOnOpen
+          | ImGuiTreeNodeFlags_SpanAvailWidth;
+        if (tree.IsSelected(row.m_key))
+        {
+          node_flags |= ImGuiTreeNodeFlags_Selected;
+        }
+
+        bool hasChild = tree.HasChildren(row.m_key);
+        bool expanded = filtering || tree.IsExpanded(row.m_key);
+        if (hasChild)
+        {
+          node_flags |= ImGuiTreeNodeFlags_OpenOnArrow
+            | ImGuiTreeNodeFlags_OpenOnDoubleClick;
+          ImGui::SetNextItemOpen(expanded);
+        }
+        else
+        {
+          node_flags |= ImGuiTreeNodeFlags_Leaf;
+        }
+
+        ImGui::SetCursorPosX(ImGui::GetCursorPosX() + row.m_depth * indent);
+        bool node_open = ImGui::TreeNodeEx((void*)(intptr_t)row.m_key
+          , node_flags, "%s", name.c_str());
+        if (hasChild && node_open != expanded && !filtering)
+        {
+          toggled = row.m_key;
+        }
+
+        //Select Node
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+        {
+          clicked = row.m_key;
+        }
+
+        //Drag a node onto another to parent it
+        if (ImGui::BeginDragDropSource())
+        {
+          ImGui::SetDragDropPayload(g_dragDropType, &row.m_key, sizeof(HierarchyTree::Key));
+          ImGui::Text("%s", name.c_str());
+          ImGui::EndDragDropSource();
+        }
+        if (ImGui::BeginDragDropTarget())
+        {
+          if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload(g_dragDropType))
+          {
+            dropChild = *static_cast<const HierarchyTree::Key*>(payload->Data);
+            dropParent = row.m_key;
+          }
+          ImGui::EndDragDropTarget();
+        }
+      }
+    }
+    ImGui::PopStyleVar();
+
+    if (toggled != HierarchyTree::c_ROOT)
+    {
+      tree.SetExpanded(toggled, !tree.IsExpanded(toggled));
+    }
+
+    //Click on some Node
+    if (clicked != HierarchyTree::c_ROOT)
+    {
+      bool additive = ImGui::GetIO().KeyCtrl;
+      if (!additive)
+      {
+        for (auto& pair : m_sceneViews)
+        {
+          pair.second.m_tree.ClearSelection();
+        }
+      }
+      tree.Select(clicked, additive);
+      m_curSelected = view.m_gameObjects[clicked];
+    }
+
+    //Reparent in the scene, the tree follow from the scene changes
+    auto child = view.m_gameObjects.find(dropChild);
+    auto parent = view.m_gameObjects.find(dropParent);
+    if (child != view.m_gameObjects.end() && parent != view.m_gameObjects.end()
+      && scene.SetParent(child->second, parent->second))
+    {
+      tree.SetExpanded(dropParent, true);
+    }
+  }
+}
@@ -4,16 +4,17 @@
   @brief Contain the Interface of GameObjectHierarchy
 */
 #pragma once
-#include <unordered_set>
+#include "Editor/HierarchyTree.hpp"
+#include "Core/EC/Handle.hpp"
 
-//Forward declaration
-struct ImGuiTextFilter;
+#include <unordered_map>
 
 namespace NightEngine
 {
   namespace EC
   {
     class GameObject;
+    class Scene;
   }
 }
 
@@ -32,17 +33,38 @@ namespace Editor
     void Draw(bool* open);
 
     //! @brief Draw the Hierarchy Tree
-    void DrawHierarchyTree(ImGuiTextFilter& filter);
+    void DrawHierarchyTree(void);
 
     //! @brief Get reference to boolean
     inline bool& GetBool(void) { return m_show; }
 
     //! @brief Get selected gameobject
-    inline NightEngine::EC::GameObject* GetSelectedGameObject(void) { return m_curSelected; }
+    NightEngine::EC::GameObject* GetSelectedGameObject(void);
   private:
-    NightEngine::EC::GameObject* m_curSelected;
-    std::unordered_set<int> m_selectedIndexSet;
+    using GameObjectHandle = NightEngine::EC::Handle<NightEngine::EC::GameObject>;
+
+    //! @brief Cached tree of a scene, patched from the scene changes
+    struct SceneView
+    {
+      HierarchyTree                                          m_tree;
+      std::unordered_map<HierarchyTree::Key, GameObjectHandle> m_gameObjects;
+      NightEngine::Container::U64                            m_revision = ~0ull;
+      bool                                                   m_built = false;
+    };
+
+    //! @brief Apply the scene changes to the view, rebuild it if they can't be applied
+    void SyncSceneView(NightEngine::EC::Scene& scene, SceneView& view);
+
+    //! @brief Rebuild the view from the scene nodes
+    void RebuildSceneView(NightEngine::EC::Scene& scene, SceneView& view);
+
+    //! @brief Draw the visible rows of a scene
+    void DrawSceneRows(NightEngine::EC::Scene& scene, SceneView& view);
+
+    std::unordered_map<const NightEngine::EC::Scene*, SceneView> m_sceneViews;
+    GameObjectHandle m_curSelected;
+    char m_filter[128] = {};
     bool m_show = true;
   };
-  
-}
\ No newline at end of file
+
+}
@@ -0,0 +1,544 @@
+/*!
+  @file HierarchyTree.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of HierarchyTree
+*/
+#include "Editor/HierarchyTree.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace NightEngine::Container;
+
+namespace Editor
+{
+  static std::string ToLower(const std::string& str)
+  {
+    std::string lower{ str };
+    for (auto& c : lower)
+    {
+      c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lower;
+  }
+
+  static U32 GetTrigram(const std::string& lower, size_t i)
+  {
+    return (U32)(U8)lower[i] | ((U32)(U8)lower[i + 1] << 8) | ((U32)(U8)lower[i + 2] << 16);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void NameSearchIndex::Insert(Key key, const std::string& name)
+  {
+    Remove(key);
+    AddEntry(key, name);
+  }
+
+  void NameSearchIndex::AddEntry(Key key, const std::string& name)
+  {
+    U32 entryIndex = static_cast<U32>(m_entries.size());
+    m_entries.emplace_back(Entry{ key, ToLower(name), true });
+    m_keyToEntry[key] = entryIndex;
+
+    //Posting lists stay sorted since entries are only appended
+    const std::string& lower = m_entries.back().m_lowerName;
+    std::vector<U32> trigrams;
+    for (size_t i = 0; i + 2 < lower.size(); ++i)
+    {
+      trigrams.emplace_back(GetTrigram(lower, i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    for (U32 trigram : trigrams)
+    {
+      m_trigrams[trigram].emplace_back(entryIndex);
+    }
+  }
+
+  void NameSearchIndex::Remove(Key key)
+  {
+    auto it = m_keyToEntry.find(key);
+    if (it == m_keyToEntry.end())
+    {
+      return;
+    }
+
+    //Dead entries are skipped by Search until the next compaction
+    m_entries[it->second].m_alive = false;
+    m_keyToEntry.erase(it);
+    ++m_deadCount;
+
+    const size_t k_minDeadToCompact = 1024;
+    if (m_deadCount > k_minDeadToCompact && m_deadCount > m_keyToEntry.size())
+    {
+      Compact();
+    }
+  }
+
+  void NameSearchIndex::Clear(void)
+  {
+    m_entries.clear();
+    m_keyToEntry.clear();
+    m_trigrams.clear();
+    m_deadCount = 0;
+  }
+
+  void NameSearchIndex::Compact(void)
+  {
+    std::vector<Entry> entries;
+    entries.swap(m_entries);
+    Clear();
+
+    for (auto& entry : entries)
+    {
+      if (entry.m_alive)
+      {
+        AddEntry(entry.m_key, entry.m_lowerName);
+      }
+    }
+  }
+
+  void NameSearchIndex::Search(const std::string& query, std::vector<Key>& result) const
+  {
+    result.clear();
+    std::string lowerQuery = ToLower(query);
+
+    //Too short for a trigram, compare every name
+    if (lowerQuery.size() < 3)
+    {
+      for (auto& entry : m_entries)
+      {
+        if (entry.m_alive && entry.m_lowerName.find(lowerQuery) != std::string::npos)
+        {
+          result.emplace_back(entry.m_key);
+        }
+      }
+      return;
+    }
+
+    //Rarest trigram of the query, a missing one means no match
+    const std::vector<U32>* candidates = nullptr;
+    for (size_t i = 0; i + 2 < lowerQuery.size(); ++i)
+    {
+      auto it = m_trigrams.find(GetTrigram(lowerQuery, i));
+      if (it == m_trigrams.end())
+      {
+        return;
+      }
+      if (candidates == nullptr || it->second.size() < candidates->size())
+      {
+        candidates = &(it->second);
+      }
+    }
+
+    for (U32 entryIndex : *candidates)
+    {
+      const Entry& entry = m_entries[entryIndex];
+      if (entry.m_alive && entry.m_lowerName.find(lowerQuery) != std::string::npos)
+      {
+        result.emplace_back(entry.m_key);
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  bool HierarchyTree::Add(Key key, const std::string& name, Key parent)
+  {
+    if (key == c_ROOT || Contains(key)
+      || (parent != c_ROOT && !Contains(parent)))
+    {
+      return false;
+    }
+
+    Node& node = m_nodes[key];
+    node.m_key = key;
+    node.m_parent = parent;
+    node.m_name = name;
+    ChildrenOf(parent).emplace_back(key);
+    m_searchIndex.Insert(key, name);
+
+    int row = GetChildInsertRow(parent);
+    if (row >= 0)
+    {
+      int depth = parent == c_ROOT ? 0 : m_rows[FindNode(parent)->m_row].m_depth + 1;
+      InsertRows(row, node, depth);
+    }
+
+    m_filterDirty = true;
+    return true;
+  }
+
+  bool HierarchyTree::Remove(Key key)
+  {
+    Node* node = FindNode(key);
+    if (node == nullptr)
+    {
+      return false;
+    }
+
+    if (node->m_row >= 0)
+    {
+      EraseRows(node->m_row, GetSubtreeRowEnd(node->m_row));
+    }
+    DetachFromParent(*node);
+
+    //Children take the place of the removed node
+    Key parent = node->m_parent;
+    std::vector<Key> children;
+    children.swap(node->m_children);
+    for (Key childKey : children)
+    {
+      Node& child = *FindNode(childKey);
+      child.m_parent = parent;
+      ChildrenOf(parent).emplace_back(childKey);
+
+      int row = GetChildInsertRow(parent);
+      if (row >= 0)
+      {
+        int depth = parent == c_ROOT ? 0 : m_rows[FindNode(parent)->m_row].m_depth + 1;
+        InsertRows(row, child, depth);
+      }
+    }
+
+    m_searchIndex.Remove(key);
+    m_selection.erase(key);
+    m_nodes.erase(key);
+    m_filterDirty = true;
+    return true;
+  }
+
+  bool HierarchyTree::Reparent(Key key, Key parent)
+  {
+    Node* node = FindNode(key);
+    if (node == nullptr || (parent != c_ROOT && !Contains(parent)))
+    {
+      return false;
+    }
+    if (node->m_parent == parent)
+    {
+      return true;
+    }
+
+    //Can't move a node under itself
+    for (Key ancestor = parent; ancestor != c_ROOT; ancestor = FindNode(ancestor)->m_parent)
+    {
+      if (ancestor == key)
+      {
+        return false;
+      }
+    }
+
+    if (node->m_row >= 0)
+    {
+      EraseRows(node->m_row, GetSubtreeRowEnd(node->m_row));
+    }
+    DetachFromParent(*node);
+
+    node->m_parent = parent;
+    ChildrenOf(parent).emplace_back(key);
+
+    int row = GetChildInsertRow(parent);
+    if (row >= 0)
+    {
+      int depth = parent == c_ROOT ? 0 : m_rows[FindNode(parent)->m_row].m_depth + 1;
+      InsertRows(row, *node, depth);
+    }
+
+    m_filterDirty = true;
+    return true;
+  }
+
+  void HierarchyTree::Rename(Key key, const std::string& name)
+  {
+    Node* node = FindNode(key);
+    if (node != nullptr && node->m_name != name)
+    {
+      node->m_name = name;
+      m_searchIndex.Insert(key, name);
+      m_filterDirty = true;
+    }
+  }
+
+  void HierarchyTree::Clear(void)
+  {
+    m_nodes.clear();
+    m_rootChildren.clear();
+    m_selection.clear();
+    m_rows.clear();
+    m_rowNodes.clear();
+    m_searchIndex.Clear();
+    m_filteredRows.clear();
+    m_filterDirty = true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  HierarchyTree::Key HierarchyTree::GetParent(Key key) const
+  {
+    const Node* node = FindNode(key);
+    return node != nullptr ? node->m_parent : c_ROOT;
+  }
+
+  const std::string& HierarchyTree::GetName(Key key) const
+  {
+    static const std::string s_empty;
+    const Node* node = FindNode(key);
+    return node != nullptr ? node->m_name : s_empty;
+  }
+
+  bool HierarchyTree::HasChildren(Key key) const
+  {
+    const Node* node = FindNode(key);
+    return node != nullptr && !node->m_children.empty();
+  }
+
+  const std::vector<HierarchyTree::Key>& HierarchyTree::GetChildren(Key key) const
+  {
+    static const std::vector<Key> s_empty;
+    if (key == c_ROOT)
+    {
+      return m_rootChildren;
+    }
+    const Node* node = FindNode(key);
+    return node != nullptr ? node->m_children : s_empty;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void HierarchyTree::SetExpanded(Key key, bool expanded)
+  {
+    Node* node = FindNode(key);
+    if (node == nullptr || node->m_expanded == expanded)
+    {
+      return;
+    }
+    node->m_expanded = expanded;
+
+    //Only the rows below a visible node change
+    if (node->m_row < 0)
+    {
+      return;
+    }
+
+    int row = node->m_row;
+    if (expanded)
+    {
+      std::vector<Row> rows;
+      std::vector<Node*> rowNodes;
+      int depth = m_rows[row].m_depth + 1;
+      for (Key childKey : node->m_children)
+      {
+        CollectRows(*FindNode(childKey), depth, rows, rowNodes);
+      }
+      m_rows.insert(m_rows.begin() + row + 1, rows.begin(), rows.end());
+      m_rowNodes.insert(m_rowNodes.begin() + row + 1, rowNodes.begin(), rowNodes.end());
+      RefreshRowIndices(row + 1);
+    }
+    else
+    {
+      EraseRows(row + 1, GetSubtreeRowEnd(row));
+    }
+  }
+
+  bool HierarchyTree::IsExpanded(Key key) const
+  {
+    const Node* node = FindNode(key);
+    return node != nullptr && node->m_expanded;
+  }
+
+  void HierarchyTree::Select(Key key, bool additive)
+  {
+    if (!additive)
+    {
+      m_selection.clear();
+    }
+    if (Contains(key))
+    {
+      m_selection.insert(key);
+    }
+  }
+
+  void HierarchyTree::SetFilter(const std::string& filter)
+  {
+    if (m_filter != filter)
+    {
+      m_filter = filter;
+      m_filterDirty = true;
+    }
+  }
+
+  const std::vector<HierarchyTree::Row>& HierarchyTree::GetRows(void)
+  {
+    if (m_filter.empty())
+    {
+      return m_rows;
+    }
+
+    if (m_filterDirty)
+    {
+      BuildFilteredRows();
+      m_filterDirty = false;
+    }
+    return m_filteredRows;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  HierarchyTree::Node* HierarchyTree::FindNode(Key key)
+  {
+    auto it = m_nodes.find(key);
+    return it != m_nodes.end() ? &(it->second) : nullptr;
+  }
+
+  const HierarchyTree::Node* HierarchyTree::FindNode(Key key) const
+  {
+    auto it = m_nodes.find(key);
+    return it != m_nodes.end() ? &(it->second) : nullptr;
+  }
+
+  std::vector<HierarchyTree::Key>& HierarchyTree::ChildrenOf(Key parent)
+  {
+    return parent == c_ROOT ? m_rootChildren : FindNode(parent)->m_children;
+  }
+
+  int HierarchyTree::GetChildInsertRow(Key parent)
+  {
+    if (parent == c_ROOT)
+    {
+      return static_cast<int>(m_rows.size());
+    }
+
+    Node* node = FindNode(parent);
+    if (node->m_row < 0 || !node->m_expanded)
+    {
+      return -1;
+    }
+    return GetSubtreeRowEnd(node->m_row);
+  }
+
+  int HierarchyTree::GetSubtreeRowEnd(int row) const
+  {
+    //Descendant rows follow their ancestor with a greater depth
+    int depth = m_rows[row].m_depth;
+    int end = row + 1;
+    while (end < (int)m_rows.size() && m_rows[end].m_depth > depth)
+    {
+      ++end;
+    }
+    return end;
+  }
+
+  void HierarchyTree::CollectRows(Node& node, int depth, std::vector<Row>& rows
+    , std::vector<Node*>& rowNodes)
+  {
+    //Depth first, iterative so deep chains don't overflow the stack
+    std::vector<std::pair<Node*, int>> stack;
+    stack.emplace_back(&node, depth);
+    while (!stack.empty())
+    {
+      auto current = stack.back();
+      stack.pop_back();
+
+      rows.emplace_back(Row{ current.first->m_key, current.second });
+      rowNodes.emplace_back(current.first);
+
+      if (current.first->m_expanded)
+      {
+        auto& children = current.first->m_children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+          stack.emplace_back(FindNode(*it), current.second + 1);
+        }
+      }
+    }
+  }
+
+  void HierarchyTree::InsertRows(int position, Node& node, int depth)
+  {
+    std::vector<Row> rows;
+    std::vector<Node*> rowNodes;
+    CollectRows(node, depth, rows, rowNodes);
+
+    m_rows.insert(m_rows.begin() + position, rows.begin(), rows.end());
+    m_rowNodes.insert(m_rowNodes.begin() + position, rowNodes.begin(), rowNodes.end());
+    RefreshRowIndices(position);
+  }
+
+  void HierarchyTree::EraseRows(int begin, int end)
+  {
+    for (int i = begin; i < end; ++i)
+    {
+      m_rowNodes[i]->m_row = -1;
+    }
+    m_rows.erase(m_rows.begin() + begin, m_rows.begin() + end);
+    m_rowNodes.erase(m_rowNodes.begin() + begin, m_rowNodes.begin() + end);
+    RefreshRowIndices(begin);
+  }
+
+  void HierarchyTree::RefreshRowIndices(int from)
+  {
+    for (int i = from; i < (int)m_rowNodes.size(); ++i)
+    {
+      m_rowNodes[i]->m_row = i;
+    }
+  }
+
+  void HierarchyTree::DetachFromParent(Node& node)
+  {
+    auto& siblings = ChildrenOf(node.m_parent);
+    auto it = std::find(siblings.begin(), siblings.end(), node.m_key);
+    if (it != siblings.end())
+    {
+      siblings.erase(it);
+    }
+  }
+
+  void HierarchyTree::BuildFilteredRows(void)
+  {
+    m_filteredRows.clear();
+
+    std::vector<Key> matches;
+    m_searchIndex.Search(m_filter, matches);
+
+    //Matches with their ancestors, shown as if expanded
+    std::unordered_set<Key> shown;
+    for (Key key : matches)
+    {
+      for (Key current = key; current != c_ROOT; current = FindNode(current)->m_parent)
+      {
+        if (!shown.insert(current).second)
+        {
+          break;
+        }
+      }
+    }
+
+    std::vector<std::pair<Key, int>> stack;
+    for (auto it = m_rootChildren.rbegin(); it != m_rootChildren.rend(); ++it)
+    {
+      if (shown.count(*it) > 0)
+      {
+        stack.emplace_back(*it, 0);
+      }
+    }
+
+    while (!stack.empty())
+    {
+      auto current = stack.back();
+      stack.pop_back();
+      m_filteredRows.emplace_back(Row{ current.first, current.second });
+
+      auto& children = FindNode(current.first)->m_children;
+      for (auto it = children.rbegin(); it != children.rend(); ++it)
+      {
+        if (shown.count(*it) > 0)
+        {
+          stack.emplace_back(*it, current.second + 1);
+        }
+      }
+    }
+  }
+}
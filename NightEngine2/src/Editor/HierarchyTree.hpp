@@ -0,0 +1,160 @@
+/*!
+  @file HierarchyTree.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of HierarchyTree
+*/
+#pragma once
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Editor
+{
+  //! @brief Case insensitive substring search over names. Each trigram of a name
+  // has a posting list, a query only compare the names of its rarest trigram.
+  class NameSearchIndex
+  {
+  public:
+    using Key = NightEngine::Container::U64;
+
+    //! @brief Add a name, or replace the name of key
+    void Insert(Key key, const std::string& name);
+
+    //! @brief Remove key
+    void Remove(Key key);
+
+    //! @brief Remove everything
+    void Clear(void);
+
+    //! @brief Check if key is indexed
+    bool Contains(Key key) const { return m_keyToEntry.find(key) != m_keyToEntry.end(); }
+
+    //! @brief Number of indexed names
+    size_t GetCount(void) const { return m_keyToEntry.size(); }
+
+    //! @brief Keys whose name contain query, in insertion order. An empty query match everything.
+    void Search(const std::string& query, std::vector<Key>& result) const;
+  private:
+    struct Entry
+    {
+      Key         m_key;
+      std::string m_lowerName;
+      bool        m_alive;
+    };
+
+    void AddEntry(Key key, const std::string& name);
+    void Compact(void);
+
+    std::vector<Entry>                                            m_entries;
+    std::unordered_map<Key, NightEngine::Container::U32>          m_keyToEntry;
+    std::unordered_map<NightEngine::Container::U32
+      , std::vector<NightEngine::Container::U32>>                 m_trigrams;
+    size_t                                                        m_deadCount = 0;
+  };
+
+  //! @brief Parent/child tree of the hierarchy view flattened into the rows to draw.
+  // The rows are patched on add, remove, reparent and expand instead of walking the
+  // whole tree every frame. Expansion and selection are stored by key.
+  class HierarchyTree
+  {
+  public:
+    using Key = NightEngine::Container::U64;
+    static constexpr Key c_ROOT = ~Key(0);
+
+    struct Row
+    {
+      Key m_key;
+      int m_depth;
+    };
+
+    //! @brief Add a node under parent, false if key exist or parent doesn't
+    bool Add(Key key, const std::string& name, Key parent = c_ROOT);
+
+    //! @brief Remove a node, its children move to its parent
+    bool Remove(Key key);
+
+    //! @brief Move a node under parent, false if it would make a cycle
+    bool Reparent(Key key, Key parent);
+
+    //! @brief Change the searchable name of a node
+    void Rename(Key key, const std::string& name);
+
+    //! @brief Remove every node
+    void Clear(void);
+
+    //*****************************************************
+    // Tree Query
+    //*****************************************************
+    bool Contains(Key key) const { return m_nodes.find(key) != m_nodes.end(); }
+    size_t GetNodeCount(void) const { return m_nodes.size(); }
+    Key GetParent(Key key) const;
+    const std::string& GetName(Key key) const;
+    bool HasChildren(Key key) const;
+
+    //! @brief Children in insertion order, c_ROOT for the top level nodes
+    const std::vector<Key>& GetChildren(Key key) const;
+
+    //*****************************************************
+    // View State
+    //*****************************************************
+    void SetExpanded(Key key, bool expanded);
+    bool IsExpanded(Key key) const;
+
+    //! @brief Select key, keep the other selected nodes if additive
+    void Select(Key key, bool additive);
+    void ClearSelection(void) { m_selection.clear(); }
+    bool IsSelected(Key key) const { return m_selection.find(key) != m_selection.end(); }
+    const std::unordered_set<Key>& GetSelection(void) const { return m_selection; }
+
+    //! @brief Only show the nodes whose name contain filter, with their ancestors
+    void SetFilter(const std::string& filter);
+    const std::string& GetFilter(void) const { return m_filter; }
+
+    //! @brief Visible rows in draw order
+    const std::vector<Row>& GetRows(void);
+  private:
+    struct Node
+    {
+      Key               m_key;
+      Key               m_parent;
+      std::vector<Key>  m_children;
+      std::string       m_name;
+      int               m_row = -1;       //Index in m_rows, -1 if collapsed away
+      bool              m_expanded = false;
+    };
+
+    Node* FindNode(Key key);
+    const Node* FindNode(Key key) const;
+    std::vector<Key>& ChildrenOf(Key parent);
+
+    //! @brief Row where a new child subtree of parent go, -1 if parent's children aren't visible
+    int GetChildInsertRow(Key parent);
+    int GetSubtreeRowEnd(int row) const;
+
+    void CollectRows(Node& node, int depth, std::vector<Row>& rows
+      , std::vector<Node*>& rowNodes);
+    void InsertRows(int position, Node& node, int depth);
+    void EraseRows(int begin, int end);
+    void RefreshRowIndices(int from);
+
+    void DetachFromParent(Node& node);
+    void BuildFilteredRows(void);
+
+    std::unordered_map<Key, Node> m_nodes;
+    std::vector<Key>              m_rootChildren;
+    std::unordered_set<Key>       m_selection;
+
+    //Rows of the unfiltered tree, kept up to date
+    std::vector<Row>              m_rows;
+    std::vector<Node*>            m_rowNodes;
+
+    //Rows of the filtered tree, rebuilt when dirty
+    NameSearchIndex               m_searchIndex;
+    std::string                   m_filter;
+    std::vector<Row>              m_filteredRows;
+    bool                          m_filterDirty = false;
+  };
+}
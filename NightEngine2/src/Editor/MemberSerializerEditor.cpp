@@ -331,6 +331,9 @@ namespace Editor
         //ImGui::InputScalar(pair.first.c_str(), ImGuiDataType_S32, (int*)val);
         IMGUI::DrawIntProperty(data, pair.first.c_str(), (int*)val);
       }
+
+      //Values may have been edited, repack them into the MaterialBuffer
+      material.MarkConstantsDirty();
     }
       });
 
@@ -0,0 +1,74 @@
+/*!
+  @file MemoryStatsView.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MemoryStatsView
+*/
+
+#include "Editor/MemoryStatsView.hpp"
+#include "imgui/imgui.h"
+
+#include "Core/Container/Allocator.hpp"
+#include "Core/GameTime.hpp"
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace Editor
+{
+  static const float c_KB = 1024.0f;
+
+  void MemoryStatsView::Update(void)
+  {
+    if (m_show)
+    {
+      Draw(&m_show);
+    }
+  }
+
+  void MemoryStatsView::Draw(bool* show)
+  {
+    ImGui::SetNextWindowSize(ImVec2(460, 300), ImGuiCond_Appearing);
+    ImGui::SetNextWindowPos(ImVec2(340, 40), ImGuiCond_Appearing);
+
+    //********************************************************
+    // Window
+    //********************************************************
+    if (ImGui::Begin("Memory Stats", show, ImGuiWindowFlags_NoSavedSettings))
+    {
+      auto& gameTime = GameTime::GetInstance();
+      ImGui::Text("Heap allocations last frame: %llu"
+        , static_cast<unsigned long long>(gameTime.m_frameHeapAllocations));
+      ImGui::Text("Heap allocations total: %llu"
+        , static_cast<unsigned long long>(TaggedHeap::GetGlobalAllocationCount()));
+
+      LinearArena& frameArena = GetFrameArena();
+      ImGui::Text("Frame arena: %.1f / %.1f KB (peak %.1f KB)"
+        , frameArena.GetUsedBytes() / c_KB, frameArena.GetCapacity() / c_KB
+        , frameArena.GetPeakBytes() / c_KB);
+      ImGui::Separator();
+
+      //Per-tag table
+      ImGui::Columns(5, "MemoryTagColumns");
+      ImGui::Text("Tag"); ImGui::NextColumn();
+      ImGui::Text("Live KB"); ImGui::NextColumn();
+      ImGui::Text("Peak KB"); ImGui::NextColumn();
+      ImGui::Text("Live Allocs"); ImGui::NextColumn();
+      ImGui::Text("Total Allocs"); ImGui::NextColumn();
+      ImGui::Separator();
+
+      for (size_t i = 0; i < static_cast<size_t>(MemoryTag::COUNT); ++i)
+      {
+        MemoryTag tag = static_cast<MemoryTag>(i);
+        MemoryTagStats stats = TaggedHeap::GetStats(tag);
+
+        ImGui::Text("%s", TaggedHeap::GetTagName(tag)); ImGui::NextColumn();
+        ImGui::Text("%.1f", stats.m_liveBytes / c_KB); ImGui::NextColumn();
+        ImGui::Text("%.1f", stats.m_peakBytes / c_KB); ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stats.m_liveAllocations)); ImGui::NextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(stats.m_totalAllocations)); ImGui::NextColumn();
+      }
+      ImGui::Columns(1);
+    }
+    ImGui::End();
+  }
+}
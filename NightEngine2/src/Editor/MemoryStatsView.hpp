@@ -0,0 +1,28 @@
+/*!
+  @file MemoryStatsView.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MemoryStatsView
+*/
+
+#pragma once
+namespace Editor
+{
+  class MemoryStatsView
+  {
+  public:
+    //! @brief Constructor
+    MemoryStatsView(void) {}
+
+    //! @brief Update
+    void Update(void);
+
+    //! @brief Draw the per-tag memory statistics
+    void Draw(bool* show);
+
+    //! @brief Get reference to boolean
+    bool& GetBool(void) { return m_show; }
+  private:
+    bool m_show = false;
+  };
+
+}
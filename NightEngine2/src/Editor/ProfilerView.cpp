@@ -0,0 +1,223 @@
+/*!
+  @file ProfilerView.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ProfilerView
+*/
+
+#include "Editor/ProfilerView.hpp"
+#include "imgui/imgui.h"
+
+#include "Core/Serialization/FileSystem.hpp"
+#include "Core/Container/Allocator.hpp"
+#include "Graphics/Opengl/Window.hpp"
+
+#include <algorithm>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+using namespace NightEngine::Rendering::Opengl;
+
+namespace Editor
+{
+  static const float c_ROW_HEIGHT = 18.0f;
+  static const float c_LANE_HEADER_HEIGHT = 16.0f;
+  static const size_t c_MAX_LANES = 64;
+
+  //! @brief Stable color per zone name
+  static ImU32 GetZoneColor(const char* name)
+  {
+    //FNV-1a, no std::string temporary per zone
+    U32 hash = 2166136261u;
+    for (; *name != '\0'; ++name)
+    {
+      hash = (hash ^ static_cast<U8>(*name)) * 16777619u;
+    }
+    float hue = static_cast<float>(hash % 360) / 360.0f;
+    return ImColor::HSV(hue, 0.55f, 0.75f);
+  }
+
+  void ProfilerView::Update(void)
+  {
+    if (m_show)
+    {
+      if (!m_paused)
+      {
+        RefreshZones();
+      }
+      Draw(&m_show);
+    }
+  }
+
+  void ProfilerView::RefreshZones(void)
+  {
+    m_events.clear();
+    m_zones.clear();
+    m_laneThreads.clear();
+    m_laneDepths.clear();
+
+    //Previous frame is the last complete one
+    m_frameBegin = Profiling::GetFrameTimestamp(1);
+    m_frameEnd = Profiling::GetFrameTimestamp(0);
+    if (m_frameBegin == 0 || m_frameEnd <= m_frameBegin)
+    {
+      return;
+    }
+    Profiling::CaptureEvents(m_frameBegin, m_frameEnd, m_events);
+
+    //Main thread always on top
+    m_laneThreads.emplace_back(Profiling::GetMainThreadIndex());
+    m_laneDepths.emplace_back(0);
+
+    //Rebuild zones with a stack per lane, scratch memory live in the frame arena
+    struct OpenZone { U64 m_begin; const char* m_name; };
+    FrameVector<FrameVector<OpenZone>> stacks;
+    stacks.reserve(c_MAX_LANES);
+    stacks.emplace_back();
+    for (auto& captured : m_events)
+    {
+      auto found = std::find(m_laneThreads.begin(), m_laneThreads.end(), captured.m_threadIndex);
+      U32 lane = static_cast<U32>(found - m_laneThreads.begin());
+      if (found == m_laneThreads.end())
+      {
+        m_laneThreads.emplace_back(captured.m_threadIndex);
+        m_laneDepths.emplace_back(0);
+        stacks.emplace_back();
+      }
+
+      auto& stack = stacks[lane];
+      const Profiling::ProfileEvent& ev = captured.m_event;
+      if (ev.m_type == Profiling::EventType::ZONE_BEGIN)
+      {
+        stack.emplace_back(OpenZone{ ev.m_timestamp, ev.m_name });
+      }
+      else if (ev.m_type == Profiling::EventType::ZONE_END)
+      {
+        //Zones started in the earlier frame are clamped to the frame begin
+        U32 depth = static_cast<U32>(stack.size());
+        U64 begin = m_frameBegin;
+        if (!stack.empty())
+        {
+          begin = stack.back().m_begin;
+          stack.pop_back();
+          --depth;
+        }
+        m_zones.emplace_back(Zone{ begin, ev.m_timestamp, ev.m_name, depth, lane });
+        m_laneDepths[lane] = std::max(m_laneDepths[lane], depth + 1);
+      }
+    }
+
+    //Zones still open at the end of the frame are clamped to the frame end
+    for (U32 lane = 0; lane < stacks.size(); ++lane)
+    {
+      auto& stack = stacks[lane];
+      for (U32 depth = 0; depth < stack.size(); ++depth)
+      {
+        m_zones.emplace_back(Zone{ stack[depth].m_begin, m_frameEnd
+          , stack[depth].m_name, depth, lane });
+        m_laneDepths[lane] = std::max(m_laneDepths[lane], depth + 1);
+      }
+    }
+  }
+
+  void ProfilerView::Draw(bool* show)
+  {
+    float width = Window::GetWidth() * 0.6f;
+    ImGui::SetNextWindowPos(ImVec2(Window::GetWidth() * 0.2f, 40.0f), ImGuiCond_Appearing);
+    ImGui::SetNextWindowSize(ImVec2(width, 320.0f), ImGuiCond_Appearing);
+
+    //********************************************************
+    // Window
+    //********************************************************
+    if (ImGui::Begin("Profiler", show, ImGuiWindowFlags_NoSavedSettings))
+    {
+      bool enabled = Profiling::IsEnabled();
+      if (ImGui::Checkbox("Enabled", &enabled))
+      {
+        Profiling::SetEnabled(enabled);
+      }
+      ImGui::SameLine();
+      ImGui::Checkbox("Pause", &m_paused);
+      ImGui::SameLine();
+      ImGui::PushItemWidth(120.0f);
+      ImGui::SliderInt("Frames", &m_captureFrameCount, 1, Profiling::c_FRAME_HISTORY - 2);
+      ImGui::PopItemWidth();
+      ImGui::SameLine();
+      if (ImGui::Button("Capture"))
+      {
+        Profiling::CaptureLastFrames(static_cast<U32>(m_captureFrameCount)
+          , FileSystem::GetFilePath("nightengine2_profile_capture.json"
+            , FileSystem::DirectoryType::Assets));
+      }
+
+      if (m_frameEnd <= m_frameBegin)
+      {
+        ImGui::Text("No complete frame recorded yet");
+        ImGui::End();
+        return;
+      }
+
+      double frameMS = Profiling::TicksToMicroseconds(m_frameEnd - m_frameBegin) / 1000.0;
+      ImGui::Text("Frame: %.3f ms, %u events", frameMS, static_cast<unsigned>(m_events.size()));
+      ImGui::Separator();
+
+      //********************************************************
+      // Flame view
+      //********************************************************
+      ImGui::BeginChild("FlameView", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+      {
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        float viewWidth = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+        double pixelPerTick = viewWidth / static_cast<double>(m_frameEnd - m_frameBegin);
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+
+        //Lane offsets
+        FrameVector<float> laneOffsets(m_laneThreads.size(), 0.0f);
+        float totalHeight = 0.0f;
+        for (size_t lane = 0; lane < m_laneThreads.size(); ++lane)
+        {
+          laneOffsets[lane] = totalHeight;
+
+          char header[64];
+          snprintf(header, sizeof(header), lane == 0 ? "Main Thread %u" : "Thread %u"
+            , m_laneThreads[lane]);
+          drawList->AddText(ImVec2(origin.x, origin.y + totalHeight)
+            , ImGui::GetColorU32(ImGuiCol_Text), header);
+
+          totalHeight += c_LANE_HEADER_HEIGHT + m_laneDepths[lane] * c_ROW_HEIGHT;
+        }
+
+        for (auto& zone : m_zones)
+        {
+          float x0 = origin.x + static_cast<float>((zone.m_begin - m_frameBegin) * pixelPerTick);
+          float x1 = origin.x + static_cast<float>((zone.m_end - m_frameBegin) * pixelPerTick);
+          float y0 = origin.y + laneOffsets[zone.m_lane] + c_LANE_HEADER_HEIGHT
+            + zone.m_depth * c_ROW_HEIGHT;
+          float y1 = y0 + c_ROW_HEIGHT - 1.0f;
+          x1 = std::max(x1, x0 + 1.0f);
+
+          drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), GetZoneColor(zone.m_name));
+
+          //Only label zones wide enough for the text
+          ImVec2 textSize = ImGui::CalcTextSize(zone.m_name);
+          if (textSize.x + 4.0f < x1 - x0)
+          {
+            drawList->AddText(ImVec2(x0 + 2.0f, y0 + 1.0f), IM_COL32(255, 255, 255, 255), zone.m_name);
+          }
+
+          if (mouse.x >= x0 && mouse.x <= x1 && mouse.y >= y0 && mouse.y <= y1
+            && ImGui::IsWindowHovered())
+          {
+            double zoneMS = Profiling::TicksToMicroseconds(zone.m_end - zone.m_begin) / 1000.0;
+            ImGui::SetTooltip("%s: %.3f ms", zone.m_name, zoneMS);
+          }
+        }
+
+        //Reserve the drawn area for scrolling
+        ImGui::Dummy(ImVec2(viewWidth, totalHeight));
+      }
+      ImGui::EndChild();
+    }
+    ImGui::End();
+  }
+}
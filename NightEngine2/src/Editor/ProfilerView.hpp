@@ -0,0 +1,52 @@
+/*!
+  @file ProfilerView.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ProfilerView
+*/
+
+#pragma once
+#include "Core/Utility/Profiling.hpp"
+
+namespace Editor
+{
+  class ProfilerView
+  {
+  public:
+    //! @brief Constructor
+    ProfilerView(void) {}
+
+    //! @brief Update
+    void Update(void);
+
+    //! @brief Draw the flame view of the last complete frame
+    void Draw(bool* show);
+
+    //! @brief Get reference to boolean
+    bool& GetBool(void) { return m_show; }
+  private:
+    //! @brief Zone rebuilt from a begin/end event pair
+    struct Zone
+    {
+      NightEngine::Container::U64 m_begin;
+      NightEngine::Container::U64 m_end;
+      const char*                 m_name;
+      NightEngine::Container::U32 m_depth;
+      NightEngine::Container::U32 m_lane;
+    };
+
+    //! @brief Capture the last complete frame and rebuild zones
+    void RefreshZones(void);
+
+    NightEngine::Container::Vector<NightEngine::Profiling::CapturedEvent> m_events;
+    NightEngine::Container::Vector<Zone> m_zones;
+    NightEngine::Container::Vector<NightEngine::Container::U32> m_laneThreads;
+    NightEngine::Container::Vector<NightEngine::Container::U32> m_laneDepths;
+    NightEngine::Container::U64 m_frameBegin = 0;
+    NightEngine::Container::U64 m_frameEnd = 0;
+
+    int  m_captureFrameCount = 120;
+    bool m_paused = false;
+    bool m_show = false;
+  };
+
+}
@@ -207,6 +207,52 @@ namespace Editor
               ImGui::Unindent();
             }
 
+            if (ImGui::CollapsingHeader("Dynamic Resolution", treeNodeFlag))
+            {
+              ImGui::Indent();
+              {
+                //Only applied while TAA run before tonemapping
+                ImGui::Checkbox("Enable Dynamic Resolution", &(rlgl->enableDynamicResolution));
+
+                auto& settings = rlgl->m_dynamicResolution.m_settings;
+                static float s_tfm_min = 1.0f;
+                static float s_tfm_max = 100.0f;
+                ImGui::DragScalar("Target Frame Time (ms)", ImGuiDataType_Float
+                  , &(settings.m_targetFrameMs), 0.1f, &s_tfm_min, &s_tfm_max);
+
+                static float s_ms_min = 0.25f;
+                static float s_ms_max = 1.0f;
+                ImGui::DragScalar("Min Scale", ImGuiDataType_Float
+                  , &(settings.m_minScale), 0.01f, &s_ms_min, &s_ms_max);
+
+                ImGui::Text("GPU Frame Time: %.2f ms", rlgl->m_dynamicResolution.GetFilteredFrameMs());
+                ImGui::Text("Dynamic Scale: %.2f (%dx%d)", rlgl->m_camera.m_dynamicScale
+                  , rlgl->m_camera.m_viewportPixelResolution.x, rlgl->m_camera.m_viewportPixelResolution.y);
+              }
+              ImGui::Unindent();
+            }
+
+            if (ImGui::CollapsingHeader("Occlusion Culling", treeNodeFlag))
+            {
+              ImGui::Indent();
+              {
+                //MeshRenderers flagged as occluder hide the others
+                ImGui::Checkbox("Enable Occlusion Culling", &(rlgl->enableOcclusionCulling));
+
+                static int s_obw_min = 64;
+                static int s_obw_max = 1024;
+                ImGui::DragScalar("Buffer Width", ImGuiDataType_S32
+                  , &(rlgl->m_occlusionCulling.m_bufferWidth), 1.0f, &s_obw_min, &s_obw_max);
+
+                auto& stats = rlgl->m_occlusionCulling.GetStats();
+                ImGui::Text("Occluders: %d (%d triangles)", (int)stats.m_occluderCount
+                  , (int)stats.m_occluderTriangles);
+                ImGui::Text("Occluded: %d / %d", (int)stats.m_occludedCount, (int)stats.m_testedCount);
+                ImGui::Text("CPU Time: %.2f ms", stats.m_cpuMs);
+              }
+              ImGui::Unindent();
+            }
+
             if (ImGui::CollapsingHeader("Shadows Settings", treeNodeFlag))
             {
               ImGui::Indent();
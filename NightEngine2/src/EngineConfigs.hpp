@@ -4,4 +4,11 @@
 #define DEBUG_MODE true
 #define EDITOR_MODE true
 
-#define STARTUP_RENDERDOC_ATTACHMENT false
\ No newline at end of file
+#define STARTUP_RENDERDOC_ATTACHMENT false
+
+//Cheap enough to stay on in release, runtime toggle with Profiling::SetEnabled()
+#define PROFILER_ENABLED true
+
+//Count every global operator new for the per-frame allocation stats,
+//replace the global new/delete so it is kept out of shipping builds
+#define MEMORY_TRACKING_ENABLED (DEBUG_MODE || EDITOR_MODE)
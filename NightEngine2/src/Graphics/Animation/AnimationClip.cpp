@@ -0,0 +1,506 @@
+/*!
+  @file AnimationClip.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of AnimationClip
+*/
+#include "Graphics/Animation/AnimationClip.hpp"
+#include "Graphics/Animation/Pose.hpp"
+
+#include "Core/Macros.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace NightEngine::Container;
+using namespace NightEngine::Simd;
+
+namespace NightEngine::Rendering::Animation
+{
+  static const float c_TIME_SCALE = 65535.0f;
+  static const float c_VEC3_SCALE = 65535.0f;
+  static const float c_ROTATION_SCALE = 32767.0f;
+
+  //Every component but the largest is in [-1/sqrt(2), 1/sqrt(2)]
+  static const float c_SQRT2 = 1.41421356f;
+
+  static glm::vec3 Interpolate(const glm::vec3& a, const glm::vec3& b, float t)
+  {
+    return a + (b - a) * t;
+  }
+
+  //! @brief Normalized lerp along the shortest path, what the SoA sampling does
+  static glm::quat Interpolate(const glm::quat& a, glm::quat b, float t)
+  {
+    if (glm::dot(a, b) < 0.0f)
+    {
+      b = -b;
+    }
+    return glm::normalize(a * (1.0f - t) + b * t);
+  }
+
+  static float GetError(const glm::vec3& a, const glm::vec3& b)
+  {
+    return glm::length(a - b);
+  }
+
+  //! @brief Angle between the rotations in radians. From the imaginary part of the
+  // difference, acos of the dot has no precision left for small angles
+  static float GetError(const glm::quat& a, const glm::quat& b)
+  {
+    glm::quat difference = a * glm::conjugate(b);
+    float sine = glm::length(glm::vec3(difference.x, difference.y, difference.z));
+    return 2.0f * std::asin(std::min(sine, 1.0f));
+  }
+
+  template<typename T>
+  static T SampleChannel(const Vector<AnimationKey<T>>& keys, float time, const T& defaultValue)
+  {
+    if (keys.empty())
+    {
+      return defaultValue;
+    }
+
+    auto upper = std::upper_bound(keys.begin(), keys.end(), time
+      , [](float t, const AnimationKey<T>& key) { return t < key.m_time; });
+    if (upper == keys.begin())
+    {
+      return keys.front().m_value;
+    }
+    if (upper == keys.end())
+    {
+      return keys.back().m_value;
+    }
+
+    auto lower = upper - 1;
+    float t = (time - lower->m_time) / (upper->m_time - lower->m_time);
+    return Interpolate(lower->m_value, upper->m_value, t);
+  }
+
+  //! @brief Drop the keys that interpolating their kept neighbours rebuild within tolerance.
+  // Each key is checked against the original keys, so the error doesn't add up
+  template<typename T>
+  static Vector<AnimationKey<T>> ReduceKeys(const Vector<AnimationKey<T>>& keys, float tolerance)
+  {
+    if (keys.size() <= 1)
+    {
+      return keys;
+    }
+
+    //A constant channel is one key
+    bool constant = std::all_of(keys.begin(), keys.end()
+      , [&keys, tolerance](const AnimationKey<T>& key) { return GetError(keys[0].m_value, key.m_value) <= tolerance; });
+    if (constant || keys.size() == 2)
+    {
+      return constant ? Vector<AnimationKey<T>>{ keys[0] } : keys;
+    }
+
+    Vector<AnimationKey<T>> kept{ keys[0] };
+    size_t anchor = 0;
+    for (size_t next = 2; next < keys.size(); ++next)
+    {
+      float duration = keys[next].m_time - keys[anchor].m_time;
+      bool fits = duration > 0.0f;
+      for (size_t i = anchor + 1; i < next && fits; ++i)
+      {
+        float t = (keys[i].m_time - keys[anchor].m_time) / duration;
+        fits = GetError(Interpolate(keys[anchor].m_value, keys[next].m_value, t), keys[i].m_value) <= tolerance;
+      }
+
+      if (!fits)
+      {
+        anchor = next - 1;
+        kept.emplace_back(keys[anchor]);
+      }
+    }
+    kept.emplace_back(keys.back());
+    return kept;
+  }
+
+  static U16 QuantizeTime(float time, float duration)
+  {
+    float normalized = std::min(std::max(time / duration, 0.0f), 1.0f);
+    return static_cast<U16>(std::lround(normalized * c_TIME_SCALE));
+  }
+
+  static CompressedClip::QuantizedVec3 QuantizeVec3(const glm::vec3& value
+    , const glm::vec3& min, const glm::vec3& extent)
+  {
+    CompressedClip::QuantizedVec3 result;
+    for (int i = 0; i < 3; ++i)
+    {
+      float normalized = extent[i] > 0.0f ? (value[i] - min[i]) / extent[i] : 0.0f;
+      normalized = std::min(std::max(normalized, 0.0f), 1.0f);
+      result.m_value[i] = static_cast<U16>(std::lround(normalized * c_VEC3_SCALE));
+    }
+    return result;
+  }
+
+  static glm::vec3 DequantizeVec3(const CompressedClip::QuantizedVec3& value
+    , const glm::vec3& min, const glm::vec3& extent)
+  {
+    return min + glm::vec3(value.m_value[0], value.m_value[1], value.m_value[2])
+      * (extent * (1.0f / c_VEC3_SCALE));
+  }
+
+  //! @brief Reduce then append a vector channel to the pools, return the kept range
+  static void CompressVec3Channel(const Vector<AnimationKey<glm::vec3>>& keys, const glm::vec3& defaultValue
+    , float tolerance, float duration, Vector<U16>& times, Vector<CompressedClip::QuantizedVec3>& values
+    , U32& outBegin, U32& outCount, glm::vec3& outMin, glm::vec3& outExtent)
+  {
+    Vector<AnimationKey<glm::vec3>> kept = keys.empty()
+      ? Vector<AnimationKey<glm::vec3>>{ { 0.0f, defaultValue } } : ReduceKeys(keys, tolerance);
+
+    glm::vec3 min = kept[0].m_value;
+    glm::vec3 max = kept[0].m_value;
+    for (auto& key : kept)
+    {
+      min = glm::min(min, key.m_value);
+      max = glm::max(max, key.m_value);
+    }
+
+    outBegin = static_cast<U32>(times.size());
+    outCount = static_cast<U32>(kept.size());
+    outMin = min;
+    outExtent = max - min;
+    for (auto& key : kept)
+    {
+      times.emplace_back(QuantizeTime(key.m_time, duration));
+      values.emplace_back(QuantizeVec3(key.m_value, outMin, outExtent));
+    }
+  }
+
+  //! @brief Keys around time in a channel, time is on the quantized scale
+  static void FindKeys(const U16* times, U32 count, float time
+    , U32& outKey0, U32& outKey1, float& outAlpha)
+  {
+    U32 upper = static_cast<U32>(std::upper_bound(times, times + count, time
+      , [](float t, U16 key) { return t < key; }) - times);
+    if (upper == 0 || upper == count)
+    {
+      outKey0 = outKey1 = upper == 0 ? 0 : count - 1;
+      outAlpha = 0.0f;
+      return;
+    }
+
+    outKey0 = upper - 1;
+    outKey1 = upper;
+    outAlpha = (time - times[outKey0]) / static_cast<float>(times[outKey1] - times[outKey0]);
+  }
+
+  template<typename T>
+  static void AppendPod(std::vector<char>& output, const T* data, size_t count)
+  {
+    auto bytes = reinterpret_cast<const char*>(data);
+    output.insert(output.end(), bytes, bytes + count * sizeof(T));
+  }
+
+  template<typename T>
+  static bool ReadPod(T* output, size_t count, const char* data, size_t size, size_t& offset)
+  {
+    if ((size - offset) / sizeof(T) < count)
+    {
+      return false;
+    }
+    std::memcpy(output, data + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+    return true;
+  }
+
+  template<typename T>
+  static void AppendVector(std::vector<char>& output, const Vector<T>& vector)
+  {
+    U32 count = static_cast<U32>(vector.size());
+    AppendPod(output, &count, 1);
+    AppendPod(output, vector.data(), vector.size());
+  }
+
+  template<typename T>
+  static bool ReadVector(Vector<T>& vector, const char* data, size_t size, size_t& offset)
+  {
+    U32 count = 0;
+    if (!ReadPod(&count, 1, data, size, offset) || (size - offset) / sizeof(T) < count)
+    {
+      return false;
+    }
+    vector.resize(count);
+    return ReadPod(vector.data(), count, data, size, offset);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void AnimationClip::Sample(const Skeleton& skeleton, float time, Vector<BoneTransform>& outPose) const
+  {
+    auto& bindPose = skeleton.GetBindPose();
+    outPose.resize(bindPose.size());
+    for (size_t i = 0; i < bindPose.size(); ++i)
+    {
+      if (i >= m_tracks.size())
+      {
+        outPose[i] = bindPose[i];
+        continue;
+      }
+
+      const AnimationTrack& track = m_tracks[i];
+      outPose[i].m_translation = SampleChannel(track.m_translations, time, bindPose[i].m_translation);
+      outPose[i].m_rotation = SampleChannel(track.m_rotations, time, bindPose[i].m_rotation);
+      outPose[i].m_scale = SampleChannel(track.m_scales, time, bindPose[i].m_scale);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void CompressedClip::Compress(const AnimationClip& clip, const Skeleton& skeleton
+    , const CompressionSettings& settings)
+  {
+    ASSERT_MSG(clip.m_tracks.size() <= skeleton.GetBoneCount()
+      , "CompressedClip: the clip has more tracks than the skeleton has bones");
+    *this = CompressedClip();
+    m_name = clip.m_name;
+    m_duration = std::max(clip.m_duration, 1e-4f);
+
+    auto& bindPose = skeleton.GetBindPose();
+    m_tracks.resize(bindPose.size());
+    for (size_t i = 0; i < bindPose.size(); ++i)
+    {
+      static const AnimationTrack s_emptyTrack;
+      const AnimationTrack& source = i < clip.m_tracks.size() ? clip.m_tracks[i] : s_emptyTrack;
+      Track& track = m_tracks[i];
+
+      CompressVec3Channel(source.m_translations, bindPose[i].m_translation
+        , settings.m_translationTolerance, m_duration, m_translationTimes, m_translations
+        , track.m_translationBegin, track.m_translationCount
+        , track.m_translationMin, track.m_translationExtent);
+      CompressVec3Channel(source.m_scales, bindPose[i].m_scale
+        , settings.m_scaleTolerance, m_duration, m_scaleTimes, m_scales
+        , track.m_scaleBegin, track.m_scaleCount
+        , track.m_scaleMin, track.m_scaleExtent);
+
+      Vector<AnimationKey<glm::quat>> rotations = source.m_rotations.empty()
+        ? Vector<AnimationKey<glm::quat>>{ { 0.0f, bindPose[i].m_rotation } }
+        : ReduceKeys(source.m_rotations, settings.m_rotationTolerance);
+      track.m_rotationBegin = static_cast<U32>(m_rotationTimes.size());
+      track.m_rotationCount = static_cast<U32>(rotations.size());
+      for (auto& key : rotations)
+      {
+        m_rotationTimes.emplace_back(QuantizeTime(key.m_time, m_duration));
+        m_rotations.emplace_back(QuantizeRotation(key.m_value));
+      }
+    }
+  }
+
+  void CompressedClip::Sample(float time, Pose& outPose) const
+  {
+    size_t boneCount = m_tracks.size();
+    outPose.Resize(boneCount);
+
+    float scaledTime = std::min(std::max(time / m_duration, 0.0f), 1.0f) * c_TIME_SCALE;
+    SoaTransform* soa = outPose.GetSoa();
+    for (size_t i = 0; i < outPose.GetSoaCount(); ++i)
+    {
+      //Both keys of each channel for 4 bones, the padding lanes stay the identity
+      alignas(16) float translation[2][3][4] = {};
+      alignas(16) float rotation[2][4][4] = {};
+      alignas(16) float scale[2][3][4] = {};
+      alignas(16) float alpha[3][4] = {};
+      for (int key = 0; key < 2; ++key)
+      {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+          rotation[key][3][lane] = 1.0f;
+          scale[key][0][lane] = scale[key][1][lane] = scale[key][2][lane] = 1.0f;
+        }
+      }
+
+      for (size_t lane = 0; lane < 4 && i * 4 + lane < boneCount; ++lane)
+      {
+        const Track& track = m_tracks[i * 4 + lane];
+        U32 key0, key1;
+
+        FindKeys(m_translationTimes.data() + track.m_translationBegin, track.m_translationCount
+          , scaledTime, key0, key1, alpha[0][lane]);
+        glm::vec3 t0 = DequantizeVec3(m_translations[track.m_translationBegin + key0]
+          , track.m_translationMin, track.m_translationExtent);
+        glm::vec3 t1 = DequantizeVec3(m_translations[track.m_translationBegin + key1]
+          , track.m_translationMin, track.m_translationExtent);
+
+        FindKeys(m_rotationTimes.data() + track.m_rotationBegin, track.m_rotationCount
+          , scaledTime, key0, key1, alpha[1][lane]);
+        glm::quat r0 = DequantizeRotation(m_rotations[track.m_rotationBegin + key0]);
+        glm::quat r1 = DequantizeRotation(m_rotations[track.m_rotationBegin + key1]);
+
+        FindKeys(m_scaleTimes.data() + track.m_scaleBegin, track.m_scaleCount
+          , scaledTime, key0, key1, alpha[2][lane]);
+        glm::vec3 s0 = DequantizeVec3(m_scales[track.m_scaleBegin + key0]
+          , track.m_scaleMin, track.m_scaleExtent);
+        glm::vec3 s1 = DequantizeVec3(m_scales[track.m_scaleBegin + key1]
+          , track.m_scaleMin, track.m_scaleExtent);
+
+        for (int c = 0; c < 3; ++c)
+        {
+          translation[0][c][lane] = t0[c];
+          translation[1][c][lane] = t1[c];
+          scale[0][c][lane] = s0[c];
+          scale[1][c][lane] = s1[c];
+        }
+        rotation[0][0][lane] = r0.x; rotation[0][1][lane] = r0.y;
+        rotation[0][2][lane] = r0.z; rotation[0][3][lane] = r0.w;
+        rotation[1][0][lane] = r1.x; rotation[1][1][lane] = r1.y;
+        rotation[1][2][lane] = r1.z; rotation[1][3][lane] = r1.w;
+      }
+
+      //Interpolate the 4 bones at once
+      SoaTransform& result = soa[i];
+      Float4 translationAlpha = Load(alpha[0]);
+      Float4 rotationAlpha = Load(alpha[1]);
+      Float4 scaleAlpha = Load(alpha[2]);
+      for (int c = 0; c < 3; ++c)
+      {
+        result.m_translation[c] = Lerp(Load(translation[0][c]), Load(translation[1][c]), translationAlpha);
+        result.m_scale[c] = Lerp(Load(scale[0][c]), Load(scale[1][c]), scaleAlpha);
+      }
+
+      Float4 r0[4], r1[4];
+      for (int c = 0; c < 4; ++c)
+      {
+        r0[c] = Load(rotation[0][c]);
+        r1[c] = Load(rotation[1][c]);
+      }
+      Float4 sign = SignBits(r0[0] * r1[0] + r0[1] * r1[1] + r0[2] * r1[2] + r0[3] * r1[3]);
+      for (int c = 0; c < 4; ++c)
+      {
+        result.m_rotation[c] = Lerp(r0[c], Xor(r1[c], sign), rotationAlpha);
+      }
+      Float4 inverseLength = RSqrt(result.m_rotation[0] * result.m_rotation[0]
+        + result.m_rotation[1] * result.m_rotation[1] + result.m_rotation[2] * result.m_rotation[2]
+        + result.m_rotation[3] * result.m_rotation[3]);
+      for (int c = 0; c < 4; ++c)
+      {
+        result.m_rotation[c] = result.m_rotation[c] * inverseLength;
+      }
+    }
+  }
+
+  size_t CompressedClip::GetKeyCount(void) const
+  {
+    return m_translations.size() + m_rotations.size() + m_scales.size();
+  }
+
+  size_t CompressedClip::GetSize(void) const
+  {
+    return m_tracks.size() * sizeof(Track)
+      + (m_translationTimes.size() + m_rotationTimes.size() + m_scaleTimes.size()) * sizeof(U16)
+      + (m_translations.size() + m_scales.size()) * sizeof(QuantizedVec3)
+      + m_rotations.size() * sizeof(QuantizedQuat);
+  }
+
+  void CompressedClip::Write(std::vector<char>& output) const
+  {
+    U32 length = static_cast<U32>(m_name.size());
+    AppendPod(output, &length, 1);
+    AppendPod(output, m_name.data(), length);
+    AppendPod(output, &m_duration, 1);
+    AppendVector(output, m_tracks);
+    AppendVector(output, m_translationTimes);
+    AppendVector(output, m_translations);
+    AppendVector(output, m_rotationTimes);
+    AppendVector(output, m_rotations);
+    AppendVector(output, m_scaleTimes);
+    AppendVector(output, m_scales);
+  }
+
+  bool CompressedClip::Read(const char* data, size_t size, size_t& offset)
+  {
+    *this = CompressedClip();
+
+    U32 length = 0;
+    if (!ReadPod(&length, 1, data, size, offset) || size - offset < length)
+    {
+      return false;
+    }
+    m_name.assign(data + offset, length);
+    offset += length;
+
+    if (!ReadPod(&m_duration, 1, data, size, offset) || !(m_duration > 0.0f)
+      || !ReadVector(m_tracks, data, size, offset)
+      || !ReadVector(m_translationTimes, data, size, offset)
+      || !ReadVector(m_translations, data, size, offset)
+      || !ReadVector(m_rotationTimes, data, size, offset)
+      || !ReadVector(m_rotations, data, size, offset)
+      || !ReadVector(m_scaleTimes, data, size, offset)
+      || !ReadVector(m_scales, data, size, offset))
+    {
+      return false;
+    }
+
+    //Every track range has to stay inside the pools
+    for (auto& track : m_tracks)
+    {
+      if (track.m_translationCount == 0 || track.m_rotationCount == 0 || track.m_scaleCount == 0
+        || size_t(track.m_translationBegin) + track.m_translationCount > m_translations.size()
+        || size_t(track.m_rotationBegin) + track.m_rotationCount > m_rotations.size()
+        || size_t(track.m_scaleBegin) + track.m_scaleCount > m_scales.size())
+      {
+        return false;
+      }
+    }
+    return m_translationTimes.size() == m_translations.size()
+      && m_rotationTimes.size() == m_rotations.size()
+      && m_scaleTimes.size() == m_scales.size();
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  CompressedClip::QuantizedQuat CompressedClip::QuantizeRotation(const glm::quat& rotation)
+  {
+    float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+    {
+      if (std::abs(components[i]) > std::abs(components[largest]))
+      {
+        largest = i;
+      }
+    }
+
+    //q and -q are the same rotation, keep the dropped component positive
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    QuantizedQuat result;
+    for (int i = 0, j = 0; i < 4; ++i)
+    {
+      if (i == largest)
+      {
+        continue;
+      }
+
+      float normalized = (components[i] * sign * c_SQRT2 + 1.0f) * 0.5f;
+      normalized = std::min(std::max(normalized, 0.0f), 1.0f);
+      result.m_value[j++] = static_cast<U16>(std::lround(normalized * c_ROTATION_SCALE));
+    }
+    result.m_value[0] |= static_cast<U16>((largest & 1) << 15);
+    result.m_value[1] |= static_cast<U16>((largest >> 1) << 15);
+    return result;
+  }
+
+  glm::quat CompressedClip::DequantizeRotation(const QuantizedQuat& rotation)
+  {
+    int largest = (rotation.m_value[0] >> 15) | ((rotation.m_value[1] >> 15) << 1);
+
+    float components[4];
+    float sum = 0.0f;
+    for (int i = 0, j = 0; i < 4; ++i)
+    {
+      if (i == largest)
+      {
+        continue;
+      }
+
+      float normalized = (rotation.m_value[j++] & 0x7FFF) / c_ROTATION_SCALE;
+      components[i] = (normalized * 2.0f - 1.0f) / c_SQRT2;
+      sum += components[i] * components[i];
+    }
+    components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+    return glm::quat(components[3], components[0], components[1], components[2]);
+  }
+}
@@ -0,0 +1,126 @@
+/*!
+  @file AnimationClip.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of AnimationClip
+*/
+#pragma once
+
+#include "Graphics/Animation/Skeleton.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+namespace NightEngine::Rendering::Animation
+{
+  class Pose;
+
+  //! @brief Value of a channel at a time in seconds
+  template<typename T>
+  struct AnimationKey
+  {
+    float m_time;
+    T     m_value;
+  };
+
+  //! @brief Keys of one bone sorted by time, an empty channel keep the bind pose
+  struct AnimationTrack
+  {
+    Container::Vector<AnimationKey<glm::vec3>> m_translations;
+    Container::Vector<AnimationKey<glm::quat>> m_rotations;
+    Container::Vector<AnimationKey<glm::vec3>> m_scales;
+  };
+
+  //! @brief Clip as imported, one track per skeleton bone. Only used to build a CompressedClip
+  struct AnimationClip
+  {
+    Container::String                 m_name;
+    float                             m_duration = 0.0f;
+    Container::Vector<AnimationTrack> m_tracks;
+
+    //! @brief Reference sampling of every bone at time, keys are linearly interpolated
+    void Sample(const Skeleton& skeleton, float time, Container::Vector<BoneTransform>& outPose) const;
+  };
+
+  //! @brief How far the compressed keys can drift from the imported ones
+  struct CompressionSettings
+  {
+    float m_translationTolerance = 0.0005f;   //Distance
+    float m_rotationTolerance = 0.0005f;      //Radians
+    float m_scaleTolerance = 0.0005f;
+  };
+
+  //! @brief Runtime clip. Keys that interpolation can rebuild within the tolerance are
+  // removed, the rest are quantized: times and vectors to 16 bits, rotations to the
+  // smallest three components at 15 bits. Sampling write a SoA Pose.
+  class CompressedClip
+  {
+    public:
+      //! @brief Reduce and quantize clip, its tracks must match the skeleton bones
+      void Compress(const AnimationClip& clip, const Skeleton& skeleton
+        , const CompressionSettings& settings = CompressionSettings());
+
+      //! @brief Pose at time, clamped to the clip. outPose is resized to the bone count
+      void Sample(float time, Pose& outPose) const;
+
+      const Container::String& GetName(void) const { return m_name; }
+
+      float GetDuration(void) const { return m_duration; }
+
+      size_t GetBoneCount(void) const { return m_tracks.size(); }
+
+      //! @brief Keys left in every channel of every track
+      size_t GetKeyCount(void) const;
+
+      //! @brief Bytes used by the keys and tracks
+      size_t GetSize(void) const;
+
+      //! @brief Append the clip to a binary blob
+      void Write(std::vector<char>& output) const;
+
+      //! @brief Read a clip written by Write at offset, offset is moved past it
+      bool Read(const char* data, size_t size, size_t& offset);
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief 3 floats at 16 bits in a range
+      struct QuantizedVec3
+      {
+        Container::U16 m_value[3];
+      };
+
+      //! @brief Smallest three components at 15 bits, the spare bits of the
+      // first two hold which component was dropped
+      struct QuantizedQuat
+      {
+        Container::U16 m_value[3];
+      };
+
+      static QuantizedQuat QuantizeRotation(const glm::quat& rotation);
+      static glm::quat DequantizeRotation(const QuantizedQuat& rotation);
+    private:
+      //! @brief Key ranges of one bone inside the pools, every channel has at least one key
+      struct Track
+      {
+        Container::U32  m_translationBegin;
+        Container::U32  m_translationCount;
+        Container::U32  m_rotationBegin;
+        Container::U32  m_rotationCount;
+        Container::U32  m_scaleBegin;
+        Container::U32  m_scaleCount;
+        glm::vec3       m_translationMin;
+        glm::vec3       m_translationExtent;
+        glm::vec3       m_scaleMin;
+        glm::vec3       m_scaleExtent;
+      };
+
+      Container::String                 m_name;
+      float                             m_duration = 0.0f;
+      Container::Vector<Track>          m_tracks;
+
+      //Key times are normalized to the duration
+      Container::Vector<Container::U16> m_translationTimes;
+      Container::Vector<QuantizedVec3>  m_translations;
+      Container::Vector<Container::U16> m_rotationTimes;
+      Container::Vector<QuantizedQuat>  m_rotations;
+      Container::Vector<Container::U16> m_scaleTimes;
+      Container::Vector<QuantizedVec3>  m_scales;
+  };
+}
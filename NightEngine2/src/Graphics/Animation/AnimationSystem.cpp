@@ -0,0 +1,104 @@
+/*!
+  @file AnimationSystem.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of AnimationSystem
+*/
+#include "Graphics/Animation/AnimationSystem.hpp"
+#include "Graphics/Animation/AnimationClip.hpp"
+#include "Graphics/Animation/Animator.hpp"
+#include "Graphics/Opengl/SkinningPalette.hpp"
+
+#include "Core/EC/Factory.hpp"
+#include "Core/Utility/JobSystem.hpp"
+#include "Core/Macros.hpp"
+
+using namespace NightEngine::EC;
+using namespace NightEngine::EC::Components;
+
+namespace NightEngine::Rendering::Animation
+{
+  namespace AnimationSystem
+  {
+    //Characters are a few dozen microseconds each, batch them to amortize the scheduling
+    static const size_t c_MIN_BATCH = 4;
+
+    static Container::Vector<SkinMatrix>    g_palette;
+    static Container::Vector<AnimationTask> g_tasks;
+    static Container::Vector<Animator*>     g_animators;
+
+    void Evaluate(const AnimationTask& task)
+    {
+      ASSERT_TRUE(task.m_skeleton != nullptr && task.m_clip != nullptr && task.m_output != nullptr);
+      CharacterPose& character = *task.m_output;
+      const Skeleton& skeleton = *task.m_skeleton;
+
+      task.m_clip->Sample(task.m_time, character.m_pose);
+      if (task.m_blendClip != nullptr && task.m_blendWeight > 0.0f)
+      {
+        task.m_blendClip->Sample(task.m_blendTime, character.m_blendPose);
+        BlendPoses(character.m_pose, character.m_blendPose, task.m_blendWeight, character.m_pose);
+      }
+
+      character.m_modelMatrices.resize(skeleton.GetBoneCount());
+      LocalToModel(skeleton, character.m_pose, character.m_modelMatrices.data());
+      if (task.m_palette != nullptr)
+      {
+        BuildSkinningPalette(skeleton, character.m_modelMatrices.data(), task.m_palette);
+      }
+    }
+
+    void EvaluateAll(const Container::Vector<AnimationTask>& tasks)
+    {
+      JobSystem::ParallelFor(tasks.size(), c_MIN_BATCH, [&tasks](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          Evaluate(tasks[i]);
+        }
+      });
+    }
+
+    void Update(float dt)
+    {
+      //Advance on the main thread, the animators only change here
+      g_animators.clear();
+      auto& container = Factory::GetTypeContainer<Animator>();
+      auto it = container.GetIterator();
+      while (!it.IsEnd())
+      {
+        Animator* animator = it.Get();
+        animator->Advance(dt);
+        if (animator->IsPlaying())
+        {
+          g_animators.emplace_back(animator);
+        }
+        else
+        {
+          animator->SetPaletteOffset(-1);
+        }
+        it.Next();
+      }
+
+      //Every character write its own range of the shared palette
+      size_t boneCount = 0;
+      g_tasks.resize(g_animators.size());
+      for (size_t i = 0; i < g_animators.size(); ++i)
+      {
+        g_tasks[i] = g_animators[i]->MakeTask();
+        boneCount += g_tasks[i].m_skeleton->GetBoneCount();
+      }
+      g_palette.resize(boneCount);
+
+      size_t offset = 0;
+      for (size_t i = 0; i < g_tasks.size(); ++i)
+      {
+        g_tasks[i].m_palette = g_palette.data() + offset;
+        g_animators[i]->SetPaletteOffset(static_cast<int>(offset));
+        offset += g_tasks[i].m_skeleton->GetBoneCount();
+      }
+
+      EvaluateAll(g_tasks);
+      Opengl::SkinningPalette::Upload(g_palette.data(), g_palette.size());
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*!
+  @file AnimationSystem.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of AnimationSystem
+*/
+#pragma once
+
+#include "Graphics/Animation/Pose.hpp"
+
+namespace NightEngine::Rendering::Animation
+{
+  class CompressedClip;
+
+  //! @brief Scratch memory of one character, kept between frames to avoid allocations
+  struct CharacterPose
+  {
+    Pose                         m_pose;
+    Pose                         m_blendPose;
+    Container::Vector<glm::mat4> m_modelMatrices;
+  };
+
+  //! @brief Everything needed to evaluate one character, characters are independent
+  struct AnimationTask
+  {
+    const Skeleton*       m_skeleton = nullptr;
+    const CompressedClip* m_clip = nullptr;
+    float                 m_time = 0.0f;
+
+    //Blended over m_clip by m_blendWeight when not null
+    const CompressedClip* m_blendClip = nullptr;
+    float                 m_blendTime = 0.0f;
+    float                 m_blendWeight = 0.0f;
+
+    CharacterPose*        m_output = nullptr;
+    SkinMatrix*           m_palette = nullptr;    //Skipped when null
+  };
+
+  //! @brief Sample, blend and skin every animated character on the JobSystem workers
+  namespace AnimationSystem
+  {
+    //! @brief Evaluate one character on the calling thread
+    void Evaluate(const AnimationTask& task);
+
+    //! @brief Evaluate every task across the workers, block until done
+    void EvaluateAll(const Container::Vector<AnimationTask>& tasks);
+
+    //! @brief Advance the Animators, evaluate them and upload the skinning palette
+    void Update(float dt);
+  }
+}
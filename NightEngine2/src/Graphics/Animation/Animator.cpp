@@ -0,0 +1,188 @@
+/*!
+  @file Animator.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Animator
+*/
+#include "Graphics/Animation/Animator.hpp"
+#include "Graphics/Animation/AnimationClip.hpp"
+
+#include "Graphics/Opengl/Model.hpp"
+#include "Graphics/Opengl/MeshRenderer.hpp"
+
+#include "Core/EC/GameObject.hpp"
+#include "Core/Serialization/ResourceManager.hpp"
+#include "Core/Logger.hpp"
+
+#include <cmath>
+
+using namespace NightEngine::Rendering::Animation;
+
+namespace NightEngine::EC::Components
+{
+  INIT_REFLECTION_AND_FACTORY(Animator, 100, 100)
+
+  //! @brief Wrap or clamp time into the clip
+  static float WrapTime(float time, float duration, bool loop)
+  {
+    if (duration <= 0.0f)
+    {
+      return 0.0f;
+    }
+
+    if (loop)
+    {
+      time = std::fmod(time, duration);
+      return time < 0.0f ? time + duration : time;
+    }
+    return time < 0.0f ? 0.0f : (time > duration ? duration : time);
+  }
+
+  void Animator::OnAwake(void)
+  {
+    m_paletteOffset = -1;
+    if (!m_modelPath.empty())
+    {
+      SetModel(m_modelPath);
+    }
+  }
+
+  void Animator::OnDestroy(void)
+  {
+    SetPaletteOffset(-1);
+
+    m_skeleton.reset();
+    m_clips.clear();
+    m_clip = nullptr;
+    m_blendClip = nullptr;
+    m_time = 0.0f;
+    m_blendTime = 0.0f;
+
+    m_modelPath = "";
+    m_clipName = "";
+    m_blendClipName = "";
+    m_blendWeight = 0.0f;
+    m_speed = 1.0f;
+    m_loop = true;
+  }
+
+  void Animator::SetModel(const std::string& path)
+  {
+    using namespace NightEngine::Rendering::Opengl;
+    Model* model = ResourceManager::LoadModelResource(path);
+    if (model == nullptr || model->GetSkeleton() == nullptr)
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "Animator: [" << path << "] has no skeleton\n";
+      return;
+    }
+
+    m_modelPath = path;
+    SetRig(model->GetSkeleton(), model->GetClips());
+  }
+
+  void Animator::SetRig(std::shared_ptr<const Skeleton> skeleton
+    , std::vector<std::shared_ptr<const CompressedClip>> clips)
+  {
+    m_skeleton = std::move(skeleton);
+    m_clips = std::move(clips);
+
+    //Keep the serialized clips if the rig has them, otherwise the first one
+    m_clip = FindClip(m_clipName);
+    if (m_clip == nullptr && !m_clips.empty())
+    {
+      m_clip = m_clips.front().get();
+      m_clipName = m_clip->GetName();
+    }
+    m_blendClip = FindClip(m_blendClipName);
+    m_time = 0.0f;
+    m_blendTime = 0.0f;
+
+    if (m_skeleton != nullptr)
+    {
+      m_character.m_pose.SetBindPose(*m_skeleton);
+      m_character.m_blendPose.SetBindPose(*m_skeleton);
+    }
+  }
+
+  bool Animator::Play(const std::string& name)
+  {
+    const CompressedClip* clip = FindClip(name);
+    if (clip == nullptr)
+    {
+      return false;
+    }
+
+    m_clip = clip;
+    m_clipName = name;
+    m_time = 0.0f;
+    return true;
+  }
+
+  bool Animator::SetBlend(const std::string& name, float weight)
+  {
+    const CompressedClip* clip = name.empty() ? nullptr : FindClip(name);
+    if (!name.empty() && clip == nullptr)
+    {
+      return false;
+    }
+
+    m_blendClip = clip;
+    m_blendClipName = name;
+    m_blendWeight = weight;
+    m_blendTime = m_time;
+    return true;
+  }
+
+  void Animator::Advance(float dt)
+  {
+    if (m_clip != nullptr)
+    {
+      m_time = WrapTime(m_time + dt * m_speed, m_clip->GetDuration(), m_loop);
+    }
+    if (m_blendClip != nullptr)
+    {
+      m_blendTime = WrapTime(m_blendTime + dt * m_speed, m_blendClip->GetDuration(), m_loop);
+    }
+  }
+
+  AnimationTask Animator::MakeTask(void)
+  {
+    AnimationTask task;
+    task.m_skeleton = m_skeleton.get();
+    task.m_clip = m_clip;
+    task.m_time = m_time;
+    task.m_blendClip = m_blendClip;
+    task.m_blendTime = m_blendTime;
+    task.m_blendWeight = m_blendWeight;
+    task.m_output = &m_character;
+    return task;
+  }
+
+  void Animator::SetPaletteOffset(int offset)
+  {
+    //Only look the MeshRenderer up when the offset move
+    if (offset == m_paletteOffset || !m_gameObject.IsValid())
+    {
+      return;
+    }
+    m_paletteOffset = offset;
+
+    ComponentHandle* meshRenderer = m_gameObject->GetComponent("MeshRenderer");
+    if (meshRenderer != nullptr)
+    {
+      meshRenderer->Get<MeshRenderer>()->SetSkinPaletteOffset(offset);
+    }
+  }
+
+  const CompressedClip* Animator::FindClip(const std::string& name) const
+  {
+    for (auto& clip : m_clips)
+    {
+      if (clip->GetName() == name)
+      {
+        return clip.get();
+      }
+    }
+    return nullptr;
+  }
+}
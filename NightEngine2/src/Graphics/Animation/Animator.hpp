@@ -0,0 +1,99 @@
+/*!
+  @file Animator.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Animator
+*/
+#pragma once
+
+#include "Core/EC/ComponentLogic.hpp"
+#include "Core/EC/Factory.hpp"
+#include "Graphics/Animation/AnimationSystem.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NightEngine::EC::Components
+{
+  //! @brief Play the clips of a skinned model on the MeshRenderer of the same GameObject.
+  // Evaluated by AnimationSystem::Update every frame.
+  class Animator: public ComponentLogic
+  {
+    REFLECTABLE_TYPE_BLOCK()
+    {
+      META_REGISTERER_WITHBASE(Animator, ComponentLogic
+        , InheritType::PUBLIC, true
+        , nullptr, nullptr)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_modelPath, true)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_clipName, true)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_blendClipName, true)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_blendWeight, true)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_speed, true)
+        .MR_ADD_MEMBER_PROTECTED(Animator, m_loop, true);
+    }
+    public:
+      using Skeleton = NightEngine::Rendering::Animation::Skeleton;
+      using CompressedClip = NightEngine::Rendering::Animation::CompressedClip;
+
+      //! @brief On Awake, load the rig of m_modelPath if it was deserialized
+      virtual void OnAwake(void) override;
+
+      //! @brief On destroy callback
+      virtual void OnDestroy(void) override;
+
+      //! @brief Use the skeleton and clips of a model loaded through the ResourceManager
+      void SetModel(const std::string& path);
+
+      //! @brief Use a skeleton and its clips directly
+      void SetRig(std::shared_ptr<const Skeleton> skeleton
+        , std::vector<std::shared_ptr<const CompressedClip>> clips);
+
+      //! @brief Play the clip named name from the start, return false if there is none
+      bool Play(const std::string& name);
+
+      //! @brief Blend the clip named name over the playing one, an empty name stop blending
+      bool SetBlend(const std::string& name, float weight);
+
+      //! @brief Playback rate, 1 is the clip speed
+      void SetSpeed(float speed) { m_speed = speed; }
+
+      //! @brief Check if a clip is playing
+      bool IsPlaying(void) const { return m_skeleton != nullptr && m_clip != nullptr; }
+
+      //! @brief Current time in the playing clip
+      float GetTime(void) const { return m_time; }
+
+      //! @brief Model space matrices of the last evaluation
+      const Container::Vector<glm::mat4>& GetModelMatrices(void) const { return m_character.m_modelMatrices; }
+
+      ///////////////////////////////////////////////////////
+
+      //! @brief Move the clips forward by dt
+      void Advance(float dt);
+
+      //! @brief Task evaluating this character, without a palette
+      NightEngine::Rendering::Animation::AnimationTask MakeTask(void);
+
+      //! @brief Where the skinning matrices of this character start, -1 for none
+      void SetPaletteOffset(int offset);
+    private:
+      const CompressedClip* FindClip(const std::string& name) const;
+
+      std::string    m_modelPath;
+      std::string    m_clipName;
+      std::string    m_blendClipName;
+      float          m_blendWeight = 0.0f;
+      float          m_speed = 1.0f;
+      bool           m_loop = true;
+
+      std::shared_ptr<const Skeleton>                    m_skeleton;
+      std::vector<std::shared_ptr<const CompressedClip>> m_clips;
+      const CompressedClip*                              m_clip = nullptr;
+      const CompressedClip*                              m_blendClip = nullptr;
+      float                                              m_time = 0.0f;
+      float                                              m_blendTime = 0.0f;
+      int                                                m_paletteOffset = -1;
+
+      NightEngine::Rendering::Animation::CharacterPose   m_character;
+  };
+}
@@ -0,0 +1,203 @@
+/*!
+  @file Pose.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Pose
+*/
+#include "Graphics/Animation/Pose.hpp"
+
+#include "Core/Macros.hpp"
+
+using namespace NightEngine::Simd;
+
+namespace NightEngine::Rendering::Animation
+{
+  static SoaTransform GetIdentitySoa(void)
+  {
+    SoaTransform identity;
+    for (int i = 0; i < 3; ++i)
+    {
+      identity.m_translation[i] = Splat(0.0f);
+      identity.m_rotation[i] = Splat(0.0f);
+      identity.m_scale[i] = Splat(1.0f);
+    }
+    identity.m_rotation[3] = Splat(1.0f);
+    return identity;
+  }
+
+  static void SetLane(Float4& value, size_t lane, float x)
+  {
+    alignas(16) float values[4];
+    Store(value, values);
+    values[lane] = x;
+    value = Load(values);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void Pose::Resize(size_t boneCount)
+  {
+    size_t soaCount = (boneCount + 3) / 4;
+    if (soaCount != m_soa.size())
+    {
+      m_soa.assign(soaCount, GetIdentitySoa());
+    }
+    else if (boneCount < m_boneCount)
+    {
+      //Lanes that are now padding go back to the identity
+      for (size_t bone = boneCount; bone < m_boneCount; ++bone)
+      {
+        SetBone(bone, BoneTransform());
+      }
+    }
+    m_boneCount = boneCount;
+  }
+
+  BoneTransform Pose::GetBone(size_t bone) const
+  {
+    ASSERT_TRUE(bone < m_boneCount);
+    const SoaTransform& soa = m_soa[bone / 4];
+    int lane = static_cast<int>(bone % 4);
+
+    BoneTransform transform;
+    transform.m_translation = glm::vec3(GetLane(soa.m_translation[0], lane)
+      , GetLane(soa.m_translation[1], lane), GetLane(soa.m_translation[2], lane));
+    transform.m_rotation = glm::quat(GetLane(soa.m_rotation[3], lane)
+      , GetLane(soa.m_rotation[0], lane), GetLane(soa.m_rotation[1], lane)
+      , GetLane(soa.m_rotation[2], lane));
+    transform.m_scale = glm::vec3(GetLane(soa.m_scale[0], lane)
+      , GetLane(soa.m_scale[1], lane), GetLane(soa.m_scale[2], lane));
+    return transform;
+  }
+
+  void Pose::SetBone(size_t bone, const BoneTransform& transform)
+  {
+    ASSERT_TRUE(bone / 4 < m_soa.size());
+    SoaTransform& soa = m_soa[bone / 4];
+    size_t lane = bone % 4;
+
+    for (int i = 0; i < 3; ++i)
+    {
+      SetLane(soa.m_translation[i], lane, transform.m_translation[i]);
+      SetLane(soa.m_scale[i], lane, transform.m_scale[i]);
+    }
+    SetLane(soa.m_rotation[0], lane, transform.m_rotation.x);
+    SetLane(soa.m_rotation[1], lane, transform.m_rotation.y);
+    SetLane(soa.m_rotation[2], lane, transform.m_rotation.z);
+    SetLane(soa.m_rotation[3], lane, transform.m_rotation.w);
+  }
+
+  void Pose::SetBindPose(const Skeleton& skeleton)
+  {
+    Resize(skeleton.GetBoneCount());
+    auto& bindPose = skeleton.GetBindPose();
+    for (size_t i = 0; i < bindPose.size(); ++i)
+    {
+      SetBone(i, bindPose[i]);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out)
+  {
+    ASSERT_TRUE(a.GetBoneCount() == b.GetBoneCount());
+    out.Resize(a.GetBoneCount());
+
+    const Float4 w = Splat(weight);
+    const SoaTransform* soaA = a.GetSoa();
+    const SoaTransform* soaB = b.GetSoa();
+    SoaTransform* soaOut = out.GetSoa();
+    for (size_t i = 0; i < a.GetSoaCount(); ++i)
+    {
+      const SoaTransform& lhs = soaA[i];
+      const SoaTransform& rhs = soaB[i];
+      SoaTransform& result = soaOut[i];
+
+      //q and -q are the same rotation, flip rhs where it is on the other hemisphere
+      Float4 dot = lhs.m_rotation[0] * rhs.m_rotation[0] + lhs.m_rotation[1] * rhs.m_rotation[1]
+        + lhs.m_rotation[2] * rhs.m_rotation[2] + lhs.m_rotation[3] * rhs.m_rotation[3];
+      Float4 sign = SignBits(dot);
+
+      Float4 rotation[4];
+      for (int j = 0; j < 4; ++j)
+      {
+        rotation[j] = Lerp(lhs.m_rotation[j], Xor(rhs.m_rotation[j], sign), w);
+      }
+      Float4 inverseLength = RSqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1]
+        + rotation[2] * rotation[2] + rotation[3] * rotation[3]);
+
+      for (int j = 0; j < 3; ++j)
+      {
+        result.m_translation[j] = Lerp(lhs.m_translation[j], rhs.m_translation[j], w);
+        result.m_scale[j] = Lerp(lhs.m_scale[j], rhs.m_scale[j], w);
+      }
+      for (int j = 0; j < 4; ++j)
+      {
+        result.m_rotation[j] = rotation[j] * inverseLength;
+      }
+    }
+  }
+
+  void LocalToModel(const Skeleton& skeleton, const Pose& pose, glm::mat4* outModelMatrices)
+  {
+    ASSERT_TRUE(skeleton.GetBoneCount() == pose.GetBoneCount());
+    const Float4 one = Splat(1.0f);
+    const Float4 two = Splat(2.0f);
+
+    const SoaTransform* soa = pose.GetSoa();
+    size_t boneCount = pose.GetBoneCount();
+    for (size_t i = 0; i < pose.GetSoaCount(); ++i)
+    {
+      const SoaTransform& transform = soa[i];
+      const Float4& x = transform.m_rotation[0];
+      const Float4& y = transform.m_rotation[1];
+      const Float4& z = transform.m_rotation[2];
+      const Float4& w = transform.m_rotation[3];
+
+      //Rotation matrix of 4 bones at once, columns scaled by the scale
+      Float4 xx = x * x, yy = y * y, zz = z * z;
+      Float4 xy = x * y, xz = x * z, yz = y * z;
+      Float4 wx = w * x, wy = w * y, wz = w * z;
+
+      alignas(16) float columns[12][4];
+      Store((one - two * (yy + zz)) * transform.m_scale[0], columns[0]);
+      Store(two * (xy + wz) * transform.m_scale[0], columns[1]);
+      Store(two * (xz - wy) * transform.m_scale[0], columns[2]);
+      Store(two * (xy - wz) * transform.m_scale[1], columns[3]);
+      Store((one - two * (xx + zz)) * transform.m_scale[1], columns[4]);
+      Store(two * (yz + wx) * transform.m_scale[1], columns[5]);
+      Store(two * (xz + wy) * transform.m_scale[2], columns[6]);
+      Store(two * (yz - wx) * transform.m_scale[2], columns[7]);
+      Store((one - two * (xx + yy)) * transform.m_scale[2], columns[8]);
+      Store(transform.m_translation[0], columns[9]);
+      Store(transform.m_translation[1], columns[10]);
+      Store(transform.m_translation[2], columns[11]);
+
+      //The hierarchy is serial, parents always have a smaller index
+      for (size_t lane = 0; lane < 4 && i * 4 + lane < boneCount; ++lane)
+      {
+        size_t bone = i * 4 + lane;
+        glm::mat4 local{ columns[0][lane], columns[1][lane], columns[2][lane], 0.0f
+          , columns[3][lane], columns[4][lane], columns[5][lane], 0.0f
+          , columns[6][lane], columns[7][lane], columns[8][lane], 0.0f
+          , columns[9][lane], columns[10][lane], columns[11][lane], 1.0f };
+
+        int parent = skeleton.GetParent(static_cast<int>(bone));
+        outModelMatrices[bone] = parent >= 0 ? outModelMatrices[parent] * local : local;
+      }
+    }
+  }
+
+  void BuildSkinningPalette(const Skeleton& skeleton, const glm::mat4* modelMatrices
+    , SkinMatrix* outPalette)
+  {
+    for (size_t i = 0; i < skeleton.GetBoneCount(); ++i)
+    {
+      glm::mat4 skin = modelMatrices[i] * skeleton.GetInverseBindMatrix(static_cast<int>(i));
+      for (int row = 0; row < 3; ++row)
+      {
+        outPalette[i].m_rows[row] = glm::vec4(skin[0][row], skin[1][row], skin[2][row], skin[3][row]);
+      }
+    }
+  }
+}
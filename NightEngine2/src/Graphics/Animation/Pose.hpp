@@ -0,0 +1,60 @@
+/*!
+  @file Pose.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Pose
+*/
+#pragma once
+
+#include "Graphics/Animation/Skeleton.hpp"
+#include "Core/Utility/SimdFloat4.hpp"
+
+namespace NightEngine::Rendering::Animation
+{
+  //! @brief Local transforms of 4 bones, one bone per lane
+  struct SoaTransform
+  {
+    Simd::Float4 m_translation[3];  //x, y, z
+    Simd::Float4 m_rotation[4];     //x, y, z, w
+    Simd::Float4 m_scale[3];        //x, y, z
+  };
+
+  //! @brief Local transforms of every bone of a skeleton, 4 bones per SoaTransform.
+  // The lanes past the last bone hold the identity so they can be processed blindly.
+  class Pose
+  {
+    public:
+      //! @brief Resize for boneCount bones, the transforms are undefined until written
+      void Resize(size_t boneCount);
+
+      size_t GetBoneCount(void) const { return m_boneCount; }
+
+      size_t GetSoaCount(void) const { return m_soa.size(); }
+
+      SoaTransform* GetSoa(void) { return m_soa.data(); }
+
+      const SoaTransform* GetSoa(void) const { return m_soa.data(); }
+
+      //! @brief Transform of one bone, slow, for tools and tests
+      BoneTransform GetBone(size_t bone) const;
+
+      //! @brief Set the transform of one bone, slow, for tools and tests
+      void SetBone(size_t bone, const BoneTransform& transform);
+
+      //! @brief Resize to the skeleton and copy its bind pose
+      void SetBindPose(const Skeleton& skeleton);
+    private:
+      Container::Vector<SoaTransform> m_soa;
+      size_t                          m_boneCount = 0;
+  };
+
+  //! @brief Blend weight of b over a, rotations are normalized lerped along the shortest path.
+  // out may be a or b
+  void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+  //! @brief Model space matrix of every bone, parents are resolved before their children
+  void LocalToModel(const Skeleton& skeleton, const Pose& pose, glm::mat4* outModelMatrices);
+
+  //! @brief Model space matrix times inverse bind matrix of every bone, transposed to 3 rows
+  void BuildSkinningPalette(const Skeleton& skeleton, const glm::mat4* modelMatrices
+    , SkinMatrix* outPalette);
+}
@@ -0,0 +1,131 @@
+/*!
+  @file Skeleton.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Skeleton
+*/
+#include "Graphics/Animation/Skeleton.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <cstring>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Animation
+{
+  template<typename T>
+  static void AppendPod(std::vector<char>& output, const T* data, size_t count)
+  {
+    auto bytes = reinterpret_cast<const char*>(data);
+    output.insert(output.end(), bytes, bytes + count * sizeof(T));
+  }
+
+  template<typename T>
+  static bool ReadPod(T* output, size_t count, const char* data, size_t size, size_t& offset)
+  {
+    if (size - offset < count * sizeof(T))
+    {
+      return false;
+    }
+    std::memcpy(output, data + offset, count * sizeof(T));
+    offset += count * sizeof(T);
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  glm::mat4 BoneTransform::ToMatrix(void) const
+  {
+    glm::mat4 matrix = glm::mat4_cast(m_rotation);
+    matrix[0] *= m_scale.x;
+    matrix[1] *= m_scale.y;
+    matrix[2] *= m_scale.z;
+    matrix[3] = glm::vec4(m_translation, 1.0f);
+    return matrix;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  int Skeleton::AddBone(const String& name, int parentIndex
+    , const BoneTransform& bindPose, const glm::mat4& inverseBindMatrix)
+  {
+    ASSERT_MSG(parentIndex < static_cast<int>(m_parents.size())
+      , "Skeleton: a parent has to be added before its children");
+    if (m_parents.size() >= c_MAX_BONES)
+    {
+      return -1;
+    }
+
+    int index = static_cast<int>(m_parents.size());
+    m_names.emplace_back(name);
+    m_parents.emplace_back(parentIndex);
+    m_bindPose.emplace_back(bindPose);
+    m_inverseBindMatrices.emplace_back(inverseBindMatrix);
+    m_boneMap.emplace(name, index);
+    return index;
+  }
+
+  void Skeleton::SetInverseBindMatrix(int bone, const glm::mat4& inverseBindMatrix)
+  {
+    m_inverseBindMatrices[bone] = inverseBindMatrix;
+  }
+
+  int Skeleton::FindBone(const String& name) const
+  {
+    auto it = m_boneMap.find(name);
+    return it != m_boneMap.end() ? it->second : -1;
+  }
+
+  void Skeleton::Write(std::vector<char>& output) const
+  {
+    U32 count = static_cast<U32>(m_parents.size());
+    AppendPod(output, &count, 1);
+    for (U32 i = 0; i < count; ++i)
+    {
+      U32 length = static_cast<U32>(m_names[i].size());
+      I32 parent = m_parents[i];
+      AppendPod(output, &length, 1);
+      AppendPod(output, m_names[i].data(), length);
+      AppendPod(output, &parent, 1);
+      AppendPod(output, &m_bindPose[i], 1);
+      AppendPod(output, &m_inverseBindMatrices[i], 1);
+    }
+  }
+
+  bool Skeleton::Read(const char* data, size_t size, size_t& offset)
+  {
+    *this = Skeleton();
+
+    U32 count = 0;
+    if (!ReadPod(&count, 1, data, size, offset) || count > c_MAX_BONES)
+    {
+      return false;
+    }
+
+    for (U32 i = 0; i < count; ++i)
+    {
+      U32 length = 0;
+      if (!ReadPod(&length, 1, data, size, offset) || size - offset < length)
+      {
+        return false;
+      }
+
+      String name{ data + offset, length };
+      offset += length;
+
+      I32 parent = 0;
+      BoneTransform bindPose;
+      glm::mat4 inverseBindMatrix;
+      if (!ReadPod(&parent, 1, data, size, offset)
+        || !ReadPod(&bindPose, 1, data, size, offset)
+        || !ReadPod(&inverseBindMatrix, 1, data, size, offset)
+        || parent >= static_cast<I32>(i))
+      {
+        return false;
+      }
+      AddBone(name, parent, bindPose, inverseBindMatrix);
+    }
+    return true;
+  }
+}
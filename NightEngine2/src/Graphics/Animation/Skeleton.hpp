@@ -0,0 +1,78 @@
+/*!
+  @file Skeleton.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Skeleton
+*/
+#pragma once
+
+#include "Core/Container/String.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/Hashmap.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+namespace NightEngine::Rendering::Animation
+{
+  //! @brief Local transform of a bone, relative to its parent
+  struct BoneTransform
+  {
+    glm::vec3 m_translation{ 0.0f };
+    glm::quat m_rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+    glm::vec3 m_scale{ 1.0f };
+
+    //! @brief Translation * Rotation * Scale
+    glm::mat4 ToMatrix(void) const;
+  };
+
+  //! @brief Skinning matrix of a bone uploaded to the GPU, the 4th row is always (0, 0, 0, 1)
+  struct SkinMatrix
+  {
+    glm::vec4 m_rows[3];
+  };
+
+  //! @brief Bone hierarchy of a skinned model, parents always come before their children
+  class Skeleton
+  {
+    public:
+      //! @brief Skinned vertices index their bones with a byte
+      static constexpr size_t c_MAX_BONES = 256;
+
+      //! @brief Append a bone, parentIndex is -1 for a root and must be an added bone otherwise.
+      // Return the bone index, -1 when the skeleton is full
+      int AddBone(const Container::String& name, int parentIndex
+        , const BoneTransform& bindPose, const glm::mat4& inverseBindMatrix);
+
+      //! @brief Model space to bone space at bind time, from the skinned mesh
+      void SetInverseBindMatrix(int bone, const glm::mat4& inverseBindMatrix);
+
+      //! @brief Index of the bone named name, -1 if there is none
+      int FindBone(const Container::String& name) const;
+
+      size_t GetBoneCount(void) const { return m_parents.size(); }
+
+      int GetParent(int bone) const { return m_parents[bone]; }
+
+      const Container::String& GetBoneName(int bone) const { return m_names[bone]; }
+
+      const Container::Vector<BoneTransform>& GetBindPose(void) const { return m_bindPose; }
+
+      const glm::mat4& GetInverseBindMatrix(int bone) const { return m_inverseBindMatrices[bone]; }
+
+      //! @brief Append the skeleton to a binary blob
+      void Write(std::vector<char>& output) const;
+
+      //! @brief Read a skeleton written by Write at offset, offset is moved past it
+      bool Read(const char* data, size_t size, size_t& offset);
+    private:
+      Container::Vector<Container::String>      m_names;
+      Container::Vector<int>                    m_parents;
+      Container::Vector<BoneTransform>          m_bindPose;
+      Container::Vector<glm::mat4>              m_inverseBindMatrices;
+      Container::Hashmap<Container::String, int> m_boneMap;
+  };
+}
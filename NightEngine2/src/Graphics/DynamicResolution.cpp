@@ -0,0 +1,100 @@
+/*!
+  @file DynamicResolution.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of DynamicResolution
+*/
+#include "Graphics/DynamicResolution.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <cmath>
+
+namespace NightEngine::Rendering
+{
+  float DynamicResolution::Update(float frameMs)
+  {
+    if (!m_initialized)
+    {
+      Reset();
+    }
+
+    const DynamicResolutionSettings& s = m_settings;
+    int historySize = std::clamp(s.m_historySize, 1, c_MAX_HISTORY);
+
+    m_history[m_historyIndex] = frameMs;
+    m_historyIndex = (m_historyIndex + 1) % historySize;
+    m_historyCount = std::min(m_historyCount + 1, historySize);
+    m_filteredMs = MedianFrameMs();
+
+    //Wait for a full history, and for the frames of the last change to reach the median
+    if (m_historyCount < historySize)
+    {
+      return m_scale;
+    }
+    if (m_cooldown > 0)
+    {
+      --m_cooldown;
+      return m_scale;
+    }
+
+    //Headroom as a fraction of the budget, nothing to correct inside the hysteresis band
+    float ratio = m_filteredMs / std::max(s.m_targetFrameMs, 0.001f);
+    float error = 1.0f - ratio;
+    if (ratio <= s.m_downscaleRatio && ratio >= s.m_upscaleRatio)
+    {
+      error = 0.0f;
+    }
+
+    float derivative = error - m_prevError;
+    m_prevError = error;
+
+    //Clamping the integral to the output range is the anti-windup
+    m_integral = std::clamp(m_integral + s.m_ki * error, s.m_minScale, s.m_maxScale);
+    float output = std::clamp(m_integral + s.m_kp * error + s.m_kd * derivative
+      , s.m_minScale, s.m_maxScale);
+
+    float step = std::max(s.m_scaleStep, 0.001f);
+    float scale = std::clamp(std::round(output / step) * step, s.m_minScale, s.m_maxScale);
+
+    //Frame cost is about proportional to the pixel count, only scale up to a
+    //resolution predicted to land in the lower half of the hysteresis band,
+    //a noisy median would otherwise bounce between two steps
+    float maxUpscaleRatio = (s.m_upscaleRatio + s.m_downscaleRatio) * 0.5f;
+    while (scale > m_scale
+      && ratio * (scale * scale) / (m_scale * m_scale) > maxUpscaleRatio)
+    {
+      scale = std::max(scale - step, m_scale);
+    }
+
+    if (std::abs(scale - m_scale) > 0.0001f)
+    {
+      m_scale = scale;
+      m_integral = scale;
+      m_cooldown = s.m_cooldownFrames;
+    }
+    return m_scale;
+  }
+
+  void DynamicResolution::Reset(void)
+  {
+    m_historyCount = 0;
+    m_historyIndex = 0;
+
+    m_scale = m_settings.m_maxScale;
+    m_integral = m_scale;
+    m_prevError = 0.0f;
+    m_filteredMs = 0.0f;
+    m_cooldown = 0;
+    m_initialized = true;
+  }
+
+  float DynamicResolution::MedianFrameMs(void) const
+  {
+    float sorted[c_MAX_HISTORY];
+    std::copy(m_history, m_history + m_historyCount, sorted);
+
+    float* median = sorted + (m_historyCount / 2);
+    std::nth_element(sorted, median, sorted + m_historyCount);
+    return *median;
+  }
+} // Rendering
@@ -0,0 +1,66 @@
+/*!
+  @file DynamicResolution.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of DynamicResolution
+*/
+#pragma once
+
+namespace NightEngine::Rendering
+{
+  //! @brief Tuning of the DynamicResolution controller
+  struct DynamicResolutionSettings
+  {
+    float m_targetFrameMs = 16.6f;   //Frame time budget
+    float m_minScale = 0.5f;
+    float m_maxScale = 1.0f;
+
+    //PID gains, the error is the budget headroom as a fraction of the budget
+    float m_kp = 0.1f;
+    float m_ki = 0.05f;
+    float m_kd = 0.05f;
+
+    //Hysteresis, scale up only under m_upscaleRatio of the budget
+    //and down only over m_downscaleRatio of it
+    float m_upscaleRatio = 0.85f;
+    float m_downscaleRatio = 1.0f;
+
+    float m_scaleStep = 0.05f;       //Output is quantized to this
+    int   m_historySize = 8;         //Frames in the median filter, spikes shorter than half are ignored
+    int   m_cooldownFrames = 4;      //Frames to hold the scale after a change
+  };
+
+  //! @brief Pick the render scale that hold a frame time budget from the recent
+  // frame times. Pure CPU, the caller feed one frame time per frame and apply the scale.
+  class DynamicResolution
+  {
+    public:
+      static constexpr int c_MAX_HISTORY = 32;
+
+      DynamicResolutionSettings m_settings;
+
+      //! @brief Feed the time of the last frame, return the scale for the next one
+      float Update(float frameMs);
+
+      //! @brief Forget the history and go back to the max scale
+      void Reset(void);
+
+      //! @brief Scale returned by the last Update
+      float GetScale(void) const { return m_scale; }
+
+      //! @brief Median of the frame time history
+      float GetFilteredFrameMs(void) const { return m_filteredMs; }
+    private:
+      float MedianFrameMs(void) const;
+
+      float m_history[c_MAX_HISTORY] = {};
+      int   m_historyCount = 0;
+      int   m_historyIndex = 0;
+
+      float m_scale = 1.0f;
+      float m_integral = 1.0f;       //Integral term, in scale unit
+      float m_prevError = 0.0f;
+      float m_filteredMs = 0.0f;
+      int   m_cooldown = 0;
+      bool  m_initialized = false;
+  };
+} // Rendering
@@ -26,6 +26,8 @@
 #include "Editor/ArchetypeBrowser.hpp"
 #include "Editor/MaterialEditor.hpp"
 #include "Editor/Inspector.hpp"
+#include "Editor/ProfilerView.hpp"
+#include "Editor/MemoryStatsView.hpp"
 
 //Input
 #include "Input/Input.hpp"
@@ -72,6 +74,8 @@ namespace Editor
   static MaterialEditor         g_materialEditor;
 
   static Inspector g_inspector;
+  static ProfilerView g_profilerView;
+  static MemoryStatsView g_memoryStatsView;
   static Hierarchy g_hierarchy;
 
   //Confirmation box
@@ -304,6 +308,15 @@ namespace Editor
         if (ImGui::MenuItem("Cut", "CTRL+X")) {}
         if (ImGui::MenuItem("Copy", "CTRL+C")) {}
         if (ImGui::MenuItem("Paste", "CTRL+V")) {}
+        ImGui::Separator();
+        if (!SceneManager::IsInPlayMode() && ImGui::MenuItem("Play"))
+        {
+          SceneManager::EnterPlayMode();
+        }
+        else if (SceneManager::IsInPlayMode() && ImGui::MenuItem("Stop"))
+        {
+          SceneManager::ExitPlayMode();
+        }
         ImGui::EndMenu();
       }
 
@@ -320,6 +333,16 @@ namespace Editor
           Debug::Log << Logger::MessageType::INFO
             << "Profiling Window: " << show_frameinfo_window << '\n';
         }
+        if (ImGui::MenuItem("Profiler Flame View", "", &g_profilerView.GetBool()))
+        {
+          Debug::Log << Logger::MessageType::INFO
+            << "Profiler Flame View Window: " << g_profilerView.GetBool() << '\n';
+        }
+        if (ImGui::MenuItem("Memory Stats", "", &g_memoryStatsView.GetBool()))
+        {
+          Debug::Log << Logger::MessageType::INFO
+            << "Memory Stats Window: " << g_memoryStatsView.GetBool() << '\n';
+        }
 
         if (ImGui::MenuItem("DevConsole", "`",&g_devConsole.GetBool()))
         {
@@ -405,6 +428,8 @@ namespace Editor
         ImGui::Checkbox("GameObject Browser", &g_gameObjectBrowser.GetBool() );
         ImGui::Checkbox("Archetype Browser", &g_archetypeBrowser.GetBool());
         ImGui::Checkbox("Material Editor", &g_materialEditor.GetBool());
+        ImGui::Checkbox("Profiler", &g_profilerView.GetBool());
+        ImGui::Checkbox("Memory Stats", &g_memoryStatsView.GetBool());
         ImGui::Separator();
 
         ImGui::Checkbox("Demo Window", &show_demo_window);
@@ -519,6 +544,8 @@ namespace Editor
     g_comboBox.Update();
     g_devConsole.Update();
     g_postprocessSetting.Update(g_memberSerializer);
+    g_profilerView.Update();
+    g_memoryStatsView.Update();
 
     //Top Menu
     if (reenable_ui)
@@ -0,0 +1,62 @@
+/*!
+  @file MaskedOcclusionAvx2.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MaskedOcclusionAvx2
+*/
+#include "Graphics/Occlusion/MaskedOcclusionAvx2.hpp"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#endif
+
+namespace NightEngine::Rendering::Occlusion::Avx2
+{
+#if defined(__AVX2__)
+  bool IsCompiled(void) { return true; }
+
+  //Same operations in the same order as the SSE2 coverage (no fma), the bits match
+  void CoverTiles(const float* edgeA, const float* edgeB, const float* edgeC
+    , const int* tileX, int tileY, int tileCount, unsigned* outCoverage)
+  {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 laneX = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    const __m256 a[3] = { _mm256_set1_ps(edgeA[0]), _mm256_set1_ps(edgeA[1]), _mm256_set1_ps(edgeA[2]) };
+
+    //Start of every edge on the pixel center rows, the same for the whole tile row
+    const float y0 = static_cast<float>(tileY * c_TILE_HEIGHT) + 0.5f;
+    __m256 rowStart[c_TILE_HEIGHT][3];
+    for (int row = 0; row < c_TILE_HEIGHT; ++row)
+    {
+      const float y = y0 + static_cast<float>(row);
+      for (int e = 0; e < 3; ++e)
+      {
+        rowStart[row][e] = _mm256_set1_ps(edgeB[e] * y + edgeC[e]);
+      }
+    }
+
+    for (int t = 0; t < tileCount; ++t)
+    {
+      //A whole row of the tile per register
+      const __m256 x = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(tileX[t] * c_TILE_WIDTH)), laneX);
+      const __m256 ax[3] = { _mm256_mul_ps(a[0], x), _mm256_mul_ps(a[1], x), _mm256_mul_ps(a[2], x) };
+      unsigned coverage = 0;
+      for (int row = 0; row < c_TILE_HEIGHT; ++row)
+      {
+        __m256 outside = _mm256_cmp_ps(_mm256_add_ps(ax[0], rowStart[row][0]), zero, _CMP_LT_OQ);
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(ax[1], rowStart[row][1]), zero, _CMP_LT_OQ));
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(ax[2], rowStart[row][2]), zero, _CMP_LT_OQ));
+        coverage |= static_cast<unsigned>(~_mm256_movemask_ps(outside) & 0xFF) << (row * c_TILE_WIDTH);
+      }
+      outCoverage[t] = coverage;
+    }
+  }
+#else
+  //Built without the AVX2 flags, the SSE2 coverage does everything
+  bool IsCompiled(void) { return false; }
+
+  void CoverTiles(const float*, const float*, const float*
+    , const int*, int, int, unsigned*)
+  {
+  }
+#endif
+}
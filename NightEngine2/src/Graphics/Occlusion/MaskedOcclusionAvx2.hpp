@@ -0,0 +1,23 @@
+/*!
+  @file MaskedOcclusionAvx2.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MaskedOcclusionAvx2
+*/
+#pragma once
+
+//Only plain types here, the AVX2 file is built with its own flags and must not
+//instantiate inline functions the rest of the engine could end up calling
+namespace NightEngine::Rendering::Occlusion::Avx2
+{
+  //Same tile as MaskedOcclusionBuffer, a row of 8 pixels is one register
+  constexpr int c_TILE_WIDTH = 8;
+  constexpr int c_TILE_HEIGHT = 4;
+
+  //! @brief Check if the AVX2 file was built with the AVX2 flags
+  bool IsCompiled(void);
+
+  //! @brief Same as the SSE2 CoverTile of MaskedOcclusionBuffer for tileCount tiles of
+  // the tile row tileY, a bit per pixel center inside the 3 edges (a * x + b * y + c >= 0)
+  void CoverTiles(const float* edgeA, const float* edgeB, const float* edgeC
+    , const int* tileX, int tileY, int tileCount, unsigned* outCoverage);
+}
@@ -0,0 +1,570 @@
+/*!
+  @file MaskedOcclusionBuffer.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MaskedOcclusionBuffer
+*/
+#include "Graphics/Occlusion/MaskedOcclusionBuffer.hpp"
+#include "Graphics/Occlusion/MaskedOcclusionAvx2.hpp"
+#include "Core/Utility/SimdFloat4.hpp"
+#include "Core/Utility/CpuFeatures.hpp"
+#include "Core/Utility/JobSystem.hpp"
+
+#include "Core/Macros.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+using namespace NightEngine::Container;
+using namespace NightEngine::Simd;
+
+namespace NightEngine::Rendering::Occlusion
+{
+  static const U32 c_FULL_COVERAGE = 0xFFFFFFFFu;
+
+  //Triangles set up per job, enough to hide the scheduling
+  static const size_t c_CHUNK_TRIANGLES = 2048;
+
+  //Bands of tile rows rasterized in parallel, each one own its rows
+  static const int c_MAX_BINS = 16;
+
+  static const size_t c_MIN_BOX_BATCH = 64;
+
+  //Partial tiles of a tile row gathered before computing their coverage
+  static const int c_TILE_BATCH = 64;
+
+  static_assert(MaskedOcclusionBuffer::c_TILE_WIDTH == Avx2::c_TILE_WIDTH
+    && MaskedOcclusionBuffer::c_TILE_HEIGHT == Avx2::c_TILE_HEIGHT, "AVX2 coverage use another tile");
+
+  //! @brief Merge a triangle covering coverage, nowhere farther than depth, in a tile
+  static inline void MergeTile(U32& tileCoverage, float& tileDepth, float& coveredDepth
+    , U32 coverage, float depth)
+  {
+    if (depth <= tileDepth)
+    {
+      return;
+    }
+
+    //Start the covered layer over when the triangle is much nearer than it,
+    //the pixels it had go back to the tile depth
+    if (tileCoverage == 0 || depth - coveredDepth > coveredDepth - tileDepth)
+    {
+      tileCoverage = coverage;
+      coveredDepth = depth;
+    }
+    else
+    {
+      tileCoverage |= coverage;
+      coveredDepth = std::min(coveredDepth, depth);
+    }
+
+    //Every pixel is covered, the whole tile move forward
+    if (tileCoverage == c_FULL_COVERAGE)
+    {
+      tileDepth = coveredDepth;
+      tileCoverage = 0;
+    }
+  }
+
+  static bool UseAvx2(void)
+  {
+    return Avx2::IsCompiled() && CpuFeatures::IsAvx2Enabled();
+  }
+
+  //! @brief Bit per pixel center of the tile inside the 3 edges (a * x + b * y + c >= 0),
+  // half a tile row per lane group
+  static inline U32 CoverTile(const float* edgeA, const float* edgeB, const float* edgeC
+    , int tileX, int tileY)
+  {
+    const Float4 zero = Splat(0.0f);
+    const Float4 left = Splat(static_cast<float>(tileX * MaskedOcclusionBuffer::c_TILE_WIDTH))
+      + Set(0.5f, 1.5f, 2.5f, 3.5f);
+    const Float4 right = left + Splat(4.0f);
+    const float y0 = static_cast<float>(tileY * MaskedOcclusionBuffer::c_TILE_HEIGHT) + 0.5f;
+
+    U32 coverage = 0;
+    for (int row = 0; row < MaskedOcclusionBuffer::c_TILE_HEIGHT; ++row)
+    {
+      const float y = y0 + static_cast<float>(row);
+      int outsideBits = 0;
+      for (int e = 0; e < 3; ++e)
+      {
+        const Float4 a = Splat(edgeA[e]);
+        const Float4 rowStart = Splat(edgeB[e] * y + edgeC[e]);
+        outsideBits |= MoveMask(CmpLess(MulAdd(a, left, rowStart), zero))
+          | (MoveMask(CmpLess(MulAdd(a, right, rowStart), zero)) << 4);
+      }
+      coverage |= static_cast<U32>(~outsideBits & 0xFF) << (row * MaskedOcclusionBuffer::c_TILE_WIDTH);
+    }
+    return coverage;
+  }
+
+  //! @brief Position transformed by the columns of a matrix
+  static inline Float4 TransformPoint(const Float4 columns[4], const glm::vec3& position)
+  {
+    return MulAdd(columns[0], Splat(position.x), MulAdd(columns[1], Splat(position.y)
+      , MulAdd(columns[2], Splat(position.z), columns[3])));
+  }
+
+  static inline void LoadColumns(const glm::mat4& matrix, Float4 outColumns[4])
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      outColumns[i] = Load(&matrix[i][0]);
+    }
+  }
+
+  //! @brief Bits of the clip planes v is outside of
+  static inline int GetOutcode(const glm::vec4& v)
+  {
+    return (v.x < -v.w ? 1 : 0) | (v.x > v.w ? 2 : 0) | (v.y < -v.w ? 4 : 0)
+      | (v.y > v.w ? 8 : 0) | (v.z < -v.w ? 16 : 0) | (v.z > v.w ? 32 : 0);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void MaskedOcclusionBuffer::Resize(int width, int height)
+  {
+    ASSERT_MSG(width > 0 && height > 0, "MaskedOcclusionBuffer need a resolution");
+    m_tilesX = (width + c_TILE_WIDTH - 1) / c_TILE_WIDTH;
+    m_tilesY = (height + c_TILE_HEIGHT - 1) / c_TILE_HEIGHT;
+
+    m_tileRowsPerBin = (m_tilesY + c_MAX_BINS - 1) / c_MAX_BINS;
+    m_binCount = (m_tilesY + m_tileRowsPerBin - 1) / m_tileRowsPerBin;
+    Clear();
+  }
+
+  void MaskedOcclusionBuffer::Clear(void)
+  {
+    size_t tileCount = static_cast<size_t>(m_tilesX) * m_tilesY;
+    m_coverage.assign(tileCount, 0);
+    m_tileDepth.assign(tileCount, 0.0f);
+    m_coveredDepth.assign(tileCount, 0.0f);
+    m_rasterizedTriangles = 0;
+  }
+
+  void MaskedOcclusionBuffer::RenderOccluders(const glm::mat4& viewProjection
+    , const OccluderInstance* occluders, size_t count)
+  {
+    ASSERT_MSG(m_tilesX > 0, "MaskedOcclusionBuffer must be resized before rendering");
+
+    //Clip space vertices of every occluder
+    m_vertexOffsets.resize(count + 1);
+    m_vertexOffsets[0] = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      m_vertexOffsets[i + 1] = m_vertexOffsets[i] + occluders[i].m_mesh->m_positions.size();
+    }
+    m_clipVertices.resize(m_vertexOffsets[count]);
+
+    JobSystem::ParallelFor(count, 1, [this, occluders, &viewProjection](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        Float4 columns[4];
+        LoadColumns(viewProjection * occluders[i].m_model, columns);
+
+        const auto& positions = occluders[i].m_mesh->m_positions;
+        glm::vec4* clip = m_clipVertices.data() + m_vertexOffsets[i];
+        for (size_t v = 0; v < positions.size(); ++v)
+        {
+          Store(TransformPoint(columns, positions[v]), &clip[v].x);
+        }
+      }
+    });
+
+    //Big meshes are split so they don't end on one worker
+    m_chunkCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      size_t triangleCount = occluders[i].m_mesh->m_indices.size() / 3;
+      for (size_t first = 0; first < triangleCount; first += c_CHUNK_TRIANGLES)
+      {
+        if (m_chunkCount == m_chunks.size())
+        {
+          m_chunks.emplace_back();
+        }
+
+        ChunkWork& chunk = m_chunks[m_chunkCount++];
+        chunk.m_occluder = i;
+        chunk.m_firstTriangle = first;
+        chunk.m_triangleCount = std::min(c_CHUNK_TRIANGLES, triangleCount - first);
+      }
+    }
+
+    JobSystem::ParallelFor(m_chunkCount, 1, [this, occluders](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        SetupChunk(m_chunks[i], occluders);
+      }
+    });
+
+    JobSystem::ParallelFor(static_cast<size_t>(m_binCount), 1, [this](size_t begin, size_t end)
+    {
+      for (size_t bin = begin; bin < end; ++bin)
+      {
+        RasterizeBin(bin);
+      }
+    });
+
+    m_rasterizedTriangles = 0;
+    for (size_t i = 0; i < m_chunkCount; ++i)
+    {
+      m_rasterizedTriangles += m_chunks[i].m_triangles.size();
+    }
+  }
+
+  bool MaskedOcclusionBuffer::IsVisible(const glm::mat4& viewProjection, const OcclusionBox& box) const
+  {
+    if (m_tilesX == 0)
+    {
+      return true;
+    }
+
+    Float4 columns[4];
+    LoadColumns(viewProjection, columns);
+
+    //Screen rectangle and nearest depth of the corners
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    float nearestDepth = 0.0f;
+    const float width = static_cast<float>(GetWidth());
+    const float height = static_cast<float>(GetHeight());
+    for (int i = 0; i < 8; ++i)
+    {
+      glm::vec3 corner{ (i & 1) ? box.m_max.x : box.m_min.x
+        , (i & 2) ? box.m_max.y : box.m_min.y, (i & 4) ? box.m_max.z : box.m_min.z };
+      glm::vec4 clip;
+      Store(TransformPoint(columns, corner), &clip.x);
+
+      //In front of the near plane, nothing can hide it
+      if (clip.z < -clip.w || clip.w <= 0.0f)
+      {
+        return true;
+      }
+
+      float invW = 1.0f / clip.w;
+      float x = (clip.x * invW * 0.5f + 0.5f) * width;
+      float y = (clip.y * invW * 0.5f + 0.5f) * height;
+      minX = std::min(minX, x);
+      maxX = std::max(maxX, x);
+      minY = std::min(minY, y);
+      maxY = std::max(maxY, y);
+      nearestDepth = std::max(nearestDepth, invW);
+    }
+
+    if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+    {
+      return true;
+    }
+
+    //Every pixel the rectangle touch
+    int pixelMinX = static_cast<int>(std::max(minX, 0.0f));
+    int pixelMinY = static_cast<int>(std::max(minY, 0.0f));
+    int pixelMaxX = static_cast<int>(std::min(maxX, width - 1.0f));
+    int pixelMaxY = static_cast<int>(std::min(maxY, height - 1.0f));
+
+    const Float4 boxDepth = Splat(nearestDepth);
+    for (int tileY = pixelMinY / c_TILE_HEIGHT; tileY <= pixelMaxY / c_TILE_HEIGHT; ++tileY)
+    {
+      //Rows of the rectangle in this tile row
+      int rowBegin = std::max(pixelMinY - tileY * c_TILE_HEIGHT, 0);
+      int rowEnd = std::min(pixelMaxY - tileY * c_TILE_HEIGHT, c_TILE_HEIGHT - 1);
+      U32 rowsMask = 0;
+      for (int row = rowBegin; row <= rowEnd; ++row)
+      {
+        rowsMask |= 0xFFu << (row * c_TILE_WIDTH);
+      }
+
+      const int tileMinX = pixelMinX / c_TILE_WIDTH;
+      const int tileMaxX = pixelMaxX / c_TILE_WIDTH;
+      const size_t rowIndex = static_cast<size_t>(tileY) * m_tilesX;
+      for (int tileX = tileMinX; tileX <= tileMaxX; )
+      {
+        //Four tiles behind at once by their whole tile depth alone
+        if (tileX + 3 <= tileMaxX
+          && MoveMask(CmpLess(boxDepth, Load(&m_tileDepth[rowIndex + tileX]))) == 0xF)
+        {
+          tileX += 4;
+          continue;
+        }
+
+        //Otherwise the covered pixels may still hide the part of the rectangle in the tile
+        int columnBegin = std::max(pixelMinX - tileX * c_TILE_WIDTH, 0);
+        int columnEnd = std::min(pixelMaxX - tileX * c_TILE_WIDTH, c_TILE_WIDTH - 1);
+        U32 columns8 = (0xFFu >> (c_TILE_WIDTH - 1 - columnEnd)) & (0xFFu << columnBegin);
+        U32 rectangle = rowsMask & (columns8 * 0x01010101u);
+
+        size_t index = rowIndex + tileX;
+        U32 coverage = m_coverage[index];
+        float depth = coverage != 0 && (rectangle & ~coverage) == 0 ?
+          m_coveredDepth[index] : m_tileDepth[index];
+        if (!(nearestDepth < depth))
+        {
+          return true;
+        }
+        ++tileX;
+      }
+    }
+    return false;
+  }
+
+  void MaskedOcclusionBuffer::TestBoxes(const glm::mat4& viewProjection, const OcclusionBox* boxes
+    , size_t count, U8* outVisible) const
+  {
+    JobSystem::ParallelFor(count, c_MIN_BOX_BATCH, [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        outVisible[i] = IsVisible(viewProjection, boxes[i]) ? 1 : 0;
+      }
+    });
+  }
+
+  float MaskedOcclusionBuffer::GetPixelDepth(int x, int y) const
+  {
+    ASSERT_TRUE(x >= 0 && x < GetWidth() && y >= 0 && y < GetHeight());
+    size_t index = static_cast<size_t>(y / c_TILE_HEIGHT) * m_tilesX + x / c_TILE_WIDTH;
+    U32 bit = 1u << ((y % c_TILE_HEIGHT) * c_TILE_WIDTH + x % c_TILE_WIDTH);
+    return (m_coverage[index] & bit) != 0 ? m_coveredDepth[index] : m_tileDepth[index];
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void MaskedOcclusionBuffer::SetupChunk(ChunkWork& chunk, const OccluderInstance* occluders) const
+  {
+    chunk.m_triangles.clear();
+    chunk.m_bins.resize(m_binCount);
+    for (auto& bin : chunk.m_bins)
+    {
+      bin.clear();
+    }
+
+    const auto& indices = occluders[chunk.m_occluder].m_mesh->m_indices;
+    const glm::vec4* clip = m_clipVertices.data() + m_vertexOffsets[chunk.m_occluder];
+    const size_t vertexCount = m_vertexOffsets[chunk.m_occluder + 1] - m_vertexOffsets[chunk.m_occluder];
+    const size_t end = (chunk.m_firstTriangle + chunk.m_triangleCount) * 3;
+    for (size_t i = chunk.m_firstTriangle * 3; i < end; i += 3)
+    {
+      if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount)
+      {
+        continue;
+      }
+
+      const glm::vec4 v[3] = { clip[indices[i]], clip[indices[i + 1]], clip[indices[i + 2]] };
+      int outcodes[3] = { GetOutcode(v[0]), GetOutcode(v[1]), GetOutcode(v[2]) };
+      if ((outcodes[0] & outcodes[1] & outcodes[2]) != 0)
+      {
+        continue;
+      }
+
+      const int c_NEAR_BIT = 16;
+      if (((outcodes[0] | outcodes[1] | outcodes[2]) & c_NEAR_BIT) == 0)
+      {
+        AddTriangle(chunk, v[0], v[1], v[2]);
+        continue;
+      }
+
+      //Clip against the near plane z = -w, keep the winding
+      glm::vec4 polygon[4];
+      int polygonSize = 0;
+      for (int e = 0; e < 3; ++e)
+      {
+        const glm::vec4& a = v[e];
+        const glm::vec4& b = v[(e + 1) % 3];
+        float da = a.z + a.w;
+        float db = b.z + b.w;
+        if (da >= 0.0f)
+        {
+          polygon[polygonSize++] = a;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f))
+        {
+          polygon[polygonSize++] = a + (b - a) * (da / (da - db));
+        }
+      }
+
+      for (int p = 2; p < polygonSize; ++p)
+      {
+        AddTriangle(chunk, polygon[0], polygon[p - 1], polygon[p]);
+      }
+    }
+  }
+
+  void MaskedOcclusionBuffer::AddTriangle(ChunkWork& chunk, const glm::vec4& v0, const glm::vec4& v1
+    , const glm::vec4& v2) const
+  {
+    const float width = static_cast<float>(GetWidth());
+    const float height = static_cast<float>(GetHeight());
+    float x[3], y[3], depth[3];
+    const glm::vec4* v[3] = { &v0, &v1, &v2 };
+    for (int i = 0; i < 3; ++i)
+    {
+      if (!(v[i]->w > 0.0f))
+      {
+        return;
+      }
+      depth[i] = 1.0f / v[i]->w;
+      x[i] = (v[i]->x * depth[i] * 0.5f + 0.5f) * width;
+      y[i] = (v[i]->y * depth[i] * 0.5f + 0.5f) * height;
+    }
+
+    //Back faces and degenerate triangles
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (!(area > 0.0f))
+    {
+      return;
+    }
+
+    float minX = std::min({ x[0], x[1], x[2] });
+    float maxX = std::max({ x[0], x[1], x[2] });
+    float minY = std::min({ y[0], y[1], y[2] });
+    float maxY = std::max({ y[0], y[1], y[2] });
+    if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+    {
+      return;
+    }
+
+    ScreenTriangle triangle;
+    triangle.m_tileMinX = static_cast<int>(std::max(minX, 0.0f)) / c_TILE_WIDTH;
+    triangle.m_tileMinY = static_cast<int>(std::max(minY, 0.0f)) / c_TILE_HEIGHT;
+    triangle.m_tileMaxX = static_cast<int>(std::min(maxX, width - 1.0f)) / c_TILE_WIDTH;
+    triangle.m_tileMaxY = static_cast<int>(std::min(maxY, height - 1.0f)) / c_TILE_HEIGHT;
+
+    //Counter clockwise, the inside is on the left of every edge
+    for (int i = 0; i < 3; ++i)
+    {
+      int j = (i + 1) % 3;
+      triangle.m_edgeA[i] = y[i] - y[j];
+      triangle.m_edgeB[i] = x[j] - x[i];
+      triangle.m_edgeC[i] = -(triangle.m_edgeA[i] * x[i] + triangle.m_edgeB[i] * y[i]);
+    }
+
+    float dx1 = x[1] - x[0], dy1 = y[1] - y[0], dz1 = depth[1] - depth[0];
+    float dx2 = x[2] - x[0], dy2 = y[2] - y[0], dz2 = depth[2] - depth[0];
+    triangle.m_depthA = (dz1 * dy2 - dy1 * dz2) / area;
+    triangle.m_depthB = (dx1 * dz2 - dz1 * dx2) / area;
+    triangle.m_depthC = depth[0] - triangle.m_depthA * x[0] - triangle.m_depthB * y[0];
+    triangle.m_minDepth = std::min({ depth[0], depth[1], depth[2] });
+
+    U32 triangleIndex = static_cast<U32>(chunk.m_triangles.size());
+    chunk.m_triangles.emplace_back(triangle);
+    for (int bin = triangle.m_tileMinY / m_tileRowsPerBin; bin <= triangle.m_tileMaxY / m_tileRowsPerBin; ++bin)
+    {
+      chunk.m_bins[bin].emplace_back(triangleIndex);
+    }
+  }
+
+  void MaskedOcclusionBuffer::RasterizeBin(size_t bin)
+  {
+    //Chunks in order so the result doesn't depend on the worker count
+    int tileRowBegin = static_cast<int>(bin) * m_tileRowsPerBin;
+    int tileRowEnd = std::min(m_tilesY, tileRowBegin + m_tileRowsPerBin);
+    for (size_t c = 0; c < m_chunkCount; ++c)
+    {
+      const ChunkWork& chunk = m_chunks[c];
+      for (U32 triangleIndex : chunk.m_bins[bin])
+      {
+        RasterizeTriangle(chunk.m_triangles[triangleIndex], tileRowBegin, tileRowEnd);
+      }
+    }
+  }
+
+  void MaskedOcclusionBuffer::RasterizeTriangle(const ScreenTriangle& triangle
+    , int tileRowBegin, int tileRowEnd)
+  {
+    const bool useAvx2 = UseAvx2();
+    int partialTiles[c_TILE_BATCH];
+    U32 coverage[c_TILE_BATCH];
+
+    int tileMinY = std::max(triangle.m_tileMinY, tileRowBegin);
+    int tileMaxY = std::min(triangle.m_tileMaxY, tileRowEnd - 1);
+    for (int tileY = tileMinY; tileY <= tileMaxY; ++tileY)
+    {
+      //Pixel centers at the corners of the tile
+      const float y0 = static_cast<float>(tileY * c_TILE_HEIGHT) + 0.5f;
+      const float y1 = y0 + static_cast<float>(c_TILE_HEIGHT - 1);
+
+      //Farthest depth of the plane over the tile, never past the farthest vertex
+      auto mergeTile = [&](int tileX, U32 tileCoverage)
+      {
+        const float x0 = static_cast<float>(tileX * c_TILE_WIDTH) + 0.5f;
+        const float x1 = x0 + static_cast<float>(c_TILE_WIDTH - 1);
+        float a = triangle.m_depthA;
+        float b = triangle.m_depthB;
+        float depth = triangle.m_depthC + a * (a >= 0.0f ? x0 : x1) + b * (b >= 0.0f ? y0 : y1);
+        depth = std::max(depth, triangle.m_minDepth);
+
+        size_t index = static_cast<size_t>(tileY) * m_tilesX + tileX;
+        MergeTile(m_coverage[index], m_tileDepth[index], m_coveredDepth[index], tileCoverage, depth);
+      };
+
+      //AVX2 coverage is a call away, partial tiles are gathered and computed a batch at once
+      int partialCount = 0;
+      auto mergePartialTiles = [&]()
+      {
+        Avx2::CoverTiles(triangle.m_edgeA, triangle.m_edgeB, triangle.m_edgeC
+          , partialTiles, tileY, partialCount, coverage);
+        for (int t = 0; t < partialCount; ++t)
+        {
+          if (coverage[t] != 0)
+          {
+            mergeTile(partialTiles[t], coverage[t]);
+          }
+        }
+        partialCount = 0;
+      };
+
+      for (int tileX = triangle.m_tileMinX; tileX <= triangle.m_tileMaxX; ++tileX)
+      {
+        const float x0 = static_cast<float>(tileX * c_TILE_WIDTH) + 0.5f;
+        const float x1 = x0 + static_cast<float>(c_TILE_WIDTH - 1);
+
+        //Edges at the corners tell if the tile is fully outside or fully inside
+        bool outside = false;
+        bool inside = true;
+        for (int e = 0; e < 3 && !outside; ++e)
+        {
+          float a = triangle.m_edgeA[e];
+          float b = triangle.m_edgeB[e];
+          float c = triangle.m_edgeC[e];
+          float farthest = c + a * (a >= 0.0f ? x1 : x0) + b * (b >= 0.0f ? y1 : y0);
+          float nearest = c + a * (a >= 0.0f ? x0 : x1) + b * (b >= 0.0f ? y0 : y1);
+          outside = farthest < 0.0f;
+          inside = inside && nearest >= 0.0f;
+        }
+        if (outside)
+        {
+          continue;
+        }
+
+        if (inside)
+        {
+          mergeTile(tileX, c_FULL_COVERAGE);
+          continue;
+        }
+
+        if (!useAvx2)
+        {
+          U32 tileCoverage = CoverTile(triangle.m_edgeA, triangle.m_edgeB, triangle.m_edgeC, tileX, tileY);
+          if (tileCoverage != 0)
+          {
+            mergeTile(tileX, tileCoverage);
+          }
+          continue;
+        }
+
+        partialTiles[partialCount++] = tileX;
+        if (partialCount == c_TILE_BATCH)
+        {
+          mergePartialTiles();
+        }
+      }
+
+      if (partialCount > 0)
+      {
+        mergePartialTiles();
+      }
+    }
+  }
+}
@@ -0,0 +1,134 @@
+/*!
+  @file MaskedOcclusionBuffer.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MaskedOcclusionBuffer
+*/
+#pragma once
+
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace NightEngine::Rendering::Occlusion
+{
+  //! @brief Positions and triangle list of a mesh, kept on the CPU for the occlusion buffer
+  struct OccluderMesh
+  {
+    Container::Vector<glm::vec3>      m_positions;
+    Container::Vector<Container::U32> m_indices;
+  };
+
+  //! @brief One occluder mesh placed in the world
+  struct OccluderInstance
+  {
+    const OccluderMesh* m_mesh = nullptr;
+    glm::mat4           m_model{ 1.0f };
+  };
+
+  //! @brief World space box tested against the occluders
+  struct OcclusionBox
+  {
+    glm::vec3 m_min{ 0.0f };
+    glm::vec3 m_max{ 0.0f };
+  };
+
+  //! @brief Low resolution depth of the occluders for testing bounding boxes on the CPU.
+  // The screen is split in 8x4 pixel tiles, each tile keep a coverage bit per pixel
+  // and two depths: the farthest depth of the whole tile and the farthest depth of
+  // the covered pixels. Depths are 1/w so they interpolate linearly across the screen,
+  // bigger is nearer. Results are conservative: a box is only reported hidden if it is
+  // behind the occluders at every pixel it covers.
+  class MaskedOcclusionBuffer
+  {
+    public:
+      static constexpr int c_TILE_WIDTH = 8;
+      static constexpr int c_TILE_HEIGHT = 4;
+
+      //! @brief Set the resolution, rounded up to whole tiles, and clear
+      void Resize(int width, int height);
+
+      //! @brief Forget every occluder
+      void Clear(void);
+
+      //! @brief Rasterize the front faces of the occluders, counter clockwise like GL_CCW.
+      // Vertices and triangles are set up across the JobSystem workers, then each worker
+      // rasterize the triangles of its band of tile rows
+      void RenderOccluders(const glm::mat4& viewProjection
+        , const OccluderInstance* occluders, size_t count);
+
+      //! @brief False if the box is behind the occluders everywhere on screen. Boxes
+      // crossing the near plane or outside of the screen are visible
+      bool IsVisible(const glm::mat4& viewProjection, const OcclusionBox& box) const;
+
+      //! @brief Test every box across the workers, outVisible get 1 for the visible ones
+      void TestBoxes(const glm::mat4& viewProjection, const OcclusionBox* boxes, size_t count
+        , Container::U8* outVisible) const;
+
+      ///////////////////////////////////////////////////////
+
+      int GetWidth(void) const { return m_tilesX * c_TILE_WIDTH; }
+
+      int GetHeight(void) const { return m_tilesY * c_TILE_HEIGHT; }
+
+      //! @brief Triangles rasterized by the last RenderOccluders, after clipping and culling
+      size_t GetRasterizedTriangleCount(void) const { return m_rasterizedTriangles; }
+
+      //! @brief Farthest depth known at a pixel, 0 where nothing was rasterized
+      float GetPixelDepth(int x, int y) const;
+    private:
+      //! @brief Triangle ready to rasterize, edges and depth are planes in pixel space
+      struct ScreenTriangle
+      {
+        float m_edgeA[3];
+        float m_edgeB[3];
+        float m_edgeC[3];       //Inside where a * x + b * y + c >= 0
+        float m_depthA;
+        float m_depthB;
+        float m_depthC;
+        float m_minDepth;       //Farthest vertex, bound the depth plane
+        int   m_tileMinX;
+        int   m_tileMinY;
+        int   m_tileMaxX;
+        int   m_tileMaxY;
+      };
+
+      //! @brief Set up triangles of a chunk, listed per band of tile rows
+      struct ChunkWork
+      {
+        size_t                                    m_occluder = 0;
+        size_t                                    m_firstTriangle = 0;
+        size_t                                    m_triangleCount = 0;
+        Container::Vector<ScreenTriangle>         m_triangles;
+        Container::Vector<Container::Vector<Container::U32>> m_bins;
+      };
+
+      void SetupChunk(ChunkWork& chunk, const OccluderInstance* occluders) const;
+
+      void AddTriangle(ChunkWork& chunk, const glm::vec4& v0, const glm::vec4& v1
+        , const glm::vec4& v2) const;
+
+      void RasterizeBin(size_t bin);
+
+      void RasterizeTriangle(const ScreenTriangle& triangle, int tileRowBegin, int tileRowEnd);
+
+      int                                m_tilesX = 0;
+      int                                m_tilesY = 0;
+      int                                m_binCount = 1;
+      int                                m_tileRowsPerBin = 1;
+
+      //Per tile, see the class brief
+      Container::Vector<Container::U32>  m_coverage;
+      Container::Vector<float>           m_tileDepth;       //Whole tile
+      Container::Vector<float>           m_coveredDepth;    //Covered pixels
+
+      //Scratch kept across frames
+      Container::Vector<glm::vec4>       m_clipVertices;
+      Container::Vector<size_t>          m_vertexOffsets;
+      Container::Vector<ChunkWork>       m_chunks;
+      size_t                             m_chunkCount = 0;
+      size_t                             m_rasterizedTriangles = 0;
+  };
+}
@@ -0,0 +1,125 @@
+/*!
+  @file OcclusionCulling.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of OcclusionCulling
+*/
+#include "Graphics/Occlusion/OcclusionCulling.hpp"
+#include "Graphics/Opengl/InstanceDrawer.hpp"
+#include "Graphics/Opengl/MeshRenderer.hpp"
+
+#include "Core/Utility/Utility.hpp"
+
+#include <glm/common.hpp>
+#include <glm/mat3x3.hpp>
+
+#include <algorithm>
+
+using namespace NightEngine::Rendering::Opengl;
+using namespace NightEngine::EC::Components;
+
+namespace NightEngine::Rendering::Occlusion
+{
+  static const Drawer::DrawPass c_CULLED_PASSES[] = { Drawer::DrawPass::UNDEFINED
+    , Drawer::DrawPass::OPAQUE_PASS };
+
+  //! @brief World box around a local box under a model matrix
+  static OcclusionBox TransformBox(const glm::mat4& model, const glm::vec3& localMin
+    , const glm::vec3& localMax)
+  {
+    glm::vec3 center = glm::vec3(model * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+    glm::vec3 extent = (localMax - localMin) * 0.5f;
+
+    glm::mat3 absolute{ model };
+    for (int i = 0; i < 3; ++i)
+    {
+      absolute[i] = glm::abs(absolute[i]);
+    }
+    glm::vec3 worldExtent = absolute * extent;
+    return OcclusionBox{ center - worldExtent, center + worldExtent };
+  }
+
+  void OcclusionCulling::Cull(const glm::mat4& viewProjection, float aspectRatio)
+  {
+    Utility::StopWatch watch{ true };
+    Reset();
+
+    //Occluders and occludees of the frame, skinned meshes outgrow their bounds
+    //and occluders aren't tested against themselves
+    m_occluders.clear();
+    m_boxes.clear();
+    m_tested.clear();
+    for (auto drawPass : c_CULLED_PASSES)
+    {
+      for (auto& handle : Drawer::GetDrawContainer(drawPass))
+      {
+        auto mr = handle.Get<MeshRenderer>();
+        if (mr->IsOccluder() && !mr->IsSkinned())
+        {
+          glm::mat4 model = mr->GetModelMatrix();
+          for (auto& mesh : mr->GetMeshes())
+          {
+            if (mesh.GetOccluderMesh() != nullptr)
+            {
+              m_occluders.emplace_back(OccluderInstance{ mesh.GetOccluderMesh(), model });
+            }
+          }
+          continue;
+        }
+
+        glm::vec3 localMin, localMax;
+        if (mr->IsSkinned() || !mr->GetLocalBounds(localMin, localMax))
+        {
+          continue;
+        }
+        m_boxes.emplace_back(TransformBox(mr->GetModelMatrix(), localMin, localMax));
+        m_tested.emplace_back(mr);
+      }
+    }
+
+    int height = std::max(static_cast<int>(m_bufferWidth / std::max(aspectRatio, 0.01f))
+      , MaskedOcclusionBuffer::c_TILE_HEIGHT);
+    m_buffer.Resize(m_bufferWidth, height);
+    m_buffer.RenderOccluders(viewProjection, m_occluders.data(), m_occluders.size());
+
+    m_stats = OcclusionCullingStats();
+    m_stats.m_occluderCount = m_occluders.size();
+    m_stats.m_occluderTriangles = m_buffer.GetRasterizedTriangleCount();
+    m_stats.m_testedCount = m_boxes.size();
+
+    //Nothing rasterized, nothing can be hidden
+    if (m_stats.m_occluderTriangles > 0)
+    {
+      m_visible.resize(m_boxes.size());
+      m_buffer.TestBoxes(viewProjection, m_boxes.data(), m_boxes.size(), m_visible.data());
+      for (size_t i = 0; i < m_tested.size(); ++i)
+      {
+        if (m_visible[i] == 0)
+        {
+          m_tested[i]->SetOccluded(true);
+          ++m_stats.m_occludedCount;
+        }
+      }
+      m_hasOccluded = m_stats.m_occludedCount > 0;
+    }
+
+    watch.Stop();
+    m_stats.m_cpuMs = static_cast<float>(watch.GetElapsedTimeMilli());
+  }
+
+  void OcclusionCulling::Reset(void)
+  {
+    if (!m_hasOccluded)
+    {
+      return;
+    }
+
+    for (auto drawPass : c_CULLED_PASSES)
+    {
+      for (auto& handle : Drawer::GetDrawContainer(drawPass))
+      {
+        handle.Get<MeshRenderer>()->SetOccluded(false);
+      }
+    }
+    m_hasOccluded = false;
+  }
+} // Rendering
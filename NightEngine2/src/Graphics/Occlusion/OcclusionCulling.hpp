@@ -0,0 +1,56 @@
+/*!
+  @file OcclusionCulling.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of OcclusionCulling
+*/
+#pragma once
+
+#include "Graphics/Occlusion/MaskedOcclusionBuffer.hpp"
+
+namespace NightEngine::EC::Components
+{
+  class MeshRenderer;
+}
+
+namespace NightEngine::Rendering::Occlusion
+{
+  //! @brief Numbers of the last Cull
+  struct OcclusionCullingStats
+  {
+    size_t m_occluderCount = 0;
+    size_t m_occluderTriangles = 0;     //Rasterized, after clipping and culling
+    size_t m_testedCount = 0;
+    size_t m_occludedCount = 0;
+    float  m_cpuMs = 0.0f;
+  };
+
+  //! @brief Hide the MeshRenderers of the Drawer behind the occluder ones for a frame.
+  // Renderers flagged as occluder are rasterized into a MaskedOcclusionBuffer, then
+  // the world box of every other renderer is tested against it
+  class OcclusionCulling
+  {
+    public:
+      //! @brief Width of the buffer, the height follow the aspect ratio
+      int m_bufferWidth = 320;
+
+      //! @brief Set the occluded flag of the UNDEFINED and OPAQUE_PASS renderers
+      void Cull(const glm::mat4& viewProjection, float aspectRatio);
+
+      //! @brief Show every renderer again
+      void Reset(void);
+
+      const OcclusionCullingStats& GetStats(void) const { return m_stats; }
+
+      const MaskedOcclusionBuffer& GetBuffer(void) const { return m_buffer; }
+    private:
+      MaskedOcclusionBuffer            m_buffer;
+      OcclusionCullingStats            m_stats;
+      bool                             m_hasOccluded = false;
+
+      //Scratch kept across frames
+      Container::Vector<OccluderInstance> m_occluders;
+      Container::Vector<OcclusionBox>     m_boxes;
+      Container::Vector<EC::Components::MeshRenderer*> m_tested;
+      Container::Vector<Container::U8>    m_visible;
+  };
+} // Rendering
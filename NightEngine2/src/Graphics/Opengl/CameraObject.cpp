@@ -85,8 +85,9 @@ namespace NightEngine::Rendering::Opengl
       float texelOffsetX = (GetHaltonSequence(index, 2) * jitterStrength) - (jitterStrength * 0.5f); //[-0.5,0.5]
       float texelOffsetY = (GetHaltonSequence(index, 3) * jitterStrength) - (jitterStrength * 0.5f); //[-0.5,0.5]
 
-      float pixelWidth = Window::GetWidth();
-      float pixelHeight = Window::GetHeight();
+      //Jitter by the pixels actually rendered
+      float pixelWidth = (float)camera.m_viewportPixelResolution.x;
+      float pixelHeight = (float)camera.m_viewportPixelResolution.y;
 
       jitteredUV.x = texelOffsetX / pixelWidth;
       jitteredUV.y = texelOffsetY / pixelHeight;
@@ -179,6 +180,8 @@ namespace NightEngine::Rendering::Opengl
     m_windowPixelResolution.y = Window::GetHeight();
     m_scaledPixelResolution.x = (int)(m_windowPixelResolution.x * m_renderScale);
     m_scaledPixelResolution.y = (int)(m_windowPixelResolution.y * m_renderScale);
+    m_viewportPixelResolution.x = glm::max((int)(m_scaledPixelResolution.x * m_dynamicScale), 1);
+    m_viewportPixelResolution.y = glm::max((int)(m_scaledPixelResolution.y * m_dynamicScale), 1);
 
     //Matrix
     m_view = CalculateViewMatrix(m_position, m_dirForward, WORLD_UP);
@@ -32,6 +32,11 @@ namespace NightEngine::Rendering::Opengl
     glm::ivec2 m_windowPixelResolution = glm::ivec2(1, 1);
     float m_renderScale = 1.0f;
 
+    //Dynamic resolution, targets stay at the scaled resolution and only
+    //the viewport shrink, TAA upscale it back
+    glm::ivec2 m_viewportPixelResolution = glm::ivec2(1, 1);
+    float m_dynamicScale = 1.0f;
+
     CameraType m_projectionType = CameraType::PERSPECTIVE;
 		glm::vec3 m_position = DEFAULT_CAM_POS;
 		glm::vec3 m_eulerAngle = VEC3_ZERO;
@@ -90,6 +95,11 @@ namespace NightEngine::Rendering::Opengl
     
     inline glm::ivec2 GetWindowsSize(void) const { return m_windowPixelResolution; };
 
+    inline glm::ivec2 GetViewportSize(void) const { return m_viewportPixelResolution; };
+
+    //! @brief Part of the render targets covered by the viewport, to scale the uv sampling them
+    inline glm::vec2 GetUVScale(void) const { return glm::vec2(m_viewportPixelResolution) / glm::vec2(m_scaledPixelResolution); }
+
     //////////////////////////////////////////////////////////
 
     void ApplyCameraInfo(Shader& shader);
@@ -9,6 +9,7 @@
 #include "Core/Logger.hpp"
 #include "Core/Macros.hpp"
 #include "Core/Serialization/FileSystem.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
 
 #include <glad/glad.h>
 
@@ -129,8 +130,10 @@ namespace NightEngine::Rendering::Opengl
 
         //Default loading image
         stbi_set_flip_vertically_on_load(false);
-        unsigned char *data = stbi_load(filePath.c_str()
-          , &width, &height, &nrChannels, loadChannel);
+        FileView file = VirtualFileSystem::Read(filePath);
+        unsigned char *data = file.IsValid() ? stbi_load_from_memory(
+          reinterpret_cast<const stbi_uc*>(file.GetData()), static_cast<int>(file.GetSize())
+          , &width, &height, &nrChannels, loadChannel) : nullptr;
         if (data != nullptr)
         {
           glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i
@@ -0,0 +1,75 @@
+/*!
+  @file GpuTimer.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of GpuTimer
+*/
+#include "Graphics/Opengl/GpuTimer.hpp"
+
+#include <glad/glad.h>
+
+namespace NightEngine::Rendering::Opengl
+{
+  void GpuTimer::Init(void)
+  {
+    if (!m_initialized)
+    {
+      glGenQueries(c_QUERY_COUNT, m_queries);
+      m_writeIndex = 0;
+      m_pendingCount = 0;
+      m_initialized = true;
+    }
+  }
+
+  void GpuTimer::Release(void)
+  {
+    if (m_initialized)
+    {
+      glDeleteQueries(c_QUERY_COUNT, m_queries);
+      m_initialized = false;
+    }
+  }
+
+  void GpuTimer::Begin(void)
+  {
+    //All queries in flight, skip this frame rather than reuse one
+    if (!m_initialized || m_pendingCount == c_QUERY_COUNT)
+    {
+      return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_writeIndex]);
+  }
+
+  void GpuTimer::End(void)
+  {
+    if (!m_initialized || m_pendingCount == c_QUERY_COUNT)
+    {
+      return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    m_writeIndex = (m_writeIndex + 1) % c_QUERY_COUNT;
+    ++m_pendingCount;
+  }
+
+  bool GpuTimer::PollElapsedMs(float& elapsedMs)
+  {
+    if (!m_initialized || m_pendingCount == 0)
+    {
+      return false;
+    }
+
+    int readIndex = (m_writeIndex - m_pendingCount + c_QUERY_COUNT) % c_QUERY_COUNT;
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(m_queries[readIndex], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE)
+    {
+      return false;
+    }
+
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(m_queries[readIndex], GL_QUERY_RESULT, &elapsedNs);
+    --m_pendingCount;
+
+    elapsedMs = static_cast<float>(static_cast<double>(elapsedNs) / 1000000.0);
+    return true;
+  }
+}
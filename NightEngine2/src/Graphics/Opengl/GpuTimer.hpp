@@ -0,0 +1,38 @@
+/*!
+  @file GpuTimer.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of GpuTimer
+*/
+
+#pragma once
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief GPU time of a range of commands, read a few frames later so it never stall
+  class GpuTimer
+  {
+    public:
+    //! @brief Initialization
+    void Init(void);
+
+    //! @brief Release the queries
+    void Release(void);
+
+    //! @brief Start timing, one range per frame
+    void Begin(void);
+
+    //! @brief Stop timing
+    void End(void);
+
+    //! @brief Read the oldest finished range, false if none is ready
+    bool PollElapsedMs(float& elapsedMs);
+
+    private:
+    static constexpr int c_QUERY_COUNT = 4;
+
+    unsigned int m_queries[c_QUERY_COUNT] = {};
+    int  m_writeIndex = 0;
+    int  m_pendingCount = 0;
+    bool m_initialized = false;
+  };
+}
@@ -15,6 +15,9 @@
 
 #include "Core/EC/Factory.hpp"
 #include "Core/Container/MurmurHash2.hpp"
+#include "Core/Container/Allocator.hpp"
+
+#include <algorithm>
 
 using namespace NightEngine;
 using namespace NightEngine::Container;
@@ -39,6 +42,42 @@ namespace NightEngine::Rendering::Opengl
       return container[drawPass];
     }
 
+    //! @brief One item per material draw of a MeshRenderer, kept sorted between frames
+    struct DrawItem
+    {
+      U64                           m_sortKey;
+      NightEngine::EC::HandleObject m_handle;
+      U32                           m_item;
+      U32                           m_itemCount;  //Of the renderer, to notice a reloaded model
+    };
+
+    struct SortedDrawList
+    {
+      std::vector<DrawItem> m_items;
+      bool                  m_dirty = true;
+    };
+
+    static SortedDrawList& GetSortedDrawList(DrawPass drawPass)
+    {
+      static std::map<DrawPass, SortedDrawList> lists;
+      return lists[drawPass];
+    }
+
+    static void RebuildDrawItems(const DrawContainer& container, SortedDrawList& list)
+    {
+      list.m_items.clear();
+      for (auto& mesh : container)
+      {
+        //Always an item 0, so a model loaded later is still noticed
+        U32 itemCount = static_cast<U32>(mesh.Get<MeshRenderer>()->GetDrawItemCount());
+        for (U32 i = 0; i < std::max(itemCount, 1u); ++i)
+        {
+          list.m_items.push_back(DrawItem{ 0, mesh, i, itemCount });
+        }
+      }
+      list.m_dirty = false;
+    }
+
     void RegisterMeshRenderer(MeshRenderer& meshRenderer
       , DrawPass drawPass)
     {
@@ -48,6 +87,7 @@ namespace NightEngine::Rendering::Opengl
       ASSERT_TRUE(handle.Get<MeshRenderer>() != nullptr);
 
       container.emplace_back(handle);
+      GetSortedDrawList(drawPass).m_dirty = true;
     }
 
     void UnregisterMeshRenderer(NightEngine::EC::Components::MeshRenderer& meshRenderer
@@ -65,6 +105,7 @@ namespace NightEngine::Rendering::Opengl
         if (*it == handle)
         {
           it = container.erase(it);
+          GetSortedDrawList(drawPass).m_dirty = true;
           return;
         }
         else
@@ -82,18 +123,60 @@ namespace NightEngine::Rendering::Opengl
       //Profiled, this loop is as fast as direct Slotmap lookup
       for (auto& mesh : container)
       {
-        mesh.Get<MeshRenderer>()->DrawWithoutBind(false, shader);
+        auto mr = mesh.Get<MeshRenderer>();
+        if (!mr->IsOccluded())
+        {
+          mr->DrawWithoutBind(false, shader);
+        }
       }
     }
 
     void Draw(DrawPass drawPass, ShaderUniformsFn fn)
     {
       auto& container = GetDrawContainer(drawPass);
+      auto& list = GetSortedDrawList(drawPass);
 
-      //Profiled, this loop is as fast as direct Slotmap lookup
-      for (auto& mesh : container)
+      //A model reloaded in place change its submesh count without registering again
+      for (auto& item : list.m_items)
+      {
+        if (item.m_item == 0
+          && item.m_handle.Get<MeshRenderer>()->GetDrawItemCount() != item.m_itemCount)
+        {
+          list.m_dirty = true;
+          break;
+        }
+      }
+
+      bool shouldSort = list.m_dirty;
+      if (list.m_dirty)
       {
-        mesh.Get<MeshRenderer>()->DrawWithMaterial(fn);
+        RebuildDrawItems(container, list);
+      }
+
+      //Keys only change when a material or its variant is swapped,
+      //so the list is sorted again only when the order broke
+      U64 prevKey = 0;
+      for (auto& item : list.m_items)
+      {
+        item.m_sortKey = item.m_handle.Get<MeshRenderer>()->GetSortKey(item.m_item);
+        shouldSort = shouldSort || item.m_sortKey < prevKey;
+        prevKey = item.m_sortKey;
+      }
+
+      //Sort by (program, variant, material) so the state changes only when the key does
+      if (shouldSort)
+      {
+        std::sort(list.m_items.begin(), list.m_items.end()
+          , [](const DrawItem& lhs, const DrawItem& rhs) { return lhs.m_sortKey < rhs.m_sortKey; });
+      }
+
+      for (auto& item : list.m_items)
+      {
+        auto mr = item.m_handle.Get<MeshRenderer>();
+        if (!mr->IsOccluded())
+        {
+          mr->DrawItemWithMaterial(item.m_item, fn);
+        }
       }
     }
 
@@ -102,6 +185,8 @@ namespace NightEngine::Rendering::Opengl
     {
       auto& container = GetDrawContainer(drawPass);
 
+      //Occluded ones still cast shadows, the occlusion is from the camera
+
       //Profiled, this loop is as fast as Slotmap lookup directly
       for (auto& mesh : container)
       {
@@ -121,7 +206,11 @@ namespace NightEngine::Rendering::Opengl
       //Profiled, this loop is as fast as direct Slotmap lookup
       for (auto& mesh : container)
       {
-        mesh.Get<MeshRenderer>()->DrawWithoutBindDepthPass(false, shader);
+        auto mr = mesh.Get<MeshRenderer>();
+        if (!mr->IsOccluded())
+        {
+          mr->DrawWithoutBindDepthPass(false, shader);
+        }
       }
     }
 
@@ -163,7 +252,9 @@ namespace NightEngine::Rendering::Opengl
 
     void BatchInfo::Build(void)
     {
-      //Save model matrix of each meshRenderer
+      //Save model matrix of each meshRenderer, rebuilt from scratch
+      m_data.clear();
+      m_data.reserve(m_meshrenderers.size());
       for (auto& handle : m_meshrenderers)
       {
         auto mr = handle.Get<MeshRenderer>();
@@ -179,12 +270,13 @@ namespace NightEngine::Rendering::Opengl
       }
     }
 
-    void BatchInfo::DrawInstances(void)
+    void BatchInfo::DrawInstances(const Shader& shader)
     {
       //TODO: Set Uniform for u_model to represent all the object's position
 
       for (auto& mesh : m_meshes)
       {
+        mesh.SetUniforms(shader);
         mesh.DrawInstanced(m_data.size());
       }
     }
@@ -304,7 +396,7 @@ namespace NightEngine::Rendering::Opengl
       for (auto it = map.begin()
         ; it != map.end(); ++it)
       {
-        it->second.DrawInstances();
+        it->second.DrawInstances(shader);
       }
 
       shader.SetUniform("u_instanceRendering", false);
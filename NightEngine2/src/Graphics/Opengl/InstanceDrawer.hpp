@@ -10,6 +10,7 @@
 #include <glm/mat4x4.hpp>
 
 #include "Core/Container/PrimitiveType.hpp"
+#include "Core/Container/Allocator.hpp"
 
 #include "Graphics/Opengl/VertexArrayObject.hpp"
 #include "Graphics/Opengl/Mesh.hpp"
@@ -87,7 +88,8 @@ namespace NightEngine::Rendering::Opengl
     {
       using RendererHandle = NightEngine::EC::HandleObject;
 
-      std::vector<glm::mat4> m_data;                //Model matrices to be drawn
+      NightEngine::Container::TaggedVector<glm::mat4
+        , NightEngine::Container::MemoryTag::RENDERING> m_data;  //Model matrices to be drawn
       std::vector<Mesh>      m_meshes;              //All meshes accociate with meshRenderer
 
       std::vector<RendererHandle> m_meshrenderers;  //References to Meshrenderer
@@ -99,7 +101,7 @@ namespace NightEngine::Rendering::Opengl
       void Build(void);
 
       //! @brief Draw all instances of meshes
-      void DrawInstances(void);
+      void DrawInstances(const Shader& shader);
     };
 
     //TODO: Rightnow all mesh with same polygon count is the same mesh
@@ -5,10 +5,13 @@
 */
 
 #include "Graphics/Opengl/Material.hpp"
+#include "Graphics/Opengl/ShaderVariantCache.hpp"
+#include "Graphics/Opengl/MaterialBuffer.hpp"
 
 #include "Core/Serialization/Serialization.hpp"
 #include "Core/Serialization/SerializeFunction.hpp"
 #include "Core/Serialization/ResourceManager.hpp"
+#include "Core/Serialization/HotReload.hpp"
 
 #include "Core/EC/Factory.hpp"
 
@@ -23,11 +26,35 @@ namespace NightEngine::Rendering::Opengl
     *this = rhs;
   }
 
+  Material::Material(Material&& rhs) noexcept
+    : m_name(std::move(rhs.m_name)), m_filePath(std::move(rhs.m_filePath))
+    , m_shader(rhs.m_shader), m_activeShader(rhs.m_activeShader)
+    , m_variantKey(rhs.m_variantKey), m_materialProperty(rhs.m_materialProperty)
+    , m_materialID(rhs.m_materialID), m_materialEpoch(rhs.m_materialEpoch)
+    , m_constantsDirty(rhs.m_constantsDirty)
+    , m_textureMap(std::move(rhs.m_textureMap)), m_vec4Map(std::move(rhs.m_vec4Map))
+    , m_floatMap(std::move(rhs.m_floatMap)), m_intMap(std::move(rhs.m_intMap))
+  {
+    //The slot move with the values, the Slotmap growing won't repack every material
+    rhs.m_materialID = c_INVALID_MATERIAL_ID;
+  }
+
+  Material::~Material(void)
+  {
+    //The copies get their own slot, each one give it back
+    if (HasConstantSlot())
+    {
+      MaterialBuffer::GetConstantBuffer().Free(m_materialID);
+    }
+  }
+
   Material& Material::operator=(const Material& rhs)
   {
     m_name = rhs.m_name;
     m_filePath = rhs.m_filePath;
     m_shader = rhs.m_shader;
+    m_activeShader = rhs.m_activeShader;
+    m_variantKey = rhs.m_variantKey;
 
     m_materialProperty = rhs.m_materialProperty;
 
@@ -36,6 +63,9 @@ namespace NightEngine::Rendering::Opengl
     m_floatMap = rhs.m_floatMap;
     m_intMap = rhs.m_intMap;
 
+    //Keep our own slot, only the values are copied
+    m_constantsDirty = true;
+
     return *this;
   }
 
@@ -132,11 +162,42 @@ namespace NightEngine::Rendering::Opengl
       }
     }
     m_shader.Unbind();
+
+    if (m_activeShader != nullptr && m_materialProperty != nullptr)
+    {
+      m_activeShader->Bind();
+      m_materialProperty->RefreshTextureUniforms(*m_activeShader);
+      m_activeShader->Unbind();
+    }
+  }
+
+  void Material::RefreshShaderVariant(void)
+  {
+    //Shader without keywords only has the base variant
+    ShaderVariantKey key = 0;
+    auto& keywords = m_shader.GetKeywords();
+    if (m_materialProperty != nullptr && keywords.size() > 0)
+    {
+      key = m_materialProperty->GetVariantKey(*this, keywords);
+    }
+
+    if (key == m_variantKey && (key == 0 || m_activeShader != nullptr))
+    {
+      return;
+    }
+
+    m_variantKey = key;
+    m_activeShader = key != 0 ? ShaderVariantCache::GetVariant(m_shader, key) : nullptr;
+    RefreshTextureUniforms();
   }
 
   void Material::Bind(bool useTexture)
   {
-    m_shader.Bind();
+    //Feature toggles can be changed by the editor at any time
+    RefreshShaderVariant();
+
+    Shader& shader = GetShader();
+    shader.Bind();
 
     if (useTexture)
     {
@@ -152,32 +213,75 @@ namespace NightEngine::Rendering::Opengl
         }
       }
 
+      //Packed constants, one range bind instead of a SetUniform per property
+      auto layout = m_materialProperty != nullptr ? m_materialProperty->GetConstantLayout() : nullptr;
+      if (layout != nullptr)
+      {
+        if (m_constantsDirty || !HasConstantSlot())
+        {
+          UpdateConstants(*layout);
+        }
+        MaterialBuffer::Bind(m_materialID);
+        return;
+      }
+
       for (auto& pair : m_vec4Map)
       {
-        m_shader.SetUniform(pair.first, pair.second);
+        shader.SetUniform(pair.first, pair.second);
       }
 
       for (auto& pair : m_floatMap)
       {
-        m_shader.SetUniform(pair.first, pair.second);
+        shader.SetUniform(pair.first, pair.second);
       }
 
+      //Keyword toggles are compiled into the variant, the shader has no such uniform
+      bool hasKeywords = m_materialProperty != nullptr && m_shader.GetKeywords().size() > 0;
       for (auto& pair : m_intMap)
       {
-        m_shader.SetUniform(pair.first, pair.second);
+        if (!hasKeywords || !m_materialProperty->IsKeywordToggle(pair.first))
+        {
+          shader.SetUniform(pair.first, pair.second);
+        }
       }
     }
   }
 
+  void Material::UpdateConstants(const MaterialConstantLayout& layout)
+  {
+    auto& buffer = MaterialBuffer::GetConstantBuffer();
+    if (!HasConstantSlot())
+    {
+      m_materialID = buffer.Allocate();
+      m_materialEpoch = buffer.GetEpoch();
+    }
+
+    layout.Pack(m_vec4Map, m_floatMap, m_intMap, buffer.GetData(m_materialID));
+    buffer.MarkDirty(m_materialID);
+    m_constantsDirty = false;
+  }
+
+  bool Material::HasConstantSlot(void) const
+  {
+    return m_materialID != c_INVALID_MATERIAL_ID
+      && m_materialEpoch == MaterialBuffer::GetConstantBuffer().GetEpoch();
+  }
+
   void Material::Unbind(void)
   {
-    m_shader.Unbind();
+    GetShader().Unbind();
   }
 
   void Material::Clear(void)
   {
     m_shader.Clear();
 
+    if (HasConstantSlot())
+    {
+      MaterialBuffer::GetConstantBuffer().Free(m_materialID);
+      m_materialID = c_INVALID_MATERIAL_ID;
+    }
+
     for (auto& tex : m_textureMap)
     {
       tex.second->Clear();
@@ -211,11 +315,42 @@ namespace NightEngine::Rendering::Opengl
     Serialization::SerializeToFile(material
       , fileName
       , FileSystem::DirectoryType::Materials);
+    HotReload::NotifyFileWritten(FileSystem::GetFilePath(fileName
+      , FileSystem::DirectoryType::Materials));
 
     Debug::Log << Logger::MessageType::INFO 
       << "Saved Material: " << fileName << '\n';
   }
 
+  bool Material::ReloadFromFile(void)
+  {
+    if (m_filePath.empty())
+    {
+      return false;
+    }
+
+    std::string fileName = m_filePath;
+    FileSystem::RemoveFileDirectoryPath(fileName, FileSystem::DirectoryType::Materials);
+    if (!FileSystem::IsFileExist(fileName, FileSystem::DirectoryType::Materials))
+    {
+      return false;
+    }
+
+    //Removed properties have to go, Init fill the defaults back
+    m_textureMap.clear();
+    m_vec4Map.clear();
+    m_floatMap.clear();
+    m_intMap.clear();
+
+    Serialization::Deserialize(*this, fileName, FileSystem::DirectoryType::Materials);
+    RefreshTextureUniforms();
+    MarkConstantsDirty();
+
+    Debug::Log << Logger::MessageType::INFO
+      << "Reloaded Material: " << fileName << '\n';
+    return true;
+  }
+
   void Material::PreLoadAllMaterials(void)
   {
     Debug::Log << Logger::MessageType::INFO
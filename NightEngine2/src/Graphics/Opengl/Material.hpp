@@ -43,9 +43,15 @@ namespace NightEngine::Rendering::Opengl
       //! @brief default constructor
       Material(const Material& rhs);
 
+      //! @brief Move Constructor, take over rhs's MaterialBuffer slot
+      Material(Material&& rhs) noexcept;
+
       //! @brief Assignment Operator
       Material& operator=(const Material& rhs);
 
+      //! @brief Destructor, release the MaterialBuffer slot
+      ~Material(void);
+
       //! @brief Initialize Shader
 		  void	InitShader(const std::string& vertexShader
       , const std::string& fragmentShader);
@@ -70,10 +76,18 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Apply material to the shader
       void Bind(bool useTexture = true);
 
+      //! @brief Pick the keyword variant of the shader from the material's feature bits,
+      // the variant is compiled the first time any material use it
+      void RefreshShaderVariant(void);
+
+      //! @brief Repack the constants into the MaterialBuffer on the next Bind,
+      // call it after modifying the property maps
+      inline void MarkConstantsDirty(void) { m_constantsDirty = true; }
+
       //! @brief Unbind the Shader
       void Unbind(void);
 
-      //! @brief Clear Material
+      //! @brief Clear Material, release its MaterialBuffer slot
       void Clear(void);
 
       //! @brief Load Material from File (eg. "fileName.mat")
@@ -82,13 +96,28 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Save Material from File
       static void SaveMaterial(const std::string& fileName, Material& material);
 
+      //! @brief Read the properties from m_filePath again, the shader is kept
+      bool ReloadFromFile(void);
+
       //! @brief Preload All Materials in the Path
       static void PreLoadAllMaterials(void);
 
       //////////////////////////////////////////////////////////////
 
-      //! @brief Get Shader
-      inline Shader& GetShader(void) { return m_shader; }
+      //! @brief Get the shader variant in use
+      inline Shader& GetShader(void) { return m_activeShader != nullptr ? *m_activeShader : m_shader; }
+
+      //! @brief Get the shader without keywords
+      inline Shader& GetBaseShader(void) { return m_shader; }
+
+      //! @brief Get the keyword variant key of the shader in use
+      inline ShaderVariantKey GetVariantKey(void) const { return m_variantKey; }
+
+      //! @brief Render queue sort key, materialID tell apart materials sharing a variant
+      inline Container::U64 GetSortKey(Container::U32 materialID) const
+      {
+        return ShaderKeywords::MakeRenderSortKey(m_shader.GetProgramID(), m_variantKey, materialID);
+      }
 
       //! @brief Get Name
       inline const std::string& GetName(void) const { return m_name; }
@@ -119,13 +148,29 @@ namespace NightEngine::Rendering::Opengl
       inline PROPERTY_TABLE(int)& GetIntMap(void) { return m_intMap; }
 
       const MaterialProperty* GetMaterialProperty(void) { return m_materialProperty; }
+
+      //! @brief Slot in the MaterialBuffer, c_INVALID_MATERIAL_ID until the first Bind
+      inline Container::U32 GetMaterialID(void) const { return m_materialID; }
     private:
+      //! @brief Pack the property maps into the MaterialBuffer slot
+      void UpdateConstants(const MaterialConstantLayout& layout);
+
+      //! @brief Check if m_materialID is a live slot of the current MaterialBuffer
+      bool HasConstantSlot(void) const;
+
       std::string m_name = "unnamed";
       std::string m_filePath = "";
       Shader      m_shader;
+      Shader*     m_activeShader = nullptr;   //Keyword variant, nullptr use m_shader
+      ShaderVariantKey m_variantKey = 0;
 
       const MaterialProperty* m_materialProperty = nullptr;
 
+      //The maps below are the editing/serialized data, the packed copy is what get bound
+      Container::U32 m_materialID = c_INVALID_MATERIAL_ID;
+      Container::U32 m_materialEpoch = 0;   //Slot is stale if the MaterialBuffer was reset
+      bool           m_constantsDirty = true;
+
       TEXTURE_TABLE(NightEngine::EC::Handle<Texture>) m_textureMap;
       PROPERTY_TABLE(glm::vec4) m_vec4Map;
       PROPERTY_TABLE(float)     m_floatMap;
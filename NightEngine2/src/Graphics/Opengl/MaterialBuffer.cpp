@@ -0,0 +1,99 @@
+/*!
+  @file MaterialBuffer.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MaterialBuffer
+*/
+#include "Graphics/Opengl/MaterialBuffer.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <algorithm>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  namespace MaterialBuffer
+  {
+    static MaterialConstantBuffer g_constantBuffer;
+    static GLuint g_bufferID = 0;
+    static size_t g_gpuCapacity = 0;
+
+    void Initialize(void)
+    {
+      //Every slot offset has to be a multiple of the driver's alignment
+      GLint alignment = 256;
+      glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+      U32 stride = static_cast<U32>(alignment);
+      while (stride < c_MAX_MATERIAL_CONSTANT_SIZE)
+      {
+        stride += static_cast<U32>(alignment);
+      }
+      g_constantBuffer.Init(stride);
+
+      glGenBuffers(1, &g_bufferID);
+      g_gpuCapacity = 0;
+      CHECKGL_ERROR();
+
+      Debug::Log << Logger::MessageType::INFO
+        << "MaterialBuffer: slot stride [" << stride << " bytes]\n";
+    }
+
+    void Terminate(void)
+    {
+      if (g_bufferID != 0)
+      {
+        glDeleteBuffers(1, &g_bufferID);
+        g_bufferID = 0;
+      }
+      g_gpuCapacity = 0;
+      g_constantBuffer.Clear();
+    }
+
+    MaterialConstantBuffer& GetConstantBuffer(void)
+    {
+      return g_constantBuffer;
+    }
+
+    void Flush(void)
+    {
+      if (!g_constantBuffer.IsDirty())
+      {
+        return;
+      }
+
+      glBindBuffer(GL_UNIFORM_BUFFER, g_bufferID);
+      size_t size = g_constantBuffer.GetByteSize();
+      if (size > g_gpuCapacity)
+      {
+        //Grow by doubling, the whole CPU copy is uploaded into the new storage
+        g_gpuCapacity = std::max(size, g_gpuCapacity * 2);
+        glBufferData(GL_UNIFORM_BUFFER, g_gpuCapacity, nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, size, g_constantBuffer.GetBuffer());
+      }
+      else
+      {
+        size_t begin = g_constantBuffer.GetDirtyBegin();
+        glBufferSubData(GL_UNIFORM_BUFFER, begin, g_constantBuffer.GetDirtyEnd() - begin
+          , g_constantBuffer.GetBuffer() + begin);
+      }
+      glBindBuffer(GL_UNIFORM_BUFFER, 0);
+      CHECKGL_ERROR();
+
+      g_constantBuffer.ClearDirty();
+    }
+
+    void Bind(U32 materialID)
+    {
+      Flush();
+      glBindBufferRange(GL_UNIFORM_BUFFER, c_BINDING_POINT, g_bufferID
+        , g_constantBuffer.GetOffset(materialID), g_constantBuffer.GetStride());
+    }
+  }
+} // Rendering
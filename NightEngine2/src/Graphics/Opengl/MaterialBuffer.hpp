@@ -0,0 +1,37 @@
+/*!
+  @file MaterialBuffer.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MaterialBuffer
+*/
+#pragma once
+
+#include "Graphics/Opengl/MaterialConstants.hpp"
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief One uniform buffer holding the packed constants of every material.
+  // Binding a material is a glBindBufferRange at its materialID.
+  namespace MaterialBuffer
+  {
+    //! @brief Uniform block binding point, 0 is u_matrices
+    constexpr unsigned c_BINDING_POINT = 1;
+
+    //! @brief Name of the uniform block in the shaders
+    constexpr const char* c_BLOCK_NAME = "MaterialConstants";
+
+    //! @brief Create the buffer, need a current context
+    void Initialize(void);
+
+    //! @brief Delete the buffer and all the slots
+    void Terminate(void);
+
+    //! @brief CPU side of the buffer, Material pack into it
+    MaterialConstantBuffer& GetConstantBuffer(void);
+
+    //! @brief Upload the dirty range, growing the GPU buffer if needed
+    void Flush(void);
+
+    //! @brief Bind the constants of materialID to c_BINDING_POINT
+    void Bind(Container::U32 materialID);
+  }
+} // Rendering
@@ -0,0 +1,183 @@
+/*!
+  @file MaterialConstants.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of MaterialConstants
+*/
+#include "Graphics/Opengl/MaterialConstants.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <cstring>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  static U32 AlignTo(U32 value, U32 alignment)
+  {
+    return (value + alignment - 1) & ~(alignment - 1);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  U32 MaterialConstantLayout::GetAlignment(MaterialConstantType type)
+  {
+    //std140: scalars align to 4 bytes, vec4 to 16 bytes
+    return type == MaterialConstantType::VEC4 ? 16 : 4;
+  }
+
+  U32 MaterialConstantLayout::GetTypeSize(MaterialConstantType type)
+  {
+    return type == MaterialConstantType::VEC4 ? 16 : 4;
+  }
+
+  MaterialConstantLayout& MaterialConstantLayout::AddField(const char* name
+    , MaterialConstantType type)
+  {
+    ASSERT_MSG(FindField(name) == nullptr, "MaterialConstantLayout: duplicated field " << name);
+
+    U32 offset = AlignTo(m_end, GetAlignment(type));
+    m_end = offset + GetTypeSize(type);
+    ASSERT_MSG(GetSize() <= c_MAX_MATERIAL_CONSTANT_SIZE
+      , "MaterialConstantLayout: exceed " << c_MAX_MATERIAL_CONSTANT_SIZE << " bytes");
+
+    m_fields.emplace_back(MaterialConstantField{ name, type, offset });
+    return *this;
+  }
+
+  const MaterialConstantField* MaterialConstantLayout::FindField(const std::string& name) const
+  {
+    for (auto& field : m_fields)
+    {
+      if (field.m_name == name)
+      {
+        return &field;
+      }
+    }
+    return nullptr;
+  }
+
+  U32 MaterialConstantLayout::GetSize(void) const
+  {
+    return AlignTo(m_end, 16);
+  }
+
+  void MaterialConstantLayout::Pack(const std::map<std::string, glm::vec4>& vec4Map
+    , const std::map<std::string, float>& floatMap
+    , const std::map<std::string, int>& intMap, void* output) const
+  {
+    U8* dst = static_cast<U8*>(output);
+    std::memset(dst, 0, GetSize());
+
+    for (auto& field : m_fields)
+    {
+      switch (field.m_type)
+      {
+        case MaterialConstantType::INT:
+        {
+          auto it = intMap.find(field.m_name);
+          if (it != intMap.end())
+          {
+            std::memcpy(dst + field.m_offset, &(it->second), sizeof(int));
+          }
+          break;
+        }
+        case MaterialConstantType::FLOAT:
+        {
+          auto it = floatMap.find(field.m_name);
+          if (it != floatMap.end())
+          {
+            std::memcpy(dst + field.m_offset, &(it->second), sizeof(float));
+          }
+          break;
+        }
+        case MaterialConstantType::VEC4:
+        {
+          auto it = vec4Map.find(field.m_name);
+          if (it != vec4Map.end())
+          {
+            std::memcpy(dst + field.m_offset, &(it->second), sizeof(glm::vec4));
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void MaterialConstantBuffer::Init(U32 stride)
+  {
+    Clear();
+    m_stride = stride;
+  }
+
+  U32 MaterialConstantBuffer::Allocate(void)
+  {
+    U32 materialID;
+    if (m_freeSlots.size() > 0)
+    {
+      materialID = m_freeSlots.back();
+      m_freeSlots.pop_back();
+    }
+    else
+    {
+      materialID = static_cast<U32>(m_data.size() / m_stride);
+      m_data.resize(m_data.size() + m_stride);
+    }
+
+    std::memset(GetData(materialID), 0, m_stride);
+    MarkDirty(materialID);
+    ++m_liveCount;
+    return materialID;
+  }
+
+  void MaterialConstantBuffer::Free(U32 materialID)
+  {
+    ASSERT_TRUE(GetOffset(materialID) < m_data.size());
+    ASSERT_TRUE(std::find(m_freeSlots.begin(), m_freeSlots.end(), materialID) == m_freeSlots.end());
+    m_freeSlots.emplace_back(materialID);
+    --m_liveCount;
+  }
+
+  U8* MaterialConstantBuffer::GetData(U32 materialID)
+  {
+    ASSERT_TRUE(GetOffset(materialID) < m_data.size());
+    return m_data.data() + GetOffset(materialID);
+  }
+
+  void MaterialConstantBuffer::MarkDirty(U32 materialID)
+  {
+    size_t begin = GetOffset(materialID);
+    size_t end = begin + m_stride;
+    if (!IsDirty())
+    {
+      m_dirtyBegin = begin;
+      m_dirtyEnd = end;
+    }
+    else
+    {
+      m_dirtyBegin = std::min(m_dirtyBegin, begin);
+      m_dirtyEnd = std::max(m_dirtyEnd, end);
+    }
+  }
+
+  void MaterialConstantBuffer::ClearDirty(void)
+  {
+    m_dirtyBegin = 0;
+    m_dirtyEnd = 0;
+  }
+
+  void MaterialConstantBuffer::Clear(void)
+  {
+    m_data.clear();
+    m_freeSlots.clear();
+    m_liveCount = 0;
+    ++m_epoch;
+    ClearDirty();
+  }
+} // Rendering
@@ -0,0 +1,128 @@
+/*!
+  @file MaterialConstants.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of MaterialConstants
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec4.hpp>
+
+// Standard Headers
+#include <map>
+#include <string>
+#include <vector>
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief Byte budget of one material's constants, every slot in the buffer has this size
+  constexpr Container::U32 c_MAX_MATERIAL_CONSTANT_SIZE = 256;
+
+  //! @brief Invalid slot in MaterialConstantBuffer
+  constexpr Container::U32 c_INVALID_MATERIAL_ID = ~Container::U32(0);
+
+  enum class MaterialConstantType: Container::U8
+  {
+    INT = 0,
+    FLOAT,
+    VEC4
+  };
+
+  struct MaterialConstantField
+  {
+    std::string          m_name;     //Key in the Material's property map
+    MaterialConstantType m_type;
+    Container::U32       m_offset;   //std140 offset in bytes
+  };
+
+  //! @brief std140 layout of a material's constants, built from the MaterialProperty schema.
+  // Fields are laid out in the order they are added, must match the uniform block in the shader.
+  class MaterialConstantLayout
+  {
+    public:
+      //! @brief Append a field after the previous one, aligned by the std140 rules
+      MaterialConstantLayout& AddField(const char* name, MaterialConstantType type);
+
+      //! @brief Find field by property name, nullptr if the layout doesn't have it
+      const MaterialConstantField* FindField(const std::string& name) const;
+
+      //! @brief Size of the block, rounded up to a vec4 like std140 does for structs
+      Container::U32 GetSize(void) const;
+
+      //! @brief Get all fields in layout order
+      const std::vector<MaterialConstantField>& GetFields(void) const { return m_fields; }
+
+      //! @brief Pack the property maps into output (GetSize() bytes).
+      // Missing properties are zero, properties not in the layout are ignored.
+      void Pack(const std::map<std::string, glm::vec4>& vec4Map
+        , const std::map<std::string, float>& floatMap
+        , const std::map<std::string, int>& intMap, void* output) const;
+
+      //! @brief std140 base alignment of the type
+      static Container::U32 GetAlignment(MaterialConstantType type);
+
+      //! @brief Size in bytes of the type
+      static Container::U32 GetTypeSize(MaterialConstantType type);
+    private:
+      std::vector<MaterialConstantField> m_fields;
+      Container::U32 m_end = 0;
+  };
+
+  //! @brief CPU copy of every material's packed constants, one fixed stride slot per material.
+  // The dirty byte range is what need to be uploaded to the GPU buffer.
+  class MaterialConstantBuffer
+  {
+    public:
+      //! @brief Set the slot stride, stride has to respect the GPU's offset alignment
+      void Init(Container::U32 stride);
+
+      //! @brief Get a zeroed slot, freed slots are reused first
+      Container::U32 Allocate(void);
+
+      //! @brief Release the slot
+      void Free(Container::U32 materialID);
+
+      //! @brief Slot's memory, call MarkDirty after writing it
+      Container::U8* GetData(Container::U32 materialID);
+
+      //! @brief Add the slot to the range to upload
+      void MarkDirty(Container::U32 materialID);
+
+      //! @brief Forget the dirty range after uploading it
+      void ClearDirty(void);
+
+      //! @brief Check if anything need to be uploaded
+      bool IsDirty(void) const { return m_dirtyBegin < m_dirtyEnd; }
+
+      //! @brief Dirty range in bytes, [begin, end)
+      size_t GetDirtyBegin(void) const { return m_dirtyBegin; }
+      size_t GetDirtyEnd(void) const { return m_dirtyEnd; }
+
+      //! @brief Byte offset of the slot
+      size_t GetOffset(Container::U32 materialID) const { return size_t(materialID) * m_stride; }
+
+      //! @brief Get whole buffer
+      const Container::U8* GetBuffer(void) const { return m_data.data(); }
+      size_t GetByteSize(void) const { return m_data.size(); }
+
+      Container::U32 GetStride(void) const { return m_stride; }
+
+      //! @brief Number of slots in use
+      Container::U32 GetLiveCount(void) const { return m_liveCount; }
+
+      //! @brief Changed by Clear, slots from an older epoch are invalid
+      Container::U32 GetEpoch(void) const { return m_epoch; }
+
+      //! @brief Free everything
+      void Clear(void);
+    private:
+      std::vector<Container::U8>  m_data;
+      std::vector<Container::U32> m_freeSlots;
+      Container::U32 m_stride = c_MAX_MATERIAL_CONSTANT_SIZE;
+      Container::U32 m_liveCount = 0;
+      Container::U32 m_epoch = 0;
+      size_t m_dirtyBegin = 0;
+      size_t m_dirtyEnd = 0;
+  };
+} // Rendering
@@ -8,6 +8,7 @@
 
 #include "Graphics/Opengl/Shader.hpp"
 #include "Graphics/Opengl/Material.hpp"
+#include "Graphics/Opengl/MaterialBuffer.hpp"
 
 #include "Core/Serialization/ResourceManager.hpp"
 
@@ -28,26 +29,29 @@ namespace NightEngine::Rendering::Opengl
   const char* MP_PBRMetallic::k_textureNames[6] =
   { "DiffuseMap" , "NormalMap", "RoughnessMap", "MetallicMap", "EmissiveMap", "OpacityMap" };
 
-  const char* MP_PBRMetallic::m_diffuseMap = "u_material.m_diffuseMap";
+  const char* MP_PBRMetallic::m_diffuseMap = "u_diffuseMap";
   const char* MP_PBRMetallic::u_diffuseColor = "u_diffuseColor";
 
   const char* MP_PBRMetallic::u_useNormalmap = "u_useNormalmap";
   const char* MP_PBRMetallic::m_normalMultiplier = "u_material.m_normalMultiplier";
-  const char* MP_PBRMetallic::m_normalMap = "u_material.m_normalMap";
+  const char* MP_PBRMetallic::m_normalMap = "u_normalMap";
 
-  const char* MP_PBRMetallic::m_roughnessMap = "u_material.m_roughnessMap";
+  const char* MP_PBRMetallic::m_roughnessMap = "u_roughnessMap";
   const char* MP_PBRMetallic::m_roughnessValue = "u_material.m_roughnessValue";
 
-  const char* MP_PBRMetallic::m_metallicMap = "u_material.m_metallicMap";
+  const char* MP_PBRMetallic::m_metallicMap = "u_metallicMap";
   const char* MP_PBRMetallic::m_metallicValue = "u_material.m_metallicValue";
 
-  const char* MP_PBRMetallic::m_emissiveMap = "u_material.m_emissiveMap";
+  const char* MP_PBRMetallic::m_emissiveMap = "u_emissiveMap";
   const char* MP_PBRMetallic::m_emissiveStrength = "u_material.m_emissiveStrength";
 
   const char* MP_PBRMetallic::u_useOpacityMap = "u_useOpacityMap";
-  const char* MP_PBRMetallic::m_opacityMap = "u_material.m_opacityMap";
+  const char* MP_PBRMetallic::m_opacityMap = "u_opacityMap";
   const char* MP_PBRMetallic::m_cutOffValue = "u_material.m_cutOffValue";
 
+  const char* MP_PBRMetallic::k_USE_NORMALMAP = "USE_NORMALMAP";
+  const char* MP_PBRMetallic::k_USE_OPACITYMAP = "USE_OPACITYMAP";
+
   static const std::unordered_map<std::string, IMGUIEditorData> s_PBRMetallicMap
   {
     {"u_diffuseColor", {IMGUIEditorType::COLOR4}}
@@ -76,6 +80,7 @@ namespace NightEngine::Rendering::Opengl
   void MP_PBRMetallic::Init(Material& material) const
   {
     material.SetMaterialProperty(this);
+    material.MarkConstantsDirty();
 
     auto& texMap = material.GetTextureMap();
     auto& vec4Map = material.GetVec4Map();
@@ -113,5 +118,50 @@ namespace NightEngine::Rendering::Opengl
     shader.SetUniform(MP_PBRMetallic::m_metallicMap, METALLIC_TEXUNIT_INDEX);
     shader.SetUniform(MP_PBRMetallic::m_emissiveMap, EMISSIVE_TEXUNIT_INDEX);
     shader.SetUniform(MP_PBRMetallic::m_opacityMap, OPACITYMASK_TEXUNIT_INDEX);
+
+    if (shader.IsValidUniformBlock(MaterialBuffer::c_BLOCK_NAME))
+    {
+      shader.SetUniformBlockBindingPoint(MaterialBuffer::c_BLOCK_NAME, MaterialBuffer::c_BINDING_POINT);
+    }
+  }
+
+  ShaderVariantKey MP_PBRMetallic::GetVariantKey(Material& material
+    , const std::vector<std::string>& keywords) const
+  {
+    //The int toggles stay the serialized source of the feature bits
+    auto& intMap = material.GetIntMap();
+    ShaderVariantKey key = 0;
+
+    auto it = intMap.find(MP_PBRMetallic::u_useNormalmap);
+    if (it != intMap.end() && it->second != 0)
+    {
+      key = ShaderKeywords::EnableKeyword(keywords, key, k_USE_NORMALMAP);
+    }
+
+    it = intMap.find(MP_PBRMetallic::u_useOpacityMap);
+    if (it != intMap.end() && it->second != 0)
+    {
+      key = ShaderKeywords::EnableKeyword(keywords, key, k_USE_OPACITYMAP);
+    }
+
+    return key;
+  }
+
+  bool MP_PBRMetallic::IsKeywordToggle(const std::string& name) const
+  {
+    return name == MP_PBRMetallic::u_useNormalmap || name == MP_PBRMetallic::u_useOpacityMap;
+  }
+
+  const MaterialConstantLayout* MP_PBRMetallic::GetConstantLayout(void) const
+  {
+    //Same order as MaterialConstants in gbuffer_pass.frag
+    static const MaterialConstantLayout s_layout = MaterialConstantLayout()
+      .AddField(MP_PBRMetallic::u_diffuseColor, MaterialConstantType::VEC4)
+      .AddField(MP_PBRMetallic::m_normalMultiplier, MaterialConstantType::FLOAT)
+      .AddField(MP_PBRMetallic::m_roughnessValue, MaterialConstantType::FLOAT)
+      .AddField(MP_PBRMetallic::m_metallicValue, MaterialConstantType::FLOAT)
+      .AddField(MP_PBRMetallic::m_emissiveStrength, MaterialConstantType::FLOAT)
+      .AddField(MP_PBRMetallic::m_cutOffValue, MaterialConstantType::FLOAT);
+    return &s_layout;
   }
 }
\ No newline at end of file
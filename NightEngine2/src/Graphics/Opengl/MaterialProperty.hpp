@@ -5,6 +5,11 @@
 */
 #pragma once
 #include "Core/Reflection/RemoveQualifier.hpp"
+#include "Graphics/Opengl/ShaderKeywords.hpp"
+#include "Graphics/Opengl/MaterialConstants.hpp"
+
+#include <string>
+#include <vector>
 
 #define DEFAULT_VERTEX_SHADER_PBR "ShaderPass/gbuffer_pass.vert"
 #define DEFAULT_FRAG_SHADER_PBR "ShaderPass/gbuffer_pass.frag"
@@ -22,6 +27,9 @@
 // 2) Fill default value in MaterialProperty.Init()
 // 2.5) If the property is a texture, then fill MaterialProperty.RefreshTextureUniforms() and MaterialProperty.GetName()
 // 3) Fill editor information in MaterialProperty.GetEditorData()
+// 4) If the property toggle a shader feature, map it to the keyword in MaterialProperty.GetVariantKey()
+// 5) If the property is a vec4/float/int constant, add it to MaterialProperty.GetConstantLayout()
+//    in the same order as the shader's MaterialConstants uniform block
 
 namespace NightEngine
 {
@@ -68,6 +76,16 @@ namespace NightEngine::Rendering::Opengl
     virtual const char* GetName(int index) const = 0;
 
     virtual NightEngine::IMGUI::IMGUIEditorData GetEditorData(const char* name) const = 0;
+
+    //! @brief Variant key of the material, keywords are the ones declared by its shader
+    virtual ShaderVariantKey GetVariantKey(Material& material
+      , const std::vector<std::string>& keywords) const { return 0; }
+
+    //! @brief Check if the int property only select a keyword, no uniform to set then
+    virtual bool IsKeywordToggle(const std::string& name) const { return false; }
+
+    //! @brief Layout of the packed constants, nullptr to set every property with SetUniform
+    virtual const MaterialConstantLayout* GetConstantLayout(void) const { return nullptr; }
   };
 
   struct MP_PBRMetallic: public MaterialProperty
@@ -94,6 +112,9 @@ namespace NightEngine::Rendering::Opengl
     static const char* m_opacityMap;
     static const char* m_cutOffValue;
 
+    static const char* k_USE_NORMALMAP;
+    static const char* k_USE_OPACITYMAP;
+
     void Init(Material& material) const override;
 
     void RefreshTextureUniforms(const Shader& shader) const override;
@@ -101,5 +122,12 @@ namespace NightEngine::Rendering::Opengl
     const char* GetName(int index) const override { return k_textureNames[index]; }
 
     NightEngine::IMGUI::IMGUIEditorData GetEditorData(const char* name) const override;
+
+    ShaderVariantKey GetVariantKey(Material& material
+      , const std::vector<std::string>& keywords) const override;
+
+    bool IsKeywordToggle(const std::string& name) const override;
+
+    const MaterialConstantLayout* GetConstantLayout(void) const override;
   };
 }
\ No newline at end of file
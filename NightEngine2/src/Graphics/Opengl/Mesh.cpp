@@ -6,6 +6,8 @@
 
 #include "Graphics/Opengl/Mesh.hpp"
 
+#include <glm/common.hpp>
+
 namespace NightEngine::Rendering::Opengl
 {
   Mesh::Mesh(const std::vector<Vertex>& vertices
@@ -13,6 +15,7 @@ namespace NightEngine::Rendering::Opengl
   {
     m_verticesCount = vertices.size();
     m_polygonCount = (indices.size() / sizeof(unsigned)) / 3;
+    InitOccluder(vertices.data(), vertices.size(), indices.data(), indices.size());
 
     if (buildNow)
     {
@@ -32,6 +35,7 @@ namespace NightEngine::Rendering::Opengl
   {
     m_verticesCount = vertexArraySize / sizeof(Vertex);
     m_polygonCount = (indexArraySize/ sizeof(unsigned) ) / 3;
+    InitOccluder(vertices, m_verticesCount, indices, indexArraySize / sizeof(unsigned));
 
     if (buildNow)
     {
@@ -46,6 +50,37 @@ namespace NightEngine::Rendering::Opengl
     }
   }
 
+  Mesh::Mesh(const VertexFormat& format, const VertexQuantization& quantization
+    , const std::vector<Container::U8>& encodedVertices
+    , const std::vector<unsigned>& indices, bool buildNow)
+    : m_quantization(quantization)
+  {
+    size_t stride = format.GetStride();
+    m_verticesCount = static_cast<unsigned>(encodedVertices.size() / stride);
+    m_polygonCount = static_cast<unsigned>(indices.size() / 3);
+
+    Container::Vector<glm::vec3> positions(m_verticesCount);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+      positions[i] = VertexEncoding::DecodePosition(format, quantization
+        , encodedVertices.data() + i * stride);
+    }
+    InitOccluder(std::move(positions), indices.data(), indices.size());
+
+    m_vao.FillData(format, encodedVertices.data(), encodedVertices.size()
+      , indices.data(), indices.size() * sizeof(unsigned));
+    if (buildNow)
+    {
+      m_vao.Init();
+      m_vao.Build(BufferMode::Static);
+    }
+  }
+
+  void Mesh::SetSkin(const std::vector<SkinVertex>& skin)
+  {
+    m_vao.FillSkin(skin.data(), skin.size());
+  }
+
   void Mesh::Build(void)
   {
     m_vao.Init();
@@ -65,13 +100,62 @@ namespace NightEngine::Rendering::Opengl
     m_vao.Draw();
   }
 
+  void Mesh::Draw(const Shader& shader) const
+  {
+    SetUniforms(shader);
+    m_vao.Draw();
+  }
+
   void Mesh::DrawInstanced(size_t amount) const
   {
     m_vao.DrawInstanced(amount);
   }
 
+  void Mesh::SetUniforms(const Shader& shader) const
+  {
+    VertexEncoding::SetUniforms(shader, m_vao.GetFormat(), m_quantization);
+  }
+
   void Mesh::Release(void)
   {
     m_vao.Release();
   }
+
+  void Mesh::InitOccluder(const Vertex* vertices, size_t vertexCount
+    , const unsigned* indices, size_t indexCount)
+  {
+    if (vertexCount == 0)
+    {
+      return;
+    }
+
+    Container::Vector<glm::vec3> positions;
+    positions.reserve(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+      positions.emplace_back(vertices[i].m_position);
+    }
+    InitOccluder(std::move(positions), indices, indexCount);
+  }
+
+  void Mesh::InitOccluder(Container::Vector<glm::vec3>&& positions
+    , const unsigned* indices, size_t indexCount)
+  {
+    if (positions.empty())
+    {
+      return;
+    }
+
+    m_boundsMin = m_boundsMax = positions[0];
+    for (auto& position : positions)
+    {
+      m_boundsMin = glm::min(m_boundsMin, position);
+      m_boundsMax = glm::max(m_boundsMax, position);
+    }
+
+    auto occluder = std::make_shared<Occlusion::OccluderMesh>();
+    occluder->m_positions = std::move(positions);
+    occluder->m_indices.assign(indices, indices + (indexCount - indexCount % 3));
+    m_occluderMesh = occluder;
+  }
 }
\ No newline at end of file
@@ -6,10 +6,12 @@
 
 #pragma once
 #include <vector>
+#include <memory>
 #include "Graphics/Opengl/Shader.hpp"
 #include "Graphics/Opengl/Vertex.hpp"
 #include "Graphics/Opengl/Texture.hpp"
 #include "Graphics/Opengl/VertexArrayObject.hpp"
+#include "Graphics/Occlusion/MaskedOcclusionBuffer.hpp"
 
 namespace NightEngine::Rendering::Opengl
 {
@@ -29,6 +31,18 @@ namespace NightEngine::Rendering::Opengl
         , const unsigned* indices, size_t indexArraySize
         , bool buildNow);
 
+      //! @brief Constructor for building VAO from vertices encoded by VertexEncoding
+      explicit Mesh(const VertexFormat& format, const VertexQuantization& quantization
+        , const std::vector<Container::U8>& encodedVertices
+        , const std::vector<unsigned>& indices
+        , bool buildNow);
+
+      //! @brief Set bone influences of every vertex, before Build
+      void SetSkin(const std::vector<SkinVertex>& skin);
+
+      //! @brief Check if the mesh has bone influences
+      bool IsSkinned(void) const { return m_vao.IsSkinned(); }
+
       //! @brief Build data into opengl State
       void Build(void);
 
@@ -38,17 +52,48 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Draw mesh by direct VAO drawcall
       void Draw(void) const;
 
+      //! @brief Set the vertex decoding uniforms of shader then draw
+      void Draw(const Shader& shader) const;
+
       //! @brief Draw mesh with option
       void DrawInstanced(size_t amount) const;
 
+      //! @brief Set the vertex decoding uniforms, see ShaderLibrary/mesh_vertex.glsl
+      void SetUniforms(const Shader& shader) const;
+
+      //! @brief Layout of the vertices in the buffer
+      const VertexFormat& GetFormat(void) const { return m_vao.GetFormat(); }
+
+      const VertexQuantization& GetQuantization(void) const { return m_quantization; }
+
       //! @brief Get Mesh Polygon count
       unsigned GetPolygonCount(void) const { return m_polygonCount; }
 
+      //! @brief Local space bounding box of the vertices
+      const glm::vec3& GetBoundsMin(void) const { return m_boundsMin; }
+
+      const glm::vec3& GetBoundsMax(void) const { return m_boundsMax; }
+
+      //! @brief Positions and indices kept for the occlusion buffer, shared by the copies
+      const Occlusion::OccluderMesh* GetOccluderMesh(void) const { return m_occluderMesh.get(); }
+
       //! @brief Deallocate all the VAO
       void Release(void);
     private:
+      //! @brief Keep the bounds and the occluder data of the vertices
+      void InitOccluder(const Vertex* vertices, size_t vertexCount
+        , const unsigned* indices, size_t indexCount);
+
+      void InitOccluder(Container::Vector<glm::vec3>&& positions
+        , const unsigned* indices, size_t indexCount);
+
       VertexArrayObject    m_vao;
       unsigned             m_verticesCount;
       unsigned             m_polygonCount;
+      VertexQuantization   m_quantization;
+
+      glm::vec3            m_boundsMin{ 0.0f };
+      glm::vec3            m_boundsMax{ 0.0f };
+      std::shared_ptr<const Occlusion::OccluderMesh> m_occluderMesh;
   };
 }
\ No newline at end of file
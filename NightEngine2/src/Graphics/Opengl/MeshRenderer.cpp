@@ -12,9 +12,12 @@
 #include "Graphics/Opengl/Shader.hpp"
 
 #include "Graphics/Opengl/InstanceDrawer.hpp"
+#include "Graphics/Opengl/SkinningPalette.hpp"
 
 #include "Core/Serialization/ResourceManager.hpp"
 
+#include <glm/common.hpp>
+
 using namespace NightEngine::Rendering::Opengl;
 
 namespace NightEngine
@@ -131,6 +134,9 @@ namespace NightEngine
 
       void MeshRenderer::UnregisterDrawMode(DrawMode mode)
       {
+        //The occlusion culling only reset the registered ones
+        m_occluded = false;
+
         //Unregister from Drawer
         switch (mode)
         {
@@ -179,71 +185,89 @@ namespace NightEngine
         return t->CalculateModelMatrix();
       }
 
-      void MeshRenderer::DrawWithMaterial(ShaderUniformsFn fn)
+      Handle<Material> MeshRenderer::GetItemMaterial(size_t item)
       {
         if (m_useModelLoadedMaterials)
         {
-          auto errorMat = SceneManager::GetErrorMaterial();
-          Handle<Material> currMat;
+          return item < m_materials.size() && m_materials[item].IsValid()
+            ? m_materials[item] : SceneManager::GetErrorMaterial();
+        }
 
-          for (size_t i = 0; i < m_meshes.size(); ++i)
-          {
-            currMat = i < m_materials.size() 
-              && m_materials[i].IsValid() ? m_materials[i] : errorMat;
-            currMat->Bind(true);
-            {
-              //SetUniform Modelmatrix
-              auto t = m_gameObject->GetTransform();
-              ASSERT_TRUE(t != nullptr);
-              currMat->GetShader().SetUniform("u_model", t->GetModelMatrix());
-              
-              if (fn != nullptr)
-              {
-                fn(currMat->GetShader());
-              }
-
-              m_meshes[i].Draw();
-            }
-            currMat->Unbind();
-          }
+        //If for some reason material become invalid (deleted), assign this mesh an error material
+        if (!m_material.IsValid())
+        {
+          m_material = SceneManager::GetErrorMaterial();
+          ASSERT_TRUE(m_material.IsValid());
         }
-        else
+        return m_material;
+      }
+
+      size_t MeshRenderer::GetDrawItemCount(void) const
+      {
+        //Every submesh has its own material, otherwise they all share m_material
+        return m_useModelLoadedMaterials ? m_meshes.size() : 1;
+      }
+
+      U64 MeshRenderer::GetSortKey(size_t item)
+      {
+        Handle<Material> material = GetItemMaterial(item);
+        if (!material.IsValid())
+        {
+          return ~U64(0);
+        }
+
+        //Variant is picked here so the key match what Bind will use
+        material->RefreshShaderVariant();
+        return material->GetSortKey(static_cast<U32>(material.m_handle.m_slotmapID.m_index));
+      }
+
+      void MeshRenderer::DrawWithMaterial(ShaderUniformsFn fn)
+      {
+        for (size_t i = 0; i < GetDrawItemCount(); ++i)
         {
-          //If for some reason material become invalid (deleted), assign this mesh an error material
-          if (!m_material.IsValid())
+          DrawItemWithMaterial(i, fn);
+        }
+      }
+
+      void MeshRenderer::DrawItemWithMaterial(size_t item, ShaderUniformsFn fn)
+      {
+        if (m_useModelLoadedMaterials && item >= m_meshes.size())
+        {
+          return;
+        }
+
+        Handle<Material> material = GetItemMaterial(item);
+        material->Bind(true);
+        {
+          //SetUniform Modelmatrix
+          auto t = m_gameObject->GetTransform();
+          ASSERT_TRUE(t != nullptr);
+          material->GetShader().SetUniform("u_model", t->GetModelMatrix());
+          SkinningPalette::SetUniforms(material->GetShader(), m_skinPaletteOffset);
+
+          if (fn != nullptr)
           {
-            m_material = SceneManager::GetErrorMaterial();
-            ASSERT_TRUE(m_material.IsValid());
+            fn(material->GetShader());
           }
 
-          m_material->Bind(true);
+          if (m_useModelLoadedMaterials)
           {
-            //SetUniform Modelmatrix
-            auto t = m_gameObject->GetTransform();
-            ASSERT_TRUE(t != nullptr);
-            m_material->GetShader().SetUniform("u_model", t->GetModelMatrix());
-
-            if (fn != nullptr)
-            {
-              fn(m_material->GetShader());
-            }
-
-            //Draw meshes
-            for (size_t i = 0; i < m_meshes.size(); ++i)
-            {
-              m_meshes[i].Draw();
-            }
+            m_meshes[item].Draw(material->GetShader());
+          }
+          else
+          {
+            DrawMeshes(material->GetShader());
           }
-          m_material->Unbind();
         }
+        material->Unbind();
       }
 
-      void MeshRenderer::DrawMeshes(void)
+      void MeshRenderer::DrawMeshes(const Shader& shader)
       {
         //Draw meshes
         for (size_t i = 0; i < m_meshes.size(); ++i)
         {
-          m_meshes[i].Draw();
+          m_meshes[i].Draw(shader);
         }
       }
 
@@ -253,9 +277,10 @@ namespace NightEngine
         auto t = m_gameObject->GetTransform();
         ASSERT_TRUE(t != nullptr);
         shader.SetUniform("u_model", t->GetModelMatrix());
+        SkinningPalette::SetUniforms(shader, m_skinPaletteOffset);
 
         //Draw
-        DrawMeshes();
+        DrawMeshes(shader);
       }
 
       void MeshRenderer::DrawWithoutBindDepthPass(bool useTexture, NightEngine::Rendering::Opengl::Shader& shader)
@@ -265,6 +290,7 @@ namespace NightEngine
         ASSERT_TRUE(t != nullptr);
         shader.SetUniform("u_model", t->GetModelMatrix());
         shader.SetUniform("u_prevModel", t->GetPrevModelMatrix());
+        SkinningPalette::SetUniforms(shader, m_skinPaletteOffset);
 
         //Skip Transparent Material in Depth Prepass
         //Draw meshes
@@ -277,7 +303,7 @@ namespace NightEngine
             
             if(!isTransparent)
             {
-              m_meshes[i].Draw();
+              m_meshes[i].Draw(shader);
             }
           }
         }
@@ -290,7 +316,7 @@ namespace NightEngine
           {
             for (size_t i = 0; i < m_meshes.size(); ++i)
             {
-              m_meshes[i].Draw();
+              m_meshes[i].Draw(shader);
             }
           }
         }
@@ -308,9 +334,10 @@ namespace NightEngine
           auto t = m_gameObject->GetTransform();
           ASSERT_TRUE(t != nullptr);
           shader.SetUniform("u_model", t->GetModelMatrix());
+          SkinningPalette::SetUniforms(shader, m_skinPaletteOffset);
 
           //Draw
-          DrawMeshes();
+          DrawMeshes(shader);
           break;
         }
         case DrawMode::CUSTOM:
@@ -338,9 +365,10 @@ namespace NightEngine
             //SetUniform Modelmatrix
             ASSERT_TRUE(t != nullptr);
             shader.SetUniform("u_model", t->GetModelMatrix());
+            SkinningPalette::SetUniforms(shader, m_skinPaletteOffset);
 
             //Draw
-            DrawMeshes();
+            DrawMeshes(shader);
           }
           shader.Unbind();
 
@@ -357,9 +385,10 @@ namespace NightEngine
               auto modelMatrix = t->CalculateModelMatrix(t->GetPosition()
                 , t->GetRotation(), t->GetScale() * 1.1f);
               m_material->GetShader().SetUniform("u_model", modelMatrix);
+              SkinningPalette::SetUniforms(m_material->GetShader(), m_skinPaletteOffset);
 
               //Draw
-              DrawMeshes();
+              DrawMeshes(m_material->GetShader());
             }
             m_material->Unbind();
           }
@@ -408,6 +437,68 @@ namespace NightEngine
         }
       }
 
+      void MeshRenderer::ReloadModel(void)
+      {
+        if (m_meshLoadPath.empty())
+        {
+          return;
+        }
+
+        for (size_t i = 0; i < m_meshes.size(); ++i)
+        {
+          m_meshes[i].Release();
+        }
+        m_meshes.clear();
+
+        //Materials assigned by hand are kept
+        if (m_useModelLoadedMaterials)
+        {
+          m_materials.clear();
+          m_useModelLoadedMaterials = false;
+        }
+
+        std::string path = m_meshLoadPath;
+        LoadModel(path, true, m_castShadow);
+      }
+
+      void MeshRenderer::SuspendDrawMode(void)
+      {
+        UnregisterDrawMode(m_drawMode);
+      }
+
+      void MeshRenderer::ResumeDrawMode(void)
+      {
+        DrawMode mode = m_drawMode;
+        if (mode == DrawMode::UNINITIALIZED)
+        {
+          return;
+        }
+
+        m_drawMode = DrawMode::UNINITIALIZED;
+        RegisterDrawMode(mode);
+      }
+
+      void MeshRenderer::RebuildFromSnapshot(void)
+      {
+        //The buffers of the copied meshes were released, they may belong to someone else now
+        m_meshes.clear();
+
+        //Meshes from InitMesh have no path to load from, they stay empty
+        if (!m_meshLoadPath.empty())
+        {
+          if (m_useModelLoadedMaterials)
+          {
+            m_materials.clear();
+            m_useModelLoadedMaterials = false;
+          }
+
+          std::string path = m_meshLoadPath;
+          LoadModel(path, true, m_castShadow);
+        }
+
+        ResumeDrawMode();
+      }
+
       unsigned MeshRenderer::GetPolygonCount(void) const
       {
         unsigned sum = 0;
@@ -418,6 +509,23 @@ namespace NightEngine
         return sum;
       }
 
+      bool MeshRenderer::GetLocalBounds(glm::vec3& outMin, glm::vec3& outMax) const
+      {
+        if (m_meshes.empty())
+        {
+          return false;
+        }
+
+        outMin = m_meshes[0].GetBoundsMin();
+        outMax = m_meshes[0].GetBoundsMax();
+        for (auto& mesh : m_meshes)
+        {
+          outMin = glm::min(outMin, mesh.GetBoundsMin());
+          outMax = glm::max(outMax, mesh.GetBoundsMax());
+        }
+        return true;
+      }
+
       void MeshRenderer::OnDestroy(void)
       {
         UnregisterDrawMode(m_drawMode);
@@ -437,7 +545,10 @@ namespace NightEngine
 
         m_meshLoadPath = "";
         m_castShadow = false;
+        m_occluder = false;
+        m_occluded = false;
         m_drawMode = DrawMode::UNINITIALIZED;
+        m_skinPaletteOffset = -1;
       }
 
       void MeshRenderer::LoadMaterial(std::string fileName)
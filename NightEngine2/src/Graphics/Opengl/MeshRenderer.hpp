@@ -27,7 +27,8 @@ namespace NightEngine::EC::Components
         .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_drawMode, true)
         .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_submeshCount, true)
         .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_meshLoadPath, true)
-        .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_castShadow, true);
+        .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_castShadow, true)
+        .MR_ADD_MEMBER_PROTECTED(MeshRenderer, m_occluder, true);
     }
     public:
       enum class DrawMode : unsigned
@@ -71,6 +72,12 @@ namespace NightEngine::EC::Components
       //! @brief Get DrawMode
       DrawMode GetDrawMode(void) const { return m_drawMode; }
 
+      //! @brief Amount of material draws, one per submesh with model loaded materials
+      size_t GetDrawItemCount(void) const;
+
+      //! @brief Render queue sort key of the item's material, see ShaderKeywords::MakeRenderSortKey
+      Container::U64 GetSortKey(size_t item);
+
       //! @brief Get Material
       glm::mat4 GetModelMatrix(void);
 
@@ -83,11 +90,35 @@ namespace NightEngine::EC::Components
       //! @brief Check if casting shadow
       bool IsCastingShadow(void) { return m_castShadow; }
 
+      //! @brief Check if the meshes are rasterized into the occlusion buffer
+      bool IsOccluder(void) const { return m_occluder; }
+
+      //! @brief Set if the meshes are rasterized into the occlusion buffer
+      void SetOccluder(bool occluder) { m_occluder = occluder; }
+
+      //! @brief Check if the occlusion culling hid this one for the current frame
+      bool IsOccluded(void) const { return m_occluded; }
+
+      //! @brief Set by the occlusion culling every frame
+      void SetOccluded(bool occluded) { m_occluded = occluded; }
+
+      //! @brief Local space box around every submesh, false if there is no mesh
+      bool GetLocalBounds(glm::vec3& outMin, glm::vec3& outMax) const;
+
+      //! @brief Check if the Animator deform the meshes, their bounds don't hold then
+      bool IsSkinned(void) const { return m_skinPaletteOffset >= 0; }
+
+      //! @brief Where the Animator put this character in the skinning palette, -1 when not skinned
+      void SetSkinPaletteOffset(int offset) { m_skinPaletteOffset = offset; }
+
       //! @brief Draw mesh with custom m_material
       void DrawWithMaterial(NightEngine::Rendering::Opengl::ShaderUniformsFn fn = nullptr);
 
-      //! @brief Plain draw loop
-      void DrawMeshes(void);
+      //! @brief Bind the item's material and draw what it cover, see GetDrawItemCount
+      void DrawItemWithMaterial(size_t item, NightEngine::Rendering::Opengl::ShaderUniformsFn fn = nullptr);
+
+      //! @brief Plain draw loop, with the vertex decoding uniforms of each mesh
+      void DrawMeshes(const NightEngine::Rendering::Opengl::Shader& shader);
 
       //! @brief Draw mesh without binding material
       void DrawWithoutBind(bool useTexture, NightEngine::Rendering::Opengl::Shader& shader);
@@ -102,6 +133,18 @@ namespace NightEngine::EC::Components
       void LoadModel(const std::string& path
         , bool buildNow, bool castShadow = true);
 
+      //! @brief Release the meshes and load m_meshLoadPath again
+      void ReloadModel(void);
+
+      //! @brief Unregister from the Drawers, the draw mode is kept for ResumeDrawMode
+      void SuspendDrawMode(void);
+
+      //! @brief Register the kept draw mode again
+      void ResumeDrawMode(void);
+
+      //! @brief Rebuild a copy whose meshes were released since, by loading m_meshLoadPath
+      void RebuildFromSnapshot(void);
+
       //! @brief Get all mesh polygon count
       unsigned GetPolygonCount(void) const;
 
@@ -123,6 +166,9 @@ namespace NightEngine::EC::Components
       void OnEndFrame(void);
 
     private:
+      //! @brief Material drawing the item, the error material if it is gone
+      EC::Handle<NightEngine::Rendering::Opengl::Material> GetItemMaterial(size_t item);
+
       EC::Handle<NightEngine::Rendering::Opengl::Material> m_material;
 
       std::vector <EC::Handle<NightEngine::Rendering::Opengl::Material>> m_materials;
@@ -134,6 +180,9 @@ namespace NightEngine::EC::Components
       std::string                     m_meshLoadPath;
 
       bool                            m_castShadow = true;
+      bool                            m_occluder = false;
+      bool                            m_occluded = false;
       DrawMode                        m_drawMode = DrawMode::UNINITIALIZED;
+      int                             m_skinPaletteOffset = -1;
   };
 }
\ No newline at end of file
@@ -5,138 +5,457 @@
 */
 #include "Graphics/Opengl/Model.hpp"
 #include "Graphics/Opengl/Vertex.hpp"
+#include "Graphics/Opengl/VertexFormat.hpp"
 #include "Graphics/Opengl/Texture.hpp"
 #include "Graphics/Opengl/Material.hpp"
+#include "Graphics/Animation/AnimationClip.hpp"
 
 #include "Core/Logger.hpp"
 #include "Core/EC/Factory.hpp"
 
+#include "Core/Container/MurmurHash2.hpp"
 #include "Core/Serialization/FileSystem.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+#include "assimp/IOStream.hpp"
+#include "assimp/IOSystem.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
 
 using namespace NightEngine;
 using namespace NightEngine::EC;
+using namespace NightEngine::Container;
+using namespace NightEngine::Rendering::Animation;
 
 namespace NightEngine::Rendering::Opengl
 {
-  Model::Model(const std::string& path, bool allowPrint)
+  //! @brief Assimp stream over a VFS file view, read-only
+  class VFSIOStream: public Assimp::IOStream
   {
-    if (allowPrint)
-    {
-      Debug::Log << Logger::MessageType::INFO
-        << "Loading Model: " << path << '\n';
-    }
+    public:
+      explicit VFSIOStream(FileView file) : m_file(std::move(file)) {}
 
-    LoadModel(path);
+      virtual size_t Read(void* buffer, size_t size, size_t count) override
+      {
+        if (size == 0)
+        {
+          return 0;
+        }
+
+        count = std::min(count, (m_file.GetSize() - m_cursor) / size);
+        std::memcpy(buffer, m_file.GetData() + m_cursor, count * size);
+        m_cursor += count * size;
+        return count;
+      }
+
+      virtual size_t Write(const void*, size_t, size_t) override { return 0; }
+
+      virtual aiReturn Seek(size_t offset, aiOrigin origin) override
+      {
+        size_t base = origin == aiOrigin_SET ? 0
+          : origin == aiOrigin_CUR ? m_cursor : m_file.GetSize();
+        if (base + offset > m_file.GetSize())
+        {
+          return aiReturn_FAILURE;
+        }
+        m_cursor = base + offset;
+        return aiReturn_SUCCESS;
+      }
+
+      virtual size_t Tell(void) const override { return m_cursor; }
+      virtual size_t FileSize(void) const override { return m_file.GetSize(); }
+      virtual void Flush(void) override {}
+    private:
+      FileView m_file;
+      size_t   m_cursor = 0;
+  };
+
+  //! @brief Let Assimp open the model and the files it reference (.mtl, .bin) through the VFS
+  class VFSIOSystem: public Assimp::IOSystem
+  {
+    public:
+      //! @brief Constructor, every opened path is appended to openedFiles if not null
+      explicit VFSIOSystem(std::vector<std::string>* openedFiles = nullptr)
+        : m_openedFiles(openedFiles) {}
+
+      virtual bool Exists(const char* file) const override
+      {
+        return VirtualFileSystem::Exists(file);
+      }
+
+      virtual char getOsSeparator(void) const override { return '/'; }
+
+      virtual Assimp::IOStream* Open(const char* file, const char* mode) override
+      {
+        if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr)
+        {
+          return nullptr;
+        }
+
+        FileView view = VirtualFileSystem::Read(file);
+        if (view.IsValid() && m_openedFiles != nullptr)
+        {
+          m_openedFiles->emplace_back(file);
+        }
+        return view.IsValid() ? new VFSIOStream(std::move(view)) : nullptr;
+      }
+
+      virtual void Close(Assimp::IOStream* stream) override
+      {
+        delete stream;
+      }
+    private:
+      std::vector<std::string>* m_openedFiles;
+  };
+
+
+  //*****************************************************
+  // Cooked Model
+  //*****************************************************
+  static const U32 c_COOKED_MODEL_MAGIC = 0x4C444D4E;  //"NMDL"
+
+  //! @brief Header in front of the materials, the skeleton and its clips, then the meshes
+  struct CookedModelHeader
+  {
+    U32 m_magic;
+    U32 m_meshCount;
+    U32 m_materialCount;
+    U32 m_vertexSize;
+    U32 m_boneCount;      //0 when there is no skeleton
+    U32 m_clipCount;
+  };
+
+  //! @brief Header in front of each mesh's quantization, vertices, indices and skin
+  struct CookedMeshHeader
+  {
+    I32 m_materialIndex;
+    U32 m_vertexCount;
+    U32 m_indexCount;
+    U32 m_skinned;        //One SkinVertex per vertex follow the indices
+    U32 m_vertexFormat;   //VertexFormat::Pack, the vertices are GetStride() bytes each
+  };
+
+  //! @brief Error allowed when picking the VertexFormat of each mesh
+  static const VertexFormatSettings c_VERTEX_FORMAT_SETTINGS{};
+
+  static void Append(std::vector<char>& output, const void* data, size_t size)
+  {
+    auto bytes = static_cast<const char*>(data);
+    output.insert(output.end(), bytes, bytes + size);
   }
 
-  void Model::Draw(void)
+  static void AppendString(std::vector<char>& output, const std::string& str)
   {
-    for(size_t i=0; i < m_meshes.size(); ++i)
+    U32 length = static_cast<U32>(str.size());
+    Append(output, &length, sizeof(length));
+    Append(output, str.data(), str.size());
+  }
+
+  //! @brief Bounds checked reads over the cooked bytes
+  class CookedReader
+  {
+    public:
+      CookedReader(const char* data, size_t size)
+        : m_begin(data), m_cursor(data), m_end(data + size) {}
+
+      bool Read(void* output, size_t size)
+      {
+        if (static_cast<size_t>(m_end - m_cursor) < size)
+        {
+          return false;
+        }
+        std::memcpy(output, m_cursor, size);
+        m_cursor += size;
+        return true;
+      }
+
+      bool ReadString(std::string& str)
+      {
+        U32 length = 0;
+        if (!Read(&length, sizeof(length)) || static_cast<size_t>(m_end - m_cursor) < length)
+        {
+          return false;
+        }
+        str.assign(m_cursor, length);
+        m_cursor += length;
+        return true;
+      }
+
+      //! @brief Read an object that parse its own bytes, like a Skeleton
+      template<typename T>
+      bool ReadObject(T& object)
+      {
+        size_t offset = static_cast<size_t>(m_cursor - m_begin);
+        if (!object.Read(m_begin, static_cast<size_t>(m_end - m_begin), offset))
+        {
+          return false;
+        }
+        m_cursor = m_begin + offset;
+        return true;
+      }
+    private:
+      const char* m_begin;
+      const char* m_cursor;
+      const char* m_end;
+  };
+
+  //! @brief First texture of type, relative to the model directory
+  static std::string GetTexture(aiMaterial* mat, aiTextureType type)
+  {
+    if (mat->GetTextureCount(type) == 0)
     {
-      m_meshes[i].Draw();
+      return std::string();
     }
+
+    //Assume that path in the material is relative, not absolute path
+    aiString str;
+    mat->GetTexture(type, 0, &str);
+    std::string path{ str.C_Str() };
+    std::replace(path.begin(), path.end(), '\\', '/');
+    return path;
   }
 
-  //*****************************************
-  // Private Methods
-  //*****************************************
-  void Model::LoadModel(const std::string& path)
+  //*****************************************************
+  // Cooked Skeleton
+  //*****************************************************
+  //! @brief Assimp matrices are row major
+  static glm::mat4 ToGlm(const aiMatrix4x4& matrix)
   {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path
-    , aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    return glm::mat4{ matrix.a1, matrix.b1, matrix.c1, matrix.d1
+      , matrix.a2, matrix.b2, matrix.c2, matrix.d2
+      , matrix.a3, matrix.b3, matrix.c3, matrix.d3
+      , matrix.a4, matrix.b4, matrix.c4, matrix.d4 };
+  }
 
-    //Check for Load error
-    if(scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE
-    || scene->mRootNode == nullptr)
+  static bool IsSkinnedScene(const aiScene* scene)
+  {
+    for (size_t i = 0; i < scene->mNumMeshes; ++i)
     {
-      Debug::Log << Logger::MessageType::ERROR_MSG 
-      << "Assimp: " << importer.GetErrorString() << '\n';
-      return;
+      if (scene->mMeshes[i]->mNumBones > 0)
+      {
+        return true;
+      }
     }
-
-    //Save the model directory
-    m_directory = path.substr(0, path.find_last_of('/') + 1);
-    m_name = path.substr(path.find_last_of('/') + 1, path.size() - m_directory.size());
-    ProcessAINode(scene->mRootNode, scene);
+    return scene->mNumAnimations > 0;
   }
 
-  void Model::ProcessAINode(aiNode* rootNode, const aiScene* scene)
+  //! @brief Keep the nodes that bones, animation channels and meshes refer to, with their
+  // ancestors. Nodes are added depth first so parents come before their children.
+  static bool ImportSkeleton(const aiScene* scene, Skeleton& skeleton)
   {
-    //Material indices to load (Per SubMesh)
-    std::vector<int> materialIndices;
-    materialIndices.reserve(scene->mNumMaterials);
-    std::unordered_map<int, Handle<Material>> handleMap;
+    std::unordered_set<std::string> used;
+    for (size_t i = 0; i < scene->mNumMeshes; ++i)
+    {
+      aiMesh* mesh = scene->mMeshes[i];
+      for (size_t j = 0; j < mesh->mNumBones; ++j)
+      {
+        used.emplace(mesh->mBones[j]->mName.C_Str());
+      }
+    }
+    for (size_t i = 0; i < scene->mNumAnimations; ++i)
+    {
+      aiAnimation* animation = scene->mAnimations[i];
+      for (size_t j = 0; j < animation->mNumChannels; ++j)
+      {
+        used.emplace(animation->mChannels[j]->mNodeName.C_Str());
+      }
+    }
 
-    //Vertices data
-    std::vector<Vertex> vertices; 
-    std::vector<unsigned> indices;
-    std::vector<aiNode*> stack;
+    //Meshes without bones follow their node
+    std::vector<aiNode*> stack{ scene->mRootNode };
+    std::unordered_set<const aiNode*> kept;
+    while (!stack.empty())
+    {
+      aiNode* node = stack.back();
+      stack.pop_back();
+      if (node->mNumMeshes > 0 || used.count(node->mName.C_Str()) > 0)
+      {
+        for (const aiNode* curr = node; curr != nullptr && kept.emplace(curr).second
+          ; curr = curr->mParent) {}
+      }
+      for (size_t i = 0; i < node->mNumChildren; ++i)
+      {
+        stack.emplace_back(node->mChildren[i]);
+      }
+    }
 
-    aiNode* currNode = rootNode;
-    while (currNode != nullptr)
+    //Children are pushed in reverse to keep the file order
+    std::vector<std::pair<aiNode*, int>> nodes{ { scene->mRootNode, -1 } };
+    std::vector<glm::mat4> globalBind;
+    while (!nodes.empty())
     {
-      //Get this Node's Mesh and Process it
-      for (size_t i = 0; i < currNode->mNumMeshes; ++i)
+      aiNode* node = nodes.back().first;
+      int parent = nodes.back().second;
+      nodes.pop_back();
+      if (kept.count(node) == 0)
       {
-        aiMesh* mesh = scene->mMeshes[currNode->mMeshes[i]];
-        AddMesh(mesh, vertices, indices);
+        continue;
+      }
 
-        int matIndex = mesh->mMaterialIndex >= 0
-          && mesh->mMaterialIndex < scene->mNumMaterials ? mesh->mMaterialIndex : -1;
-        materialIndices.emplace_back(matIndex);
+      aiVector3D scale, position;
+      aiQuaternion rotation;
+      node->mTransformation.Decompose(scale, rotation, position);
+      BoneTransform bindPose;
+      bindPose.m_translation = glm::vec3(position.x, position.y, position.z);
+      bindPose.m_rotation = glm::quat(rotation.w, rotation.x, rotation.y, rotation.z);
+      bindPose.m_scale = glm::vec3(scale.x, scale.y, scale.z);
+
+      glm::mat4 global = ToGlm(node->mTransformation);
+      if (parent >= 0)
+      {
+        global = globalBind[parent] * global;
       }
 
-      //Save all the children node to be processed later
-      for (size_t i = 0; i < currNode->mNumChildren; ++i)
+      int bone = skeleton.AddBone(node->mName.C_Str(), parent, bindPose, glm::inverse(global));
+      if (bone < 0)
       {
-        stack.emplace_back(currNode->mChildren[i]);
+        Debug::Log << Logger::MessageType::WARNING << "Assimp: more than "
+          << Skeleton::c_MAX_BONES << " bones, the model is imported without skinning\n";
+        return false;
       }
+      globalBind.emplace_back(global);
 
-      //Traverse next node in the stack
-      if (stack.size() > 0)
+      for (size_t i = node->mNumChildren; i > 0; --i)
       {
-        currNode = stack[stack.size() - 1];
-        stack.pop_back();
+        nodes.emplace_back(node->mChildren[i - 1], bone);
       }
-      else
+    }
+
+    //The skinned meshes know the exact bind matrices
+    for (size_t i = 0; i < scene->mNumMeshes; ++i)
+    {
+      aiMesh* mesh = scene->mMeshes[i];
+      for (size_t j = 0; j < mesh->mNumBones; ++j)
       {
-        currNode = nullptr;
+        int bone = skeleton.FindBone(mesh->mBones[j]->mName.C_Str());
+        skeleton.SetInverseBindMatrix(bone, ToGlm(mesh->mBones[j]->mOffsetMatrix));
       }
     }
+    return true;
+  }
 
-    // Load Materials
-    m_validMaterialCount = 0;
-    for (int i = 0; i < materialIndices.size(); ++i)
+  //! @brief Sample the channels of animation into one track per bone, then compress
+  static void ImportClip(const aiAnimation* animation, const Skeleton& skeleton
+    , CompressedClip& output)
+  {
+    double ticksPerSecond = animation->mTicksPerSecond > 0.0 ? animation->mTicksPerSecond : 25.0;
+
+    AnimationClip clip;
+    clip.m_name = animation->mName.C_Str();
+    clip.m_duration = static_cast<float>(animation->mDuration / ticksPerSecond);
+    clip.m_tracks.resize(skeleton.GetBoneCount());
+    for (size_t i = 0; i < animation->mNumChannels; ++i)
     {
-      if (materialIndices[i] == -1
-        || !AddMaterial(materialIndices[i], scene, handleMap))
+      const aiNodeAnim* channel = animation->mChannels[i];
+      int bone = skeleton.FindBone(channel->mNodeName.C_Str());
+      if (bone < 0)
       {
-        m_materials.emplace_back();
+        continue;
       }
-      else
+
+      AnimationTrack& track = clip.m_tracks[bone];
+      for (size_t j = 0; j < channel->mNumPositionKeys; ++j)
       {
-        ++m_validMaterialCount;
+        const aiVectorKey& key = channel->mPositionKeys[j];
+        track.m_translations.push_back({ static_cast<float>(key.mTime / ticksPerSecond)
+          , glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z) });
+      }
+      for (size_t j = 0; j < channel->mNumRotationKeys; ++j)
+      {
+        const aiQuatKey& key = channel->mRotationKeys[j];
+        track.m_rotations.push_back({ static_cast<float>(key.mTime / ticksPerSecond)
+          , glm::quat(key.mValue.w, key.mValue.x, key.mValue.y, key.mValue.z) });
+      }
+      for (size_t j = 0; j < channel->mNumScalingKeys; ++j)
+      {
+        const aiVectorKey& key = channel->mScalingKeys[j];
+        track.m_scales.push_back({ static_cast<float>(key.mTime / ticksPerSecond)
+          , glm::vec3(key.mValue.x, key.mValue.y, key.mValue.z) });
       }
     }
+
+    output.Compress(clip, skeleton);
   }
 
-  void Model::AddMesh(aiMesh* mesh
-    ,std::vector<Vertex>& vertices, std::vector<unsigned>& indices)
+  //! @brief The 4 strongest influences of every vertex, in bytes summing to 255.
+  // Vertices of a mesh without bones follow nodeBone.
+  static std::vector<SkinVertex> ImportSkin(const aiMesh* mesh, const Skeleton& skeleton
+    , int nodeBone)
   {
-    vertices.clear();
-    indices.clear();
+    std::vector<SkinVertex> skin(mesh->mNumVertices);
+    std::vector<std::pair<float, int>> influences(mesh->mNumVertices * 4, { 0.0f, 0 });
+    std::vector<unsigned> counts(mesh->mNumVertices, 0);
+    for (size_t i = 0; i < mesh->mNumBones; ++i)
+    {
+      const aiBone* bone = mesh->mBones[i];
+      int boneIndex = skeleton.FindBone(bone->mName.C_Str());
+      if (boneIndex < 0)
+      {
+        continue;
+      }
+
+      for (size_t j = 0; j < bone->mNumWeights; ++j)
+      {
+        const aiVertexWeight& weight = bone->mWeights[j];
+        auto first = influences.begin() + weight.mVertexId * 4;
+        unsigned& count = counts[weight.mVertexId];
 
-    //Process Data into Vertex
-    for(size_t i=0; i < mesh->mNumVertices; ++i)
+        //Replace the weakest once there are 4
+        auto slot = count < 4 ? first + count++ : std::min_element(first, first + 4);
+        if (slot->first < weight.mWeight)
+        {
+          *slot = { weight.mWeight, boneIndex };
+        }
+      }
+    }
+
+    for (size_t i = 0; i < skin.size(); ++i)
     {
-      Vertex vertex;
+      SkinVertex& vertex = skin[i];
+      auto first = influences.begin() + i * 4;
+      float sum = first[0].first + first[1].first + first[2].first + first[3].first;
+      if (sum <= 0.0f)
+      {
+        vertex = SkinVertex{ { static_cast<unsigned char>(std::max(nodeBone, 0)), 0, 0, 0 }
+          , { 255, 0, 0, 0 } };
+        continue;
+      }
+
+      //Rounding leftover goes to the strongest influence
+      std::sort(first, first + 4, std::greater<std::pair<float, int>>());
+      int total = 0;
+      for (int j = 0; j < 4; ++j)
+      {
+        vertex.m_bones[j] = static_cast<unsigned char>(first[j].second);
+        vertex.m_weights[j] = static_cast<unsigned char>(first[j].first / sum * 255.0f + 0.5f);
+        total += vertex.m_weights[j];
+      }
+      vertex.m_weights[0] = static_cast<unsigned char>(vertex.m_weights[0] + (255 - total));
+    }
+    return skin;
+  }
+
+  static void AppendMesh(std::vector<char>& output, aiMesh* mesh, int materialIndex
+    , const Skeleton* skeleton, int nodeBone)
+  {
+    std::vector<Vertex> vertices(mesh->mNumVertices);
+    for (size_t i = 0; i < mesh->mNumVertices; ++i)
+    {
+      Vertex& vertex = vertices[i];
 
       //Position
       vertex.m_position.x = mesh->mVertices[i].x;
       vertex.m_position.y = mesh->mVertices[i].y;
       vertex.m_position.z = mesh->mVertices[i].z;
-      
+
       //Normal
       if (mesh->mNormals != nullptr)
       {
@@ -144,16 +463,16 @@ namespace NightEngine::Rendering::Opengl
         vertex.m_normal.y = mesh->mNormals[i].y;
         vertex.m_normal.z = mesh->mNormals[i].z;
       }
-      
+
       //Texture Coordinate
-      if(mesh->mTextureCoords[0])
+      if (mesh->mTextureCoords[0])
       {
         vertex.m_texCoord.x = mesh->mTextureCoords[0][i].x;
         vertex.m_texCoord.y = mesh->mTextureCoords[0][i].y;
       }
       else
       {
-        vertex.m_texCoord = glm::vec2(0.0f,0.0f);
+        vertex.m_texCoord = glm::vec2(0.0f, 0.0f);
       }
 
       //Tangent
@@ -163,124 +482,355 @@ namespace NightEngine::Rendering::Opengl
         vertex.m_tangent.y = mesh->mTangents[i].y;
         vertex.m_tangent.z = mesh->mTangents[i].z;
       }
+    }
+
+    std::vector<unsigned> indices;
+    indices.reserve(mesh->mNumFaces * 3);
+    for (size_t i = 0; i < mesh->mNumFaces; ++i)
+    {
+      const aiFace& face = mesh->mFaces[i];
+      indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+
+    //Smallest vertex format that keep this mesh within the error
+    VertexFormat format = VertexFormat::Choose(vertices.data(), vertices.size()
+      , c_VERTEX_FORMAT_SETTINGS);
+    VertexQuantization quantization = VertexEncoding::ComputeQuantization(format
+      , vertices.data(), vertices.size());
+    std::vector<U8> encoded;
+    VertexEncoding::EncodeVertices(format, quantization, vertices.data(), vertices.size(), encoded);
+
+    CookedMeshHeader header{ materialIndex, static_cast<U32>(vertices.size())
+      , static_cast<U32>(indices.size()), skeleton != nullptr ? 1u : 0u, format.Pack() };
+    Append(output, &header, sizeof(header));
+    Append(output, &quantization, sizeof(quantization));
+    Append(output, encoded.data(), encoded.size());
+    Append(output, indices.data(), indices.size() * sizeof(unsigned));
+    if (skeleton != nullptr)
+    {
+      std::vector<SkinVertex> skin = ImportSkin(mesh, *skeleton, nodeBone);
+      Append(output, skin.data(), skin.size() * sizeof(SkinVertex));
+    }
+  }
+
+  //! @brief Import through Assimp, the files it open besides path become inputs
+  static bool CookModel(const std::string& path, const FileView&, CookOutput& output)
+  {
+    Assimp::Importer importer;
+    importer.SetIOHandler(new VFSIOSystem(&output.m_inputs));   //Owned by the importer
+    const aiScene* scene = importer.ReadFile(path
+    , aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+
+    //Check for Load error
+    if(scene == nullptr || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE
+    || scene->mRootNode == nullptr)
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG 
+      << "Assimp: " << importer.GetErrorString() << '\n';
+      return false;
+    }
+
+    std::string directory = path.substr(0, path.find_last_of('/') + 1);
+    std::vector<char>& data = output.m_data;
+    CookedModelHeader header{ c_COOKED_MODEL_MAGIC, 0, scene->mNumMaterials
+      , static_cast<U32>(sizeof(Vertex)), 0, 0 };
+    Append(data, &header, sizeof(header));
+
+    //This is specifically for loading sponza scene
+    for (size_t i = 0; i < scene->mNumMaterials; ++i)
+    {
+      aiMaterial* material = scene->mMaterials[i];
+      for (aiTextureType type : { aiTextureType_DIFFUSE, aiTextureType_NORMALS
+        , aiTextureType_SPECULAR, aiTextureType_AMBIENT, aiTextureType_OPACITY })
+      {
+        std::string texture = GetTexture(material, type);
+        if (!texture.empty())
+        {
+          output.m_references.emplace_back(directory + texture);
+        }
+        AppendString(data, texture);
+      }
+    }
+
+    //Skeleton and clips, the meshes need the bone indices
+    Skeleton skeleton;
+    bool skinned = IsSkinnedScene(scene) && ImportSkeleton(scene, skeleton);
+    if (skinned)
+    {
+      skeleton.Write(data);
+      for (size_t i = 0; i < scene->mNumAnimations; ++i)
+      {
+        CompressedClip clip;
+        ImportClip(scene->mAnimations[i], skeleton, clip);
+        clip.Write(data);
+      }
 
-      vertices.push_back(vertex);
+      header.m_boneCount = static_cast<U32>(skeleton.GetBoneCount());
+      header.m_clipCount = scene->mNumAnimations;
+      std::memcpy(data.data(), &header, sizeof(header));
     }
 
-    //Process Data into Indices
-    for(size_t i=0; i < mesh->mNumFaces; ++i)
+    //Meshes in node order, depth first
+    U32 meshCount = 0;
+    std::vector<aiNode*> stack{ scene->mRootNode };
+    while (!stack.empty())
     {
-      aiFace face = mesh->mFaces[i];
-      for(size_t j = 0; j < face.mNumIndices; ++j)
+      aiNode* currNode = stack.back();
+      stack.pop_back();
+
+      //Get this Node's Mesh and Process it
+      for (size_t i = 0; i < currNode->mNumMeshes; ++i)
       {
-        indices.emplace_back(face.mIndices[j]);
+        aiMesh* mesh = scene->mMeshes[currNode->mMeshes[i]];
+        int matIndex = mesh->mMaterialIndex >= 0
+          && mesh->mMaterialIndex < scene->mNumMaterials ? mesh->mMaterialIndex : -1;
+        AppendMesh(data, mesh, matIndex, skinned ? &skeleton : nullptr
+          , skinned ? skeleton.FindBone(currNode->mName.C_Str()) : -1);
+        ++meshCount;
+      }
+
+      //Save all the children node to be processed later
+      for (size_t i = 0; i < currNode->mNumChildren; ++i)
+      {
+        stack.emplace_back(currNode->mChildren[i]);
       }
     }
 
-    m_meshes.emplace_back(vertices, indices, false);
+    std::memcpy(data.data() + offsetof(CookedModelHeader, m_meshCount)
+      , &meshCount, sizeof(meshCount));
+    return true;
   }
 
-  bool Model::AddMaterial(int index, const aiScene* scene
-    , std::unordered_map<int, Handle<Material>>& handleMap)
+  void Model::RegisterCooker(AssetDatabase& database)
+  {
+    //Version and options of the cooker, changing them recook every model
+    auto& format = c_VERTEX_FORMAT_SETTINGS;
+    std::string settings = "Model|v3|Triangulate FlipUVs CalcTangentSpace|vertex "
+      + std::to_string(sizeof(Vertex)) + "|skin " + std::to_string(sizeof(SkinVertex))
+      + "|format " + std::to_string(format.m_quantizePositions) + std::to_string(format.m_octahedralDirections)
+      + " " + std::to_string(format.m_maxPositionError) + " " + std::to_string(format.m_maxTexCoordError);
+    database.RegisterCooker(AssetType::MODEL
+      , ConvertToHash(settings.c_str(), settings.size()), CookModel);
+  }
+
+  //*****************************************************
+  // Model
+  //*****************************************************
+  Model::Model(const std::string& path, bool allowPrint)
+  {
+    if (allowPrint)
+    {
+      Debug::Log << Logger::MessageType::INFO
+        << "Loading Model: " << path << '\n';
+    }
+
+    LoadModel(path);
+  }
+
+  void Model::Draw(void)
+  {
+    for(size_t i=0; i < m_meshes.size(); ++i)
+    {
+      m_meshes[i].Draw();
+    }
+  }
+
+  //*****************************************
+  // Private Methods
+  //*****************************************
+  void Model::LoadModel(const std::string& path)
   {
-    std::vector<std::string> diffuseTextures;
-    std::vector<std::string> normalsTextures;
+    //Cooked meshes from the asset cache, imported here if it can't be cooked
+    FileView cooked = GetAssetDatabase().LoadCooked(path);
+    CookOutput output;
+    if (!cooked.IsValid())
+    {
+      if (!CookModel(path, cooked, output))
+      {
+        return;
+      }
+      cooked = FileView(output.m_data.data(), output.m_data.size(), nullptr);
+    }
+
+    //Save the model directory
+    m_directory = path.substr(0, path.find_last_of('/') + 1);
+    m_name = path.substr(path.find_last_of('/') + 1, path.size() - m_directory.size());
+    if (!BuildFromCooked(cooked.GetData(), cooked.GetSize()))
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "Model: broken cooked data for [" << path << "]\n";
+    }
+  }
+
+  bool Model::BuildFromCooked(const char* data, size_t size)
+  {
+    CookedReader reader{ data, size };
+    CookedModelHeader header;
+    if (!reader.Read(&header, sizeof(header)) || header.m_magic != c_COOKED_MODEL_MAGIC
+      || header.m_vertexSize != sizeof(Vertex))
+    {
+      return false;
+    }
 
-    std::vector<std::string> roughnessTextures;
-    std::vector<std::string> metallicTextures;
-    std::vector<std::string> opacityTextures;
+    //Texture paths per imported material
+    std::vector<MaterialTextures> materials(header.m_materialCount);
+    for (auto& textures : materials)
+    {
+      if (!reader.ReadString(textures.m_diffuse) || !reader.ReadString(textures.m_normal)
+        || !reader.ReadString(textures.m_roughness) || !reader.ReadString(textures.m_metallic)
+        || !reader.ReadString(textures.m_opacity))
+      {
+        return false;
+      }
+    }
 
-    bool added = false;
-    if(index >= 0 && index < scene->mNumMaterials)
+    //Skeleton and clips of the skinned meshes
+    if (header.m_boneCount > 0)
     {
-      aiMaterial* material = scene->mMaterials[index];
-      
-      //This is specifically for loading sponza scene
-      bool hasTexture = GetTextures(diffuseTextures, material, aiTextureType_DIFFUSE);
-      hasTexture |= GetTextures(normalsTextures, material, aiTextureType_NORMALS);
-      
-      hasTexture |= GetTextures(roughnessTextures, material, aiTextureType_SPECULAR);
-      hasTexture |= GetTextures(metallicTextures, material, aiTextureType_AMBIENT);
-      hasTexture |= GetTextures(opacityTextures, material, aiTextureType_OPACITY);
-
-      //Create Material Handle
-      if(hasTexture)
-      {
-        //Only need to create Material for specifics index once
-        auto it = handleMap.find(index);
-        if (it != handleMap.end())
+      auto skeleton = std::make_shared<Skeleton>();
+      if (!reader.ReadObject(*skeleton) || skeleton->GetBoneCount() != header.m_boneCount)
+      {
+        return false;
+      }
+      m_skeleton = skeleton;
+
+      for (U32 i = 0; i < header.m_clipCount; ++i)
+      {
+        auto clip = std::make_shared<CompressedClip>();
+        if (!reader.ReadObject(*clip))
         {
-          m_materials.emplace_back(it->second);
+          return false;
         }
-        else
+        m_clips.emplace_back(clip);
+      }
+    }
+
+    //Material indices to load (Per SubMesh)
+    std::vector<int> materialIndices;
+    materialIndices.reserve(header.m_meshCount);
+    std::unordered_map<int, Handle<Material>> handleMap;
+
+    //Vertices data
+    std::vector<U8> vertices;
+    std::vector<unsigned> indices;
+    std::vector<SkinVertex> skin;
+    for (U32 i = 0; i < header.m_meshCount; ++i)
+    {
+      CookedMeshHeader meshHeader;
+      if (!reader.Read(&meshHeader, sizeof(meshHeader)))
+      {
+        return false;
+      }
+
+      VertexFormat format;
+      VertexQuantization quantization;
+      if (!VertexFormat::Unpack(meshHeader.m_vertexFormat, format)
+        || !reader.Read(&quantization, sizeof(quantization)))
+      {
+        return false;
+      }
+
+      vertices.resize(static_cast<size_t>(meshHeader.m_vertexCount) * format.GetStride());
+      indices.resize(meshHeader.m_indexCount);
+      if (!reader.Read(vertices.data(), vertices.size())
+        || !reader.Read(indices.data(), indices.size() * sizeof(unsigned)))
+      {
+        return false;
+      }
+
+      m_meshes.emplace_back(format, quantization, vertices, indices, false);
+      if (meshHeader.m_skinned != 0)
+      {
+        skin.resize(meshHeader.m_vertexCount);
+        if (!reader.Read(skin.data(), skin.size() * sizeof(SkinVertex)))
         {
-          //Textures
-          std::string blackTexPath = FileSystem::GetFilePath("Blank/000.png", FileSystem::DirectoryType::Textures);
-          std::string whiteTexPath = FileSystem::GetFilePath("Blank/100.png", FileSystem::DirectoryType::Textures);
-          std::string diffTexPath = diffuseTextures.size() > 0 ?
-            diffuseTextures[0] : whiteTexPath;
-
-          bool useNormal = normalsTextures.size() > 0;
-          std::string normalTexPath = useNormal ?
-            normalsTextures[0] : blackTexPath;
-
-          std::string roughnessTexPath = roughnessTextures.size() > 0 ?
-            roughnessTextures[0] : "";
-          std::string metallicTexPath = metallicTextures.size() > 0 ?
-            metallicTextures[0] : "";
-          bool useOpacityMask = opacityTextures.size() > 0;
-          std::string opacityTexPath = useOpacityMask ?
-            opacityTextures[0] : whiteTexPath;
-
-          {
-            //Init material
-            Handle<Material> handle = Factory::Create<Material>("Material");
-            
-            std::string name = "mat_" + m_name + "[" + std::to_string(index) + "]";
-            handle.Get()->SetName(name);
-
-            {
-              handle->InitShader(DEFAULT_VERTEX_SHADER_PBR
-                , DEFAULT_FRAG_SHADER_PBR);
-              handle->InitPBRTexture(diffTexPath
-                , useNormal, normalTexPath
-                , roughnessTexPath, metallicTexPath, blackTexPath
-                , useOpacityMask, opacityTexPath);
-            }
-
-            m_materials.emplace_back(handle);
-            Debug::Log << "Created Material: " << name << '\n';
-
-            // Save handle for this index
-            // so we only need to create Material for specifics index once
-            handleMap.insert({ index, handle });
-          }
+          return false;
         }
-
-        added = true;
+        m_meshes.back().SetSkin(skin);
       }
+      materialIndices.emplace_back(meshHeader.m_materialIndex < static_cast<I32>(materials.size())
+        ? meshHeader.m_materialIndex : -1);
     }
 
-    return added;
+    // Load Materials
+    m_validMaterialCount = 0;
+    for (int i = 0; i < materialIndices.size(); ++i)
+    {
+      if (materialIndices[i] == -1
+        || !AddMaterial(materialIndices[i], materials[materialIndices[i]], handleMap))
+      {
+        m_materials.emplace_back();
+      }
+      else
+      {
+        ++m_validMaterialCount;
+      }
+    }
+    return true;
   }
 
-  bool Model::GetTextures(std::vector<std::string>& textures
-    , aiMaterial* mat, aiTextureType type)
+  bool Model::AddMaterial(int index, const MaterialTextures& textures
+    , std::unordered_map<int, Handle<Material>>& handleMap)
   {
-    for(size_t i=0; i < mat->GetTextureCount(type); ++i)
+    //Create Material Handle
+    bool hasTexture = !textures.m_diffuse.empty() || !textures.m_normal.empty()
+      || !textures.m_roughness.empty() || !textures.m_metallic.empty()
+      || !textures.m_opacity.empty();
+    if (!hasTexture)
     {
-      aiString str;
-      mat->GetTexture(type, i, &str);
+      return false;
+    }
+
+    //Only need to create Material for specifics index once
+    auto it = handleMap.find(index);
+    if (it != handleMap.end())
+    {
+      m_materials.emplace_back(it->second);
+      return true;
+    }
+
+    //Textures
+    std::string blackTexPath = FileSystem::GetFilePath("Blank/000.png", FileSystem::DirectoryType::Textures);
+    std::string whiteTexPath = FileSystem::GetFilePath("Blank/100.png", FileSystem::DirectoryType::Textures);
+    std::string diffTexPath = !textures.m_diffuse.empty() ?
+      m_directory + textures.m_diffuse : whiteTexPath;
+
+    bool useNormal = !textures.m_normal.empty();
+    std::string normalTexPath = useNormal ?
+      m_directory + textures.m_normal : blackTexPath;
+
+    std::string roughnessTexPath = !textures.m_roughness.empty() ?
+      m_directory + textures.m_roughness : "";
+    std::string metallicTexPath = !textures.m_metallic.empty() ?
+      m_directory + textures.m_metallic : "";
+    bool useOpacityMask = !textures.m_opacity.empty();
+    std::string opacityTexPath = useOpacityMask ?
+      m_directory + textures.m_opacity : whiteTexPath;
+
+    {
+      //Init material
+      Handle<Material> handle = Factory::Create<Material>("Material");
+
+      std::string name = "mat_" + m_name + "[" + std::to_string(index) + "]";
+      handle.Get()->SetName(name);
+
+      {
+        handle->InitShader(DEFAULT_VERTEX_SHADER_PBR
+          , DEFAULT_FRAG_SHADER_PBR);
+        handle->InitPBRTexture(diffTexPath
+          , useNormal, normalTexPath
+          , roughnessTexPath, metallicTexPath, blackTexPath
+          , useOpacityMask, opacityTexPath);
+      }
 
-      //Assume that path in the material is relative, not absolute path
-      std::string path{m_directory};
-      path += str.C_Str();
+      m_materials.emplace_back(handle);
+      Debug::Log << "Created Material: " << name << '\n';
 
-      //Push to textures
-      std::replace(path.begin(), path.end(), '\\', '/');
-      textures.emplace_back(path);
+      // Save handle for this index
+      // so we only need to create Material for specifics index once
+      handleMap.insert({ index, handle });
     }
 
-    return textures.size() > 0;
+    return true;
   }
-}
\ No newline at end of file
+}
@@ -9,12 +9,21 @@
 #include "Core/EC/Handle.hpp"
 #include "Core/Reflection/ReflectionMacros.hpp"
 
-#include "assimp/Importer.hpp"
-#include "assimp/scene.h"
-#include "assimp/postprocess.h"
 #include <vector>
+#include <memory>
 #include <unordered_map>
 
+namespace NightEngine
+{
+  class AssetDatabase;
+}
+
+namespace NightEngine::Rendering::Animation
+{
+  class Skeleton;
+  class CompressedClip;
+}
+
 namespace NightEngine::Rendering::Opengl
 {
   class Model
@@ -38,24 +47,40 @@ namespace NightEngine::Rendering::Opengl
 
       //! @brief Check if some of the loaded materials is valid or not
       inline bool IsValidMaterials(void) { return m_validMaterialCount > 0; }
+
+      //! @brief Skeleton of the skinned meshes, null when the model isn't animated
+      inline const std::shared_ptr<const Animation::Skeleton>& GetSkeleton(void) const { return m_skeleton; }
+
+      //! @brief Animation clips imported with the model, they animate GetSkeleton
+      inline const std::vector<std::shared_ptr<const Animation::CompressedClip>>& GetClips(void) const { return m_clips; }
+
+      //! @brief Cook model files through Assimp into meshes and material texture paths
+      static void RegisterCooker(AssetDatabase& database);
+
+      //! @brief Texture paths of one imported material, relative to the model directory
+      struct MaterialTextures
+      {
+        std::string m_diffuse;
+        std::string m_normal;
+        std::string m_roughness;
+        std::string m_metallic;
+        std::string m_opacity;
+      };
     private:
       void LoadModel(const std::string& path);
 
-      void ProcessAINode(aiNode* node, const aiScene* scene);
-
-      void AddMesh(aiMesh* mesh
-        , std::vector<Vertex>& vertices, std::vector<unsigned>& indices);
+      bool BuildFromCooked(const char* data, size_t size);
 
-      bool AddMaterial(int index, const aiScene* scene
+      bool AddMaterial(int index, const MaterialTextures& textures
         , std::unordered_map<int, NightEngine::EC::Handle<NightEngine::Rendering::Opengl::Material>>& handleMap);
 
-      bool GetTextures(std::vector<std::string>& textures
-        , aiMaterial* mat, aiTextureType type);
-
       std::vector<Mesh> m_meshes;
       std::vector <NightEngine::EC::Handle<NightEngine::Rendering::Opengl::Material>> m_materials;
       unsigned              m_validMaterialCount = 0;
 
+      std::shared_ptr<const Animation::Skeleton>                 m_skeleton;
+      std::vector<std::shared_ptr<const Animation::CompressedClip>> m_clips;
+
       std::string       m_directory;
       std::string       m_name;
   };
@@ -62,19 +62,6 @@ namespace NightEngine::Rendering::Opengl
           renderSize /= 2;
         }
 
-        //FBO Target
-        {
-          m_targetTexture = Texture::GenerateRenderTexture(m_resolution.x, m_resolution.y
-            , Texture::Format::RGBA16F, Texture::PixelFormat::RGBA
-            , Texture::FilterMode::LINEAR, Texture::WrapMode::CLAMP_TO_EDGE);
-          m_targetTexture.SetName("BloomResult");
-
-          m_targetFbo.Init();
-          m_targetFbo.AttachColorTexture(m_targetTexture);
-          m_targetFbo.Bind();
-          m_targetFbo.Unbind();
-        }
-
         //Shaders
         m_thresholdShader.Create();
         m_thresholdShader.AttachShaderFile("Utility/fullscreenTriangle.vert");
@@ -113,13 +100,13 @@ namespace NightEngine::Rendering::Opengl
             m_bloomUpscaleTexture[i].Resize(renderSize.x, renderSize.y, Texture::PixelFormat::RGBA);
             renderSize /= 2;
           }
-          m_targetTexture.Resize(width, height, Texture::PixelFormat::RGBA);
         }
       }
     }
 
     void Bloom::Apply(VertexArrayObject& screenVAO
-      , Texture& screenTexture, PostProcessUtility& ppUtility)
+      , Texture& screenTexture, PostProcessUtility& ppUtility
+      , FrameBufferObject& targetFbo)
     {
       //Render 5 versions of downsample threshold color
       glDisable(GL_DEPTH_TEST);
@@ -227,7 +214,7 @@ namespace NightEngine::Rendering::Opengl
 
       //Combine all blurred texture
       glViewport(0, 0, m_resolution.x, m_resolution.y);
-      m_targetFbo.Bind();
+      targetFbo.Bind();
       {
         glClear(GL_COLOR_BUFFER_BIT);
         m_bloomShader.Bind();
@@ -253,18 +240,7 @@ namespace NightEngine::Rendering::Opengl
         }
         m_bloomShader.Unbind();
       }
-      m_targetFbo.Unbind();
-    }
-
-    void Bloom::Clear(void)
-    {
-      m_targetFbo.Bind();
-      {
-        //Clear with black color
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-      }
-      m_targetFbo.Unbind();
+      targetFbo.Unbind();
     }
 
     void Bloom::RefreshTextureUniforms(void)
@@ -42,9 +42,6 @@ namespace NightEngine::Rendering::Opengl
           .MR_ADD_MEMBER_PROTECTED(Bloom, m_blurIteration, true);
       }
       //Members
-      FrameBufferObject m_targetFbo;
-      Texture           m_targetTexture;
-
       FrameBufferObject m_bloomDownscaleFbo[k_bloomPyramidCount + 1];
       Texture           m_bloomDownscaleTexture[k_bloomPyramidCount + 1];
 
@@ -72,12 +69,10 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Initialization
       void LazyInit(int width, int height);
 
-      //! @brief Apply Bloom to the screen texture
+      //! @brief Apply Bloom of the screen texture into targetFbo, a transient target of the render graph
       void Apply(VertexArrayObject& screenVAO
-        , Texture& screenTexture, PostProcessUtility& ppUtility);
-
-      //! @brief Clear Color on fbo texture
-      void Clear(void);
+        , Texture& screenTexture, PostProcessUtility& ppUtility
+        , FrameBufferObject& targetFbo);
 
       //! @brief Refresh Texture Uniforms binding unit
       void RefreshTextureUniforms(void);
@@ -14,6 +14,7 @@
 #include "Graphics/Opengl/Postprocess/PostProcessEffect.hpp"
 #include "Graphics/Opengl/DebugMarker.hpp"
 #include "Graphics/Opengl/Material.hpp"
+#include "Graphics/Opengl/RenderTargetPool.hpp"
 
 namespace NightEngine::Rendering::Opengl
 {
@@ -62,209 +63,207 @@ namespace NightEngine::Rendering::Opengl
       }
     }
 
-    void PostProcessSetting::Apply(const PostProcessContext& context)
+    void PostProcessSetting::AddPasses(RenderGraph& graph, RenderTargetPool& targetPool
+      , const PostProcessContext& context, const PostProcessResources& resources)
     {
-      CameraObject* camera = context.camera;
-      bool additionalCompositePass = camera->m_renderScale != 1.0f;
-      glm::ivec2 screenSize = camera->GetScreenSize();
-      float screenZoomScale = context.screenZoomScale;
-
-      GBuffer* gbuffer = context.gbuffer;
-      FrameBufferObject* sceneFBO = context.sceneFBO;
-      VertexArrayObject* screenVAO = context.screenVAO;
-      Texture* screenTexture = context.screenTexture;
+      bool taaBeforeTonemapping = m_taaPP.m_enable && m_taaPP.m_beforeTonemapping;
+      bool taaAfterTonemapping = m_taaPP.m_enable && !m_taaPP.m_beforeTonemapping;
+
+      //Transient targets, only allocated if a surviving pass use them
+      glm::ivec2 ssaoRes = m_ssaoPP.GetTargetResolution();
+      auto ssaoTarget = graph.CreateTexture("SSAO"
+        , RenderTargetPool::MakeDesc(ssaoRes.x, ssaoRes.y, Texture::Format::RGB));
+      auto bloomTarget = graph.CreateTexture("BloomResult"
+        , RenderTargetPool::MakeDesc(m_resolution.x, m_resolution.y, Texture::Format::RGBA16F));
+      auto taaTarget = graph.CreateTexture("SceneTAAColor"
+        , RenderTargetPool::MakeDesc(m_resolution.x, m_resolution.y, Texture::Format::RGBA16F));
+      auto taaHistory = graph.ImportTexture("SceneHistoryColor");
 
       //SSAO
-      bool shouldCompositeSSAOToSceneRT = false;// m_taaPP.m_enable&& m_taaPP.m_beforeTonemapping;
-      if (m_ssaoPP.m_enable)
-      {
-        DebugMarker::PushDebugGroup("SSAO Pass");
+      graph.AddPass("SSAO Pass", [this, &graph, &targetPool, context, ssaoTarget]()
         {
-          m_ssaoPP.Apply(*screenVAO, *camera
-            , *gbuffer, m_ppUtility);
+          DebugMarker::PushDebugGroup("SSAO Pass");
+          {
+            m_ssaoPP.Apply(*context.screenVAO, *context.camera
+              , *context.gbuffer, m_ppUtility, targetPool.GetTexture(graph, ssaoTarget));
+          }
+          DebugMarker::PopDebugGroup();
+        })
+        .Read(resources.depth).Read(resources.gbuffer).Write(ssaoTarget);
 
-          //Turn off for now as this will overwrite the emissive
-          if (shouldCompositeSSAOToSceneRT)
+      //TAA, before or after tonemapping
+      auto addTAAPass = [&]()
+      {
+        graph.AddPass("TAA", [this, &graph, &targetPool, context, taaTarget]()
           {
-            //Combine ssao to scene texture
-            sceneFBO->Bind();
+            DebugMarker::PushDebugGroup("TAA");
             {
-              m_ssaoComposite.Bind(false);
-              {
-                Shader& shader = m_ssaoComposite.GetShader();
-                shader.SetUniform("u_screenTexture", 0);
-                shader.SetUniform("u_ssaoTexture", 1);
-
-                //PP Texture
-                {
-                  screenTexture->BindToTextureUnit(0);
-                  m_ssaoPP.m_ssaoTexture.BindToTextureUnit(1);
-                }
-
-                screenVAO->Draw();
-              }
-              m_ssaoComposite.Unbind();
+              m_taaPP.Apply(*context.screenVAO
+                , *context.gbuffer, *context.screenTexture
+                , *context.sceneFBO, *context.camera
+                , targetPool.GetFbo(graph, taaTarget));
             }
-            sceneFBO->Unbind();
-          }
-        }
-        DebugMarker::PopDebugGroup();
-      }
-      else
-      {
-        m_ssaoPP.Clear();
-      }
+            DebugMarker::PopDebugGroup();
+          })
+          .Read(resources.sceneColor).Read(resources.depth).Read(resources.motionVector)
+          .Read(taaHistory).Write(taaTarget).Write(taaHistory);
+      };
 
-      //TAA before tonemapping
-      if (m_taaPP.m_enable && m_taaPP.m_beforeTonemapping)
+      if (m_taaPP.m_beforeTonemapping)
       {
-        DebugMarker::PushDebugGroup("TAA");
-        {
-          m_taaPP.Apply(*screenVAO
-            , *gbuffer, *screenTexture
-            , *sceneFBO, *camera);
-        }
-        DebugMarker::PopDebugGroup();
+        addTAAPass();
       }
 
       //Bloom
-      if (m_bloomPP.m_enable)
-      {
-        DebugMarker::PushDebugGroup("Bloom Pass");
+      auto hdrColor = taaBeforeTonemapping ? taaTarget : resources.sceneColor;
+      graph.AddPass("Bloom Pass", [this, &graph, &targetPool, context, bloomTarget, hdrColor]()
         {
-          m_bloomPP.Apply(*screenVAO
-            , m_taaPP.m_enable && m_taaPP.m_beforeTonemapping? 
-            m_taaPP.m_currRT: *(context.screenTexture)
-            , m_ppUtility);
-        }
-        DebugMarker::PopDebugGroup();
-      }
-      else
-      {
-        m_bloomPP.Clear();
-      }
+          DebugMarker::PushDebugGroup("Bloom Pass");
+          {
+            Texture& screenTexture = graph.IsImported(hdrColor) ?
+              *context.screenTexture : targetPool.GetTexture(graph, hdrColor);
+            m_bloomPP.Apply(*context.screenVAO, screenTexture
+              , m_ppUtility, targetPool.GetFbo(graph, bloomTarget));
+          }
+          DebugMarker::PopDebugGroup();
+        })
+        .Read(hdrColor).Write(bloomTarget);
 
       //*************************************************
       // Uber pass
       //*************************************************
-      DebugMarker::PushDebugGroup("UberPostProcess");
-      {
-        glViewport(0, 0, screenSize.x, screenSize.y);
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-
-        //Draw Screen
-        auto time = context.time;
-        sceneFBO->Bind();
+      bool useSSAO = m_ssaoPP.m_enable;
+      bool useBloom = m_bloomPP.m_enable;
+      auto uberPass = graph.AddPass("UberPostProcess"
+        , [this, &graph, &targetPool, context, hdrColor, ssaoTarget, bloomTarget, useSSAO, useBloom]()
         {
-          m_uberPostMaterial.Bind(false);
+          DebugMarker::PushDebugGroup("UberPostProcess");
           {
-            Shader& shader = m_uberPostMaterial.GetShader();
-            shader.SetUniform("u_screenTexture", 0);
-            shader.SetUniform("u_bloomTexture", 1);
-            shader.SetUniform("u_ssaoTexture", 2);
-            shader.SetUniform("u_exposure", 1.0f);
-            shader.SetUniform("u_time", time);
-            shader.SetUniform("u_useSSAO", !shouldCompositeSSAOToSceneRT);
-
-            //PP Texture
+            glm::ivec2 screenSize = context.camera->GetScreenSize();
+            glViewport(0, 0, screenSize.x, screenSize.y);
+            glDisable(GL_DEPTH_TEST);
+            glDepthMask(GL_FALSE);
+
+            //Draw Screen
+            context.sceneFBO->Bind();
             {
-              if (m_taaPP.m_enable && m_taaPP.m_beforeTonemapping)
-              {
-                m_taaPP.m_currRT.BindToTextureUnit(0);
-              }
-              else
+              m_uberPostMaterial.Bind(false);
               {
-                screenTexture->BindToTextureUnit(0);
+                Shader& shader = m_uberPostMaterial.GetShader();
+                shader.SetUniform("u_screenTexture", 0);
+                shader.SetUniform("u_bloomTexture", 1);
+                shader.SetUniform("u_ssaoTexture", 2);
+                shader.SetUniform("u_exposure", 1.0f);
+                shader.SetUniform("u_time", context.time);
+                shader.SetUniform("u_useSSAO", useSSAO);
+                shader.SetUniform("u_useBloom", useBloom);
+                shader.SetUniform("u_ssaoUVScale", context.camera->GetUVScale());
+
+                //PP Texture
+                {
+                  if (graph.IsImported(hdrColor))
+                  {
+                    context.screenTexture->BindToTextureUnit(0);
+                  }
+                  else
+                  {
+                    targetPool.GetTexture(graph, hdrColor).BindToTextureUnit(0);
+                  }
+
+                  //Disabled effects were culled, their targets don't exist
+                  if (useBloom)
+                  {
+                    targetPool.GetTexture(graph, bloomTarget).BindToTextureUnit(1);
+                  }
+                  if (useSSAO)
+                  {
+                    targetPool.GetTexture(graph, ssaoTarget).BindToTextureUnit(2);
+                  }
+                }
+
+                context.screenVAO->Draw();
               }
-              m_bloomPP.m_targetTexture.BindToTextureUnit(1);
-              m_ssaoPP.m_ssaoTexture.BindToTextureUnit(2);
+              m_uberPostMaterial.Unbind();
             }
-
-            screenVAO->Draw();
+            context.sceneFBO->Unbind();
           }
-          m_uberPostMaterial.Unbind();
-        }
-        sceneFBO->Unbind();
+          DebugMarker::PopDebugGroup();
+        });
+      uberPass.Read(hdrColor).Write(resources.sceneColor);
+      if (useSSAO)
+      {
+        uberPass.Read(ssaoTarget);
+      }
+      if (useBloom)
+      {
+        uberPass.Read(bloomTarget);
       }
-      DebugMarker::PopDebugGroup();
 
-      //TAA after tonemapping
-      if (m_taaPP.m_enable && !m_taaPP.m_beforeTonemapping)
+      if (!m_taaPP.m_beforeTonemapping)
       {
-        DebugMarker::PushDebugGroup("TAA");
-        {
-          m_taaPP.Apply(*screenVAO
-            , *gbuffer, *screenTexture
-            , *sceneFBO, *camera);
-        }
-        DebugMarker::PopDebugGroup();
+        addTAAPass();
       }
 
       //*************************************************
       // Final Draw pass
       //*************************************************
-      DebugMarker::PushDebugGroup("Final Draw");
-      {
-        //Required additional composite pass from abitrary RT resolution onto screen
-        if (additionalCompositePass)
+      auto finalColor = taaAfterTonemapping ? taaTarget : resources.sceneColor;
+      graph.AddPass("Final Draw", [this, &graph, &targetPool, context, finalColor]()
         {
-          sceneFBO->Bind();
-        }
-        {
-          //FXAA
-          if (m_fxaaPP.m_enable)
+          DebugMarker::PushDebugGroup("Final Draw");
           {
-            DebugMarker::PushDebugGroup("FXAA");
+            //Required additional composite pass from abitrary RT resolution onto screen
+            CameraObject* camera = context.camera;
+            bool additionalCompositePass = camera->m_renderScale != 1.0f;
+            Texture& screenTexture = graph.IsImported(finalColor) ?
+              *context.screenTexture : targetPool.GetTexture(graph, finalColor);
+
+            if (additionalCompositePass)
             {
-              m_fxaaPP.ApplyToScreen(*screenVAO
-                , m_taaPP.m_enable && !m_taaPP.m_beforeTonemapping ?
-                m_taaPP.m_currRT : *(context.screenTexture)
-                , screenZoomScale);
+              context.sceneFBO->Bind();
             }
-            DebugMarker::PopDebugGroup();
-          }
-          else
-          {
-            m_blitCopyMaterial.Bind(false);
             {
-              m_blitCopyMaterial.GetShader().SetUniform("u_scale", screenZoomScale);
-
-              m_blitCopyMaterial.GetShader().SetUniform("u_screenTexture", 0);
-
-              //Use TAA result if its after tonemapping
-              if (m_taaPP.m_enable && !m_taaPP.m_beforeTonemapping)
+              //FXAA
+              if (m_fxaaPP.m_enable)
               {
-                m_taaPP.m_currRT.BindToTextureUnit(0);
+                DebugMarker::PushDebugGroup("FXAA");
+                {
+                  m_fxaaPP.ApplyToScreen(*context.screenVAO
+                    , screenTexture, context.screenZoomScale);
+                }
+                DebugMarker::PopDebugGroup();
               }
               else
               {
-                screenTexture->BindToTextureUnit(0);
-              }
+                m_blitCopyMaterial.Bind(false);
+                {
+                  m_blitCopyMaterial.GetShader().SetUniform("u_scale", context.screenZoomScale);
+
+                  m_blitCopyMaterial.GetShader().SetUniform("u_screenTexture", 0);
+                  screenTexture.BindToTextureUnit(0);
 
-              //Draw Quad
-              screenVAO->Draw();
+                  //Draw Quad
+                  context.screenVAO->Draw();
+                }
+                m_blitCopyMaterial.Unbind();
+              }
+            }
+            if (additionalCompositePass)
+            {
+              context.sceneFBO->Unbind();
+              context.sceneFBO->CopyBufferToTarget(camera->m_scaledPixelResolution.x, camera->m_scaledPixelResolution.y
+                , camera->m_windowPixelResolution.x, camera->m_windowPixelResolution.y
+                , 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
             }
-            m_blitCopyMaterial.Unbind();
           }
-        }
-        if (additionalCompositePass)
-        {
-          sceneFBO->Unbind();
-          sceneFBO->CopyBufferToTarget(camera->m_scaledPixelResolution.x, camera->m_scaledPixelResolution.y
-            , camera->m_windowPixelResolution.x, camera->m_windowPixelResolution.y
-            , 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
-        }
-      }
-      DebugMarker::PopDebugGroup();
+          DebugMarker::PopDebugGroup();
+        })
+        .Read(finalColor).Write(resources.backbuffer);
     }
 
     void PostProcessSetting::Clear(void)
     {
       m_ppUtility.Clear();
-
-      m_ssaoPP.Clear();
-      m_bloomPP.Clear();
     }
 
     void PostProcessSetting::RefreshTextureUniforms(void)
@@ -21,11 +21,13 @@
 #include "Graphics/Opengl/Postprocess/TAA.hpp"
 
 #include "Core/Reflection/ReflectionMacros.hpp"
+#include "Graphics/RenderGraph.hpp"
 
 namespace NightEngine::Rendering::Opengl
 {
   class VertexArrayObject;
   class FrameBufferObject;
+  class RenderTargetPool;
   struct GBuffer;
 
   namespace Postprocess
@@ -43,6 +45,16 @@ namespace NightEngine::Rendering::Opengl
       float               screenZoomScale = 1.0f;
     };
 
+    //! @brief Resources of the frame graph the effects read and write
+    struct PostProcessResources
+    {
+      RenderGraph::ResourceID sceneColor;
+      RenderGraph::ResourceID depth;
+      RenderGraph::ResourceID gbuffer;
+      RenderGraph::ResourceID motionVector;
+      RenderGraph::ResourceID backbuffer;
+    };
+
     //! @brief PostProcessSetting struct
     struct PostProcessSetting
     {
@@ -75,8 +87,10 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Initialization
       void LazyInit(CameraObject& camera, GBuffer& gbuffer);
 
-      //! @brief Apply Postfx to the screen texture
-      void Apply(const PostProcessContext& context);
+      //! @brief Add every effect's pass to the frame graph, disabled effects are culled
+      // by the graph as nothing read their output. Their targets come from targetPool.
+      void AddPasses(RenderGraph& graph, RenderTargetPool& targetPool
+        , const PostProcessContext& context, const PostProcessResources& resources);
 
       //! @brief Clear Color on fbo texture
       void Clear(void);
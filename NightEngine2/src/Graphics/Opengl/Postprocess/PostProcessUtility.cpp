@@ -69,7 +69,8 @@ namespace NightEngine::Rendering::Opengl
     }
 
     void PostProcessUtility::BlurTarget(glm::vec4 clearColor, Texture& target
-      , VertexArrayObject& screenVAO, glm::ivec2 resolution, int iteration, bool useKawase)
+      , VertexArrayObject& screenVAO, glm::ivec2 resolution, int iteration, bool useKawase
+      , glm::vec2 targetUVScale)
     {
       //Render Resolution and clear color
       glViewport(0, 0, m_resolution.x, m_resolution.y);
@@ -112,7 +113,7 @@ namespace NightEngine::Rendering::Opengl
             {
               //In first pass, fits the variable sized texture into screen resolution texture
               target.BindToTextureUnit(Texture::TextureUnit::TEXTURE_0);
-              blurShader.SetUniform("u_uvScale", glm::vec2(1.0f, 1.0f));
+              blurShader.SetUniform("u_uvScale", targetUVScale);
 
             }
             else
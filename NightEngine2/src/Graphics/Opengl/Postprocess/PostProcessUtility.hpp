@@ -39,9 +39,10 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Clear Color on fbo texture
       void Clear(void);
       
-      //! @brief Blur the target Texture
+      //! @brief Blur the target Texture, targetUVScale is the part of target to blur
       void BlurTarget(glm::vec4 clearColor,Texture& target, VertexArrayObject& screenVAO
-        , glm::ivec2 resolution, int iteration, bool useKawase = false);
+        , glm::ivec2 resolution, int iteration, bool useKawase = false
+        , glm::vec2 targetUVScale = glm::vec2(1.0f, 1.0f));
 
       //! @brief Blur the target Texture
       void BlurTarget(glm::vec4 clearColor, FrameBufferObject& targetFbo, Texture& target, VertexArrayObject& screenVAO
@@ -28,20 +28,10 @@ namespace NightEngine::Rendering::Opengl
         INIT_POSTPROCESSEFFECT();
         m_resolution = glm::ivec2(width, height);
         m_halfRes = m_resolution / 2;
-        auto& res = m_useHalfRes ? m_halfRes : m_resolution;
 
-        m_ssaoTexture = Texture::GenerateRenderTexture(
-          res.x, res.y, Texture::Format::RGB
-          , Texture::PixelFormat::RGB, Texture::FilterMode::LINEAR
-          , Texture::WrapMode::CLAMP_TO_EDGE);
-        m_ssaoTexture.SetName("SSAO RT");
-
-        //FBO
+        //FBO, the AO target is attached in Apply
         m_fbo.Init();
         m_fbo.AttachDepthTexture(gbuffer.m_depthTexture);
-        m_fbo.AttachColorTexture(m_ssaoTexture);
-        m_fbo.Bind();
-        m_fbo.Unbind();
 
         //Shader
         m_ssaoShader.Create();
@@ -105,8 +95,6 @@ namespace NightEngine::Rendering::Opengl
         {
           m_resolution.x = width, m_resolution.y = height;
           m_halfRes = m_resolution / 2;
-          auto& res = m_useHalfRes ? m_halfRes : m_resolution;
-          m_ssaoTexture.Resize(res.x, res.y, Texture::PixelFormat::RGB);
 
           m_prevUseHalfResFlag = m_useHalfRes;
         }
@@ -114,10 +102,20 @@ namespace NightEngine::Rendering::Opengl
     }
 
     void SSAO::Apply(VertexArrayObject& screenVAO
-      , CameraObject& camera, GBuffer& gbuffer, PostProcessUtility& ppUtility)
+      , CameraObject& camera, GBuffer& gbuffer, PostProcessUtility& ppUtility
+      , Texture& target)
     {
-      //glm::ivec2 screenSize = camera.GetScreenSize();
-      auto& res = m_useHalfRes ? m_halfRes : m_resolution;
+      //Target may be a different texture every frame
+      if (m_attachedTextureID != target.GetID())
+      {
+        m_fbo.AttachColorTexture(target);
+        m_attachedTextureID = target.GetID();
+      }
+
+      //Only the dynamic resolution viewport of the target is rendered
+      auto& targetRes = m_useHalfRes ? m_halfRes : m_resolution;
+      glm::vec2 uvScale = camera.GetUVScale();
+      glm::ivec2 res = glm::max(glm::ivec2(glm::vec2(targetRes) * uvScale + 0.5f), glm::ivec2(1));
       glViewport(0, 0, res.x, res.y);
 
       glDepthMask(GL_FALSE);
@@ -142,6 +140,7 @@ namespace NightEngine::Rendering::Opengl
           m_ssaoShader.SetUniform("u_view", camera.m_view);
           m_ssaoShader.SetUniform("u_projection", camera.m_projection);
           m_ssaoShader.SetUniform("u_invProjection", camera.m_invProjection);
+          m_ssaoShader.SetUniform("u_uvScale", uvScale);
 
           //m_ssaoShader.SetUniform("u_TAAJitter"
           //  , glm::vec2(camera.m_activeJitteredUV.x, camera.m_activeJitteredUV.y));
@@ -171,25 +170,14 @@ namespace NightEngine::Rendering::Opengl
       glDisable(GL_STENCIL_TEST);
 
       glm::vec4 clearColor = glm::vec4{ 1.0f,1.0f,1.0f,1.0f };
-      ppUtility.BlurTarget(clearColor, m_ssaoTexture, screenVAO
-        , res, 4, true);
+      ppUtility.BlurTarget(clearColor, target, screenVAO
+        , res, 4, true, uvScale);
 
       /*m_fbo.CopyBufferToTarget(camera.m_scaledPixelResolution.x, camera.m_scaledPixelResolution.y
         , camera.m_windowPixelResolution.x, camera.m_windowPixelResolution.y
         , 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);*/
     }
 
-    void SSAO::Clear(void)
-    {
-      m_fbo.Bind();
-      {
-        //Clear with white
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-      }
-      m_fbo.Unbind();
-    }
-
     void SSAO::RefreshTextureUniforms(void)
     {
       //Set Uniform
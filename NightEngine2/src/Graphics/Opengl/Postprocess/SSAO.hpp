@@ -42,7 +42,7 @@ namespace NightEngine::Rendering::Opengl
       }
 
       FrameBufferObject m_fbo;
-      Texture           m_ssaoTexture;
+      GLuint            m_attachedTextureID = ~(0);
       Shader            m_ssaoShader;
       Shader            m_simpleBlur;
 
@@ -69,12 +69,13 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Initialization
       void LazyInit(int width, int height , GBuffer& gbuffer);
 
-      //! @brief Apply SSAO to the screen texture
+      //! @brief Apply SSAO into target, a transient texture of the render graph
       void Apply(VertexArrayObject& screenVAO
-        ,CameraObject& camera, GBuffer& gbuffer, PostProcessUtility& ppUtility);
+        ,CameraObject& camera, GBuffer& gbuffer, PostProcessUtility& ppUtility
+        , Texture& target);
 
-      //! @brief Clear Color on fbo texture
-      void Clear(void);
+      //! @brief Resolution of the AO target
+      glm::ivec2 GetTargetResolution(void) const { return m_useHalfRes ? m_halfRes : m_resolution; }
 
       //! @brief Refresh states
       void RefreshTextureUniforms(void);
@@ -30,12 +30,6 @@ namespace NightEngine::Rendering::Opengl
         m_TAAShader.Link();
 
         //RT
-        m_currRT = Texture::GenerateRenderTexture(width, height
-          , Texture::Format::RGBA16F, Texture::PixelFormat::RGBA
-          , Texture::FilterMode::LINEAR
-          , Texture::WrapMode::CLAMP_TO_EDGE);
-        m_currRT.SetName("SceneTAAColorRT");
-
         m_historyRT = Texture::GenerateRenderTexture(width, height
           , Texture::Format::RGBA16F, Texture::PixelFormat::RGBA
           , Texture::FilterMode::LINEAR
@@ -43,11 +37,6 @@ namespace NightEngine::Rendering::Opengl
         m_historyRT.SetName("SceneHistoryColorRT");
 
         //FBO
-        m_taaFBO.Init();
-        m_taaFBO.AttachColorTexture(m_currRT);
-        m_taaFBO.Bind();
-        m_taaFBO.Unbind();
-
         m_copyHistoryFBO.Init();
         m_copyHistoryFBO.AttachColorTexture(m_historyRT);
         m_copyHistoryFBO.Bind();
@@ -62,7 +51,6 @@ namespace NightEngine::Rendering::Opengl
         if (m_resolution.x != width || m_resolution.y != height)
         {
           m_resolution.x = width, m_resolution.y = height;
-          m_currRT.Resize(width, height, Texture::PixelFormat::RGBA);
           m_historyRT.Resize(width, height, Texture::PixelFormat::RGBA);
         }
       }
@@ -70,19 +58,22 @@ namespace NightEngine::Rendering::Opengl
 
     void TAA::Apply(VertexArrayObject& screenVAO
       , GBuffer& gbuffer, Texture& screenTexture
-      , FrameBufferObject& sceneFbo, const CameraObject& cam)
+      , FrameBufferObject& sceneFbo, const CameraObject& cam
+      , FrameBufferObject& targetFbo)
     {
       glm::ivec2 screenSize = cam.GetScreenSize();
       glViewport(0, 0, screenSize.x, screenSize.y);
 
+      //Scene color only cover the dynamic resolution viewport, upscaled here
+      glm::ivec2 viewportSize = cam.GetViewportSize();
       if (m_isFirstFrame)
       {
-        sceneFbo.CopyBufferToTarget(m_resolution.x, m_resolution.y, m_resolution.x, m_resolution.y
+        sceneFbo.CopyBufferToTarget(viewportSize.x, viewportSize.y, m_resolution.x, m_resolution.y
           , m_copyHistoryFBO.GetID(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
         m_isFirstFrame = false;
       }
 
-      m_taaFBO.Bind();
+      targetFbo.Bind();
       {
         m_TAAShader.Bind();
         {
@@ -95,6 +86,7 @@ namespace NightEngine::Rendering::Opengl
             , cam.m_activeJitteredUV.x, cam.m_activeJitteredUV.y));
 
           m_TAAShader.SetUniform("u_beforeTonemapping", m_beforeTonemapping);
+          m_TAAShader.SetUniform("u_uvScale", cam.GetUVScale());
           m_TAAShader.SetUniform("u_blendTofilteredColor", m_blendToFilteredColor);
           
           //Draw Quad
@@ -102,14 +94,14 @@ namespace NightEngine::Rendering::Opengl
         }
         m_TAAShader.Unbind();
       }
-      m_taaFBO.Unbind();
+      targetFbo.Unbind();
 
       //Save history buffer
       //sceneFbo.CopyToTexture(m_historyRT
       //  , m_width, m_height);
 
       //TODO: Use MRT to output to both screenTexture and historyTexture in single pass
-      m_taaFBO.CopyBufferToTarget(m_resolution.x, m_resolution.y, m_resolution.x, m_resolution.y
+      targetFbo.CopyBufferToTarget(m_resolution.x, m_resolution.y, m_resolution.x, m_resolution.y
         , m_copyHistoryFBO.GetID(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
     }
 
@@ -38,10 +38,8 @@ namespace NightEngine::Rendering::Opengl
 
       Shader    m_TAAShader;
 
-      Texture   m_currRT;
       Texture   m_historyRT;
 
-      FrameBufferObject m_taaFBO;
       FrameBufferObject m_copyHistoryFBO;
 
       float m_sharpness = 1.0f;
@@ -55,10 +53,12 @@ namespace NightEngine::Rendering::Opengl
       //! @brief Initialization
       void LazyInit(int width, int height);
 
-      //! @brief Apply TAA to the screen texture
+      //! @brief Apply TAA of the screen texture into targetFbo, a transient target of
+      // the render graph, and copy the result to the history
       void Apply(VertexArrayObject& screenVAO
         , GBuffer& gbuffer, Texture& screenTexture
-        , FrameBufferObject& sceneFbo, const CameraObject& cam);
+        , FrameBufferObject& sceneFbo, const CameraObject& cam
+        , FrameBufferObject& targetFbo);
 
       //! @brief Apply TAA to the screen directly
       void ApplyToScreen(VertexArrayObject& screenVAO
@@ -67,6 +67,7 @@ namespace NightEngine::Rendering::Opengl
           m_cmvShader.SetUniform("u_unjitteredVP", unjitteredVP);
 
           m_cmvShader.SetUniform("u_invVP", cam.m_invVP);
+          m_cmvShader.SetUniform("u_uvScale", cam.GetUVScale());
 
           //Draw Quad
           screenVAO.Draw();
@@ -47,7 +47,7 @@ namespace NightEngine::Rendering::Opengl
     glEnable(GL_DEPTH_TEST);
     glDepthMask(GL_TRUE);
 
-    glm::ivec2 resolution = camera.GetScreenSize();
+    glm::ivec2 resolution = camera.GetViewportSize();
     glViewport(0, 0, (GLsizei)resolution.x, (GLsizei)resolution.y);
 
     glEnable(GL_STENCIL_TEST);
@@ -0,0 +1,144 @@
+/*!
+  @file ParticlePass.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ParticlePass
+*/
+
+#include "Graphics/Opengl/RenderPass/ParticlePass.hpp"
+
+#include "Core/Macros.hpp"
+
+#include "Graphics/Opengl/Shader.hpp"
+#include "Graphics/Opengl/Texture.hpp"
+#include "Graphics/Opengl/CameraObject.hpp"
+#include "Graphics/Opengl/FrameBufferObject.hpp"
+#include "Graphics/Opengl/DebugMarker.hpp"
+
+#include "Graphics/Particles/ParticleSystem.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+
+using namespace NightEngine;
+using namespace NightEngine::Rendering::Particles;
+
+namespace NightEngine::Rendering::Opengl
+{
+  void ParticlePass::Init(void)
+  {
+    //Material
+    m_particleMaterial.InitShader("ShaderPass/particle.vert"
+      , "ShaderPass/particle.frag");
+
+    //Unit quad corners, expanded along the camera axes in the vertex shader
+    const float quad[] = { -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_quadVbo);
+    glGenBuffers(1, &m_instanceVbo);
+
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    //Instances use the locations after the mesh attributes
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance), nullptr, GL_STREAM_DRAW);
+    m_instanceCapacity = 1;
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance)
+      , (void*)offsetof(ParticleInstance, m_positionSize));
+    glVertexAttribDivisor(4, 1);
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance)
+      , (void*)offsetof(ParticleInstance, m_color));
+    glVertexAttribDivisor(5, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CHECKGL_ERROR();
+  }
+
+  void ParticlePass::Release(void)
+  {
+    if (m_vao != 0)
+    {
+      glDeleteVertexArrays(1, &m_vao);
+      glDeleteBuffers(1, &m_quadVbo);
+      glDeleteBuffers(1, &m_instanceVbo);
+      m_vao = m_quadVbo = m_instanceVbo = 0;
+    }
+    m_instanceCapacity = 0;
+    m_drawnCount = 0;
+  }
+
+  void ParticlePass::Execute(CameraObject& camera, FrameBufferObject& sceneFbo)
+  {
+    m_drawnCount = 0;
+    auto& emitters = ParticleSystem::GetActiveEmitters();
+    size_t count = ParticleSystem::GetParticleCount(emitters);
+    if (count == 0 || m_vao == 0)
+    {
+      return;
+    }
+
+    DebugMarker::PushDebugGroup("Particles");
+    {
+      //Orphan the storage every frame, grow by doubling
+      glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+      m_instanceCapacity = std::max(count, count > m_instanceCapacity
+        ? m_instanceCapacity * 2 : m_instanceCapacity);
+      glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(ParticleInstance)
+        , nullptr, GL_STREAM_DRAW);
+
+      //The emitters sort and write straight into the mapped buffer
+      void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(ParticleInstance)
+        , GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+      if (mapped != nullptr)
+      {
+        m_drawnCount = ParticleSystem::WriteInstances(emitters, camera.m_position
+          , camera.m_dirForward, static_cast<ParticleInstance*>(mapped));
+      }
+      if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+      {
+        m_drawnCount = 0;
+      }
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+      if (m_drawnCount > 0)
+      {
+        glm::ivec2 resolution = camera.GetViewportSize();
+        glViewport(0, 0, (GLsizei)resolution.x, (GLsizei)resolution.y);
+
+        glEnable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        Texture::SetBlendMode(true);
+
+        sceneFbo.Bind();
+        {
+          Shader& shader = m_particleMaterial.GetShader();
+          shader.Bind();
+          {
+            shader.SetUniform("u_vp", camera.m_VP);
+            shader.SetUniform("u_cameraRight", camera.m_dirRight);
+            shader.SetUniform("u_cameraUp", camera.m_dirUp);
+
+            glBindVertexArray(m_vao);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(m_drawnCount));
+            glBindVertexArray(0);
+          }
+          shader.Unbind();
+        }
+        sceneFbo.Unbind();
+
+        Texture::SetBlendMode(false);
+        glDepthMask(GL_TRUE);
+      }
+      CHECKGL_ERROR();
+    }
+    DebugMarker::PopDebugGroup();
+  }
+}
@@ -0,0 +1,34 @@
+/*!
+  @file ParticlePass.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ParticlePass
+*/
+#pragma once
+#include "Graphics/Opengl/Material.hpp"
+
+namespace NightEngine::Rendering::Opengl
+{
+  class CameraObject;
+  class FrameBufferObject;
+
+  //! @brief Draw the particles of every emitter as instanced billboards over the scene color
+  struct ParticlePass
+  {
+    Material       m_particleMaterial;
+    unsigned       m_vao = 0;
+    unsigned       m_quadVbo = 0;
+    unsigned       m_instanceVbo = 0;
+    size_t         m_instanceCapacity = 0;
+    size_t         m_drawnCount = 0;
+
+    //! @brief Initialize ParticlePass
+    void Init(void);
+
+    //! @brief Delete the buffers
+    void Release(void);
+
+    //! @brief Stream the sorted instances and draw them into the bound sceneFbo,
+    // depth tested against the scene but not written
+    void Execute(CameraObject& camera, FrameBufferObject& sceneFbo);
+  };
+}
@@ -0,0 +1,173 @@
+/*!
+  @file RenderTargetPool.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of RenderTargetPool
+*/
+#include "Graphics/Opengl/RenderTargetPool.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// Standard Headers
+#include <string>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  static U32 GetBytesPerPixel(Texture::Format format)
+  {
+    //Drivers pad 3 channels formats to 4
+    switch (format)
+    {
+      case Texture::Format::RED:
+        return 1;
+      case Texture::Format::RG:
+        return 2;
+      case Texture::Format::RG16F:
+      case Texture::Format::RGB:
+      case Texture::Format::RGBA:
+      case Texture::Format::SRGB:
+      case Texture::Format::SRGBA:
+      case Texture::Format::SRGB8_ALPHA8:
+      case Texture::Format::DepthDefault:
+      case Texture::Format::Depth24Stencil8:
+        return 4;
+      case Texture::Format::RGB16F:
+      case Texture::Format::RGBA16F:
+      case Texture::Format::RGBA12:
+        return 8;
+      case Texture::Format::RGB32F:
+      case Texture::Format::RGBA32F:
+        return 16;
+      default:
+        return 4;
+    }
+  }
+
+  RenderGraphTextureDesc RenderTargetPool::MakeDesc(int width, int height, Texture::Format format)
+  {
+    return RenderGraphTextureDesc{ width, height
+      , static_cast<U32>(format), GetBytesPerPixel(format) };
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void RenderTargetPool::Realize(const RenderGraph& graph)
+  {
+    for (auto& target : m_targets)
+    {
+      target->m_physical = -1;
+    }
+    m_physicalTargets.assign(graph.GetPhysicalCount(), nullptr);
+
+    //Same description as last frame, nothing to do
+    for (size_t p = 0; p < m_physicalTargets.size(); ++p)
+    {
+      for (auto& target : m_targets)
+      {
+        if (target->m_physical < 0 && target->m_texture.IsValid()
+          && target->m_desc == graph.GetPhysicalDesc(p))
+        {
+          target->m_physical = static_cast<int>(p);
+          m_physicalTargets[p] = target.get();
+          break;
+        }
+      }
+    }
+
+    //Reallocate a free target or add a new one
+    for (size_t p = 0; p < m_physicalTargets.size(); ++p)
+    {
+      if (m_physicalTargets[p] != nullptr)
+      {
+        continue;
+      }
+
+      Target* free = nullptr;
+      for (auto& target : m_targets)
+      {
+        if (target->m_physical < 0)
+        {
+          free = target.get();
+          break;
+        }
+      }
+      if (free == nullptr)
+      {
+        m_targets.emplace_back(std::make_unique<Target>());
+        free = m_targets.back().get();
+      }
+
+      Allocate(*free, graph.GetPhysicalDesc(p));
+      free->m_physical = static_cast<int>(p);
+      m_physicalTargets[p] = free;
+    }
+
+    //Targets of culled passes don't keep their memory
+    for (auto& target : m_targets)
+    {
+      if (target->m_physical < 0 && target->m_texture.IsValid())
+      {
+        target->m_texture.Release();
+        target->m_texture.Clear();
+      }
+    }
+  }
+
+  void RenderTargetPool::Allocate(Target& target, const RenderGraphTextureDesc& desc)
+  {
+    if (target.m_texture.IsValid())
+    {
+      target.m_texture.Release();
+      target.m_texture.Clear();
+    }
+    if (target.m_fbo.GetID() == ~(0u))
+    {
+      target.m_fbo.Init();
+    }
+
+    target.m_desc = desc;
+    target.m_texture = Texture::GenerateRenderTexture(desc.m_width, desc.m_height
+      , static_cast<Texture::Format>(desc.m_format), Texture::PixelFormat::RGBA
+      , Texture::FilterMode::LINEAR, Texture::WrapMode::CLAMP_TO_EDGE);
+
+    std::string name = "RenderGraphTarget (" + std::to_string(desc.m_width)
+      + "x" + std::to_string(desc.m_height) + ")";
+    target.m_texture.SetName(name.c_str());
+
+    target.m_fbo.AttachColorTexture(target.m_texture);
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  RenderTargetPool::Target& RenderTargetPool::GetTarget(const RenderGraph& graph
+    , RenderGraph::ResourceID resource)
+  {
+    int physical = graph.GetPhysicalIndex(resource);
+    ASSERT_MSG(physical >= 0 && physical < (int)m_physicalTargets.size()
+      , "Render graph resource [" << graph.GetResourceName(resource) << "] has no target");
+    return *m_physicalTargets[physical];
+  }
+
+  Texture& RenderTargetPool::GetTexture(const RenderGraph& graph, RenderGraph::ResourceID resource)
+  {
+    return GetTarget(graph, resource).m_texture;
+  }
+
+  FrameBufferObject& RenderTargetPool::GetFbo(const RenderGraph& graph, RenderGraph::ResourceID resource)
+  {
+    return GetTarget(graph, resource).m_fbo;
+  }
+
+  U64 RenderTargetPool::GetAllocatedBytes(void) const
+  {
+    U64 bytes = 0;
+    for (auto& target : m_targets)
+    {
+      bytes += target->m_texture.IsValid() ? target->m_desc.GetByteSize() : 0;
+    }
+    return bytes;
+  }
+}
@@ -0,0 +1,53 @@
+/*!
+  @file RenderTargetPool.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of RenderTargetPool
+*/
+#pragma once
+#include "Graphics/RenderGraph.hpp"
+#include "Graphics/Opengl/Texture.hpp"
+#include "Graphics/Opengl/FrameBufferObject.hpp"
+
+// Standard Headers
+#include <memory>
+#include <vector>
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief Opengl targets behind the physical targets of a compiled RenderGraph.
+  // Targets are kept across frames and only reallocated when the plan change.
+  class RenderTargetPool
+  {
+    public:
+      //! @brief Description of a color texture for RenderGraph::CreateTexture
+      static RenderGraphTextureDesc MakeDesc(int width, int height, Texture::Format format);
+
+      //! @brief Create or reuse one target per physical target of the compiled graph,
+      // textures of targets the frame doesn't need are released
+      void Realize(const RenderGraph& graph);
+
+      //! @brief Texture behind a transient resource, valid after Realize
+      Texture& GetTexture(const RenderGraph& graph, RenderGraph::ResourceID resource);
+
+      //! @brief Framebuffer with the texture of resource as color attachment 0
+      FrameBufferObject& GetFbo(const RenderGraph& graph, RenderGraph::ResourceID resource);
+
+      //! @brief Memory of the allocated targets
+      Container::U64 GetAllocatedBytes(void) const;
+    private:
+      struct Target
+      {
+        RenderGraphTextureDesc m_desc;
+        Texture                m_texture;
+        FrameBufferObject      m_fbo;
+        int                    m_physical = -1;
+      };
+
+      Target& GetTarget(const RenderGraph& graph, RenderGraph::ResourceID resource);
+      void Allocate(Target& target, const RenderGraphTextureDesc& desc);
+
+      //FrameBufferObject isn't movable, targets stay at the same address
+      std::vector<std::unique_ptr<Target>> m_targets;
+      std::vector<Target*>                 m_physicalTargets;
+  };
+}
@@ -7,16 +7,18 @@
 #include "Graphics/Opengl/Shader.hpp"
 #include "Graphics/Opengl/OpenglAllocationTracker.hpp"
 #include "Graphics/Opengl/ShaderTracker.hpp"
+#include "Graphics/Opengl/ShaderCache.hpp"
+#include "Graphics/Opengl/ShaderPreprocessor.hpp"
 
 #include "Core/Macros.hpp"
 #include "Core/Logger.hpp"
 #include "Core/Serialization/FileSystem.hpp"
+#include "Core/Container/MurmurHash2.hpp"
 
 // System Headers
 #include <glm/gtc/type_ptr.hpp>
 
 // Standard Headers
-#include <fstream>
 #include <memory>
 
 using namespace NightEngine;
@@ -24,6 +26,12 @@ using namespace NightEngine;
 
 namespace NightEngine::Rendering::Opengl
 {
+  //Same order as DrawUniform
+  static const char* c_DRAW_UNIFORM_NAMES[] = { "u_vertexFormat", "u_positionOffset"
+    , "u_positionScale", "u_texCoordDecode" };
+  static_assert(sizeof(c_DRAW_UNIFORM_NAMES) / sizeof(c_DRAW_UNIFORM_NAMES[0])
+    == static_cast<size_t>(DrawUniform::COUNT), "A DrawUniform has no name");
+
   static void ReleaseShaderID(GLuint shaderID)
   {
     glDeleteProgram(shaderID);
@@ -38,7 +46,11 @@ namespace NightEngine::Rendering::Opengl
   Shader& Shader::operator=(const Shader& rhs)
   {
     m_programID = rhs.m_programID;
+    m_programKey = rhs.m_programKey;
     m_filePath = rhs.m_filePath;
+    m_keywords = rhs.m_keywords;
+    m_defines = rhs.m_defines;
+    m_drawUniformLocations = rhs.m_drawUniformLocations;
 
     return *this;
   }
@@ -126,7 +138,7 @@ namespace NightEngine::Rendering::Opengl
 		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
-  void Shader::SetUniformBlockBindingPoint(const std::string& uniformBlockName, unsigned bufferPointIndex)
+  void Shader::SetUniformBlockBindingPoint(const std::string& uniformBlockName, unsigned bufferPointIndex) const
   {
     unsigned int uniformBlockIndex = glGetUniformBlockIndex(m_programID, uniformBlockName.c_str());
     if (uniformBlockIndex == GL_INVALID_INDEX)
@@ -143,159 +155,186 @@ namespace NightEngine::Rendering::Opengl
 
   bool Shader::AttachShaderFile(const std::string& filename)
 	{
-    //TODO: Load Shader through ResourceManager and cache it
     Debug::Log << Logger::MessageType::INFO 
       << "Loading Shader: " << filename << '\n';
 
-		// Load GLSL Shader Source from File
-    std::string path = PROJECT_DIR_SOURCE_SHADER + filename;
-    m_filePath.emplace_back(path);
-		auto srcCodeStr = LoadShaderSourceCode(path);
+    return PreprocessShaderFile(PROJECT_DIR_SOURCE_SHADER + filename, true);
+	}
 
-		// Create a Shader Object
-		auto shaderID = CreateShaderObject(filename);
-    bool success = CompileShader(shaderID, srcCodeStr.c_str());
-    if (!success)
-    {
-      //Output full source code file to the error log, so its easier to trace the error lod when using #include
-      auto pos = filename.find_last_of('/');
-      auto fileNameNoSlash = pos != filename.npos ?
-        filename.substr(pos + 1, filename.size() - pos) : filename;
+  bool Shader::AttachShaderFileFromPathNoAssert(const std::string& filePath)
+  {
+    Debug::Log << Logger::MessageType::INFO
+      << "Loading Shader: " << filePath << '\n';
 
-      auto file = FileSystem::CreateFileTo("[" + fileNameNoSlash + "] shader_error.txt"
-        , FileSystem::DirectoryType::ErrorLog);
-      *file << srcCodeStr;
-      file->flush();
-      file->close();
+    return PreprocessShaderFile(filePath, false);
+  }
+
+  bool Shader::Link()
+	{
+    BeginLink();
+    return FinishLink(true);
+	}
+
+  bool Shader::LinkNoAssert()
+  {
+    BeginLink();
+    return FinishLink(false);
+  }
+
+  void Shader::BeginLink(void)
+  {
+    //Same preprocessed sources on the same driver, skip the GLSL compile
+    m_programKey = ComputeProgramKey();
+    m_loadedFromCache = ShaderCache::LoadProgram(m_programKey, m_programID);
+    if (m_loadedFromCache)
+    {
+      return;
     }
-    ASSERT_TRUE(success);
 
-		// Attach the Shader and Free Allocated Memory
-    if (success)
+    //Issue every stage before querying anything, the driver may compile them in parallel
+    for (auto& stage : m_pendingStages)
     {
-  		glAttachShader(m_programID, shaderID);
+      const char* sourceCode = stage.m_source.c_str();
+      stage.m_shaderID = glCreateShader(stage.m_type);
+      glShaderSource(stage.m_shaderID, 1, &sourceCode, nullptr);
+      glCompileShader(stage.m_shaderID);
+      glAttachShader(m_programID, stage.m_shaderID);
     }
-		glDeleteShader(shaderID);
 
+    if (ShaderCache::IsBinaryCacheSupported())
+    {
+      glProgramParameteri(m_programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(m_programID);
     CHECKGL_ERROR();
+  }
 
-    return success;
-	}
+  bool Shader::IsLinkComplete(void) const
+  {
+    return m_loadedFromCache || ShaderCache::IsProgramComplete(m_programID);
+  }
 
-  bool Shader::AttachShaderFileFromPathNoAssert(const std::string& filePath)
+  bool Shader::FinishLink(bool assertOnFail)
   {
-    //TODO: Load Shader through ResourceManager and cache it
-    Debug::Log << Logger::MessageType::INFO
-      << "Loading Shader: " << filePath << '\n';
+    bool success = true;
+    if (!m_loadedFromCache)
+    {
+      //Compile status first, the link log is useless when a stage failed
+      for (auto& stage : m_pendingStages)
+      {
+        success &= CheckCompileStatus(stage);
+      }
 
-    // Load GLSL Shader Source from File
-    m_filePath.emplace_back(filePath);
-    auto srcCodeStr = LoadShaderSourceCode(filePath);
+      //Check for Link Error
+      GLint status = GL_FALSE;
+      glGetProgramiv(m_programID, GL_LINK_STATUS, &status);
+      if (success && !status)
+      {
+        GLint length;
+        glGetProgramiv(m_programID, GL_INFO_LOG_LENGTH, &length);
+        std::unique_ptr<char[]> buffer(new char[length]);
+        glGetProgramInfoLog(m_programID, length, nullptr, buffer.get());
+
+        Debug::Log << Logger::MessageType::ERROR_MSG
+          << buffer.get();
+      }
+      success &= status == GL_TRUE;
 
-    // Create a Shader Object
-    auto shaderID = CreateShaderObject(filePath);
-    bool success = CompileShader(shaderID, srcCodeStr.c_str());
+      //The program keep the binary, shader objects are not needed anymore
+      for (auto& stage : m_pendingStages)
+      {
+        glDetachShader(m_programID, stage.m_shaderID);
+        glDeleteShader(stage.m_shaderID);
+      }
+
+      if (success)
+      {
+        ShaderCache::StoreProgram(m_programKey, m_programID);
+      }
+    }
+    m_pendingStages.clear();
+    m_loadedFromCache = false;
 
-    // Attach the Shader and Free Allocated Memory
     if (success)
     {
-      glAttachShader(m_programID, shaderID);
+      CacheDrawUniformLocations();
     }
-    glDeleteShader(shaderID);
 
+    ASSERT_TRUE(!assertOnFail || success);
     CHECKGL_ERROR();
 
     return success;
   }
 
-  bool Shader::Link() const
-	{
-		glLinkProgram(m_programID);
-
-		//Check for Link Error
-    GLint status;
-    glGetProgramiv(m_programID, GL_LINK_STATUS, &status);
-		if (!status)
-		{
-			GLint length;
-			glGetProgramiv(m_programID, GL_INFO_LOG_LENGTH, &length);
-			std::unique_ptr<char[]> buffer(new char[length]);
-			glGetProgramInfoLog(m_programID, length, nullptr, buffer.get());
-
-			Debug::Log << Logger::MessageType::ERROR_MSG 
-        << buffer.get();
-		}
-		ASSERT_TRUE(status == true);
-    CHECKGL_ERROR();
-
-    return status;
-	}
+  void Shader::RecompileShader(void)
+  {
+    Shader tempShader;
+    if (BeginRecompile(tempShader))
+    {
+      FinishRecompile(tempShader);
+    }
+  }
 
-  bool Shader::LinkNoAssert() const
+  bool Shader::BeginRecompile(Shader& tempShader)
   {
-    glLinkProgram(m_programID);
+    if (!IS_ALLOCATED(Shader, m_programID))
+    {
+      return false;
+    }
 
-    //Check for Link Error
-    GLint status;
-    glGetProgramiv(m_programID, GL_LINK_STATUS, &status);
-    if (!status)
+    // Do all of this again without Asseting, its okay to fail compiling
+    bool success = true;
+    tempShader.m_defines = m_defines;
+    for (auto& path : m_filePath)
     {
-      GLint length;
-      glGetProgramiv(m_programID, GL_INFO_LOG_LENGTH, &length);
-      std::unique_ptr<char[]> buffer(new char[length]);
-      glGetProgramInfoLog(m_programID, length, nullptr, buffer.get());
+      success &= tempShader.AttachShaderFileFromPathNoAssert(path);
+    }
+
+    //Nothing that went into the program changed
+    if (success && tempShader.ComputeProgramKey() == m_programKey)
+    {
+      tempShader.Clear();
+      tempShader.m_pendingStages.clear();
+      return false;
+    }
 
+    Debug::Log << Logger::MessageType::INFO
+      << "RecompileShader: " << m_programID << '\n';
+    if (!success)
+    {
       Debug::Log << Logger::MessageType::ERROR_MSG
-        << buffer.get();
+        << "Shader::RecompileShader: Failed to preprocess [" << m_programID << "]\n";
+      tempShader.Clear();
+      tempShader.m_pendingStages.clear();
+      return false;
     }
-    CHECKGL_ERROR();
 
-    return status;
+    // Create a new temp Shader here and swap it in after it linked
+    tempShader.Create();
+    tempShader.BeginLink();
+    return true;
   }
 
-  void Shader::RecompileShader(void)
+  void Shader::FinishRecompile(Shader& tempShader)
   {
-    if (IS_ALLOCATED(Shader, m_programID))
+    //If Compiled and linked successfully
+    if (tempShader.FinishLink(false))
     {
-      Debug::Log << Logger::MessageType::INFO
-        << "**********************************\n";
-      Debug::Log << Logger::MessageType::INFO
-        << "RecompileShader: " << m_programID << '\n';
-
-      // Create a new temp Shader here
-      // Do all of this again without Asseting, its okay to fail compiling
-      Shader tempShader;
-      tempShader.Create();
-
-      //Attach Shader to the program and link the program
-      bool success = true;
-      for (auto path : m_filePath)
-      {
-        success &= tempShader.AttachShaderFileFromPathNoAssert(path);
-      }
-      success &= tempShader.LinkNoAssert();
+      //Release old program
+      this->Release();
+      *this = tempShader;
 
-      //If Compiled and linked successfully
-      if (success)
-      {
-        //Release old program
-        this->Release();
-        *this = tempShader;
+      //Remove tempShader pointer from the Tracker, add this pointer instead
+      ShaderTracker::Remove(tempShader);
+      ShaderTracker::Add(*this);
+    }
+    else
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "Shader::RecompileShader: Failed [" << m_programID << "]\n";
 
-        //Remove tempShader pointer from the Tracker, add this pointer instead
-        ShaderTracker::Remove(tempShader);
-        ShaderTracker::Add(*this);
-      }
-      else
-      {
-        Debug::Log << Logger::MessageType::ERROR_MSG
-          << "Shader::RecompileShader: Failed [" << m_programID << "]\n";
-        
-        //Release the tempShader that failed to compile
-        tempShader.Release();
-      }
-      Debug::Log << Logger::MessageType::INFO
-        << "**********************************\n";
+      //Release the tempShader that failed to compile
+      tempShader.Release();
     }
   }
 
@@ -315,102 +354,107 @@ namespace NightEngine::Rendering::Opengl
   }
 
 
-  GLuint Shader::CreateShaderObject(const std::string& filename)
+  GLenum Shader::GetShaderType(const std::string& filename) const
 	{
 		auto index = filename.rfind(".");
 		auto ext = filename.substr(index + 1);
     if (ext == "comp")
     {
-      return glCreateShader(GL_COMPUTE_SHADER);
+      return GL_COMPUTE_SHADER;
     }
     else if (ext == "frag")
     {
-      return glCreateShader(GL_FRAGMENT_SHADER);
+      return GL_FRAGMENT_SHADER;
     }
     else if (ext == "geom")
     {
-      return glCreateShader(GL_GEOMETRY_SHADER);
+      return GL_GEOMETRY_SHADER;
     }
     else if (ext == "vert")
     {
-      return glCreateShader(GL_VERTEX_SHADER);
+      return GL_VERTEX_SHADER;
     }
 		
-		return false;
+		return GL_NONE;
 	}
 
-  std::string Shader::LoadShaderSourceCode(const std::string& filePath)
+  bool Shader::PreprocessShaderFile(const std::string& filePath, bool assertOnFail)
   {
-    std::ifstream fd(filePath);
-    std::string sourceCode = std::string(std::istreambuf_iterator<char>(fd),
-      (std::istreambuf_iterator<char>()));
-
-    if (sourceCode == "")
-    {
-      Debug::Log << Logger::MessageType::WARNING
-        << "Shader::LoadShaderSourceCode(), filePath's content is empty [" << filePath << "]\n";
-      return "";
-    }
+    m_filePath.emplace_back(filePath);
 
-    //TODO: some preprocessing shader code here before returning
-    bool done = false;
-    while (!done)
+    //Includes come from the preprocessor cache, each file is read once
+    PreprocessedShader preprocessed;
+    bool success = GetShaderPreprocessor().Preprocess(filePath, preprocessed);
+    if (success)
     {
-      //Find token
-      const std::string includeStr = "#include \"";
-      auto includeTokenPos = sourceCode.find(includeStr);
-
-      bool found = includeTokenPos != std::string::npos;
-      if (found)
+      //Keyword variant, the defines are part of the source hash
+      ShaderKeywords::ParseKeywords(preprocessed.m_source, m_keywords);
+      if (!m_defines.empty())
       {
-        size_t posAtIncludePath = includeTokenPos + includeStr.length();
-        std::string afterIncludeToken = sourceCode.substr(posAtIncludePath, sourceCode.length() - posAtIncludePath);
-        auto closingIncludeTokenPos = afterIncludeToken.find("\"");
-
-        std::string includeSourceCode = "";
-        if (closingIncludeTokenPos != std::string::npos)
-        {
-          //Load source code from path
-          auto includePath = afterIncludeToken.substr(0, closingIncludeTokenPos);
-          includePath = PROJECT_DIR_SOURCE_SHADER + includePath;
-          includeSourceCode = LoadShaderSourceCode(includePath);
-        }
-        else
-        {
-          Debug::Log << Logger::MessageType::ERROR_MSG
-            << "Shader::LoadShaderSourceCode(), Error while attempting to replace \"#include\" token at pos[" << includeTokenPos << "]\n";
-        }
-
-        //Replace with source code
-        sourceCode.replace(includeTokenPos, includeStr.length() + closingIncludeTokenPos + 1, includeSourceCode);
+        ShaderKeywords::InjectDefines(preprocessed.m_source, m_defines);
+        preprocessed.m_hash = Container::ConvertToHash(preprocessed.m_source.c_str()
+          , preprocessed.m_source.size());
       }
 
-      done = !found;
+      m_pendingStages.emplace_back(PendingStage{ GetShaderType(filePath), 0
+        , preprocessed.m_hash, filePath, std::move(preprocessed.m_source) });
     }
+    ASSERT_TRUE(!assertOnFail || success);
 
-    return sourceCode;
+    return success;
   }
 
-  bool Shader::CompileShader(GLuint shaderID, const char* sourceCode)
+  bool Shader::CheckCompileStatus(const PendingStage& stage) const
   {
-    glShaderSource(shaderID, 1, &sourceCode, nullptr);
-    glCompileShader(shaderID);
-
     // Display the Build Log on Error
     GLint status;
-    glGetShaderiv(shaderID, GL_COMPILE_STATUS, &status);
-    if (status == false)
+    glGetShaderiv(stage.m_shaderID, GL_COMPILE_STATUS, &status);
+    if (status == GL_FALSE)
     {
       GLint length;
-      glGetShaderiv(shaderID, GL_INFO_LOG_LENGTH, &length);
+      glGetShaderiv(stage.m_shaderID, GL_INFO_LOG_LENGTH, &length);
       std::unique_ptr<char[]> buffer(new char[length]);
-      glGetShaderInfoLog(shaderID, length, nullptr, buffer.get());
+      glGetShaderInfoLog(stage.m_shaderID, length, nullptr, buffer.get());
 
       Debug::Log << Logger::MessageType::ERROR_MSG
-        << m_filePath[m_filePath.size()-1].c_str() << '\n' << buffer.get();
+        << stage.m_path.c_str() << '\n' << buffer.get();
+
+      //Output full source code file to the error log, so its easier to trace the error lod when using #include
+      auto pos = stage.m_path.find_last_of('/');
+      auto fileNameNoSlash = pos != stage.m_path.npos ?
+        stage.m_path.substr(pos + 1, stage.m_path.size() - pos) : stage.m_path;
+
+      auto file = FileSystem::CreateFileTo("[" + fileNameNoSlash + "] shader_error.txt"
+        , FileSystem::DirectoryType::ErrorLog);
+      *file << stage.m_source;
+      file->flush();
+      file->close();
+    }
+
+    return status == GL_TRUE;
+  }
+
+  Container::U64 Shader::ComputeProgramKey(void) const
+  {
+    std::vector<GLenum> types;
+    std::vector<Container::U64> hashes;
+    types.reserve(m_pendingStages.size());
+    hashes.reserve(m_pendingStages.size());
+    for (auto& stage : m_pendingStages)
+    {
+      types.emplace_back(stage.m_type);
+      hashes.emplace_back(stage.m_hash);
     }
 
-    return status;
+    return ShaderCache::MakeProgramKey(types.data(), hashes.data(), types.size());
+  }
+
+  void Shader::CacheDrawUniformLocations(void)
+  {
+    for (size_t i = 0; i < m_drawUniformLocations.size(); ++i)
+    {
+      m_drawUniformLocations[i] = glGetUniformLocation(m_programID, c_DRAW_UNIFORM_NAMES[i]);
+    }
   }
 } // Rendering
 
@@ -16,19 +16,32 @@
 #include "Core/Logger.hpp"
 
 #include "Core/Reflection/ReflectionMacros.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+#include "Graphics/Opengl/ShaderKeywords.hpp"
 
 // Standard Headers
+#include <array>
 #include <string>
 #include <vector>
 
 namespace NightEngine::Rendering::Opengl
 {
+  //! @brief Uniforms set on every draw, looked up once when the program is linked
+  enum class DrawUniform : unsigned
+  {
+    VERTEX_FORMAT = 0,    //u_vertexFormat
+    POSITION_OFFSET,      //u_positionOffset
+    POSITION_SCALE,       //u_positionScale
+    TEXCOORD_DECODE,      //u_texCoordDecode
+    COUNT
+  };
+
 	class Shader
 	{
     REFLECTABLE_TYPE();
 	public:
     //! @brief Constructor
-		Shader() : m_programID(~0) {}
+		Shader() : m_programID(~0) { m_drawUniformLocations.fill(-1); }
 
     //! @brief Assignment Operator
     Shader& operator=(const Shader& rhs);
@@ -51,26 +64,54 @@ namespace NightEngine::Rendering::Opengl
     //! @brief Unbind
 		void		Unbind(void) const;
 
-    //! @brief Attach shader file
+    //! @brief Attach shader file, the source is preprocessed now and compiled on Link
 		bool		AttachShaderFile(const std::string& filename);
 
     //! @brief Attach shader file
     bool		AttachShaderFileFromPathNoAssert(const std::string& filePath);
 
-    //! @brief Link the shader
-    bool		Link() const;
+    //! @brief Compile the attached files and link the shader, or load it from the ShaderCache
+    bool		Link();
 
     //! @brief Link the shader
-    bool		LinkNoAssert() const;
+    bool		LinkNoAssert();
+
+    //! @brief Issue the compile and link without waiting for the result,
+    // so other programs can be issued while the driver compile in parallel
+    void    BeginLink(void);
+
+    //! @brief Check if FinishLink would return without blocking
+    bool    IsLinkComplete(void) const;
+
+    //! @brief Wait for the link issued by BeginLink, check and cache the result
+    bool    FinishLink(bool assertOnFail);
 
     //! @brief Get Shader Program ID
 		inline GLuint  GetProgramID() const { return m_programID; }
 
+    //! @brief Get the ShaderCache key of the linked program
+    inline Container::U64 GetProgramKey() const { return m_programKey; }
+
+    //! @brief Defines injected after #version of every attached file, set before attaching
+    inline void SetKeywordDefines(const std::string& defines) { m_defines = defines; }
+
+    //! @brief Keywords declared by the attached files with #pragma shader_feature
+    inline const std::vector<std::string>& GetKeywords() const { return m_keywords; }
+
+    //! @brief Get attached file paths
+    inline const std::vector<std::string>& GetFilePaths() const { return m_filePath; }
+
     //! @brief Recompile this shader based on the filePath
     void    RecompileShader(void);
 
+    //! @brief Start recompiling into tempShader, false if the sources didn't change
+    bool    BeginRecompile(Shader& tempShader);
+
+    //! @brief Finish the recompile started by BeginRecompile, swap in tempShader on success
+    void    FinishRecompile(Shader& tempShader);
+
     //! @brief Clear Shader Variable
-    void Clear(void) { m_programID = ~(0); m_filePath.clear(); }
+    void Clear(void) { m_programID = ~(0); m_programKey = 0; m_filePath.clear(); m_keywords.clear(); m_drawUniformLocations.fill(-1); }
 
     //**************************************
     //  SetUniform Overloads
@@ -84,52 +125,117 @@ namespace NightEngine::Rendering::Opengl
 		static void	SetUniform(unsigned int location, glm::mat4 const & matrix);
 
     //! @brief Set the uniform block binding point
-    void    SetUniformBlockBindingPoint(const std::string& uniformBlockName, unsigned bufferPointIndex);
+    void    SetUniformBlockBindingPoint(const std::string& uniformBlockName, unsigned bufferPointIndex) const;
 
-    //! @brief Set Uniform Function
+    //! @brief Set Uniform Function, const char* overload avoid a std::string per call
     template<typename T> 
-    void	SetUniform(const std::string& name, T&& value) const
+    void	SetUniform(const char* name, T&& value) const
 		{
       using namespace NightEngine;
 			//Note: Need to Bind() first before calling this method
-			int location = glGetUniformLocation(m_programID, name.c_str());
+			int location = glGetUniformLocation(m_programID, name);
 			if (!CheckErrorLocation(location))
 			{
         SetUniform(location, std::forward<T>(value));
 			}
 		}
 
+    //! @brief Set Uniform Function
+    template<typename T> 
+    void	SetUniform(const std::string& name, T&& value) const
+		{
+      SetUniform(name.c_str(), std::forward<T>(value));
+		}
+
     //! @brief Set Uniform Function
     template<typename T>
-    void	SetUniformNoErrorCheck(const std::string& name, T&& value) const
+    void	SetUniformNoErrorCheck(const char* name, T&& value) const
     {
       using namespace NightEngine;
       //Note: Need to Bind() first before calling this method
-      int location = glGetUniformLocation(m_programID, name.c_str());
+      int location = glGetUniformLocation(m_programID, name);
       if (location != -1)
       {
         SetUniform(location, std::forward<T>(value));
       }
     }
 
+    //! @brief Set Uniform Function
+    template<typename T>
+    void	SetUniformNoErrorCheck(const std::string& name, T&& value) const
+    {
+      SetUniformNoErrorCheck(name.c_str(), std::forward<T>(value));
+    }
+
+    //! @brief Location of a DrawUniform, -1 if the program doesn't declare it
+    int GetDrawUniformLocation(DrawUniform uniform) const
+    {
+      return m_drawUniformLocations[static_cast<unsigned>(uniform)];
+    }
+
+    //! @brief Set a DrawUniform by its cached location, no string lookup per draw.
+    // Ignored if the program doesn't declare it
+    template<typename T>
+    void	SetDrawUniform(DrawUniform uniform, T&& value) const
+    {
+      //Note: Need to Bind() first before calling this method
+      int location = GetDrawUniformLocation(uniform);
+      if (location != -1)
+      {
+        SetUniform(location, std::forward<T>(value));
+      }
+    }
+
+    //! @brief Check if this uniform is available
+    bool IsValidUniform(const char* name) const
+    {
+      return glGetUniformLocation(m_programID, name) != -1;
+    }
+
     //! @brief Check if this uniform is available
     bool IsValidUniform(std::string const & name) const
     {
-      return glGetUniformLocation(m_programID, name.c_str()) != -1;
+      return IsValidUniform(name.c_str());
+    }
+
+    //! @brief Check if this uniform block is available
+    bool IsValidUniformBlock(const char* name) const
+    {
+      return glGetUniformBlockIndex(m_programID, name) != GL_INVALID_INDEX;
     }
 
 	private:
     bool CheckErrorLocation(int location) const;
 
-		GLuint	CreateShaderObject(const std::string& filename);
+    //! @brief Preprocessed stage waiting for Link
+    struct PendingStage
+    {
+      GLenum          m_type;
+      GLuint          m_shaderID;
+      Container::U64  m_hash;
+      std::string     m_path;
+      std::string     m_source;
+    };
+
+    GLenum  GetShaderType(const std::string& filename) const;
+
+    bool    PreprocessShaderFile(const std::string& filePath, bool assertOnFail);
+
+    bool    CheckCompileStatus(const PendingStage& stage) const;
 
-    std::string LoadShaderSourceCode(const std::string& filePath);
+    Container::U64 ComputeProgramKey(void) const;
 
-    bool CompileShader(GLuint shaderID, const char* sourceCode);
+    void    CacheDrawUniformLocations(void);
 
 		// Private Member Variables
 		GLuint m_programID;
+    Container::U64 m_programKey = 0;      //ShaderCache key of the linked program
     std::vector<std::string> m_filePath;  //Save shader path to be serialized
+    std::vector<std::string> m_keywords;  //Declared shader_feature keywords
+    std::string m_defines;                //Keyword defines of this variant
+    std::vector<PendingStage> m_pendingStages;
+    bool m_loadedFromCache = false;
+    std::array<int, static_cast<unsigned>(DrawUniform::COUNT)> m_drawUniformLocations;
 	};
 
   //! @brief Two Shader are the same if they have the same programID
@@ -0,0 +1,244 @@
+/*!
+  @file ShaderCache.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ShaderCache
+*/
+#include "Graphics/Opengl/ShaderCache.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Core/Serialization/FileSystem.hpp"
+
+// System Headers
+#include <GLFW/glfw3.h>
+
+// Standard Headers
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//Not in the loader, KHR and ARB share the same enums
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  namespace ShaderCache
+  {
+    using MaxShaderCompilerThreadsFN = void (APIENTRYP)(GLuint count);
+
+    static const U32 c_CACHE_MAGIC = 0x4345534E;  //"NSEC"
+    static const U32 c_CACHE_VERSION = 1;
+
+    //! @brief Header in front of the binary blob
+    struct CacheFileHeader
+    {
+      U32 m_magic;
+      U32 m_version;
+      U64 m_key;
+      U32 m_binaryFormat;
+      U32 m_binaryLength;
+    };
+
+    static bool g_binarySupported = false;
+    static bool g_parallelCompile = false;
+    static U64  g_driverHash = 0;
+
+    static bool HasExtension(const char* name)
+    {
+      GLint count = 0;
+      glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+      for (GLint i = 0; i < count; ++i)
+      {
+        auto ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (ext != nullptr && std::strcmp(ext, name) == 0)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    static std::string GetCacheFilePath(U64 key)
+    {
+      char fileName[32];
+      snprintf(fileName, sizeof(fileName), "%016llx.bin", static_cast<unsigned long long>(key));
+      return FileSystem::GetFilePath(fileName, FileSystem::DirectoryType::ShaderCache);
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    void Initialize(void)
+    {
+      //Binaries are only valid for the exact same driver
+      std::string driver;
+      for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION })
+      {
+        auto str = reinterpret_cast<const char*>(glGetString(name));
+        driver += str != nullptr ? str : "";
+        driver += '|';
+      }
+      g_driverHash = ConvertToHash(driver.c_str(), driver.size());
+
+      GLint formatCount = 0;
+      if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary)
+      {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+      }
+      g_binarySupported = formatCount > 0;
+
+      if (g_binarySupported)
+      {
+        std::error_code error;
+        std::filesystem::create_directories(FileSystem::GetFilePath(""
+          , FileSystem::DirectoryType::ShaderCache).c_str(), error);
+      }
+
+      //Let the driver use as many compiler threads as it want
+      MaxShaderCompilerThreadsFN maxThreadsFn = nullptr;
+      if (HasExtension("GL_KHR_parallel_shader_compile"))
+      {
+        maxThreadsFn = reinterpret_cast<MaxShaderCompilerThreadsFN>(
+          glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+      }
+      else if (HasExtension("GL_ARB_parallel_shader_compile"))
+      {
+        maxThreadsFn = reinterpret_cast<MaxShaderCompilerThreadsFN>(
+          glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+      }
+      g_parallelCompile = maxThreadsFn != nullptr;
+      if (g_parallelCompile)
+      {
+        maxThreadsFn(0xFFFFFFFF);
+      }
+      CHECKGL_ERROR();
+
+      Debug::Log << Logger::MessageType::INFO
+        << "ShaderCache: program binary [" << (g_binarySupported ? "on" : "off")
+        << "], parallel compile [" << (g_parallelCompile ? "on" : "off") << "]\n";
+    }
+
+    void Terminate(void)
+    {
+      g_binarySupported = false;
+      g_parallelCompile = false;
+      g_driverHash = 0;
+    }
+
+    bool IsBinaryCacheSupported(void)
+    {
+      return g_binarySupported;
+    }
+
+    bool IsParallelCompileSupported(void)
+    {
+      return g_parallelCompile;
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    U64 MakeProgramKey(const GLenum* stageTypes, const U64* stageHashes, size_t stageCount)
+    {
+      U64 key = g_driverHash;
+      for (size_t i = 0; i < stageCount; ++i)
+      {
+        U64 stage[2] = { static_cast<U64>(stageTypes[i]), stageHashes[i] };
+        key = Murmur2A64_Hash(reinterpret_cast<const char*>(stage), sizeof(stage), key);
+      }
+      return key;
+    }
+
+    bool LoadProgram(U64 key, GLuint programID)
+    {
+      if (!g_binarySupported)
+      {
+        return false;
+      }
+
+      std::ifstream file(GetCacheFilePath(key), std::ios::in | std::ios::binary | std::ios::ate);
+      if (!file.is_open())
+      {
+        return false;
+      }
+
+      //Size before trusting anything in the header, truncated or foreign file is a miss
+      std::streamoff fileSize = file.tellg();
+      if (fileSize < static_cast<std::streamoff>(sizeof(CacheFileHeader)))
+      {
+        return false;
+      }
+      file.seekg(0, std::ios::beg);
+
+      CacheFileHeader header;
+      if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || header.m_magic != c_CACHE_MAGIC || header.m_version != c_CACHE_VERSION
+        || header.m_key != key || header.m_binaryLength == 0
+        || static_cast<std::streamoff>(header.m_binaryLength)
+          != fileSize - static_cast<std::streamoff>(sizeof(header)))
+      {
+        return false;
+      }
+
+      std::vector<char> binary(header.m_binaryLength);
+      if (!file.read(binary.data(), binary.size()))
+      {
+        return false;
+      }
+
+      //Driver can still reject it, e.g. after an update with the same version string
+      glProgramBinary(programID, header.m_binaryFormat, binary.data()
+        , static_cast<GLsizei>(binary.size()));
+      GLint status = GL_FALSE;
+      glGetProgramiv(programID, GL_LINK_STATUS, &status);
+      CHECKGL_ERROR();
+      return status == GL_TRUE;
+    }
+
+    void StoreProgram(U64 key, GLuint programID)
+    {
+      if (!g_binarySupported)
+      {
+        return;
+      }
+
+      GLint length = 0;
+      glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+      if (length <= 0)
+      {
+        return;
+      }
+
+      std::vector<char> binary(length);
+      GLenum format = 0;
+      glGetProgramBinary(programID, length, nullptr, &format, binary.data());
+      CHECKGL_ERROR();
+
+      CacheFileHeader header{ c_CACHE_MAGIC, c_CACHE_VERSION, key
+        , static_cast<U32>(format), static_cast<U32>(length) };
+      std::ofstream file(GetCacheFilePath(key), std::ios::out | std::ios::binary);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(binary.data(), binary.size());
+    }
+
+    /////////////////////////////////////////////////////////////////////////
+
+    bool IsProgramComplete(GLuint programID)
+    {
+      if (!g_parallelCompile)
+      {
+        return true;
+      }
+
+      GLint complete = GL_TRUE;
+      glGetProgramiv(programID, GL_COMPLETION_STATUS_KHR, &complete);
+      return complete == GL_TRUE;
+    }
+  }
+} // Rendering
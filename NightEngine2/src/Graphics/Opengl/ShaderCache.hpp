@@ -0,0 +1,45 @@
+/*!
+  @file ShaderCache.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ShaderCache
+*/
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+
+#include "Core/Container/PrimitiveType.hpp"
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief Linked program binaries stored on disk, keyed by the preprocessed
+  // stage sources and the driver, and the driver's parallel compile support
+  namespace ShaderCache
+  {
+    //! @brief Query the driver, need a current context
+    void Initialize(void);
+
+    //! @brief Forget the driver state
+    void Terminate(void);
+
+    //! @brief Check if glGetProgramBinary is usable
+    bool IsBinaryCacheSupported(void);
+
+    //! @brief Check if KHR_parallel_shader_compile (or the ARB one) is available
+    bool IsParallelCompileSupported(void);
+
+    //! @brief Hash of (stage type, preprocessed source hash) pairs and the driver string
+    Container::U64 MakeProgramKey(const GLenum* stageTypes
+      , const Container::U64* stageHashes, size_t stageCount);
+
+    //! @brief Load the program binary of key into programID, true if it linked
+    bool LoadProgram(Container::U64 key, GLuint programID);
+
+    //! @brief Store the linked program binary of programID under key
+    void StoreProgram(Container::U64 key, GLuint programID);
+
+    //! @brief Check if the driver has finished linking, querying the status before
+    // that would block. Always true without parallel compile.
+    bool IsProgramComplete(GLuint programID);
+  }
+} // Rendering
@@ -0,0 +1,154 @@
+/*!
+  @file ShaderKeywords.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ShaderKeywords
+*/
+#include "Graphics/Opengl/ShaderKeywords.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+
+using namespace NightEngine;
+
+namespace NightEngine::Rendering::Opengl
+{
+  namespace ShaderKeywords
+  {
+    static bool IsSpace(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    //! @brief Position of the first token of the line if it start with directive, npos otherwise
+    static size_t MatchDirective(const std::string& source, size_t lineBegin, size_t lineEnd
+      , const char* directive)
+    {
+      size_t pos = source.find_first_not_of(" \t", lineBegin);
+      size_t length = std::char_traits<char>::length(directive);
+      if (pos < lineEnd && source.compare(pos, length, directive) == 0
+        && (pos + length == lineEnd || IsSpace(source[pos + length]) || source[pos + length] == '\n'))
+      {
+        return pos + length;
+      }
+      return std::string::npos;
+    }
+
+    void ParseKeywords(const std::string& source, std::vector<std::string>& keywords)
+    {
+      size_t lineBegin = 0;
+      while (lineBegin < source.size())
+      {
+        size_t lineEnd = source.find('\n', lineBegin);
+        lineEnd = lineEnd == std::string::npos ? source.size() : lineEnd;
+
+        //"#pragma shader_feature A B C", unknown pragma are ignored by GLSL
+        size_t pos = MatchDirective(source, lineBegin, lineEnd, "#pragma");
+        if (pos != std::string::npos)
+        {
+          pos = MatchDirective(source, pos, lineEnd, "shader_feature");
+        }
+
+        while (pos < lineEnd)
+        {
+          size_t begin = pos;
+          while (begin < lineEnd && IsSpace(source[begin]))
+          {
+            ++begin;
+          }
+          size_t end = begin;
+          while (end < lineEnd && !IsSpace(source[end]))
+          {
+            ++end;
+          }
+
+          //Stop at a trailing comment
+          if (end > begin && source.compare(begin, 2, "//") != 0)
+          {
+            std::string keyword = source.substr(begin, end - begin);
+            if (std::find(keywords.begin(), keywords.end(), keyword) == keywords.end())
+            {
+              ASSERT_MSG(keywords.size() < c_MAX_SHADER_KEYWORDS
+                , "Too many shader keywords, max is " << c_MAX_SHADER_KEYWORDS);
+              keywords.emplace_back(std::move(keyword));
+            }
+          }
+          else
+          {
+            break;
+          }
+          pos = end;
+        }
+
+        lineBegin = lineEnd + 1;
+      }
+    }
+
+    int FindKeyword(const std::vector<std::string>& keywords, const char* keyword)
+    {
+      for (size_t i = 0; i < keywords.size(); ++i)
+      {
+        if (keywords[i] == keyword)
+        {
+          return static_cast<int>(i);
+        }
+      }
+      return -1;
+    }
+
+    ShaderVariantKey EnableKeyword(const std::vector<std::string>& keywords
+      , ShaderVariantKey key, const char* keyword)
+    {
+      int index = FindKeyword(keywords, keyword);
+      return index >= 0 ? key | (ShaderVariantKey(1) << index) : key;
+    }
+
+    std::string MakeDefineBlock(const std::vector<std::string>& keywords
+      , ShaderVariantKey key)
+    {
+      std::string defines;
+      for (size_t i = 0; i < keywords.size(); ++i)
+      {
+        if (key & (ShaderVariantKey(1) << i))
+        {
+          defines += "#define ";
+          defines += keywords[i];
+          defines += '\n';
+        }
+      }
+      return defines;
+    }
+
+    void InjectDefines(std::string& source, const std::string& defines)
+    {
+      if (defines.empty())
+      {
+        return;
+      }
+
+      size_t lineBegin = 0;
+      while (lineBegin < source.size())
+      {
+        size_t lineEnd = source.find('\n', lineBegin);
+        lineEnd = lineEnd == std::string::npos ? source.size() : lineEnd;
+
+        if (MatchDirective(source, lineBegin, lineEnd, "#version") != std::string::npos)
+        {
+          //Version line may be the last line without '\n'
+          if (lineEnd == source.size())
+          {
+            source += '\n';
+          }
+          source.insert(lineEnd + 1, defines);
+          return;
+        }
+
+        lineBegin = lineEnd + 1;
+      }
+
+      //No #version, defaulted to 110 and defines can go first
+      source.insert(0, defines);
+    }
+  }
+} // Rendering
@@ -0,0 +1,53 @@
+/*!
+  @file ShaderKeywords.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ShaderKeywords
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+
+// Standard Headers
+#include <string>
+#include <vector>
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief Bit i is set when the i-th keyword declared by the shader is enabled
+  using ShaderVariantKey = Container::U32;
+
+  //! @brief Keywords per shader, the variant key take 16 bits of the render sort key
+  constexpr size_t c_MAX_SHADER_KEYWORDS = 16;
+
+  //! @brief Shader feature toggles compiled as #define instead of runtime uniforms.
+  // Shader declare them with "#pragma shader_feature KEYWORD_A KEYWORD_B".
+  namespace ShaderKeywords
+  {
+    //! @brief Append keywords declared in source, skipping the ones already in keywords
+    void ParseKeywords(const std::string& source, std::vector<std::string>& keywords);
+
+    //! @brief Index of keyword in keywords, -1 if not declared
+    int FindKeyword(const std::vector<std::string>& keywords, const char* keyword);
+
+    //! @brief Return key with keyword enabled, unchanged if keyword isn't declared
+    ShaderVariantKey EnableKeyword(const std::vector<std::string>& keywords
+      , ShaderVariantKey key, const char* keyword);
+
+    //! @brief "#define KEYWORD" line for every keyword enabled in key
+    std::string MakeDefineBlock(const std::vector<std::string>& keywords
+      , ShaderVariantKey key);
+
+    //! @brief Insert defines after the #version line, #version has to stay first
+    void InjectDefines(std::string& source, const std::string& defines);
+
+    //! @brief Draw order key, sorted ascending: program, then variant, then material.
+    // Draws that share a program end up next to each other.
+    constexpr Container::U64 MakeRenderSortKey(Container::U32 shaderID
+      , ShaderVariantKey variantKey, Container::U32 materialID)
+    {
+      return (static_cast<Container::U64>(shaderID & 0xFFFF) << 48)
+        | (static_cast<Container::U64>(variantKey & 0xFFFF) << 32)
+        | static_cast<Container::U64>(materialID);
+    }
+  }
+} // Rendering
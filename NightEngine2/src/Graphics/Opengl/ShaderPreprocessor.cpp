@@ -0,0 +1,299 @@
+/*!
+  @file ShaderPreprocessor.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ShaderPreprocessor
+*/
+#include "Graphics/Opengl/ShaderPreprocessor.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  static U64 HashSource(const std::string& source)
+  {
+    return ConvertToHash(source.c_str(), source.size());
+  }
+
+  bool ShaderPreprocessor::ReadFromDisk(const std::string& path, std::string& outSource)
+  {
+    //Loose file or pak archive
+    FileView file = VirtualFileSystem::Read(path);
+    if (!file.IsValid())
+    {
+      return false;
+    }
+
+    outSource.assign(file.GetData(), file.GetSize());
+    return true;
+  }
+
+  ShaderPreprocessor::ShaderPreprocessor(ReadFileFN readFile, std::string includeRoot)
+    : m_readFile(std::move(readFile)), m_includeRoot(std::move(includeRoot))
+  {
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  bool ShaderPreprocessor::Preprocess(const std::string& path, PreprocessedShader& output)
+  {
+    output.m_source.clear();
+    output.m_files.clear();
+
+    std::vector<std::string> stack;
+    std::unordered_set<std::string> included;
+    output.m_success = Expand(path, output, stack, included);
+    output.m_hash = HashSource(output.m_source);
+
+    return output.m_success;
+  }
+
+  bool ShaderPreprocessor::Expand(const std::string& path, PreprocessedShader& output
+    , std::vector<std::string>& stack, std::unordered_set<std::string>& included)
+  {
+    //Circular include would never terminate
+    if (std::find(stack.begin(), stack.end(), path) != stack.end())
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "ShaderPreprocessor: circular #include of [" << path << "] from ["
+        << stack.back() << "]\n";
+      return false;
+    }
+
+    //Already expanded in this shader, same as #pragma once
+    if (!included.insert(path).second)
+    {
+      return true;
+    }
+
+    SourceFile* file = LoadFile(path);
+    if (file == nullptr)
+    {
+      Debug::Log << Logger::MessageType::ERROR_MSG
+        << "ShaderPreprocessor: failed to read [" << path << "]\n";
+      return false;
+    }
+    output.m_files.emplace_back(path);
+
+    if (file->m_source.empty())
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "ShaderPreprocessor: file's content is empty [" << path << "]\n";
+    }
+
+    //Copy the text between directives, splice the includes in place
+    bool success = true;
+    stack.emplace_back(path);
+    size_t cursor = 0;
+    for (auto& include : file->m_includes)
+    {
+      output.m_source.append(file->m_source, cursor, include.m_begin - cursor);
+      success &= Expand(include.m_path, output, stack, included);
+      cursor = include.m_end;
+    }
+    output.m_source.append(file->m_source, cursor, std::string::npos);
+    stack.pop_back();
+
+    return success;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  ShaderPreprocessor::SourceFile* ShaderPreprocessor::LoadFile(const std::string& path)
+  {
+    SourceFile& file = m_files[path];
+    if (file.m_loaded)
+    {
+      return &file;
+    }
+
+    ++m_readCount;
+    if (!m_readFile(path, file.m_source))
+    {
+      file.m_source.clear();
+      return nullptr;
+    }
+
+    file.m_contentHash = HashSource(file.m_source);
+    file.m_loaded = true;
+    ScanIncludes(path, file);
+    return &file;
+  }
+
+  void ShaderPreprocessor::ScanIncludes(const std::string& path, SourceFile& file)
+  {
+    //Unlink the edges from the previous content
+    for (auto& include : file.m_includes)
+    {
+      auto it = m_files.find(include.m_path);
+      if (it != m_files.end())
+      {
+        it->second.m_includedBy.erase(path);
+      }
+    }
+    file.m_includes.clear();
+
+    //Directive is "#include" at the start of a line, optionally indented
+    const std::string& source = file.m_source;
+    const std::string includeToken = "#include";
+    size_t lineBegin = 0;
+    while (lineBegin < source.size())
+    {
+      size_t lineEnd = source.find('\n', lineBegin);
+      lineEnd = lineEnd == std::string::npos ? source.size() : lineEnd + 1;
+
+      size_t pos = source.find_first_not_of(" \t", lineBegin);
+      if (pos < lineEnd && source.compare(pos, includeToken.size(), includeToken) == 0)
+      {
+        size_t open = source.find('\"', pos + includeToken.size());
+        size_t close = open < lineEnd ? source.find('\"', open + 1) : std::string::npos;
+        if (close < lineEnd)
+        {
+          std::string includePath = ResolveIncludePath(source.substr(open + 1, close - open - 1));
+          file.m_includes.emplace_back(IncludeDirective{ lineBegin, lineEnd, includePath });
+        }
+        else
+        {
+          Debug::Log << Logger::MessageType::ERROR_MSG
+            << "ShaderPreprocessor: malformed #include in [" << path << "] at pos["
+            << pos << "]\n";
+        }
+      }
+
+      lineBegin = lineEnd;
+    }
+
+    //Link the new edges, the included file don't need to be loaded yet
+    for (auto& include : file.m_includes)
+    {
+      m_files[include.m_path].m_includedBy.insert(path);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  U64 ShaderPreprocessor::GetContentHash(const std::string& path) const
+  {
+    auto it = m_files.find(path);
+    return it != m_files.end() && it->second.m_loaded ? it->second.m_contentHash : 0;
+  }
+
+  void ShaderPreprocessor::GetDependents(const std::string& path, std::vector<std::string>& output) const
+  {
+    output.clear();
+
+    std::vector<const std::string*> open{ &path };
+    std::unordered_set<std::string> visited{ path };
+    while (!open.empty())
+    {
+      auto it = m_files.find(*open.back());
+      open.pop_back();
+      if (it == m_files.end())
+      {
+        continue;
+      }
+
+      for (auto& includer : it->second.m_includedBy)
+      {
+        if (visited.insert(includer).second)
+        {
+          output.emplace_back(includer);
+          open.emplace_back(&includer);
+        }
+      }
+    }
+  }
+
+  void ShaderPreprocessor::GetIncludes(const std::string& path, std::vector<std::string>& output) const
+  {
+    output.clear();
+    auto it = m_files.find(path);
+    if (it != m_files.end())
+    {
+      for (auto& include : it->second.m_includes)
+      {
+        output.emplace_back(include.m_path);
+      }
+    }
+  }
+
+  void ShaderPreprocessor::GetFiles(std::vector<std::string>& output) const
+  {
+    output.clear();
+    output.reserve(m_files.size());
+    for (auto& pair : m_files)
+    {
+      output.emplace_back(pair.first);
+    }
+  }
+
+  bool ShaderPreprocessor::Invalidate(const std::string& path)
+  {
+    auto it = m_files.find(path);
+    if (it == m_files.end() || !it->second.m_loaded)
+    {
+      return false;
+    }
+
+    //Keep m_includedBy, dependents are still known until they reload
+    SourceFile& file = it->second;
+    file.m_loaded = false;
+    file.m_source.clear();
+    file.m_contentHash = 0;
+    return true;
+  }
+
+  void ShaderPreprocessor::Revalidate(std::vector<std::string>* changedFiles)
+  {
+    if (changedFiles != nullptr)
+    {
+      changedFiles->clear();
+    }
+
+    std::string source;
+    for (auto& pair : m_files)
+    {
+      SourceFile& file = pair.second;
+      if (!file.m_loaded)
+      {
+        continue;
+      }
+
+      ++m_readCount;
+      bool readSuccess = m_readFile(pair.first, source);
+      if (readSuccess && HashSource(source) == file.m_contentHash)
+      {
+        continue;
+      }
+
+      //Changed or removed, rescan on the next expansion
+      Invalidate(pair.first);
+      if (changedFiles != nullptr)
+      {
+        changedFiles->emplace_back(pair.first);
+      }
+    }
+  }
+
+  void ShaderPreprocessor::Clear(void)
+  {
+    m_files.clear();
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  ShaderPreprocessor& GetShaderPreprocessor(void)
+  {
+    static ShaderPreprocessor preprocessor{ ShaderPreprocessor::ReadFromDisk
+      , PROJECT_DIR_SOURCE_SHADER };
+    return preprocessor;
+  }
+} // Rendering
@@ -0,0 +1,113 @@
+/*!
+  @file ShaderPreprocessor.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ShaderPreprocessor
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+
+// Standard Headers
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief Shader file with every #include expanded
+  struct PreprocessedShader
+  {
+    std::string               m_source;
+    Container::U64            m_hash = 0;   //Hash of m_source
+    std::vector<std::string>  m_files;      //Every file that went in, root first
+    bool                      m_success = false;
+  };
+
+  //! @brief Expand #include "path" with a cache of raw files and an include graph.
+  // No GL calls, the file reading can be replaced so it is testable headless.
+  class ShaderPreprocessor
+  {
+  public:
+    using ReadFileFN = std::function<bool(const std::string& path, std::string& outSource)>;
+
+    //! @brief Read the whole file from disk
+    static bool ReadFromDisk(const std::string& path, std::string& outSource);
+
+    //! @brief Constructor, include paths are resolved as includeRoot + path
+    explicit ShaderPreprocessor(ReadFileFN readFile = ReadFromDisk
+      , std::string includeRoot = "");
+
+    //! @brief Expand the file at path, each file is included once per expansion
+    bool Preprocess(const std::string& path, PreprocessedShader& output);
+
+    //! @brief Content hash of a loaded file, 0 if it wasn't loaded
+    Container::U64 GetContentHash(const std::string& path) const;
+
+    //! @brief Get every loaded file that directly or indirectly include path
+    void GetDependents(const std::string& path, std::vector<std::string>& output) const;
+
+    //! @brief Get the files directly included by path
+    void GetIncludes(const std::string& path, std::vector<std::string>& output) const;
+
+    //! @brief Get the path of every known file, loaded or only included
+    void GetFiles(std::vector<std::string>& output) const;
+
+    //! @brief Drop the cached content of path, it will be read again on the next expansion.
+    // Return true if the file was loaded.
+    bool Invalidate(const std::string& path);
+
+    //! @brief Read every loaded file again, output the paths whose content hash changed
+    void Revalidate(std::vector<std::string>* changedFiles = nullptr);
+
+    //! @brief Drop every cached file
+    void Clear(void);
+
+    //! @brief Amount of cached files
+    size_t GetFileCount(void) const { return m_files.size(); }
+
+    //! @brief Amount of file reads since construction
+    size_t GetReadCount(void) const { return m_readCount; }
+
+    //! @brief Resolve an include path the same way the expansion does
+    std::string ResolveIncludePath(const std::string& includePath) const
+    {
+      return m_includeRoot + includePath;
+    }
+  private:
+    struct IncludeDirective
+    {
+      size_t      m_begin;    //Start of the #include line
+      size_t      m_end;      //Past the end of the line
+      std::string m_path;     //Resolved path
+    };
+
+    struct SourceFile
+    {
+      std::string                     m_source;
+      Container::U64                  m_contentHash = 0;
+      std::vector<IncludeDirective>   m_includes;
+      std::unordered_set<std::string> m_includedBy;
+      bool                            m_loaded = false;
+    };
+
+    //! @brief Get the cached file, read and scan it if needed
+    SourceFile* LoadFile(const std::string& path);
+
+    //! @brief Find the #include directives of file
+    void ScanIncludes(const std::string& path, SourceFile& file);
+
+    //! @brief Append the expansion of path to output
+    bool Expand(const std::string& path, PreprocessedShader& output
+      , std::vector<std::string>& stack, std::unordered_set<std::string>& included);
+
+    ReadFileFN                                  m_readFile;
+    std::string                                 m_includeRoot;
+    std::unordered_map<std::string, SourceFile> m_files;
+    size_t                                      m_readCount = 0;
+  };
+
+  //! @brief Preprocessor used by Shader, include root is the shader directory
+  ShaderPreprocessor& GetShaderPreprocessor(void);
+} // Rendering
@@ -5,6 +5,7 @@
 */
 #include "Graphics/Opengl/ShaderTracker.hpp"
 #include "Graphics/Opengl/Shader.hpp"
+#include "Graphics/Opengl/ShaderPreprocessor.hpp"
 
 #include "Core/Logger.hpp"
 #include "Core/Utility/Utility.hpp"
@@ -45,11 +46,35 @@ namespace NightEngine::Rendering::Opengl
     }
   }
 
+  static size_t RecompileShaders(const std::vector<Shader*>& shaders)
+  {
+    //Issue every program first so the driver can compile them in parallel,
+    //temp shaders are tracked by address so they must not reallocate
+    std::vector<Shader> tempShaders(shaders.size());
+    std::vector<size_t> issued;
+    for (size_t i = 0; i < shaders.size(); ++i)
+    {
+      if (shaders[i]->BeginRecompile(tempShaders[i]))
+      {
+        issued.emplace_back(i);
+      }
+    }
+    for (size_t i : issued)
+    {
+      shaders[i]->FinishRecompile(tempShaders[i]);
+    }
+    return issued.size();
+  }
+
   void ShaderTracker::RecompileAllShaders()
   {
     NightEngine::Utility::StopWatch stopWatch{ true };
+    size_t recompiledCount = 0;
+    std::vector<Shader*> shaders;
     {
-      std::vector<Shader*> shaders;
+      //Read every source once, only the changed files and their includers are expanded again
+      std::vector<std::string> changedFiles;
+      GetShaderPreprocessor().Revalidate(&changedFiles);
 
       //Recompile all Shaders
       auto& map = GetShaderMap();
@@ -61,16 +86,34 @@ namespace NightEngine::Rendering::Opengl
           shaders.emplace_back(shaderPtr);
         }
       }
-      int i = 0;
-      for (auto shaderPtr : shaders)
-      {
-        //if(i++ < 10)
-        shaderPtr->RecompileShader();
-      }
+
+      recompiledCount = RecompileShaders(shaders);
     }
     stopWatch.Stop();
     Debug::Log << Logger::MessageType::INFO
-      << "RecompileAllShaders: [" << stopWatch.GetElapsedTimeMilli() << " ms]\n";
+      << "RecompileAllShaders: " << recompiledCount << "/" << shaders.size()
+      << " changed [" << stopWatch.GetElapsedTimeMilli() << " ms]\n";
+  }
+
+  size_t ShaderTracker::RecompileShadersUsing(const std::unordered_set<std::string>& filePaths)
+  {
+    std::vector<Shader*> shaders;
+    for (auto& pair : GetShaderMap())
+    {
+      for (auto shaderPtr : pair.second)
+      {
+        for (auto& path : shaderPtr->GetFilePaths())
+        {
+          if (filePaths.find(path) != filePaths.end())
+          {
+            shaders.emplace_back(shaderPtr);
+            break;
+          }
+        }
+      }
+    }
+
+    return RecompileShaders(shaders);
   }
 
   void ShaderTracker::Clear()
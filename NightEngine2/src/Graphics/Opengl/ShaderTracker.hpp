@@ -6,6 +6,8 @@
 #pragma once
 #include <unordered_set>
 #include <unordered_map>
+#include <string>
+#include <vector>
 
 namespace NightEngine::Rendering::Opengl
 {
@@ -22,6 +24,10 @@ namespace NightEngine::Rendering::Opengl
 
     static void RecompileAllShaders();
 
+    //! @brief Recompile only the shaders with a stage in filePaths, return the recompiled count.
+    // The preprocessor cache of the changed files has to be invalidated first.
+    static size_t RecompileShadersUsing(const std::unordered_set<std::string>& filePaths);
+
     static void Clear();
   };
 } // Rendering
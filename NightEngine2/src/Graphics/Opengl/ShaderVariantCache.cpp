@@ -0,0 +1,93 @@
+/*!
+  @file ShaderVariantCache.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ShaderVariantCache
+*/
+#include "Graphics/Opengl/ShaderVariantCache.hpp"
+#include "Graphics/Opengl/Shader.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+
+// Standard Headers
+#include <memory>
+#include <unordered_map>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  namespace ShaderVariantCache
+  {
+    //Shader are tracked by address for recompiling, they must not move
+    using VariantMap = std::unordered_map<U64, std::unique_ptr<Shader>>;
+
+    static VariantMap& GetVariantMap(void)
+    {
+      static VariantMap map;
+      return map;
+    }
+
+    //! @brief Same files and same key is the same variant, stable across recompiles
+    static U64 MakeVariantID(const Shader& baseShader, ShaderVariantKey key)
+    {
+      U64 id = static_cast<U64>(key);
+      for (auto& path : baseShader.GetFilePaths())
+      {
+        id = Murmur2A64_Hash(path.c_str(), static_cast<unsigned long>(path.size()), id);
+      }
+      return id;
+    }
+
+    Shader* GetVariant(Shader& baseShader, ShaderVariantKey key)
+    {
+      if (key == 0)
+      {
+        return &baseShader;
+      }
+
+      auto& map = GetVariantMap();
+      U64 id = MakeVariantID(baseShader, key);
+      auto it = map.find(id);
+      if (it != map.end())
+      {
+        return it->second.get();
+      }
+
+      //Compile on demand, the ShaderCache make this cheap after the first run
+      std::string defines = ShaderKeywords::MakeDefineBlock(baseShader.GetKeywords(), key);
+      Debug::Log << Logger::MessageType::INFO
+        << "ShaderVariantCache: compiling variant\n" << defines;
+
+      std::unique_ptr<Shader> variant{ new Shader() };
+      variant->SetKeywordDefines(defines);
+      variant->Create();
+      for (auto& path : baseShader.GetFilePaths())
+      {
+        variant->AttachShaderFileFromPathNoAssert(path);
+      }
+      variant->Link();
+
+      Shader* result = variant.get();
+      map.emplace(id, std::move(variant));
+      return result;
+    }
+
+    size_t GetVariantCount(void)
+    {
+      return GetVariantMap().size();
+    }
+
+    void Clear(void)
+    {
+      //Program are already deleted by DeallocateAllLoadedObjects
+      auto& map = GetVariantMap();
+      for (auto& pair : map)
+      {
+        pair.second->Clear();
+      }
+      map.clear();
+    }
+  }
+} // Rendering
@@ -0,0 +1,27 @@
+/*!
+  @file ShaderVariantCache.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ShaderVariantCache
+*/
+#pragma once
+
+#include "Graphics/Opengl/ShaderKeywords.hpp"
+
+namespace NightEngine::Rendering::Opengl
+{
+  class Shader;
+
+  //! @brief Keyword variants of shaders, compiled on first use and shared by every material
+  namespace ShaderVariantCache
+  {
+    //! @brief Get the variant of baseShader with the keywords in key enabled.
+    // Key 0 is baseShader itself.
+    Shader* GetVariant(Shader& baseShader, ShaderVariantKey key);
+
+    //! @brief Amount of compiled variants
+    size_t GetVariantCount(void);
+
+    //! @brief Forget every variant, their programs are released with the other gl objects
+    void Clear(void);
+  }
+} // Rendering
@@ -0,0 +1,121 @@
+/*!
+  @file SkinningPalette.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of SkinningPalette
+*/
+#include "Graphics/Opengl/SkinningPalette.hpp"
+#include "Graphics/Opengl/Shader.hpp"
+#include "Graphics/Animation/Skeleton.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <algorithm>
+
+using namespace NightEngine;
+
+namespace NightEngine::Rendering::Opengl
+{
+  namespace SkinningPalette
+  {
+    static const size_t c_TEXELS_PER_BONE = 3;
+
+    static GLuint g_bufferID = 0;
+    static GLuint g_textureID = 0;
+    static size_t g_gpuCapacity = 0;    //In bones
+    static size_t g_maxBones = 0;
+    static size_t g_boneCount = 0;
+
+    void Initialize(void)
+    {
+      GLint maxTexels = 65536;
+      glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+      g_maxBones = static_cast<size_t>(maxTexels) / c_TEXELS_PER_BONE;
+
+      glGenBuffers(1, &g_bufferID);
+      glBindBuffer(GL_TEXTURE_BUFFER, g_bufferID);
+      glBufferData(GL_TEXTURE_BUFFER, sizeof(Animation::SkinMatrix), nullptr, GL_STREAM_DRAW);
+      glBindBuffer(GL_TEXTURE_BUFFER, 0);
+      g_gpuCapacity = 1;
+      g_boneCount = 0;
+
+      //The texture keep pointing at the buffer when its storage is reallocated
+      glGenTextures(1, &g_textureID);
+      glBindTexture(GL_TEXTURE_BUFFER, g_textureID);
+      glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, g_bufferID);
+      glBindTexture(GL_TEXTURE_BUFFER, 0);
+      CHECKGL_ERROR();
+
+      Debug::Log << Logger::MessageType::INFO
+        << "SkinningPalette: up to [" << g_maxBones << " bones]\n";
+    }
+
+    void Terminate(void)
+    {
+      if (g_textureID != 0)
+      {
+        glDeleteTextures(1, &g_textureID);
+        g_textureID = 0;
+      }
+      if (g_bufferID != 0)
+      {
+        glDeleteBuffers(1, &g_bufferID);
+        g_bufferID = 0;
+      }
+      g_gpuCapacity = 0;
+      g_boneCount = 0;
+    }
+
+    void Upload(const Animation::SkinMatrix* palette, size_t boneCount)
+    {
+      if (g_bufferID == 0)
+      {
+        return;
+      }
+
+      if (boneCount > g_maxBones)
+      {
+        Debug::Log << Logger::MessageType::WARNING << "SkinningPalette: " << boneCount
+          << " bones over the texture buffer limit, the last characters are cut\n";
+        boneCount = g_maxBones;
+      }
+
+      g_boneCount = boneCount;
+      if (boneCount == 0)
+      {
+        return;
+      }
+
+      //Grow by doubling, otherwise orphan the storage the last frame may still read
+      g_gpuCapacity = boneCount > g_gpuCapacity
+        ? std::min(std::max(boneCount, g_gpuCapacity * 2), g_maxBones) : g_gpuCapacity;
+      glBindBuffer(GL_TEXTURE_BUFFER, g_bufferID);
+      glBufferData(GL_TEXTURE_BUFFER, g_gpuCapacity * sizeof(Animation::SkinMatrix)
+        , nullptr, GL_STREAM_DRAW);
+      glBufferSubData(GL_TEXTURE_BUFFER, 0, boneCount * sizeof(Animation::SkinMatrix), palette);
+      glBindBuffer(GL_TEXTURE_BUFFER, 0);
+      CHECKGL_ERROR();
+    }
+
+    size_t GetBoneCount(void)
+    {
+      return g_boneCount;
+    }
+
+    void SetUniforms(const Shader& shader, int offset)
+    {
+      //Shaders without skinning don't declare the uniforms
+      shader.SetUniformNoErrorCheck("u_skinPaletteOffset", offset);
+      if (offset >= 0)
+      {
+        glActiveTexture(GL_TEXTURE0 + c_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_BUFFER, g_textureID);
+        shader.SetUniformNoErrorCheck("u_skinPalette", static_cast<int>(c_TEXTURE_UNIT));
+      }
+    }
+  }
+} // Rendering
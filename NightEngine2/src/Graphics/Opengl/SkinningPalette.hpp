@@ -0,0 +1,42 @@
+/*!
+  @file SkinningPalette.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of SkinningPalette
+*/
+#pragma once
+
+#include <cstddef>
+
+namespace NightEngine::Rendering::Animation
+{
+  struct SkinMatrix;
+}
+
+namespace NightEngine::Rendering::Opengl
+{
+  class Shader;
+
+  //! @brief One texture buffer holding the skinning matrices of every animated character.
+  // Each bone take 3 RGBA32F texels, a skinned draw only set its offset in bones.
+  namespace SkinningPalette
+  {
+    //! @brief Texture unit of the palette, above the ones the materials use
+    constexpr unsigned c_TEXTURE_UNIT = 15;
+
+    //! @brief Create the buffer and its texture, need a current context
+    void Initialize(void);
+
+    //! @brief Delete the buffer and its texture
+    void Terminate(void);
+
+    //! @brief Replace the palette for this frame, the storage is orphaned so the
+    // draws of the previous frame never stall the upload
+    void Upload(const Animation::SkinMatrix* palette, size_t boneCount);
+
+    //! @brief Amount of bones uploaded last
+    size_t GetBoneCount(void);
+
+    //! @brief Set the skinning uniforms of a bound shader, offset -1 draw without skinning
+    void SetUniforms(const Shader& shader, int offset);
+  }
+} // Rendering
@@ -10,15 +10,20 @@
 #include "Core/Logger.hpp"
 
 #include "Core/Serialization/ResourceManager.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
+#include "Core/Container/MurmurHash2.hpp"
 
 //// Reference: https://github.com/nothings/stb/blob/master/stb_image.h#L4
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #undef STB_IMAGE_IMPLEMENTATION
 
+#include <cstring>
 #include <unordered_map>
 
 using namespace NightEngine;
+using namespace NightEngine::Container;
 
 namespace NightEngine::Rendering::Opengl
 {
@@ -43,6 +48,115 @@ namespace NightEngine::Rendering::Opengl
     }
     return filterMode;
   }
+
+  //*****************************************************
+  // Cooked Texture
+  //*****************************************************
+  static const U32 c_COOKED_TEXTURE_MAGIC = 0x5845544E;  //"NTEX"
+
+  //! @brief Header in front of the pixels
+  struct CookedTextureHeader
+  {
+    U32 m_magic;
+    U32 m_width;
+    U32 m_height;
+    U32 m_channels;
+    U32 m_hdr;
+    U32 m_reserved;
+  };
+
+  //! @brief Decode the image with its own channel count, bottom row first.
+  // Flipped by hand, stbi_set_flip_vertically_on_load is shared by every thread.
+  static bool DecodeTexture(const FileView& source, bool hdr, std::vector<char>& output)
+  {
+    auto fileData = reinterpret_cast<const stbi_uc*>(source.GetData());
+    int fileSize = static_cast<int>(source.GetSize());
+    int width = 0, height = 0, channels = 0;
+    void* pixels = hdr ? static_cast<void*>(stbi_loadf_from_memory(fileData, fileSize
+      , &width, &height, &channels, 0))
+      : static_cast<void*>(stbi_load_from_memory(fileData, fileSize
+        , &width, &height, &channels, 0));
+    if (pixels == nullptr)
+    {
+      return false;
+    }
+
+    CookedTextureHeader header{ c_COOKED_TEXTURE_MAGIC, static_cast<U32>(width)
+      , static_cast<U32>(height), static_cast<U32>(channels), hdr ? 1u : 0u, 0 };
+    size_t rowSize = static_cast<size_t>(width) * channels * (hdr ? sizeof(float) : 1);
+    output.resize(sizeof(header) + rowSize * height);
+    std::memcpy(output.data(), &header, sizeof(header));
+
+    auto src = static_cast<const char*>(pixels);
+    char* dst = output.data() + sizeof(header);
+    for (int y = 0; y < height; ++y)
+    {
+      std::memcpy(dst + rowSize * y, src + rowSize * (height - 1 - y), rowSize);
+    }
+
+    stbi_image_free(pixels);
+    return true;
+  }
+
+  static bool CookTexture(const std::string& path, const FileView& source, CookOutput& output)
+  {
+    bool hdr = stbi_is_hdr_from_memory(reinterpret_cast<const stbi_uc*>(source.GetData())
+      , static_cast<int>(source.GetSize())) != 0;
+    return DecodeTexture(source, hdr, output.m_data);
+  }
+
+  //! @brief Pixels of the texture from the asset cache, decoded from the file if it
+  // can't be cooked or was cooked as the other kind (ldr/hdr)
+  static FileView LoadTexturePixels(const std::string& filePath, bool hdr
+    , CookedTextureHeader& header)
+  {
+    FileView cooked = GetAssetDatabase().LoadCooked(filePath);
+    if (!cooked.IsValid() || cooked.GetSize() < sizeof(header)
+      || std::memcmp(cooked.GetData(), &c_COOKED_TEXTURE_MAGIC, sizeof(U32)) != 0
+      || reinterpret_cast<const CookedTextureHeader*>(cooked.GetData())->m_hdr != (hdr ? 1u : 0u))
+    {
+      auto decoded = std::make_shared<std::vector<char>>();
+      FileView file = VirtualFileSystem::Read(filePath);
+      if (!file.IsValid() || !DecodeTexture(file, hdr, *decoded))
+      {
+        return FileView();
+      }
+      const char* data = decoded->data();
+      size_t size = decoded->size();
+      cooked = FileView(data, size, std::move(decoded));
+    }
+
+    std::memcpy(&header, cooked.GetData(), sizeof(header));
+    return cooked;
+  }
+
+  //! @brief Same conversion as stbi's req_comp, grey is replicated and alpha default to opaque
+  static void ConvertChannels(const unsigned char* src, size_t pixelCount
+    , int srcChannels, int dstChannels, std::vector<unsigned char>& output)
+  {
+    output.resize(pixelCount * dstChannels);
+    unsigned char* dst = output.data();
+    for (size_t i = 0; i < pixelCount; ++i, src += srcChannels, dst += dstChannels)
+    {
+      bool grey = srcChannels < 3;
+      dst[0] = src[0];
+      dst[1] = grey ? src[0] : src[1];
+      dst[2] = grey ? src[0] : src[2];
+      if (dstChannels == 4)
+      {
+        dst[3] = srcChannels == 2 ? src[1] : srcChannels == 4 ? src[3] : 255;
+      }
+    }
+  }
+
+  void Texture::RegisterCooker(AssetDatabase& database)
+  {
+    //Version and options of the cooker, changing them recook every texture
+    const char c_SETTINGS[] = "Texture|v1|native channels|flip y";
+    database.RegisterCooker(AssetType::TEXTURE
+      , ConvertToHash(c_SETTINGS, sizeof(c_SETTINGS) - 1), CookTexture);
+  }
+
   /////////////////////////////////////////////////////////////////////////
 
   Texture::Texture(const Texture& texture)
@@ -145,6 +259,35 @@ namespace NightEngine::Rendering::Opengl
     Unbind();
   }
 
+  bool Texture::Reload(void)
+  {
+    //Keep the current texture if the file is gone or half written
+    int width, height, channels;
+    FileView file = m_filePath.empty() ? FileView() : VirtualFileSystem::Read(m_filePath);
+    auto fileData = reinterpret_cast<const stbi_uc*>(file.GetData());
+    int fileSize = static_cast<int>(file.GetSize());
+    if (!file.IsValid()
+      || !stbi_info_from_memory(fileData, fileSize, &width, &height, &channels))
+    {
+      Debug::Log << Logger::MessageType::WARNING
+        << "Texture::Reload: can't read [" << m_filePath << "]\n";
+      return false;
+    }
+
+    //Wrap mode isn't stored, file textures are loaded with the default one
+    TextureIdentifier t = stbi_is_hdr_from_memory(fileData, fileSize) ?
+      LoadHDRTexture(m_filePath, m_internalFormat, m_filterMode)
+      : LoadTexture(m_filePath, m_internalFormat, m_filterMode);
+
+    Release();
+    m_textureID = t.m_textureID;
+    if (!m_name.empty())
+    {
+      SetName(m_name.c_str());
+    }
+    return true;
+  }
+
   void Texture::Resize(int width, int height, PixelFormat format, GLenum pixelTarget)
   {
     //Choose target based on channel
@@ -191,30 +334,35 @@ namespace NightEngine::Rendering::Opengl
     Debug::Log << Logger::MessageType::INFO
       << "Texture Loading: " << filePath << '\n';
 
-    //Load Image
-    int width, height, channels;
-
     //TODO: detect Alpha channel from file extension
-    unsigned loadChannel = (internalFormat == Format::RGB
+    int loadChannel = (internalFormat == Format::RGB
       || internalFormat == Format::SRGB
       || internalFormat == Format::RGB16F
       || internalFormat == Format::RGB32F) ? STBI_rgb : STBI_rgb_alpha;
 
-    //Flip Img vertically 
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* imgData = stbi_load(filePath.c_str()
-      , &width, &height, &channels, loadChannel);
+    //Decoded pixels from the asset cache
+    CookedTextureHeader header{};
+    FileView pixels = LoadTexturePixels(filePath, false, header);
+    void* imgData = const_cast<char*>(pixels.IsValid() ? pixels.GetData() + sizeof(header) : nullptr);
+
+    std::vector<unsigned char> converted;
+    if (imgData != nullptr && static_cast<int>(header.m_channels) != loadChannel)
+    {
+      ConvertChannels(static_cast<const unsigned char*>(imgData)
+        , static_cast<size_t>(header.m_width) * header.m_height
+        , static_cast<int>(header.m_channels), loadChannel, converted);
+      imgData = converted.data();
+    }
 
     PixelFormat format = loadChannel == STBI_rgb ?
       PixelFormat::RGB : PixelFormat::RGBA;
 
     //Generate Actual Texture Data based on the loaded file
-    TextureIdentifier t = GenerateTextureData(imgData, width, height
+    TextureIdentifier t = GenerateTextureData(imgData
+      , static_cast<int>(header.m_width), static_cast<int>(header.m_height)
       , internalFormat, format
       , filterMode, wrapMode);
 
-    stbi_image_free(imgData);
-
     return t;
   }
 
@@ -224,23 +372,17 @@ namespace NightEngine::Rendering::Opengl
     Debug::Log << Logger::MessageType::INFO
       << "Texture(HDR) Loading: " << filePath << '\n';
 
-    //Load Image
-    int width, height, channels;
-
-    //Flip Img vertically 
-    stbi_set_flip_vertically_on_load(true);
-
-    //Load the HDR image
-    float* imgData = stbi_loadf(filePath.c_str()
-      , &width, &height, &channels, 0);
+    //Decoded pixels from the asset cache
+    CookedTextureHeader header{};
+    FileView pixels = LoadTexturePixels(filePath, true, header);
+    void* imgData = const_cast<char*>(pixels.IsValid() ? pixels.GetData() + sizeof(header) : nullptr);
 
     //Generate Actual Texture Data based on the loaded file
-    TextureIdentifier t = GenerateTextureData(imgData, width, height
+    TextureIdentifier t = GenerateTextureData(imgData
+      , static_cast<int>(header.m_width), static_cast<int>(header.m_height)
       , internalFormat, PixelFormat::RGB
       , filterMode, wrapMode);
 
-    stbi_image_free(imgData);
-
     return t;
   }
 
@@ -14,6 +14,11 @@
 #include "Core/Reflection/ReflectionMacros.hpp"
 #include "Core/EC/Handle.hpp"
 
+namespace NightEngine
+{
+  class AssetDatabase;
+}
+
 namespace NightEngine::Rendering::Opengl
 {
   class FrameBufferObject;
@@ -186,6 +191,9 @@ namespace NightEngine::Rendering::Opengl
 
     void Resize(int width, int height, PixelFormat format, GLenum pixelTarget = ~(0));
 
+    //! @brief Load the file again into this texture, every handle to it see the new content
+    bool Reload(void);
+
     //*****************************************************
     // Static Method
     //*****************************************************
@@ -215,6 +223,9 @@ namespace NightEngine::Rendering::Opengl
       , Format internalFormat, PixelFormat format
       , FilterMode filterMode, WrapMode wrapMode);
 
+    //! @brief Cook image files into decoded pixels, rows already flipped for GL
+    static void RegisterCooker(AssetDatabase& database);
+
     //! @brief Set opengl blend mode
     static void SetBlendMode(bool enable);
 
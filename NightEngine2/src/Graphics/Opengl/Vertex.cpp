@@ -4,15 +4,10 @@
   @brief Contain the Implementation of Vertex
 */
 #include "Graphics/Opengl/Vertex.hpp"
-#include <glm/mat4x4.hpp>
+#include "Graphics/Opengl/VertexFormat.hpp"
 
 namespace NightEngine::Rendering::Opengl
 {
   const AttributePointerInfo Vertex::s_attributePointerInfo
-    = { 5
-    , std::vector<unsigned>{3, 3, 2, 3, 16}
-    , std::vector<size_t>{sizeof(glm::vec3), sizeof(glm::vec3)
-      ,sizeof(glm::vec2), sizeof(glm::vec3) ,sizeof(glm::mat4)}
-    , std::vector<bool>{ false,false,false ,true, false} 
-    , std::vector<int>{ 0, 0, 0, 0, 1} };
+    = VertexFormat().GetAttributePointerInfo();
 }
\ No newline at end of file
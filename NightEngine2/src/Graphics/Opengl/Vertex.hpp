@@ -12,6 +12,15 @@
 
 namespace NightEngine::Rendering::Opengl
 {
+  //! @brief Component type of an attribute in the buffer
+  enum class AttributeType : unsigned
+  {
+    FLOAT = 0,
+    HALF_FLOAT,
+    SHORT,
+    UNSIGNED_SHORT
+  };
+
   //! @brief Info for describing Attribute
   struct AttributePointerInfo
   {
@@ -20,13 +29,14 @@ namespace NightEngine::Rendering::Opengl
     std::vector<size_t>   m_size;           //Size of each attribute
     std::vector<bool>     m_normalized;     //Should this attribute be normalized?
     std::vector<int>      m_divisor;        //1 for instance, 0 for normal
+    std::vector<AttributeType> m_type;      //Component type, FLOAT by default
 
     //! @brief Constructor
     AttributePointerInfo(unsigned count, const std::vector<unsigned>& dimension
       , const std::vector<size_t>& sizes, const std::vector<bool>& normalized)
       : m_attributeCount(count), m_dimension(dimension)
       , m_size(sizes), m_normalized(normalized)
-      , m_divisor(count,0)
+      , m_divisor(count,0), m_type(count, AttributeType::FLOAT)
     {
     }
 
@@ -36,7 +46,17 @@ namespace NightEngine::Rendering::Opengl
       , const std::vector<int>& divisor)
       : m_attributeCount(count), m_dimension(dimension)
       , m_size(sizes), m_normalized(normalized)
-      , m_divisor(divisor)
+      , m_divisor(divisor), m_type(count, AttributeType::FLOAT)
+    {
+    }
+
+    //! @brief Constructor
+    AttributePointerInfo(unsigned count, const std::vector<unsigned>& dimension
+      , const std::vector<size_t>& sizes, const std::vector<bool>& normalized
+      , const std::vector<int>& divisor, const std::vector<AttributeType>& types)
+      : m_attributeCount(count), m_dimension(dimension)
+      , m_size(sizes), m_normalized(normalized)
+      , m_divisor(divisor), m_type(types)
     {
     }
 
@@ -56,7 +76,7 @@ namespace NightEngine::Rendering::Opengl
     }
   };
 
-  //! @brief Default Vertex Object
+  //! @brief Default Vertex Object, the layout of VertexFormat() in the buffers
 	struct Vertex
 	{
     //To Add Attribute, VAO.AddVertex() need to be modify
@@ -69,4 +89,16 @@ namespace NightEngine::Rendering::Opengl
     static const AttributePointerInfo s_attributePointerInfo;
 	};
 
+  //! @brief Bone influences of a skinned vertex, in a stream next to the Vertex buffer.
+  // Weights are normalized bytes that sum to 255, unused influences have a zero weight.
+  struct SkinVertex
+  {
+    unsigned char m_bones[4];
+    unsigned char m_weights[4];
+
+    //! @brief Attribute locations, after the instance matrix
+    static constexpr unsigned c_BONES_LOCATION = 8;
+    static constexpr unsigned c_WEIGHTS_LOCATION = 9;
+  };
+
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "Core/Macros.hpp"
 #include "Core/Logger.hpp"
 
+#include <cstddef>
+
 //"min" in std::min was override by Window Macros
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 
@@ -29,8 +31,31 @@ namespace NightEngine::Rendering::Opengl
     CHECKGL_ERROR();
   }
 
+  static void ReleaseVAOSBID(GLuint objID)
+  {
+    glDeleteBuffers(1, &objID);
+    DECREMENT_ALLOCATION(VertexArrayObjectSkinBuffer, objID);
+    CHECKGL_ERROR();
+  }
+
+  static GLenum GetGLType(AttributeType type)
+  {
+    switch (type)
+    {
+    case AttributeType::HALF_FLOAT:
+      return GL_HALF_FLOAT;
+    case AttributeType::SHORT:
+      return GL_SHORT;
+    case AttributeType::UNSIGNED_SHORT:
+      return GL_UNSIGNED_SHORT;
+    default:
+      return GL_FLOAT;
+    }
+  }
+
   REGISTER_DEALLOCATION_FUNC(VertexArrayObject, ReleaseVAOID)
   REGISTER_DEALLOCATION_FUNC(VertexArrayObjectInstanceBuffer, ReleaseVAOIBID)
+  REGISTER_DEALLOCATION_FUNC(VertexArrayObjectSkinBuffer, ReleaseVAOSBID)
 
   /////////////////////////////////////////////////////////////////////////
 
@@ -47,12 +72,14 @@ namespace NightEngine::Rendering::Opengl
 	{
     CHECK_LEAK(VertexArrayObject, m_objectID);
     CHECK_LEAK(VertexArrayObjectInstanceBuffer, m_instanceBufferID);
+    CHECK_LEAK(VertexArrayObjectSkinBuffer, m_skinBufferID);
 	}
 
   void VertexArrayObject::ReleaseAllLoadedVAO(void)
   {
     OpenglAllocationTracker::DeallocateAllObjects("VertexArrayObject", ReleaseVAOID);
     OpenglAllocationTracker::DeallocateAllObjects("VertexArrayObjectInstanceBuffer", ReleaseVAOIBID);
+    OpenglAllocationTracker::DeallocateAllObjects("VertexArrayObjectSkinBuffer", ReleaseVAOSBID);
   }
 
   void VertexArrayObject::Release(void)
@@ -69,6 +96,12 @@ namespace NightEngine::Rendering::Opengl
       ReleaseVAOIBID(m_instanceBufferID);
     }
 
+    if (m_skinBufferID != (~0)
+      && IS_ALLOCATED(VertexArrayObjectSkinBuffer, m_skinBufferID))
+    {
+      ReleaseVAOSBID(m_skinBufferID);
+    }
+
     m_vbo.Release();
     m_ebo.Release();
   }
@@ -117,6 +150,20 @@ namespace NightEngine::Rendering::Opengl
     m_ebo.FillIndex(indexArray);
   }
 
+  void VertexArrayObject::FillData(const VertexFormat& format
+    , const Container::U8* vertexBytes, size_t vertexByteSize
+    , const unsigned* indexArray, size_t indexArraySize)
+  {
+    m_format = format;
+    m_vbo.FillVertexBytes(vertexBytes, vertexByteSize);
+    m_ebo.FillIndex(indexArray, indexArraySize);
+  }
+
+  void VertexArrayObject::FillSkin(const SkinVertex* skinArray, size_t skinArraySize)
+  {
+    m_skinVertices.assign(skinArray, skinArray + skinArraySize);
+  }
+
   void VertexArrayObject::Clear(void)
   {
     m_vbo.Clear();
@@ -133,6 +180,7 @@ namespace NightEngine::Rendering::Opengl
     m_ebo.Build(mode);
 
     SetupAttributePointer();
+    SetupSkinAttribute(mode);
     Unbind();
 
     m_vbo.Unbind();
@@ -276,7 +324,8 @@ namespace NightEngine::Rendering::Opengl
 
   void VertexArrayObject::SetupAttributePointer(void)
   {
-    AttributePointerInfo info = Vertex::s_attributePointerInfo;
+    AttributePointerInfo info = m_format.IsDefault() ? Vertex::s_attributePointerInfo
+      : m_format.GetAttributePointerInfo();
     SetupAttributePointer(info);
   }
 
@@ -351,7 +400,7 @@ namespace NightEngine::Rendering::Opengl
         //Enable and Set Attribute Pointer
         glEnableVertexAttribArray(i);
         glVertexAttribPointer(i, attributeInfo.m_dimension[i]
-          , GL_FLOAT, attributeInfo.m_normalized[i]
+          , GetGLType(attributeInfo.m_type[i]), attributeInfo.m_normalized[i]
           , strideSize, (void*)offset);
       }
 
@@ -360,4 +409,35 @@ namespace NightEngine::Rendering::Opengl
     }
   }
 
+  void VertexArrayObject::SetupSkinAttribute(BufferMode mode)
+  {
+    if (m_skinVertices.empty())
+    {
+      return;
+    }
+
+    //A released or copied VAO generate its own buffer
+    if (m_skinBufferID == (~0u)
+      || !IS_ALLOCATED(VertexArrayObjectSkinBuffer, m_skinBufferID))
+    {
+      glGenBuffers(1, &m_skinBufferID);
+      INCREMENT_ALLOCATION(VertexArrayObjectSkinBuffer, m_skinBufferID);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_skinBufferID);
+    glBufferData(GL_ARRAY_BUFFER, m_skinVertices.size() * sizeof(SkinVertex)
+      , m_skinVertices.data(), static_cast<GLenum>(mode));
+
+    //Bone indices stay integers, weights are normalized to [0, 1]
+    glEnableVertexAttribArray(SkinVertex::c_BONES_LOCATION);
+    glVertexAttribIPointer(SkinVertex::c_BONES_LOCATION, 4, GL_UNSIGNED_BYTE
+      , sizeof(SkinVertex), (void*)offsetof(SkinVertex, m_bones));
+    glEnableVertexAttribArray(SkinVertex::c_WEIGHTS_LOCATION);
+    glVertexAttribPointer(SkinVertex::c_WEIGHTS_LOCATION, 4, GL_UNSIGNED_BYTE, true
+      , sizeof(SkinVertex), (void*)offsetof(SkinVertex, m_weights));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CHECKGL_ERROR();
+  }
+
 } // Rendering
@@ -7,6 +7,8 @@
 
 #include "Graphics/Opengl/VertexBufferObject.hpp"
 #include "Graphics/Opengl/ElementBufferObject.hpp"
+#include "Graphics/Opengl/Vertex.hpp"
+#include "Graphics/Opengl/VertexFormat.hpp"
 
 // System Headers
 #include <glad/glad.h>
@@ -29,7 +31,7 @@ namespace NightEngine::Rendering::Opengl
 	{
 	public:
     //! @brief Constructor
-		VertexArrayObject(void) : m_objectID(~0u), m_instanceBufferID(~0u){}
+		VertexArrayObject(void) : m_objectID(~0u), m_instanceBufferID(~0u), m_skinBufferID(~0u){}
 
     //! @brief Constructor
     VertexArrayObject(BufferMode mode
@@ -65,6 +67,20 @@ namespace NightEngine::Rendering::Opengl
     void FillData(const std::vector<Vertex>& vertexArray
       , const std::vector<unsigned>& indexArray);
 
+    //! @brief Fill vertices encoded in format, their attributes follow the format on Build
+    void FillData(const VertexFormat& format
+      , const Container::U8* vertexBytes, size_t vertexByteSize
+      , const unsigned* indexArray, size_t indexArraySize);
+
+    //! @brief Layout of the filled vertices
+    const VertexFormat& GetFormat(void) const { return m_format; }
+
+    //! @brief Fill bone influences, one per vertex, uploaded on the next Build
+    void FillSkin(const SkinVertex* skinArray, size_t skinArraySize);
+
+    //! @brief Check if bone influences were filled
+    bool IsSkinned(void) const { return !m_skinVertices.empty(); }
+
     //! @brief Clear Data
     void Clear(void);
     /////////////////////////////////////////////////////////
@@ -125,8 +141,14 @@ namespace NightEngine::Rendering::Opengl
     //! @brief Setup Attribute Pointer using AttributePointerInfo
     void SetupAttributePointer(AttributePointerInfo& attributeInfo);
 
+    //! @brief Upload the bone influences and point the skin attributes at them
+    void SetupSkinAttribute(BufferMode mode);
+
     GLuint m_objectID;
     GLuint m_instanceBufferID;
+    GLuint m_skinBufferID;
+    std::vector<SkinVertex> m_skinVertices;
+    VertexFormat m_format;
 		VertexBufferObject m_vbo;
 		ElementBufferObject m_ebo;
 	};
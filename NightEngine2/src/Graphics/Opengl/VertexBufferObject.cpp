@@ -10,6 +10,8 @@
 #include "Graphics/Opengl/Vertex.hpp"
 #include "Core/Macros.hpp"
 
+#include <cstring>
+
 namespace NightEngine::Rendering::Opengl
 {
   static void ReleaseVBOID(GLuint shaderID)
@@ -90,6 +92,16 @@ namespace NightEngine::Rendering::Opengl
 		}
 	}
 
+  void VertexBufferObject::FillVertexBytes(const void* data, size_t byteSize)
+  {
+    //Every VertexFormat stride is a multiple of float
+    ASSERT_TRUE(byteSize % sizeof(float) == 0);
+
+    size_t begin = m_vertices.size();
+    m_vertices.resize(begin + byteSize / sizeof(float));
+    std::memcpy(m_vertices.data() + begin, data, byteSize);
+  }
+
 	void VertexBufferObject::AddVertex(const Vertex & vertex)
 	{
 		m_vertices.emplace_back(vertex.m_position.x);
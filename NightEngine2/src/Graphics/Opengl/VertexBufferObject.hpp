@@ -52,6 +52,9 @@ namespace NightEngine::Rendering::Opengl
 
     //! @brief Fill Vertex with array
     void FillVertex(const Vertex* vertexArray, size_t arraySize);
+
+    //! @brief Fill Vertex with encoded vertices, byteSize is a multiple of float
+    void FillVertexBytes(const void* data, size_t byteSize);
 		
     //! @brief Add Vertex
     void AddVertex(const Vertex& vertex);
@@ -0,0 +1,513 @@
+/*!
+  @file VertexFormat.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of VertexFormat
+*/
+#include "Graphics/Opengl/VertexFormat.hpp"
+#include "Graphics/Opengl/Shader.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Opengl
+{
+  static const float c_UNORM16_MAX = 65535.0f;
+  static const float c_SNORM16_MAX = 32767.0f;
+
+  //Bits of u_vertexFormat in mesh_vertex.glsl
+  static const int c_OCTAHEDRAL_NORMAL_BIT = 1;
+  static const int c_OCTAHEDRAL_TANGENT_BIT = 2;
+
+  static size_t GetPositionSize(PositionEncoding encoding)
+  {
+    return encoding == PositionEncoding::UNORM16 ? sizeof(U16) * 4 : sizeof(float) * 3;
+  }
+
+  static size_t GetDirectionSize(DirectionEncoding encoding)
+  {
+    return encoding == DirectionEncoding::OCTAHEDRAL ? sizeof(I16) * 2 : sizeof(float) * 3;
+  }
+
+  static size_t GetTexCoordSize(TexCoordEncoding encoding)
+  {
+    return encoding == TexCoordEncoding::FLOAT2 ? sizeof(float) * 2 : sizeof(U16) * 2;
+  }
+
+  static U16 ToUnorm16(float value)
+  {
+    return static_cast<U16>(std::lround(glm::clamp(value, 0.0f, 1.0f) * c_UNORM16_MAX));
+  }
+
+  static float FromUnorm16(U16 value)
+  {
+    return static_cast<float>(value) / c_UNORM16_MAX;
+  }
+
+  //! @brief Same as GL normalized SHORT
+  static float FromSnorm16(I16 value)
+  {
+    return std::max(static_cast<float>(value) / c_SNORM16_MAX, -1.0f);
+  }
+
+  //! @brief Encoded direction whose decoding is the closest, out of the 4 roundings
+  static void EncodeDirection(const glm::vec3& direction, I16 output[2])
+  {
+    glm::vec2 encoded = VertexEncoding::EncodeOctahedral(direction) * c_SNORM16_MAX;
+    glm::vec2 base = glm::floor(encoded);
+    glm::vec3 unit = glm::length(direction) > 0.0f ? glm::normalize(direction) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    float bestDot = -2.0f;
+    for (int i = 0; i < 4; ++i)
+    {
+      glm::vec2 candidate = glm::clamp(base + glm::vec2(i & 1, i >> 1), -c_SNORM16_MAX, c_SNORM16_MAX);
+      I16 x = static_cast<I16>(candidate.x);
+      I16 y = static_cast<I16>(candidate.y);
+      float dot = glm::dot(unit, VertexEncoding::DecodeOctahedral(
+        glm::vec2(FromSnorm16(x), FromSnorm16(y))));
+      if (dot > bestDot)
+      {
+        bestDot = dot;
+        output[0] = x;
+        output[1] = y;
+      }
+    }
+  }
+
+  static glm::vec3 DecodeDirection(const U8* data)
+  {
+    I16 encoded[2];
+    std::memcpy(encoded, data, sizeof(encoded));
+    return VertexEncoding::DecodeOctahedral(glm::vec2(FromSnorm16(encoded[0]), FromSnorm16(encoded[1])));
+  }
+
+  //! @brief Write then move the cursor
+  template<typename T>
+  static void Write(U8*& cursor, const T* values, size_t count)
+  {
+    std::memcpy(cursor, values, sizeof(T) * count);
+    cursor += sizeof(T) * count;
+  }
+
+  template<typename T>
+  static void Read(const U8*& cursor, T* values, size_t count)
+  {
+    std::memcpy(values, cursor, sizeof(T) * count);
+    cursor += sizeof(T) * count;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  size_t VertexFormat::GetStride(void) const
+  {
+    return GetPositionSize(m_position) + GetDirectionSize(m_normal)
+      + GetTexCoordSize(m_texCoord) + GetDirectionSize(m_tangent);
+  }
+
+  AttributePointerInfo VertexFormat::GetAttributePointerInfo(void) const
+  {
+    bool octahedralNormal = m_normal == DirectionEncoding::OCTAHEDRAL;
+    bool octahedralTangent = m_tangent == DirectionEncoding::OCTAHEDRAL;
+
+    AttributeType texCoordType = m_texCoord == TexCoordEncoding::HALF2 ? AttributeType::HALF_FLOAT
+      : m_texCoord == TexCoordEncoding::UNORM16 ? AttributeType::UNSIGNED_SHORT : AttributeType::FLOAT;
+
+    return AttributePointerInfo{ 5
+      , std::vector<unsigned>{ 3, octahedralNormal ? 2u : 3u, 2, octahedralTangent ? 2u : 3u, 16 }
+      , std::vector<size_t>{ GetPositionSize(m_position), GetDirectionSize(m_normal)
+        , GetTexCoordSize(m_texCoord), GetDirectionSize(m_tangent), sizeof(glm::mat4) }
+      , std::vector<bool>{ m_position == PositionEncoding::UNORM16, octahedralNormal
+        , m_texCoord == TexCoordEncoding::UNORM16, true, false }
+      , std::vector<int>{ 0, 0, 0, 0, 1 }
+      , std::vector<AttributeType>{ m_position == PositionEncoding::UNORM16
+          ? AttributeType::UNSIGNED_SHORT : AttributeType::FLOAT
+        , octahedralNormal ? AttributeType::SHORT : AttributeType::FLOAT
+        , texCoordType
+        , octahedralTangent ? AttributeType::SHORT : AttributeType::FLOAT
+        , AttributeType::FLOAT } };
+  }
+
+  U32 VertexFormat::Pack(void) const
+  {
+    return static_cast<U32>(m_position) | (static_cast<U32>(m_normal) << 2)
+      | (static_cast<U32>(m_texCoord) << 4) | (static_cast<U32>(m_tangent) << 6);
+  }
+
+  bool VertexFormat::Unpack(U32 value, VertexFormat& format)
+  {
+    U32 position = value & 3;
+    U32 normal = (value >> 2) & 3;
+    U32 texCoord = (value >> 4) & 3;
+    U32 tangent = (value >> 6) & 3;
+    if ((value >> 8) != 0 || position > 1 || normal > 1 || texCoord > 2 || tangent > 1)
+    {
+      return false;
+    }
+
+    format.m_position = static_cast<PositionEncoding>(position);
+    format.m_normal = static_cast<DirectionEncoding>(normal);
+    format.m_texCoord = static_cast<TexCoordEncoding>(texCoord);
+    format.m_tangent = static_cast<DirectionEncoding>(tangent);
+    return true;
+  }
+
+  VertexFormat VertexFormat::Choose(const Vertex* vertices, size_t count
+    , const VertexFormatSettings& settings)
+  {
+    VertexFormat format;
+    if (count == 0)
+    {
+      return format;
+    }
+
+    glm::vec3 minPosition = vertices[0].m_position;
+    glm::vec3 maxPosition = minPosition;
+    glm::vec2 minTexCoord = vertices[0].m_texCoord;
+    glm::vec2 maxTexCoord = minTexCoord;
+    for (size_t i = 0; i < count; ++i)
+    {
+      minPosition = glm::min(minPosition, vertices[i].m_position);
+      maxPosition = glm::max(maxPosition, vertices[i].m_position);
+      minTexCoord = glm::min(minTexCoord, vertices[i].m_texCoord);
+      maxTexCoord = glm::max(maxTexCoord, vertices[i].m_texCoord);
+    }
+
+    //Rounding error is half a step
+    glm::vec3 extent = maxPosition - minPosition;
+    float positionError = std::max(extent.x, std::max(extent.y, extent.z)) * 0.5f / c_UNORM16_MAX;
+    if (settings.m_quantizePositions && positionError <= settings.m_maxPositionError)
+    {
+      format.m_position = PositionEncoding::UNORM16;
+    }
+
+    if (settings.m_octahedralDirections)
+    {
+      format.m_normal = DirectionEncoding::OCTAHEDRAL;
+      format.m_tangent = DirectionEncoding::OCTAHEDRAL;
+    }
+
+    //Inside the bounds beat half float, whose step is 1/2048 of the magnitude,
+    //HALF2 is for formats picked without looking at the vertices
+    glm::vec2 range = maxTexCoord - minTexCoord;
+    if (std::max(range.x, range.y) * 0.5f / c_UNORM16_MAX <= settings.m_maxTexCoordError)
+    {
+      format.m_texCoord = TexCoordEncoding::UNORM16;
+    }
+    return format;
+  }
+
+  VertexFormat VertexFormat::Compact(void)
+  {
+    VertexFormat format;
+    format.m_normal = DirectionEncoding::OCTAHEDRAL;
+    format.m_texCoord = TexCoordEncoding::HALF2;
+    format.m_tangent = DirectionEncoding::OCTAHEDRAL;
+    return format;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  namespace VertexEncoding
+  {
+    glm::vec2 EncodeOctahedral(const glm::vec3& direction)
+    {
+      float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+      if (sum <= 0.0f)
+      {
+        return glm::vec2(0.0f);
+      }
+
+      glm::vec3 n = direction / sum;
+      if (n.z >= 0.0f)
+      {
+        return glm::vec2(n.x, n.y);
+      }
+
+      //Lower half fold over the diagonals
+      return glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f)
+        , (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+    }
+
+    glm::vec3 DecodeOctahedral(const glm::vec2& encoded)
+    {
+      glm::vec3 n{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+      float t = std::max(-n.z, 0.0f);
+      n.x += n.x >= 0.0f ? -t : t;
+      n.y += n.y >= 0.0f ? -t : t;
+      return glm::normalize(n);
+    }
+
+    U16 FloatToHalf(float value)
+    {
+      U32 bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      U32 sign = (bits >> 16) & 0x8000;
+      U32 absolute = bits & 0x7FFFFFFF;
+
+      if (absolute > 0x7F800000)
+      {
+        return static_cast<U16>(sign | 0x7E00);     //NaN
+      }
+      if (absolute >= 0x477FE000)
+      {
+        return static_cast<U16>(sign | 0x7BFF);     //Saturate at 65504
+      }
+
+      //Subnormal half, round to nearest even on the shifted out bits
+      if (absolute < 0x38800000)
+      {
+        if (absolute < 0x33000000)
+        {
+          return static_cast<U16>(sign);
+        }
+
+        U32 mantissa = (absolute & 0x7FFFFF) | 0x800000;
+        U32 shift = 126 - (absolute >> 23);
+        U32 half = mantissa >> shift;
+        U32 remainder = mantissa & ((1u << shift) - 1);
+        U32 halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+        {
+          ++half;
+        }
+        return static_cast<U16>(sign | half);
+      }
+
+      //Rebias the exponent, a mantissa carry move into the exponent correctly
+      U32 half = (absolute - 0x38000000) >> 13;
+      U32 remainder = absolute & 0x1FFF;
+      if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+      {
+        ++half;
+      }
+      return static_cast<U16>(sign | std::min(half, 0x7BFFu));
+    }
+
+    float HalfToFloat(U16 half)
+    {
+      U32 sign = static_cast<U32>(half & 0x8000) << 16;
+      U32 exponent = (half >> 10) & 0x1F;
+      U32 mantissa = half & 0x3FF;
+
+      U32 bits;
+      if (exponent == 0)
+      {
+        float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign != 0 ? -value : value;
+      }
+      else if (exponent == 31)
+      {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+      }
+      else
+      {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+      }
+
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+    }
+
+    VertexQuantization ComputeQuantization(const VertexFormat& format
+      , const Vertex* vertices, size_t count)
+    {
+      VertexQuantization quantization;
+      if (count == 0)
+      {
+        return quantization;
+      }
+
+      if (format.m_position == PositionEncoding::UNORM16)
+      {
+        glm::vec3 minPosition = vertices[0].m_position;
+        glm::vec3 maxPosition = minPosition;
+        for (size_t i = 0; i < count; ++i)
+        {
+          minPosition = glm::min(minPosition, vertices[i].m_position);
+          maxPosition = glm::max(maxPosition, vertices[i].m_position);
+        }
+        quantization.m_positionOffset = minPosition;
+        quantization.m_positionScale = maxPosition - minPosition;
+      }
+
+      if (format.m_texCoord == TexCoordEncoding::UNORM16)
+      {
+        glm::vec2 minTexCoord = vertices[0].m_texCoord;
+        glm::vec2 maxTexCoord = minTexCoord;
+        for (size_t i = 0; i < count; ++i)
+        {
+          minTexCoord = glm::min(minTexCoord, vertices[i].m_texCoord);
+          maxTexCoord = glm::max(maxTexCoord, vertices[i].m_texCoord);
+        }
+        quantization.m_texCoordDecode = glm::vec4(minTexCoord, maxTexCoord - minTexCoord);
+      }
+      return quantization;
+    }
+
+    void EncodeVertices(const VertexFormat& format, const VertexQuantization& quantization
+      , const Vertex* vertices, size_t count, std::vector<U8>& output)
+    {
+      size_t stride = format.GetStride();
+      output.resize(stride * count);
+
+      //A flat axis store 0, it decode back to the offset
+      glm::vec3 positionScale = quantization.m_positionScale;
+      glm::vec3 invPositionScale{ positionScale.x != 0.0f ? 1.0f / positionScale.x : 0.0f
+        , positionScale.y != 0.0f ? 1.0f / positionScale.y : 0.0f
+        , positionScale.z != 0.0f ? 1.0f / positionScale.z : 0.0f };
+      glm::vec2 texCoordScale{ quantization.m_texCoordDecode.z, quantization.m_texCoordDecode.w };
+      glm::vec2 invTexCoordScale{ texCoordScale.x != 0.0f ? 1.0f / texCoordScale.x : 0.0f
+        , texCoordScale.y != 0.0f ? 1.0f / texCoordScale.y : 0.0f };
+
+      U8* cursor = output.data();
+      for (size_t i = 0; i < count; ++i)
+      {
+        const Vertex& vertex = vertices[i];
+
+        if (format.m_position == PositionEncoding::UNORM16)
+        {
+          glm::vec3 unit = (vertex.m_position - quantization.m_positionOffset) * invPositionScale;
+          U16 position[4] = { ToUnorm16(unit.x), ToUnorm16(unit.y), ToUnorm16(unit.z), 0 };
+          Write(cursor, position, 4);
+        }
+        else
+        {
+          Write(cursor, &vertex.m_position.x, 3);
+        }
+
+        if (format.m_normal == DirectionEncoding::OCTAHEDRAL)
+        {
+          I16 normal[2];
+          EncodeDirection(vertex.m_normal, normal);
+          Write(cursor, normal, 2);
+        }
+        else
+        {
+          Write(cursor, &vertex.m_normal.x, 3);
+        }
+
+        if (format.m_texCoord == TexCoordEncoding::UNORM16)
+        {
+          glm::vec2 unit = (vertex.m_texCoord - glm::vec2(quantization.m_texCoordDecode)) * invTexCoordScale;
+          U16 texCoord[2] = { ToUnorm16(unit.x), ToUnorm16(unit.y) };
+          Write(cursor, texCoord, 2);
+        }
+        else if (format.m_texCoord == TexCoordEncoding::HALF2)
+        {
+          U16 texCoord[2] = { FloatToHalf(vertex.m_texCoord.x), FloatToHalf(vertex.m_texCoord.y) };
+          Write(cursor, texCoord, 2);
+        }
+        else
+        {
+          Write(cursor, &vertex.m_texCoord.x, 2);
+        }
+
+        if (format.m_tangent == DirectionEncoding::OCTAHEDRAL)
+        {
+          I16 tangent[2];
+          EncodeDirection(vertex.m_tangent, tangent);
+          Write(cursor, tangent, 2);
+        }
+        else
+        {
+          Write(cursor, &vertex.m_tangent.x, 3);
+        }
+      }
+    }
+
+    glm::vec3 DecodePosition(const VertexFormat& format, const VertexQuantization& quantization
+      , const U8* data)
+    {
+      if (format.m_position == PositionEncoding::UNORM16)
+      {
+        U16 position[3];
+        std::memcpy(position, data, sizeof(position));
+        return quantization.m_positionOffset + quantization.m_positionScale
+          * glm::vec3(FromUnorm16(position[0]), FromUnorm16(position[1]), FromUnorm16(position[2]));
+      }
+
+      glm::vec3 position;
+      std::memcpy(&position.x, data, sizeof(float) * 3);
+      return position;
+    }
+
+    Vertex DecodeVertex(const VertexFormat& format, const VertexQuantization& quantization
+      , const U8* data)
+    {
+      Vertex vertex;
+      const U8* cursor = data;
+
+      if (format.m_position == PositionEncoding::UNORM16)
+      {
+        U16 position[4];
+        Read(cursor, position, 4);
+        vertex.m_position = quantization.m_positionOffset + quantization.m_positionScale
+          * glm::vec3(FromUnorm16(position[0]), FromUnorm16(position[1]), FromUnorm16(position[2]));
+      }
+      else
+      {
+        Read(cursor, &vertex.m_position.x, 3);
+      }
+
+      if (format.m_normal == DirectionEncoding::OCTAHEDRAL)
+      {
+        vertex.m_normal = DecodeDirection(cursor);
+        cursor += sizeof(I16) * 2;
+      }
+      else
+      {
+        Read(cursor, &vertex.m_normal.x, 3);
+      }
+
+      if (format.m_texCoord == TexCoordEncoding::UNORM16)
+      {
+        U16 texCoord[2];
+        Read(cursor, texCoord, 2);
+        vertex.m_texCoord = glm::vec2(quantization.m_texCoordDecode)
+          + glm::vec2(quantization.m_texCoordDecode.z, quantization.m_texCoordDecode.w)
+          * glm::vec2(FromUnorm16(texCoord[0]), FromUnorm16(texCoord[1]));
+      }
+      else if (format.m_texCoord == TexCoordEncoding::HALF2)
+      {
+        U16 texCoord[2];
+        Read(cursor, texCoord, 2);
+        vertex.m_texCoord = glm::vec2(HalfToFloat(texCoord[0]), HalfToFloat(texCoord[1]));
+      }
+      else
+      {
+        Read(cursor, &vertex.m_texCoord.x, 2);
+      }
+
+      if (format.m_tangent == DirectionEncoding::OCTAHEDRAL)
+      {
+        vertex.m_tangent = DecodeDirection(cursor);
+      }
+      else
+      {
+        Read(cursor, &vertex.m_tangent.x, 3);
+      }
+      return vertex;
+    }
+
+    void SetUniforms(const Shader& shader, const VertexFormat& format
+      , const VertexQuantization& quantization)
+    {
+      int flags = (format.m_normal == DirectionEncoding::OCTAHEDRAL ? c_OCTAHEDRAL_NORMAL_BIT : 0)
+        | (format.m_tangent == DirectionEncoding::OCTAHEDRAL ? c_OCTAHEDRAL_TANGENT_BIT : 0);
+
+      //Always set, the previous mesh drawn with the program may be quantized.
+      //Locations are cached at link, no string lookup per draw
+      shader.SetDrawUniform(DrawUniform::VERTEX_FORMAT, flags);
+      shader.SetDrawUniform(DrawUniform::POSITION_OFFSET, quantization.m_positionOffset);
+      shader.SetDrawUniform(DrawUniform::POSITION_SCALE, quantization.m_positionScale);
+      shader.SetDrawUniform(DrawUniform::TEXCOORD_DECODE, quantization.m_texCoordDecode);
+    }
+  }
+}
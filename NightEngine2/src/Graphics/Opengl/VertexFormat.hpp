@@ -0,0 +1,128 @@
+/*!
+  @file VertexFormat.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of VertexFormat
+*/
+#pragma once
+
+#include "Graphics/Opengl/Vertex.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec4.hpp>
+
+#include <vector>
+
+namespace NightEngine::Rendering::Opengl
+{
+  //! @brief How the position is stored
+  enum class PositionEncoding : Container::U8
+  {
+    FLOAT3 = 0,
+    UNORM16         //4 x U16 inside the mesh bounds, the 4th is padding
+  };
+
+  //! @brief How the normal and the tangent are stored
+  enum class DirectionEncoding : Container::U8
+  {
+    FLOAT3 = 0,
+    OCTAHEDRAL      //2 x I16 on the octahedron folded onto a square
+  };
+
+  //! @brief How the texture coordinate is stored
+  enum class TexCoordEncoding : Container::U8
+  {
+    FLOAT2 = 0,
+    HALF2,
+    UNORM16         //2 x U16 inside the uv bounds of the mesh
+  };
+
+  //! @brief Error the cooker accept when picking a VertexFormat
+  struct VertexFormatSettings
+  {
+    bool  m_quantizePositions = true;
+    bool  m_octahedralDirections = true;
+    float m_maxPositionError = 0.0005f;      //Mesh unit, half a millimeter for meter scale
+    float m_maxTexCoordError = 1.0f / 8192.0f; //A quarter texel of a 2048 texture
+  };
+
+  //! @brief Offset and scale of the quantized attributes of a mesh, decoded = offset + scale * stored
+  struct VertexQuantization
+  {
+    glm::vec3 m_positionOffset{ 0.0f };
+    glm::vec3 m_positionScale{ 1.0f };
+    glm::vec4 m_texCoordDecode{ 0.0f, 0.0f, 1.0f, 1.0f };   //xy offset, zw scale
+  };
+
+  //! @brief Layout of the vertices of a mesh, with the attributes at the locations of Vertex.
+  // The default is the 44 bytes all float Vertex, the compact ones are decoded in
+  // ShaderLibrary/mesh_vertex.glsl with the uniforms set by SetUniforms.
+  struct VertexFormat
+  {
+    PositionEncoding  m_position = PositionEncoding::FLOAT3;
+    DirectionEncoding m_normal = DirectionEncoding::FLOAT3;
+    TexCoordEncoding  m_texCoord = TexCoordEncoding::FLOAT2;
+    DirectionEncoding m_tangent = DirectionEncoding::FLOAT3;
+
+    //! @brief Bytes per vertex
+    size_t GetStride(void) const;
+
+    //! @brief Attributes of the buffer, followed by the instance matrix like Vertex
+    AttributePointerInfo GetAttributePointerInfo(void) const;
+
+    //! @brief Check if this is the Vertex layout
+    bool IsDefault(void) const { return Pack() == 0; }
+
+    //! @brief Store in a cooked file
+    Container::U32 Pack(void) const;
+
+    //! @brief Read from a cooked file, false if the value isn't a format
+    static bool Unpack(Container::U32 value, VertexFormat& format);
+
+    //! @brief Smallest format keeping the vertices within the error of settings
+    static VertexFormat Choose(const Vertex* vertices, size_t count
+      , const VertexFormatSettings& settings = VertexFormatSettings());
+
+    //! @brief Octahedral normals and tangents, half uv, float positions
+    static VertexFormat Compact(void);
+
+    bool operator==(const VertexFormat& rhs) const { return Pack() == rhs.Pack(); }
+
+    bool operator!=(const VertexFormat& rhs) const { return Pack() != rhs.Pack(); }
+  };
+
+  class Shader;
+
+  namespace VertexEncoding
+  {
+    //! @brief Unit vector to the octahedron square, both in [-1, 1]
+    glm::vec2 EncodeOctahedral(const glm::vec3& direction);
+
+    //! @brief Octahedron square back to a unit vector
+    glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+
+    //! @brief Round to the nearest half float, out of range values saturate
+    Container::U16 FloatToHalf(float value);
+
+    float HalfToFloat(Container::U16 half);
+
+    //! @brief Bounds of the quantized attributes of format over the vertices
+    VertexQuantization ComputeQuantization(const VertexFormat& format
+      , const Vertex* vertices, size_t count);
+
+    //! @brief Pack count vertices, GetStride() bytes each, into output
+    void EncodeVertices(const VertexFormat& format, const VertexQuantization& quantization
+      , const Vertex* vertices, size_t count, std::vector<Container::U8>& output);
+
+    //! @brief Position of one vertex of EncodeVertices, it is always first
+    glm::vec3 DecodePosition(const VertexFormat& format, const VertexQuantization& quantization
+      , const Container::U8* data);
+
+    //! @brief Unpack one vertex of EncodeVertices
+    Vertex DecodeVertex(const VertexFormat& format, const VertexQuantization& quantization
+      , const Container::U8* data);
+
+    //! @brief Set the decoding uniforms of mesh_vertex.glsl, shaders without them ignore it
+    void SetUniforms(const Shader& shader, const VertexFormat& format
+      , const VertexQuantization& quantization);
+  }
+}
@@ -0,0 +1,200 @@
+/*!
+  @file Emitter.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of Emitter
+*/
+#include "Graphics/Particles/Emitter.hpp"
+#include "Core/Utility/SimdFloat4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+using namespace NightEngine::Simd;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering::Particles
+{
+  using Stream = ParticlePool::Stream;
+
+  //! @brief Float bits that order like the floats when compared as unsigned
+  static U32 ToSortable(float value)
+  {
+    U32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+  }
+
+  //! @brief LSD radix sort of the keys by their high 32 bits, 11 bits per pass.
+  // The histograms of every pass are built in one read, passes where every key
+  // fall in the same bucket are skipped
+  static void RadixSortHigh32(Vector<U64>& keys, Vector<U64>& scratch)
+  {
+    const int c_PASS_BITS[3] = { 11, 11, 10 };
+    const int c_PASS_SHIFT[3] = { 32, 43, 54 };
+    U32 histograms[3][1 << 11] = {};
+    for (U64 key : keys)
+    {
+      ++histograms[0][(key >> 32) & 0x7FF];
+      ++histograms[1][(key >> 43) & 0x7FF];
+      ++histograms[2][key >> 54];
+    }
+
+    scratch.resize(keys.size());
+    for (int pass = 0; pass < 3; ++pass)
+    {
+      U32* offsets = histograms[pass];
+      const int shift = c_PASS_SHIFT[pass];
+      const U64 mask = (U64(1) << c_PASS_BITS[pass]) - 1;
+      if (keys.empty() || offsets[(keys[0] >> shift) & mask] == keys.size())
+      {
+        continue;
+      }
+
+      U32 sum = 0;
+      for (size_t bucket = 0; bucket < (size_t(1) << c_PASS_BITS[pass]); ++bucket)
+      {
+        U32 count = offsets[bucket];
+        offsets[bucket] = sum;
+        sum += count;
+      }
+      for (U64 key : keys)
+      {
+        scratch[offsets[(key >> shift) & mask]++] = key;
+      }
+      std::swap(keys, scratch);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void Emitter::Initialize(const EmitterSettings& settings, U32 seed)
+  {
+    m_settings = settings;
+    m_pool.Reserve(settings.m_maxParticles);
+    m_spawnAccumulator = 0.0f;
+    m_random = seed != 0 ? seed : 1;
+  }
+
+  void Emitter::Burst(size_t count)
+  {
+    SpawnParticles(count);
+  }
+
+  void Emitter::Emit(float dt)
+  {
+    ParticleKernels::KillExpired(m_pool);
+
+    m_spawnAccumulator += m_settings.m_rate * dt;
+    float spawnCount = std::floor(m_spawnAccumulator);
+    m_spawnAccumulator -= spawnCount;
+    SpawnParticles(static_cast<size_t>(spawnCount));
+  }
+
+  void Emitter::Simulate(float dt, size_t begin, size_t end)
+  {
+    end = std::min(end, m_pool.GetCount());
+    if (begin >= end)
+    {
+      return;
+    }
+
+    ParticleKernels::Integrate(m_pool, begin, end, m_settings.m_acceleration
+      , m_settings.m_drag, dt);
+    if (!m_planes.empty())
+    {
+      ParticleKernels::CollidePlanes(m_pool, begin, end, m_planes.data(), m_planes.size()
+        , m_settings.m_restitution);
+    }
+  }
+
+  void Emitter::Update(float dt)
+  {
+    Emit(dt);
+    Simulate(dt, 0, m_pool.GetCount());
+  }
+
+  size_t Emitter::WriteInstances(const glm::vec3& cameraPosition, const glm::vec3& cameraForward
+    , ParticleInstance* output)
+  {
+    const float* px = m_pool.GetStream(Stream::POSITION_X);
+    const float* py = m_pool.GetStream(Stream::POSITION_Y);
+    const float* pz = m_pool.GetStream(Stream::POSITION_Z);
+    const float* age = m_pool.GetStream(Stream::AGE);
+    const float* invLifetime = m_pool.GetStream(Stream::INV_LIFETIME);
+    size_t count = m_pool.GetCount();
+
+    //View depth 4 at a time, the farthest particles get the smallest keys
+    const Float4 cameraX = Splat(cameraPosition.x);
+    const Float4 cameraY = Splat(cameraPosition.y);
+    const Float4 cameraZ = Splat(cameraPosition.z);
+    const Float4 forwardX = Splat(cameraForward.x);
+    const Float4 forwardY = Splat(cameraForward.y);
+    const Float4 forwardZ = Splat(cameraForward.z);
+    m_sortKeys.resize(count);
+    for (size_t i = 0; i < count; i += 4)
+    {
+      alignas(16) float depth[4];
+      Store(MulAdd(Load(px + i) - cameraX, forwardX, MulAdd(Load(py + i) - cameraY, forwardY
+        , (Load(pz + i) - cameraZ) * forwardZ)), depth);
+      for (size_t lane = 0; lane < 4 && i + lane < count; ++lane)
+      {
+        m_sortKeys[i + lane] = (U64(~ToSortable(depth[lane])) << 32) | U64(i + lane);
+      }
+    }
+    RadixSortHigh32(m_sortKeys, m_sortScratch);
+
+    const EmitterSettings& settings = m_settings;
+    for (size_t i = 0; i < count; ++i)
+    {
+      size_t index = static_cast<size_t>(m_sortKeys[i] & 0xFFFFFFFFu);
+      float t = std::min(age[index] * invLifetime[index], 1.0f);
+
+      ParticleInstance& instance = output[i];
+      instance.m_positionSize = glm::vec4(px[index], py[index], pz[index]
+        , settings.m_startSize + (settings.m_endSize - settings.m_startSize) * t);
+      instance.m_color = settings.m_startColor + (settings.m_endColor - settings.m_startColor) * t;
+    }
+    return count;
+  }
+
+  void Emitter::SpawnParticles(size_t count)
+  {
+    size_t spawned = 0;
+    size_t first = m_pool.Spawn(count, spawned);
+
+    float* px = m_pool.GetStream(Stream::POSITION_X);
+    float* py = m_pool.GetStream(Stream::POSITION_Y);
+    float* pz = m_pool.GetStream(Stream::POSITION_Z);
+    float* vx = m_pool.GetStream(Stream::VELOCITY_X);
+    float* vy = m_pool.GetStream(Stream::VELOCITY_Y);
+    float* vz = m_pool.GetStream(Stream::VELOCITY_Z);
+    float* age = m_pool.GetStream(Stream::AGE);
+    float* invLifetime = m_pool.GetStream(Stream::INV_LIFETIME);
+
+    const EmitterSettings& settings = m_settings;
+    for (size_t i = first; i < first + spawned; ++i)
+    {
+      px[i] = m_position.x;
+      py[i] = m_position.y;
+      pz[i] = m_position.z;
+      vx[i] = settings.m_velocity.x + (Random() * 2.0f - 1.0f) * settings.m_velocitySpread;
+      vy[i] = settings.m_velocity.y + (Random() * 2.0f - 1.0f) * settings.m_velocitySpread;
+      vz[i] = settings.m_velocity.z + (Random() * 2.0f - 1.0f) * settings.m_velocitySpread;
+      age[i] = 0.0f;
+
+      float lifetime = settings.m_lifetimeMin
+        + (settings.m_lifetimeMax - settings.m_lifetimeMin) * Random();
+      invLifetime[i] = 1.0f / std::max(lifetime, 1e-4f);
+    }
+  }
+
+  float Emitter::Random(void)
+  {
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return (m_random >> 8) * (1.0f / 16777216.0f);
+  }
+}
@@ -0,0 +1,99 @@
+/*!
+  @file Emitter.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of Emitter
+*/
+#pragma once
+
+#include "Graphics/Particles/ParticlePool.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec4.hpp>
+
+namespace NightEngine::Rendering::Particles
+{
+  //! @brief What an emitter spawn and how its particles move
+  struct EmitterSettings
+  {
+    float     m_rate = 100.0f;                          //Particles per second
+    float     m_lifetimeMin = 1.0f;
+    float     m_lifetimeMax = 2.0f;
+    glm::vec3 m_velocity{ 0.0f, 2.0f, 0.0f };
+    float     m_velocitySpread = 1.0f;                  //Random offset added per axis
+    glm::vec3 m_acceleration{ 0.0f, -9.8f, 0.0f };
+    float     m_drag = 0.0f;
+    float     m_restitution = 0.5f;
+    float     m_startSize = 0.1f;
+    float     m_endSize = 0.0f;
+    glm::vec4 m_startColor{ 1.0f };
+    glm::vec4 m_endColor{ 1.0f, 1.0f, 1.0f, 0.0f };
+    size_t    m_maxParticles = 10000;
+  };
+
+  //! @brief Instance data of one particle billboard
+  struct ParticleInstance
+  {
+    glm::vec4 m_positionSize;   //xyz world position, w size
+    glm::vec4 m_color;
+  };
+
+  //! @brief Spawn and simulate the particles of one effect. An emitter is only
+  // touched by one thread at a time, except Simulate over disjoint ranges.
+  class Emitter
+  {
+    public:
+      //! @brief Size the pool, seed make the spawned particles repeatable
+      void Initialize(const EmitterSettings& settings, Container::U32 seed = 1);
+
+      const EmitterSettings& GetSettings(void) const { return m_settings; }
+
+      //! @brief Where new particles start, in world space
+      void SetPosition(const glm::vec3& position) { m_position = position; }
+
+      const glm::vec3& GetPosition(void) const { return m_position; }
+
+      //! @brief Add a plane the particles bounce on
+      void AddPlane(const ParticlePlane& plane) { m_planes.emplace_back(plane); }
+
+      void ClearPlanes(void) { m_planes.clear(); }
+
+      //! @brief Spawn count particles now, on top of the rate
+      void Burst(size_t count);
+
+      //! @brief Kill the expired particles and spawn the ones due this frame
+      void Emit(float dt);
+
+      //! @brief Integrate and collide the particles [begin, end), begin is a multiple of 4
+      void Simulate(float dt, size_t begin, size_t end);
+
+      //! @brief Emit then Simulate every particle
+      void Update(float dt);
+
+      //! @brief Write the particles sorted back to front along cameraForward, return the count
+      size_t WriteInstances(const glm::vec3& cameraPosition, const glm::vec3& cameraForward
+        , ParticleInstance* output);
+
+      size_t GetParticleCount(void) const { return m_pool.GetCount(); }
+
+      ParticlePool& GetPool(void) { return m_pool; }
+
+      const ParticlePool& GetPool(void) const { return m_pool; }
+    private:
+      //! @brief Append count particles at the emitter position
+      void SpawnParticles(size_t count);
+
+      //! @brief Uniform in [0, 1), xorshift so each emitter has its own sequence
+      float Random(void);
+
+      EmitterSettings                   m_settings;
+      ParticlePool                      m_pool;
+      Container::Vector<ParticlePlane>  m_planes;
+      glm::vec3                         m_position{ 0.0f };
+      float                             m_spawnAccumulator = 0.0f;
+      Container::U32                    m_random = 1;
+
+      //Sorting scratch, kept between frames
+      Container::Vector<Container::U64> m_sortKeys;
+      Container::Vector<Container::U64> m_sortScratch;
+  };
+}
@@ -0,0 +1,81 @@
+/*!
+  @file ParticleEmitter.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ParticleEmitter
+*/
+#include "Graphics/Particles/ParticleEmitter.hpp"
+
+#include "Core/EC/GameObject.hpp"
+
+#include <cstdint>
+
+using namespace NightEngine::Rendering::Particles;
+
+namespace NightEngine::EC::Components
+{
+  INIT_REFLECTION_AND_FACTORY(ParticleEmitter, 100, 100)
+
+  void ParticleEmitter::OnAwake(void)
+  {
+    Rebuild();
+  }
+
+  void ParticleEmitter::OnDestroy(void)
+  {
+    m_emitter.GetPool().Reserve(0);
+    m_emitter.ClearPlanes();
+  }
+
+  void ParticleEmitter::SetSettings(const EmitterSettings& settings)
+  {
+    m_rate = settings.m_rate;
+    m_lifetimeMin = settings.m_lifetimeMin;
+    m_lifetimeMax = settings.m_lifetimeMax;
+    m_velocity = settings.m_velocity;
+    m_velocitySpread = settings.m_velocitySpread;
+    m_acceleration = settings.m_acceleration;
+    m_drag = settings.m_drag;
+    m_restitution = settings.m_restitution;
+    m_startSize = settings.m_startSize;
+    m_endSize = settings.m_endSize;
+    m_startColor = settings.m_startColor;
+    m_endColor = settings.m_endColor;
+    m_maxParticles = static_cast<int>(settings.m_maxParticles);
+    Rebuild();
+  }
+
+  void ParticleEmitter::SetGround(bool collide, float height)
+  {
+    m_collideWithGround = collide;
+    m_groundHeight = height;
+
+    m_emitter.ClearPlanes();
+    if (m_collideWithGround)
+    {
+      m_emitter.AddPlane(ParticlePlane{ glm::vec3(0.0f, 1.0f, 0.0f), -m_groundHeight });
+    }
+  }
+
+  void ParticleEmitter::Rebuild(void)
+  {
+    EmitterSettings settings;
+    settings.m_rate = m_rate;
+    settings.m_lifetimeMin = m_lifetimeMin;
+    settings.m_lifetimeMax = m_lifetimeMax;
+    settings.m_velocity = m_velocity;
+    settings.m_velocitySpread = m_velocitySpread;
+    settings.m_acceleration = m_acceleration;
+    settings.m_drag = m_drag;
+    settings.m_restitution = m_restitution;
+    settings.m_startSize = m_startSize;
+    settings.m_endSize = m_endSize;
+    settings.m_startColor = m_startColor;
+    settings.m_endColor = m_endColor;
+    settings.m_maxParticles = m_maxParticles > 0 ? static_cast<size_t>(m_maxParticles) : 0;
+
+    //Seeded by address so identical effects don't spawn in lockstep
+    m_emitter.Initialize(settings
+      , static_cast<Container::U32>(reinterpret_cast<uintptr_t>(this) >> 4));
+    SetGround(m_collideWithGround, m_groundHeight);
+  }
+}
@@ -0,0 +1,78 @@
+/*!
+  @file ParticleEmitter.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ParticleEmitter
+*/
+#pragma once
+
+#include "Core/EC/ComponentLogic.hpp"
+#include "Core/EC/Factory.hpp"
+#include "Graphics/Particles/Emitter.hpp"
+
+namespace NightEngine::EC::Components
+{
+  //! @brief Particle effect following its GameObject.
+  // Simulated by ParticleSystem::Update and drawn by the ParticleRenderer every frame.
+  class ParticleEmitter: public ComponentLogic
+  {
+    REFLECTABLE_TYPE_BLOCK()
+    {
+      META_REGISTERER_WITHBASE(ParticleEmitter, ComponentLogic
+        , InheritType::PUBLIC, true
+        , nullptr, nullptr)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_rate, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_lifetimeMin, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_lifetimeMax, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_velocity, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_velocitySpread, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_acceleration, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_drag, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_restitution, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_startSize, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_endSize, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_startColor, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_endColor, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_maxParticles, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_collideWithGround, true)
+        .MR_ADD_MEMBER_PROTECTED(ParticleEmitter, m_groundHeight, true);
+    }
+    public:
+      using Emitter = NightEngine::Rendering::Particles::Emitter;
+      using EmitterSettings = NightEngine::Rendering::Particles::EmitterSettings;
+
+      //! @brief On Awake, build the emitter from the deserialized settings
+      virtual void OnAwake(void) override;
+
+      //! @brief On destroy callback
+      virtual void OnDestroy(void) override;
+
+      //! @brief Replace the settings, the live particles are dropped
+      void SetSettings(const EmitterSettings& settings);
+
+      //! @brief Bounce on a horizontal plane at height, in world space
+      void SetGround(bool collide, float height);
+
+      Emitter& GetEmitter(void) { return m_emitter; }
+    private:
+      //! @brief Rebuild m_emitter from the members
+      void Rebuild(void);
+
+      float      m_rate = 100.0f;
+      float      m_lifetimeMin = 1.0f;
+      float      m_lifetimeMax = 2.0f;
+      glm::vec3  m_velocity{ 0.0f, 2.0f, 0.0f };
+      float      m_velocitySpread = 1.0f;
+      glm::vec3  m_acceleration{ 0.0f, -9.8f, 0.0f };
+      float      m_drag = 0.0f;
+      float      m_restitution = 0.5f;
+      float      m_startSize = 0.1f;
+      float      m_endSize = 0.0f;
+      glm::vec4  m_startColor{ 1.0f };
+      glm::vec4  m_endColor{ 1.0f, 1.0f, 1.0f, 0.0f };
+      int        m_maxParticles = 10000;
+      bool       m_collideWithGround = false;
+      float      m_groundHeight = 0.0f;
+
+      Emitter    m_emitter;
+  };
+}
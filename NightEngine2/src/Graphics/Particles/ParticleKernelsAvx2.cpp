@@ -0,0 +1,106 @@
+/*!
+  @file ParticleKernelsAvx2.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ParticleKernelsAvx2
+*/
+#include "Graphics/Particles/ParticleKernelsAvx2.hpp"
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#endif
+
+namespace NightEngine::Rendering::Particles::ParticleKernels::Avx2
+{
+#if defined(__AVX2__)
+  bool IsCompiled(void) { return true; }
+
+  //Same operations in the same order as the SSE2 kernels (no fma), the results match bit for bit
+  size_t Integrate(float* const* position, float* const* velocity, float* age
+    , size_t begin, size_t end, const float* accelerationDt, float damping, float dt)
+  {
+    const __m256 step = _mm256_set1_ps(dt);
+    const __m256 drag = _mm256_set1_ps(damping);
+    const __m256 ax = _mm256_set1_ps(accelerationDt[0]);
+    const __m256 ay = _mm256_set1_ps(accelerationDt[1]);
+    const __m256 az = _mm256_set1_ps(accelerationDt[2]);
+
+    //Blocks of 4 are padded, the last one can be read whole
+    size_t blockEnd = (end + 3) & ~size_t(3);
+    size_t i = begin;
+    for (; i + 8 <= blockEnd; i += 8)
+    {
+      __m256 velocityX = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(velocity[0] + i), drag), ax);
+      __m256 velocityY = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(velocity[1] + i), drag), ay);
+      __m256 velocityZ = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(velocity[2] + i), drag), az);
+      _mm256_storeu_ps(velocity[0] + i, velocityX);
+      _mm256_storeu_ps(velocity[1] + i, velocityY);
+      _mm256_storeu_ps(velocity[2] + i, velocityZ);
+      _mm256_storeu_ps(position[0] + i, _mm256_add_ps(_mm256_mul_ps(velocityX, step), _mm256_loadu_ps(position[0] + i)));
+      _mm256_storeu_ps(position[1] + i, _mm256_add_ps(_mm256_mul_ps(velocityY, step), _mm256_loadu_ps(position[1] + i)));
+      _mm256_storeu_ps(position[2] + i, _mm256_add_ps(_mm256_mul_ps(velocityZ, step), _mm256_loadu_ps(position[2] + i)));
+      _mm256_storeu_ps(age + i, _mm256_add_ps(_mm256_loadu_ps(age + i), step));
+    }
+    return i;
+  }
+
+  size_t CollidePlane(float* const* position, float* const* velocity
+    , size_t begin, size_t end, const float* plane, float restitution)
+  {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 bounce = _mm256_set1_ps(1.0f + restitution);
+    const __m256 nx = _mm256_set1_ps(plane[0]);
+    const __m256 ny = _mm256_set1_ps(plane[1]);
+    const __m256 nz = _mm256_set1_ps(plane[2]);
+    const __m256 distance = _mm256_set1_ps(plane[3]);
+
+    size_t blockEnd = (end + 3) & ~size_t(3);
+    size_t i = begin;
+    for (; i + 8 <= blockEnd; i += 8)
+    {
+      __m256 positionX = _mm256_loadu_ps(position[0] + i);
+      __m256 positionY = _mm256_loadu_ps(position[1] + i);
+      __m256 positionZ = _mm256_loadu_ps(position[2] + i);
+      __m256 depth = _mm256_add_ps(_mm256_mul_ps(nx, positionX)
+        , _mm256_add_ps(_mm256_mul_ps(ny, positionY)
+        , _mm256_add_ps(_mm256_mul_ps(nz, positionZ), distance)));
+      __m256 inside = _mm256_cmp_ps(depth, zero, _CMP_LT_OQ);
+      if (_mm256_movemask_ps(inside) == 0)
+      {
+        continue;
+      }
+
+      __m256 push = _mm256_and_ps(inside, depth);
+      _mm256_storeu_ps(position[0] + i, _mm256_sub_ps(positionX, _mm256_mul_ps(nx, push)));
+      _mm256_storeu_ps(position[1] + i, _mm256_sub_ps(positionY, _mm256_mul_ps(ny, push)));
+      _mm256_storeu_ps(position[2] + i, _mm256_sub_ps(positionZ, _mm256_mul_ps(nz, push)));
+
+      __m256 velocityX = _mm256_loadu_ps(velocity[0] + i);
+      __m256 velocityY = _mm256_loadu_ps(velocity[1] + i);
+      __m256 velocityZ = _mm256_loadu_ps(velocity[2] + i);
+      __m256 normalSpeed = _mm256_add_ps(_mm256_mul_ps(nx, velocityX)
+        , _mm256_add_ps(_mm256_mul_ps(ny, velocityY), _mm256_mul_ps(nz, velocityZ)));
+      __m256 into = _mm256_and_ps(inside, _mm256_cmp_ps(normalSpeed, zero, _CMP_LT_OQ));
+      __m256 impulse = _mm256_and_ps(into, _mm256_mul_ps(normalSpeed, bounce));
+      _mm256_storeu_ps(velocity[0] + i, _mm256_sub_ps(velocityX, _mm256_mul_ps(nx, impulse)));
+      _mm256_storeu_ps(velocity[1] + i, _mm256_sub_ps(velocityY, _mm256_mul_ps(ny, impulse)));
+      _mm256_storeu_ps(velocity[2] + i, _mm256_sub_ps(velocityZ, _mm256_mul_ps(nz, impulse)));
+    }
+    return i;
+  }
+#else
+  //Built without the AVX2 flags, the SSE2 kernels do everything
+  bool IsCompiled(void) { return false; }
+
+  size_t Integrate(float* const*, float* const*, float*
+    , size_t begin, size_t, const float*, float, float)
+  {
+    return begin;
+  }
+
+  size_t CollidePlane(float* const*, float* const*
+    , size_t begin, size_t, const float*, float)
+  {
+    return begin;
+  }
+#endif
+}
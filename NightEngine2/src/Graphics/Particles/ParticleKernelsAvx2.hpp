@@ -0,0 +1,25 @@
+/*!
+  @file ParticleKernelsAvx2.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ParticleKernelsAvx2
+*/
+#pragma once
+#include <cstddef>
+
+//Only plain types here, the AVX2 file is built with its own flags and must not
+//instantiate inline functions the rest of the engine could end up calling
+namespace NightEngine::Rendering::Particles::ParticleKernels::Avx2
+{
+  //! @brief Check if the AVX2 file was built with the AVX2 flags
+  bool IsCompiled(void);
+
+  //! @brief Same as ParticleKernels::Integrate 8 particles at a time, acceleration is
+  // already scaled by dt. Stop when less than 8 are left, return where it stopped
+  size_t Integrate(float* const* position, float* const* velocity, float* age
+    , size_t begin, size_t end, const float* accelerationDt, float damping, float dt);
+
+  //! @brief Same as ParticleKernels::CollidePlanes for one plane, 8 particles at a time.
+  // Stop when less than 8 are left, return where it stopped
+  size_t CollidePlane(float* const* position, float* const* velocity
+    , size_t begin, size_t end, const float* plane, float restitution);
+}
@@ -0,0 +1,199 @@
+/*!
+  @file ParticlePool.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ParticlePool
+*/
+#include "Graphics/Particles/ParticlePool.hpp"
+#include "Graphics/Particles/ParticleKernelsAvx2.hpp"
+#include "Core/Utility/SimdFloat4.hpp"
+#include "Core/Utility/CpuFeatures.hpp"
+
+#include "Core/Macros.hpp"
+
+#include <algorithm>
+
+using namespace NightEngine::Simd;
+
+namespace NightEngine::Rendering::Particles
+{
+  using Stream = ParticlePool::Stream;
+  static const size_t c_STREAM_COUNT = static_cast<size_t>(Stream::COUNT);
+
+  void ParticlePool::Reserve(size_t capacity)
+  {
+    m_capacity = capacity;
+    m_stride = (capacity + 3) & ~size_t(3);
+    m_count = 0;
+
+    //Padding lanes are processed with the live ones, keep them finite
+    m_data.assign(m_stride * c_STREAM_COUNT, 0.0f);
+  }
+
+  size_t ParticlePool::Spawn(size_t count, size_t& outSpawned)
+  {
+    size_t first = m_count;
+    outSpawned = std::min(count, m_capacity - m_count);
+    m_count += outSpawned;
+    return first;
+  }
+
+  void ParticlePool::RemoveSwapBack(size_t index)
+  {
+    ASSERT_TRUE(index < m_count);
+    --m_count;
+    for (size_t i = 0; i < c_STREAM_COUNT; ++i)
+    {
+      float* stream = m_data.data() + i * m_stride;
+      stream[index] = stream[m_count];
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  namespace ParticleKernels
+  {
+    //! @brief AVX2 file built with its flags and the cpu has it
+    static bool UseAvx2(void)
+    {
+      return Avx2::IsCompiled() && CpuFeatures::IsAvx2Enabled();
+    }
+
+    void Integrate(ParticlePool& pool, size_t begin, size_t end
+      , const glm::vec3& acceleration, float drag, float dt)
+    {
+      ASSERT_TRUE(begin % 4 == 0);
+      float* px = pool.GetStream(Stream::POSITION_X);
+      float* py = pool.GetStream(Stream::POSITION_Y);
+      float* pz = pool.GetStream(Stream::POSITION_Z);
+      float* vx = pool.GetStream(Stream::VELOCITY_X);
+      float* vy = pool.GetStream(Stream::VELOCITY_Y);
+      float* vz = pool.GetStream(Stream::VELOCITY_Z);
+      float* age = pool.GetStream(Stream::AGE);
+
+      float damping = std::max(1.0f - drag * dt, 0.0f);
+      float accelerationDt[3]{ acceleration.x * dt, acceleration.y * dt, acceleration.z * dt };
+
+      //8 at a time when the cpu can, the rest 4 at a time
+      size_t i = begin;
+      if (UseAvx2())
+      {
+        float* position[3]{ px, py, pz };
+        float* velocity[3]{ vx, vy, vz };
+        i = Avx2::Integrate(position, velocity, age, begin, end, accelerationDt, damping, dt);
+      }
+
+      const Float4 step = Splat(dt);
+      const Float4 dampingFactor = Splat(damping);
+      const Float4 ax = Splat(accelerationDt[0]);
+      const Float4 ay = Splat(accelerationDt[1]);
+      const Float4 az = Splat(accelerationDt[2]);
+      for (; i < end; i += 4)
+      {
+        Float4 velocityX = MulAdd(Load(vx + i), dampingFactor, ax);
+        Float4 velocityY = MulAdd(Load(vy + i), dampingFactor, ay);
+        Float4 velocityZ = MulAdd(Load(vz + i), dampingFactor, az);
+        Store(velocityX, vx + i);
+        Store(velocityY, vy + i);
+        Store(velocityZ, vz + i);
+        Store(MulAdd(velocityX, step, Load(px + i)), px + i);
+        Store(MulAdd(velocityY, step, Load(py + i)), py + i);
+        Store(MulAdd(velocityZ, step, Load(pz + i)), pz + i);
+        Store(Load(age + i) + step, age + i);
+      }
+    }
+
+    void CollidePlanes(ParticlePool& pool, size_t begin, size_t end
+      , const ParticlePlane* planes, size_t planeCount, float restitution)
+    {
+      ASSERT_TRUE(begin % 4 == 0);
+      float* px = pool.GetStream(Stream::POSITION_X);
+      float* py = pool.GetStream(Stream::POSITION_Y);
+      float* pz = pool.GetStream(Stream::POSITION_Z);
+      float* vx = pool.GetStream(Stream::VELOCITY_X);
+      float* vy = pool.GetStream(Stream::VELOCITY_Y);
+      float* vz = pool.GetStream(Stream::VELOCITY_Z);
+
+      const bool useAvx2 = UseAvx2();
+      float* position[3]{ px, py, pz };
+      float* velocity[3]{ vx, vy, vz };
+
+      const Float4 zero = Splat(0.0f);
+      const Float4 bounce = Splat(1.0f + restitution);
+      for (size_t p = 0; p < planeCount; ++p)
+      {
+        size_t i = begin;
+        if (useAvx2)
+        {
+          float plane[4]{ planes[p].m_normal.x, planes[p].m_normal.y
+            , planes[p].m_normal.z, planes[p].m_distance };
+          i = Avx2::CollidePlane(position, velocity, begin, end, plane, restitution);
+        }
+
+        const Float4 nx = Splat(planes[p].m_normal.x);
+        const Float4 ny = Splat(planes[p].m_normal.y);
+        const Float4 nz = Splat(planes[p].m_normal.z);
+        const Float4 distance = Splat(planes[p].m_distance);
+        for (; i < end; i += 4)
+        {
+          Float4 positionX = Load(px + i);
+          Float4 positionY = Load(py + i);
+          Float4 positionZ = Load(pz + i);
+          Float4 depth = MulAdd(nx, positionX, MulAdd(ny, positionY, MulAdd(nz, positionZ, distance)));
+          Float4 inside = CmpLess(depth, zero);
+          if (MoveMask(inside) == 0)
+          {
+            continue;
+          }
+
+          //Back on the plane, then remove the velocity going in and bounce it out
+          Float4 push = And(inside, depth);
+          Store(positionX - nx * push, px + i);
+          Store(positionY - ny * push, py + i);
+          Store(positionZ - nz * push, pz + i);
+
+          Float4 velocityX = Load(vx + i);
+          Float4 velocityY = Load(vy + i);
+          Float4 velocityZ = Load(vz + i);
+          Float4 normalSpeed = MulAdd(nx, velocityX, MulAdd(ny, velocityY, nz * velocityZ));
+          Float4 impulse = And(And(inside, CmpLess(normalSpeed, zero)), normalSpeed * bounce);
+          Store(velocityX - nx * impulse, vx + i);
+          Store(velocityY - ny * impulse, vy + i);
+          Store(velocityZ - nz * impulse, vz + i);
+        }
+      }
+    }
+
+    size_t KillExpired(ParticlePool& pool)
+    {
+      const float* age = pool.GetStream(Stream::AGE);
+      const float* invLifetime = pool.GetStream(Stream::INV_LIFETIME);
+      const Float4 one = Splat(1.0f);
+
+      size_t killed = 0;
+      size_t i = 0;
+      while (i < pool.GetCount())
+      {
+        //Most blocks have nobody to kill, test 4 at once
+        int dead = MoveMask(CmpLess(one, Load(age + i) * Load(invLifetime + i)));
+        int live = (1 << std::min<size_t>(pool.GetCount() - i, 4)) - 1;
+        if ((dead & live) == 0)
+        {
+          i += 4;
+          continue;
+        }
+
+        //The swapped in particle can be dead too, the block is tested again
+        for (size_t lane = 0; lane < 4; ++lane)
+        {
+          if ((dead & live & (1 << lane)) != 0)
+          {
+            pool.RemoveSwapBack(i + lane);
+            ++killed;
+            break;
+          }
+        }
+      }
+      return killed;
+    }
+  }
+}
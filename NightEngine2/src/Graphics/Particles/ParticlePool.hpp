@@ -0,0 +1,81 @@
+/*!
+  @file ParticlePool.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ParticlePool
+*/
+#pragma once
+
+#include "Core/Container/Vector.hpp"
+#include <glm/vec3.hpp>
+
+namespace NightEngine::Rendering::Particles
+{
+  //! @brief Plane particles bounce on, they stay where dot(normal, p) + distance >= 0
+  struct ParticlePlane
+  {
+    glm::vec3 m_normal{ 0.0f, 1.0f, 0.0f };
+    float     m_distance = 0.0f;
+  };
+
+  //! @brief Live particles of one emitter, one array per attribute. The live particles
+  // are packed at the front, the kernels process them 4 at a time.
+  class ParticlePool
+  {
+    public:
+      enum class Stream : unsigned
+      {
+        POSITION_X = 0,
+        POSITION_Y,
+        POSITION_Z,
+        VELOCITY_X,
+        VELOCITY_Y,
+        VELOCITY_Z,
+        AGE,
+        INV_LIFETIME,     //Normalized age is age * inverse lifetime
+        COUNT
+      };
+
+      //! @brief Allocate room for capacity particles, the live ones are dropped
+      void Reserve(size_t capacity);
+
+      //! @brief Append up to count particles, return the index of the first one.
+      // Their attributes are undefined until written
+      size_t Spawn(size_t count, size_t& outSpawned);
+
+      //! @brief Drop every particle
+      void Clear(void) { m_count = 0; }
+
+      //! @brief Copy the last particle over index, then shrink by one
+      void RemoveSwapBack(size_t index);
+
+      size_t GetCount(void) const { return m_count; }
+
+      size_t GetCapacity(void) const { return m_capacity; }
+
+      float* GetStream(Stream stream) { return m_data.data() + static_cast<size_t>(stream) * m_stride; }
+
+      const float* GetStream(Stream stream) const { return m_data.data() + static_cast<size_t>(stream) * m_stride; }
+    private:
+      Container::Vector<float> m_data;
+      size_t                   m_capacity = 0;
+      size_t                   m_stride = 0;    //Capacity rounded up to 4 floats
+      size_t                   m_count = 0;
+  };
+
+  //! @brief Kernels over the particles [begin, end), begin must be a multiple of 4.
+  // Ranges don't overlap so they can run on different threads.
+  namespace ParticleKernels
+  {
+    //! @brief Explicit Euler step with a constant acceleration and a linear drag, age the particles
+    void Integrate(ParticlePool& pool, size_t begin, size_t end
+      , const glm::vec3& acceleration, float drag, float dt);
+
+    //! @brief Push particles out of the planes, reflect the velocity going into them
+    void CollidePlanes(ParticlePool& pool, size_t begin, size_t end
+      , const ParticlePlane* planes, size_t planeCount, float restitution);
+
+    //! @brief Remove the particles past their lifetime, the order isn't kept.
+    // Return the amount removed, run over the whole pool on one thread
+    size_t KillExpired(ParticlePool& pool);
+  }
+}
@@ -0,0 +1,147 @@
+/*!
+  @file ParticleSystem.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of ParticleSystem
+*/
+#include "Graphics/Particles/ParticleSystem.hpp"
+#include "Graphics/Particles/ParticleEmitter.hpp"
+
+#include "Core/EC/Factory.hpp"
+#include "Core/EC/GameObject.hpp"
+#include "Core/Utility/JobSystem.hpp"
+
+#include <algorithm>
+
+using namespace NightEngine::EC;
+using namespace NightEngine::EC::Components;
+
+namespace NightEngine::Rendering::Particles
+{
+  namespace ParticleSystem
+  {
+    //Particles simulated per job, a multiple of 4 so the kernels stay aligned
+    static const size_t c_CHUNK_SIZE = 16384;
+
+    struct SimulateChunk
+    {
+      Emitter* m_emitter;
+      size_t   m_begin;
+      size_t   m_end;
+    };
+
+    struct EmitterDepth
+    {
+      Emitter* m_emitter;
+      float    m_depth;
+      size_t   m_offset;    //Emitter index while sorting, then the first output particle
+    };
+
+    static Container::Vector<SimulateChunk> g_chunks;
+    static Container::Vector<EmitterDepth>  g_order;
+    static Container::Vector<Emitter*>      g_emitters;
+
+    void UpdateEmitters(const Container::Vector<Emitter*>& emitters, float dt)
+    {
+      //Spawning and compacting move particles around, one job per emitter
+      JobSystem::ParallelFor(emitters.size(), 1, [&emitters, dt](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          emitters[i]->Emit(dt);
+        }
+      });
+
+      //Then split big emitters so a single effect still use every worker
+      g_chunks.clear();
+      for (Emitter* emitter : emitters)
+      {
+        size_t count = emitter->GetParticleCount();
+        for (size_t begin = 0; begin < count; begin += c_CHUNK_SIZE)
+        {
+          g_chunks.emplace_back(SimulateChunk{ emitter, begin, std::min(begin + c_CHUNK_SIZE, count) });
+        }
+      }
+
+      JobSystem::ParallelFor(g_chunks.size(), 1, [dt](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          const SimulateChunk& chunk = g_chunks[i];
+          chunk.m_emitter->Simulate(dt, chunk.m_begin, chunk.m_end);
+        }
+      });
+    }
+
+    size_t GetParticleCount(const Container::Vector<Emitter*>& emitters)
+    {
+      size_t count = 0;
+      for (const Emitter* emitter : emitters)
+      {
+        count += emitter->GetParticleCount();
+      }
+      return count;
+    }
+
+    size_t WriteInstances(const Container::Vector<Emitter*>& emitters
+      , const glm::vec3& cameraPosition, const glm::vec3& cameraForward
+      , ParticleInstance* output)
+    {
+      //Emitters are ordered by their position only, overlapping effects may still mix wrong
+      g_order.resize(emitters.size());
+      for (size_t i = 0; i < emitters.size(); ++i)
+      {
+        glm::vec3 offset = emitters[i]->GetPosition() - cameraPosition;
+        g_order[i] = EmitterDepth{ emitters[i]
+          , offset.x * cameraForward.x + offset.y * cameraForward.y + offset.z * cameraForward.z, i };
+      }
+
+      //Ties keep the emitter order, std::stable_sort would allocate a buffer every frame
+      std::sort(g_order.begin(), g_order.end()
+        , [](const EmitterDepth& lhs, const EmitterDepth& rhs)
+        {
+          return lhs.m_depth != rhs.m_depth ? lhs.m_depth > rhs.m_depth : lhs.m_offset < rhs.m_offset;
+        });
+
+      size_t count = 0;
+      for (EmitterDepth& emitter : g_order)
+      {
+        emitter.m_offset = count;
+        count += emitter.m_emitter->GetParticleCount();
+      }
+
+      //Each emitter sort and write its own range of the output
+      JobSystem::ParallelFor(g_order.size(), 1
+        , [&cameraPosition, &cameraForward, output](size_t begin, size_t end)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          g_order[i].m_emitter->WriteInstances(cameraPosition, cameraForward
+            , output + g_order[i].m_offset);
+        }
+      });
+      return count;
+    }
+
+    void Update(float dt)
+    {
+      g_emitters.clear();
+      auto& container = Factory::GetTypeContainer<ParticleEmitter>();
+      auto it = container.GetIterator();
+      while (!it.IsEnd())
+      {
+        ParticleEmitter* component = it.Get();
+        Emitter& emitter = component->GetEmitter();
+        emitter.SetPosition(component->GetGameObject()->GetTransform()->GetPosition());
+        g_emitters.emplace_back(&emitter);
+        it.Next();
+      }
+
+      UpdateEmitters(g_emitters, dt);
+    }
+
+    const Container::Vector<Emitter*>& GetActiveEmitters(void)
+    {
+      return g_emitters;
+    }
+  }
+}
@@ -0,0 +1,34 @@
+/*!
+  @file ParticleSystem.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of ParticleSystem
+*/
+#pragma once
+
+#include "Graphics/Particles/Emitter.hpp"
+
+namespace NightEngine::Rendering::Particles
+{
+  //! @brief Simulate every emitter on the JobSystem workers and gather their instances
+  namespace ParticleSystem
+  {
+    //! @brief Emit per emitter, then simulate chunks of particles across the workers.
+    // Block until done
+    void UpdateEmitters(const Container::Vector<Emitter*>& emitters, float dt);
+
+    //! @brief Sum of the live particles of emitters
+    size_t GetParticleCount(const Container::Vector<Emitter*>& emitters);
+
+    //! @brief Write the particles of every emitter into output, emitters far to near
+    // and each one sorted back to front. output must hold GetParticleCount, return the count
+    size_t WriteInstances(const Container::Vector<Emitter*>& emitters
+      , const glm::vec3& cameraPosition, const glm::vec3& cameraForward
+      , ParticleInstance* output);
+
+    //! @brief Move the ParticleEmitter components to their GameObject and update them
+    void Update(float dt);
+
+    //! @brief Emitters of the ParticleEmitter components updated last
+    const Container::Vector<Emitter*>& GetActiveEmitters(void);
+  }
+}
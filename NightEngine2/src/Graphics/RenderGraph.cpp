@@ -0,0 +1,243 @@
+/*!
+  @file RenderGraph.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of RenderGraph
+*/
+#include "Graphics/RenderGraph.hpp"
+
+#include "Core/Macros.hpp"
+#include "Core/Logger.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+using namespace NightEngine;
+using namespace NightEngine::Container;
+
+namespace NightEngine::Rendering
+{
+  U64 RenderGraphTextureDesc::GetByteSize(void) const
+  {
+    return static_cast<U64>(m_width) * static_cast<U64>(m_height) * m_bytesPerPixel;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  RenderGraph::PassBuilder& RenderGraph::PassBuilder::Read(ResourceID resource)
+  {
+    ASSERT_MSG(resource < m_graph.m_resources.size(), "Invalid render graph resource");
+    m_graph.m_passes[m_pass].m_reads.emplace_back(resource);
+    return *this;
+  }
+
+  RenderGraph::PassBuilder& RenderGraph::PassBuilder::Write(ResourceID resource)
+  {
+    ASSERT_MSG(resource < m_graph.m_resources.size(), "Invalid render graph resource");
+    m_graph.m_passes[m_pass].m_writes.emplace_back(resource);
+    return *this;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  RenderGraph::ResourceID RenderGraph::CreateTexture(const std::string& name
+    , const RenderGraphTextureDesc& desc)
+  {
+    Resource resource;
+    resource.m_name = name;
+    resource.m_desc = desc;
+    m_resources.emplace_back(std::move(resource));
+    return static_cast<ResourceID>(m_resources.size() - 1);
+  }
+
+  RenderGraph::ResourceID RenderGraph::ImportTexture(const std::string& name)
+  {
+    Resource resource;
+    resource.m_name = name;
+    resource.m_imported = true;
+    m_resources.emplace_back(std::move(resource));
+    return static_cast<ResourceID>(m_resources.size() - 1);
+  }
+
+  void RenderGraph::MarkOutput(ResourceID resource)
+  {
+    ASSERT_MSG(resource < m_resources.size(), "Invalid render graph resource");
+    m_resources[resource].m_output = true;
+  }
+
+  RenderGraph::PassBuilder RenderGraph::AddPass(const std::string& name, ExecuteFN executeFn)
+  {
+    Pass pass;
+    pass.m_name = name;
+    pass.m_executeFn = std::move(executeFn);
+    m_passes.emplace_back(std::move(pass));
+    return PassBuilder{ *this, m_passes.size() - 1 };
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  bool RenderGraph::Compile(void)
+  {
+    CullPasses();
+    if (!ComputeLifetimes())
+    {
+      return false;
+    }
+    AssignPhysicals();
+    return true;
+  }
+
+  void RenderGraph::CullPasses(void)
+  {
+    //Walk backward from the outputs, a pass is needed if it write something
+    //a later needed pass read. Passes are already in execution order.
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+      needed[i] = m_resources[i].m_output;
+    }
+
+    for (size_t i = m_passes.size(); i-- > 0;)
+    {
+      Pass& pass = m_passes[i];
+      pass.m_culled = std::none_of(pass.m_writes.begin(), pass.m_writes.end()
+        , [&needed](ResourceID resource) { return needed[resource]; });
+
+      //Earlier writers of the same resources stay needed too, a pass may
+      //only touch part of a target (stencil masked, blending)
+      if (!pass.m_culled)
+      {
+        for (ResourceID resource : pass.m_reads)
+        {
+          needed[resource] = true;
+        }
+      }
+    }
+  }
+
+  bool RenderGraph::ComputeLifetimes(void)
+  {
+    for (auto& resource : m_resources)
+    {
+      resource.m_lifetime = Lifetime{};
+      resource.m_physical = -1;
+    }
+
+    bool success = true;
+    std::vector<bool> written(m_resources.size(), false);
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+      Pass& pass = m_passes[i];
+      if (pass.m_culled)
+      {
+        continue;
+      }
+
+      auto touch = [this, i](ResourceID id)
+      {
+        Lifetime& lifetime = m_resources[id].m_lifetime;
+        if (!lifetime.IsUsed())
+        {
+          lifetime.m_firstPass = static_cast<int>(i);
+        }
+        lifetime.m_lastPass = static_cast<int>(i);
+      };
+
+      for (ResourceID id : pass.m_reads)
+      {
+        //Transient content doesn't exist before its first write
+        if (!m_resources[id].m_imported && !written[id])
+        {
+          Debug::Log << Logger::MessageType::ERROR_MSG
+            << "RenderGraph: pass [" << pass.m_name << "] read ["
+            << m_resources[id].m_name << "] before anything wrote it\n";
+          success = false;
+        }
+        touch(id);
+      }
+      for (ResourceID id : pass.m_writes)
+      {
+        written[id] = true;
+        touch(id);
+      }
+    }
+    return success;
+  }
+
+  void RenderGraph::AssignPhysicals(void)
+  {
+    m_physicals.clear();
+    m_transientBytes = 0;
+    m_physicalBytes = 0;
+
+    std::vector<ResourceID> transients;
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+      const Resource& resource = m_resources[i];
+      if (!resource.m_imported && resource.m_lifetime.IsUsed())
+      {
+        transients.emplace_back(static_cast<ResourceID>(i));
+        m_transientBytes += resource.m_desc.GetByteSize();
+      }
+    }
+
+    //Greedy interval assignment by first use, a target is free again
+    //after the last pass of the texture that used it
+    std::stable_sort(transients.begin(), transients.end()
+      , [this](ResourceID lhs, ResourceID rhs)
+      {
+        return m_resources[lhs].m_lifetime.m_firstPass
+          < m_resources[rhs].m_lifetime.m_firstPass;
+      });
+
+    for (ResourceID id : transients)
+    {
+      Resource& resource = m_resources[id];
+      for (size_t p = 0; p < m_physicals.size(); ++p)
+      {
+        Physical& physical = m_physicals[p];
+        if (physical.m_desc == resource.m_desc
+          && physical.m_lastPass < resource.m_lifetime.m_firstPass)
+        {
+          resource.m_physical = static_cast<int>(p);
+          break;
+        }
+      }
+
+      if (resource.m_physical < 0)
+      {
+        resource.m_physical = static_cast<int>(m_physicals.size());
+        m_physicals.emplace_back(Physical{ resource.m_desc, -1 });
+        m_physicalBytes += resource.m_desc.GetByteSize();
+      }
+      m_physicals[resource.m_physical].m_lastPass = resource.m_lifetime.m_lastPass;
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void RenderGraph::Execute(void)
+  {
+    for (auto& pass : m_passes)
+    {
+      if (!pass.m_culled && pass.m_executeFn)
+      {
+        pass.m_executeFn();
+      }
+    }
+  }
+
+  void RenderGraph::Clear(void)
+  {
+    m_resources.clear();
+    m_passes.clear();
+    m_physicals.clear();
+    m_transientBytes = 0;
+    m_physicalBytes = 0;
+  }
+
+  size_t RenderGraph::GetActivePassCount(void) const
+  {
+    return static_cast<size_t>(std::count_if(m_passes.begin(), m_passes.end()
+      , [](const Pass& pass) { return !pass.m_culled; }));
+  }
+} // Rendering
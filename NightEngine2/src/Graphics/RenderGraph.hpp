@@ -0,0 +1,167 @@
+/*!
+  @file RenderGraph.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of RenderGraph
+*/
+#pragma once
+
+#include "Core/Container/PrimitiveType.hpp"
+
+// Standard Headers
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace NightEngine::Rendering
+{
+  //! @brief Size and format of a transient texture, textures only share a target if equal
+  struct RenderGraphTextureDesc
+  {
+    int            m_width = 0;
+    int            m_height = 0;
+    Container::U32 m_format = 0;         //Backend's format enum
+    Container::U32 m_bytesPerPixel = 0;  //Only for the memory statistics
+
+    //! @brief Estimated memory of the texture
+    Container::U64 GetByteSize(void) const;
+
+    bool operator==(const RenderGraphTextureDesc& rhs) const
+    {
+      return m_width == rhs.m_width && m_height == rhs.m_height
+        && m_format == rhs.m_format;
+    }
+    bool operator!=(const RenderGraphTextureDesc& rhs) const { return !(*this == rhs); }
+  };
+
+  //! @brief Frame's passes declared with the resources they read and write.
+  // Compile cull the passes that don't contribute to an output, compute when each
+  // resource is live and assign the transient textures to physical targets, textures
+  // that are never live at the same time share one. This part is pure CPU, the backend
+  // create the physical targets and the passes' callbacks do the drawing.
+  class RenderGraph
+  {
+    public:
+      using ResourceID = Container::U32;
+      using ExecuteFN = std::function<void(void)>;
+
+      static constexpr ResourceID c_INVALID_RESOURCE = ~ResourceID(0);
+
+      //! @brief First and last surviving pass using a resource, -1 if unused
+      struct Lifetime
+      {
+        int m_firstPass = -1;
+        int m_lastPass = -1;
+
+        bool IsUsed(void) const { return m_firstPass >= 0; }
+      };
+
+      //! @brief Declare the resources of the pass just added
+      class PassBuilder
+      {
+        public:
+          PassBuilder(RenderGraph& graph, size_t pass) : m_graph(graph), m_pass(pass) {}
+
+          //! @brief The pass sample or blend with resource
+          PassBuilder& Read(ResourceID resource);
+
+          //! @brief The pass render into resource
+          PassBuilder& Write(ResourceID resource);
+        private:
+          RenderGraph& m_graph;
+          size_t       m_pass;
+      };
+
+      //! @brief Texture owned by the graph, only valid during the frame
+      ResourceID CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+      //! @brief Texture owned outside the graph, persistent or the backbuffer. Never aliased.
+      ResourceID ImportTexture(const std::string& name);
+
+      //! @brief Passes writing resource are kept, with everything they depend on
+      void MarkOutput(ResourceID resource);
+
+      //! @brief Add a pass, executed in declaration order
+      PassBuilder AddPass(const std::string& name, ExecuteFN executeFn);
+
+      //! @brief Cull, compute lifetimes and the aliasing plan.
+      // False if a surviving pass read a transient texture nothing wrote before.
+      bool Compile(void);
+
+      //! @brief Call every pass that survived Compile in order
+      void Execute(void);
+
+      //! @brief Remove every pass and resource, keep the memory for the next frame
+      void Clear(void);
+
+      //*****************************************************
+      // Compile Result
+      //*****************************************************
+      size_t GetPassCount(void) const { return m_passes.size(); }
+      size_t GetResourceCount(void) const { return m_resources.size(); }
+      const std::string& GetPassName(size_t pass) const { return m_passes[pass].m_name; }
+      const std::string& GetResourceName(ResourceID resource) const { return m_resources[resource].m_name; }
+      const RenderGraphTextureDesc& GetDesc(ResourceID resource) const { return m_resources[resource].m_desc; }
+      bool IsImported(ResourceID resource) const { return m_resources[resource].m_imported; }
+
+      //! @brief Check if the pass was removed by Compile
+      bool IsPassCulled(size_t pass) const { return m_passes[pass].m_culled; }
+
+      //! @brief Number of passes surviving Compile
+      size_t GetActivePassCount(void) const;
+
+      //! @brief Pass index range where resource is live
+      Lifetime GetLifetime(ResourceID resource) const { return m_resources[resource].m_lifetime; }
+
+      //! @brief Physical target of a transient texture, -1 if imported or unused
+      int GetPhysicalIndex(ResourceID resource) const { return m_resources[resource].m_physical; }
+
+      //! @brief Number of physical targets needed by the frame
+      size_t GetPhysicalCount(void) const { return m_physicals.size(); }
+
+      //! @brief Description of a physical target
+      const RenderGraphTextureDesc& GetPhysicalDesc(size_t physical) const { return m_physicals[physical].m_desc; }
+
+      //! @brief Memory of the used transient textures if each had its own target
+      Container::U64 GetTransientBytes(void) const { return m_transientBytes; }
+
+      //! @brief Memory of the physical targets after aliasing
+      Container::U64 GetPhysicalBytes(void) const { return m_physicalBytes; }
+    private:
+      struct Resource
+      {
+        std::string            m_name;
+        RenderGraphTextureDesc m_desc;
+        bool                   m_imported = false;
+        bool                   m_output = false;
+
+        Lifetime               m_lifetime;
+        int                    m_physical = -1;
+      };
+
+      struct Pass
+      {
+        std::string             m_name;
+        ExecuteFN               m_executeFn;
+        std::vector<ResourceID> m_reads;
+        std::vector<ResourceID> m_writes;
+        bool                    m_culled = false;
+      };
+
+      struct Physical
+      {
+        RenderGraphTextureDesc m_desc;
+        int                    m_lastPass = -1;
+      };
+
+      void CullPasses(void);
+      bool ComputeLifetimes(void);
+      void AssignPhysicals(void);
+
+      std::vector<Resource> m_resources;
+      std::vector<Pass>     m_passes;
+      std::vector<Physical> m_physicals;
+
+      Container::U64        m_transientBytes = 0;
+      Container::U64        m_physicalBytes = 0;
+  };
+} // Rendering
@@ -16,8 +16,13 @@
 #include "Graphics/Opengl/Light.hpp"
 #include "Graphics/Opengl/OpenglAllocationTracker.hpp"
 #include "Graphics/Opengl/ShaderTracker.hpp"
+#include "Graphics/Opengl/ShaderCache.hpp"
+#include "Graphics/Opengl/ShaderVariantCache.hpp"
+#include "Graphics/Opengl/MaterialBuffer.hpp"
+#include "Graphics/Opengl/SkinningPalette.hpp"
 
 #include "Graphics/Opengl/Postprocess/PostProcessSetting.hpp"
+#include "Graphics/Opengl/RenderTargetPool.hpp"
 #include "Graphics/Opengl/DebugMarker.hpp"
 #include "Graphics/Opengl/RenderState.hpp"
 
@@ -256,6 +261,10 @@ namespace NightEngine::Rendering
 
     //Prepass
     m_cameraMotionVector.Init(m_gbuffer);
+    m_particlePass.Init();
+
+    //Dynamic resolution input
+    m_frameGpuTimer.Init();
 
     //************************************************
     // Cubemap
@@ -347,6 +356,7 @@ namespace NightEngine::Rendering
     }
 
     GPUInstancedDrawer::UnregisterAllInstances();
+    m_frameGpuTimer.Release();
 
 #if(EDITOR_MODE)
     Editor::Terminate();
@@ -358,8 +368,13 @@ namespace NightEngine::Rendering
 
     SceneManager::DeletePostProcessSetting();
 
+    ShaderCache::Terminate();
+    MaterialBuffer::Terminate();
+    SkinningPalette::Terminate();
+    m_particlePass.Release();
     Window::Terminate();
     OpenglAllocationTracker::PrintAllocationState();
+    ShaderVariantCache::Clear();
     ShaderTracker::Clear();
   }
 
@@ -376,11 +391,43 @@ namespace NightEngine::Rendering
     m_camera.m_far = cameraFarPlane;
     m_camera.m_jitterStrength = m_postProcessSetting->m_taaPP.m_frustumJitterStrength;
 
+    //Dynamic resolution, only TAA before tonemapping upscale the viewport
+    {
+      auto& taa = m_postProcessSetting->m_taaPP;
+      bool canUpscale = g_enablePostprocess && taa.m_enable && taa.m_beforeTonemapping;
+
+      float gpuFrameMs = 0.0f;
+      bool hasFrameTime = m_frameGpuTimer.PollElapsedMs(gpuFrameMs);
+      if (enableDynamicResolution && canUpscale)
+      {
+        if (hasFrameTime)
+        {
+          m_camera.m_dynamicScale = m_dynamicResolution.Update(gpuFrameMs);
+        }
+      }
+      else
+      {
+        m_dynamicResolution.Reset();
+        m_camera.m_dynamicScale = 1.0f;
+      }
+    }
+
     m_camera.OnStartFrame();
     Drawer::OnStartFrame(Drawer::DrawPass::UNDEFINED);
     Drawer::OnStartFrame(Drawer::DrawPass::OPAQUE_PASS);
     Drawer::OnStartFrame(Drawer::DrawPass::DEBUG);
 
+    //Occlusion from the unjittered camera, TAA jitter stay under a pixel of the buffer
+    if (enableOcclusionCulling)
+    {
+      glm::vec2 screenSize = glm::vec2(m_camera.GetScreenSize());
+      m_occlusionCulling.Cull(m_camera.m_unjitteredVP, screenSize.x / std::max(screenSize.y, 1.0f));
+    }
+    else
+    {
+      m_occlusionCulling.Reset();
+    }
+
     //Update View/Projection matrix to Shader
     m_uniformBufferObject.FillBuffer(0, sizeof(glm::mat4)
       , glm::value_ptr(m_camera.m_VP));
@@ -396,6 +443,7 @@ namespace NightEngine::Rendering
 
     //Update global variable for lambda func
     g_cameraPosition = m_camera.m_position;
+    SceneManager::SetStreamingFocus(m_camera.m_position);
 
     //*************************************************
     // Rendering Loop
@@ -407,7 +455,9 @@ namespace NightEngine::Rendering
 
       DebugMarker::PushDebugGroup("Render");
       {
+        m_frameGpuTimer.Begin();
         Render();
+        m_frameGpuTimer.End();
       }
       DebugMarker::PopDebugGroup();
 
@@ -419,7 +469,9 @@ namespace NightEngine::Rendering
 
       DebugMarker::EndFrame();
 #else
+      m_frameGpuTimer.Begin();
       Render();
+      m_frameGpuTimer.End();
 #endif
 
       // Flip Buffers and Draw
@@ -458,16 +510,112 @@ namespace NightEngine::Rendering
     glClearColor(clear_color, clear_color, clear_color, clear_color);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    float pointShadowFarPlane = m_camera.m_far;
+    //TODO: don't refresh lights component every frame
+    SceneManager::GetLights(g_sceneLights);
+
+    if (Input::GetKeyDown(Input::KeyCode::KEY_8))
+    {
+      g_enablePostprocess = !g_enablePostprocess;
+      if (!g_enablePostprocess)
+      {
+        m_postProcessSetting->Clear();
+      }
+    }
+
+    //Debugging View
+    if (Input::GetKeyDown(Input::KeyCode::KEY_7))
+    {
+      g_showLight = !g_showLight;
+    }
 
     //*************************************************
-    // Depth Prepass
+    // Frame Graph
     //*************************************************
-    m_depthPrepass.Execute(m_camera);
+    RenderGraph& graph = m_renderGraph;
+    graph.Clear();
+
+    auto backbuffer = graph.ImportTexture("Backbuffer");
+    auto depth = graph.ImportTexture("DepthStencil");
+    auto gbuffer = graph.ImportTexture("GBuffer");
+    auto motionVector = graph.ImportTexture("MotionVector");
+    auto shadowMaps = graph.ImportTexture("ShadowMaps");
+    auto sceneColor = graph.ImportTexture("SceneColor");
+    graph.MarkOutput(backbuffer);
+
+    //Object velocity and depth
+    graph.AddPass("DepthPrepass", [this]() { m_depthPrepass.Execute(m_camera); })
+      .Write(depth).Write(motionVector);
+
+    graph.AddPass("ShadowCaster Pass", [this]() { RenderShadowCasters(); })
+      .Write(shadowMaps);
+
+    graph.AddPass("GBuffer", [this]() { RenderGBuffer(); })
+      .Read(depth).Write(depth).Write(gbuffer);
+
+    //Only needed by TAA and the debug view
+    graph.AddPass("CameraMotionVector", [this]()
+      {
+        DebugMarker::PushDebugGroup("CameraMotionVector");
+        {
+          m_cameraMotionVector.Render(m_sceneBuffer.m_screenTriangleVAO
+            , m_gbuffer, m_camera);
+        }
+        DebugMarker::PopDebugGroup();
+      })
+      .Read(depth).Write(motionVector);
+
+    auto lightingPass = graph.AddPass("Deferred Lighting Pass", [this]() { RenderDeferredLighting(); });
+    lightingPass.Read(gbuffer).Read(depth).Read(shadowMaps)
+      .Write(sceneColor).Write(depth);
+    if (IsDebugView())
+    {
+      lightingPass.Read(motionVector);
+    }
+
+    //Blended over the lit scene and the skybox, tested against the scene depth
+    graph.AddPass("Particles", [this]() { m_particlePass.Execute(m_camera, m_sceneBuffer.m_sceneFbo); })
+      .Read(depth).Write(sceneColor);
+
+    //*************************************************
+    // PostProcess Pass
+    //*************************************************
+    if (g_enablePostprocess)
+    {
+      m_postProcessSetting->AddPasses(graph, m_renderTargetPool
+        , PostProcessContext{ &m_camera, &m_gbuffer
+        , & m_sceneBuffer.m_sceneFbo, & m_sceneBuffer.m_screenTriangleVAO, & m_sceneBuffer.m_sceneTexture
+        , g_time, screenZoomScale }
+        , PostProcessResources{ sceneColor, depth, gbuffer, motionVector, backbuffer });
+    }
+    else
+    {
+      graph.AddPass("Blit to Backbuffer", [this]()
+        {
+          m_sceneBuffer.m_sceneFbo.CopyBufferToTarget(m_camera.m_scaledPixelResolution.x, m_camera.m_scaledPixelResolution.y
+            , m_camera.m_windowPixelResolution.x, m_camera.m_windowPixelResolution.y
+            , 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        })
+        .Read(sceneColor).Write(backbuffer);
+    }
 
     //*************************************************
-    // ShadowCaster Prepass
+    // Draw Debug Icons
     //*************************************************
+    graph.AddPass("Editor Icons", [this]() { DrawDebugIcons(); })
+      .Write(backbuffer);
+
+    //Culled passes and transient targets are skipped
+    if (graph.Compile())
+    {
+      m_renderTargetPool.Realize(graph);
+      graph.Execute();
+    }
+  }
+
+  void RenderLoopOpengl::RenderShadowCasters(void)
+  {
+    float pointShadowFarPlane = m_camera.m_far;
+
     //TODO: Make into its own ShadowCasterPass struct/class
     DebugMarker::PushDebugGroup("ShadowCaster Pass");
     {
@@ -477,14 +625,11 @@ namespace NightEngine::Rendering
       glViewport(0, 0, (GLsizei)g_dirLightResolution, (GLsizei)g_dirLightResolution);
       glEnable(GL_DEPTH_TEST);
 
-      //TODO: don't refresh lights component every frame
-      SceneManager::GetLights(g_sceneLights);
-
       //Shader and Matrices
       DebugMarker::PushDebugGroup("DirectionalLight ShadowCaster Pass");
       if (g_sceneLights.dirLights.size() > 0)
       {
-        auto lightComponent = g_sceneLights.dirLights[0]->GetComponent("Light");
+        auto lightComponent = g_sceneLights.dirLights[0]->GetComponent<Light>();
         g_dirLightWorldToLightSpaceMatrix = lightComponent->Get<Light>()
           ->CalculateDirLightWorldToLightSpaceMatrix(m_camera, mainShadowsSize, 0.3f, mainShadowsFarPlane);
 
@@ -518,7 +663,7 @@ namespace NightEngine::Rendering
         for (int i = 0; i < POINTLIGHT_AMOUNT; ++i)
         {
           //Shader and Matrices
-          auto pointLightComponent = g_sceneLights.pointLights[i]->GetComponent("Light");
+          auto pointLightComponent = g_sceneLights.pointLights[i]->GetComponent<Light>();
           auto& lightSpaceMatrices = pointLightComponent->Get<Light>()
             ->CalculatePointLightWorldToLightSpaceMatrices(90.0f, 1.0f, 0.1f, pointShadowFarPlane);
 
@@ -554,12 +699,12 @@ namespace NightEngine::Rendering
       }
     }
     DebugMarker::PopDebugGroup();
+  }
 
-    //*************************************************
-    // Geometry Pass
-    //*************************************************
+  void RenderLoopOpengl::RenderGBuffer(void)
+  {
     //glViewport(0, 0, (GLsizei)m_initResolution.x, (GLsizei)m_initResolution.y);
-    glViewport(0, 0, m_camera.m_scaledPixelResolution.x, m_camera.m_scaledPixelResolution.y);
+    glViewport(0, 0, m_camera.m_viewportPixelResolution.x, m_camera.m_viewportPixelResolution.y);
     
     // This got weird real fast lol
     m_gbuffer.Execute(m_defaultMaterial
@@ -587,20 +732,12 @@ namespace NightEngine::Rendering
             //shader.SetUniformNoErrorCheck("u_cameraPosWS", g_cameraPosition);
           });
       });
+  }
 
-    //*************************************************
-    // Camera Motion Vector Pass
-    //*************************************************
-    DebugMarker::PushDebugGroup("CameraMotionVector");
-    {
-      m_cameraMotionVector.Render(m_sceneBuffer.m_screenTriangleVAO
-        , m_gbuffer, m_camera);
-    }
-    DebugMarker::PopDebugGroup();
+  void RenderLoopOpengl::RenderDeferredLighting(void)
+  {
+    float pointShadowFarPlane = m_camera.m_far;
 
-    //*************************************************
-    // Lighting Pass
-    //*************************************************
     glDisable(GL_DEPTH_TEST);
     glDepthMask(GL_FALSE);
 
@@ -625,6 +762,7 @@ namespace NightEngine::Rendering
         shader.SetUniform("u_ambientStrength", ambientStrength);
         shader.SetUniform("u_invVP", m_camera.m_invVP);
         shader.SetUniform("u_lightSpaceMatrix", g_dirLightWorldToLightSpaceMatrix);
+        shader.SetUniform("u_uvScale", m_camera.GetUVScale());
         
         if (debugView)
         {
@@ -677,48 +815,6 @@ namespace NightEngine::Rendering
     }
     m_sceneBuffer.m_sceneFbo.Unbind();
     DebugMarker::PopDebugGroup();
-
-    //*************************************************
-    // PostProcess Pass
-    //*************************************************
-    if (Input::GetKeyDown(Input::KeyCode::KEY_8))
-    {
-      g_enablePostprocess = !g_enablePostprocess;
-      if (!g_enablePostprocess)
-      {
-        m_postProcessSetting->Clear();
-      }
-    }
-
-    if (g_enablePostprocess)
-    {
-      DebugMarker::PushDebugGroup("PostProcess");
-      //Postfx
-      {
-        m_postProcessSetting->Apply(PostProcessContext{ &m_camera, &m_gbuffer
-          , & m_sceneBuffer.m_sceneFbo, & m_sceneBuffer.m_screenTriangleVAO, & m_sceneBuffer.m_sceneTexture
-          , g_time, screenZoomScale });
-      }
-      DebugMarker::PopDebugGroup();
-    }
-    else
-    { 
-      //Blit to backbuffer
-      m_sceneBuffer.m_sceneFbo.CopyBufferToTarget(m_camera.m_scaledPixelResolution.x, m_camera.m_scaledPixelResolution.y
-        , m_camera.m_windowPixelResolution.x, m_camera.m_windowPixelResolution.y
-        , 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
-    }
-
-    //Debugging View
-    if (Input::GetKeyDown(Input::KeyCode::KEY_7))
-    {
-      g_showLight = !g_showLight;
-    }
-
-    //*************************************************
-    // Draw Debug Icons
-    //*************************************************
-    DrawDebugIcons();
   }
 
   void RenderLoopOpengl::DrawDebugIcons()
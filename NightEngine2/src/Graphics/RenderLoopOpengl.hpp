@@ -6,6 +6,9 @@
 #pragma once
 
 #include "Graphics/IRenderLoop.hpp"
+#include "Graphics/RenderGraph.hpp"
+#include "Graphics/DynamicResolution.hpp"
+#include "Graphics/Occlusion/OcclusionCulling.hpp"
 #include "Core/EC/Handle.hpp"
 
 //FrameBuffer Test
@@ -20,10 +23,13 @@
 #include "Graphics/Opengl/UniformBufferObject.hpp"
 #include "Graphics/Opengl/IBL.hpp"
 #include "Graphics/Opengl/CameraObject.hpp"
+#include "Graphics/Opengl/RenderTargetPool.hpp"
+#include "Graphics/Opengl/GpuTimer.hpp"
 
 //Render Passes
 #include "Graphics/Opengl/RenderPass/DepthPrepass.hpp"
 #include "Graphics/Opengl/RenderPass/GBuffer.hpp"
+#include "Graphics/Opengl/RenderPass/ParticlePass.hpp"
 
 //Postprocess
 #include "Graphics/Opengl/Postprocess/SSAO.hpp"
@@ -69,6 +75,12 @@ namespace NightEngine::Rendering
   protected:
     void Render(void);
 
+    void RenderShadowCasters(void);
+
+    void RenderGBuffer(void);
+
+    void RenderDeferredLighting(void);
+
     void DrawDebugIcons(void);
 
     void SetDeferredLightingPassUniforms(Opengl::Material& material);
@@ -88,9 +100,24 @@ namespace NightEngine::Rendering
 
     Opengl::CameraObject m_camera{ Opengl::CameraObject::CameraType::PERSPECTIVE, 100.0f };
 
+    //Scale the camera viewport to hold the GPU frame time budget
+    bool enableDynamicResolution = false;
+    DynamicResolution m_dynamicResolution;
+
+    //Hide the MeshRenderers behind the occluder ones before the Drawer passes
+    bool enableOcclusionCulling = false;
+    Occlusion::OcclusionCulling m_occlusionCulling;
+
   protected:
     Opengl::SceneBuffer m_sceneBuffer;
 
+    //Frame's passes, rebuilt every frame, and the targets of its transient textures
+    RenderGraph                 m_renderGraph;
+    Opengl::RenderTargetPool    m_renderTargetPool;
+
+    //GPU time of Render, input of the dynamic resolution
+    Opengl::GpuTimer            m_frameGpuTimer;
+
     //Uniform Buffer Object
     Opengl::UniformBufferObject m_uniformBufferObject;
 
@@ -108,6 +135,7 @@ namespace NightEngine::Rendering
     Opengl::DepthPrepass        m_depthPrepass;
     Opengl::GBuffer             m_gbuffer;
     NightEngine::Rendering::Opengl::Prepass::CameraMotionVector m_cameraMotionVector;
+    Opengl::ParticlePass        m_particlePass;
 
     //PostProcess
     NightEngine::Rendering::Opengl::Postprocess::PostProcessSetting* m_postProcessSetting;
@@ -4,12 +4,15 @@
   @brief Contain the Implementation of Input
 */
 #include "Input/Input.hpp"
+#include "Input/InputEvent.hpp"
+#include "Input/InputRecorder.hpp"
 #include "Graphics/Opengl/Window.hpp"
 #include "Core/Logger.hpp"
 #include "UnitTest/UnitTest.hpp"
 
 #include <iostream>
-#include "Core/Container/Hashmap.hpp"
+#include <fstream>
+#include <algorithm>
 #include "Core/Container/Vector.hpp"
 
 using namespace std;
@@ -116,28 +119,22 @@ namespace Input
   //**************************************************************
   // Global Variables
   //**************************************************************
-	struct EnumClassHash
-	{
-		template <typename T>
-		std::size_t operator()(T t) const
-		{
-			return static_cast<std::size_t>(t);
-		}
-	};
-	
-	//Type Alias
-	using KeyStateMap = Container::HashmapCustom<KeyCode, KeyState, EnumClassHash>;
-	using JoyButtonStateMap = Container::HashmapCustom<JoyButtonCode, KeyState, EnumClassHash>;
-	using MouseInputStateMap = Container::HashmapCustom<MouseKeyCode, KeyState, EnumClassHash>;
 
-	//Data Container
-	static KeyStateMap g_keyStateMap;
-	static JoyButtonStateMap g_joyButtonStateMap[JOYSTICK_MAX];
-	static MouseInputStateMap g_mouseStateMap;
+	//Events pushed by the window callbacks, applied to the state once per frame
+	static InputEventRing g_eventRing;
+	static InputState g_inputState;
+
+	//Record/Replay
+	static InputRecording g_recording;
+	static InputReplay g_replay;
+	static Container::U32 g_recordingFrame = 0;
+	static bool g_recordingActive = false;
 
-	//Mouse data
-	Vector2 g_mousePos;
-	Vector2 g_lastMousePos;
+	//Callbacks installed before ours (e.g. ImGui), still called
+	static GLFWkeyfun g_prevKeyCallback = nullptr;
+	static GLFWmousebuttonfun g_prevMouseButtonCallback = nullptr;
+	static GLFWcursorposfun g_prevCursorPosCallback = nullptr;
+	static GLFWwindow* g_callbackWindow = nullptr;
 
   //TODO: MessageObject for toggle debugInput
   bool g_debugInput = false;  
@@ -148,153 +145,242 @@ namespace Input
   // Function Definition
   //**************************************************************
 
-	void UpdateKeyState(KeyCode keyCode)
+	void PushEvent(InputEventType type, int code, int action, float x = 0.0f, float y = 0.0f, int device = 0)
+	{
+		InputEvent inputEvent;
+		inputEvent.m_time = glfwGetTime();
+		inputEvent.m_type = type;
+		inputEvent.m_device = static_cast<Container::U8>(device);
+		inputEvent.m_code = static_cast<Container::U16>(code);
+		inputEvent.m_action = action;
+		inputEvent.m_x = x;
+		inputEvent.m_y = y;
+		g_eventRing.Push(inputEvent);
+	}
+
+	void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 	{
-		//Check previous and current state
-		int key = static_cast<int>(keyCode);
-		KeyState previousState = g_keyStateMap[keyCode];
-		bool press = Window::GetKeyboardInput(key) == GLFW_PRESS;
+		if (g_prevKeyCallback != nullptr)
+		{
+			g_prevKeyCallback(window, key, scancode, action, mods);
+		}
+		if (key >= 0 && action != GLFW_REPEAT)
+		{
+			PushEvent(InputEventType::KEY, key, action);
+		}
+	}
 
-		//Result Key State
-		KeyState state = KeyState::KEY_NONE;
-		if (press)
+	void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+	{
+		if (g_prevMouseButtonCallback != nullptr)
 		{
-			// Not pressed previously and start pressing
-			if(previousState == KeyState::KEY_NONE
-			|| previousState == KeyState::KEY_UP)
-			{
-				state = KeyState::KEY_DOWN;
-			}
-			else
-			{
-				state = KeyState::KEY_HOLD;
-			} 
+			g_prevMouseButtonCallback(window, button, action, mods);
 		}
-		// Pressed previously and now stop pressing
-		else if (previousState == KeyState::KEY_DOWN
-			|| previousState == KeyState::KEY_HOLD)
+		PushEvent(InputEventType::MOUSE_BUTTON, button, action);
+	}
+
+	void cursor_position_callback(GLFWwindow* window, double xpos, double ypos)
+	{
+		if (g_prevCursorPosCallback != nullptr)
 		{
-			state = KeyState::KEY_UP;
+			g_prevCursorPosCallback(window, xpos, ypos);
 		}
+		PushEvent(InputEventType::MOUSE_MOVE, 0, GLFW_PRESS
+			, static_cast<float>(xpos), static_cast<float>(ypos));
+	}
 
-		g_keyStateMap[keyCode] = state;
+	void InstallWindowCallbacks()
+	{
+		//Window was recreated, the callbacks have to be set again
+		GLFWwindow* window = Window::GetWindow();
+		if (window == nullptr || window == g_callbackWindow)
+		{
+			return;
+		}
+		g_callbackWindow = window;
+
+		g_prevKeyCallback = glfwSetKeyCallback(window, key_callback);
+		g_prevMouseButtonCallback = glfwSetMouseButtonCallback(window, mouse_button_callback);
+		g_prevCursorPosCallback = glfwSetCursorPosCallback(window, cursor_position_callback);
+
+		//Cursor callback only fire on move, start from the current position
+		double xpos, ypos;
+		glfwGetCursorPos(window, &xpos, &ypos);
+		PushEvent(InputEventType::MOUSE_MOVE, 0, GLFW_PRESS
+			, static_cast<float>(xpos), static_cast<float>(ypos));
+	}
+
+	void PollJoystickEvents()
+	{
+		//GLFW has no joystick button callback, push the changes since last frame
+		for (int joy = 0; joy < JOYSTICK_MAX; ++joy)
+		{
+			int count = 0;
+			const unsigned char* buttons = glfwJoystickPresent(GLFW_JOYSTICK_1 + joy) ?
+				glfwGetJoystickButtons(GLFW_JOYSTICK_1 + joy, &count) : nullptr;
+			count = buttons != nullptr ? std::min(count, InputState::c_JOY_BUTTON_COUNT) : 0;
+
+			for (int button = 0; button < count; ++button)
+			{
+				bool press = buttons[button] == GLFW_PRESS;
+				if (press != g_inputState.IsDown(InputEventType::JOY_BUTTON, button, joy))
+				{
+					PushEvent(InputEventType::JOY_BUTTON, button
+						, press ? GLFW_PRESS : GLFW_RELEASE, 0.0f, 0.0f, joy);
+				}
+			}
+		}
 	}
 
-	void UpdateKeyState(MouseKeyCode keyCode)
+	void UpdateAllInputState()
 	{
-		//Check previous and current state
-		int key = static_cast<int>(keyCode);
-		KeyState previousState = g_mouseStateMap[keyCode];
-		bool press = Window::GetMouseInput(key) == GLFW_PRESS;
+		InstallWindowCallbacks();
+		PollJoystickEvents();
 
-		//Result Key State
-		KeyState state = KeyState::KEY_NONE;
-		if (press)
+		//Live events are consumed but ignored while replaying
+		g_inputState.BeginFrame();
+		InputEvent inputEvent;
+		while (g_eventRing.Pop(inputEvent))
 		{
-			// Not pressed previously and start pressing
-			if (previousState == KeyState::KEY_NONE
-				|| previousState == KeyState::KEY_UP)
+			if (g_replay.IsFinished())
 			{
-				state = KeyState::KEY_DOWN;
+				g_inputState.Apply(inputEvent);
 			}
-			else
+			if (g_recordingActive)
 			{
-				state = KeyState::KEY_HOLD;
+				g_recording.Add(g_recordingFrame, inputEvent);
 			}
 		}
-		// Pressed previously and now stop pressing
-		else if (previousState == KeyState::KEY_DOWN
-			|| previousState == KeyState::KEY_HOLD)
+
+		if (g_recordingActive)
 		{
-			state = KeyState::KEY_UP;
+			g_recording.SetFrameCount(++g_recordingFrame);
 		}
 
-		g_mouseStateMap[keyCode] = state;
+		if (!g_replay.IsFinished())
+		{
+			g_replay.ReplayFrame(g_inputState);
+			if (g_replay.IsFinished())
+			{
+				Debug::Log << "Input Replay Finished\n";
+			}
+		}
 	}
 
-	void UpdateKeyState(JoyStickNumber joyNumber,JoyButtonCode keyCode)
+	/////////////////////////////////////////////////////////////////////////
+
+	bool BeginRecording()
 	{
-		//Check previous and current state
-		int key = static_cast<int>(keyCode);
-    int joyNumIndex = static_cast<int>(joyNumber);
-		KeyState previousState = g_joyButtonStateMap[joyNumIndex][keyCode];
+		if (g_recordingActive || IsReplaying())
+		{
+			return false;
+		}
 
-		//Get amount of Input count
-		int count;
-		const unsigned char* button = glfwGetJoystickButtons(GLFW_JOYSTICK_1, &count);
+		g_recording.Clear();
+		g_recordingFrame = 0;
+		g_recordingActive = true;
 
-		//No input, just return
-		if(count == 0){return;}
-		bool press = count > key? button[key] == GLFW_PRESS:false;
+		//Buttons already down and the cursor are the starting state of the replay
+		InputEvent inputEvent;
+		inputEvent.m_time = glfwGetTime();
+		inputEvent.m_action = GLFW_PRESS;
+		inputEvent.m_type = InputEventType::MOUSE_MOVE;
+		inputEvent.m_x = g_inputState.GetMousePosition().x;
+		inputEvent.m_y = g_inputState.GetMousePosition().y;
+		g_recording.Add(0, inputEvent);
 
-		//Result Key State
-		KeyState state = KeyState::KEY_NONE;
-		if (press)
+		for (int key = 0; key < InputState::c_KEY_COUNT; ++key)
 		{
-			// Not pressed previously and start pressing
-			if (previousState == KeyState::KEY_NONE
-				|| previousState == KeyState::KEY_UP)
-			{
-				state = KeyState::KEY_DOWN;
-			}
-			else
+			if (g_inputState.IsDown(InputEventType::KEY, key))
 			{
-				state = KeyState::KEY_HOLD;
+				inputEvent.m_type = InputEventType::KEY;
+				inputEvent.m_code = static_cast<Container::U16>(key);
+				g_recording.Add(0, inputEvent);
 			}
 		}
-		// Pressed previously and now stop pressing
-		else if (previousState == KeyState::KEY_DOWN
-			|| previousState == KeyState::KEY_HOLD)
+		for (int button = 0; button < InputState::c_MOUSE_BUTTON_COUNT; ++button)
 		{
-			state = KeyState::KEY_UP;
+			if (g_inputState.IsDown(InputEventType::MOUSE_BUTTON, button))
+			{
+				inputEvent.m_type = InputEventType::MOUSE_BUTTON;
+				inputEvent.m_code = static_cast<Container::U16>(button);
+				g_recording.Add(0, inputEvent);
+			}
 		}
 
-		g_joyButtonStateMap[joyNumIndex][keyCode] = state;
+		Debug::Log << "Input Recording Started\n";
+		return true;
 	}
 
-	void UpdateAllInputState()
+	bool EndRecording(const std::string& filePath)
 	{
-		//Update all Registered KeyState
-		for (auto keyCode : keyCodeEnumArray)
+		if (!g_recordingActive)
 		{
-			UpdateKeyState(keyCode);
+			return false;
 		}
+		g_recordingActive = false;
+
+		std::ofstream file(filePath, std::ios::binary);
+		bool saved = file && g_recording.Write(file);
+		Debug::Log << "Input Recording Saved (" << g_recording.GetFrameCount() << " frames, "
+			<< g_recording.GetEvents().size() << " events): " << filePath
+			<< (saved ? "\n" : " FAILED\n");
+		return saved;
+	}
 
-		//Update all mouse state
-		for (auto keyCode : mouseKeyCodeEnumArray)
+	bool BeginReplay(const std::string& filePath)
+	{
+		if (g_recordingActive)
 		{
-			UpdateKeyState(keyCode);
+			return false;
 		}
 
-		//Update all joy button state
-		for (auto keyCode : joyButtonEnumArray)
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file || !g_recording.Read(file))
 		{
-      UpdateKeyState(JoyStickNumber::Joy_1,keyCode);
+			Debug::Log << Logger::MessageType::WARNING
+				<< "Input Replay: invalid recording " << filePath << '\n';
+			return false;
 		}
+
+		g_replay.Begin(g_recording, g_inputState);
+		Debug::Log << "Input Replay Started (" << g_recording.GetFrameCount() << " frames)\n";
+		return true;
+	}
+
+	bool IsRecording()
+	{
+		return g_recordingActive;
+	}
+
+	bool IsReplaying()
+	{
+		return !g_replay.IsFinished();
 	}
 
 	/////////////////////////////////////////////////////////////////////////
 
-	KeyState GetKeyState(KeyCode keyCode)
+	//A press and release in the same frame is both down and up
+	bool IsPressed(InputEventType type, int code, int device = 0)
 	{
-		return g_keyStateMap[keyCode];
+		return g_inputState.IsPressed(type, code, device);
 	}
 
-	KeyState GetMouseState(MouseKeyCode keyCode)
+	bool IsReleased(InputEventType type, int code, int device = 0)
 	{
-		return g_mouseStateMap[keyCode];
+		return g_inputState.IsReleased(type, code, device);
 	}
 
-	KeyState GetJoyButtonState(JoyStickNumber joyNumber,JoyButtonCode keyCode)
+	bool IsHeld(InputEventType type, int code, int device = 0)
 	{
-		return g_joyButtonStateMap[static_cast<int>(joyNumber)][keyCode];
+		return g_inputState.IsHeld(type, code, device);
 	}
 
 	/////////////////////////////////////////////////////////////////////////
 
 	bool GetMouseUp(MouseKeyCode keyCode)
 	{
-		return GetMouseState(keyCode) == KeyState::KEY_UP;
+		return IsReleased(InputEventType::MOUSE_BUTTON, static_cast<int>(keyCode));
 	}
 
   bool GetMouseUp(unsigned keyCode)
@@ -304,7 +390,7 @@ namespace Input
 
 	bool GetMouseDown(MouseKeyCode keyCode)
 	{
-		return GetMouseState(keyCode) == KeyState::KEY_DOWN;
+		return IsPressed(InputEventType::MOUSE_BUTTON, static_cast<int>(keyCode));
 	}
 
   bool GetMouseDown(unsigned keyCode)
@@ -314,7 +400,7 @@ namespace Input
 
 	bool GetMouseHold(MouseKeyCode keyCode)
 	{
-		return GetMouseState(keyCode) == KeyState::KEY_HOLD;
+		return IsHeld(InputEventType::MOUSE_BUTTON, static_cast<int>(keyCode));
 	}
 
   bool GetMouseHold(unsigned keyCode)
@@ -334,36 +420,21 @@ namespace Input
 			<< ", " << toPrint.z << '\n';
 	}
 
-	void UpdateMousePosition()
-	{
-		double xpos, ypos;
-		glfwGetCursorPos(Window::GetWindow(), &xpos, &ypos);
-
-		g_lastMousePos = g_mousePos;
-		g_mousePos.x = xpos;
-		g_mousePos.y = ypos;
-
-		//Print(g_lastMousePos);
-		//Print(GetMouseOffset());
-	}
-
 	Vector2 GetMousePosition()
 	{
-		return g_mousePos;
+		return g_inputState.GetMousePosition();
 	}
 
 	Vector2 GetMouseOffset()
 	{
-		//glm::vec2 offset = g_mousePos - g_lastMousePos;
-		//offset.y = -offset.y;
-		return g_mousePos - g_lastMousePos;
+		return g_inputState.GetMouseOffset();
 	}
 
 	/////////////////////////////////////////////////////////////////////////
 
 	bool GetKeyUp(KeyCode keyCode)
 	{
-		return GetKeyState(keyCode) == KeyState::KEY_UP;
+		return IsReleased(InputEventType::KEY, static_cast<int>(keyCode));
 	}
 
   bool GetKeyUp(int keyCode)
@@ -373,7 +444,7 @@ namespace Input
 
 	bool GetKeyDown(KeyCode keyCode)
 	{
-		return GetKeyState(keyCode) == KeyState::KEY_DOWN;
+		return IsPressed(InputEventType::KEY, static_cast<int>(keyCode));
 	}
 
   bool GetKeyDown(int keyCode)
@@ -383,7 +454,7 @@ namespace Input
 
 	bool GetKeyHold(KeyCode keyCode)
 	{
-		return GetKeyState(keyCode) == KeyState::KEY_HOLD;
+		return IsHeld(InputEventType::KEY, static_cast<int>(keyCode));
 	}
 
   bool GetKeyHold(int keyCode)
@@ -453,7 +524,7 @@ namespace Input
 
 	bool GetJoyButtonUp(JoyStickNumber joyNumber, JoyButtonCode button)
 	{
-		return GetJoyButtonState(joyNumber, button) == KeyState::KEY_UP;
+		return IsReleased(InputEventType::JOY_BUTTON, static_cast<int>(button), static_cast<int>(joyNumber));
 	}
 
   bool GetJoyButtonUp(unsigned joyNumber, unsigned joyButton)
@@ -463,7 +534,7 @@ namespace Input
 
 	bool GetJoyButtonDown(JoyStickNumber joyNumber, JoyButtonCode button)
 	{
-		return GetJoyButtonState(joyNumber,button) == KeyState::KEY_DOWN;
+		return IsPressed(InputEventType::JOY_BUTTON, static_cast<int>(button), static_cast<int>(joyNumber));
 	}
 
   bool GetJoyButtonDown(unsigned joyNumber, unsigned joyButton)
@@ -473,7 +544,7 @@ namespace Input
 
 	bool GetJoyButtonHold(JoyStickNumber joyNumber, JoyButtonCode button)
 	{
-		return GetJoyButtonState(joyNumber,button) == KeyState::KEY_HOLD;
+		return IsHeld(InputEventType::JOY_BUTTON, static_cast<int>(button), static_cast<int>(joyNumber));
 	}
 
   bool GetJoyButtonHold(unsigned joyNumber, unsigned joyButton)
@@ -578,16 +649,14 @@ namespace Input
 
 		//Set Callback function
 		glfwSetJoystickCallback(joystick_callback);
+		InstallWindowCallbacks();
 	}
 
 	void OnUpdate()
 	{
-		//Update all key state for this frame
+		//Apply the events of this frame to the key and mouse state
 		UpdateAllInputState();
 
-		//Update mouse pos state
-		UpdateMousePosition();
-
     //Cursor mode Shortcut
     bool ctrl = Input::GetKeyHold(KeyCode::KEY_LEFT_CONTROL);
     if (ctrl)
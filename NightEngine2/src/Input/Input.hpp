@@ -8,6 +8,8 @@
 #include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
 
+#include <string>
+
 namespace Input
 {
 	//Type Aliasing
@@ -117,6 +119,21 @@ namespace Input
 
 	/////////////////////////////////////////////////////////////////////////
 
+	//! @brief Start recording the input events of every frame
+	bool BeginRecording();
+
+	//! @brief Stop recording and save it to filePath
+	bool EndRecording(const std::string& filePath);
+
+	//! @brief Replace the live input with a recording until it ends
+	bool BeginReplay(const std::string& filePath);
+
+	bool IsRecording();
+
+	bool IsReplaying();
+
+	/////////////////////////////////////////////////////////////////////////
+
 	void Initialize();
 
 	void OnUpdate();
@@ -0,0 +1,166 @@
+/*!
+  @file InputEvent.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of InputEvent
+*/
+#include "Input/InputEvent.hpp"
+
+using namespace NightEngine::Container;
+
+namespace Input
+{
+  bool InputEventRing::Push(const InputEvent& inputEvent)
+  {
+    U32 tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) >= c_CAPACITY)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    m_events[tail & (c_CAPACITY - 1)] = inputEvent;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool InputEventRing::Pop(InputEvent& inputEvent)
+  {
+    U32 head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    inputEvent = m_events[head & (c_CAPACITY - 1)];
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  template<size_t N>
+  void InputState::ButtonBits<N>::Apply(int code, bool press)
+  {
+    if (press && !m_down[code])
+    {
+      m_down.set(code);
+      m_pressed.set(code);
+    }
+    else if (!press && m_down[code])
+    {
+      m_down.reset(code);
+      m_released.set(code);
+    }
+  }
+
+  void InputState::BeginFrame(void)
+  {
+    m_keys.BeginFrame();
+    m_mouseButtons.BeginFrame();
+    for (auto& joyButtons : m_joyButtons)
+    {
+      joyButtons.BeginFrame();
+    }
+    m_lastMousePos = m_mousePos;
+  }
+
+  void InputState::Reset(void)
+  {
+    m_keys.Reset();
+    m_mouseButtons.Reset();
+    for (auto& joyButtons : m_joyButtons)
+    {
+      joyButtons.Reset();
+    }
+    m_lastMousePos = m_mousePos;
+  }
+
+  void InputState::Apply(const InputEvent& inputEvent)
+  {
+    m_lastEventTime = inputEvent.m_time;
+
+    //Repeats don't change the state
+    bool press = inputEvent.m_action == GLFW_PRESS;
+    if (!press && inputEvent.m_action != GLFW_RELEASE
+      && inputEvent.m_type != InputEventType::MOUSE_MOVE)
+    {
+      return;
+    }
+
+    int code = inputEvent.m_code;
+    switch (inputEvent.m_type)
+    {
+      case InputEventType::KEY:
+      {
+        if (code < c_KEY_COUNT)
+        {
+          m_keys.Apply(code, press);
+        }
+        break;
+      }
+      case InputEventType::MOUSE_BUTTON:
+      {
+        if (code < c_MOUSE_BUTTON_COUNT)
+        {
+          m_mouseButtons.Apply(code, press);
+        }
+        break;
+      }
+      case InputEventType::MOUSE_MOVE:
+      {
+        m_mousePos = glm::vec2(inputEvent.m_x, inputEvent.m_y);
+        break;
+      }
+      case InputEventType::JOY_BUTTON:
+      {
+        if (code < c_JOY_BUTTON_COUNT && inputEvent.m_device < c_JOYSTICK_COUNT)
+        {
+          m_joyButtons[inputEvent.m_device].Apply(code, press);
+        }
+        break;
+      }
+    }
+  }
+
+  template<typename Fn>
+  bool InputState::Query(InputEventType type, int code, int device, Fn fn) const
+  {
+    switch (type)
+    {
+      case InputEventType::KEY:
+        return code >= 0 && code < c_KEY_COUNT && fn(m_keys, code);
+      case InputEventType::MOUSE_BUTTON:
+        return code >= 0 && code < c_MOUSE_BUTTON_COUNT && fn(m_mouseButtons, code);
+      case InputEventType::JOY_BUTTON:
+        return code >= 0 && code < c_JOY_BUTTON_COUNT
+          && device >= 0 && device < c_JOYSTICK_COUNT
+          && fn(m_joyButtons[device], code);
+      default:
+        return false;
+    }
+  }
+
+  bool InputState::IsPressed(InputEventType type, int code, int device) const
+  {
+    return Query(type, code, device
+      , [](const auto& bits, int i) { return bits.m_pressed[i]; });
+  }
+
+  bool InputState::IsReleased(InputEventType type, int code, int device) const
+  {
+    return Query(type, code, device
+      , [](const auto& bits, int i) { return bits.m_released[i]; });
+  }
+
+  bool InputState::IsHeld(InputEventType type, int code, int device) const
+  {
+    return Query(type, code, device
+      , [](const auto& bits, int i) { return bits.m_down[i] && !bits.m_pressed[i]; });
+  }
+
+  bool InputState::IsDown(InputEventType type, int code, int device) const
+  {
+    return Query(type, code, device
+      , [](const auto& bits, int i) { return bits.m_down[i]; });
+  }
+} // Input
@@ -0,0 +1,120 @@
+/*!
+  @file InputEvent.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of InputEvent
+*/
+#pragma once
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <GLFW/glfw3.h>
+#include "glm/vec2.hpp"
+
+#include <atomic>
+#include <bitset>
+
+namespace Input
+{
+  enum class InputEventType : NightEngine::Container::U8
+  {
+    KEY = 0,
+    MOUSE_BUTTON,
+    MOUSE_MOVE,
+    JOY_BUTTON
+  };
+
+  //! @brief One input change, as reported by the window callbacks
+  struct InputEvent
+  {
+    double                          m_time = 0.0;    //Seconds since glfwInit
+    InputEventType                  m_type = InputEventType::KEY;
+    NightEngine::Container::U8      m_device = 0;    //Joystick number
+    NightEngine::Container::U16     m_code = 0;      //Key, mouse button or joy button
+    NightEngine::Container::I32     m_action = 0;    //GLFW_PRESS or GLFW_RELEASE
+    float                           m_x = 0.0f;      //Cursor position for MOUSE_MOVE
+    float                           m_y = 0.0f;
+  };
+
+  //! @brief Lock free single producer, single consumer queue of InputEvent.
+  // The window callbacks push, the input update pop once per frame.
+  class InputEventRing
+  {
+  public:
+    static constexpr NightEngine::Container::U32 c_CAPACITY = 1024;   //Power of two
+
+    //! @brief Push an event, false and counted as dropped if full
+    bool Push(const InputEvent& inputEvent);
+
+    //! @brief Pop the oldest event, false if empty
+    bool Pop(InputEvent& inputEvent);
+
+    //! @brief Events lost because the ring was full
+    NightEngine::Container::U32 GetDroppedCount(void) const { return m_dropped.load(std::memory_order_relaxed); }
+  private:
+    InputEvent                                m_events[c_CAPACITY];
+    std::atomic<NightEngine::Container::U32>  m_head{ 0 };    //Next to pop, written by the consumer
+    std::atomic<NightEngine::Container::U32>  m_tail{ 0 };    //Next to push, written by the producer
+    std::atomic<NightEngine::Container::U32>  m_dropped{ 0 };
+  };
+
+  //! @brief Button states of a frame computed from the event stream. A press and
+  // release inside one frame is reported as both down and up for that frame.
+  class InputState
+  {
+  public:
+    static constexpr int c_KEY_COUNT = GLFW_KEY_LAST + 1;
+    static constexpr int c_MOUSE_BUTTON_COUNT = GLFW_MOUSE_BUTTON_LAST + 1;
+    static constexpr int c_JOYSTICK_COUNT = 4;
+    static constexpr int c_JOY_BUTTON_COUNT = 32;
+
+    //! @brief Forget the pressed and released of last frame
+    void BeginFrame(void);
+
+    //! @brief Release everything
+    void Reset(void);
+
+    //! @brief Apply an event to the current frame
+    void Apply(const InputEvent& inputEvent);
+
+    //! @brief Went down this frame
+    bool IsPressed(InputEventType type, int code, int device = 0) const;
+
+    //! @brief Went up this frame
+    bool IsReleased(InputEventType type, int code, int device = 0) const;
+
+    //! @brief Down since an earlier frame
+    bool IsHeld(InputEventType type, int code, int device = 0) const;
+
+    //! @brief Currently down
+    bool IsDown(InputEventType type, int code, int device = 0) const;
+
+    glm::vec2 GetMousePosition(void) const { return m_mousePos; }
+    glm::vec2 GetMouseOffset(void) const { return m_mousePos - m_lastMousePos; }
+
+    //! @brief Time of the last applied event
+    double GetLastEventTime(void) const { return m_lastEventTime; }
+  private:
+    template<size_t N>
+    struct ButtonBits
+    {
+      std::bitset<N> m_down;
+      std::bitset<N> m_pressed;
+      std::bitset<N> m_released;
+
+      void BeginFrame(void) { m_pressed.reset(); m_released.reset(); }
+      void Reset(void) { m_down.reset(); BeginFrame(); }
+      void Apply(int code, bool press);
+    };
+
+    //! @brief Call fn with the bits of the device and the code, false if out of range
+    template<typename Fn>
+    bool Query(InputEventType type, int code, int device, Fn fn) const;
+
+    ButtonBits<c_KEY_COUNT>           m_keys;
+    ButtonBits<c_MOUSE_BUTTON_COUNT>  m_mouseButtons;
+    ButtonBits<c_JOY_BUTTON_COUNT>    m_joyButtons[c_JOYSTICK_COUNT];
+
+    glm::vec2 m_mousePos{ 0.0f };
+    glm::vec2 m_lastMousePos{ 0.0f };
+    double    m_lastEventTime = 0.0;
+  };
+} // Input
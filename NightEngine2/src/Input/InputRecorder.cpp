@@ -0,0 +1,139 @@
+/*!
+  @file InputRecorder.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Implementation of InputRecorder
+*/
+#include "Input/InputRecorder.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+using namespace NightEngine::Container;
+
+namespace Input
+{
+  static const char c_RECORDING_MAGIC[4] = { 'N', 'E', 'I', 'R' };
+  static const U32  c_RECORDING_VERSION = 1;
+
+  //Fields are written one by one in the host byte order, the struct padding isn't stored
+  template<typename T>
+  static void WriteValue(std::ostream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template<typename T>
+  static bool ReadValue(std::istream& stream, T& value)
+  {
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void InputRecording::Add(U32 frame, const InputEvent& inputEvent)
+  {
+    m_events.emplace_back(RecordedInputEvent{ frame, inputEvent });
+    m_frameCount = std::max(m_frameCount, frame + 1);
+  }
+
+  void InputRecording::SetFrameCount(U32 frameCount)
+  {
+    m_frameCount = std::max(m_frameCount, frameCount);
+  }
+
+  bool InputRecording::Write(std::ostream& stream) const
+  {
+    stream.write(c_RECORDING_MAGIC, sizeof(c_RECORDING_MAGIC));
+    WriteValue(stream, c_RECORDING_VERSION);
+    WriteValue(stream, m_frameCount);
+    WriteValue(stream, static_cast<U32>(m_events.size()));
+
+    for (auto& recorded : m_events)
+    {
+      const InputEvent& e = recorded.m_event;
+      WriteValue(stream, recorded.m_frame);
+      WriteValue(stream, e.m_time);
+      WriteValue(stream, static_cast<U8>(e.m_type));
+      WriteValue(stream, e.m_device);
+      WriteValue(stream, e.m_code);
+      WriteValue(stream, e.m_action);
+      WriteValue(stream, e.m_x);
+      WriteValue(stream, e.m_y);
+    }
+    return static_cast<bool>(stream);
+  }
+
+  bool InputRecording::Read(std::istream& stream)
+  {
+    Clear();
+
+    char magic[4];
+    U32 version = 0, frameCount = 0, eventCount = 0;
+    if (!stream.read(magic, sizeof(magic))
+      || !std::equal(magic, magic + 4, c_RECORDING_MAGIC)
+      || !ReadValue(stream, version) || version != c_RECORDING_VERSION
+      || !ReadValue(stream, frameCount)
+      || !ReadValue(stream, eventCount))
+    {
+      return false;
+    }
+
+    m_events.reserve(eventCount);
+    for (U32 i = 0; i < eventCount; ++i)
+    {
+      RecordedInputEvent recorded;
+      InputEvent& e = recorded.m_event;
+      U8 type = 0;
+      bool valid = ReadValue(stream, recorded.m_frame)
+        && ReadValue(stream, e.m_time)
+        && ReadValue(stream, type)
+        && ReadValue(stream, e.m_device)
+        && ReadValue(stream, e.m_code)
+        && ReadValue(stream, e.m_action)
+        && ReadValue(stream, e.m_x)
+        && ReadValue(stream, e.m_y);
+      if (!valid || type > static_cast<U8>(InputEventType::JOY_BUTTON)
+        || (!m_events.empty() && recorded.m_frame < m_events.back().m_frame))
+      {
+        Clear();
+        return false;
+      }
+
+      e.m_type = static_cast<InputEventType>(type);
+      Add(recorded.m_frame, e);
+    }
+
+    SetFrameCount(frameCount);
+    return true;
+  }
+
+  /////////////////////////////////////////////////////////////////////////
+
+  void InputReplay::Begin(const InputRecording& recording, InputState& state)
+  {
+    m_recording = &recording;
+    m_cursor = 0;
+    m_frame = 0;
+    state.Reset();
+  }
+
+  bool InputReplay::ReplayFrame(InputState& state)
+  {
+    if (IsFinished())
+    {
+      return false;
+    }
+
+    state.BeginFrame();
+    auto& events = m_recording->GetEvents();
+    while (m_cursor < events.size() && events[m_cursor].m_frame == m_frame)
+    {
+      state.Apply(events[m_cursor].m_event);
+      ++m_cursor;
+    }
+
+    ++m_frame;
+    return true;
+  }
+} // Input
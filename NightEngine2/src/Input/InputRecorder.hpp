@@ -0,0 +1,65 @@
+/*!
+  @file InputRecorder.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of InputRecorder
+*/
+#pragma once
+#include "Input/InputEvent.hpp"
+
+#include <iosfwd>
+#include <vector>
+
+namespace Input
+{
+  //! @brief InputEvent with the frame that applied it, relative to the recording start
+  struct RecordedInputEvent
+  {
+    NightEngine::Container::U32 m_frame;
+    InputEvent                  m_event;
+  };
+
+  //! @brief Input events of a session, serialized to a binary stream
+  class InputRecording
+  {
+  public:
+    //! @brief Append an event, frames must not decrease
+    void Add(NightEngine::Container::U32 frame, const InputEvent& inputEvent);
+
+    //! @brief Remove every event
+    void Clear(void) { m_events.clear(); m_frameCount = 0; }
+
+    //! @brief Make the recording last at least frameCount frames
+    void SetFrameCount(NightEngine::Container::U32 frameCount);
+
+    //! @brief Frames from the start to the end of the recording
+    NightEngine::Container::U32 GetFrameCount(void) const { return m_frameCount; }
+
+    const std::vector<RecordedInputEvent>& GetEvents(void) const { return m_events; }
+
+    //! @brief Write the recording, false on stream error
+    bool Write(std::ostream& stream) const;
+
+    //! @brief Replace the recording with the one in stream, false if it isn't a valid recording
+    bool Read(std::istream& stream);
+  private:
+    std::vector<RecordedInputEvent> m_events;
+    NightEngine::Container::U32     m_frameCount = 0;
+  };
+
+  //! @brief Feed a recording to an InputState, one frame per call
+  class InputReplay
+  {
+  public:
+    //! @brief Start from the first frame of recording, with every button released
+    void Begin(const InputRecording& recording, InputState& state);
+
+    //! @brief Apply the events of the next frame, false once the recording is over
+    bool ReplayFrame(InputState& state);
+
+    bool IsFinished(void) const { return m_recording == nullptr || m_frame >= m_recording->GetFrameCount(); }
+  private:
+    const InputRecording*       m_recording = nullptr;
+    size_t                      m_cursor = 0;
+    NightEngine::Container::U32 m_frame = 0;
+  };
+} // Input
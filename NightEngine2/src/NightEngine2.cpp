@@ -16,6 +16,7 @@
 #include "Core/Logger.hpp"
 #include "Core/Utility/Utility.hpp"
 #include "Core/Utility/Profiling.hpp"
+#include "Core/Utility/JobSystem.hpp"
 
 #include "Core/GameTime.hpp"
 #include "Input/Input.hpp"
@@ -28,6 +29,18 @@
 #include "Graphics/Opengl/OpenglAllocationTracker.hpp"
 #include "Graphics/Opengl/Window.hpp"
 #include "Graphics/Opengl/ShaderTracker.hpp"
+#include "Graphics/Opengl/ShaderCache.hpp"
+#include "Graphics/Opengl/MaterialBuffer.hpp"
+#include "Graphics/Opengl/SkinningPalette.hpp"
+#include "Graphics/Animation/AnimationSystem.hpp"
+#include "Graphics/Particles/ParticleSystem.hpp"
+#include "Core/Serialization/HotReload.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
+#include "Core/Serialization/FileSystem.hpp"
+#include "Core/Container/MurmurHash2.hpp"
+#include "Graphics/Opengl/Texture.hpp"
+#include "Graphics/Opengl/Model.hpp"
 
 #include "Graphics/RenderDoc/RenderDocManager.hpp"
 
@@ -52,6 +65,30 @@ namespace NightEngine
 
   Engine* Engine::s_instance = nullptr;
 
+  static std::string GetAssetDatabaseFilePath(void)
+  {
+    return FileSystem::GetFilePath(c_ASSET_DATABASE_FILE, FileSystem::DirectoryType::Assets);
+  }
+
+  //! @brief Load the asset records, register the cookers and rehash what changed
+  static void InitializeAssetDatabase(void)
+  {
+    auto& assetDatabase = GetAssetDatabase();
+    assetDatabase.Load(GetAssetDatabaseFilePath());
+
+    Texture::RegisterCooker(assetDatabase);
+    Model::RegisterCooker(assetDatabase);
+    const char c_JSON_SETTINGS[] = "JsonReferences|v1";
+    U64 jsonSettings = ConvertToHash(c_JSON_SETTINGS, sizeof(c_JSON_SETTINGS) - 1);
+    assetDatabase.RegisterCooker(AssetType::MATERIAL, jsonSettings, CookJsonReferences);
+    assetDatabase.RegisterCooker(AssetType::SCENE, jsonSettings, CookJsonReferences);
+
+    //Only stat and hash, outputs are cooked on load or by CookAssets
+    size_t changedCount = assetDatabase.Refresh();
+    Debug::Log << Logger::MessageType::INFO << "AssetDatabase: "
+      << assetDatabase.GetRecordCount() << " assets, " << changedCount << " changed\n";
+  }
+
   void Engine::Initialize(void)
   {
     PROFILE_SESSION_BEGIN(nightengine2_profile_session_init);
@@ -64,6 +101,13 @@ namespace NightEngine
       *m_gameTime = GameTime{ c_renderFPS, c_simulationFPS, c_AVR_FRAMERATE_SAMPLE };
       m_gameTime->Subscribe(NightEngine::MessageType::MSG_GAMESHOULDQUIT);
 
+      //Worker threads
+      JobSystem::Initialize();
+
+      //Asset files, loose or packed
+      VirtualFileSystem::Initialize();
+      InitializeAssetDatabase();
+
       //Physics
       g_physicScene = new PhysicsScene();
 
@@ -82,6 +126,9 @@ namespace NightEngine
       if (m_renderloop == nullptr)
       {
         Window::Initialize("NightEngine", Window::WindowMode::WINDOW);
+        ShaderCache::Initialize();
+        MaterialBuffer::Initialize();
+        SkinningPalette::Initialize();
         m_renderloop = new RenderLoopOpengl();
         m_renderloop->Initialize();
       }
@@ -91,6 +138,10 @@ namespace NightEngine
 
       SceneManager::Initialize();
       Input::Initialize();
+      HotReload::Initialize();
+
+      //Startup is long enough a reference for the timestamp frequency
+      Profiling::Calibrate();
 
       //TODO: Scene Init, Update, Terminate
     }
@@ -105,6 +156,7 @@ namespace NightEngine
       Debug::Log << "NightEngine::Terminate\n";
 
       //Terminate System
+      HotReload::Terminate();
       Input::Terminate();
       SceneManager::Terminate();
 
@@ -123,17 +175,54 @@ namespace NightEngine
       Factory::Terminate();
       Reflection::Terminate();
 
+      //Guids and hashes of the assets loaded this run
+      GetAssetDatabase().Save(GetAssetDatabaseFilePath());
+
+      VirtualFileSystem::Terminate();
+      JobSystem::Terminate();
+      Debug::Log.Flush();
 
       m_gameTime->UnsubscribeAll();
     }
     PROFILE_SESSION_END();
   }
 
+  size_t Engine::CookAssets(void)
+  {
+    auto& assetDatabase = GetAssetDatabase();
+    assetDatabase.Refresh();
+    size_t cookedCount = assetDatabase.Cook();
+    assetDatabase.Save(GetAssetDatabaseFilePath());
+    return cookedCount;
+  }
+
+  int Engine::RunCookTarget(void)
+  {
+    Debug::Log << "NightEngine::RunCookTarget\n";
+    JobSystem::Initialize();
+    VirtualFileSystem::Initialize();
+    InitializeAssetDatabase();
+
+    NightEngine::Utility::StopWatch stopWatch{ true };
+    size_t cookedCount = CookAssets();
+    stopWatch.Stop();
+    Debug::Log << Logger::MessageType::INFO << "Cooked " << cookedCount << " assets in "
+      << stopWatch.GetElapsedTimeMilli() << " ms\n";
+
+    VirtualFileSystem::Terminate();
+    JobSystem::Terminate();
+    Debug::Log.Flush();
+    return 0;
+  }
+
   void Engine::MainLoop(void)
   {
     while (!m_gameTime->m_shouldClose)
     {
       m_gameTime->BeginFrame();
+
+      //Logger thread formatted lines, DevConsole only live on the main thread
+      Debug::Log.SendLogToDevConsole();
       PROFILE_BLOCK_INSTRUMENT("GameLoop")
       {
         float dt = m_gameTime->m_deltaTimeSeconds;
@@ -185,6 +274,12 @@ namespace NightEngine
           break;
         }
       }
+
+      //Changed asset files, only the affected resources reload
+      if (HotReload::Update())
+      {
+        m_renderloop->OnRecompiledShader();
+      }
     }
   }
 
@@ -221,6 +316,8 @@ namespace NightEngine
     //Update Systems
     Input::OnUpdate();
     SceneManager::Update(dt);
+    Rendering::Animation::AnimationSystem::Update(dt);
+    Rendering::Particles::ParticleSystem::Update(dt);
 
     //TODO: Update all the Components
   }
@@ -262,6 +359,9 @@ namespace NightEngine
       if (m_renderloop == nullptr)
       {
         Window::Initialize("NightEngine", Window::WindowMode::WINDOW);
+        ShaderCache::Initialize();
+        MaterialBuffer::Initialize();
+        SkinningPalette::Initialize();
         m_renderloop = new RenderLoopOpengl();
         m_renderloop->Initialize();
         CHECKGL_ERROR();
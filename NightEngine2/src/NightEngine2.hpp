@@ -5,6 +5,9 @@
 */
 #pragma once
 
+// Standard Headers
+#include <cstddef>
+
 namespace NightEngine::Rendering
 {
   enum class DebugView;
@@ -39,6 +42,12 @@ namespace NightEngine
 
     static Engine* GetInstance(){ return s_instance; }
 
+    //! @brief Rehash the assets and cook the ones missing from the asset cache, in parallel
+    static size_t CookAssets(void);
+
+    //! @brief Cook the assets without opening a window, for "--cook"
+    static int RunCookTarget(void);
+
     NightEngine::Rendering::IRenderLoop* GetRenderLoop(void) { return m_renderloop; }
 
   private:
@@ -0,0 +1,163 @@
+/*!
+  @file PhysicsQuery.hpp
+  @author Rittikorn Tangtrongchit
+  @brief Contain the Interface of PhysicsQuery
+*/
+
+#pragma once
+#include "Core/EC/Handle.hpp"
+#include "Core/Container/Vector.hpp"
+#include "Core/Container/PrimitiveType.hpp"
+
+#include <glm/vec3.hpp>
+
+//Forward Declaration
+namespace NightEngine::EC
+{
+  class GameObject;
+}
+
+namespace Physics
+{
+  //! brief Default batch size for splitting queries across worker threads
+  constexpr size_t c_DEFAULT_QUERY_BATCH_SIZE = 64;
+
+  //! brief Closest hit output of a batch, one entry per query (SoA)
+  struct QueryHitResult
+  {
+    NightEngine::Container::Vector<NightEngine::Container::U8>  m_hit;
+    NightEngine::Container::Vector<float>                       m_hitFraction;
+    NightEngine::Container::Vector<glm::vec3>                   m_hitPoint;
+    NightEngine::Container::Vector<glm::vec3>                   m_hitNormal;
+    NightEngine::Container::Vector<NightEngine::EC::Handle<NightEngine::EC::GameObject>> m_gameObject;
+
+    //! brief Resize output to match query count, keep capacity
+    inline void Resize(size_t count)
+    {
+      m_hit.resize(count);
+      m_hitFraction.resize(count);
+      m_hitPoint.resize(count);
+      m_hitNormal.resize(count);
+      m_gameObject.resize(count);
+    }
+
+    //! brief Preallocate the output
+    inline void Reserve(size_t count)
+    {
+      m_hit.reserve(count);
+      m_hitFraction.reserve(count);
+      m_hitPoint.reserve(count);
+      m_hitNormal.reserve(count);
+      m_gameObject.reserve(count);
+    }
+  };
+
+  //! brief Batch of closest-hit raycasts (SoA)
+  struct RaycastBatch
+  {
+    //Input
+    NightEngine::Container::Vector<glm::vec3> m_from;
+    NightEngine::Container::Vector<glm::vec3> m_to;
+    int m_collisionFilterMask = -1;
+
+    //Output
+    QueryHitResult m_result;
+
+    //! brief Preallocate input and output
+    inline void Reserve(size_t count)
+    {
+      m_from.reserve(count);
+      m_to.reserve(count);
+      m_result.Reserve(count);
+    }
+
+    //! brief Add ray query
+    inline void AddRay(const glm::vec3& from, const glm::vec3& to)
+    {
+      m_from.emplace_back(from);
+      m_to.emplace_back(to);
+    }
+
+    //! brief Clear input, keep capacity for the next frame
+    inline void Clear(void) { m_from.clear(); m_to.clear(); }
+
+    inline size_t Size(void) const { return m_from.size(); }
+  };
+
+  //! brief Batch of closest-hit sphere sweeps (SoA)
+  struct SweepBatch
+  {
+    //Input
+    NightEngine::Container::Vector<glm::vec3> m_from;
+    NightEngine::Container::Vector<glm::vec3> m_to;
+    NightEngine::Container::Vector<float>     m_radius;
+    int m_collisionFilterMask = -1;
+
+    //Output
+    QueryHitResult m_result;
+
+    //! brief Preallocate input and output
+    inline void Reserve(size_t count)
+    {
+      m_from.reserve(count);
+      m_to.reserve(count);
+      m_radius.reserve(count);
+      m_result.Reserve(count);
+    }
+
+    //! brief Add sphere sweep query
+    inline void AddSweep(const glm::vec3& from, const glm::vec3& to, float radius)
+    {
+      m_from.emplace_back(from);
+      m_to.emplace_back(to);
+      m_radius.emplace_back(radius);
+    }
+
+    //! brief Clear input, keep capacity for the next frame
+    inline void Clear(void) { m_from.clear(); m_to.clear(); m_radius.clear(); }
+
+    inline size_t Size(void) const { return m_from.size(); }
+  };
+
+  //! brief Batch of sphere overlaps (SoA), tested against the objects' world AABB.
+  // Query i owns m_gameObjects[i * m_maxResultsPerQuery, + m_resultCount[i])
+  struct OverlapBatch
+  {
+    //Input
+    NightEngine::Container::Vector<glm::vec3> m_center;
+    NightEngine::Container::Vector<float>     m_radius;
+    int m_collisionFilterMask = -1;
+    NightEngine::Container::U32 m_maxResultsPerQuery = 16;
+
+    //Output
+    NightEngine::Container::Vector<NightEngine::Container::U32> m_resultCount;
+    NightEngine::Container::Vector<NightEngine::EC::Handle<NightEngine::EC::GameObject>> m_gameObjects;
+
+    //! brief Preallocate input and output
+    inline void Reserve(size_t count)
+    {
+      m_center.reserve(count);
+      m_radius.reserve(count);
+      m_resultCount.reserve(count);
+      m_gameObjects.reserve(count * m_maxResultsPerQuery);
+    }
+
+    //! brief Add sphere overlap query
+    inline void AddOverlap(const glm::vec3& center, float radius)
+    {
+      m_center.emplace_back(center);
+      m_radius.emplace_back(radius);
+    }
+
+    //! brief Clear input, keep capacity for the next frame
+    inline void Clear(void) { m_center.clear(); m_radius.clear(); }
+
+    inline size_t Size(void) const { return m_center.size(); }
+
+    //! brief Get pointer to the first result of query i
+    inline const NightEngine::EC::Handle<NightEngine::EC::GameObject>* GetResults(size_t i) const
+    {
+      return m_gameObjects.data() + (i * m_maxResultsPerQuery);
+    }
+  };
+}
@@ -11,6 +11,7 @@
 #include <BulletDynamics/Dynamics/btDiscreteDynamicsWorld.h>
 
 #include "Core/Macros.hpp"
+#include "Core/Utility/JobSystem.hpp"
 #include "Physics/PhysicUtilities.hpp"
 #include "Physics/PhysicsDebugDrawer.hpp"
 
@@ -26,6 +27,51 @@ namespace Physics
 {
   std::vector<PhysicsScene*> PhysicsScene::s_physicScenes;
 
+  //! brief Collect broadphase proxies touched by a dbvt traversal, each worker own one
+  struct BroadphaseCandidates : public btDbvt::ICollide
+  {
+    explicit BroadphaseCandidates(int collisionFilterMask)
+      : m_collisionFilterMask(collisionFilterMask) {}
+
+    virtual void Process(const btDbvtNode* leaf) override
+    {
+      auto proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+      if ((proxy->m_collisionFilterGroup & m_collisionFilterMask) != 0)
+      {
+        m_proxies.push_back(proxy);
+      }
+    }
+
+    int m_collisionFilterMask;
+    btAlignedObjectArray<btBroadphaseProxy*> m_proxies;
+  };
+
+  //! brief Resolve btCollisionObject to GameObject through the Rigidbody handle in UserPointer/UserIndex
+  static EC::Handle<EC::GameObject> ResolveGameObject(const btCollisionObject* obj)
+  {
+    if (obj == nullptr || obj->getUserPointer() == nullptr)
+    {
+      return EC::Handle<EC::GameObject>{};
+    }
+
+    auto rigidbody = EC::HandleObject::LookupHandle<Rigidbody>(obj->getUserPointer()
+      , obj->getUserIndex(), obj->getUserIndex2());
+    return rigidbody != nullptr ? rigidbody->GetGameObject() : EC::Handle<EC::GameObject>{};
+  }
+
+  //! brief Write closest hit into SoA output slot
+  static void WriteHitResult(QueryHitResult& result, size_t index
+    , const btCollisionObject* hitObject, btScalar fraction
+    , const btVector3& point, const btVector3& normal)
+  {
+    bool hit = hitObject != nullptr;
+    result.m_hit[index] = hit;
+    result.m_hitFraction[index] = hit ? fraction : 1.0f;
+    result.m_hitPoint[index] = hit ? ToGLMVec3(point) : glm::vec3(0.0f);
+    result.m_hitNormal[index] = hit ? ToGLMVec3(normal) : glm::vec3(0.0f);
+    result.m_gameObject[index] = ResolveGameObject(hitObject);
+  }
+
   PhysicsScene::PhysicsScene(void)
   {
     ASSERT_TRUE(m_world == nullptr);
@@ -144,7 +190,9 @@ namespace Physics
   void PhysicsScene::Update(float dt)
   {
     {
+      m_isSimulating = true;
       m_world->stepSimulation(dt, m_simulationSubStep);
+      m_isSimulating = false;
 
       //Update positions of all objects
       for (int i = 0; i < m_rigidbodys.size(); ++i)
@@ -213,6 +261,148 @@ namespace Physics
     m_world->debugDrawWorld();
   }
 
+  void PhysicsScene::Raycast(RaycastBatch& batch, size_t minBatchSize) const
+  {
+    ASSERT_TRUE(!m_isSimulating);
+    ASSERT_TRUE(batch.m_from.size() == batch.m_to.size());
+
+    //Traverse the dbvt directly, btDbvtBroadphase::rayTest share one stack across threads
+    const btDbvt* sets = static_cast<btDbvtBroadphase*>(m_broadPhase)->m_sets;
+    QueryHitResult& result = batch.m_result;
+    result.Resize(batch.Size());
+
+    NightEngine::JobSystem::ParallelFor(batch.Size(), minBatchSize
+      , [&batch, &result, sets](size_t begin, size_t end)
+    {
+      BroadphaseCandidates candidates{ batch.m_collisionFilterMask };
+      for (size_t i = begin; i < end; ++i)
+      {
+        btVector3 from = ToBulletVec3(batch.m_from[i]);
+        btVector3 to = ToBulletVec3(batch.m_to[i]);
+
+        candidates.m_proxies.resize(0);
+        btDbvt::rayTest(sets[0].m_root, from, to, candidates);
+        btDbvt::rayTest(sets[1].m_root, from, to, candidates);
+
+        btTransform fromTrans, toTrans;
+        fromTrans.setIdentity();
+        fromTrans.setOrigin(from);
+        toTrans.setIdentity();
+        toTrans.setOrigin(to);
+
+        btCollisionWorld::ClosestRayResultCallback callback(from, to);
+        callback.m_collisionFilterMask = batch.m_collisionFilterMask;
+        for (int j = 0; j < candidates.m_proxies.size(); ++j)
+        {
+          auto obj = static_cast<btCollisionObject*>(candidates.m_proxies[j]->m_clientObject);
+          btCollisionWorld::rayTestSingle(fromTrans, toTrans, obj
+            , obj->getCollisionShape(), obj->getWorldTransform(), callback);
+        }
+
+        WriteHitResult(result, i, callback.m_collisionObject
+          , callback.m_closestHitFraction, callback.m_hitPointWorld, callback.m_hitNormalWorld);
+      }
+    });
+  }
+
+  void PhysicsScene::SweepSphere(SweepBatch& batch, size_t minBatchSize) const
+  {
+    ASSERT_TRUE(!m_isSimulating);
+    ASSERT_TRUE(batch.m_from.size() == batch.m_to.size()
+      && batch.m_from.size() == batch.m_radius.size());
+
+    const btDbvt* sets = static_cast<btDbvtBroadphase*>(m_broadPhase)->m_sets;
+    QueryHitResult& result = batch.m_result;
+    result.Resize(batch.Size());
+
+    NightEngine::JobSystem::ParallelFor(batch.Size(), minBatchSize
+      , [&batch, &result, sets](size_t begin, size_t end)
+    {
+      BroadphaseCandidates candidates{ batch.m_collisionFilterMask };
+      btSphereShape sphere{ 1.0f };
+      for (size_t i = begin; i < end; ++i)
+      {
+        btVector3 from = ToBulletVec3(batch.m_from[i]);
+        btVector3 to = ToBulletVec3(batch.m_to[i]);
+        btScalar radius = batch.m_radius[i];
+        sphere.setUnscaledRadius(radius);
+
+        //Swept AABB of the sphere
+        btVector3 extent{ radius, radius, radius };
+        btVector3 aabbMin = from, aabbMax = from;
+        aabbMin.setMin(to);
+        aabbMax.setMax(to);
+        btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin - extent, aabbMax + extent);
+
+        candidates.m_proxies.resize(0);
+        sets[0].collideTV(sets[0].m_root, volume, candidates);
+        sets[1].collideTV(sets[1].m_root, volume, candidates);
+
+        btTransform fromTrans, toTrans;
+        fromTrans.setIdentity();
+        fromTrans.setOrigin(from);
+        toTrans.setIdentity();
+        toTrans.setOrigin(to);
+
+        btCollisionWorld::ClosestConvexResultCallback callback(from, to);
+        callback.m_collisionFilterMask = batch.m_collisionFilterMask;
+        for (int j = 0; j < candidates.m_proxies.size(); ++j)
+        {
+          auto obj = static_cast<btCollisionObject*>(candidates.m_proxies[j]->m_clientObject);
+          btCollisionWorld::objectQuerySingle(&sphere, fromTrans, toTrans, obj
+            , obj->getCollisionShape(), obj->getWorldTransform(), callback, 0.0f);
+        }
+
+        WriteHitResult(result, i, callback.m_hitCollisionObject
+          , callback.m_closestHitFraction, callback.m_hitPointWorld, callback.m_hitNormalWorld);
+      }
+    });
+  }
+
+  void PhysicsScene::OverlapSphere(OverlapBatch& batch, size_t minBatchSize) const
+  {
+    ASSERT_TRUE(!m_isSimulating);
+    ASSERT_TRUE(batch.m_center.size() == batch.m_radius.size());
+
+    const btDbvt* sets = static_cast<btDbvtBroadphase*>(m_broadPhase)->m_sets;
+    const NightEngine::Container::U32 maxResults = batch.m_maxResultsPerQuery;
+    batch.m_resultCount.resize(batch.Size());
+    batch.m_gameObjects.resize(batch.Size() * maxResults);
+
+    NightEngine::JobSystem::ParallelFor(batch.Size(), minBatchSize
+      , [&batch, sets, maxResults](size_t begin, size_t end)
+    {
+      BroadphaseCandidates candidates{ batch.m_collisionFilterMask };
+      for (size_t i = begin; i < end; ++i)
+      {
+        btVector3 center = ToBulletVec3(batch.m_center[i]);
+        btScalar radius = batch.m_radius[i];
+        btVector3 extent{ radius, radius, radius };
+        btDbvtVolume volume = btDbvtVolume::FromCE(center, extent);
+
+        candidates.m_proxies.resize(0);
+        sets[0].collideTV(sets[0].m_root, volume, candidates);
+        sets[1].collideTV(sets[1].m_root, volume, candidates);
+
+        //Refine with sphere vs object AABB
+        NightEngine::Container::U32 count = 0;
+        auto output = batch.m_gameObjects.data() + (i * maxResults);
+        for (int j = 0; j < candidates.m_proxies.size() && count < maxResults; ++j)
+        {
+          btBroadphaseProxy* proxy = candidates.m_proxies[j];
+          btVector3 closest = center;
+          closest.setMax(proxy->m_aabbMin);
+          closest.setMin(proxy->m_aabbMax);
+          if (closest.distance2(center) <= radius * radius)
+          {
+            output[count++] = ResolveGameObject(static_cast<btCollisionObject*>(proxy->m_clientObject));
+          }
+        }
+        batch.m_resultCount[i] = count;
+      }
+    });
+  }
+
   void PhysicsScene::DebugDraw(CameraObject& cam)
   {
     if (m_debugDrawer == nullptr)
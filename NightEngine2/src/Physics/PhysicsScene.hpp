@@ -10,6 +10,7 @@
 
 #include "Core/EC/GameObject.hpp"
 #include "Core/EC/Handle.hpp"
+#include "Physics/PhysicsQuery.hpp"
 #include <vector>
 #include <unordered_map>
 
@@ -72,6 +73,19 @@ namespace Physics
       //! brief Update the Scene
       void Update(float dt);
 
+      //! brief Closest-hit raycast for every ray in the batch, split across worker threads.
+      // Read-only against the broadphase, must be called between simulation steps
+      void Raycast(RaycastBatch& batch
+        , size_t minBatchSize = c_DEFAULT_QUERY_BATCH_SIZE) const;
+
+      //! brief Closest-hit sphere sweep for every sweep in the batch, split across worker threads
+      void SweepSphere(SweepBatch& batch
+        , size_t minBatchSize = c_DEFAULT_QUERY_BATCH_SIZE) const;
+
+      //! brief Sphere overlap for every query in the batch, split across worker threads
+      void OverlapSphere(OverlapBatch& batch
+        , size_t minBatchSize = c_DEFAULT_QUERY_BATCH_SIZE) const;
+
       //! brief Draw the Debug Colliders
       void DebugDraw(NightEngine::Rendering::Opengl::CameraObject& cam);
 
@@ -82,6 +96,7 @@ namespace Physics
       static PhysicsScene* GetPhysicsScene(int sceneIndex);
     private:
       int                                     m_simulationSubStep = 10;
+      bool                                    m_isSimulating = false;
 
       btDefaultCollisionConfiguration*        m_collisionConfig = nullptr;
       btCollisionDispatcher*                  m_collisionDispatcher = nullptr;
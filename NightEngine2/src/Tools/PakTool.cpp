@@ -0,0 +1,96 @@
+/*!
+  @file PakTool.cpp
+  @author Rittikorn Tangtrongchit
+  @brief Command line packer building a PakArchive from the asset directory
+*/
+#include "Core/Serialization/PakArchive.hpp"
+
+// Standard Headers
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace NightEngine;
+
+static void PrintUsage(void)
+{
+  std::cout << "Usage: NightEngine2_PakTool <asset directory> <output.pak> [options]\n"
+    << "  --store          don't compress\n"
+    << "  --exclude <dir>  skip a top level directory, can be repeated\n"
+    << "ShaderCache, AssetCache, ErrorLog and .pak files are always skipped.\n";
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  std::filesystem::path root{ argv[1] };
+  std::string outputPath{ argv[2] };
+  CompressionType compression = CompressionType::LZ4;
+  std::vector<std::string> excludes{ "ShaderCache", "AssetCache", "ErrorLog" };
+  for (int i = 3; i < argc; ++i)
+  {
+    if (std::strcmp(argv[i], "--store") == 0)
+    {
+      compression = CompressionType::NONE;
+    }
+    else if (std::strcmp(argv[i], "--exclude") == 0 && i + 1 < argc)
+    {
+      excludes.emplace_back(argv[++i]);
+    }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  std::error_code error;
+  if (!std::filesystem::is_directory(root, error))
+  {
+    std::cerr << "PakTool: not a directory [" << root.string() << "]\n";
+    return 1;
+  }
+
+  //Paths in the archive are relative to the asset root, the same as VirtualFileSystem
+  auto start = std::chrono::steady_clock::now();
+  PakWriter writer;
+  for (auto& entry : std::filesystem::recursive_directory_iterator(root, error))
+  {
+    if (!entry.is_regular_file(error) || entry.path().extension() == ".pak")
+    {
+      continue;
+    }
+
+    std::string path = std::filesystem::relative(entry.path(), root, error).generic_string();
+    std::string topDirectory = path.substr(0, path.find('/'));
+    if (std::find(excludes.begin(), excludes.end(), topDirectory) != excludes.end())
+    {
+      continue;
+    }
+    writer.AddFile(path, entry.path().string());
+  }
+
+  std::string writeError;
+  if (!writer.Write(outputPath, compression, writeError))
+  {
+    std::cerr << "PakTool: " << writeError << '\n';
+    return 1;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double ratio = writer.GetTotalSize() > 0 ?
+    double(writer.GetStoredSize()) / double(writer.GetTotalSize()) : 1.0;
+  std::cout << "PakTool: packed " << writer.GetFileCount() << " files into [" << outputPath
+    << "], " << writer.GetTotalSize() << " -> " << writer.GetStoredSize() << " bytes ("
+    << int(ratio * 100.0 + 0.5) << "%) in " << seconds << " s\n";
+  return 0;
+}
@@ -9,12 +9,25 @@
 #include "Core/EC/GameObject.hpp"
 #include "Core/EC/ComponentLogic.hpp"
 #include "Core/EC/Components/TestComponent.hpp"
+#include "Core/EC/Blueprint.hpp"
+#include "Core/EC/WorldSnapshot.hpp"
+#include "Core/EC/SceneLoader.hpp"
+#include "Core/EC/Scene.hpp"
+#include "Core/EC/SceneManager.hpp"
+#include "Core/EC/WorldPartition.hpp"
+#include "Core/EC/SpatialIndex.hpp"
 
+#include "Core/Macros.hpp"
 #include "Core/Logger.hpp"
 #include "Core/Utility/Utility.hpp"
+#include "Core/Utility/Profiling.hpp"
+#include "Core/Utility/JobSystem.hpp"
+#include "Core/Utility/CpuFeatures.hpp"
 
 //Slotmap
 #include "Core/Container/Slotmap.hpp"
+#include "Core/Container/Allocator.hpp"
+#include "Core/GameTime.hpp"
 
 //MessageSystem Test
 #include "Core/Message/MessageTypeEnum.hpp"
@@ -25,12 +38,60 @@
 
 //Serialization
 #include "Core/Serialization/Serialization.hpp"
+#include "Core/Serialization/FileWatcher.hpp"
+#include "Core/Serialization/AssetDependencyGraph.hpp"
+#include "Core/Serialization/Compression.hpp"
+#include "Core/Serialization/PakArchive.hpp"
+#include "Core/Serialization/VirtualFileSystem.hpp"
+#include "Core/Serialization/AssetDatabase.hpp"
+
+//Shader
+#include "Graphics/Opengl/ShaderPreprocessor.hpp"
+#include "Graphics/Opengl/ShaderKeywords.hpp"
+#include "Graphics/Opengl/MaterialConstants.hpp"
+
+//Render Graph
+#include "Graphics/RenderGraph.hpp"
+#include "Graphics/DynamicResolution.hpp"
+#include "Graphics/Animation/AnimationClip.hpp"
+#include "Graphics/Animation/AnimationSystem.hpp"
+#include "Graphics/Animation/Animator.hpp"
+#include "Graphics/Particles/ParticleSystem.hpp"
+#include "Graphics/Occlusion/MaskedOcclusionBuffer.hpp"
+#include "Graphics/Opengl/VertexFormat.hpp"
+
+//Editor
+#include "Editor/HierarchyTree.hpp"
+
+//Input
+#include "Input/InputRecorder.hpp"
+
+//Physics
+#include "Physics/PhysicsScene.hpp"
+#include "Physics/PhysicUtilities.hpp"
+#include "Physics/Collider.hpp"
+#include "Core/EC/Components/Rigidbody.hpp"
+#include <btBulletCollisionCommon.h>
 
 //#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
 
 #include <string> 
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <cfloat>
+
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 using namespace NightEngine::Utility;
 using namespace NightEngine::Container;
@@ -178,6 +239,23 @@ namespace UnitTest
 				handler3.UnsubscribeAll();
 				handler4.UnsubscribeAll();
 			}
+
+			SECTION("Subscribe_ByName")
+			{
+				REQUIRE(MessageSystem::Get().LookupMessageType("MSG_TEST") == MessageType::MSG_TEST);
+				REQUIRE(MessageSystem::Get().LookupMessageType("MSG_LOGMESSAGE") == MessageType::MSG_LOGMESSAGE);
+
+				TestMessageHandler handler2;
+				handler2.Subscribe("MSG_TEST");
+
+				TestMessage msg(true, 3);
+				MessageSystem::Get().BroadcastMessage(msg, BroadcastScope::GLOBAL);
+				REQUIRE(handler2.m_count == 3);
+
+				handler2.Unsubscribe(MessageType::MSG_TEST);
+				MessageSystem::Get().BroadcastMessage(msg, BroadcastScope::GLOBAL);
+				REQUIRE(handler2.m_count == 3);
+			}
 			handler.UnsubscribeAll();
 		}
 	}
@@ -602,6 +680,200 @@ namespace UnitTest
 			//Should remain the same size
 			REQUIRE(size == container.Size());
 		}
+
+		SECTION("Benchmark_Component_Lookup")
+		{
+			const int lookupCount = 1000000;
+			auto handle = NightEngine::Factory::Create<GameObject>("GameObject");
+			handle->AddComponent("CharacterInfo");
+			handle->AddComponent("Controller");
+			auto& g = *handle;
+
+			//Before: std::string keyed Map lookup, what GetComponent(const char*) used to do
+			auto& metaMap = NightEngine::Reflection::MetaManager::GetMetaMap();
+			size_t found = 0;
+			StopWatch legacyWatch{ true };
+			for (int i = 0; i < lookupCount; ++i)
+			{
+				found += g.GetComponent(metaMap.find("Controller")->second) != nullptr;
+			}
+			legacyWatch.Stop();
+
+			//After: string wrapper, hash then dense index
+			StopWatch stringWatch{ true };
+			for (int i = 0; i < lookupCount; ++i)
+			{
+				found += g.GetComponent("Controller") != nullptr;
+			}
+			stringWatch.Stop();
+
+			//After: compile-time StringID
+			StopWatch idWatch{ true };
+			for (int i = 0; i < lookupCount; ++i)
+			{
+				found += g.GetComponent(METATYPE_FROM_ID(STRING_ID("Controller"))) != nullptr;
+			}
+			idWatch.Stop();
+
+			//After: by type
+			StopWatch typeWatch{ true };
+			for (int i = 0; i < lookupCount; ++i)
+			{
+				found += g.GetComponent<Controller>() != nullptr;
+			}
+			typeWatch.Stop();
+
+			REQUIRE(found == 4 * lookupCount);
+
+			auto lookupPerSecond = [lookupCount](StopWatch& watch)
+			{
+				return lookupCount / (watch.GetElapsedTimeMicro() * 0.000001);
+			};
+			Debug::Log << Logger::MessageType::INFO << "GetComponent Map<String>: "
+				<< lookupPerSecond(legacyWatch) << " lookups/s\n";
+			Debug::Log << Logger::MessageType::INFO << "GetComponent(const char*): "
+				<< lookupPerSecond(stringWatch) << " lookups/s\n";
+			Debug::Log << Logger::MessageType::INFO << "GetComponent(STRING_ID): "
+				<< lookupPerSecond(idWatch) << " lookups/s\n";
+			Debug::Log << Logger::MessageType::INFO << "GetComponent<T>: "
+				<< lookupPerSecond(typeWatch) << " lookups/s\n";
+
+			handle->RemoveAllComponents();
+			handle.Destroy();
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: Blueprint
+  //*****************************************************
+	TEST_CASE("Blueprint", "[blueprint]")
+	{
+		//Blueprint json from a serialized GameObject, same as a .bp file
+		auto source = GameObject::Create("Enemy", 2);
+		source->AddComponent("CharacterInfo");
+		source->AddComponent("Controller");
+		source->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->SetMoveSpeed(42.0f);
+		source->GetTransform()->SetScale(glm::vec3(2.0f));
+
+		std::stringstream json;
+		NightEngine::Serialization::Serialize(*source, json);
+		source->Destroy();
+
+		Blueprint blueprint;
+		REQUIRE(blueprint.CompileFromString(json.str()));
+		REQUIRE(blueprint.GetName() == "Enemy");
+		REQUIRE(blueprint.GetComponentCount() == 2);
+		REQUIRE(blueprint.GetTransform().GetScale() == glm::vec3(2.0f));
+
+		auto& container = NightEngine::Factory::GetTypeContainer<GameObject>();
+		size_t size = container.Size();
+
+		SECTION("Instantiate")
+		{
+			const size_t count = 500;
+			Vector<InstanceTransform> transforms(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				transforms[i].m_position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+			}
+
+			Vector<Handle<GameObject>> instances;
+			blueprint.Instantiate(count, transforms.data(), instances);
+			REQUIRE(instances.size() == count);
+
+			auto firstInfo = instances[0]->GetComponent<CharacterInfo>()->Get<CharacterInfo>();
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto& g = *instances[i];
+				REQUIRE(g.GetName() == "Enemy");
+				REQUIRE(g.GetComponentCount() == 2);
+				REQUIRE(g.GetTransform()->GetPosition().x == static_cast<float>(i));
+				REQUIRE(g.GetTransform()->GetScale() == glm::vec3(1.0f));
+
+				//Values come from the image, identity is per instance
+				auto info = g.GetComponent<CharacterInfo>()->Get<CharacterInfo>();
+				REQUIRE(info->GetMoveSpeed() == 42.0f);
+				REQUIRE(info->GetGameObject().m_handle == instances[i].m_handle);
+				REQUIRE((i == 0 || info->GetUID() != firstInfo->GetUID()));
+			}
+
+			//Without transforms, keep the blueprint transform
+			blueprint.Instantiate(1, nullptr, instances);
+			REQUIRE(instances.back()->GetTransform()->GetScale() == glm::vec3(2.0f));
+
+			for (auto& instance : instances)
+			{
+				instance->Destroy();
+			}
+			REQUIRE(size == container.Size());
+		}
+
+		SECTION("Apply")
+		{
+			auto g = GameObject::Create("Other", 2);
+			g->AddComponent("CharacterInfo");
+			auto uid = g->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->GetUID();
+			Vector<Handle<GameObject>> moved;
+			Components::Transform::TakeMovedGameObjects(moved);
+
+			blueprint.Apply(*g);
+			REQUIRE(g->GetName() == "Enemy");
+			REQUIRE(g->GetTransform()->GetScale() == glm::vec3(2.0f));
+
+			//Applied like a move, and the next move is still heard
+			Components::Transform::TakeMovedGameObjects(moved);
+			REQUIRE(moved.size() == 1);
+			REQUIRE(moved[0].m_handle == g.m_handle);
+			g->GetTransform()->SetPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+			Components::Transform::TakeMovedGameObjects(moved);
+			REQUIRE(moved.size() == 1);
+			REQUIRE(g->GetComponentCount() == 2);
+			REQUIRE(g->GetComponent<Controller>() != nullptr);
+			REQUIRE(g->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->GetMoveSpeed() == 42.0f);
+			REQUIRE(g->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->GetUID() == uid);
+
+			g->Destroy();
+			REQUIRE(size == container.Size());
+		}
+
+		SECTION("Benchmark_Instantiate")
+		{
+			const size_t count = 1000;
+			Vector<Handle<GameObject>> instances;
+			instances.reserve(count);
+
+			//Before: create then deserialize the parsed json per instance
+			StopWatch deserializeWatch{ true };
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto g = GameObject::Create("Enemy", 2);
+				JsonValue value = tao::json::from_string(json.str());
+				NightEngine::Reflection::Variable var{ METATYPE(GameObject), g.Get() };
+				var.Deserialize(value.get_object().begin()->second);
+				instances.emplace_back(g);
+			}
+			deserializeWatch.Stop();
+			for (auto& instance : instances)
+			{
+				instance->Destroy();
+			}
+			instances.clear();
+
+			//After: one pass from the compiled image
+			StopWatch instantiateWatch{ true };
+			blueprint.Instantiate(count, nullptr, instances);
+			instantiateWatch.Stop();
+			for (auto& instance : instances)
+			{
+				instance->Destroy();
+			}
+
+			Debug::Log << Logger::MessageType::INFO << "Blueprint deserialize per instance: "
+				<< (deserializeWatch.GetElapsedTimeMilli()) << " ms/" << count << '\n';
+			Debug::Log << Logger::MessageType::INFO << "Blueprint::Instantiate: "
+				<< (instantiateWatch.GetElapsedTimeMilli()) << " ms/" << count << '\n';
+			REQUIRE(size == container.Size());
+		}
 	}
 
   //*****************************************************
@@ -640,6 +912,181 @@ namespace UnitTest
 				REQUIRE(METATYPE_FROM_STRING("TestReflection")->GetName() == "TestReflection");
 				REQUIRE(METATYPE_FROM_STRING(trStr)->GetName() == "TestReflection");
 			}
+
+			SECTION("StringID_TypeIndex_Lookup")
+			{
+				static_assert(STRING_ID("TestReflection") == ToStringID("TestReflection")
+					, "STRING_ID must match the runtime hash");
+				std::string trStr{ "TestReflection" };
+				REQUIRE(ToStringID(trStr) == STRING_ID("TestReflection"));
+
+				//Name, id and dense index resolve to the same MetaType
+				auto metaType = METATYPE(TestReflection);
+				REQUIRE(METATYPE_FROM_ID(STRING_ID("TestReflection")) == metaType);
+				REQUIRE(metaType->GetTypeIndex() != c_INVALID_DENSE_INDEX);
+				REQUIRE(METATYPE_FROM_INDEX(metaType->GetTypeIndex()) == metaType);
+				REQUIRE(METATYPE_FROM_INDEX(METATYPE(int)->GetTypeIndex()) == METATYPE(int));
+
+				//Registered names are interned
+				REQUIRE(std::string{ StringIntern::GetString(STRING_ID("TestReflection")) } == "TestReflection");
+				REQUIRE(StringIntern::GetString(STRING_ID("NeverInternedString")) == nullptr);
+
+				//Factory dense index
+				REQUIRE(NightEngine::Factory::GetTypeIndex<GameObject>() != c_INVALID_DENSE_INDEX);
+				REQUIRE(NightEngine::Factory::g_factory.GetTypeIndex("GameObject")
+					== NightEngine::Factory::GetTypeIndex<GameObject>());
+				REQUIRE(NightEngine::Factory::g_factory.GetTypeIndex("NeverRegisteredType")
+					== c_INVALID_DENSE_INDEX);
+			}
+
+			SECTION("FindMember_Hashed")
+			{
+				using namespace UnitTest::Serialization;
+				auto metaType = METATYPE(TestReflection);
+				for (auto& member : metaType->GetMembers())
+				{
+					REQUIRE(metaType->FindMember(member.GetName()) == &member);
+					REQUIRE(metaType->FindMember(member.GetNameID()) == &member);
+				}
+				REQUIRE(metaType->FindMember(STRING_ID("m_secret")) == metaType->FindMember("m_secret"));
+				REQUIRE(metaType->FindMember(STRING_ID("m_secret"))->GetName() == "m_secret");
+				REQUIRE(metaType->FindMember("m_notAMember") == nullptr);
+				REQUIRE(METATYPE(int)->FindMember("m_int") == nullptr);
+
+				//Inherited members are found from the derived type
+				auto derived = METATYPE(SecondDerivedClass);
+				REQUIRE(derived->FindMember(STRING_ID("m_class_int")) != nullptr);
+				REQUIRE(derived->FindMember(STRING_ID("m_derived_POD")) != nullptr);
+				REQUIRE(derived->FindMember(STRING_ID("m_secondDerived_float")) != nullptr);
+				REQUIRE(derived->FindMember(STRING_ID("m_thirdPrivateDerived_float")) == nullptr);
+			}
+
+			SECTION("IsDerivedFrom_Interval")
+			{
+				using namespace UnitTest::Serialization;
+				auto base = METATYPE(ClassWithProtected);
+				auto derived = METATYPE(DerivedClass);
+				auto second = METATYPE(SecondDerivedClass);
+				auto secondPrivate = METATYPE(SecondPrivateDerivedClass);
+				auto third = METATYPE(ThirdDerivedClass);
+
+				REQUIRE(third->IsDerivedFrom(third));
+				REQUIRE(third->IsDerivedFrom(secondPrivate));
+				REQUIRE(third->IsDerivedFrom(derived));
+				REQUIRE(third->IsDerivedFrom(base));
+				REQUIRE(!third->IsDerivedFrom(second));
+				REQUIRE(!second->IsDerivedFrom(secondPrivate));
+				REQUIRE(!base->IsDerivedFrom(derived));
+				REQUIRE(!base->IsDerivedFrom(nullptr));
+				REQUIRE(METATYPE(CharacterInfo)->IsDerivedFrom(METATYPE(ComponentLogic)));
+				REQUIRE(!METATYPE(GameObject)->IsDerivedFrom(METATYPE(ComponentLogic)));
+
+				//Same answer as walking the base chain, for every pair of registered types
+				auto walk = [](const NightEngine::Reflection::MetaType* meta, const NightEngine::Reflection::MetaType* baseClass)
+				{
+					for (; meta != nullptr; meta = meta->GetBaseClass().m_metaType)
+					{
+						if (meta == baseClass)
+						{
+							return true;
+						}
+					}
+					return false;
+				};
+				auto& metaArray = NightEngine::Reflection::MetaManager::GetMetaArray();
+				size_t mismatch = 0;
+				for (auto a : metaArray)
+				{
+					for (auto b : metaArray)
+					{
+						mismatch += a->IsDerivedFrom(b) != walk(a, b);
+					}
+				}
+				REQUIRE(mismatch == 0);
+			}
+
+			SECTION("Benchmark_Reflection_Query")
+			{
+				using namespace UnitTest::Serialization;
+				const int queryCount = 1000000;
+				auto metaType = METATYPE(SecondDerivedClass);
+				std::string names[] = { "m_class_bool", "m_class_POD", "m_derived_POD_2", "m_secondDerived_float" };
+				size_t found = 0;
+
+				//Before: copy the name, then compare against every member
+				StopWatch linearWatch{ true };
+				for (int i = 0; i < queryCount; ++i)
+				{
+					std::string name = names[i & 3];
+					for (auto& member : metaType->GetMembers())
+					{
+						if (member.GetName() == name)
+						{
+							++found;
+							break;
+						}
+					}
+				}
+				linearWatch.Stop();
+
+				//After: hash the string, then one perfect hash probe
+				StopWatch stringWatch{ true };
+				for (int i = 0; i < queryCount; ++i)
+				{
+					found += metaType->FindMember(names[i & 3]) != nullptr;
+				}
+				stringWatch.Stop();
+
+				//After: compile-time StringID
+				StopWatch idWatch{ true };
+				for (int i = 0; i < queryCount; ++i)
+				{
+					found += metaType->FindMember(STRING_ID("m_derived_POD_2")) != nullptr;
+				}
+				idWatch.Stop();
+				REQUIRE(found == 3 * queryCount);
+
+				//Before: walk the base chain; After: two compares
+				auto third = METATYPE(ThirdDerivedClass);
+				auto base = METATYPE(ClassWithProtected);
+				size_t derivedCount = 0;
+				StopWatch walkWatch{ true };
+				for (int i = 0; i < queryCount; ++i)
+				{
+					for (const NightEngine::Reflection::MetaType* meta = third; meta != nullptr; meta = meta->GetBaseClass().m_metaType)
+					{
+						if (meta == base)
+						{
+							++derivedCount;
+							break;
+						}
+					}
+				}
+				walkWatch.Stop();
+
+				StopWatch intervalWatch{ true };
+				for (int i = 0; i < queryCount; ++i)
+				{
+					derivedCount += third->IsDerivedFrom(base);
+				}
+				intervalWatch.Stop();
+				REQUIRE(derivedCount == 2 * queryCount);
+
+				auto queryPerSecond = [queryCount](StopWatch& watch)
+				{
+					return queryCount / (watch.GetElapsedTimeMicro() * 0.000001);
+				};
+				Debug::Log << Logger::MessageType::INFO << "FindMember linear scan: "
+					<< queryPerSecond(linearWatch) << " queries/s\n";
+				Debug::Log << Logger::MessageType::INFO << "FindMember(std::string): "
+					<< queryPerSecond(stringWatch) << " queries/s\n";
+				Debug::Log << Logger::MessageType::INFO << "FindMember(STRING_ID): "
+					<< queryPerSecond(idWatch) << " queries/s\n";
+				Debug::Log << Logger::MessageType::INFO << "IsDerivedFrom base walk: "
+					<< queryPerSecond(walkWatch) << " queries/s\n";
+				Debug::Log << Logger::MessageType::INFO << "IsDerivedFrom interval: "
+					<< queryPerSecond(intervalWatch) << " queries/s\n";
+			}
 		}
 	}
 
@@ -821,4 +1268,4238 @@ namespace UnitTest
 		}
 	}
 
-}
\ No newline at end of file
+  //*****************************************************
+  // UnitTest: Logger
+  //*****************************************************
+  TEST_CASE("Logger", "[logger]")
+  {
+    const int logCount = 2000;
+    unsigned sinks = Debug::Log.GetSinks();
+
+    SECTION("Async_Records_Written")
+    {
+      Debug::Log.Flush();
+      auto written = Debug::Log.GetWrittenCount();
+
+      //Mute the sinks, only the record count matter
+      Debug::Log.SetSinks(0);
+      std::thread worker([logCount]()
+      {
+        for (int i = 0; i < logCount; ++i)
+        {
+          LOG_INFO("worker {} {}", i, 0.5f);
+        }
+      });
+      for (int i = 0; i < logCount; ++i)
+      {
+        Debug::Log << Logger::MessageType::INFO << "main " << i << '\n';
+      }
+      worker.join();
+      Debug::Log.Flush();
+      Debug::Log.SetSinks(sinks);
+
+      REQUIRE(Debug::Log.GetWrittenCount() - written == logCount * 2);
+    }
+
+    SECTION("Runtime_Filter")
+    {
+      Debug::Log.Flush();
+      auto written = Debug::Log.GetWrittenCount();
+
+      Debug::Log.SetSinks(0);
+      Debug::Log.SetLogLevel(2);
+      LOG_INFO("filtered {}", 1);
+      LOG_WARNING("filtered {}", 2);
+      Debug::Log << Logger::MessageType::WARNING << "filtered" << '\n';
+      LOG_ERROR("not filtered {}", 3);
+      Debug::Log.SetLogLevel(0);
+      Debug::Log.Flush();
+      Debug::Log.SetSinks(sinks);
+
+      REQUIRE(Debug::Log.GetWrittenCount() - written == 1);
+    }
+
+    SECTION("Benchmark_LogCall")
+    {
+      Debug::Log.Flush();
+      Debug::Log.SetSinks(0);
+
+      //Stay under the per-thread ring capacity to measure the caller cost only
+      NightEngine::Utility::StopWatch formatWatch{ true };
+      for (int i = 0; i < logCount; ++i)
+      {
+        LOG_INFO("benchmark {} {} {}", i, 1.5f, "str");
+      }
+      formatWatch.Stop();
+      Debug::Log.Flush();
+
+      NightEngine::Utility::StopWatch streamWatch{ true };
+      for (int i = 0; i < logCount; ++i)
+      {
+        Debug::Log << "benchmark " << i << ' ' << 1.5f << '\n';
+      }
+      streamWatch.Stop();
+      Debug::Log.Flush();
+      Debug::Log.SetSinks(sinks);
+
+      Debug::Log << Logger::MessageType::INFO << "Logger LOG_INFO: "
+        << (formatWatch.GetElapsedTimeMicro() * 1000.0f / logCount) << " ns/log-call\n";
+      Debug::Log << Logger::MessageType::INFO << "Logger operator<<: "
+        << (streamWatch.GetElapsedTimeMicro() * 1000.0f / logCount) << " ns/log-call\n";
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: Profiler
+  //*****************************************************
+  TEST_CASE("Profiler", "[profiler]")
+  {
+    using namespace NightEngine::Profiling;
+    const int zoneCount = 4000;
+
+    SECTION("Capture_Zones_Per_Thread")
+    {
+      NightEngine::Container::U64 begin = ReadTimestamp();
+      std::thread worker([zoneCount]()
+      {
+        for (int i = 0; i < zoneCount; ++i)
+        {
+          PROFILE_ZONE("UnitTest_WorkerZone");
+        }
+      });
+      for (int i = 0; i < zoneCount; ++i)
+      {
+        PROFILE_ZONE("UnitTest_MainZone");
+        PROFILE_COUNTER("UnitTest_Counter", i);
+      }
+      worker.join();
+
+      NightEngine::Container::Vector<CapturedEvent> events;
+      CaptureEvents(begin, ReadTimestamp(), events);
+
+      int mainEvents = 0, workerEvents = 0, counterEvents = 0;
+      double counterSum = 0.0;
+      for (auto& captured : events)
+      {
+        const char* name = captured.m_event.m_name;
+        mainEvents += std::string(name) == "UnitTest_MainZone";
+        workerEvents += std::string(name) == "UnitTest_WorkerZone";
+        if (captured.m_event.m_type == EventType::COUNTER)
+        {
+          ++counterEvents;
+          counterSum += captured.m_event.m_value;
+        }
+      }
+      REQUIRE(mainEvents == zoneCount * 2);
+      REQUIRE(workerEvents == zoneCount * 2);
+      REQUIRE(counterEvents == zoneCount);
+      REQUIRE(counterSum == Approx(zoneCount * (zoneCount - 1) / 2.0));
+    }
+
+    SECTION("Capture_While_Writing")
+    {
+      //The worker wrap its ring many times while the main thread capture it
+      std::atomic<bool> stop{ false };
+      std::thread worker([&stop]()
+      {
+        while (!stop.load(std::memory_order_relaxed))
+        {
+          PROFILE_ZONE("UnitTest_WrapZone");
+          PROFILE_COUNTER("UnitTest_WrapCounter", 42);
+        }
+      });
+
+      int tornEvents = 0;
+      size_t capturedEvents = 0;
+      for (int capture = 0; capture < 50; ++capture)
+      {
+        NightEngine::Container::Vector<CapturedEvent> events;
+        CaptureEvents(0, ReadTimestamp(), events);
+        capturedEvents += events.size();
+
+        NightEngine::Container::U64 lastTimestamp = 0;
+        for (auto& captured : events)
+        {
+          const ProfileEvent& ev = captured.m_event;
+          if (ev.m_name == nullptr || std::string(ev.m_name).compare(0, 13, "UnitTest_Wrap") != 0)
+          {
+            continue;
+          }
+
+          //Every event of the worker is whole and in order
+          tornEvents += ev.m_timestamp < lastTimestamp;
+          tornEvents += ev.m_type == EventType::COUNTER && ev.m_value != 42.0f;
+          lastTimestamp = ev.m_timestamp;
+        }
+      }
+      stop.store(true);
+      worker.join();
+
+      REQUIRE(capturedEvents > 0);
+      REQUIRE(tornEvents == 0);
+    }
+
+    SECTION("Benchmark_Zone")
+    {
+      NightEngine::Utility::StopWatch zoneWatch{ true };
+      for (int i = 0; i < zoneCount; ++i)
+      {
+        PROFILE_ZONE("UnitTest_BenchmarkZone");
+      }
+      zoneWatch.Stop();
+
+      Debug::Log << Logger::MessageType::INFO << "Profiler PROFILE_ZONE: "
+        << (zoneWatch.GetElapsedTimeMicro() * 1000.0f / zoneCount) << " ns/zone\n";
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: Allocator
+  //*****************************************************
+  TEST_CASE("Allocator", "[allocator]")
+  {
+    SECTION("LinearArena")
+    {
+      LinearArena arena{ 1024, MemoryTag::GENERAL };
+      void* a = arena.Allocate(3, 1);
+      void* b = arena.Allocate(64, 64);
+      REQUIRE(arena.Owns(a));
+      REQUIRE(arena.Owns(b));
+      REQUIRE(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+
+      //Overflow fall back to the heap, then grow on Reset
+      void* big = arena.Allocate(4096);
+      REQUIRE(big != nullptr);
+      REQUIRE(!arena.Owns(big));
+      REQUIRE(arena.GetOverflowBytes() == 4096);
+
+      arena.Reset();
+      REQUIRE(arena.GetUsedBytes() == 0);
+      REQUIRE(arena.GetCapacity() >= 4096);
+      REQUIRE(arena.Owns(arena.Allocate(4096)));
+    }
+
+    SECTION("PoolAllocator")
+    {
+      PoolAllocator pool{ 24, 4, MemoryTag::GENERAL };
+      Vector<void*> blocks;
+      for (int i = 0; i < 10; ++i)
+      {
+        blocks.emplace_back(pool.Allocate());
+      }
+      REQUIRE(pool.GetLiveBlocks() == 10);
+      REQUIRE(pool.GetPageCount() == 3);
+
+      //Freed blocks are reused before growing
+      for (void* block : blocks)
+      {
+        pool.Deallocate(block);
+      }
+      for (int i = 0; i < 10; ++i)
+      {
+        pool.Allocate();
+      }
+      REQUIRE(pool.GetPageCount() == 3);
+
+      auto& threadPool = GetThreadLocalPool<sizeof(glm::vec3)>();
+      glm::vec3* vec = threadPool.New<glm::vec3>(1.0f, 2.0f, 3.0f);
+      REQUIRE(vec->y == 2.0f);
+      threadPool.Delete(vec);
+    }
+
+    SECTION("TaggedHeap_Stats")
+    {
+      MemoryTagStats before = TaggedHeap::GetStats(MemoryTag::PHYSICS);
+      {
+        TaggedVector<int, MemoryTag::PHYSICS> vec;
+        vec.resize(100);
+
+        MemoryTagStats during = TaggedHeap::GetStats(MemoryTag::PHYSICS);
+        REQUIRE(during.m_liveBytes - before.m_liveBytes == 100 * sizeof(int));
+        REQUIRE(during.m_liveAllocations - before.m_liveAllocations == 1);
+      }
+      MemoryTagStats after = TaggedHeap::GetStats(MemoryTag::PHYSICS);
+      REQUIRE(after.m_liveBytes == before.m_liveBytes);
+      REQUIRE(after.m_totalAllocations - before.m_totalAllocations == 1);
+    }
+
+#if MEMORY_TRACKING_ENABLED
+    SECTION("Frame_Malloc_Count")
+    {
+      using namespace NightEngine::Rendering::Particles;
+
+      //The CPU side of an engine frame: GameTime, logging, messages, profiler zones,
+      //and particles simulated and sorted across the JobSystem workers
+      unsigned initialWorkers = JobSystem::GetWorkerCount();
+      if (initialWorkers == 0)
+      {
+        JobSystem::Initialize(3);
+      }
+
+      EmitterSettings settings;
+      settings.m_rate = 2000.0f;
+      settings.m_maxParticles = 4096;
+      Vector<Emitter> emitters(4);
+      Vector<Emitter*> emitterPointers;
+      for (size_t i = 0; i < emitters.size(); ++i)
+      {
+        emitters[i].Initialize(settings, static_cast<U32>(i + 1));
+        emitters[i].Burst(settings.m_maxParticles / 2);
+        emitterPointers.emplace_back(&emitters[i]);
+      }
+      Vector<ParticleInstance> instances(emitters.size() * settings.m_maxParticles);
+
+      GameTime gameTime{ 100000.0f, 60.0f, 10.0f };
+      Message::TestMessageHandler handler;
+      handler.Subscribe(MessageType::MSG_TEST);
+
+      auto RunFrame = [&]()
+      {
+        gameTime.BeginFrame();
+        Debug::Log.SendLogToDevConsole();
+        {
+          PROFILE_ZONE("UnitTest_Frame");
+          gameTime.BeginTimeStamp("UnitTest_Particles", 0);
+          ParticleSystem::UpdateEmitters(emitterPointers, 1.0f / 60.0f);
+          ParticleSystem::WriteInstances(emitterPointers, glm::vec3(0.0f, 5.0f, -20.0f)
+            , glm::vec3(0.0f, 0.0f, 1.0f), instances.data());
+          gameTime.EndTimeStamp();
+
+          TestMessage msg{ true, 1 };
+          MessageSystem::Get().BroadcastMessage(msg, BroadcastScope::HANDLER);
+          LOG_INFO("UnitTest frame {} particles", ParticleSystem::GetParticleCount(emitterPointers));
+        }
+        gameTime.EndFrame();
+      };
+
+      //Warm up until every persistent buffer reached its size
+      for (int frame = 0; frame < 8; ++frame)
+      {
+        RunFrame();
+      }
+
+      //Regression guard: a steady state frame must not touch the global heap.
+      //This thread and the workers running the particle jobs are counted,
+      //the logger thread allocate the DevConsole lines
+      auto CountFrameAllocations = []()
+      {
+        return TaggedHeap::GetThreadAllocationCount() + JobSystem::GetWorkerAllocationCount();
+      };
+      U64 before = CountFrameAllocations();
+      for (int frame = 0; frame < 8; ++frame)
+      {
+        RunFrame();
+      }
+      U64 allocations = CountFrameAllocations() - before;
+      handler.UnsubscribeAll();
+      if (initialWorkers == 0)
+      {
+        JobSystem::Terminate();
+      }
+
+      REQUIRE(allocations == 0);
+    }
+#endif
+  }
+  //*****************************************************
+  // UnitTest: ShaderPreprocessor
+  //*****************************************************
+  TEST_CASE("ShaderPreprocessor", "[shader]")
+  {
+    using NightEngine::Rendering::Opengl::ShaderPreprocessor;
+    using NightEngine::Rendering::Opengl::PreprocessedShader;
+
+    //In-memory files, no GL context or disk needed
+    std::unordered_map<std::string, std::string> files;
+    files["root/common.glsl"] = "float Common() { return 1.0; }\n";
+    files["root/lighting.glsl"] = "#include \"common.glsl\"\nfloat Light() { return Common(); }\n";
+    files["root/gbuffer.glsl"] = "  #include \"common.glsl\"\nfloat GBuffer() { return 2.0; }\n";
+    files["root/pass.frag"] = "#version 400 core\n#include \"lighting.glsl\"\n"
+      "#include \"gbuffer.glsl\"\n// #include is ignored in this comment\nvoid main() {}\n";
+    auto readFile = [&files](const std::string& path, std::string& outSource)
+    {
+      auto it = files.find(path);
+      if (it == files.end())
+      {
+        return false;
+      }
+      outSource = it->second;
+      return true;
+    };
+    ShaderPreprocessor preprocessor{ readFile, "root/" };
+
+    SECTION("Expand")
+    {
+      PreprocessedShader result;
+      REQUIRE(preprocessor.Preprocess("root/pass.frag", result));
+      REQUIRE(result.m_source == "#version 400 core\n"
+        "float Common() { return 1.0; }\n"
+        "float Light() { return Common(); }\n"
+        "float GBuffer() { return 2.0; }\n"
+        "// #include is ignored in this comment\nvoid main() {}\n");
+      REQUIRE(result.m_files.size() == 4);
+      REQUIRE(result.m_files[0] == "root/pass.frag");
+
+      //Cached, the second expansion doesn't read anything
+      size_t readCount = preprocessor.GetReadCount();
+      PreprocessedShader again;
+      REQUIRE(preprocessor.Preprocess("root/pass.frag", again));
+      REQUIRE(preprocessor.GetReadCount() == readCount);
+      REQUIRE(again.m_hash == result.m_hash);
+    }
+
+    SECTION("Hash_And_Dependents")
+    {
+      PreprocessedShader before;
+      preprocessor.Preprocess("root/pass.frag", before);
+      U64 commonHash = preprocessor.GetContentHash("root/common.glsl");
+      REQUIRE(commonHash != 0);
+
+      std::vector<std::string> dependents;
+      preprocessor.GetDependents("root/common.glsl", dependents);
+      std::sort(dependents.begin(), dependents.end());
+      REQUIRE(dependents == std::vector<std::string>{ "root/gbuffer.glsl"
+        , "root/lighting.glsl", "root/pass.frag" });
+
+      //Unchanged files keep their content, changed ones are reported and rehashed
+      std::vector<std::string> changed;
+      preprocessor.Revalidate(&changed);
+      REQUIRE(changed.empty());
+
+      files["root/common.glsl"] = "float Common() { return 3.0; }\n";
+      preprocessor.Revalidate(&changed);
+      REQUIRE(changed == std::vector<std::string>{ "root/common.glsl" });
+
+      PreprocessedShader after;
+      REQUIRE(preprocessor.Preprocess("root/pass.frag", after));
+      REQUIRE(after.m_hash != before.m_hash);
+      REQUIRE(preprocessor.GetContentHash("root/common.glsl") != commonHash);
+      REQUIRE(after.m_source.find("return 3.0") != std::string::npos);
+    }
+
+    SECTION("Errors")
+    {
+      files["root/a.glsl"] = "#include \"b.glsl\"\n";
+      files["root/b.glsl"] = "#include \"a.glsl\"\n";
+      files["root/missing.frag"] = "#include \"nothing.glsl\"\n";
+
+      PreprocessedShader result;
+      REQUIRE(!preprocessor.Preprocess("root/a.glsl", result));
+      REQUIRE(!preprocessor.Preprocess("root/missing.frag", result));
+      REQUIRE(!preprocessor.Preprocess("root/nothing.frag", result));
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: ShaderKeywords
+  //*****************************************************
+  TEST_CASE("ShaderKeywords", "[shader]")
+  {
+    using namespace NightEngine::Rendering::Opengl;
+
+    SECTION("Parse")
+    {
+      std::vector<std::string> keywords;
+      ShaderKeywords::ParseKeywords("#version 330 core\n"
+        "#pragma shader_feature USE_NORMALMAP USE_OPACITYMAP\n"
+        "  #pragma shader_feature\tUSE_NORMALMAP USE_FOG // USE_COMMENTED\n"
+        "#pragma optimize(off)\n"
+        "#pragma shader_featureX USE_TYPO\n"
+        "// #pragma shader_feature USE_IN_COMMENT\n"
+        "#pragma shader_feature USE_LAST", keywords);
+      REQUIRE(keywords == std::vector<std::string>{ "USE_NORMALMAP"
+        , "USE_OPACITYMAP", "USE_FOG", "USE_LAST" });
+
+      //Another stage only add the new ones, order stay the same
+      ShaderKeywords::ParseKeywords("#pragma shader_feature USE_SKINNING USE_FOG\n", keywords);
+      REQUIRE(keywords.size() == 5);
+      REQUIRE(ShaderKeywords::FindKeyword(keywords, "USE_SKINNING") == 4);
+      REQUIRE(ShaderKeywords::FindKeyword(keywords, "USE_UNKNOWN") == -1);
+    }
+
+    SECTION("Defines")
+    {
+      std::vector<std::string> keywords{ "USE_NORMALMAP", "USE_OPACITYMAP", "USE_FOG" };
+      ShaderVariantKey key = 0;
+      key = ShaderKeywords::EnableKeyword(keywords, key, "USE_FOG");
+      key = ShaderKeywords::EnableKeyword(keywords, key, "USE_NORMALMAP");
+      key = ShaderKeywords::EnableKeyword(keywords, key, "USE_UNKNOWN");
+      REQUIRE(key == 0b101);
+      REQUIRE(ShaderKeywords::MakeDefineBlock(keywords, key)
+        == "#define USE_NORMALMAP\n#define USE_FOG\n");
+      REQUIRE(ShaderKeywords::MakeDefineBlock(keywords, 0).empty());
+
+      std::string source = "// header\n#version 330 core\nvoid main() {}\n";
+      ShaderKeywords::InjectDefines(source, "#define USE_FOG\n");
+      REQUIRE(source == "// header\n#version 330 core\n#define USE_FOG\nvoid main() {}\n");
+
+      std::string versionOnly = "#version 330 core";
+      ShaderKeywords::InjectDefines(versionOnly, "#define USE_FOG\n");
+      REQUIRE(versionOnly == "#version 330 core\n#define USE_FOG\n");
+
+      std::string noVersion = "void main() {}\n";
+      ShaderKeywords::InjectDefines(noVersion, "#define USE_FOG\n");
+      REQUIRE(noVersion == "#define USE_FOG\nvoid main() {}\n");
+    }
+
+    SECTION("SortKey")
+    {
+      //Program first, then variant, then material
+      using ShaderKeywords::MakeRenderSortKey;
+      REQUIRE(MakeRenderSortKey(1, 3, 9) < MakeRenderSortKey(2, 0, 0));
+      REQUIRE(MakeRenderSortKey(1, 0, 9) < MakeRenderSortKey(1, 1, 0));
+      REQUIRE(MakeRenderSortKey(1, 1, 2) < MakeRenderSortKey(1, 1, 3));
+      REQUIRE(MakeRenderSortKey(1, 1, 2) == MakeRenderSortKey(1, 1, 2));
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: MaterialConstants
+  //*****************************************************
+  TEST_CASE("MaterialConstants", "[material]")
+  {
+    using namespace NightEngine::Rendering::Opengl;
+
+    SECTION("Std140_Layout")
+    {
+      //float, vec4 has to skip to the next 16 bytes, int pack right after
+      MaterialConstantLayout layout;
+      layout.AddField("a", MaterialConstantType::FLOAT)
+        .AddField("b", MaterialConstantType::VEC4)
+        .AddField("c", MaterialConstantType::INT)
+        .AddField("d", MaterialConstantType::FLOAT);
+      REQUIRE(layout.FindField("a")->m_offset == 0);
+      REQUIRE(layout.FindField("b")->m_offset == 16);
+      REQUIRE(layout.FindField("c")->m_offset == 32);
+      REQUIRE(layout.FindField("d")->m_offset == 36);
+      REQUIRE(layout.FindField("e") == nullptr);
+      REQUIRE(layout.GetSize() == 48);
+
+      //Same as MaterialConstants in gbuffer_pass.frag
+      MaterialConstantLayout pbr;
+      pbr.AddField("u_diffuseColor", MaterialConstantType::VEC4);
+      for (const char* name : { "normal", "roughness", "metallic", "emissive", "cutoff" })
+      {
+        pbr.AddField(name, MaterialConstantType::FLOAT);
+      }
+      REQUIRE(pbr.FindField("normal")->m_offset == 16);
+      REQUIRE(pbr.FindField("cutoff")->m_offset == 32);
+      REQUIRE(pbr.GetSize() == 48);
+    }
+
+    SECTION("Pack")
+    {
+      MaterialConstantLayout layout;
+      layout.AddField("u_color", MaterialConstantType::VEC4)
+        .AddField("u_value", MaterialConstantType::FLOAT)
+        .AddField("u_flag", MaterialConstantType::INT)
+        .AddField("u_missing", MaterialConstantType::FLOAT);
+
+      std::map<std::string, glm::vec4> vec4Map{ { "u_color", glm::vec4(1.0f, 2.0f, 3.0f, 4.0f) } };
+      std::map<std::string, float> floatMap{ { "u_value", 0.5f }, { "u_notInLayout", 9.0f } };
+      std::map<std::string, int> intMap{ { "u_flag", 7 } };
+
+      std::vector<unsigned char> packed(layout.GetSize(), 0xFF);
+      layout.Pack(vec4Map, floatMap, intMap, packed.data());
+
+      float color[4];
+      float value, missing;
+      int flag;
+      std::memcpy(color, packed.data(), sizeof(color));
+      std::memcpy(&value, packed.data() + 16, sizeof(float));
+      std::memcpy(&flag, packed.data() + 20, sizeof(int));
+      std::memcpy(&missing, packed.data() + 24, sizeof(float));
+      REQUIRE(color[0] == 1.0f);
+      REQUIRE(color[3] == 4.0f);
+      REQUIRE(value == 0.5f);
+      REQUIRE(flag == 7);
+      REQUIRE(missing == 0.0f);
+      REQUIRE(packed.back() == 0);
+    }
+
+    SECTION("Buffer_Slots")
+    {
+      MaterialConstantBuffer buffer;
+      buffer.Init(256);
+
+      auto a = buffer.Allocate();
+      auto b = buffer.Allocate();
+      auto c = buffer.Allocate();
+      REQUIRE(b == a + 1);
+      REQUIRE(buffer.GetOffset(c) == 512);
+      REQUIRE(buffer.GetByteSize() == 768);
+      REQUIRE(buffer.GetDirtyBegin() == 0);
+      REQUIRE(buffer.GetDirtyEnd() == 768);
+
+      //Only the touched slot get uploaded
+      buffer.ClearDirty();
+      REQUIRE(!buffer.IsDirty());
+      buffer.GetData(b)[0] = 42;
+      buffer.MarkDirty(b);
+      REQUIRE(buffer.GetDirtyBegin() == 256);
+      REQUIRE(buffer.GetDirtyEnd() == 512);
+
+      //Freed slot is reused and zeroed
+      buffer.Free(b);
+      REQUIRE(buffer.GetLiveCount() == 2);
+      auto d = buffer.Allocate();
+      REQUIRE(d == b);
+      REQUIRE(buffer.GetData(d)[0] == 0);
+      REQUIRE(buffer.GetByteSize() == 768);
+
+      auto epoch = buffer.GetEpoch();
+      buffer.Clear();
+      REQUIRE(buffer.GetEpoch() != epoch);
+      REQUIRE(buffer.GetLiveCount() == 0);
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: HotReload
+  //*****************************************************
+  TEST_CASE("HotReload", "[hotreload]")
+  {
+    SECTION("Debouncer")
+    {
+      ChangeDebouncer debouncer{ 0.2 };
+      std::vector<FileChange> changes;
+
+      //Burst of writes is one change, reported after the quiet period
+      debouncer.Add("b.frag", FileChangeType::MODIFIED, 0.0);
+      debouncer.Add("b.frag", FileChangeType::MODIFIED, 0.1);
+      debouncer.Add("a.png", FileChangeType::MODIFIED, 0.15);
+      debouncer.Collect(0.25, changes);
+      REQUIRE(changes.empty());
+      REQUIRE(debouncer.GetPendingCount() == 2);
+
+      debouncer.Collect(0.4, changes);
+      REQUIRE(changes.size() == 2);
+      REQUIRE(changes[0].m_path == "a.png");
+      REQUIRE(changes[1].m_path == "b.frag");
+      REQUIRE(debouncer.GetPendingCount() == 0);
+
+      //Latest event win
+      changes.clear();
+      debouncer.Add("c.mat", FileChangeType::MODIFIED, 1.0);
+      debouncer.Add("c.mat", FileChangeType::REMOVED, 1.05);
+      debouncer.Collect(2.0, changes);
+      REQUIRE(changes.size() == 1);
+      REQUIRE(changes[0].m_type == FileChangeType::REMOVED);
+    }
+
+    SECTION("DependencyGraph")
+    {
+      AssetDependencyGraph graph;
+      graph.AddDependency("pass.frag", "lighting.glsl");
+      graph.AddDependency("lighting.glsl", "common.glsl");
+      graph.AddDependency("other.frag", "common.glsl");
+      graph.AddDependency("brick.mat", "brick.png");
+      graph.AddDependency("level.nscene", "brick.mat");
+      graph.AddDependency("level.nscene", "crate.obj");
+
+      std::vector<std::string> affected;
+      graph.GetAffected({ "common.glsl" }, affected);
+      REQUIRE(affected.size() == 4);
+      REQUIRE(affected[0] == "common.glsl");
+      REQUIRE(std::find(affected.begin(), affected.end(), "pass.frag") != affected.end());
+      REQUIRE(std::find(affected.begin(), affected.end(), "brick.mat") == affected.end());
+
+      //Texture reach the scene through its material, each file once
+      graph.GetAffected({ "brick.png", "brick.mat" }, affected);
+      REQUIRE(affected == std::vector<std::string>{ "brick.png", "brick.mat", "level.nscene" });
+
+      //Unknown file only affect itself
+      graph.GetAffected({ "unused.png" }, affected);
+      REQUIRE(affected == std::vector<std::string>{ "unused.png" });
+
+      std::vector<std::string> dependencies;
+      graph.GetDependencies("level.nscene", dependencies);
+      REQUIRE(dependencies == std::vector<std::string>{ "brick.mat", "crate.obj" });
+
+      //Edges are recorded again after the material is edited
+      graph.ClearDependencies("brick.mat");
+      graph.AddDependency("brick.mat", "stone.png");
+      graph.GetAffected({ "brick.png" }, affected);
+      REQUIRE(affected.size() == 1);
+      graph.GetAffected({ "stone.png" }, affected);
+      REQUIRE(affected.size() == 3);
+
+      //Cycle terminate
+      graph.AddDependency("common.glsl", "pass.frag");
+      graph.GetAffected({ "pass.frag" }, affected);
+      REQUIRE(affected.size() == 4);
+    }
+
+    SECTION("FileWatcher")
+    {
+      namespace fs = std::filesystem;
+      fs::path root = fs::temp_directory_path() / "nightengine_filewatcher_test";
+      fs::remove_all(root);
+      fs::create_directories(root / "sub");
+
+      FileWatcher watcher{ 0.1 };
+      REQUIRE(watcher.Watch(root.string()));
+      REQUIRE(!watcher.Watch((root / "missing").string()));
+
+      //Polling fallback depend on the file time resolution
+      if (watcher.IsNative())
+      {
+        std::vector<FileChange> changes;
+        {
+          std::ofstream file((root / "sub" / "a.glsl").string());
+          file << "float A() { return 1.0; }\n";
+        }
+        {
+          std::ofstream file((root / "sub" / "a.glsl").string(), std::ios::app);
+          file << "float B() { return 2.0; }\n";
+        }
+        watcher.Poll(0.0, changes);
+        watcher.Poll(0.05, changes);
+        REQUIRE(changes.empty());
+        watcher.Poll(1.0, changes);
+        REQUIRE(changes.size() == 1);
+        REQUIRE(changes[0].m_type == FileChangeType::MODIFIED);
+        REQUIRE(fs::path(changes[0].m_path).filename() == "a.glsl");
+
+        //Directory created after Watch is watched too
+        changes.clear();
+        fs::create_directories(root / "new");
+        watcher.Poll(2.0, changes);
+        {
+          std::ofstream file((root / "new" / "b.glsl").string());
+          file << "\n";
+        }
+        fs::remove(root / "sub" / "a.glsl");
+        watcher.Poll(2.0, changes);
+        watcher.Poll(3.0, changes);
+        REQUIRE(changes.size() == 2);
+        REQUIRE(fs::path(changes[0].m_path).filename() == "b.glsl");
+        REQUIRE(changes[1].m_type == FileChangeType::REMOVED);
+
+        //Directory moved in report the files it already hold
+        changes.clear();
+        fs::path outside = fs::temp_directory_path() / "nightengine_filewatcher_moved";
+        fs::remove_all(outside);
+        fs::create_directories(outside / "deep");
+        {
+          std::ofstream file((outside / "deep" / "c.glsl").string());
+          file << "\n";
+        }
+        fs::rename(outside, root / "moved");
+        watcher.Poll(4.0, changes);
+        watcher.Poll(5.0, changes);
+        REQUIRE(changes.size() == 1);
+        REQUIRE(changes[0].m_type == FileChangeType::MODIFIED);
+        REQUIRE(fs::path(changes[0].m_path).filename() == "c.glsl");
+      }
+
+      watcher.Clear();
+      fs::remove_all(root);
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: VirtualFileSystem
+  //*****************************************************
+  TEST_CASE("VirtualFileSystem", "[vfs]")
+  {
+    namespace fs = std::filesystem;
+
+    SECTION("LZ4")
+    {
+      std::vector<std::vector<char>> inputs;
+      inputs.emplace_back();
+      inputs.emplace_back(std::vector<char>{ 'a' });
+      inputs.emplace_back(std::vector<char>(100000, 'x'));
+
+      std::string text;
+      for (int i = 0; i < 2000; ++i)
+      {
+        text += "vec3 position" + std::to_string(i % 37) + " = u_model * a_position;\n";
+      }
+      inputs.emplace_back(text.begin(), text.end());
+
+      //Incompressible input still round trip within the bound
+      std::vector<char> noise(70000);
+      U32 state = 12345;
+      for (auto& c : noise)
+      {
+        state = state * 1664525u + 1013904223u;
+        c = static_cast<char>(state >> 24);
+      }
+      inputs.emplace_back(noise);
+
+      for (auto& input : inputs)
+      {
+        std::vector<char> compressed(Compression::GetLZ4Bound(input.size()));
+        size_t size = Compression::CompressLZ4(input.data(), input.size()
+          , compressed.data(), compressed.size());
+        REQUIRE(size > 0);
+        REQUIRE(size <= compressed.size());
+
+        std::vector<char> output(input.size());
+        REQUIRE(Compression::DecompressLZ4(compressed.data(), size, output.data(), output.size()));
+        REQUIRE(output == input);
+
+        //Truncated or wrongly sized input is rejected, not overrun
+        if (size > 1)
+        {
+          REQUIRE(!Compression::DecompressLZ4(compressed.data(), size - 1, output.data(), output.size()));
+        }
+        std::vector<char> tooSmall(input.size() > 0 ? input.size() - 1 : 0);
+        if (input.size() > 0)
+        {
+          REQUIRE(!Compression::DecompressLZ4(compressed.data(), size, tooSmall.data(), tooSmall.size()));
+        }
+      }
+
+      REQUIRE(Compression::CompressLZ4(text.data(), text.size(), nullptr, 10) == 0);
+    }
+
+    SECTION("PakArchive")
+    {
+      fs::path root = fs::temp_directory_path() / "nightengine_vfs_test";
+      fs::remove_all(root);
+      fs::create_directories(root);
+      std::string pakPath = (root / "test.pak").string();
+
+      std::string shader;
+      for (int i = 0; i < 500; ++i)
+      {
+        shader += "float Light" + std::to_string(i % 7) + "() { return 1.0; }\n";
+      }
+      std::vector<char> big(200000);
+      for (size_t i = 0; i < big.size(); ++i)
+      {
+        big[i] = static_cast<char>((i * 7919) >> 5);
+      }
+
+      PakWriter writer;
+      writer.AddData("Shaders/common.glsl", std::vector<char>(shader.begin(), shader.end()));
+      writer.AddData("Textures/empty.png", {});
+      writer.AddData("Models/big.bin", big);
+      for (int i = 0; i < 20; ++i)
+      {
+        writer.AddData("Materials/m" + std::to_string(i) + ".mat", std::vector<char>(5000, char('a' + i)));
+      }
+
+      std::string error;
+      REQUIRE(writer.Write(pakPath, CompressionType::LZ4, error));
+      REQUIRE(writer.GetStoredSize() < writer.GetTotalSize());
+
+      auto archive = std::make_shared<PakArchive>();
+      REQUIRE(archive->Open(pakPath));
+      REQUIRE(archive->GetEntryCount() == 23);
+      REQUIRE(archive->Find("Shaders/missing.glsl") == nullptr);
+
+      //Sorted table of content, small entries don't cross a block
+      for (size_t i = 0; i < archive->GetEntryCount(); ++i)
+      {
+        const PakEntry& entry = archive->GetEntry(i);
+        REQUIRE(archive->Find(archive->GetPath(entry)) == &entry);
+        if (i > 0)
+        {
+          REQUIRE(archive->GetEntry(i - 1).m_pathHash <= entry.m_pathHash);
+        }
+        if (entry.m_storedSize > c_PAK_BLOCK_SIZE)
+        {
+          REQUIRE(entry.m_offset % c_PAK_BLOCK_SIZE == 0);
+        }
+        else
+        {
+          REQUIRE(entry.m_offset / c_PAK_BLOCK_SIZE
+            == (entry.m_offset + entry.m_storedSize - 1) / c_PAK_BLOCK_SIZE);
+        }
+      }
+
+      PakBackend backend{ archive };
+      FileView file = backend.Read("Shaders/common.glsl");
+      REQUIRE(file.IsValid());
+      REQUIRE(file.GetString() == shader);
+      REQUIRE(backend.Read("Textures/empty.png").IsValid());
+      REQUIRE(backend.Read("Textures/empty.png").GetSize() == 0);
+      REQUIRE(!backend.Read("Textures/none.png").IsValid());
+
+      //Stored entry is a view into the mapping, no copy
+      PakWriter storeWriter;
+      storeWriter.AddData("Models/big.bin", big);
+      std::string storePath = (root / "store.pak").string();
+      REQUIRE(storeWriter.Write(storePath, CompressionType::NONE, error));
+      auto storeArchive = std::make_shared<PakArchive>();
+      REQUIRE(storeArchive->Open(storePath));
+      FileView view = PakBackend{ storeArchive }.Read("Models/big.bin");
+      REQUIRE(view.GetData() == storeArchive->GetStoredData(*storeArchive->Find("Models/big.bin")));
+      REQUIRE(std::memcmp(view.GetData(), big.data(), big.size()) == 0);
+
+      //View keep the archive mapped
+      storeArchive.reset();
+      REQUIRE(view.GetData()[big.size() - 1] == big.back());
+
+      std::vector<std::string> files;
+      backend.GetFiles(files);
+      REQUIRE(files.size() == 23);
+
+      //Corrupted archive is rejected
+      {
+        std::ofstream corrupt((root / "corrupt.pak").string(), std::ios::binary);
+        corrupt << "NPAK but not really";
+      }
+      PakArchive corruptArchive;
+      REQUIRE(!corruptArchive.Open((root / "corrupt.pak").string()));
+      REQUIRE(!corruptArchive.Open((root / "missing.pak").string()));
+
+      //Duplicated path
+      writer.AddData("Models/big.bin", {});
+      REQUIRE(!writer.Write((root / "dup.pak").string(), CompressionType::LZ4, error));
+
+      archive.reset();
+      file = FileView();
+      fs::remove_all(root);
+    }
+
+    SECTION("DirectoryBackend")
+    {
+      fs::path root = fs::temp_directory_path() / "nightengine_vfs_dir_test";
+      fs::remove_all(root);
+      fs::create_directories(root / "Shaders" / "Include");
+      {
+        std::ofstream((root / "Shaders" / "a.frag").string()) << "void main() {}\n";
+        std::ofstream((root / "Shaders" / "Include" / "b.glsl").string()) << "";
+      }
+
+      DirectoryBackend backend{ root.string() };
+      REQUIRE(backend.Exists("Shaders/a.frag"));
+      REQUIRE(!backend.Exists("Shaders"));
+      REQUIRE(backend.Read("Shaders/a.frag").GetString() == "void main() {}\n");
+      REQUIRE(backend.Read("Shaders/Include/b.glsl").IsValid());
+      REQUIRE(!backend.Read("Shaders/c.frag").IsValid());
+
+      std::vector<std::string> files;
+      backend.GetFiles(files);
+      std::sort(files.begin(), files.end());
+      REQUIRE(files == std::vector<std::string>{ "Shaders/Include/b.glsl", "Shaders/a.frag" });
+
+      fs::remove_all(root);
+    }
+
+    SECTION("VirtualPath")
+    {
+      std::string root{ PROJECT_DIR_SOURCE_ASSETS };
+      REQUIRE(VirtualFileSystem::ToVirtualPath(root + "Textures/a.png") == "Textures/a.png");
+      REQUIRE(VirtualFileSystem::ToVirtualPath("Textures\\Blank\\000.png") == "Textures/Blank/000.png");
+      REQUIRE(VirtualFileSystem::ToVirtualPath(root + "Models/Sponza/./sponza.mtl") == "Models/Sponza/sponza.mtl");
+      REQUIRE(VirtualFileSystem::ToVirtualPath(root + "Shaders//common.glsl") == "Shaders/common.glsl");
+      REQUIRE(VirtualFileSystem::ToVirtualPath("./Scenes/a.nscene") == "Scenes/a.nscene");
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: AssetDatabase
+  //*****************************************************
+  TEST_CASE("AssetDatabase", "[assetdatabase]")
+  {
+    namespace fs = std::filesystem;
+
+    fs::path root = fs::temp_directory_path() / "nightengine_assetdb_test";
+    fs::remove_all(root);
+    std::string assetRoot = (root / "Assets").string();
+    std::string cacheRoot = (root / "Cache").string();
+    fs::create_directories(root / "Assets" / "Models");
+    fs::create_directories(root / "Assets" / "Textures");
+    fs::create_directories(root / "Assets" / "Materials");
+
+    auto writeFile = [&](const std::string& path, const std::string& content)
+    {
+      std::ofstream file((root / "Assets" / path).string(), std::ios::out | std::ios::binary | std::ios::trunc);
+      file << content;
+    };
+
+    writeFile("Models/box.obj", "mtllib box.mtl\nv 0 0 0\n");
+    writeFile("Models/box.mtl", "map_Kd ../Textures/wood.png\n");
+    writeFile("Textures/wood.png", "wood pixels");
+    writeFile("Materials/wood.mat", "{ \"m_albedo\": \"./../Assets/Textures/wood.png\", \"m_value\": 1 }");
+    writeFile("readme.txt", "not an asset");
+
+    //Model cooker read the .mtl and reference the texture it names
+    std::atomic<int> cookCount{ 0 };
+    CookFN cookModel = [&](const std::string&, const FileView& source, CookOutput& output)
+    {
+      ++cookCount;
+      std::string mtlPath = "Models/../Models/box.mtl";
+      std::ifstream mtl((fs::path(assetRoot) / mtlPath).string());
+      std::string mtlContent{ std::istreambuf_iterator<char>(mtl), std::istreambuf_iterator<char>() };
+
+      output.m_data.assign(source.GetData(), source.GetData() + source.GetSize());
+      output.m_data.insert(output.m_data.end(), mtlContent.begin(), mtlContent.end());
+      output.m_inputs.emplace_back(mtlPath);
+      output.m_references.emplace_back("Textures/wood.png");
+      return true;
+    };
+    CookFN cookTexture = [&](const std::string&, const FileView& source, CookOutput& output)
+    {
+      ++cookCount;
+      output.m_data.assign(source.GetData(), source.GetData() + source.GetSize());
+      std::reverse(output.m_data.begin(), output.m_data.end());
+      return true;
+    };
+
+    SECTION("Guid")
+    {
+      AssetGuid guid = AssetGuid::Generate();
+      REQUIRE(guid.IsValid());
+      REQUIRE(guid != AssetGuid::Generate());
+
+      std::string str = guid.ToString();
+      REQUIRE(str.size() == 32);
+      AssetGuid parsed;
+      REQUIRE(AssetGuid::FromString(str, parsed));
+      REQUIRE(parsed == guid);
+
+      REQUIRE(!AssetGuid::FromString("1234", parsed));
+      REQUIRE(!AssetGuid::FromString(std::string(31, '0') + "g", parsed));
+      REQUIRE(parsed == guid);
+
+      REQUIRE(GetAssetType("Models/Box.OBJ") == AssetType::MODEL);
+      REQUIRE(GetAssetType("Textures/a.hdr") == AssetType::TEXTURE);
+      REQUIRE(GetAssetType("Materials/a.mat") == AssetType::MATERIAL);
+      REQUIRE(GetAssetType("readme.txt") == AssetType::UNKNOWN);
+    }
+
+    SECTION("Refresh")
+    {
+      AssetDatabase database{ assetRoot, cacheRoot };
+      REQUIRE(database.Refresh() == 3);
+      REQUIRE(database.GetRecordCount() == 3);
+      REQUIRE(database.Refresh() == 0);
+
+      AssetRecord box;
+      REQUIRE(database.GetRecord("Models/box.obj", box));
+      REQUIRE(box.m_guid.IsValid());
+      REQUIRE(box.m_type == AssetType::MODEL);
+      REQUIRE(database.GetPath(box.m_guid) == "Models/box.obj");
+
+      //Side files aren't assets on their own
+      AssetRecord record;
+      REQUIRE(!database.GetRecord("Models/box.mtl", record));
+      REQUIRE(!database.GetRecord("readme.txt", record));
+
+      //Edit keep the guid, only the hash change
+      writeFile("Textures/wood.png", "wood pixels, edited");
+      AssetRecord wood;
+      REQUIRE(database.GetRecord("Textures/wood.png", wood));
+      REQUIRE(database.Refresh() == 1);
+      AssetRecord edited;
+      REQUIRE(database.GetRecord("Textures/wood.png", edited));
+      REQUIRE(edited.m_guid == wood.m_guid);
+      REQUIRE(edited.m_sourceHash != wood.m_sourceHash);
+
+      //Rename keep the guid, matched by content
+      fs::rename(root / "Assets" / "Textures" / "wood.png", root / "Assets" / "Textures" / "oak.png");
+      REQUIRE(database.Refresh() == 1);
+      REQUIRE(!database.GetRecord("Textures/wood.png", record));
+      REQUIRE(database.GetRecord("Textures/oak.png", record));
+      REQUIRE(record.m_guid == wood.m_guid);
+
+      fs::remove(root / "Assets" / "Textures" / "oak.png");
+      REQUIRE(database.Refresh() == 1);
+      REQUIRE(database.GetRecordCount() == 2);
+      REQUIRE(database.GetPath(wood.m_guid).empty());
+    }
+
+    SECTION("CookKey")
+    {
+      AssetDatabase database{ assetRoot, cacheRoot };
+      database.Refresh();
+      REQUIRE(database.GetCookKey("Models/box.obj") == 0);
+
+      database.RegisterCooker(AssetType::MODEL, 1, cookModel);
+      U64 key = database.GetCookKey("Models/box.obj");
+      REQUIRE(key != 0);
+      REQUIRE(database.GetCookKey("Textures/wood.png") == 0);
+
+      //Cooking record the .mtl as an input, it's part of the key from now on
+      REQUIRE(database.LoadCooked("Models/box.obj").IsValid());
+      AssetRecord box;
+      REQUIRE(database.GetRecord("Models/box.obj", box));
+      REQUIRE(box.m_inputs == std::vector<std::string>{ "Models/box.mtl" });
+      REQUIRE(box.m_references == std::vector<std::string>{ "Textures/wood.png" });
+      U64 cookedKey = database.GetCookKey("Models/box.obj");
+      REQUIRE(cookedKey != key);
+
+      //Input edit
+      writeFile("Models/box.mtl", "map_Kd ../Textures/stone.png\n");
+      database.Refresh();
+      U64 inputKey = database.GetCookKey("Models/box.obj");
+      REQUIRE(inputKey != cookedKey);
+
+      //Source edit
+      writeFile("Models/box.obj", "mtllib box.mtl\nv 1 1 1\n");
+      database.Refresh();
+      U64 sourceKey = database.GetCookKey("Models/box.obj");
+      REQUIRE(sourceKey != inputKey);
+
+      //Import settings
+      database.RegisterCooker(AssetType::MODEL, 2, cookModel);
+      REQUIRE(database.GetCookKey("Models/box.obj") != sourceKey);
+      database.RegisterCooker(AssetType::MODEL, 1, cookModel);
+      REQUIRE(database.GetCookKey("Models/box.obj") == sourceKey);
+
+      //Same content at another path share the key
+      writeFile("Models/copy.obj", "mtllib box.mtl\nv 1 1 1\n");
+      database.Refresh();
+      database.RegisterCooker(AssetType::TEXTURE, 1, cookTexture);
+      REQUIRE(database.LoadCooked("Models/copy.obj").IsValid());
+      REQUIRE(database.GetCookKey("Models/copy.obj") == sourceKey);
+    }
+
+    SECTION("Cache")
+    {
+      AssetDatabase database{ assetRoot, cacheRoot };
+      database.RegisterCooker(AssetType::MODEL, 1, cookModel);
+      database.RegisterCooker(AssetType::TEXTURE, 1, cookTexture);
+      database.Refresh();
+
+      FileView texture = database.LoadCooked("Textures/wood.png");
+      REQUIRE(texture.IsValid());
+      REQUIRE(std::string(texture.GetData(), texture.GetSize()) == "slexip doow");
+      REQUIRE(cookCount == 1);
+
+      //Hit, mapped from the cache without cooking
+      texture = database.LoadCooked("Textures/wood.png");
+      REQUIRE(std::string(texture.GetData(), texture.GetSize()) == "slexip doow");
+      REQUIRE(cookCount == 1);
+      REQUIRE(database.ReadCache(database.GetCookKey("Textures/wood.png")).IsValid());
+
+      //Only the model is missing
+      REQUIRE(database.Cook() == 1);
+      REQUIRE(cookCount == 2);
+      REQUIRE(database.Cook() == 0);
+      REQUIRE(cookCount == 2);
+
+      //A new database over the same cache only cook what changed
+      writeFile("Models/box.mtl", "map_Kd ../Textures/stone.png\n");
+      REQUIRE(database.Save((root / "AssetDatabase.json").string()));
+
+      AssetDatabase reloaded{ assetRoot, cacheRoot };
+      reloaded.RegisterCooker(AssetType::MODEL, 1, cookModel);
+      reloaded.RegisterCooker(AssetType::TEXTURE, 1, cookTexture);
+      REQUIRE(reloaded.Load((root / "AssetDatabase.json").string()));
+      REQUIRE(reloaded.GetRecordCount() == database.GetRecordCount());
+      REQUIRE(reloaded.Refresh() == 1);
+      REQUIRE(reloaded.Cook() == 1);
+      REQUIRE(cookCount == 3);
+
+      FileView model = reloaded.LoadCooked("Models/box.obj");
+      REQUIRE(std::string(model.GetData(), model.GetSize())
+        == "mtllib box.mtl\nv 0 0 0\nmap_Kd ../Textures/stone.png\n");
+      REQUIRE(cookCount == 3);
+
+      AssetRecord before, after;
+      REQUIRE(database.GetRecord("Models/box.obj", before));
+      REQUIRE(reloaded.GetRecord("Models/box.obj", after));
+      REQUIRE(before.m_guid == after.m_guid);
+
+      //Broken file isn't loaded, the records stay
+      size_t recordCount = reloaded.GetRecordCount();
+      writeFile("broken.json", "{ \"version\": 1, \"assets\": [");
+      REQUIRE(!reloaded.Load((root / "Assets" / "broken.json").string()));
+      REQUIRE(reloaded.GetRecordCount() == recordCount);
+    }
+
+    SECTION("Dependents")
+    {
+      AssetDatabase database{ assetRoot, cacheRoot };
+      database.RegisterCooker(AssetType::MODEL, 1, cookModel);
+      database.RegisterCooker(AssetType::MATERIAL, 1, CookJsonReferences);
+      database.Refresh();
+      REQUIRE(database.Cook() == 2);
+
+      AssetRecord material;
+      REQUIRE(database.GetRecord("Materials/wood.mat", material));
+      REQUIRE(material.m_references == std::vector<std::string>{ "Textures/wood.png" });
+
+      std::vector<std::string> dependents;
+      database.GetDependents("Textures/wood.png", dependents);
+      std::sort(dependents.begin(), dependents.end());
+      REQUIRE(dependents == std::vector<std::string>{ "Materials/wood.mat", "Models/box.obj" });
+
+      database.GetDependents("Models/box.mtl", dependents);
+      REQUIRE(dependents == std::vector<std::string>{ "Models/box.obj" });
+
+      database.GetDependents("Models/box.obj", dependents);
+      REQUIRE(dependents.empty());
+    }
+
+    fs::remove_all(root);
+  }
+
+  //*****************************************************
+  // UnitTest: RenderGraph
+  //*****************************************************
+  TEST_CASE("RenderGraph", "[rendergraph]")
+  {
+    using namespace NightEngine::Rendering;
+    using ResourceID = RenderGraph::ResourceID;
+
+    //4K RGBA16F and RGB8
+    const RenderGraphTextureDesc hdrDesc{ 3840, 2160, 1, 8 };
+    const RenderGraphTextureDesc aoDesc{ 3840, 2160, 2, 4 };
+
+    SECTION("Culling")
+    {
+      RenderGraph graph;
+      std::vector<std::string> executed;
+      auto record = [&executed](const char* name)
+      {
+        return [&executed, name]() { executed.emplace_back(name); };
+      };
+
+      ResourceID backbuffer = graph.ImportTexture("Backbuffer");
+      ResourceID scene = graph.ImportTexture("Scene");
+      ResourceID ssao = graph.CreateTexture("SSAO", aoDesc);
+      ResourceID bloom = graph.CreateTexture("Bloom", hdrDesc);
+      ResourceID unused = graph.CreateTexture("Unused", hdrDesc);
+      graph.MarkOutput(backbuffer);
+
+      graph.AddPass("Lighting", record("Lighting")).Write(scene);
+      graph.AddPass("SSAO", record("SSAO")).Read(scene).Write(ssao);
+      graph.AddPass("Bloom", record("Bloom")).Read(scene).Write(bloom);
+      graph.AddPass("Orphan", record("Orphan")).Read(bloom).Write(unused);
+
+      //SSAO is disabled, nothing read its output
+      graph.AddPass("Uber", record("Uber")).Read(scene).Read(bloom).Write(scene);
+      graph.AddPass("Final", record("Final")).Read(scene).Write(backbuffer);
+
+      REQUIRE(graph.Compile());
+      REQUIRE(graph.GetPassCount() == 6);
+      REQUIRE(graph.GetActivePassCount() == 4);
+      REQUIRE(graph.IsPassCulled(1));
+      REQUIRE(graph.IsPassCulled(3));
+      REQUIRE(!graph.IsPassCulled(0));
+      REQUIRE(!graph.IsPassCulled(2));
+
+      //Culled passes don't execute and their textures get no target
+      graph.Execute();
+      REQUIRE(executed == std::vector<std::string>{ "Lighting", "Bloom", "Uber", "Final" });
+      REQUIRE(!graph.GetLifetime(ssao).IsUsed());
+      REQUIRE(graph.GetPhysicalIndex(ssao) == -1);
+      REQUIRE(graph.GetPhysicalIndex(unused) == -1);
+      REQUIRE(graph.GetPhysicalCount() == 1);
+
+      //Nothing is output, everything is culled
+      graph.Clear();
+      ResourceID target = graph.ImportTexture("Target");
+      graph.AddPass("Draw", record("Draw")).Write(target);
+      REQUIRE(graph.Compile());
+      REQUIRE(graph.GetActivePassCount() == 0);
+    }
+
+    SECTION("Lifetimes")
+    {
+      RenderGraph graph;
+      ResourceID backbuffer = graph.ImportTexture("Backbuffer");
+      ResourceID scene = graph.ImportTexture("Scene");
+      ResourceID ao = graph.CreateTexture("SSAO", aoDesc);
+      ResourceID bloom = graph.CreateTexture("Bloom", hdrDesc);
+      ResourceID taa = graph.CreateTexture("TAA", hdrDesc);
+      graph.MarkOutput(backbuffer);
+
+      graph.AddPass("Lighting", nullptr).Write(scene);                        //0
+      graph.AddPass("SSAO", nullptr).Read(scene).Write(ao);                   //1
+      graph.AddPass("Bloom", nullptr).Read(scene).Write(bloom);               //2
+      graph.AddPass("Uber", nullptr).Read(scene).Read(ao).Read(bloom)
+        .Write(scene);                                                        //3
+      graph.AddPass("TAA", nullptr).Read(scene).Write(taa);                   //4
+      graph.AddPass("Final", nullptr).Read(taa).Write(backbuffer);            //5
+      REQUIRE(graph.Compile());
+
+      auto lifetime = graph.GetLifetime(ao);
+      REQUIRE(lifetime.m_firstPass == 1);
+      REQUIRE(lifetime.m_lastPass == 3);
+      lifetime = graph.GetLifetime(bloom);
+      REQUIRE(lifetime.m_firstPass == 2);
+      REQUIRE(lifetime.m_lastPass == 3);
+      lifetime = graph.GetLifetime(taa);
+      REQUIRE(lifetime.m_firstPass == 4);
+      REQUIRE(lifetime.m_lastPass == 5);
+      lifetime = graph.GetLifetime(scene);
+      REQUIRE(lifetime.m_firstPass == 0);
+      REQUIRE(lifetime.m_lastPass == 4);
+
+      //Bloom is dead once Uber finish, TAA after tonemapping reuse its target
+      REQUIRE(graph.GetPhysicalIndex(bloom) == graph.GetPhysicalIndex(taa));
+      REQUIRE(graph.GetPhysicalIndex(ao) != graph.GetPhysicalIndex(bloom));
+      REQUIRE(graph.GetPhysicalIndex(scene) == -1);
+      REQUIRE(graph.GetPhysicalCount() == 2);
+      REQUIRE(graph.GetTransientBytes() == aoDesc.GetByteSize() + 2 * hdrDesc.GetByteSize());
+      REQUIRE(graph.GetPhysicalBytes() == aoDesc.GetByteSize() + hdrDesc.GetByteSize());
+    }
+
+    SECTION("Aliasing")
+    {
+      RenderGraph graph;
+      ResourceID output = graph.ImportTexture("Output");
+      graph.MarkOutput(output);
+
+      //Ping pong chain, each texture live from its write to the next pass
+      const RenderGraphTextureDesc halfDesc{ 1920, 1080, 1, 8 };
+      std::vector<ResourceID> chain;
+      for (int i = 0; i < 6; ++i)
+      {
+        chain.emplace_back(graph.CreateTexture("Chain" + std::to_string(i), hdrDesc));
+      }
+      ResourceID half = graph.CreateTexture("Half", halfDesc);
+
+      graph.AddPass("Pass0", nullptr).Write(chain[0]);
+      for (int i = 1; i < 6; ++i)
+      {
+        graph.AddPass("Pass" + std::to_string(i), nullptr).Read(chain[i - 1]).Write(chain[i]);
+      }
+      graph.AddPass("Downscale", nullptr).Read(chain[5]).Write(half);
+      graph.AddPass("Resolve", nullptr).Read(half).Write(output);
+      REQUIRE(graph.Compile());
+
+      //Reader and writer of a pass overlap, two targets are enough
+      REQUIRE(graph.GetPhysicalCount() == 3);
+      for (int i = 2; i < 6; ++i)
+      {
+        REQUIRE(graph.GetPhysicalIndex(chain[i]) == graph.GetPhysicalIndex(chain[i - 2]));
+        REQUIRE(graph.GetPhysicalIndex(chain[i]) != graph.GetPhysicalIndex(chain[i - 1]));
+      }
+
+      //Different size never share
+      int halfPhysical = graph.GetPhysicalIndex(half);
+      REQUIRE(graph.GetPhysicalDesc(halfPhysical) == halfDesc);
+      for (auto id : chain)
+      {
+        REQUIRE(graph.GetPhysicalIndex(id) != halfPhysical);
+      }
+      REQUIRE(graph.GetTransientBytes() == 6 * hdrDesc.GetByteSize() + halfDesc.GetByteSize());
+      REQUIRE(graph.GetPhysicalBytes() == 2 * hdrDesc.GetByteSize() + halfDesc.GetByteSize());
+
+      //Same graph compiled again give the same plan
+      std::vector<int> plan;
+      for (auto id : chain)
+      {
+        plan.emplace_back(graph.GetPhysicalIndex(id));
+      }
+      REQUIRE(graph.Compile());
+      for (size_t i = 0; i < chain.size(); ++i)
+      {
+        REQUIRE(graph.GetPhysicalIndex(chain[i]) == plan[i]);
+      }
+    }
+
+    SECTION("ReadBeforeWrite")
+    {
+      RenderGraph graph;
+      ResourceID output = graph.ImportTexture("Output");
+      ResourceID history = graph.ImportTexture("History");
+      ResourceID temp = graph.CreateTexture("Temp", hdrDesc);
+      graph.MarkOutput(output);
+
+      //Imported content exist from the last frame, transient don't
+      graph.AddPass("Reproject", nullptr).Read(history).Write(output);
+      REQUIRE(graph.Compile());
+
+      graph.AddPass("Broken", nullptr).Read(temp).Write(output);
+      graph.AddPass("Late", nullptr).Write(temp);
+      REQUIRE(!graph.Compile());
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: DynamicResolution
+  //*****************************************************
+  TEST_CASE("DynamicResolution", "[dynamicresolution]")
+  {
+    using namespace NightEngine::Rendering;
+
+    //Mocked GPU: pixel cost grow with the scale squared, plus a fixed cost
+    struct MockFrame
+    {
+      float m_pixelMs;
+      float m_fixedMs;
+      float operator()(float scale) const { return m_pixelMs * scale * scale + m_fixedMs; }
+    };
+
+    auto run = [](DynamicResolution& controller, const MockFrame& frame
+      , int frameCount, std::vector<float>& scales)
+    {
+      float scale = controller.GetScale();
+      for (int i = 0; i < frameCount; ++i)
+      {
+        scale = controller.Update(frame(scale));
+        scales.emplace_back(scale);
+      }
+    };
+
+    auto countChanges = [](const std::vector<float>& scales, size_t from)
+    {
+      int changes = 0;
+      for (size_t i = from + 1; i < scales.size(); ++i)
+      {
+        changes += scales[i] != scales[i - 1] ? 1 : 0;
+      }
+      return changes;
+    };
+
+    SECTION("ConvergeUnderBudget")
+    {
+      DynamicResolution controller;
+      controller.Reset();
+      const auto& settings = controller.m_settings;
+
+      //32ms at full resolution for a 16.6ms budget
+      MockFrame heavy{ 30.0f, 2.0f };
+      std::vector<float> scales;
+      run(controller, heavy, 300, scales);
+
+      float scale = controller.GetScale();
+      REQUIRE(scale < settings.m_maxScale);
+      REQUIRE(scale >= settings.m_minScale);
+      REQUIRE(heavy(scale) <= settings.m_targetFrameMs);
+
+      //Not wasting more than the hysteresis band plus a step
+      float nextStep = scale + settings.m_scaleStep;
+      REQUIRE(heavy(nextStep) > settings.m_targetFrameMs * settings.m_upscaleRatio);
+
+      //Settled, the last frames hold one scale
+      REQUIRE(countChanges(scales, 150) == 0);
+    }
+
+    SECTION("LightLoadStayAtMax")
+    {
+      DynamicResolution controller;
+      controller.Reset();
+
+      std::vector<float> scales;
+      run(controller, MockFrame{ 8.0f, 1.0f }, 200, scales);
+      for (float scale : scales)
+      {
+        REQUIRE(scale == controller.m_settings.m_maxScale);
+      }
+    }
+
+    SECTION("SpikeRejection")
+    {
+      DynamicResolution controller;
+      controller.Reset();
+
+      //Hitches of up to 3 frames every 30 frames don't move the scale
+      MockFrame frame{ 11.0f, 1.0f };
+      for (int i = 0; i < 600; ++i)
+      {
+        float frameMs = (i % 30) < 3 ? 60.0f : frame(controller.GetScale());
+        REQUIRE(controller.Update(frameMs) == controller.m_settings.m_maxScale);
+      }
+    }
+
+    SECTION("NoisyTraceDoesNotOscillate")
+    {
+      DynamicResolution controller;
+      controller.Reset();
+
+      //Deterministic +-10% noise on a heavy scene
+      MockFrame heavy{ 26.0f, 2.0f };
+      unsigned seed = 12345u;
+      std::vector<float> scales;
+      for (int i = 0; i < 1000; ++i)
+      {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = 0.9f + 0.2f * (float)(seed >> 8) / (float)(1u << 24);
+        scales.emplace_back(controller.Update(heavy(controller.GetScale()) * noise));
+      }
+
+      REQUIRE(controller.GetScale() < controller.m_settings.m_maxScale);
+      REQUIRE(countChanges(scales, 200) <= 2);
+    }
+
+    SECTION("ClampAndRecover")
+    {
+      DynamicResolution controller;
+      controller.Reset();
+      const auto& settings = controller.m_settings;
+
+      std::vector<float> scales;
+      run(controller, MockFrame{ 200.0f, 5.0f }, 300, scales);
+      REQUIRE(controller.GetScale() == Approx(settings.m_minScale));
+
+      //Load drop, climb back to full resolution without overshooting the range
+      scales.clear();
+      run(controller, MockFrame{ 4.0f, 1.0f }, 300, scales);
+      REQUIRE(controller.GetScale() == Approx(settings.m_maxScale));
+      for (size_t i = 1; i < scales.size(); ++i)
+      {
+        REQUIRE(scales[i] >= scales[i - 1]);
+        REQUIRE(scales[i] <= settings.m_maxScale);
+      }
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: HierarchyTree
+  //*****************************************************
+	TEST_CASE("HierarchyTree", "[hierarchy]")
+	{
+		using namespace Editor;
+		using Key = HierarchyTree::Key;
+
+		//Rows of the tree as keys, depth encoded in the high bits
+		auto rowsOf = [](HierarchyTree& tree)
+		{
+			std::vector<Key> result;
+			for (auto& row : tree.GetRows())
+			{
+				result.emplace_back(row.m_key + (Key(row.m_depth) << 32));
+			}
+			return result;
+		};
+		auto at = [](Key key, int depth) { return key + (Key(depth) << 32); };
+
+		//Flatten the expanded tree from scratch, the incremental rows must match it
+		auto referenceRows = [](const HierarchyTree& tree)
+		{
+			std::vector<Key> result;
+			std::vector<std::pair<Key, int>> stack;
+			auto& roots = tree.GetChildren(HierarchyTree::c_ROOT);
+			for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+			{
+				stack.emplace_back(*it, 0);
+			}
+			while (!stack.empty())
+			{
+				auto current = stack.back();
+				stack.pop_back();
+				result.emplace_back(current.first + (Key(current.second) << 32));
+				if (tree.IsExpanded(current.first))
+				{
+					auto& children = tree.GetChildren(current.first);
+					for (auto it = children.rbegin(); it != children.rend(); ++it)
+					{
+						stack.emplace_back(*it, current.second + 1);
+					}
+				}
+			}
+			return result;
+		};
+
+		HierarchyTree tree;
+		REQUIRE(tree.Add(1, "Root"));
+		REQUIRE(tree.Add(2, "Child A", 1));
+		REQUIRE(tree.Add(3, "Child B", 1));
+		REQUIRE(tree.Add(4, "Grand Child", 2));
+		REQUIRE(tree.Add(5, "Other Root"));
+		REQUIRE(!tree.Add(5, "Duplicated"));
+		REQUIRE(!tree.Add(6, "No Parent", 42));
+
+		SECTION("Collapsed_By_Default")
+		{
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(5, 0) });
+			REQUIRE(tree.HasChildren(1));
+			REQUIRE(!tree.HasChildren(5));
+			REQUIRE(tree.GetParent(4) == 2);
+		}
+
+		SECTION("Expand_Collapse")
+		{
+			tree.SetExpanded(1, true);
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(3, 1), at(5, 0) });
+
+			tree.SetExpanded(2, true);
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(4, 2), at(3, 1), at(5, 0) });
+
+			//Collapsing hide the whole subtree, expanding again restore it
+			tree.SetExpanded(1, false);
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(5, 0) });
+			tree.SetExpanded(1, true);
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(4, 2), at(3, 1), at(5, 0) });
+		}
+
+		SECTION("Add_Remove_Reparent")
+		{
+			tree.SetExpanded(1, true);
+
+			//Under a collapsed parent, no new row
+			REQUIRE(tree.Add(6, "Hidden", 2));
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(3, 1), at(5, 0) });
+
+			//Children of a removed node move to its parent
+			REQUIRE(tree.Remove(2));
+			REQUIRE(!tree.Contains(2));
+			REQUIRE(tree.GetParent(4) == 1);
+			REQUIRE(tree.GetParent(6) == 1);
+			REQUIRE(rowsOf(tree) == referenceRows(tree));
+
+			//Cycles are rejected
+			REQUIRE(!tree.Reparent(1, 4));
+			REQUIRE(!tree.Reparent(1, 1));
+			REQUIRE(tree.Reparent(1, 5));
+			REQUIRE(tree.GetChildren(HierarchyTree::c_ROOT) == std::vector<Key>{ 5 });
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(5, 0) });
+			tree.SetExpanded(5, true);
+			REQUIRE(rowsOf(tree) == referenceRows(tree));
+			REQUIRE(tree.GetRows()[1].m_depth == 1);
+			REQUIRE(tree.GetRows()[2].m_depth == 2);
+		}
+
+		SECTION("Randomized_Operations")
+		{
+			tree.Clear();
+			U32 seed = 12345u;
+			auto random = [&seed](U32 range)
+			{
+				seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+				return seed % range;
+			};
+
+			std::vector<Key> keys;
+			Key nextKey = 1;
+			for (int i = 0; i < 3000; ++i)
+			{
+				U32 op = keys.empty() ? 0 : random(10);
+				Key some = keys.empty() ? HierarchyTree::c_ROOT : keys[random((U32)keys.size())];
+				Key other = keys.empty() || random(4) == 0 ? HierarchyTree::c_ROOT
+					: keys[random((U32)keys.size())];
+				if (op < 4)
+				{
+					REQUIRE(tree.Add(nextKey, "Node " + std::to_string(nextKey), other));
+					keys.emplace_back(nextKey++);
+				}
+				else if (op < 5)
+				{
+					REQUIRE(tree.Remove(some));
+					keys.erase(std::find(keys.begin(), keys.end(), some));
+				}
+				else if (op < 7)
+				{
+					tree.Reparent(some, other);
+				}
+				else
+				{
+					tree.SetExpanded(some, !tree.IsExpanded(some));
+				}
+
+				if (i % 100 == 0)
+				{
+					REQUIRE(rowsOf(tree) == referenceRows(tree));
+				}
+			}
+			REQUIRE(tree.GetNodeCount() == keys.size());
+			REQUIRE(rowsOf(tree) == referenceRows(tree));
+		}
+
+		SECTION("Filter_With_Ancestors")
+		{
+			tree.SetFilter("grand");
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(4, 2) });
+
+			tree.Rename(3, "Grandma");
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(2, 1), at(4, 2), at(3, 1) });
+
+			tree.SetFilter("nothing");
+			REQUIRE(tree.GetRows().empty());
+
+			//Back to the expansion of the unfiltered tree
+			tree.SetFilter("");
+			REQUIRE(rowsOf(tree) == std::vector<Key>{ at(1, 0), at(5, 0) });
+		}
+
+		SECTION("Selection_By_Key")
+		{
+			tree.Select(2, false);
+			tree.Select(3, true);
+			REQUIRE(tree.IsSelected(2));
+			REQUIRE(tree.IsSelected(3));
+			tree.Select(4, false);
+			REQUIRE(tree.GetSelection().size() == 1);
+			tree.Remove(4);
+			REQUIRE(tree.GetSelection().empty());
+		}
+	}
+
+	TEST_CASE("NameSearchIndex", "[hierarchy]")
+	{
+		using namespace Editor;
+
+		NameSearchIndex index;
+		index.Insert(1, "Main Camera");
+		index.Insert(2, "Point Light");
+		index.Insert(3, "Spot Light");
+		index.Insert(4, "Ca");
+
+		std::vector<NameSearchIndex::Key> result;
+		SECTION("Case_Insensitive_Substring")
+		{
+			index.Search("LIGHT", result);
+			REQUIRE(result == std::vector<NameSearchIndex::Key>{ 2, 3 });
+			index.Search("t li", result);
+			REQUIRE(result == std::vector<NameSearchIndex::Key>{ 2, 3 });
+			index.Search("Camera!", result);
+			REQUIRE(result.empty());
+		}
+
+		SECTION("Short_Queries")
+		{
+			index.Search("ca", result);
+			REQUIRE(result == std::vector<NameSearchIndex::Key>{ 1, 4 });
+			index.Search("", result);
+			REQUIRE(result.size() == 4);
+		}
+
+		SECTION("Rename_Remove")
+		{
+			index.Insert(2, "Sun");
+			index.Search("light", result);
+			REQUIRE(result == std::vector<NameSearchIndex::Key>{ 3 });
+			index.Remove(3);
+			index.Search("light", result);
+			REQUIRE(result.empty());
+			REQUIRE(index.GetCount() == 3);
+			REQUIRE(!index.Contains(3));
+		}
+
+		SECTION("Compact_Removals")
+		{
+			for (NameSearchIndex::Key key = 100; key < 5100; ++key)
+			{
+				index.Insert(key, "Particle " + std::to_string(key));
+			}
+			for (NameSearchIndex::Key key = 100; key < 5000; ++key)
+			{
+				index.Remove(key);
+			}
+			index.Search("particle 50", result);
+			REQUIRE(result.size() == 100);
+			index.Search("cam", result);
+			REQUIRE(result == std::vector<NameSearchIndex::Key>{ 1 });
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: InputEvent
+  //*****************************************************
+  TEST_CASE("InputEvent", "[input]")
+  {
+    using namespace Input;
+
+    auto makeEvent = [](InputEventType type, int code, int action, double time = 0.0)
+    {
+      InputEvent inputEvent;
+      inputEvent.m_time = time;
+      inputEvent.m_type = type;
+      inputEvent.m_code = static_cast<U16>(code);
+      inputEvent.m_action = action;
+      return inputEvent;
+    };
+
+    SECTION("Ring_Order_Wrap_Drop")
+    {
+      auto ring = std::make_unique<InputEventRing>();
+      InputEvent popped;
+      for (int i = 0; i < 3000; ++i)
+      {
+        REQUIRE(ring->Push(makeEvent(InputEventType::KEY, i % 300, GLFW_PRESS, i)));
+        REQUIRE(ring->Pop(popped));
+        REQUIRE(popped.m_time == i);
+      }
+      REQUIRE(!ring->Pop(popped));
+
+      for (U32 i = 0; i < InputEventRing::c_CAPACITY; ++i)
+      {
+        REQUIRE(ring->Push(makeEvent(InputEventType::KEY, 0, GLFW_PRESS, i)));
+      }
+      REQUIRE(!ring->Push(makeEvent(InputEventType::KEY, 0, GLFW_PRESS)));
+      REQUIRE(ring->GetDroppedCount() == 1);
+      REQUIRE(ring->Pop(popped));
+      REQUIRE(popped.m_time == 0.0);
+    }
+
+    SECTION("Down_Held_Up")
+    {
+      InputState state;
+      state.BeginFrame();
+      state.Apply(makeEvent(InputEventType::KEY, GLFW_KEY_W, GLFW_PRESS));
+      REQUIRE(state.IsPressed(InputEventType::KEY, GLFW_KEY_W));
+      REQUIRE(!state.IsHeld(InputEventType::KEY, GLFW_KEY_W));
+
+      //Repeats don't press again
+      state.BeginFrame();
+      state.Apply(makeEvent(InputEventType::KEY, GLFW_KEY_W, GLFW_REPEAT));
+      REQUIRE(!state.IsPressed(InputEventType::KEY, GLFW_KEY_W));
+      REQUIRE(state.IsHeld(InputEventType::KEY, GLFW_KEY_W));
+
+      state.BeginFrame();
+      state.Apply(makeEvent(InputEventType::KEY, GLFW_KEY_W, GLFW_RELEASE));
+      REQUIRE(state.IsReleased(InputEventType::KEY, GLFW_KEY_W));
+      REQUIRE(!state.IsDown(InputEventType::KEY, GLFW_KEY_W));
+
+      state.BeginFrame();
+      REQUIRE(!state.IsReleased(InputEventType::KEY, GLFW_KEY_W));
+
+      //Out of range codes are ignored
+      REQUIRE(!state.IsDown(InputEventType::KEY, -1));
+      REQUIRE(!state.IsDown(InputEventType::JOY_BUTTON, 0, InputState::c_JOYSTICK_COUNT));
+    }
+
+    SECTION("Tap_Within_Frame")
+    {
+      InputState state;
+      state.BeginFrame();
+      state.Apply(makeEvent(InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS));
+      state.Apply(makeEvent(InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT, GLFW_RELEASE));
+      REQUIRE(state.IsPressed(InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT));
+      REQUIRE(state.IsReleased(InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT));
+      REQUIRE(!state.IsDown(InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT));
+    }
+
+    SECTION("Record_Replay")
+    {
+      //Pseudo random session
+      U32 seed = 777u;
+      auto random = [&seed](U32 range)
+      {
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        return seed % range;
+      };
+
+      const U32 frameCount = 600;
+      InputRecording recording;
+      InputState live;
+      std::vector<std::string> liveFrames;
+      auto snapshot = [](const InputState& state)
+      {
+        std::string result;
+        for (int key = 0; key < InputState::c_KEY_COUNT; ++key)
+        {
+          result += char('0' + state.IsPressed(InputEventType::KEY, key)
+            + 2 * state.IsReleased(InputEventType::KEY, key)
+            + 4 * state.IsHeld(InputEventType::KEY, key));
+        }
+        result += std::to_string(state.GetMousePosition().x) + ","
+          + std::to_string(state.GetMouseOffset().y);
+        return result;
+      };
+
+      for (U32 frame = 0; frame < frameCount; ++frame)
+      {
+        live.BeginFrame();
+        U32 eventCount = random(4);
+        for (U32 i = 0; i < eventCount; ++i)
+        {
+          InputEvent inputEvent = random(3) == 0 ?
+            makeEvent(InputEventType::MOUSE_MOVE, 0, GLFW_PRESS, frame)
+            : makeEvent(InputEventType::KEY, GLFW_KEY_A + random(8)
+              , random(2) ? GLFW_PRESS : GLFW_RELEASE, frame);
+          inputEvent.m_x = float(random(1920));
+          inputEvent.m_y = float(random(1080));
+          live.Apply(inputEvent);
+          recording.Add(frame, inputEvent);
+        }
+        recording.SetFrameCount(frame + 1);
+        liveFrames.emplace_back(snapshot(live));
+      }
+
+      std::stringstream stream;
+      REQUIRE(recording.Write(stream));
+
+      InputRecording loaded;
+      REQUIRE(loaded.Read(stream));
+      REQUIRE(loaded.GetFrameCount() == frameCount);
+      REQUIRE(loaded.GetEvents().size() == recording.GetEvents().size());
+
+      //Replaying twice give the same frames as the live session
+      for (int run = 0; run < 2; ++run)
+      {
+        InputState replayed;
+        InputReplay replay;
+        replay.Begin(loaded, replayed);
+        for (U32 frame = 0; frame < frameCount; ++frame)
+        {
+          REQUIRE(replay.ReplayFrame(replayed));
+          REQUIRE(snapshot(replayed) == liveFrames[frame]);
+        }
+        REQUIRE(replay.IsFinished());
+        REQUIRE(!replay.ReplayFrame(replayed));
+      }
+
+      //Truncated or foreign data is rejected
+      std::string data = stream.str();
+      std::stringstream truncated(data.substr(0, data.size() - 3));
+      REQUIRE(!loaded.Read(truncated));
+      std::stringstream foreign("NOPE0000000000000000");
+      REQUIRE(!loaded.Read(foreign));
+      REQUIRE(loaded.GetEvents().empty());
+    }
+  }
+
+  //*****************************************************
+  // UnitTest: WorldSnapshot
+  //*****************************************************
+	TEST_CASE("WorldSnapshot", "[worldsnapshot]")
+	{
+		SECTION("Slotmap_State")
+		{
+			Slotmap<int> slotmap(10, 5);
+			SlotmapID id[8];
+			for (int i = 0; i < 8; ++i)
+			{
+				id[i] = slotmap.CreateSlot();
+				*slotmap.Get(id[i]) = i;
+			}
+			slotmap.Destroy(id[3]);
+
+			Vector<std::max_align_t> memory(slotmap.GetStateSize() / sizeof(std::max_align_t) + 1);
+			U8* state = reinterpret_cast<U8*>(memory.data());
+			slotmap.WriteState(state);
+
+			//Change, destroy and create past the capacity of the state
+			*slotmap.Get(id[0]) = 100;
+			slotmap.Destroy(id[1]);
+			Vector<SlotmapID> created;
+			for (int i = 0; i < 20; ++i)
+			{
+				created.emplace_back(slotmap.CreateSlot());
+			}
+
+			Vector<SlotChange> changes;
+			slotmap.CompareState(state, changes);
+			REQUIRE(changes.size() == slotmap.GetArray().size());
+			REQUIRE(changes[id[0].m_index] == SlotChange::KEPT);
+			REQUIRE(changes[id[1].m_index] == SlotChange::REPLACED);
+			REQUIRE(changes[id[3].m_index] == SlotChange::DROPPED);
+			REQUIRE(changes[created.back().m_index] == SlotChange::DROPPED);
+			REQUIRE(changes.back() == SlotChange::NONE);
+
+			slotmap.ReadState(state);
+			Slotmap<int>::ReleaseState(state);
+			REQUIRE(slotmap.Size() == 7);
+			REQUIRE(slotmap.GetArray().size() == 30);
+			for (int i = 0; i < 8; ++i)
+			{
+				REQUIRE((i == 3 || *slotmap.Get(id[i]) == i));
+			}
+
+			//Handles from before the restore don't match the reused slots
+			for (auto& c : created)
+			{
+				REQUIRE(slotmap.Get(c) == nullptr);
+			}
+			SlotmapID reused = slotmap.CreateSlot();
+			REQUIRE(reused.m_index == id[3].m_index);
+			REQUIRE(!(reused == created[1]));
+
+			//Active list is back, in creation order
+			size_t count = 0;
+			for (auto it = slotmap.GetIterator(); !it.IsEnd(); it.Next())
+			{
+				++count;
+			}
+			REQUIRE(count == 8);
+		}
+
+		SECTION("Slotmap_State_NonTrivial")
+		{
+			Slotmap<std::string> slotmap(10, 5);
+			SlotmapID a = slotmap.CreateSlot();
+			*slotmap.Get(a) = "captured string, longer than the small buffer";
+
+			Vector<std::max_align_t> memory(slotmap.GetStateSize() / sizeof(std::max_align_t) + 1);
+			U8* state = reinterpret_cast<U8*>(memory.data());
+			slotmap.WriteState(state);
+
+			*slotmap.Get(a) = "changed";
+			SlotmapID b = slotmap.CreateSlot();
+			*slotmap.Get(b) = "created";
+
+			slotmap.ReadState(state);
+			Slotmap<std::string>::ReleaseState(state);
+			REQUIRE(*slotmap.Get(a) == "captured string, longer than the small buffer");
+			REQUIRE(slotmap.Get(b) == nullptr);
+			REQUIRE(slotmap.Size() == 1);
+		}
+
+		SECTION("Capture/Restore")
+		{
+			auto& gameObjects = NightEngine::Factory::GetTypeContainer<GameObject>();
+			auto& characters = NightEngine::Factory::GetTypeContainer<CharacterInfo>();
+			size_t gameObjectSize = gameObjects.Size();
+			size_t characterSize = characters.Size();
+
+			auto kept = GameObject::Create("Kept", 1);
+			kept->AddComponent("CharacterInfo");
+			kept->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->SetMoveSpeed(5.0f);
+			auto uid = kept->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->GetUID();
+			auto removed = GameObject::Create("Removed", 1);
+			removed->AddComponent("CharacterInfo");
+
+			WorldSnapshot snapshot;
+			snapshot.Capture({ "GameObject", "Transform", "CharacterInfo" });
+			REQUIRE(snapshot.IsCaptured());
+			REQUIRE(snapshot.GetSize() > 0);
+
+			//Play
+			kept->SetName("Renamed");
+			kept->GetTransform()->SetPosition(glm::vec3(1.0f));
+			kept->GetComponent<CharacterInfo>()->Get<CharacterInfo>()->SetMoveSpeed(42.0f);
+			removed->Destroy();
+			REQUIRE(!removed.IsValid());
+
+			Vector<Handle<GameObject>> spawned;
+			for (int i = 0; i < 100; ++i)
+			{
+				spawned.emplace_back(GameObject::Create("Spawned", 1));
+				spawned.back()->AddComponent("CharacterInfo");
+			}
+
+			REQUIRE(snapshot.Restore());
+			REQUIRE(gameObjects.Size() == gameObjectSize + 2);
+			REQUIRE(characters.Size() == characterSize + 2);
+
+			REQUIRE(kept->GetName() == "Kept");
+			REQUIRE(kept->GetTransform()->GetPosition() == glm::vec3(0.0f));
+			auto info = kept->GetComponent<CharacterInfo>()->Get<CharacterInfo>();
+			REQUIRE(info->GetMoveSpeed() == 5.0f);
+			REQUIRE(info->GetUID() == uid);
+
+			//Handles taken before the snapshot are valid again
+			REQUIRE(removed.IsValid());
+			REQUIRE(removed->GetName() == "Removed");
+			REQUIRE(removed->GetComponent<CharacterInfo>()->Get<CharacterInfo>()
+				->GetGameObject().m_handle == removed.m_handle);
+			for (auto& g : spawned)
+			{
+				REQUIRE(!g.IsValid());
+			}
+
+			//The capture is kept, restore twice
+			kept->SetName("Again");
+			REQUIRE(snapshot.Restore());
+			REQUIRE(kept->GetName() == "Kept");
+
+			snapshot.Release();
+			REQUIRE(!snapshot.IsCaptured());
+			REQUIRE(!snapshot.Restore());
+
+			kept->Destroy();
+			removed->Destroy();
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+			REQUIRE(characters.Size() == characterSize);
+		}
+
+		SECTION("WorldTypes")
+		{
+			auto types = WorldSnapshot::GetWorldTypes();
+			auto has = [&types](const char* name)
+			{
+				return std::find(types.begin(), types.end(), name) != types.end();
+			};
+			REQUIRE(has("GameObject"));
+			REQUIRE(has("Transform"));
+			REQUIRE(has("CharacterInfo"));
+			REQUIRE(!has("ComponentLogic"));
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: SceneLoader
+  //*****************************************************
+	//! @brief Array of count GameObjects like "m_sceneGameObjects" in a .nscene
+	static JsonValue MakeSceneGameObjects(size_t count)
+	{
+		auto source = GameObject::Create("Enemy", 2);
+		source->AddComponent("CharacterInfo");
+		source->AddComponent("Controller");
+
+		std::stringstream json;
+		NightEngine::Serialization::Serialize(*source, json);
+		source->Destroy();
+
+		JsonValue sourceValue = tao::json::from_string(json.str());
+		auto& gameObjectValue = sourceValue.get_object().begin()->second;
+
+		JsonValue array = tao::json::empty_array;
+		auto& elements = array.get_array();
+		elements.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			elements.emplace_back(gameObjectValue);
+			auto& obj = elements.back().get_object();
+			obj["m_name"] = "Enemy" + std::to_string(i);
+			obj["m_components"].get_object()["CharacterInfo"]
+				.get_object()["m_moveSpeed"] = static_cast<float>(i);
+		}
+		return array;
+	}
+
+	TEST_CASE("SceneLoader", "[sceneloader]")
+	{
+		auto& gameObjects = NightEngine::Factory::GetTypeContainer<GameObject>();
+		auto& characters = NightEngine::Factory::GetTypeContainer<CharacterInfo>();
+		size_t gameObjectSize = gameObjects.Size();
+		size_t characterSize = characters.Size();
+
+		SECTION("Parse_ModelPaths")
+		{
+			JsonValue array = tao::json::from_string(R"([
+				{ "m_name": "A", "m_components": { "MeshRenderer": { "m_meshLoadPath": "Cube.obj" } } },
+				{ "m_name": "B", "m_components": { "MeshRenderer": { "m_meshLoadPath": "Quad.obj" } } },
+				{ "m_name": "C", "m_components": { "MeshRenderer": { "m_meshLoadPath": "Cube.obj" } } },
+				{ "m_name": "D", "m_components": { "MeshRenderer": { "m_meshLoadPath": "" } } },
+				{ "m_name": "E", "m_components": { "CharacterInfo": {} } },
+				{ "m_name": "F" }
+			])");
+
+			SceneLoader loader;
+			loader.Parse(array);
+			REQUIRE(loader.GetGameObjectCount() == 6);
+
+			//Deduplicated, in the order they are found
+			auto& paths = loader.GetModelPaths();
+			REQUIRE(paths.size() == 2);
+			REQUIRE(paths[0] == "Cube.obj");
+			REQUIRE(paths[1] == "Quad.obj");
+
+			loader.Clear();
+			REQUIRE(loader.GetGameObjectCount() == 0);
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+		}
+
+		SECTION("Load")
+		{
+			const size_t count = 1000;
+			JsonValue array = MakeSceneGameObjects(count);
+
+			SceneLoader loader;
+			loader.Parse(array);
+			loader.Stage();
+
+			//Staging doesn't create anything
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+			REQUIRE(characters.Size() == characterSize);
+
+			Vector<Handle<GameObject>> loaded;
+			loader.Commit(loaded);
+			REQUIRE(loaded.size() == count);
+			REQUIRE(loader.GetGameObjectCount() == 0);
+
+			//Same order and values as the file, identity per GameObject
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto& g = *loaded[i];
+				REQUIRE(g.GetName() == "Enemy" + std::to_string(i));
+				REQUIRE(g.GetComponentCount() == 2);
+
+				auto info = g.GetComponent<CharacterInfo>()->Get<CharacterInfo>();
+				REQUIRE(info->GetMoveSpeed() == static_cast<float>(i));
+				REQUIRE(info->GetGameObject().m_handle == loaded[i].m_handle);
+			}
+
+			for (auto& g : loaded)
+			{
+				g->Destroy();
+			}
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+			REQUIRE(characters.Size() == characterSize);
+		}
+
+		SECTION("Benchmark_Load")
+		{
+			const size_t count = 20000;
+			JsonValue array = MakeSceneGameObjects(count);
+			Vector<Handle<GameObject>> loaded;
+			loaded.reserve(count);
+
+			//Before: create then deserialize each GameObject on this thread
+			StopWatch serialWatch{ true };
+			for (auto& value : array.get_array())
+			{
+				auto g = GameObject::Create("Unname", 1);
+				NightEngine::Reflection::Variable var{ METATYPE(GameObject), g.Get() };
+				var.Deserialize(value);
+				loaded.emplace_back(g);
+			}
+			serialWatch.Stop();
+			for (auto& g : loaded)
+			{
+				g->Destroy();
+			}
+			loaded.clear();
+			Debug::Log << Logger::MessageType::INFO << "Scene deserialize serial: "
+				<< serialWatch.GetElapsedTimeMilli() << " ms/" << count << '\n';
+
+			//After: staged across the workers, from inline up to every hardware thread
+			unsigned initialWorkers = JobSystem::GetWorkerCount();
+			unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			Vector<unsigned> workerCounts{ 0 };
+			for (unsigned workers = 1; workers < hardwareThreads; workers = workers * 2 + 1)
+			{
+				workerCounts.emplace_back(workers);
+			}
+			if (workerCounts.back() != hardwareThreads - 1)
+			{
+				workerCounts.emplace_back(hardwareThreads - 1);
+			}
+
+			for (unsigned workers : workerCounts)
+			{
+				JobSystem::Terminate();
+				if (workers > 0)
+				{
+					JobSystem::Initialize(workers);
+				}
+
+				SceneLoader loader;
+				StopWatch stageWatch{ true };
+				loader.Parse(array);
+				loader.Stage();
+				stageWatch.Stop();
+
+				StopWatch commitWatch{ true };
+				loader.Commit(loaded);
+				commitWatch.Stop();
+
+				REQUIRE(loaded.size() == count);
+				REQUIRE(loaded.back()->GetName() == "Enemy" + std::to_string(count - 1));
+				for (auto& g : loaded)
+				{
+					g->Destroy();
+				}
+				loaded.clear();
+
+				Debug::Log << Logger::MessageType::INFO << "SceneLoader " << (workers + 1)
+					<< " threads, parse+stage: " << stageWatch.GetElapsedTimeMilli()
+					<< " ms, commit: " << commitWatch.GetElapsedTimeMilli()
+					<< " ms/" << count << '\n';
+			}
+
+			JobSystem::Terminate();
+			if (initialWorkers > 0)
+			{
+				JobSystem::Initialize(initialWorkers);
+			}
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+			REQUIRE(characters.Size() == characterSize);
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: WorldPartition
+  //*****************************************************
+	TEST_CASE("WorldPartition", "[worldpartition]")
+	{
+		using CellState = WorldPartition::CellState;
+
+		SECTION("Grid")
+		{
+			REQUIRE(WorldPartition::GetCell(glm::vec3(5.0f, 100.0f, 15.0f), 10.0f) == CellCoord{ 0, 1 });
+			REQUIRE(WorldPartition::GetCell(glm::vec3(-0.5f, 0.0f, -10.0f), 10.0f) == CellCoord{ -1, -1 });
+
+			//Distance to the closest point of the cell, zero inside
+			REQUIRE(WorldPartition::GetCellDistance({ 0, 0 }, glm::vec3(5.0f, 0.0f, 5.0f), 10.0f) == 0.0f);
+			REQUIRE(WorldPartition::GetCellDistance({ 2, 0 }, glm::vec3(5.0f, 0.0f, 5.0f), 10.0f) == 15.0f);
+			REQUIRE(WorldPartition::GetCellDistance({ -1, -1 }, glm::vec3(3.0f, 0.0f, 4.0f), 10.0f) == 5.0f);
+
+			CellCoord cell;
+			auto fileName = WorldPartition::GetCellFileName("World", { -3, 12 });
+			REQUIRE(fileName == "World_-3_12.nscene");
+			REQUIRE(WorldPartition::ParseCellSceneName("World", "World_-3_12", cell));
+			REQUIRE(cell == CellCoord{ -3, 12 });
+			REQUIRE(!WorldPartition::ParseCellSceneName("World", "World_-3_12x", cell));
+			REQUIRE(!WorldPartition::ParseCellSceneName("World", "Other_1_2", cell));
+			REQUIRE(!WorldPartition::ParseCellSceneName("World", "World_1", cell));
+		}
+
+		//Every cell in [-3, 3] hold the same few GameObjects, the ones outside are empty
+		std::string cellJson;
+		{
+			Scene cellScene;
+			for (int i = 0; i < 4; ++i)
+			{
+				auto g = GameObject::Create("Tree", 1);
+				g->AddComponent("CharacterInfo");
+				cellScene.AddGameObject(g);
+			}
+
+			std::stringstream json;
+			NightEngine::Serialization::Serialize(cellScene, json, SceneManager::SerializeScene);
+			cellJson = json.str();
+
+			for (auto& g : cellScene.GetAllGameObjects())
+			{
+				g->Destroy();
+			}
+			cellScene.Clear();
+		}
+
+		std::atomic<int> readCount{ 0 };
+		auto source = [&cellJson, &readCount](const CellCoord& cell, String& outJson)
+		{
+			++readCount;
+			if (std::abs(cell.m_x) > 3 || std::abs(cell.m_z) > 3)
+			{
+				return false;
+			}
+			outJson = cellJson;
+			return true;
+		};
+
+		WorldPartitionSettings settings;
+		settings.m_worldName = "UnitTestWorld";
+		settings.m_cellSize = 10.0f;
+		settings.m_loadRadius = 15.0f;
+		settings.m_unloadRadius = 25.0f;
+		settings.m_activationsPerFrame = 2;
+		settings.m_maxPendingLoads = 64;
+
+		auto& gameObjects = NightEngine::Factory::GetTypeContainer<GameObject>();
+		size_t gameObjectSize = gameObjects.Size();
+		size_t sceneCount = SceneManager::GetAllScenes()->size();
+
+		WorldPartition partition;
+		auto settle = [&partition](const glm::vec3& focus)
+		{
+			for (int i = 0; i < 32; ++i)
+			{
+				partition.Update(focus);
+				partition.WaitForLoads();
+			}
+		};
+
+		SECTION("Streaming")
+		{
+			partition.Open(settings, source);
+			glm::vec3 focus{ 5.0f, 0.0f, 5.0f };
+
+			//Loads are started then activated a few per frame
+			partition.Update(focus);
+			REQUIRE(partition.GetActiveCellCount() == 0);
+			partition.WaitForLoads();
+			partition.Update(focus);
+			REQUIRE(partition.GetActiveCellCount() == 2);
+
+			settle(focus);
+			REQUIRE(partition.GetCellState({ 0, 0 }) == CellState::ACTIVE);
+			REQUIRE(partition.GetCellState({ 2, 0 }) == CellState::ACTIVE);
+			REQUIRE(partition.GetCellState({ 1, -1 }) == CellState::ACTIVE);
+			REQUIRE(partition.GetCellState({ 2, 1 }) == CellState::UNLOADED);
+			REQUIRE(partition.GetActiveCellCount() == 13);
+			REQUIRE(SceneManager::GetAllScenes()->size() == sceneCount + 13);
+			REQUIRE(gameObjects.Size() == gameObjectSize + 13 * 4);
+
+			auto scene = partition.GetCellScene({ 0, 0 });
+			REQUIRE(scene.IsValid());
+			REQUIRE(scene->GetAllGameObjects().size() == 4);
+			REQUIRE(scene->GetSceneNodes().size() == 4);
+			REQUIRE(scene->GetAllGameObjects()[0]->GetName() == "Tree");
+
+			//Hysteresis, cells past the load radius stay until the unload radius
+			focus = glm::vec3(25.0f, 0.0f, 5.0f);
+			settle(focus);
+			REQUIRE(partition.GetCellState({ -1, 0 }) == CellState::ACTIVE);
+			REQUIRE(partition.GetCellState({ 4, 0 }) == CellState::EMPTY);
+
+			focus = glm::vec3(26.0f, 0.0f, 5.0f);
+			settle(focus);
+			REQUIRE(partition.GetCellState({ -1, 0 }) == CellState::UNLOADED);
+			REQUIRE(partition.GetCellState({ 0, 0 }) == CellState::ACTIVE);
+
+			//Back and forth across a border doesn't read anything again
+			settle(glm::vec3(21.0f, 0.0f, 5.0f));
+			settle(glm::vec3(19.0f, 0.0f, 5.0f));
+			int reads = readCount;
+			for (int i = 0; i < 8; ++i)
+			{
+				settle(glm::vec3((i % 2) ? 19.0f : 21.0f, 0.0f, 5.0f));
+			}
+			REQUIRE(readCount == reads);
+
+			partition.Close();
+			REQUIRE(!partition.IsOpen());
+			REQUIRE(partition.GetResidentSize() == 0);
+			REQUIRE(SceneManager::GetAllScenes()->size() == sceneCount);
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+		}
+
+		SECTION("MemoryBudget")
+		{
+			SceneManager::StagedScene staged;
+			SceneManager::StageScene(cellJson, staged);
+			size_t cellBytes = staged.m_loader.GetStagedSize();
+			staged.m_loader.Clear();
+			REQUIRE(cellBytes > 0);
+
+			settings.m_memoryBudget = cellBytes * 3;
+			partition.Open(settings, source);
+
+			glm::vec3 focus{ 5.0f, 0.0f, 5.0f };
+			settle(focus);
+			REQUIRE(partition.GetResidentSize() <= settings.m_memoryBudget);
+			REQUIRE(partition.GetActiveCellCount() == 3);
+			REQUIRE(partition.GetCellState({ 0, 0 }) == CellState::ACTIVE);
+
+			//Moving away, the nearest cells take the place of the farthest
+			focus = glm::vec3(35.0f, 0.0f, 5.0f);
+			settle(focus);
+			REQUIRE(partition.GetResidentSize() <= settings.m_memoryBudget);
+			REQUIRE(partition.GetActiveCellCount() == 3);
+			REQUIRE(partition.GetCellState({ 3, 0 }) == CellState::ACTIVE);
+			REQUIRE(partition.GetCellState({ 0, 0 }) != CellState::ACTIVE);
+
+			partition.Close();
+			REQUIRE(SceneManager::GetAllScenes()->size() == sceneCount);
+			REQUIRE(gameObjects.Size() == gameObjectSize);
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: Animation
+  //*****************************************************
+	//! @brief Chain of boneCount bones, each one unit above its parent
+	static Rendering::Animation::Skeleton MakeChainSkeleton(size_t boneCount)
+	{
+		using namespace Rendering::Animation;
+		Skeleton skeleton;
+		glm::mat4 globalBind{ 1.0f };
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			BoneTransform bindPose;
+			bindPose.m_translation = glm::vec3(0.0f, 1.0f, 0.0f);
+			globalBind = globalBind * bindPose.ToMatrix();
+			skeleton.AddBone("Bone" + std::to_string(i), static_cast<int>(i) - 1
+				, bindPose, glm::inverse(globalBind));
+		}
+		return skeleton;
+	}
+
+	//! @brief 2 seconds of waving baked at 30 fps, like an imported clip
+	static Rendering::Animation::AnimationClip MakeWaveClip(size_t boneCount, float frequency)
+	{
+		using namespace Rendering::Animation;
+		AnimationClip clip;
+		clip.m_name = "Wave";
+		clip.m_duration = 2.0f;
+		clip.m_tracks.resize(boneCount);
+		glm::vec3 axis = glm::normalize(glm::vec3(0.3f, 0.0f, 1.0f));
+		for (size_t i = 0; i < boneCount; ++i)
+		{
+			auto& track = clip.m_tracks[i];
+			for (int frame = 0; frame <= 60; ++frame)
+			{
+				float time = frame / 30.0f;
+				float angle = 0.5f * std::sin(time * frequency + i * 0.3f);
+				track.m_rotations.push_back({ time, glm::angleAxis(angle, axis) });
+				track.m_translations.push_back({ time
+					, glm::vec3(0.0f, 1.0f + 0.1f * std::sin(time * 2.0f), 0.0f) });
+				track.m_scales.push_back({ time, glm::vec3(1.0f) });
+			}
+		}
+		return clip;
+	}
+
+	//! @brief Angle between rotations, precise near zero
+	static float GetRotationError(const glm::quat& a, const glm::quat& b)
+	{
+		glm::quat difference = a * glm::conjugate(b);
+		float sine = glm::length(glm::vec3(difference.x, difference.y, difference.z));
+		return 2.0f * std::asin(std::min(sine, 1.0f));
+	}
+
+	TEST_CASE("Animation", "[animation]")
+	{
+		using namespace Rendering::Animation;
+		const size_t boneCount = 64;
+		Skeleton skeleton = MakeChainSkeleton(boneCount);
+		AnimationClip clip = MakeWaveClip(boneCount, 3.0f);
+
+		CompressionSettings settings;
+		CompressedClip compressed;
+		compressed.Compress(clip, skeleton, settings);
+
+		SECTION("QuantizeRotation")
+		{
+			//15 bits over [-1/sqrt(2), 1/sqrt(2)] per component
+			std::mt19937 random{ 7 };
+			std::uniform_real_distribution<float> range{ -1.0f, 1.0f };
+			float maxError = 0.0f;
+			for (int i = 0; i < 10000; ++i)
+			{
+				glm::quat rotation = glm::normalize(glm::quat(range(random), range(random)
+					, range(random), range(random)));
+				glm::quat result = CompressedClip::DequantizeRotation(
+					CompressedClip::QuantizeRotation(rotation));
+				maxError = std::max(maxError, GetRotationError(rotation, result));
+			}
+			REQUIRE(maxError < 2e-4f);
+		}
+
+		SECTION("CompressionError")
+		{
+			size_t rawKeyCount = 0;
+			size_t rawSize = 0;
+			for (auto& track : clip.m_tracks)
+			{
+				rawKeyCount += track.m_translations.size() + track.m_rotations.size()
+					+ track.m_scales.size();
+				rawSize += (track.m_translations.size() + track.m_scales.size())
+					* sizeof(AnimationKey<glm::vec3>)
+					+ track.m_rotations.size() * sizeof(AnimationKey<glm::quat>);
+			}
+			REQUIRE(compressed.GetBoneCount() == boneCount);
+			REQUIRE(compressed.GetKeyCount() < rawKeyCount);
+			REQUIRE(compressed.GetSize() * 3 < rawSize);
+
+			//Tolerance of the key reduction, plus the quantization of the kept keys
+			Vector<BoneTransform> reference;
+			Pose pose;
+			float rotationError = 0.0f;
+			float translationError = 0.0f;
+			float scaleError = 0.0f;
+			for (int i = 0; i <= 1000; ++i)
+			{
+				float time = clip.m_duration * i / 1000.0f;
+				clip.Sample(skeleton, time, reference);
+				compressed.Sample(time, pose);
+				REQUIRE(pose.GetBoneCount() == boneCount);
+				for (size_t bone = 0; bone < boneCount; ++bone)
+				{
+					BoneTransform transform = pose.GetBone(bone);
+					rotationError = std::max(rotationError
+						, GetRotationError(transform.m_rotation, reference[bone].m_rotation));
+					translationError = std::max(translationError
+						, glm::length(transform.m_translation - reference[bone].m_translation));
+					scaleError = std::max(scaleError
+						, glm::length(transform.m_scale - reference[bone].m_scale));
+				}
+			}
+			Debug::Log << Logger::MessageType::INFO << "CompressedClip " << compressed.GetKeyCount()
+				<< '/' << rawKeyCount << " keys, " << compressed.GetSize() << '/' << rawSize
+				<< " bytes, max error rotation: " << rotationError << " rad, translation: "
+				<< translationError << '\n';
+			REQUIRE(rotationError < settings.m_rotationTolerance + 2e-4f);
+			REQUIRE(translationError < settings.m_translationTolerance + 1e-4f);
+			REQUIRE(scaleError < settings.m_scaleTolerance + 1e-4f);
+		}
+
+		SECTION("Serialization")
+		{
+			std::vector<char> data;
+			skeleton.Write(data);
+			compressed.Write(data);
+
+			Skeleton readSkeleton;
+			CompressedClip readClip;
+			size_t offset = 0;
+			REQUIRE(readSkeleton.Read(data.data(), data.size(), offset));
+			REQUIRE(readClip.Read(data.data(), data.size(), offset));
+			REQUIRE(offset == data.size());
+			REQUIRE(readSkeleton.GetBoneCount() == boneCount);
+			REQUIRE(readSkeleton.FindBone("Bone5") == 5);
+			REQUIRE(readSkeleton.GetParent(5) == 4);
+			REQUIRE(readClip.GetName() == "Wave");
+			REQUIRE(readClip.GetKeyCount() == compressed.GetKeyCount());
+
+			Pose expected, result;
+			compressed.Sample(0.7f, expected);
+			readClip.Sample(0.7f, result);
+			for (size_t bone = 0; bone < boneCount; ++bone)
+			{
+				REQUIRE(result.GetBone(bone).m_rotation == expected.GetBone(bone).m_rotation);
+				REQUIRE(result.GetBone(bone).m_translation == expected.GetBone(bone).m_translation);
+			}
+
+			//Truncated data is refused
+			offset = 0;
+			REQUIRE(!readSkeleton.Read(data.data(), 16, offset));
+		}
+
+		SECTION("BlendAndSkin")
+		{
+			Pose a, b, blended;
+			compressed.Sample(0.2f, a);
+			compressed.Sample(1.3f, b);
+
+			BlendPoses(a, b, 0.0f, blended);
+			for (size_t bone = 0; bone < boneCount; ++bone)
+			{
+				REQUIRE(GetRotationError(blended.GetBone(bone).m_rotation, a.GetBone(bone).m_rotation) < 1e-5f);
+			}
+			BlendPoses(a, b, 1.0f, blended);
+			for (size_t bone = 0; bone < boneCount; ++bone)
+			{
+				REQUIRE(GetRotationError(blended.GetBone(bone).m_rotation, b.GetBone(bone).m_rotation) < 1e-5f);
+			}
+
+			//SoA model space matrices match the scalar chain
+			Vector<glm::mat4> modelMatrices(boneCount);
+			LocalToModel(skeleton, a, modelMatrices.data());
+			glm::mat4 expected{ 1.0f };
+			float matrixError = 0.0f;
+			for (size_t bone = 0; bone < boneCount; ++bone)
+			{
+				expected = expected * a.GetBone(bone).ToMatrix();
+				for (int column = 0; column < 4; ++column)
+				{
+					glm::vec4 difference = glm::abs(expected[column] - modelMatrices[bone][column]);
+					matrixError = std::max(matrixError, std::max(std::max(difference.x, difference.y)
+						, std::max(difference.z, difference.w)));
+				}
+			}
+			REQUIRE(matrixError < 1e-3f);
+
+			//The bind pose skin the vertices where they are
+			Pose bindPose;
+			bindPose.SetBindPose(skeleton);
+			LocalToModel(skeleton, bindPose, modelMatrices.data());
+			Vector<SkinMatrix> palette(boneCount);
+			BuildSkinningPalette(skeleton, modelMatrices.data(), palette.data());
+			for (auto& skin : palette)
+			{
+				for (int row = 0; row < 3; ++row)
+				{
+					glm::vec4 identity{ 0.0f };
+					identity[row] = 1.0f;
+					REQUIRE(glm::length(skin.m_rows[row] - identity) < 1e-3f);
+				}
+			}
+		}
+
+		SECTION("Animator")
+		{
+			auto sharedSkeleton = std::make_shared<Skeleton>(skeleton);
+			auto walk = std::make_shared<CompressedClip>(compressed);
+			AnimationClip runClip = MakeWaveClip(boneCount, 6.0f);
+			runClip.m_name = "Run";
+			auto run = std::make_shared<CompressedClip>();
+			run->Compress(runClip, skeleton);
+
+			auto character = GameObject::Create("Character", 2);
+			auto animator = character->AddComponent("Animator")->Get<Components::Animator>();
+			animator->SetRig(sharedSkeleton, { walk, run });
+			REQUIRE(animator->IsPlaying());
+			REQUIRE(!animator->Play("Jump"));
+			REQUIRE(animator->Play("Run"));
+
+			//Looping wrap the time into the clip
+			animator->Advance(2.5f);
+			REQUIRE(animator->GetTime() == Approx(0.5f));
+			REQUIRE(animator->SetBlend("Wave", 0.5f));
+
+			Vector<AnimationTask> tasks{ animator->MakeTask() };
+			AnimationSystem::EvaluateAll(tasks);
+			REQUIRE(animator->GetModelMatrices().size() == boneCount);
+			character->Destroy();
+		}
+
+		SECTION("Benchmark")
+		{
+			//Hundreds of characters sampling, blending and skinning every frame
+			const size_t characterCount = 500;
+			Vector<CharacterPose> characters(characterCount);
+			Vector<SkinMatrix> palette(characterCount * boneCount);
+			Vector<AnimationTask> tasks(characterCount);
+			for (size_t i = 0; i < characterCount; ++i)
+			{
+				AnimationTask& task = tasks[i];
+				task.m_skeleton = &skeleton;
+				task.m_clip = &compressed;
+				task.m_time = 0.01f * i;
+				task.m_blendClip = &compressed;
+				task.m_blendTime = 1.0f + 0.01f * i;
+				task.m_blendWeight = 0.3f;
+				task.m_output = &characters[i];
+				task.m_palette = palette.data() + i * boneCount;
+			}
+
+			unsigned initialWorkers = JobSystem::GetWorkerCount();
+			unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			Vector<unsigned> workerCounts{ 0 };
+			for (unsigned workers = 1; workers < hardwareThreads; workers = workers * 2 + 1)
+			{
+				workerCounts.emplace_back(workers);
+			}
+			if (workerCounts.back() != hardwareThreads - 1)
+			{
+				workerCounts.emplace_back(hardwareThreads - 1);
+			}
+
+			for (unsigned workers : workerCounts)
+			{
+				JobSystem::Terminate();
+				if (workers > 0)
+				{
+					JobSystem::Initialize(workers);
+				}
+
+				const int frames = 10;
+				StopWatch watch{ true };
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					AnimationSystem::EvaluateAll(tasks);
+				}
+				watch.Stop();
+
+				REQUIRE(characters.back().m_modelMatrices.size() == boneCount);
+				Debug::Log << Logger::MessageType::INFO << "AnimationSystem " << (workers + 1)
+					<< " threads: " << watch.GetElapsedTimeMilli() / frames << " ms/frame, "
+					<< characterCount << " characters x " << boneCount << " bones\n";
+			}
+
+			JobSystem::Terminate();
+			if (initialWorkers > 0)
+			{
+				JobSystem::Initialize(initialWorkers);
+			}
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: Particles
+  //*****************************************************
+	//! @brief Spawn count particles at position with velocity, every one living lifetime
+	static void SpawnParticles(Rendering::Particles::ParticlePool& pool, size_t count
+		, const glm::vec3& position, const glm::vec3& velocity, float lifetime)
+	{
+		using Stream = Rendering::Particles::ParticlePool::Stream;
+		size_t spawned = 0;
+		size_t first = pool.Spawn(count, spawned);
+		for (size_t i = first; i < first + spawned; ++i)
+		{
+			pool.GetStream(Stream::POSITION_X)[i] = position.x;
+			pool.GetStream(Stream::POSITION_Y)[i] = position.y;
+			pool.GetStream(Stream::POSITION_Z)[i] = position.z;
+			pool.GetStream(Stream::VELOCITY_X)[i] = velocity.x;
+			pool.GetStream(Stream::VELOCITY_Y)[i] = velocity.y;
+			pool.GetStream(Stream::VELOCITY_Z)[i] = velocity.z;
+			pool.GetStream(Stream::AGE)[i] = 0.0f;
+			pool.GetStream(Stream::INV_LIFETIME)[i] = 1.0f / lifetime;
+		}
+	}
+
+	TEST_CASE("Particles", "[particles]")
+	{
+		using namespace Rendering::Particles;
+		using Stream = ParticlePool::Stream;
+
+		SECTION("Integrate")
+		{
+			//Count not a multiple of 4 so the padding lanes are covered
+			ParticlePool pool;
+			pool.Reserve(10);
+			glm::vec3 velocity{ 1.0f, 5.0f, -2.0f };
+			glm::vec3 acceleration{ 0.0f, -9.8f, 0.5f };
+			SpawnParticles(pool, 10, glm::vec3(1.0f, 2.0f, 3.0f), velocity, 10.0f);
+			REQUIRE(pool.GetCount() == 10);
+
+			const int steps = 30;
+			const float dt = 1.0f / 60.0f;
+			for (int i = 0; i < steps; ++i)
+			{
+				ParticleKernels::Integrate(pool, 0, pool.GetCount(), acceleration, 0.0f, dt);
+			}
+
+			//Explicit Euler: the velocity is updated before the position
+			float k = static_cast<float>(steps);
+			glm::vec3 expected = glm::vec3(1.0f, 2.0f, 3.0f) + velocity * (k * dt)
+				+ acceleration * (dt * dt * k * (k + 1.0f) * 0.5f);
+			for (size_t i = 0; i < pool.GetCount(); ++i)
+			{
+				REQUIRE(pool.GetStream(Stream::POSITION_X)[i] == Approx(expected.x).margin(1e-4f));
+				REQUIRE(pool.GetStream(Stream::POSITION_Y)[i] == Approx(expected.y).margin(1e-4f));
+				REQUIRE(pool.GetStream(Stream::POSITION_Z)[i] == Approx(expected.z).margin(1e-4f));
+				REQUIRE(pool.GetStream(Stream::VELOCITY_Y)[i] == Approx(velocity.y + acceleration.y * k * dt).margin(1e-4f));
+				REQUIRE(pool.GetStream(Stream::AGE)[i] == Approx(k * dt).margin(1e-5f));
+			}
+
+			//Drag only slow particles down
+			ParticleKernels::Integrate(pool, 0, pool.GetCount(), glm::vec3(0.0f), 100.0f, 1.0f);
+			REQUIRE(pool.GetStream(Stream::VELOCITY_X)[0] == 0.0f);
+		}
+
+		SECTION("CollidePlanes")
+		{
+			ParticlePool pool;
+			pool.Reserve(8);
+			SpawnParticles(pool, 3, glm::vec3(0.0f, -0.5f, 0.0f), glm::vec3(1.0f, -2.0f, 0.0f), 10.0f);
+			SpawnParticles(pool, 3, glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, -2.0f, 0.0f), 10.0f);
+
+			ParticlePlane ground{ glm::vec3(0.0f, 1.0f, 0.0f), 0.0f };
+			ParticleKernels::CollidePlanes(pool, 0, pool.GetCount(), &ground, 1, 0.5f);
+			for (size_t i = 0; i < 3; ++i)
+			{
+				//Pushed onto the plane, bounced at half the speed, tangent speed kept
+				REQUIRE(pool.GetStream(Stream::POSITION_Y)[i] == Approx(0.0f).margin(1e-6f));
+				REQUIRE(pool.GetStream(Stream::VELOCITY_Y)[i] == Approx(1.0f));
+				REQUIRE(pool.GetStream(Stream::VELOCITY_X)[i] == Approx(1.0f));
+			}
+			for (size_t i = 3; i < 6; ++i)
+			{
+				REQUIRE(pool.GetStream(Stream::POSITION_Y)[i] == 1.0f);
+				REQUIRE(pool.GetStream(Stream::VELOCITY_Y)[i] == -2.0f);
+			}
+
+			//Falling for a while never end below the plane
+			for (int i = 0; i < 200; ++i)
+			{
+				ParticleKernels::Integrate(pool, 0, pool.GetCount(), glm::vec3(0.0f, -9.8f, 0.0f), 0.0f, 1.0f / 60.0f);
+				ParticleKernels::CollidePlanes(pool, 0, pool.GetCount(), &ground, 1, 0.5f);
+			}
+			for (size_t i = 0; i < pool.GetCount(); ++i)
+			{
+				REQUIRE(pool.GetStream(Stream::POSITION_Y)[i] >= 0.0f);
+			}
+		}
+
+		SECTION("Avx2_Matches_Sse2")
+		{
+			//Same operations in the same order, the AVX2 kernels must match bit for bit
+			ParticlePool pools[2];
+			for (auto& pool : pools)
+			{
+				pool.Reserve(1021);
+				for (size_t i = 0; i < 1021; ++i)
+				{
+					float x = static_cast<float>(i);
+					SpawnParticles(pool, 1, glm::vec3(std::sin(x), std::cos(x) * 2.0f, x * 0.01f)
+						, glm::vec3(std::cos(x * 3.0f), -std::sin(x), 1.0f), 10.0f);
+				}
+			}
+
+			ParticlePlane planes[2]{ { glm::vec3(0.0f, 1.0f, 0.0f), 0.5f }
+				, { glm::vec3(0.6f, 0.0f, 0.8f), 1.0f } };
+			for (int avx2 = 0; avx2 < 2; ++avx2)
+			{
+				CpuFeatures::SetAvx2Enabled(avx2 == 1);
+				for (int step = 0; step < 60; ++step)
+				{
+					//Split on a block of 4 that isn't one of 8, both paths get a 4 wide tail
+					ParticleKernels::Integrate(pools[avx2], 0, 500, glm::vec3(0.0f, -9.8f, 0.0f), 0.2f, 1.0f / 60.0f);
+					ParticleKernels::Integrate(pools[avx2], 500, 1021, glm::vec3(0.0f, -9.8f, 0.0f), 0.2f, 1.0f / 60.0f);
+					ParticleKernels::CollidePlanes(pools[avx2], 0, 1021, planes, 2, 0.5f);
+				}
+			}
+			CpuFeatures::SetAvx2Enabled(true);
+
+			for (size_t stream = 0; stream < static_cast<size_t>(Stream::COUNT); ++stream)
+			{
+				REQUIRE(std::memcmp(pools[0].GetStream(Stream(stream)), pools[1].GetStream(Stream(stream))
+					, 1021 * sizeof(float)) == 0);
+			}
+		}
+
+		SECTION("KillExpired")
+		{
+			ParticlePool pool;
+			pool.Reserve(100);
+			for (size_t i = 0; i < 100; ++i)
+			{
+				//Every third particle is short lived
+				SpawnParticles(pool, 1, glm::vec3(static_cast<float>(i)), glm::vec3(0.0f)
+					, i % 3 == 0 ? 0.5f : 2.0f);
+			}
+
+			REQUIRE(ParticleKernels::KillExpired(pool) == 0);
+			ParticleKernels::Integrate(pool, 0, pool.GetCount(), glm::vec3(0.0f), 0.0f, 1.0f);
+			REQUIRE(ParticleKernels::KillExpired(pool) == 34);
+			REQUIRE(pool.GetCount() == 66);
+
+			//Survivors are packed at the front and none of the dead are left
+			Vector<bool> found(100, false);
+			for (size_t i = 0; i < pool.GetCount(); ++i)
+			{
+				size_t id = static_cast<size_t>(pool.GetStream(Stream::POSITION_X)[i]);
+				REQUIRE(id % 3 != 0);
+				REQUIRE_FALSE(found[id]);
+				found[id] = true;
+			}
+
+			ParticleKernels::Integrate(pool, 0, pool.GetCount(), glm::vec3(0.0f), 0.0f, 1.5f);
+			REQUIRE(ParticleKernels::KillExpired(pool) == 66);
+			REQUIRE(pool.GetCount() == 0);
+		}
+
+		SECTION("Emitter")
+		{
+			EmitterSettings settings;
+			settings.m_rate = 1000.0f;
+			settings.m_lifetimeMin = 0.5f;
+			settings.m_lifetimeMax = 0.5f;
+			settings.m_maxParticles = 300;
+
+			Emitter emitter;
+			emitter.Initialize(settings, 3);
+			emitter.AddPlane(ParticlePlane{ glm::vec3(0.0f, 1.0f, 0.0f), 0.0f });
+
+			//Spawning is carried over between frames, capped by the pool
+			emitter.Update(0.1005f);
+			REQUIRE(emitter.GetParticleCount() == 100);
+			emitter.Update(0.1f);
+			REQUIRE(emitter.GetParticleCount() == 200);
+			emitter.Update(0.25f);
+			REQUIRE(emitter.GetParticleCount() == 300);
+
+			//While the pool is full the spawns are dropped
+			emitter.Update(0.2f);
+			REQUIRE(emitter.GetParticleCount() == 300);
+			emitter.Burst(10);
+			REQUIRE(emitter.GetParticleCount() == 300);
+
+			//The expired ones are removed on the next emit
+			emitter.Update(0.0f);
+			REQUIRE(emitter.GetParticleCount() == 100);
+
+			//Back to front along the camera, size and color follow the age
+			glm::vec3 cameraPosition{ 0.0f, 1.0f, -10.0f };
+			glm::vec3 cameraForward{ 0.0f, 0.0f, 1.0f };
+			Vector<ParticleInstance> instances(emitter.GetParticleCount());
+			REQUIRE(emitter.WriteInstances(cameraPosition, cameraForward, instances.data()) == instances.size());
+			for (size_t i = 1; i < instances.size(); ++i)
+			{
+				REQUIRE(instances[i - 1].m_positionSize.z >= instances[i].m_positionSize.z);
+			}
+			for (auto& instance : instances)
+			{
+				REQUIRE(instance.m_positionSize.y >= 0.0f);
+				REQUIRE(instance.m_positionSize.w <= settings.m_startSize);
+				REQUIRE(instance.m_color.a <= 1.0f);
+			}
+		}
+
+		SECTION("Benchmark")
+		{
+			//A million particles across 16 emitters, bouncing on the ground
+			const size_t emitterCount = 16;
+			const size_t particlesPerEmitter = 65536;
+			EmitterSettings settings;
+			settings.m_rate = 0.0f;
+			settings.m_lifetimeMin = 1000.0f;
+			settings.m_lifetimeMax = 1000.0f;
+			settings.m_velocitySpread = 4.0f;
+			settings.m_drag = 0.1f;
+			settings.m_maxParticles = particlesPerEmitter;
+
+			Vector<Emitter> emitters(emitterCount);
+			Vector<Emitter*> emitterPointers;
+			for (size_t i = 0; i < emitterCount; ++i)
+			{
+				emitters[i].Initialize(settings, static_cast<U32>(i + 1));
+				emitters[i].SetPosition(glm::vec3(static_cast<float>(i % 4) * 10.0f, 2.0f
+					, static_cast<float>(i / 4) * 10.0f));
+				emitters[i].AddPlane(ParticlePlane{ glm::vec3(0.0f, 1.0f, 0.0f), 0.0f });
+				emitters[i].Burst(particlesPerEmitter);
+				emitterPointers.emplace_back(&emitters[i]);
+			}
+			REQUIRE(ParticleSystem::GetParticleCount(emitterPointers) == emitterCount * particlesPerEmitter);
+			Vector<ParticleInstance> instances(emitterCount * particlesPerEmitter);
+
+			unsigned initialWorkers = JobSystem::GetWorkerCount();
+			unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			Vector<unsigned> workerCounts{ 0 };
+			for (unsigned workers = 1; workers < hardwareThreads; workers = workers * 2 + 1)
+			{
+				workerCounts.emplace_back(workers);
+			}
+			if (workerCounts.back() != hardwareThreads - 1)
+			{
+				workerCounts.emplace_back(hardwareThreads - 1);
+			}
+
+			for (unsigned workers : workerCounts)
+			{
+				JobSystem::Terminate();
+				if (workers > 0)
+				{
+					JobSystem::Initialize(workers);
+				}
+
+				const int frames = 10;
+				StopWatch simulateWatch{ true };
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					ParticleSystem::UpdateEmitters(emitterPointers, 1.0f / 60.0f);
+				}
+				simulateWatch.Stop();
+
+				StopWatch writeWatch{ true };
+				size_t written = 0;
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					written = ParticleSystem::WriteInstances(emitterPointers, glm::vec3(15.0f, 5.0f, -20.0f)
+						, glm::vec3(0.0f, 0.0f, 1.0f), instances.data());
+				}
+				writeWatch.Stop();
+
+				REQUIRE(written == instances.size());
+				Debug::Log << Logger::MessageType::INFO << "ParticleSystem " << (workers + 1)
+					<< " threads: simulate " << simulateWatch.GetElapsedTimeMilli() / frames
+					<< " ms/frame, sort and write " << writeWatch.GetElapsedTimeMilli() / frames
+					<< " ms/frame, " << written << " particles\n";
+			}
+
+			JobSystem::Terminate();
+			if (initialWorkers > 0)
+			{
+				JobSystem::Initialize(initialWorkers);
+			}
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: SpatialIndex
+  //*****************************************************
+	//! @brief Handle standing for GameObject index, the index only use it as a key
+	static Handle<GameObject> MakeSpatialHandle(size_t index)
+	{
+		return Handle<GameObject>(HandleObject(SlotmapID(index, 1), nullptr, nullptr));
+	}
+
+	//! @brief Slot indices of the handles, sorted to compare against a brute force
+	static Vector<int> GetSortedSlots(const Vector<Handle<GameObject>>& handles)
+	{
+		Vector<int> slots;
+		for (auto& handle : handles)
+		{
+			slots.emplace_back(handle.GetSlotMapID());
+		}
+		std::sort(slots.begin(), slots.end());
+		return slots;
+	}
+
+	TEST_CASE("SpatialIndex", "[spatialindex]")
+	{
+		//Objects spread in a 200m cube with a few big ones, and some outside the octree world
+		const size_t objectCount = 2000;
+		std::mt19937 random(42);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> size(0.1f, 2.0f);
+		Vector<glm::vec3> positions(objectCount);
+		Vector<float> radii(objectCount);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			positions[i] = glm::vec3(position(random), position(random), position(random));
+			radii[i] = i % 100 == 0 ? 20.0f : size(random);
+		}
+		positions[7] = glm::vec3(500.0f, 0.0f, 0.0f);
+
+		SpatialIndexSettings settings;
+		settings.m_cellSize = 8.0f;
+		settings.m_worldHalfSize = 256.0f;
+		SpatialIndexType types[] = { SpatialIndexType::HASHED_GRID, SpatialIndexType::LOOSE_OCTREE };
+
+		SECTION("Queries")
+		{
+			for (auto type : types)
+			{
+				settings.m_type = type;
+				SpatialIndex index{ settings };
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					index.Insert(MakeSpatialHandle(i), positions[i], radii[i]);
+				}
+				REQUIRE(index.GetCount() == objectCount);
+				REQUIRE(index.Contains(MakeSpatialHandle(3)));
+				REQUIRE(!index.Contains(MakeSpatialHandle(objectCount)));
+
+				for (int q = 0; q < 50; ++q)
+				{
+					glm::vec3 center{ position(random), position(random), position(random) };
+					if (q == 0)
+					{
+						center = glm::vec3(490.0f, 0.0f, 0.0f);
+					}
+
+					//Radius, spheres touching the query sphere
+					float radius = 5.0f + static_cast<float>(q);
+					Vector<int> expected;
+					for (size_t i = 0; i < objectCount; ++i)
+					{
+						if (glm::length(positions[i] - center) <= radius + radii[i])
+						{
+							expected.emplace_back(static_cast<int>(i));
+						}
+					}
+					Vector<Handle<GameObject>> result;
+					index.QueryRadius(RadiusQuery{ center, radius }, result);
+					REQUIRE(GetSortedSlots(result) == expected);
+
+					//Box, spheres touching the box
+					SpatialBox box{ center - glm::vec3(radius, 4.0f, radius * 0.5f)
+						, center + glm::vec3(radius * 0.5f, 4.0f, radius) };
+					expected.clear();
+					for (size_t i = 0; i < objectCount; ++i)
+					{
+						glm::vec3 closest = glm::clamp(positions[i], box.m_min, box.m_max);
+						if (glm::length(positions[i] - closest) <= radii[i])
+						{
+							expected.emplace_back(static_cast<int>(i));
+						}
+					}
+					result.clear();
+					index.QueryBox(box, result);
+					REQUIRE(GetSortedSlots(result) == expected);
+
+					//Nearest, ordered by the distance of the positions
+					Vector<std::pair<float, int>> distances;
+					for (size_t i = 0; i < objectCount; ++i)
+					{
+						distances.emplace_back(glm::length(positions[i] - center), static_cast<int>(i));
+					}
+					std::sort(distances.begin(), distances.end());
+					result.clear();
+					index.QueryNearest(NearestQuery{ center, 10, FLT_MAX }, result);
+					REQUIRE(result.size() == 10);
+					for (size_t i = 0; i < result.size(); ++i)
+					{
+						REQUIRE(result[i].GetSlotMapID() == distances[i].second);
+					}
+
+					//Nearest within a distance get fewer
+					result.clear();
+					index.QueryNearest(NearestQuery{ center, 10, (distances[2].first + distances[3].first) * 0.5f }, result);
+					REQUIRE(result.size() == 3);
+				}
+
+				//Frustum of a camera looking down the cube
+				glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, -150.0f), glm::vec3(10.0f, 0.0f, 0.0f)
+					, glm::vec3(0.0f, 1.0f, 0.0f));
+				glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 200.0f);
+				SpatialFrustum frustum = SpatialFrustum::FromMatrix(projection * view);
+				Vector<int> expected;
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					glm::vec3 closest = glm::clamp(positions[i], frustum.m_bounds.m_min, frustum.m_bounds.m_max);
+					bool inside = glm::length(positions[i] - closest) <= radii[i];
+					for (auto& plane : frustum.m_planes)
+					{
+						inside = inside && glm::dot(glm::vec3(plane), positions[i]) + plane.w >= -radii[i];
+					}
+					if (inside)
+					{
+						expected.emplace_back(static_cast<int>(i));
+					}
+				}
+				Vector<Handle<GameObject>> result;
+				index.QueryFrustum(frustum, result);
+				REQUIRE(expected.size() > 0);
+				REQUIRE(GetSortedSlots(result) == expected);
+			}
+		}
+
+		SECTION("Batched")
+		{
+			for (auto type : types)
+			{
+				settings.m_type = type;
+				SpatialIndex index{ settings };
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					index.Insert(MakeSpatialHandle(i), positions[i], radii[i]);
+				}
+
+				Vector<RadiusQuery> radiusQueries;
+				Vector<NearestQuery> nearestQueries;
+				Vector<SpatialBox> boxes;
+				for (int q = 0; q < 200; ++q)
+				{
+					glm::vec3 center{ position(random), position(random), position(random) };
+					radiusQueries.emplace_back(RadiusQuery{ center, 10.0f });
+					nearestQueries.emplace_back(NearestQuery{ center, 4, FLT_MAX });
+					boxes.emplace_back(SpatialBox{ center - glm::vec3(6.0f), center + glm::vec3(6.0f) });
+				}
+
+				//Every batched list match the single query
+				SpatialQueryResults results;
+				index.QueryRadius(radiusQueries.data(), radiusQueries.size(), results);
+				REQUIRE(results.size() == radiusQueries.size());
+				for (size_t q = 0; q < radiusQueries.size(); ++q)
+				{
+					Vector<Handle<GameObject>> single;
+					index.QueryRadius(radiusQueries[q], single);
+					REQUIRE(GetSortedSlots(results[q]) == GetSortedSlots(single));
+				}
+
+				index.QueryNearest(nearestQueries.data(), nearestQueries.size(), results);
+				for (size_t q = 0; q < nearestQueries.size(); ++q)
+				{
+					Vector<Handle<GameObject>> single;
+					index.QueryNearest(nearestQueries[q], single);
+					REQUIRE(results[q].size() == 4);
+					REQUIRE(GetSortedSlots(results[q]) == GetSortedSlots(single));
+				}
+
+				index.QueryBox(boxes.data(), boxes.size(), results);
+				for (size_t q = 0; q < boxes.size(); ++q)
+				{
+					Vector<Handle<GameObject>> single;
+					index.QueryBox(boxes[q], single);
+					REQUIRE(GetSortedSlots(results[q]) == GetSortedSlots(single));
+				}
+
+				//Lists are replaced, not appended to
+				index.QueryBox(boxes.data(), 1, results);
+				REQUIRE(results.size() == 1);
+			}
+		}
+
+		SECTION("Move_Remove")
+		{
+			for (auto type : types)
+			{
+				settings.m_type = type;
+				SpatialIndex index{ settings };
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					index.Insert(MakeSpatialHandle(i), positions[i], radii[i]);
+				}
+
+				//Move the even ones far away, remove every third one
+				for (size_t i = 0; i < objectCount; i += 2)
+				{
+					positions[i] += glm::vec3(37.0f, -11.0f, 5.0f);
+					index.Insert(MakeSpatialHandle(i), positions[i], radii[i]);
+				}
+				size_t removed = 0;
+				for (size_t i = 0; i < objectCount; i += 3)
+				{
+					REQUIRE(index.Remove(MakeSpatialHandle(i)));
+					REQUIRE(!index.Remove(MakeSpatialHandle(i)));
+					++removed;
+				}
+				REQUIRE(index.GetCount() == objectCount - removed);
+
+				Vector<int> expected;
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					if (i % 3 != 0 && glm::length(positions[i] - glm::vec3(10.0f)) <= 40.0f + radii[i])
+					{
+						expected.emplace_back(static_cast<int>(i));
+					}
+				}
+				Vector<Handle<GameObject>> result;
+				index.QueryRadius(RadiusQuery{ glm::vec3(10.0f), 40.0f }, result);
+				REQUIRE(GetSortedSlots(result) == expected);
+
+				//A reused slot replace the destroyed GameObject
+				Handle<GameObject> reused{ HandleObject(SlotmapID(1, 2), nullptr, nullptr) };
+				index.Insert(reused, glm::vec3(0.0f), 1.0f);
+				REQUIRE(index.Contains(reused));
+				REQUIRE(!index.Contains(MakeSpatialHandle(1)));
+				REQUIRE(index.GetCount() == objectCount - removed);
+
+				index.Clear();
+				REQUIRE(index.GetCount() == 0);
+				REQUIRE(index.GetBucketCount() == 0);
+				result.clear();
+				index.QueryRadius(RadiusQuery{ glm::vec3(0.0f), 1000.0f }, result);
+				REQUIRE(result.empty());
+
+			}
+		}
+
+		SECTION("Scene")
+		{
+			//Leftover moves of the other tests
+			Vector<Handle<GameObject>> moved;
+			Components::Transform::TakeMovedGameObjects(moved);
+
+			Scene scene;
+			for (int i = 0; i < 8; ++i)
+			{
+				auto g = GameObject::Create("Prop", 1);
+				g->GetTransform()->SetPosition(glm::vec3(static_cast<float>(i) * 10.0f, 0.0f, 0.0f));
+				scene.AddGameObject(g);
+			}
+			REQUIRE(scene.GetSpatialIndex() == nullptr);
+
+			SpatialIndexSettings sceneSettings;
+			sceneSettings.m_cellSize = 4.0f;
+			scene.EnableSpatialIndex(sceneSettings);
+			REQUIRE(scene.GetSpatialIndex()->GetCount() == 8);
+
+			//Each moved Transform is listed once until taken
+			auto gameObjects = scene.GetAllGameObjects();
+			Handle<GameObject> mover = gameObjects[2];
+			mover->GetTransform()->SetPosition(glm::vec3(72.0f, 0.0f, 0.0f));
+			mover->GetTransform()->SetScale(glm::vec3(2.0f));
+			REQUIRE(mover->GetTransform()->IsDirty());
+			Components::Transform::TakeMovedGameObjects(moved);
+			REQUIRE(moved.size() == 1);
+			REQUIRE(!mover->GetTransform()->IsDirty());
+			scene.SyncSpatialIndex(moved);
+
+			Vector<Handle<GameObject>> result;
+			scene.GetSpatialIndex()->QueryRadius(RadiusQuery{ glm::vec3(20.0f, 0.0f, 0.0f), 1.0f }, result);
+			REQUIRE(result.empty());
+			scene.GetSpatialIndex()->QueryNearest(NearestQuery{ glm::vec3(73.0f, 0.0f, 0.0f), 2, FLT_MAX }, result);
+			REQUIRE(result.size() == 2);
+			REQUIRE(result[0].m_handle == mover.m_handle);
+			REQUIRE(result[1].m_handle == gameObjects[7].m_handle);
+
+			//Added and removed GameObjects follow the scene
+			auto added = GameObject::Create("Prop", 1);
+			added->GetTransform()->SetPosition(glm::vec3(-30.0f, 0.0f, 0.0f));
+			scene.AddGameObject(added);
+			REQUIRE(scene.GetSpatialIndex()->Contains(added));
+			scene.RemoveGameObject(gameObjects[0]);
+			REQUIRE(scene.GetSpatialIndex()->GetCount() == 8);
+
+			//A replaced scene rebuild on the next sync
+			scene.InvalidateChanges();
+			gameObjects[1]->GetTransform()->SetPosition(glm::vec3(0.0f, 50.0f, 0.0f));
+			Components::Transform::TakeMovedGameObjects(moved);
+			scene.SyncSpatialIndex(moved);
+			result.clear();
+			scene.GetSpatialIndex()->QueryRadius(RadiusQuery{ glm::vec3(0.0f, 50.0f, 0.0f), 1.0f }, result);
+			REQUIRE(result.size() == 1);
+			REQUIRE(!scene.GetSpatialIndex()->Contains(gameObjects[0]));
+
+			scene.DisableSpatialIndex();
+			REQUIRE(scene.GetSpatialIndex() == nullptr);
+			for (auto g : gameObjects)
+			{
+				g->Destroy();
+			}
+			added->Destroy();
+			scene.Clear();
+		}
+
+		SECTION("Benchmark")
+		{
+			//100k objects wandering in a 1km square, all moving every frame
+			const size_t movingCount = 100000;
+			const size_t queryCount = 4096;
+			std::uniform_real_distribution<float> spread(-500.0f, 500.0f);
+			Vector<glm::vec3> moving(movingCount);
+			Vector<glm::vec3> velocities(movingCount);
+			for (size_t i = 0; i < movingCount; ++i)
+			{
+				moving[i] = glm::vec3(spread(random), spread(random) * 0.02f, spread(random));
+				velocities[i] = glm::vec3(spread(random), 0.0f, spread(random)) * 0.01f;
+			}
+			Vector<RadiusQuery> radiusQueries;
+			Vector<NearestQuery> nearestQueries;
+			for (size_t q = 0; q < queryCount; ++q)
+			{
+				glm::vec3 center{ spread(random), 0.0f, spread(random) };
+				radiusQueries.emplace_back(RadiusQuery{ center, 15.0f });
+				nearestQueries.emplace_back(NearestQuery{ center, 8, FLT_MAX });
+			}
+
+			unsigned initialWorkers = JobSystem::GetWorkerCount();
+			unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			Vector<unsigned> workerCounts{ 0 };
+			for (unsigned workers = 1; workers < hardwareThreads; workers = workers * 2 + 1)
+			{
+				workerCounts.emplace_back(workers);
+			}
+			if (workerCounts.back() != hardwareThreads - 1)
+			{
+				workerCounts.emplace_back(hardwareThreads - 1);
+			}
+
+			for (auto type : types)
+			{
+				SpatialIndexSettings benchmarkSettings;
+				benchmarkSettings.m_type = type;
+				benchmarkSettings.m_cellSize = 16.0f;
+				benchmarkSettings.m_worldHalfSize = 512.0f;
+				SpatialIndex index{ benchmarkSettings };
+				for (size_t i = 0; i < movingCount; ++i)
+				{
+					index.Insert(MakeSpatialHandle(i), moving[i], 0.5f);
+				}
+
+				//Moving is single threaded like the Transform sync, it run once
+				const int frames = 10;
+				StopWatch moveWatch{ true };
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					for (size_t i = 0; i < movingCount; ++i)
+					{
+						moving[i] += velocities[i];
+						velocities[i].x = std::abs(moving[i].x) > 500.0f ? -velocities[i].x : velocities[i].x;
+						velocities[i].z = std::abs(moving[i].z) > 500.0f ? -velocities[i].z : velocities[i].z;
+						index.Insert(MakeSpatialHandle(i), moving[i], 0.5f);
+					}
+				}
+				moveWatch.Stop();
+				REQUIRE(index.GetCount() == movingCount);
+
+				for (unsigned workers : workerCounts)
+				{
+					JobSystem::Terminate();
+					if (workers > 0)
+					{
+						JobSystem::Initialize(workers);
+					}
+
+					SpatialQueryResults results;
+					size_t found = 0;
+					StopWatch radiusWatch{ true };
+					for (int frame = 0; frame < frames; ++frame)
+					{
+						index.QueryRadius(radiusQueries.data(), queryCount, results);
+					}
+					radiusWatch.Stop();
+					for (auto& list : results)
+					{
+						found += list.size();
+					}
+
+					StopWatch nearestWatch{ true };
+					for (int frame = 0; frame < frames; ++frame)
+					{
+						index.QueryNearest(nearestQueries.data(), queryCount, results);
+					}
+					nearestWatch.Stop();
+					REQUIRE(results[0].size() == 8);
+
+					Debug::Log << Logger::MessageType::INFO << "SpatialIndex "
+						<< (type == SpatialIndexType::HASHED_GRID ? "grid " : "octree ") << (workers + 1)
+						<< " threads: move " << moveWatch.GetElapsedTimeMilli() / frames
+						<< " ms/frame, " << queryCount << " radius " << radiusWatch.GetElapsedTimeMilli() / frames
+						<< " ms/frame (" << found << " found), " << queryCount << " nearest "
+						<< nearestWatch.GetElapsedTimeMilli() / frames << " ms/frame, "
+						<< movingCount << " objects\n";
+				}
+			}
+
+			JobSystem::Terminate();
+			if (initialWorkers > 0)
+			{
+				JobSystem::Initialize(initialWorkers);
+			}
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: MaskedOcclusion
+  //*****************************************************
+	//! @brief Square of halfSize in the XY plane, facing +Z
+	static Rendering::Occlusion::OccluderMesh MakeQuadOccluder(float halfSize)
+	{
+		Rendering::Occlusion::OccluderMesh mesh;
+		mesh.m_positions = { glm::vec3(-halfSize, -halfSize, 0.0f), glm::vec3(halfSize, -halfSize, 0.0f)
+			, glm::vec3(halfSize, halfSize, 0.0f), glm::vec3(-halfSize, halfSize, 0.0f) };
+		mesh.m_indices = { 0, 1, 2, 0, 2, 3 };
+		return mesh;
+	}
+
+	//! @brief Nearest 1/w of the front faces at every pixel center, a little past the edges
+	// so any pixel the buffer cover is covered here too
+	static Vector<float> RasterizeOcclusionReference(const glm::mat4& viewProjection
+		, const Vector<Rendering::Occlusion::OccluderInstance>& occluders, int width, int height)
+	{
+		Vector<float> depth(static_cast<size_t>(width) * height, 0.0f);
+		for (auto& occluder : occluders)
+		{
+			glm::mat4 mvp = viewProjection * occluder.m_model;
+			auto& mesh = *occluder.m_mesh;
+			for (size_t i = 0; i < mesh.m_indices.size(); i += 3)
+			{
+				double x[3], y[3], z[3];
+				for (int v = 0; v < 3; ++v)
+				{
+					glm::vec4 clip = mvp * glm::vec4(mesh.m_positions[mesh.m_indices[i + v]], 1.0f);
+					z[v] = 1.0 / clip.w;
+					x[v] = (clip.x * z[v] * 0.5 + 0.5) * width;
+					y[v] = (clip.y * z[v] * 0.5 + 0.5) * height;
+				}
+				double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+				if (area <= 0.0)
+				{
+					continue;
+				}
+
+				for (int py = 0; py < height; ++py)
+				{
+					for (int px = 0; px < width; ++px)
+					{
+						double cx = px + 0.5, cy = py + 0.5;
+						double w0 = (x[2] - x[1]) * (cy - y[1]) - (y[2] - y[1]) * (cx - x[1]);
+						double w1 = (x[0] - x[2]) * (cy - y[2]) - (y[0] - y[2]) * (cx - x[2]);
+						double w2 = (x[1] - x[0]) * (cy - y[0]) - (y[1] - y[0]) * (cx - x[0]);
+						const double margin = -1e-3 * area;
+						if (w0 < margin || w1 < margin || w2 < margin)
+						{
+							continue;
+						}
+
+						double pixelDepth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) / area;
+						pixelDepth = std::min(std::max(pixelDepth, std::min({ z[0], z[1], z[2] }))
+							, std::max({ z[0], z[1], z[2] }));
+						float& stored = depth[static_cast<size_t>(py) * width + px];
+						stored = std::max(stored, static_cast<float>(pixelDepth));
+					}
+				}
+			}
+		}
+		return depth;
+	}
+
+	TEST_CASE("MaskedOcclusion", "[occlusion]")
+	{
+		using namespace Rendering::Occlusion;
+
+		//Camera at +Z looking down -Z
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f)
+			, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 200.0f);
+		glm::mat4 viewProjection = projection * view;
+
+		MaskedOcclusionBuffer buffer;
+		buffer.Resize(254, 126);
+		REQUIRE(buffer.GetWidth() == 256);
+		REQUIRE(buffer.GetHeight() == 128);
+
+		SECTION("Occluder")
+		{
+			OccluderMesh quad = MakeQuadOccluder(3.0f);
+			OccluderInstance instance{ &quad, glm::mat4(1.0f) };
+			buffer.RenderOccluders(viewProjection, &instance, 1);
+			REQUIRE(buffer.GetRasterizedTriangleCount() == 2);
+
+			//Behind the middle, in front, sticking out and beside
+			REQUIRE(!buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f) }));
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 2.0f) }));
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) }));
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-8.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f) }));
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(6.0f, -1.0f, -6.0f), glm::vec3(7.0f, 1.0f, -4.0f) }));
+
+			//Boxes through the near plane and off screen are never hidden
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, 20.0f) }));
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, 80.0f, -6.0f), glm::vec3(1.0f, 81.0f, -4.0f) }));
+
+			//Turned around, the quad is a back face
+			buffer.Clear();
+			instance.m_model = glm::rotate(glm::mat4(1.0f), glm::radians(180.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			buffer.RenderOccluders(viewProjection, &instance, 1);
+			REQUIRE(buffer.GetRasterizedTriangleCount() == 0);
+			REQUIRE(buffer.IsVisible(viewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, -6.0f), glm::vec3(1.0f, 1.0f, -4.0f) }));
+		}
+
+		SECTION("Near_Plane")
+		{
+			//Ground reaching behind the camera, seen from above
+			OccluderMesh ground = MakeQuadOccluder(1000.0f);
+			glm::mat4 groundModel = glm::rotate(glm::mat4(1.0f), glm::radians(-90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+			OccluderInstance instance{ &ground, groundModel };
+			glm::mat4 aboveView = glm::lookAt(glm::vec3(0.0f, 2.0f, 10.0f), glm::vec3(0.0f, 0.0f, -10.0f)
+				, glm::vec3(0.0f, 1.0f, 0.0f));
+			glm::mat4 aboveViewProjection = projection * aboveView;
+			buffer.RenderOccluders(aboveViewProjection, &instance, 1);
+			REQUIRE(buffer.GetRasterizedTriangleCount() >= 2);
+
+			REQUIRE(!buffer.IsVisible(aboveViewProjection, OcclusionBox{ glm::vec3(-1.0f, -4.0f, -21.0f), glm::vec3(1.0f, -2.0f, -19.0f) }));
+			REQUIRE(buffer.IsVisible(aboveViewProjection, OcclusionBox{ glm::vec3(-1.0f, 0.5f, -21.0f), glm::vec3(1.0f, 1.5f, -19.0f) }));
+			REQUIRE(buffer.IsVisible(aboveViewProjection, OcclusionBox{ glm::vec3(-1.0f, -1.0f, -21.0f), glm::vec3(1.0f, 0.5f, -19.0f) }));
+		}
+
+		SECTION("Conservative")
+		{
+			//Overlapping quads at random depths and angles, all in front of the near plane
+			std::mt19937 random(7);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			OccluderMesh quad = MakeQuadOccluder(1.5f);
+			Vector<OccluderInstance> occluders;
+			for (int i = 0; i < 60; ++i)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(unit(random) * 12.0f
+					, unit(random) * 6.0f, -10.0f + unit(random) * 8.0f));
+				model = glm::rotate(model, unit(random) * 1.2f, glm::normalize(glm::vec3(unit(random), unit(random), 0.2f)));
+				occluders.emplace_back(OccluderInstance{ &quad, model });
+			}
+			buffer.RenderOccluders(viewProjection, occluders.data(), occluders.size());
+
+			//The buffer is never nearer than the front faces
+			Vector<float> reference = RasterizeOcclusionReference(viewProjection, occluders
+				, buffer.GetWidth(), buffer.GetHeight());
+			size_t covered = 0;
+			for (int y = 0; y < buffer.GetHeight(); ++y)
+			{
+				for (int x = 0; x < buffer.GetWidth(); ++x)
+				{
+					float depth = buffer.GetPixelDepth(x, y);
+					REQUIRE(depth <= reference[static_cast<size_t>(y) * buffer.GetWidth() + x] * 1.0001f);
+					covered += depth > 0.0f ? 1 : 0;
+				}
+			}
+			REQUIRE(covered > reference.size() / 4);
+
+			//So hidden boxes are behind the occluders at every pixel they touch
+			size_t hidden = 0;
+			for (int i = 0; i < 2000; ++i)
+			{
+				glm::vec3 center{ unit(random) * 15.0f, unit(random) * 7.0f, -25.0f + unit(random) * 10.0f };
+				glm::vec3 extent = glm::abs(glm::vec3(unit(random), unit(random), unit(random))) * 1.5f + 0.05f;
+				OcclusionBox box{ center - extent, center + extent };
+				if (buffer.IsVisible(viewProjection, box))
+				{
+					continue;
+				}
+
+				++hidden;
+				float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, nearest = 0.0f;
+				for (int c = 0; c < 8; ++c)
+				{
+					glm::vec4 clip = viewProjection * glm::vec4((c & 1) ? box.m_max.x : box.m_min.x
+						, (c & 2) ? box.m_max.y : box.m_min.y, (c & 4) ? box.m_max.z : box.m_min.z, 1.0f);
+					float x = (clip.x / clip.w * 0.5f + 0.5f) * buffer.GetWidth();
+					float y = (clip.y / clip.w * 0.5f + 0.5f) * buffer.GetHeight();
+					minX = std::min(minX, x);
+					maxX = std::max(maxX, x);
+					minY = std::min(minY, y);
+					maxY = std::max(maxY, y);
+					nearest = std::max(nearest, 1.0f / clip.w);
+				}
+				for (int y = std::max(0, (int)minY); y <= std::min(buffer.GetHeight() - 1, (int)maxY); ++y)
+				{
+					for (int x = std::max(0, (int)minX); x <= std::min(buffer.GetWidth() - 1, (int)maxX); ++x)
+					{
+						REQUIRE(nearest < reference[static_cast<size_t>(y) * buffer.GetWidth() + x]);
+					}
+				}
+			}
+			REQUIRE(hidden > 100);
+		}
+
+		SECTION("Avx2_Matches_Sse2")
+		{
+			//Small and screen sized triangles, partial tiles in both coverage paths
+			std::mt19937 random(11);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			OccluderMesh quads[2]{ MakeQuadOccluder(0.4f), MakeQuadOccluder(4.0f) };
+			Vector<OccluderInstance> occluders;
+			for (int i = 0; i < 80; ++i)
+			{
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(unit(random) * 14.0f
+					, unit(random) * 7.0f, -10.0f + unit(random) * 8.0f));
+				model = glm::rotate(model, unit(random) * 1.2f, glm::normalize(glm::vec3(unit(random), unit(random), 0.2f)));
+				occluders.emplace_back(OccluderInstance{ &quads[i % 2], model });
+			}
+
+			Vector<OcclusionBox> boxes;
+			for (int i = 0; i < 500; ++i)
+			{
+				glm::vec3 center{ unit(random) * 15.0f, unit(random) * 7.0f, -25.0f + unit(random) * 10.0f };
+				glm::vec3 extent = glm::abs(glm::vec3(unit(random), unit(random), unit(random))) * 1.5f + 0.05f;
+				boxes.emplace_back(OcclusionBox{ center - extent, center + extent });
+			}
+
+			//Same operations in the same order, the depths must match bit for bit
+			Vector<float> depths[2];
+			Vector<U8> visible[2];
+			for (int avx2 = 0; avx2 < 2; ++avx2)
+			{
+				CpuFeatures::SetAvx2Enabled(avx2 == 1);
+				buffer.Clear();
+				buffer.RenderOccluders(viewProjection, occluders.data(), occluders.size());
+				for (int y = 0; y < buffer.GetHeight(); ++y)
+				{
+					for (int x = 0; x < buffer.GetWidth(); ++x)
+					{
+						depths[avx2].emplace_back(buffer.GetPixelDepth(x, y));
+					}
+				}
+				visible[avx2].resize(boxes.size());
+				buffer.TestBoxes(viewProjection, boxes.data(), boxes.size(), visible[avx2].data());
+			}
+			CpuFeatures::SetAvx2Enabled(true);
+
+			REQUIRE(std::memcmp(depths[0].data(), depths[1].data(), depths[0].size() * sizeof(float)) == 0);
+			REQUIRE(visible[0] == visible[1]);
+		}
+
+		SECTION("Benchmark")
+		{
+			//Rows of finely tessellated walls in front of a field of boxes, like the
+			//pillars and arches of an interior
+			const int wallCount = 24;
+			const int wallQuads = 48;
+			OccluderMesh wall;
+			for (int y = 0; y <= wallQuads; ++y)
+			{
+				for (int x = 0; x <= wallQuads; ++x)
+				{
+					wall.m_positions.emplace_back(static_cast<float>(x) / wallQuads * 4.0f - 2.0f
+						, static_cast<float>(y) / wallQuads * 4.0f - 2.0f, 0.0f);
+				}
+			}
+			for (int y = 0; y < wallQuads; ++y)
+			{
+				for (int x = 0; x < wallQuads; ++x)
+				{
+					U32 i = static_cast<U32>(y * (wallQuads + 1) + x);
+					U32 row = static_cast<U32>(wallQuads + 1);
+					wall.m_indices.insert(wall.m_indices.end(), { i, i + 1, i + row + 1, i, i + row + 1, i + row });
+				}
+			}
+
+			Vector<OccluderInstance> occluders;
+			for (int i = 0; i < wallCount; ++i)
+			{
+				occluders.emplace_back(OccluderInstance{ &wall, glm::translate(glm::mat4(1.0f)
+					, glm::vec3(static_cast<float>(i % 8) * 4.5f - 16.0f, static_cast<float>(i / 8) * 4.5f - 4.5f, -5.0f)) });
+			}
+
+			std::mt19937 random(3);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			const size_t boxCount = 20000;
+			Vector<OcclusionBox> boxes;
+			for (size_t i = 0; i < boxCount; ++i)
+			{
+				glm::vec3 center{ unit(random) * 40.0f, unit(random) * 12.0f, -40.0f + unit(random) * 30.0f };
+				boxes.emplace_back(OcclusionBox{ center - glm::vec3(0.5f), center + glm::vec3(0.5f) });
+			}
+			Vector<U8> visible(boxCount);
+			Vector<U8> firstVisible;
+
+			buffer.Resize(320, 160);
+			unsigned initialWorkers = JobSystem::GetWorkerCount();
+			unsigned hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+			Vector<unsigned> workerCounts{ 0 };
+			for (unsigned workers = 1; workers < hardwareThreads; workers = workers * 2 + 1)
+			{
+				workerCounts.emplace_back(workers);
+			}
+			if (workerCounts.back() != hardwareThreads - 1)
+			{
+				workerCounts.emplace_back(hardwareThreads - 1);
+			}
+
+			for (unsigned workers : workerCounts)
+			{
+				JobSystem::Terminate();
+				if (workers > 0)
+				{
+					JobSystem::Initialize(workers);
+				}
+
+				const int frames = 10;
+				StopWatch renderWatch{ true };
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					buffer.Clear();
+					buffer.RenderOccluders(viewProjection, occluders.data(), occluders.size());
+				}
+				renderWatch.Stop();
+
+				StopWatch testWatch{ true };
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					buffer.TestBoxes(viewProjection, boxes.data(), boxCount, visible.data());
+				}
+				testWatch.Stop();
+
+				//Binning keep the result the same whatever the worker count
+				if (firstVisible.empty())
+				{
+					firstVisible = visible;
+				}
+				REQUIRE(visible == firstVisible);
+
+				size_t hidden = std::count(visible.begin(), visible.end(), U8(0));
+				REQUIRE(hidden > 0);
+				Debug::Log << Logger::MessageType::INFO << "MaskedOcclusion " << (workers + 1)
+					<< " threads: render " << renderWatch.GetElapsedTimeMilli() / frames << " ms/frame ("
+					<< buffer.GetRasterizedTriangleCount() << " triangles), test "
+					<< testWatch.GetElapsedTimeMilli() / frames << " ms/frame, " << hidden << "/"
+					<< boxCount << " boxes hidden\n";
+			}
+
+			JobSystem::Terminate();
+			if (initialWorkers > 0)
+			{
+				JobSystem::Initialize(initialWorkers);
+			}
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: VertexFormat
+  //*****************************************************
+	//! @brief Random vertices like an imported mesh, unit normals and tangents
+	static std::vector<Rendering::Opengl::Vertex> MakeRandomVertices(size_t count, float size
+		, float texCoordRange, unsigned seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		auto randomDirection = [&]()
+		{
+			glm::vec3 direction{ unit(random), unit(random), unit(random) };
+			return glm::length(direction) > 1e-3f ? glm::normalize(direction) : glm::vec3(0.0f, 1.0f, 0.0f);
+		};
+
+		std::vector<Rendering::Opengl::Vertex> vertices(count);
+		for (auto& vertex : vertices)
+		{
+			vertex.m_position = glm::vec3(unit(random), unit(random), unit(random)) * size * 0.5f;
+			vertex.m_normal = randomDirection();
+			vertex.m_texCoord = (glm::vec2(unit(random), unit(random)) * 0.5f + 0.5f) * texCoordRange;
+			vertex.m_tangent = randomDirection();
+		}
+		return vertices;
+	}
+
+	//! @brief Angle between two directions, atan2 keep the precision of small angles unlike acos
+	static float AngleDegrees(const glm::vec3& lhs, const glm::vec3& rhs)
+	{
+		glm::dvec3 a{ lhs };
+		glm::dvec3 b{ rhs };
+		return static_cast<float>(glm::degrees(std::atan2(glm::length(glm::cross(a, b)), glm::dot(a, b))));
+	}
+
+	TEST_CASE("VertexFormat", "[vertexformat]")
+	{
+		using namespace Rendering::Opengl;
+
+		SECTION("Layout")
+		{
+			//The default format is the Vertex struct
+			VertexFormat defaultFormat;
+			REQUIRE(defaultFormat.IsDefault());
+			REQUIRE(defaultFormat.GetStride() == sizeof(Vertex));
+			AttributePointerInfo info = defaultFormat.GetAttributePointerInfo();
+			REQUIRE(info.GetStrideSize() == sizeof(Vertex));
+			REQUIRE(info.m_dimension == (std::vector<unsigned>{ 3, 3, 2, 3, 16 }));
+			REQUIRE(info.m_size == Vertex::s_attributePointerInfo.m_size);
+			REQUIRE(info.m_divisor == Vertex::s_attributePointerInfo.m_divisor);
+			REQUIRE(std::count(info.m_type.begin(), info.m_type.end(), AttributeType::FLOAT) == 5);
+
+			//Compact formats are 40-55% smaller
+			VertexFormat compact = VertexFormat::Compact();
+			REQUIRE(compact.GetStride() == 24);
+			REQUIRE(compact.GetAttributePointerInfo().GetStrideSize() == 24);
+			VertexFormat quantized = compact;
+			quantized.m_position = PositionEncoding::UNORM16;
+			quantized.m_texCoord = TexCoordEncoding::UNORM16;
+			REQUIRE(quantized.GetStride() == 20);
+
+			AttributePointerInfo quantizedInfo = quantized.GetAttributePointerInfo();
+			REQUIRE(quantizedInfo.m_dimension == (std::vector<unsigned>{ 3, 2, 2, 2, 16 }));
+			REQUIRE(quantizedInfo.m_type[0] == AttributeType::UNSIGNED_SHORT);
+			REQUIRE(quantizedInfo.m_type[1] == AttributeType::SHORT);
+			REQUIRE(quantizedInfo.m_normalized[0]);
+			REQUIRE(quantizedInfo.m_normalized[1]);
+
+			//Every format survive a cooked file and keep the VBO float aligned
+			for (int position = 0; position < 2; ++position)
+			{
+				for (int normal = 0; normal < 2; ++normal)
+				{
+					for (int texCoord = 0; texCoord < 3; ++texCoord)
+					{
+						VertexFormat format;
+						format.m_position = static_cast<PositionEncoding>(position);
+						format.m_normal = static_cast<DirectionEncoding>(normal);
+						format.m_texCoord = static_cast<TexCoordEncoding>(texCoord);
+						format.m_tangent = static_cast<DirectionEncoding>(1 - normal);
+
+						VertexFormat unpacked;
+						REQUIRE(VertexFormat::Unpack(format.Pack(), unpacked));
+						REQUIRE(unpacked == format);
+						REQUIRE(format.GetStride() % sizeof(float) == 0);
+						REQUIRE(format.GetAttributePointerInfo().GetStrideSize() == format.GetStride());
+					}
+				}
+			}
+			VertexFormat unpacked;
+			REQUIRE(!VertexFormat::Unpack(2, unpacked));
+			REQUIRE(!VertexFormat::Unpack(3 << 4, unpacked));
+			REQUIRE(!VertexFormat::Unpack(1 << 8, unpacked));
+		}
+
+		SECTION("Octahedral")
+		{
+			VertexFormat format;
+			format.m_normal = DirectionEncoding::OCTAHEDRAL;
+			format.m_tangent = DirectionEncoding::OCTAHEDRAL;
+
+			//Axes, diagonals and the folded lower half, then random ones
+			std::vector<Vertex> vertices = MakeRandomVertices(100000, 1.0f, 1.0f, 11);
+			std::vector<glm::vec3> directions{ glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0)
+				, glm::vec3(0, -1, 0), glm::vec3(0, 0, 1), glm::vec3(0, 0, -1), glm::vec3(1, 1, 1)
+				, glm::vec3(-1, 1, -1), glm::vec3(1, -1, -1), glm::vec3(-1, -1, -1), glm::vec3(0.5f, 0.0f, -1.0f) };
+			for (size_t i = 0; i < directions.size(); ++i)
+			{
+				vertices[i].m_normal = glm::normalize(directions[i]);
+				vertices[i].m_tangent = -vertices[i].m_normal;
+			}
+
+			VertexQuantization quantization;
+			std::vector<Container::U8> encoded;
+			VertexEncoding::EncodeVertices(format, quantization, vertices.data(), vertices.size(), encoded);
+			REQUIRE(encoded.size() == vertices.size() * format.GetStride());
+
+			float maxAngle = 0.0f;
+			float maxUnquantizedAngle = 0.0f;
+			for (size_t i = 0; i < vertices.size(); ++i)
+			{
+				Vertex decoded = VertexEncoding::DecodeVertex(format, quantization
+					, encoded.data() + i * format.GetStride());
+				REQUIRE(glm::length(decoded.m_normal) == Approx(1.0f).margin(1e-5f));
+				maxAngle = std::max(maxAngle, AngleDegrees(vertices[i].m_normal, decoded.m_normal));
+				maxAngle = std::max(maxAngle, AngleDegrees(vertices[i].m_tangent, decoded.m_tangent));
+
+				glm::vec3 unquantized = VertexEncoding::DecodeOctahedral(
+					VertexEncoding::EncodeOctahedral(vertices[i].m_normal));
+				maxUnquantizedAngle = std::max(maxUnquantizedAngle, AngleDegrees(vertices[i].m_normal, unquantized));
+			}
+			REQUIRE(maxUnquantizedAngle < 0.01f);
+			REQUIRE(maxAngle < 0.01f);
+			Debug::Log << Logger::MessageType::INFO << "VertexFormat octahedral max error: "
+				<< maxAngle << " degrees\n";
+		}
+
+		SECTION("Half")
+		{
+			//Exact ones, with the smallest normal and subnormal
+			for (float value : { 0.0f, 1.0f, -2.0f, 0.5f, 0.333251953125f, 65504.0f
+				, std::ldexp(1.0f, -14), std::ldexp(1.0f, -24), -std::ldexp(3.0f, -20) })
+			{
+				REQUIRE(VertexEncoding::HalfToFloat(VertexEncoding::FloatToHalf(value)) == value);
+			}
+
+			//Saturate instead of infinity, NaN stay NaN
+			REQUIRE(VertexEncoding::FloatToHalf(1e6f) == 0x7BFF);
+			REQUIRE(VertexEncoding::FloatToHalf(-70000.0f) == 0xFBFF);
+			REQUIRE(std::isnan(VertexEncoding::HalfToFloat(VertexEncoding::FloatToHalf(std::nanf("")))));
+
+			//Every finite half survive the round trip
+			for (unsigned half = 0; half < 0x10000; ++half)
+			{
+				if (((half >> 10) & 0x1F) == 0x1F)
+				{
+					continue;
+				}
+				float value = VertexEncoding::HalfToFloat(static_cast<Container::U16>(half));
+				REQUIRE(VertexEncoding::FloatToHalf(value) == half);
+			}
+
+			//Rounding to nearest is within half a step, 2^-11 relative
+			std::mt19937 random(5);
+			std::uniform_real_distribution<float> range(-1000.0f, 1000.0f);
+			for (int i = 0; i < 100000; ++i)
+			{
+				float value = range(random);
+				float decoded = VertexEncoding::HalfToFloat(VertexEncoding::FloatToHalf(value));
+				REQUIRE(std::abs(decoded - value) <= std::abs(value) * std::ldexp(1.0f, -11) + std::ldexp(1.0f, -25));
+			}
+		}
+
+		SECTION("Quantization")
+		{
+			const float size = 50.0f;
+			const float texCoordRange = 4.0f;
+			std::vector<Vertex> vertices = MakeRandomVertices(20000, size, texCoordRange, 3);
+
+			for (int position = 0; position < 2; ++position)
+			{
+				for (int direction = 0; direction < 2; ++direction)
+				{
+					for (int texCoord = 0; texCoord < 3; ++texCoord)
+					{
+						VertexFormat format;
+						format.m_position = static_cast<PositionEncoding>(position);
+						format.m_normal = static_cast<DirectionEncoding>(direction);
+						format.m_texCoord = static_cast<TexCoordEncoding>(texCoord);
+						format.m_tangent = static_cast<DirectionEncoding>(direction);
+
+						VertexQuantization quantization = VertexEncoding::ComputeQuantization(format
+							, vertices.data(), vertices.size());
+						std::vector<Container::U8> encoded;
+						VertexEncoding::EncodeVertices(format, quantization, vertices.data(), vertices.size(), encoded);
+
+						//Half a step of each encoding, with float rounding
+						float positionError = format.m_position == PositionEncoding::UNORM16
+							? size * 0.5f / 65535.0f + size * 1e-6f : 0.0f;
+						float directionError = format.m_normal == DirectionEncoding::OCTAHEDRAL ? 0.01f : 0.0f;
+						float texCoordError = format.m_texCoord == TexCoordEncoding::UNORM16
+							? texCoordRange * 0.5f / 65535.0f + 1e-6f
+							: format.m_texCoord == TexCoordEncoding::HALF2 ? texCoordRange * std::ldexp(1.0f, -11) : 0.0f;
+
+						for (size_t i = 0; i < vertices.size(); ++i)
+						{
+							const Container::U8* data = encoded.data() + i * format.GetStride();
+							Vertex decoded = VertexEncoding::DecodeVertex(format, quantization, data);
+							REQUIRE(VertexEncoding::DecodePosition(format, quantization, data) == decoded.m_position);
+
+							glm::vec3 positionDelta = glm::abs(decoded.m_position - vertices[i].m_position);
+							REQUIRE(std::max(positionDelta.x, std::max(positionDelta.y, positionDelta.z)) <= positionError);
+							glm::vec2 texCoordDelta = glm::abs(decoded.m_texCoord - vertices[i].m_texCoord);
+							REQUIRE(std::max(texCoordDelta.x, texCoordDelta.y) <= texCoordError);
+							if (directionError > 0.0f)
+							{
+								REQUIRE(AngleDegrees(decoded.m_normal, vertices[i].m_normal) <= directionError);
+								REQUIRE(AngleDegrees(decoded.m_tangent, vertices[i].m_tangent) <= directionError);
+							}
+							else
+							{
+								REQUIRE(decoded.m_normal == vertices[i].m_normal);
+								REQUIRE(decoded.m_tangent == vertices[i].m_tangent);
+							}
+						}
+					}
+				}
+			}
+		}
+
+		SECTION("Choose")
+		{
+			//Prop sized mesh, everything fit in 16 bits
+			std::vector<Vertex> prop = MakeRandomVertices(1000, 2.0f, 1.0f, 1);
+			VertexFormat format = VertexFormat::Choose(prop.data(), prop.size());
+			REQUIRE(format.m_position == PositionEncoding::UNORM16);
+			REQUIRE(format.m_normal == DirectionEncoding::OCTAHEDRAL);
+			REQUIRE(format.m_tangent == DirectionEncoding::OCTAHEDRAL);
+			REQUIRE(format.m_texCoord == TexCoordEncoding::UNORM16);
+			REQUIRE(format.GetStride() == 20);
+
+			//Terrain sized mesh with tiled uv keep float positions and uv
+			std::vector<Vertex> terrain = MakeRandomVertices(1000, 4000.0f, 200.0f, 2);
+			format = VertexFormat::Choose(terrain.data(), terrain.size());
+			REQUIRE(format.m_position == PositionEncoding::FLOAT3);
+			REQUIRE(format.m_texCoord == TexCoordEncoding::FLOAT2);
+			REQUIRE(format.m_normal == DirectionEncoding::OCTAHEDRAL);
+
+			VertexFormatSettings settings;
+			settings.m_quantizePositions = false;
+			settings.m_octahedralDirections = false;
+			format = VertexFormat::Choose(prop.data(), prop.size(), settings);
+			REQUIRE(format.m_position == PositionEncoding::FLOAT3);
+			REQUIRE(format.m_normal == DirectionEncoding::FLOAT3);
+			REQUIRE(VertexFormat::Choose(prop.data(), 0).IsDefault());
+		}
+
+		SECTION("Benchmark")
+		{
+			//A million vertices of a scene of props
+			const size_t count = 1 << 20;
+			std::vector<Vertex> vertices = MakeRandomVertices(count, 4.0f, 1.0f, 9);
+			VertexFormat format = VertexFormat::Choose(vertices.data(), vertices.size());
+			std::vector<Container::U8> encoded;
+
+			StopWatch watch{ true };
+			VertexQuantization quantization = VertexEncoding::ComputeQuantization(format, vertices.data(), count);
+			VertexEncoding::EncodeVertices(format, quantization, vertices.data(), count, encoded);
+			watch.Stop();
+
+			REQUIRE(encoded.size() <= count * sizeof(Vertex) * 6 / 10);
+			Debug::Log << Logger::MessageType::INFO << "VertexFormat encoded " << count
+				<< " vertices in " << watch.GetElapsedTimeMilli() << " ms, " << format.GetStride()
+				<< " bytes per vertex instead of " << sizeof(Vertex) << " ("
+				<< (100.0f - 100.0f * format.GetStride() / sizeof(Vertex)) << "% smaller)\n";
+		}
+	}
+
+  //*****************************************************
+  // UnitTest: PhysicsQuery
+  //*****************************************************
+	TEST_CASE("PhysicsQuery", "[physics]")
+	{
+		using namespace Components;
+
+		//Static boxes in a row along x, the queries go toward -z
+		const Vector<glm::vec3> positions{ glm::vec3(0.0f, 0.0f, -10.0f)
+			, glm::vec3(5.0f, 0.0f, -10.0f), glm::vec3(0.0f, 0.0f, -20.0f) };
+		const glm::vec3 halfExtent{ 1.0f };
+
+		Physics::PhysicsScene scene;
+		Vector<Handle<GameObject>> boxes;
+		for (const glm::vec3& position : positions)
+		{
+			boxes.emplace_back(GameObject::Create("Box", 1));
+			auto rigidbody = boxes.back()->AddComponent("Rigidbody")->Get<Rigidbody>();
+			rigidbody->Initialize(scene, position
+				, Physics::ColliderInitializer{ Physics::ColliderType::BOX_COLLIDER, halfExtent }, 0.0f);
+		}
+
+		//One step like the game loop, the broadphase boxes get their contact threshold
+		scene.Update(1.0f / 60.0f);
+
+		//Split every batch across the workers
+		unsigned initialWorkers = JobSystem::GetWorkerCount();
+		if (initialWorkers < 2)
+		{
+			JobSystem::Terminate();
+			JobSystem::Initialize(3);
+		}
+		const size_t minBatchSize = 4;
+
+		SECTION("Raycast")
+		{
+			Physics::RaycastBatch batch;
+			batch.AddRay(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -40.0f));
+			batch.AddRay(glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(5.0f, 0.0f, -40.0f));
+			batch.AddRay(glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(10.0f, 0.0f, -40.0f));
+			batch.AddRay(glm::vec3(-10.0f, 0.0f, -10.0f), glm::vec3(10.0f, 0.0f, -10.0f));
+			scene.Raycast(batch, 1);
+
+			auto& result = batch.m_result;
+			REQUIRE(result.m_hit[0]);
+			REQUIRE(result.m_hitFraction[0] == Approx(9.0f / 40.0f));
+			REQUIRE(result.m_hitNormal[0].z == Approx(1.0f));
+			REQUIRE(result.m_gameObject[0].m_handle == boxes[0].m_handle);
+
+			REQUIRE(result.m_hit[1]);
+			REQUIRE(result.m_gameObject[1].m_handle == boxes[1].m_handle);
+
+			REQUIRE(!result.m_hit[2]);
+			REQUIRE(result.m_hitFraction[2] == 1.0f);
+			REQUIRE(!result.m_gameObject[2].IsValid());
+
+			REQUIRE(result.m_hit[3]);
+			REQUIRE(result.m_hitFraction[3] == Approx(9.0f / 20.0f));
+			REQUIRE(result.m_hitNormal[3].x == Approx(-1.0f));
+			REQUIRE(result.m_gameObject[3].m_handle == boxes[0].m_handle);
+
+			//Static bodies are in the StaticFilter group only
+			batch.m_collisionFilterMask = btBroadphaseProxy::DefaultFilter;
+			scene.Raycast(batch, 1);
+			for (size_t i = 0; i < batch.Size(); ++i)
+			{
+				REQUIRE(!result.m_hit[i]);
+				REQUIRE(!result.m_gameObject[i].IsValid());
+			}
+		}
+
+		SECTION("Raycast_Match_RayTest")
+		{
+			//Same boxes in a plain collision world, queried one ray at a time
+			btDefaultCollisionConfiguration config;
+			btCollisionDispatcher dispatcher{ &config };
+			btDbvtBroadphase broadphase;
+			btCollisionWorld world{ &dispatcher, &broadphase, &config };
+			btBoxShape shape{ Physics::ToBulletVec3(halfExtent) };
+			Vector<btCollisionObject> objects(positions.size());
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				btTransform transform;
+				transform.setIdentity();
+				transform.setOrigin(Physics::ToBulletVec3(positions[i]));
+				objects[i].setCollisionShape(&shape);
+				objects[i].setWorldTransform(transform);
+				world.addCollisionObject(&objects[i], btBroadphaseProxy::StaticFilter
+					, btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+			}
+			world.updateAabbs();
+
+			std::mt19937 rng{ 26 };
+			std::uniform_real_distribution<float> spread{ -8.0f, 12.0f };
+			Physics::RaycastBatch batch;
+			const size_t rayCount = 512;
+			batch.Reserve(rayCount);
+			for (size_t i = 0; i < rayCount; ++i)
+			{
+				batch.AddRay(glm::vec3(spread(rng), spread(rng) * 0.25f, 0.0f)
+					, glm::vec3(spread(rng), spread(rng) * 0.25f, -30.0f));
+			}
+			scene.Raycast(batch, minBatchSize);
+
+			size_t hitCount = 0;
+			for (size_t i = 0; i < rayCount; ++i)
+			{
+				btVector3 from = Physics::ToBulletVec3(batch.m_from[i]);
+				btVector3 to = Physics::ToBulletVec3(batch.m_to[i]);
+				btCollisionWorld::ClosestRayResultCallback callback(from, to);
+				world.rayTest(from, to, callback);
+
+				auto& result = batch.m_result;
+				REQUIRE(static_cast<bool>(result.m_hit[i]) == callback.hasHit());
+				if (callback.hasHit())
+				{
+					++hitCount;
+					REQUIRE(result.m_hitFraction[i] == Approx(callback.m_closestHitFraction));
+					REQUIRE(result.m_hitNormal[i].x == Approx(callback.m_hitNormalWorld.x()).margin(1e-5));
+					REQUIRE(result.m_hitNormal[i].y == Approx(callback.m_hitNormalWorld.y()).margin(1e-5));
+					REQUIRE(result.m_hitNormal[i].z == Approx(callback.m_hitNormalWorld.z()).margin(1e-5));
+					size_t object = static_cast<size_t>(callback.m_collisionObject - &objects[0]);
+					REQUIRE(result.m_gameObject[i].m_handle == boxes[object].m_handle);
+				}
+			}
+			REQUIRE(hitCount > 0);
+			REQUIRE(hitCount < rayCount);
+
+			for (auto& object : objects)
+			{
+				world.removeCollisionObject(&object);
+			}
+		}
+
+		SECTION("SweepSphere")
+		{
+			Physics::SweepBatch batch;
+			batch.AddSweep(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -40.0f), 0.5f);
+			batch.AddSweep(glm::vec3(2.5f, 0.0f, 0.0f), glm::vec3(2.5f, 0.0f, -40.0f), 0.5f);
+			batch.AddSweep(glm::vec3(2.5f, 0.0f, 0.0f), glm::vec3(2.5f, 0.0f, -40.0f), 2.0f);
+			scene.SweepSphere(batch, 1);
+
+			auto& result = batch.m_result;
+			REQUIRE(result.m_hit[0]);
+			REQUIRE(result.m_hitFraction[0] == Approx(8.5f / 40.0f).margin(1e-3));
+			REQUIRE(result.m_hitNormal[0].z == Approx(1.0f).margin(1e-3));
+			REQUIRE(result.m_gameObject[0].m_handle == boxes[0].m_handle);
+
+			//Between the boxes
+			REQUIRE(!result.m_hit[1]);
+
+			//Too wide to pass between them
+			REQUIRE(result.m_hit[2]);
+			REQUIRE(result.m_gameObject[2].IsValid());
+
+			batch.m_collisionFilterMask = btBroadphaseProxy::DefaultFilter;
+			scene.SweepSphere(batch, 1);
+			REQUIRE(!result.m_hit[0]);
+			REQUIRE(!result.m_hit[2]);
+		}
+
+		SECTION("OverlapSphere")
+		{
+			Physics::OverlapBatch batch;
+			batch.AddOverlap(glm::vec3(2.5f, 0.0f, -10.0f), 2.0f);
+			batch.AddOverlap(glm::vec3(0.0f, 0.0f, -15.0f), 1.0f);
+			batch.AddOverlap(glm::vec3(0.0f, 0.0f, -15.0f), 4.5f);
+			batch.AddOverlap(glm::vec3(0.0f, 0.0f, -20.0f), 0.5f);
+			scene.OverlapSphere(batch, 1);
+
+			auto Contains = [&batch](size_t query, const Handle<GameObject>& gameObject)
+			{
+				auto results = batch.GetResults(query);
+				return std::any_of(results, results + batch.m_resultCount[query]
+					, [&gameObject](const Handle<GameObject>& h) { return h.m_handle == gameObject.m_handle; });
+			};
+
+			REQUIRE(batch.m_resultCount[0] == 2);
+			REQUIRE(Contains(0, boxes[0]));
+			REQUIRE(Contains(0, boxes[1]));
+
+			REQUIRE(batch.m_resultCount[1] == 0);
+
+			REQUIRE(batch.m_resultCount[2] == 2);
+			REQUIRE(Contains(2, boxes[0]));
+			REQUIRE(Contains(2, boxes[2]));
+
+			REQUIRE(batch.m_resultCount[3] == 1);
+			REQUIRE(Contains(3, boxes[2]));
+
+			batch.m_collisionFilterMask = btBroadphaseProxy::DefaultFilter;
+			scene.OverlapSphere(batch, 1);
+			for (size_t i = 0; i < batch.Size(); ++i)
+			{
+				REQUIRE(batch.m_resultCount[i] == 0);
+			}
+		}
+
+		//Remove the bodies before the scene goes away
+		for (auto& box : boxes)
+		{
+			box->Destroy();
+		}
+
+		JobSystem::Terminate();
+		if (initialWorkers > 0)
+		{
+			JobSystem::Initialize(initialWorkers);
+		}
+	}
+}
@@ -1,11 +1,27 @@
 // Local Headers
 #include "NightEngine2.hpp"
+#include "Input/Input.hpp"
+
+// Standard Headers
+#include <cstring>
 
 int main(int argc, char * argv[])
 {
+  //Cook the changed assets into the asset cache and exit
+  if (argc > 1 && std::strcmp(argv[1], "--cook") == 0)
+  {
+    return NightEngine::Engine::RunCookTarget();
+  }
+
   NightEngine::Engine* engine = new NightEngine::Engine();
   {
     engine->Initialize();
+
+    //Drive the session from a recorded input stream, for repeatable benchmarks
+    if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+    {
+      Input::BeginReplay(argv[2]);
+    }
     engine->MainLoop();
     engine->Terminate();
   }